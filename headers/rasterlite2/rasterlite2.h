@@ -856,6 +856,88 @@ extern "C"
 */
     RL2_DECLARE void rl2_cleanup_private (const void *ptr);
 
+/**
+ Registers a callback receiving per-request performance span events
+
+ \param ptr a memory pointer returned by rl2_alloc_private()
+ \param callback pointer to the callback function; NULL will disable
+ any previously registered callback.
+ \param user_data an arbitrary pointer passed back to the callback
+
+ \return RL2_OK on success: RL2_ERROR on failure.
+
+ \note the callback is invoked once for each pipeline stage (e.g. 
+ "tile_query", "decode", "image_encode") actually touched by an
+ instrumented SQL request (e.g. RL2_GetMapImageFromRaster), followed by
+ a final event whose stage is "request" reporting the total elapsed time.
+
+ \sa rl2_alloc_private
+ */
+    RL2_DECLARE int rl2_set_perf_callback (const void *ptr,
+					   void (*callback) (void *user_data,
+							     const char
+							     *request,
+							     const char
+							     *stage,
+							     int count,
+							     double
+							     elapsed_ms,
+							     sqlite3_int64
+							     bytes),
+					   void *user_data);
+
+/**
+ Sets the deadline applying to each further request
+
+ \param ptr a memory pointer returned by rl2_alloc_private()
+ \param seconds the max time (in seconds) any single instrumented SQL
+ request (e.g. RL2_GetMapImageFromRaster or RL2_WriteGeoTiff) is allowed 
+ to run before being cancelled; 0.0 will disable any deadline.
+
+ \return RL2_OK on success: RL2_ERROR on failure.
+
+ \note a cancelled (or expired) request always fails, returning NULL
+ or a failure code exactly as any other error.
+ \n while a deadline is set each request installs its own SQLite progress
+ handler on the connection, replacing the one the application may have
+ registered by calling sqlite3_progress_handler(); the handler is removed
+ (and never restored) as soon as the request completes. No progress
+ handler is ever touched when the deadline is 0.0.
+
+ \sa rl2_get_request_timeout, rl2_cancel_request
+ */
+    RL2_DECLARE int rl2_set_request_timeout (const void *ptr,
+					     double seconds);
+
+/**
+ Returns the deadline currently applying to each request
+
+ \param ptr a memory pointer returned by rl2_alloc_private()
+ \param seconds on completion will contain the current deadline (in 
+ seconds); 0.0 means that no deadline is set.
+
+ \return RL2_OK on success: RL2_ERROR on failure.
+
+ \sa rl2_set_request_timeout
+ */
+    RL2_DECLARE int rl2_get_request_timeout (const void *ptr,
+					     double *seconds);
+
+/**
+ Cancels the request currently running on some connection (if any)
+
+ \param ptr a memory pointer returned by rl2_alloc_private()
+
+ \return RL2_OK on success: RL2_ERROR on failure.
+
+ \note this function is safe to be called from any other thread; the
+ cancelled request will stop at the next Tile or Feature, and the SQL
+ statement it is currently running will be stopped by sqlite3_interrupt().
+
+ \sa rl2_set_request_timeout
+ */
+    RL2_DECLARE int rl2_cancel_request (const void *ptr);
+
 /**
  Testing if a given codec/compressor is actually supported by the library
 
@@ -4135,6 +4217,24 @@ extern "C"
 				  int is_opaque, double min_scale,
 				  double max_scale);
 
+    RL2_DECLARE int
+	rl2_create_dbms_coverage_ex (sqlite3 * handle, const char *coverage,
+				     unsigned char sample,
+				     unsigned char pixel,
+				     unsigned char num_bands,
+				     unsigned char compression, int quality,
+				     unsigned int tile_width,
+				     unsigned int tile_height, int srid,
+				     double x_res, double y_res,
+				     rl2PixelPtr no_data,
+				     rl2PalettePtr palette,
+				     int strict_resolution,
+				     int mixed_resolutions, int section_paths,
+				     int section_md5, int section_summary,
+				     int is_queryable, int is_opaque,
+				     double min_scale, double max_scale,
+				     int dedup_tiles);
+
     RL2_DECLARE int
 	rl2_set_dbms_coverage_default_bands (sqlite3 * handle,
 					     const char *coverage,
@@ -4816,6 +4916,11 @@ extern "C"
 					const char *coverage,
 					int forced_rebuild, int verbose);
 
+    RL2_DECLARE int
+	rl2_build_incremental_pyramid (sqlite3 * handle,
+				       const void *priv_data,
+				       const char *coverage, int verbose);
+
     RL2_DECLARE int
 	rl2_delete_section_pyramid (sqlite3 * handle, const char *coverage,
 				    sqlite3_int64 section_id);
@@ -5495,6 +5600,10 @@ extern "C"
     RL2_DECLARE int
 	rl2_is_visible_style (rl2FeatureTypeStylePtr style, double scale);
 
+    RL2_DECLARE char
+	*rl2_build_feature_type_style_sql_filter (rl2FeatureTypeStylePtr style,
+						  double scale);
+
     RL2_DECLARE int rl2_style_has_labels (rl2FeatureTypeStylePtr style);
 
     RL2_DECLARE int
@@ -6299,6 +6408,12 @@ extern "C"
 							with_edge_or_link_seeds,
 							int with_face_seeds);
 
+    RL2_DECLARE int rl2_vector_tile_blob (sqlite3 * sqlite,
+					  const char *db_prefix,
+					  const char *cvg_name, int z, int x,
+					  int y, int extent, int buffer,
+					  unsigned char **blob, int *blob_size);
+
     RL2_DECLARE int rl2_map_image_paint_labels (sqlite3 * sqlite,
 						const void *data,
 						rl2CanvasPtr canvas,
@@ -163,6 +163,14 @@ extern "C"
 #define RL2_FONT_START				0xa7
 #define RL2_FONT_END				0x7b
 
+/* pseudo-compression marking a Uniform (single value) tile */
+#define RL2_COMPRESSION_UNIFORM			0xe0
+
+/* sparse tiles classification */
+#define RL2_SPARSE_NONE		0
+#define RL2_SPARSE_EMPTY	1
+#define RL2_SPARSE_UNIFORM	2
+
 /* internal ColorSpace forced conversions */
 #define RL2_CONVERT_NO				0x00
 #define RL2_CONVERT_MONOCHROME_TO_PALETTE	0x01
@@ -440,6 +448,135 @@ extern "C"
 	struct rl2_label_rect *last_rect;
     };
 
+/* performance counters: pipeline stages */
+#define RL2_PERF_TILE_QUERY	0
+#define RL2_PERF_BLOB_FETCH	1
+#define RL2_PERF_DECODE		2
+#define RL2_PERF_PIXEL_COPY	3
+#define RL2_PERF_RENDER		4
+#define RL2_PERF_SYMBOLIZE	5
+#define RL2_PERF_RASTER_ENCODE	6
+#define RL2_PERF_IMAGE_ENCODE	7
+#define RL2_PERF_TILE_INSERT	8
+#define RL2_PERF_MAX_STAGES	9
+
+/* PNG encoder row filters */
+#define RL2_PNG_FILTER_NONE	0
+#define RL2_PNG_FILTER_SUB	1
+#define RL2_PNG_FILTER_UP	2
+#define RL2_PNG_FILTER_AVERAGE	3
+#define RL2_PNG_FILTER_PAETH	4
+#define RL2_PNG_FILTER_ADAPTIVE	5
+
+/* Section checksum algorithms */
+#define RL2_CHECKSUM_MD5	0
+#define RL2_CHECKSUM_XXH64	1
+
+/* Vector Coverages: number of precomputed generalization (scale) bands */
+#define RL2_VECTOR_GEN_BANDS	6
+
+    struct rl2_perf_stage
+    {
+	sqlite3_int64 count;
+	sqlite3_int64 bytes;
+	double seconds;
+    };
+
+    struct rl2_perf_counters
+    {
+	void *mutex;
+	sqlite3_int64 requests;
+	double request_seconds;
+	struct rl2_perf_stage stages[RL2_PERF_MAX_STAGES];
+	/* the currently active request (span) */
+	int depth;
+	const char *request_name;
+	double request_start;
+	struct rl2_perf_stage snapshot[RL2_PERF_MAX_STAGES];
+	/* optional user callback receiving span events */
+	void (*callback) (void *user_data, const char *request,
+			  const char *stage, int count, double elapsed_ms,
+			  sqlite3_int64 bytes);
+	void *callback_data;
+    };
+
+/* number of SQLite VM instructions between two cancellation checks */
+#define RL2_CANCEL_PROGRESS_OPS	1000
+
+/* a per-connection Cancellation Token */
+    struct rl2_cancel_token
+    {
+	void *mutex;
+	volatile int cancelled;
+	double timeout;		/* seconds; 0.0 means no deadline at all */
+	/* the currently active request */
+	int depth;
+	double deadline;	/* absolute monotonic time */
+	sqlite3 *handle;	/* the connection servicing the request */
+	int progress;		/* the progress handler has been installed */
+    };
+
+/* metadata cache: a resolution level (index 0=1:1, 1=1:2, 2=1:4, 3=1:8) */
+    struct rl2_cached_level
+    {
+	int level;
+	unsigned char valid;	/* bitmask: one bit for each scale */
+	double x_res[4];
+	double y_res[4];
+    };
+
+    struct rl2_cached_style
+    {
+	char *name;
+	void *style;
+	struct rl2_cached_style *next;
+    };
+
+    struct rl2_cached_coverage
+    {
+	char *db_prefix;
+	char *coverage_name;
+	int data_version;
+	void *coverage;
+	int mixed_resolutions;
+	int num_levels;
+	struct rl2_cached_level *levels;	/* by pyramid_level DESC */
+	void *palette;
+	int stats_loaded;
+	void *stats;
+	struct rl2_cached_style *first_style;
+	struct rl2_cached_style *last_style;
+	struct rl2_cached_coverage *next;
+    };
+
+/* metadata cache: a stable PNG8/GIF palette for some Coverage + Style */
+    struct rl2_cached_palette
+    {
+	char *db_prefix;
+	char *coverage_name;
+	char *style_name;
+	int data_version;
+	int num_entries;	/* ZERO while still sampling */
+	unsigned char red[256];
+	unsigned char green[256];
+	unsigned char blue[256];
+	unsigned short *lut;	/* nearest color: RGB 5-5-5 -> index */
+	int samples;
+	void *seed;		/* RGB histogram of the sampled images */
+	struct rl2_cached_palette *next;
+    };
+
+    struct rl2_metadata_cache
+    {
+	int total_changes;
+	int count;
+	struct rl2_cached_coverage *first;
+	struct rl2_cached_coverage *last;
+	int palette_count;
+	struct rl2_cached_palette *first_palette;
+	struct rl2_cached_palette *last_palette;
+    };
+
     struct rl2_private_data
     {
 	int max_threads;
@@ -455,11 +592,22 @@ extern "C"
 	void *FTlibrary;
 	struct rl2_private_tt_font *first_font;
 	struct rl2_private_tt_font *last_font;
+	struct rl2_text_cache *text_cache;
 	struct rl2_cached_raster *raster_cache;
 	struct rl2_private_map_canvas map_canvas;
 	int raster_cache_items;
 	char *draping_message;
 	struct rl2_advanced_labeling labeling;
+	struct rl2_perf_counters *perf;
+	struct rl2_cancel_token *cancel;
+	struct rl2_metadata_cache *meta_cache;
+	int png_level;
+	unsigned char png_filter;
+	unsigned char png8_dithering;
+	unsigned char png8_stable_palette;
+	unsigned char sparse_tiles;
+	unsigned char section_checksum;
+	unsigned char parallel_vector;
     };
 
     typedef struct rl2_priv_tile
@@ -501,6 +649,10 @@ extern "C"
 	int sectionPaths;
 	int sectionMD5;
 	int sectionSummary;
+	struct rl2_cached_coverage *cached;
+	unsigned int zstdDictId;	/* the current ZSTD Dictionary */
+	int nZstdDicts;
+	struct rl2_zstd_dictionary **zstdDicts;	/* all ZSTD Dictionaries loaded */
     } rl2PrivCoverage;
     typedef rl2PrivCoverage *rl2PrivCoveragePtr;
 
@@ -1015,6 +1167,24 @@ extern "C"
     } rl2PrivVariantArray;
     typedef rl2PrivVariantArray *rl2PrivVariantArrayPtr;
 
+    typedef struct rl2_priv_rule_literal
+    {
+	int is_numeric;
+	sqlite3_int64 int_value;
+	double dbl_value;
+	const char *text_value;
+    } rl2PrivRuleLiteral;
+    typedef rl2PrivRuleLiteral *rl2PrivRuleLiteralPtr;
+
+    typedef struct rl2_priv_rule_filter
+    {
+	int has_args;
+	int column_index;
+	rl2PrivRuleLiteral lower;
+	rl2PrivRuleLiteral upper;
+    } rl2PrivRuleFilter;
+    typedef rl2PrivRuleFilter *rl2PrivRuleFilterPtr;
+
     typedef struct rl2_priv_style_rule
     {
 	int else_rule;
@@ -1023,6 +1193,7 @@ extern "C"
 	unsigned char comparison_op;
 	void *comparison_args;
 	char *column_name;
+	rl2PrivRuleFilterPtr filter;
 	unsigned char style_type;
 	void *style;
 	struct rl2_priv_style_rule *next;
@@ -1145,6 +1316,8 @@ extern "C"
 	unsigned char num_samples;
 	unsigned char compression;
 	int quality;
+	int sparse;
+	rl2CoveragePtr coverage;
 	int srid;
 	unsigned int full_width;
 	unsigned int full_height;
@@ -1165,6 +1338,33 @@ extern "C"
     } SectionPyramid;
     typedef SectionPyramid *SectionPyramidPtr;
 
+    typedef struct monolithic_pyramid
+    {
+	const void *priv_data;
+	rl2CoveragePtr coverage;
+	unsigned char sample_type;
+	unsigned char pixel_type;
+	unsigned char num_bands;
+	unsigned char out_sample_type;
+	unsigned char out_pixel_type;
+	unsigned char out_num_bands;
+	unsigned char out_compression;
+	int out_quality;
+	unsigned int tile_width;
+	unsigned int tile_height;
+	int srid;
+	int sparse;
+	int buf_size;
+	rl2PixelPtr no_data;
+	rl2PalettePtr palette;
+	sqlite3_stmt *stmt_geo;
+	sqlite3_stmt *stmt_rd;
+	sqlite3_stmt *stmt_levl;
+	sqlite3_stmt *stmt_tils;
+	sqlite3_stmt *stmt_data;
+    } MonolithicPyramid;
+    typedef MonolithicPyramid *MonolithicPyramidPtr;
+
     typedef struct resolution_level
     {
 	int level;
@@ -1455,6 +1655,7 @@ extern "C"
 	int odd_sz;
 	const unsigned char *even_blob;
 	int even_sz;
+	rl2CoveragePtr coverage;
 	rl2PrivRasterPtr raster;
 	double horz_res;
 	double vert_res;
@@ -1482,6 +1683,7 @@ extern "C"
 	unsigned char *blob_even;
 	int blob_odd_sz;
 	int blob_even_sz;
+	rl2RasterStatisticsPtr stats;
 	struct rl2_aux_importer_tile *next;
     } rl2AuxImporterTile;
     typedef rl2AuxImporterTile *rl2AuxImporterTilePtr;
@@ -1502,11 +1704,199 @@ extern "C"
 	int verbose;
 	unsigned char compression;
 	int quality;
+	int sparse;
+	struct rl2_perf_counters *perf;
 	rl2AuxImporterTilePtr first;
 	rl2AuxImporterTilePtr last;
     } rl2AuxImporter;
     typedef rl2AuxImporter *rl2AuxImporterPtr;
 
+    typedef struct rl2_aux_import_file
+    {
+	void *opaque_thread_id;
+	char *src_path;
+	rl2PrivCoveragePtr coverage;
+	int worldfile;
+	int force_srid;
+	unsigned char sample_type;
+	unsigned char pixel_type;
+	unsigned char num_bands;
+	unsigned int tile_w;
+	unsigned int tile_h;
+	unsigned char compression;
+	int quality;
+	int sparse;
+	unsigned char checksum_algorithm;
+	int verbose;
+	int sequential;
+	unsigned char origin_type;
+	void *origin;
+	int orig_srid;
+	int srid;
+	unsigned int width;
+	unsigned int height;
+	double minx;
+	double miny;
+	double maxx;
+	double maxy;
+	double res_x;
+	double res_y;
+	char *xml_summary;
+	char *md5;
+	rl2AuxImporterPtr aux;
+	char *error_message;
+	time_t start;
+	struct rl2_perf_counters *perf;
+	int retcode;
+    } rl2AuxImportFile;
+    typedef rl2AuxImportFile *rl2AuxImportFilePtr;
+
+    typedef struct rl2_sample_points
+    {
+	int count;
+	int max_count;
+	sqlite3_int64 *fids;
+	double *x;
+	double *y;
+	int *tile_of;
+	int *by_tile;
+	unsigned char sample_type;
+	unsigned char num_bands;
+	double *no_data;
+	int bilinear;
+	double *values;
+	unsigned char *valid;
+    } rl2SamplePoints;
+    typedef rl2SamplePoints *rl2SamplePointsPtr;
+
+    typedef struct rl2_sample_tile
+    {
+	void *opaque_thread_id;
+	sqlite3_int64 tile_id;
+	double minx;
+	double miny;
+	double maxx;
+	double maxy;
+	int first;
+	int count;
+	unsigned char *blob_odd;
+	int blob_odd_sz;
+	unsigned char *blob_even;
+	int blob_even_sz;
+	rl2PalettePtr palette;
+	rl2CoveragePtr coverage;
+	rl2SamplePointsPtr points;
+	int retcode;
+    } rl2SampleTile;
+    typedef rl2SampleTile *rl2SampleTilePtr;
+
+    typedef struct rl2_gen_feature
+    {
+	sqlite3_int64 feature_id;
+	unsigned char *blob;
+	int blob_sz;
+	unsigned char *gen_blob[RL2_VECTOR_GEN_BANDS];
+	int gen_blob_sz[RL2_VECTOR_GEN_BANDS];
+    } rl2GenFeature;
+    typedef rl2GenFeature *rl2GenFeaturePtr;
+
+    typedef struct rl2_gen_worker
+    {
+	void *opaque_thread_id;
+	rl2GenFeaturePtr features;
+	int count;
+	const double *tolerances;
+    } rl2GenWorker;
+    typedef rl2GenWorker *rl2GenWorkerPtr;
+
+    typedef struct rl2_banded_feature
+    {
+	rl2GeometryPtr geom;
+	rl2VectorSymbolizerPtr symbolizer;
+	rl2VariantArrayPtr variant;
+	double margin;
+    } rl2BandedFeature;
+    typedef rl2BandedFeature *rl2BandedFeaturePtr;
+
+    typedef struct rl2_banded_renderer
+    {
+	sqlite3 *handle;
+	const void *priv_data;
+	void *ctx;
+	int max_threads;
+	int width;
+	int height;
+	double minx;
+	double miny;
+	double maxx;
+	double maxy;
+	double x_res;
+	double y_res;
+	rl2BandedFeaturePtr features;
+	int count;
+	int max;
+	int unbounded;
+    } rl2BandedRenderer;
+    typedef rl2BandedRenderer *rl2BandedRendererPtr;
+
+    typedef struct rl2_banded_worker
+    {
+	void *opaque_thread_id;
+	rl2BandedRendererPtr renderer;
+	void *ctx;
+	int band_y;
+	int band_height;
+	struct rl2_perf_counters *perf;
+	struct rl2_cancel_token *cancel;
+    } rl2BandedWorker;
+    typedef rl2BandedWorker *rl2BandedWorkerPtr;
+
+    typedef struct rl2_label_candidate
+    {
+	int seq;
+	double priority;
+	rl2PrivTextSymbolizerPtr text;
+	const unsigned char *blob;
+	int blob_sz;
+    } rl2LabelCandidate;
+    typedef rl2LabelCandidate *rl2LabelCandidatePtr;
+
+    typedef struct rl2_label_arena_block
+    {
+	unsigned char *buf;
+	size_t size;
+	size_t used;
+	struct rl2_label_arena_block *next;
+    } rl2LabelArenaBlock;
+    typedef rl2LabelArenaBlock *rl2LabelArenaBlockPtr;
+
+    typedef struct rl2_label_candidates
+    {
+	char *db_prefix;
+	char *coverage;
+	int width;
+	int height;
+	double minx;
+	double miny;
+	double maxx;
+	double maxy;
+	rl2LabelArenaBlockPtr first_block;
+	rl2LabelArenaBlockPtr last_block;
+	rl2LabelCandidatePtr *index;
+	int count;
+	int max;
+    } rl2LabelCandidates;
+    typedef rl2LabelCandidates *rl2LabelCandidatesPtr;
+
+    typedef struct rl2_aux_file_checksum
+    {
+	void *opaque_thread_id;
+	char *src_path;
+	unsigned char algorithm;
+	char *checksum;
+    } rl2AuxFileChecksum;
+    typedef rl2AuxFileChecksum *rl2AuxFileChecksumPtr;
+
     typedef struct rl2_aux_decoder
     {
 	void *opaque_thread_id;
@@ -1539,6 +1929,14 @@ extern "C"
 	rl2PrivRasterStatisticsPtr stats;
 	rl2PrivRasterPtr raster;
 	rl2PrivPalettePtr palette;
+	unsigned char *cached_odd;
+	unsigned char *cached_even;
+	int cached_odd_sz;
+	int cached_even_sz;
+	rl2PrivRasterPtr cached_raster;
+	struct rl2_perf_counters *perf;
+	struct rl2_cancel_token *cancel;
+	rl2CoveragePtr coverage;
 	int retcode;
     } rl2AuxDecoder;
     typedef rl2AuxDecoder *rl2AuxDecoderPtr;
@@ -1560,6 +1958,7 @@ extern "C"
 	double tile_minx;
 	double tile_maxy;
 	rl2PrivRasterPtr raster;
+	struct rl2_perf_counters *perf;
 	int retcode;
     } rl2AuxMaskDecoder;
     typedef rl2AuxMaskDecoder *rl2AuxMaskDecoderPtr;
@@ -1613,6 +2012,8 @@ extern "C"
 	int ctx_edge_seeds_ready;
 	int ctx_link_seeds_ready;
 	int ctx_face_seeds_ready;
+	int retain_labels;
+	void *labels;
     } rl2PrivCanvas;
     typedef rl2PrivCanvas *rl2PrivCanvasPtr;
 
@@ -1873,7 +2274,8 @@ extern "C"
 					 int scale, rl2PalettePtr palette,
 					 rl2PixelPtr no_data,
 					 rl2RasterSymbolizerPtr style,
-					 rl2RasterStatisticsPtr stats);
+					 rl2RasterStatisticsPtr stats,
+					 rl2CoveragePtr cvg);
 
     RL2_PRIVATE int rl2_load_dbms_tiles_section (sqlite3 * handle,
 						 int max_threads,
@@ -1896,7 +2298,8 @@ extern "C"
 						 double maxx, double maxy,
 						 int level, int scale,
 						 rl2PalettePtr palette,
-						 rl2PixelPtr no_data);
+						 rl2PixelPtr no_data,
+						 rl2CoveragePtr cvg);
 
     RL2_PRIVATE int rl2_load_dbms_tiles_transparent (sqlite3 * handle,
 						     int max_threads,
@@ -1928,7 +2331,7 @@ extern "C"
 						     rl2RasterSymbolizerPtr
 						     style,
 						     rl2RasterStatisticsPtr
-						     stats);
+						     stats, rl2CoveragePtr cvg);
 
     RL2_PRIVATE int rl2_load_dbms_tiles_section_transparent (sqlite3 * handle,
 							     int max_threads,
@@ -1972,7 +2375,9 @@ extern "C"
 							     rl2PalettePtr
 							     palette,
 							     rl2PixelPtr
-							     no_data);
+							     no_data,
+							     rl2CoveragePtr
+							     cvg);
 
     RL2_PRIVATE void
 	compute_aggregate_sq_diff (rl2RasterStatisticsPtr aggreg_stats);
@@ -2036,6 +2441,19 @@ extern "C"
 					   sqlite3_stmt * stmt_sect,
 					   sqlite3_int64 * id);
 
+    RL2_PRIVATE int rl2_do_insert_section_md5 (sqlite3 * handle,
+					       const char *src_path,
+					       const char *section, int srid,
+					       unsigned int width,
+					       unsigned int height,
+					       double minx, double miny,
+					       double maxx, double maxy,
+					       char *xml_summary,
+					       int section_paths, char *md5,
+					       int section_summary,
+					       sqlite3_stmt * stmt_sect,
+					       sqlite3_int64 * id);
+
     RL2_PRIVATE char *get_section_name (const char *src_path);
 
     RL2_PRIVATE rl2RasterPtr build_wms_tile (rl2CoveragePtr coverage,
@@ -2513,6 +2931,10 @@ extern "C"
 
     RL2_PRIVATE void rl2_destroy_style_rule (rl2PrivStyleRulePtr rule);
 
+    RL2_PRIVATE void
+	rl2_compile_feature_type_style_filters (rl2PrivFeatureTypeStylePtr
+						style);
+
     RL2_PRIVATE void rl2_destroy_rule_like_args (rl2PrivRuleLikeArgsPtr like);
 
     RL2_PRIVATE void rl2_destroy_rule_between_args (rl2PrivRuleBetweenArgsPtr
@@ -2653,10 +3075,91 @@ extern "C"
 
     RL2_PRIVATE char *rl2_FinalizeMD5Checksum (void *p_md5);
 
+    RL2_PRIVATE void *rl2_CreateXXH64Checksum (void);
+
+    RL2_PRIVATE void rl2_FreeXXH64Checksum (void *p_xxh);
+
+    RL2_PRIVATE void rl2_UpdateXXH64Checksum (void *p_xxh,
+					      const unsigned char *blob,
+					      int blob_len);
+
+    RL2_PRIVATE char *rl2_FinalizeXXH64Checksum (void *p_xxh);
+
+    RL2_PRIVATE char *rl2_compute_file_checksum (const char *src_path,
+						 unsigned char algorithm);
+
+    RL2_PRIVATE int rl2_register_sample_points (sqlite3 * db,
+						const void *priv_data);
+
+    RL2_PRIVATE int rl2_build_vector_generalization (sqlite3 * handle,
+						     const void *priv_data,
+						     const char *coverage);
+
+    RL2_PRIVATE int rl2_drop_vector_generalization (sqlite3 * handle,
+						    const char *coverage);
+
+    RL2_PRIVATE int rl2_find_vector_generalization (sqlite3 * handle,
+						    const char *db_prefix,
+						    const char *coverage,
+						    rl2VectorMultiLayerPtr
+						    multi, double scale);
+
+    RL2_PRIVATE char *rl2_generalized_geometry_sql (const char *db_prefix,
+						    const char *coverage,
+						    rl2PrivVectorLayerPtr lyr,
+						    int band);
+
+    RL2_PRIVATE char *rl2_generalized_filter_sql (const char *db_prefix,
+						  const char *coverage,
+						  rl2PrivVectorLayerPtr lyr,
+						  int band,
+						  const char *search_frame);
+
+    RL2_PRIVATE int rl2_build_topo_face_cache (sqlite3 * handle,
+					       const char *topology);
+
+    RL2_PRIVATE int rl2_drop_topo_face_cache (sqlite3 * handle,
+					      const char *topology);
+
+    RL2_PRIVATE int rl2_find_topo_face_cache (sqlite3 * handle,
+					      const char *db_prefix,
+					      const char *topology);
+
+    RL2_PRIVATE char *rl2_topo_face_cache_geometry_sql (const char
+							*db_prefix,
+							const char *topology,
+							const char
+							*face_table);
+
+    RL2_PRIVATE char *rl2_topo_face_cache_filter_sql (const char *db_prefix,
+						      const char *face_table,
+						      const char
+						      *search_frame);
+
     RL2_PRIVATE int rl2_is_mixed_resolutions_coverage (sqlite3 * handle,
 						       const char *db_prefix,
 						       const char *coverage);
 
+    RL2_PRIVATE char *rl2_tile_content_hash (const unsigned char *blob_odd,
+					     int blob_odd_sz,
+					     const unsigned char *blob_even,
+					     int blob_even_sz);
+
+    RL2_PRIVATE char *rl2_resolve_tile_hash (sqlite3 * handle,
+					     const char *db_prefix,
+					     const char *coverage,
+					     const unsigned char *blob_odd,
+					     int blob_odd_sz,
+					     const unsigned char *blob_even,
+					     int blob_even_sz);
+
+    RL2_PRIVATE int rl2_is_dedup_coverage (sqlite3 * handle,
+					   const char *db_prefix,
+					   const char *coverage);
+
+    RL2_PRIVATE int rl2_purge_dedup_tiles (sqlite3 * handle,
+					   const char *coverage);
+
     RL2_PRIVATE int rl2_has_styled_rgb_colors (rl2RasterSymbolizerPtr style);
 
     RL2_PRIVATE int rl2_get_raw_raster_data_common (sqlite3 * handle,
@@ -2833,6 +3336,14 @@ extern "C"
 
     RL2_PRIVATE rl2GeometryPtr rl2_clone_polygons (rl2GeometryPtr in);
 
+    RL2_PRIVATE rl2GeometryPtr rl2_clip_geometry (rl2GeometryPtr geom,
+						  double minx, double miny,
+						  double maxx, double maxy,
+						  double tol_x, double tol_y);
+
+    RL2_PRIVATE rl2GeometryPtr rl2_simplify_geometry (rl2GeometryPtr geom,
+						      double tolerance);
+
     RL2_PRIVATE rl2GeometryPtr
 	rl2_build_circle (double x, double y, double radius);
 
@@ -2883,7 +3394,8 @@ extern "C"
 	rl2_load_cached_raster (sqlite3 * handle, const void *data,
 				const char *db_prefix, const char *coverage,
 				int pyramid_level, double x, double y,
-				rl2PalettePtr palette, rl2RasterPtr * raster);
+				rl2PalettePtr palette, rl2CoveragePtr cvg,
+				rl2RasterPtr * raster);
 
     RL2_PRIVATE void
 	rl2_destroy_private_tt_font (struct rl2_private_tt_font *font);
@@ -3058,6 +3570,75 @@ extern "C"
 					     double anchor_point_x,
 					     double anchor_point_y);
 
+    RL2_PRIVATE void *rl2_graph_create_band_context (void *ctx, int band_y,
+						     int band_height);
+
+    RL2_PRIVATE int rl2_graph_merge_band (void *ctx_out, void *band,
+					  int band_y);
+
+    RL2_PRIVATE rl2BandedRendererPtr rl2_create_banded_renderer (sqlite3 *
+								 handle,
+								 const void
+								 *priv_data,
+								 void *ctx,
+								 int width,
+								 int height,
+								 double minx,
+								 double miny,
+								 double maxx,
+								 double maxy,
+								 double x_res,
+								 double y_res);
+
+    RL2_PRIVATE void rl2_destroy_banded_renderer (rl2BandedRendererPtr
+						  renderer);
+
+    RL2_PRIVATE int rl2_banded_renderer_add (rl2BandedRendererPtr renderer,
+					     rl2GeometryPtr geom,
+					     rl2VectorSymbolizerPtr
+					     symbolizer,
+					     rl2VariantArrayPtr variant);
+
+    RL2_PRIVATE int rl2_banded_renderer_paint (rl2BandedRendererPtr
+					       renderer);
+
+    RL2_PRIVATE rl2LabelCandidatesPtr rl2_create_label_candidates (const char
+								   *db_prefix,
+								   const char
+								   *coverage,
+								   int width,
+								   int height,
+								   double minx,
+								   double miny,
+								   double maxx,
+								   double
+								   maxy);
+
+    RL2_PRIVATE void rl2_destroy_label_candidates (rl2LabelCandidatesPtr
+						   labels);
+
+    RL2_PRIVATE int rl2_add_label_candidates (rl2LabelCandidatesPtr labels,
+					      rl2VectorSymbolizerPtr
+					      symbolizer, rl2GeometryPtr geom,
+					      rl2VariantArrayPtr variant);
+
+    RL2_PRIVATE int rl2_match_label_candidates (rl2LabelCandidatesPtr labels,
+						const char *db_prefix,
+						const char *coverage,
+						int width, int height,
+						double minx, double miny,
+						double maxx, double maxy);
+
+    RL2_PRIVATE void rl2_draw_label_candidates (void *ctx, sqlite3 * handle,
+						const void *priv_data,
+						rl2LabelCandidatesPtr labels);
+
+    RL2_PRIVATE int rl2_set_canvas_retain_labels (rl2CanvasPtr canvas,
+						  int retain);
+
+    RL2_PRIVATE void rl2_move_canvas_labels (rl2CanvasPtr from,
+					     rl2CanvasPtr to);
+
     RL2_PRIVATE rl2PrivMapConfigAuxPtr rl2_create_map_config_aux (sqlite3 *
 								  sqlite,
 								  const void
@@ -3100,6 +3681,198 @@ extern "C"
 
     RL2_PRIVATE int rl2cr_endian_arch ();
 
+    RL2_PRIVATE struct rl2_perf_counters *rl2_alloc_perf_counters (void);
+
+    RL2_PRIVATE void rl2_destroy_perf_counters (struct rl2_perf_counters
+						*perf);
+
+    RL2_PRIVATE void rl2_reset_perf_counters (struct rl2_perf_counters *perf);
+
+    RL2_PRIVATE char *rl2_perf_counters_to_json (struct rl2_perf_counters
+						 *perf, int text_runs,
+						 int text_hits,
+						 int text_misses);
+
+    RL2_PRIVATE struct rl2_perf_counters *rl2_perf_get_thread_counters (void);
+
+    RL2_PRIVATE void rl2_perf_set_thread_counters (struct rl2_perf_counters
+						   *perf);
+
+    RL2_PRIVATE double rl2_perf_clock (void);
+
+    RL2_PRIVATE void rl2_perf_add (int stage, double start,
+				   sqlite3_int64 bytes);
+
+    RL2_PRIVATE void rl2_perf_begin_request (const void *priv_data,
+					     const char *request);
+
+    RL2_PRIVATE void rl2_perf_end_request (const void *priv_data);
+
+    RL2_PRIVATE struct rl2_cancel_token *rl2_alloc_cancel_token (void);
+
+    RL2_PRIVATE void rl2_destroy_cancel_token (struct rl2_cancel_token
+					       *token);
+
+    RL2_PRIVATE struct rl2_cancel_token *rl2_cancel_get_thread_token (void);
+
+    RL2_PRIVATE void rl2_cancel_set_thread_token (struct rl2_cancel_token
+						  *token);
+
+    RL2_PRIVATE int rl2_is_cancelled (void);
+
+    RL2_PRIVATE void rl2_cancel_begin_request (const void *priv_data,
+					       sqlite3 * handle);
+
+    RL2_PRIVATE void rl2_cancel_end_request (const void *priv_data);
+
+    RL2_PRIVATE void rl2_png_begin_request (const void *priv_data,
+					    sqlite3 * handle,
+					    const char *db_prefix,
+					    const char *coverage,
+					    const char *style);
+
+    RL2_PRIVATE void rl2_png_end_request (void);
+
+    RL2_PRIVATE const void *rl2_png_get_request (sqlite3 ** handle,
+						 const char **db_prefix,
+						 const char **coverage,
+						 const char **style);
+
+    RL2_PRIVATE int rl2_raster_encode_sparse (rl2RasterPtr rst,
+					      int compression,
+					      unsigned char **blob_odd,
+					      int *blob_odd_sz,
+					      unsigned char **blob_even,
+					      int *blob_even_sz, int quality,
+					      int little_endian,
+					      rl2CoveragePtr cvg);
+
+    RL2_PRIVATE int rl2_raster_encode_dict (rl2RasterPtr rst,
+					    int compression,
+					    unsigned char **blob_odd,
+					    int *blob_odd_sz,
+					    unsigned char **blob_even,
+					    int *blob_even_sz, int quality,
+					    int little_endian,
+					    rl2CoveragePtr cvg);
+
+    RL2_PRIVATE rl2RasterPtr rl2_raster_decode_dict (int scale,
+						     const unsigned char
+						     *blob_odd,
+						     int blob_odd_sz,
+						     const unsigned char
+						     *blob_even,
+						     int blob_even_sz,
+						     rl2PalettePtr ext_palette,
+						     rl2CoveragePtr cvg);
+
+    RL2_PRIVATE rl2RasterStatisticsPtr
+	rl2_get_raster_statistics_dict (const unsigned char *blob_odd,
+					int blob_odd_sz,
+					const unsigned char *blob_even,
+					int blob_even_sz,
+					rl2PalettePtr palette,
+					rl2PixelPtr noData,
+					rl2CoveragePtr cvg);
+
+    RL2_PRIVATE int rl2_is_uniform_tile (const unsigned char *blob_odd,
+					 int blob_odd_sz);
+
+    RL2_PRIVATE int rl2_get_zstd_payload (const unsigned char *blob,
+					  int blob_sz,
+					  unsigned char **payload,
+					  int *payload_sz,
+					  rl2CoveragePtr cvg);
+
+    RL2_PRIVATE size_t rl2_zstd_compress (void *dst, size_t dst_capacity,
+					  const void *src, size_t src_size,
+					  int level, rl2CoveragePtr cvg);
+
+    RL2_PRIVATE size_t rl2_zstd_decompress (void *dst, size_t dst_capacity,
+					    const void *src,
+					    size_t src_size,
+					    rl2CoveragePtr cvg);
+
+    RL2_PRIVATE int rl2_load_zstd_dictionaries (sqlite3 * handle,
+						const char *db_prefix,
+						rl2CoveragePtr cvg);
+
+    RL2_PRIVATE void rl2_release_zstd_dictionaries (rl2CoveragePtr cvg);
+
+    RL2_PRIVATE int rl2_train_zstd_dictionary (sqlite3 * handle,
+					       const char *coverage,
+					       int max_samples, int dict_size,
+					       unsigned int *dict_id);
+
+    RL2_PRIVATE int rl2_quantize_map_image (const void *priv_data, int width,
+					    int height,
+					    const unsigned char *rgb,
+					    unsigned char **pixbuf,
+					    rl2PalettePtr * palette);
+
+    RL2_PRIVATE struct rl2_text_cache *rl2_alloc_text_cache (void);
+
+    RL2_PRIVATE void rl2_destroy_text_cache (struct rl2_text_cache *cache);
+
+    RL2_PRIVATE int rl2_get_text_cache_stats (const void *priv_data,
+					      int *runs, int *hits,
+					      int *misses);
+
+    RL2_PRIVATE void rl2_reset_text_cache_stats (const void *priv_data);
+
+    RL2_PRIVATE struct rl2_metadata_cache *rl2_alloc_metadata_cache (void);
+
+    RL2_PRIVATE void rl2_destroy_metadata_cache (struct rl2_metadata_cache
+						 *cache);
+
+    RL2_PRIVATE void rl2_flush_metadata_cache (struct rl2_metadata_cache
+					       *cache);
+
+    RL2_PRIVATE rl2CoveragePtr rl2_get_cached_coverage (const void *priv_data,
+							sqlite3 * handle,
+							const char *db_prefix,
+							const char *coverage);
+
+    RL2_PRIVATE void rl2_sync_metadata_cache (const void *priv_data,
+					      sqlite3 * handle);
+
+    RL2_PRIVATE rl2CoverageStylePtr rl2_get_cached_coverage_style (sqlite3 *
+								   handle,
+								   rl2CoveragePtr
+								   cvg,
+								   const char
+								   *style);
+
+    RL2_PRIVATE rl2RasterStatisticsPtr
+	rl2_get_cached_raster_statistics (sqlite3 * handle,
+					  rl2CoveragePtr cvg);
+
+    RL2_PRIVATE rl2PalettePtr rl2_get_coverage_palette (sqlite3 * handle,
+							rl2CoveragePtr cvg);
+
+    RL2_PRIVATE struct rl2_cached_palette
+	*rl2_get_cached_quantize_palette (const void *priv_data,
+					  sqlite3 * handle,
+					  const char *db_prefix,
+					  const char *coverage,
+					  const char *style);
+
+    RL2_PRIVATE struct rl2_cached_palette
+	*rl2_add_cached_quantize_palette (const void *priv_data,
+					  sqlite3 * handle,
+					  const char *db_prefix,
+					  const char *coverage,
+					  const char *style);
+
+    RL2_PRIVATE int rl2_find_cached_best_resolution_level (rl2CoveragePtr
+							   cvg, double x_res,
+							   double y_res,
+							   int *level_id,
+							   int *scale,
+							   int *real_scale,
+							   double *xx_res,
+							   double *yy_res);
+
 #ifdef __cplusplus
 }
 #endif
@@ -132,6 +132,8 @@ extern "C"
 	double halo_blue;
 	double halo_alpha;
 	struct rl2_advanced_labeling *labeling;
+	struct rl2_text_cache *text_cache;
+	char *font_key;
     } RL2GraphContext;
     typedef RL2GraphContext *RL2GraphContextPtr;
 
@@ -170,6 +172,36 @@ extern "C"
     } RL2GraphFont;
     typedef RL2GraphFont *RL2GraphFontPtr;
 
+#define RL2_TEXT_CACHE_BUCKETS	1024
+#define RL2_TEXT_CACHE_MAX_RUNS	4096
+
+    struct rl2_text_run
+    {
+/* a shaped text string (glyph run) for a given Font */
+	char *font_key;
+	char *text;
+	unsigned int hash;
+	cairo_glyph_t *glyphs;
+	int num_glyphs;
+	cairo_text_extents_t extents;
+	struct rl2_text_run *hash_next;
+	struct rl2_text_run *prev;
+	struct rl2_text_run *next;
+    };
+
+    struct rl2_text_cache
+    {
+/* an LRU cache of shaped text strings */
+	void *mutex;
+	int count;
+	int max_runs;
+	int hits;
+	int misses;
+	struct rl2_text_run *buckets[RL2_TEXT_CACHE_BUCKETS];
+	struct rl2_text_run *first;	/* most recently used */
+	struct rl2_text_run *last;	/* least recently used */
+    };
+
     typedef struct rl2_graphics_bitmap
     {
 /* a Cairo based symbol bitmap */
@@ -647,6 +647,10 @@ rl2_create_coverage (const char *db_prefix, const char *name,
     cvg->sectionPaths = 0;
     cvg->sectionMD5 = 0;
     cvg->sectionSummary = 0;
+    cvg->cached = NULL;
+    cvg->zstdDictId = 0;
+    cvg->nZstdDicts = 0;
+    cvg->zstdDicts = NULL;
     return (rl2CoveragePtr) cvg;
 }
 
@@ -663,6 +667,7 @@ rl2_destroy_coverage (rl2CoveragePtr ptr)
 	free (cvg->coverageName);
     if (cvg->noData != NULL)
 	rl2_destroy_pixel ((rl2PixelPtr) (cvg->noData));
+    rl2_release_zstd_dictionaries (ptr);
     free (cvg);
 }
 
@@ -80,6 +80,13 @@ rl2_alloc_private (void)
     priv_data->pdf_paper_format = RL2_PDF_PAPER_FORMAT_A4;
     priv_data->pdf_dpi = RL2_PDF_DPI_300;
     priv_data->pdf_orientation = RL2_PDF_PORTRAIT;
+    priv_data->png_level = -1;
+    priv_data->png_filter = RL2_PNG_FILTER_ADAPTIVE;
+    priv_data->png8_dithering = 0;
+    priv_data->png8_stable_palette = 0;
+    priv_data->sparse_tiles = 0;
+    priv_data->section_checksum = RL2_CHECKSUM_MD5;
+    priv_data->parallel_vector = 0;
     priv_data->tmp_atm_table = NULL;
     struct rl2_private_map_canvas *canvas;
 
@@ -91,6 +98,7 @@ rl2_alloc_private (void)
 	priv_data->FTlibrary = library;
     priv_data->first_font = NULL;
     priv_data->last_font = NULL;
+    priv_data->text_cache = rl2_alloc_text_cache ();
     priv_data->raster_cache_items = 4;
     priv_data->raster_cache =
 	malloc (sizeof (struct rl2_cached_raster) *
@@ -125,6 +133,15 @@ rl2_alloc_private (void)
     labeling->label_shift_position = 0;
     labeling->first_rect = NULL;
     labeling->last_rect = NULL;
+
+/* initializing the Performance Counters */
+    priv_data->perf = rl2_alloc_perf_counters ();
+
+/* initializing the Cancellation Token */
+    priv_data->cancel = rl2_alloc_cancel_token ();
+
+/* initializing the Metadata Cache */
+    priv_data->meta_cache = rl2_alloc_metadata_cache ();
     return priv_data;
 }
 
@@ -198,6 +215,7 @@ rl2_cleanup_private (const void *ptr)
 	  rl2_destroy_private_tt_font (pF);
 	  pF = pFn;
       }
+    rl2_destroy_text_cache (priv_data->text_cache);
     if (priv_data->FTlibrary != NULL)
 	FT_Done_FreeType ((FT_Library) (priv_data->FTlibrary));
 
@@ -223,6 +241,9 @@ rl2_cleanup_private (const void *ptr)
     canvas = &(priv_data->map_canvas);
     if (canvas->ref_ctx != NULL)
 	rl2_graph_destroy_context (canvas->ref_ctx);
+    rl2_destroy_perf_counters (priv_data->perf);
+    rl2_destroy_cancel_token (priv_data->cancel);
+    rl2_destroy_metadata_cache (priv_data->meta_cache);
     free (priv_data);
 }
 
@@ -365,7 +386,8 @@ RL2_PRIVATE int
 rl2_load_cached_raster (sqlite3 * handle, const void *data,
 			const char *db_prefix, const char *coverage,
 			int pyramid_level, double x, double y,
-			rl2PalettePtr palette, rl2RasterPtr * raster)
+			rl2PalettePtr palette, rl2CoveragePtr cvg,
+			rl2RasterPtr * raster)
 {
 /* will load a new Raster object into the internal Cache */
     char *sql;
@@ -451,10 +473,11 @@ rl2_load_cached_raster (sqlite3 * handle, const void *data,
 		      blob_even = sqlite3_column_blob (stmt, 6);
 		      blob_even_sz = sqlite3_column_bytes (stmt, 6);
 		  }
-		xraster = rl2_raster_decode (RL2_SCALE_1,
-					     blob_odd,
-					     blob_odd_sz,
-					     blob_even, blob_even_sz, palette);
+		xraster = rl2_raster_decode_dict (RL2_SCALE_1,
+						  blob_odd,
+						  blob_odd_sz,
+						  blob_even, blob_even_sz,
+						  palette, cvg);
 		if (xraster == NULL)
 		    goto error;
 
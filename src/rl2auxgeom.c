@@ -3701,6 +3701,834 @@ rl2_clone_polygons (rl2GeometryPtr in)
     return out;
 }
 
+struct rl2_clip_buffer
+{
+/* a growable XY coordinate buffer used while clipping */
+    double *coords;
+    int points;
+    int max;
+};
+
+static void
+clip_buffer_reset (struct rl2_clip_buffer *buf)
+{
+/* releasing a clip buffer */
+    if (buf->coords != NULL)
+	free (buf->coords);
+    buf->coords = NULL;
+    buf->points = 0;
+    buf->max = 0;
+}
+
+static int
+clip_buffer_add (struct rl2_clip_buffer *buf, double x, double y)
+{
+/* appending a vertex into a clip buffer */
+    if (buf->points == buf->max)
+      {
+	  int max = (buf->max == 0) ? 64 : buf->max * 2;
+	  double *coords = realloc (buf->coords, sizeof (double) * 2 * max);
+	  if (coords == NULL)
+	      return 0;
+	  buf->coords = coords;
+	  buf->max = max;
+      }
+    buf->coords[buf->points * 2] = x;
+    buf->coords[buf->points * 2 + 1] = y;
+    buf->points += 1;
+    return 1;
+}
+
+static int
+clip_buffer_add_decimated (struct rl2_clip_buffer *buf, double x, double y,
+			   double tol_x, double tol_y, int force)
+{
+/*
+/ appending a vertex into a clip buffer, skipping sub-pixel steps
+/ from the previous one; a forced vertex (end of a path) always
+/ replaces a too close previous vertex
+*/
+    if (buf->points > 0)
+      {
+	  double *last = buf->coords + ((buf->points - 1) * 2);
+	  if (fabs (x - last[0]) < tol_x && fabs (y - last[1]) < tol_y)
+	    {
+		if (!force)
+		    return 1;
+		if (buf->points > 1)
+		  {
+		      last[0] = x;
+		      last[1] = y;
+		      return 1;
+		  }
+	    }
+      }
+    return clip_buffer_add (buf, x, y);
+}
+
+static int
+clip_coord_stride (int dims)
+{
+/* returns how many doubles are used by each vertex */
+    switch (dims)
+      {
+      case GAIA_XY_Z:
+      case GAIA_XY_M:
+	  return 3;
+      case GAIA_XY_Z_M:
+	  return 4;
+      };
+    return 2;
+}
+
+static int
+clip_segment (double minx, double miny, double maxx, double maxy,
+	      double *x0, double *y0, double *x1, double *y1)
+{
+/*
+/ Liang-Barsky segment clipping
+/ returns 0 if the segment is fully outside, otherwise 1
+/ (+2 if the start point was moved, +4 if the end point was moved)
+*/
+    double t0 = 0.0;
+    double t1 = 1.0;
+    double dx = *x1 - *x0;
+    double dy = *y1 - *y0;
+    double p[4];
+    double q[4];
+    int i;
+    int ret = 1;
+
+    p[0] = -dx;
+    q[0] = *x0 - minx;
+    p[1] = dx;
+    q[1] = maxx - *x0;
+    p[2] = -dy;
+    q[2] = *y0 - miny;
+    p[3] = dy;
+    q[3] = maxy - *y0;
+    for (i = 0; i < 4; i++)
+      {
+	  if (p[i] == 0.0)
+	    {
+		/* parallel to this clipping edge */
+		if (q[i] < 0.0)
+		    return 0;
+		continue;
+	    }
+	  if (p[i] < 0.0)
+	    {
+		double r = q[i] / p[i];
+		if (r > t1)
+		    return 0;
+		if (r > t0)
+		    t0 = r;
+	    }
+	  else
+	    {
+		double r = q[i] / p[i];
+		if (r < t0)
+		    return 0;
+		if (r < t1)
+		    t1 = r;
+	    }
+      }
+    if (t1 < 1.0)
+      {
+	  *x1 = *x0 + (t1 * dx);
+	  *y1 = *y0 + (t1 * dy);
+	  ret += 4;
+      }
+    if (t0 > 0.0)
+      {
+	  *x0 = *x0 + (t0 * dx);
+	  *y0 = *y0 + (t0 * dy);
+	  ret += 2;
+      }
+    return ret;
+}
+
+static void
+clip_flush_linestring (rl2GeometryPtr out, struct rl2_clip_buffer *buf)
+{
+/* moving a clipped path into the output Geometry */
+    rl2LinestringPtr ln;
+    int iv;
+    if (buf->points >= 2)
+      {
+	  ln = rl2AddLinestringToGeometry (out, buf->points);
+	  for (iv = 0; iv < buf->points; iv++)
+	    {
+		double x = buf->coords[iv * 2];
+		double y = buf->coords[iv * 2 + 1];
+		rl2SetPoint (ln->coords, iv, x, y);
+	    }
+      }
+    buf->points = 0;
+}
+
+static int
+clip_linestring (rl2GeometryPtr out, rl2LinestringPtr line, double minx,
+		 double miny, double maxx, double maxy, double tol_x,
+		 double tol_y, struct rl2_clip_buffer *buf)
+{
+/* clipping and decimating a Linestring (could produce many paths) */
+    int stride = clip_coord_stride (line->dims);
+    int iv;
+
+    buf->points = 0;
+    for (iv = 1; iv < line->points; iv++)
+      {
+	  double x0 = line->coords[(iv - 1) * stride];
+	  double y0 = line->coords[(iv - 1) * stride + 1];
+	  double x1 = line->coords[iv * stride];
+	  double y1 = line->coords[iv * stride + 1];
+	  int force;
+	  int ret = clip_segment (minx, miny, maxx, maxy, &x0, &y0, &x1, &y1);
+	  if (ret == 0)
+	    {
+		/* fully outside: closing the current path */
+		clip_flush_linestring (out, buf);
+		continue;
+	    }
+	  if (ret & 2)
+	    {
+		/* re-entering the frame: starting a new path */
+		clip_flush_linestring (out, buf);
+	    }
+	  if (buf->points == 0)
+	    {
+		if (!clip_buffer_add (buf, x0, y0))
+		    return 0;
+	    }
+	  force = ((ret & 4) || iv == line->points - 1) ? 1 : 0;
+	  if (!clip_buffer_add_decimated (buf, x1, y1, tol_x, tol_y, force))
+	      return 0;
+	  if (ret & 4)
+	    {
+		/* leaving the frame: closing the current path */
+		clip_flush_linestring (out, buf);
+	    }
+      }
+    clip_flush_linestring (out, buf);
+    return 1;
+}
+
+static int
+clip_ring_edge (struct rl2_clip_buffer *in, struct rl2_clip_buffer *out,
+		int edge, double value)
+{
+/*
+/ Sutherland-Hodgman: clipping an open ring against a single edge
+/ edge: 0=left, 1=right, 2=bottom, 3=top
+*/
+    int iv;
+    double px;
+    double py;
+    int prev_in;
+
+    out->points = 0;
+    if (in->points == 0)
+	return 1;
+    px = in->coords[(in->points - 1) * 2];
+    py = in->coords[(in->points - 1) * 2 + 1];
+    switch (edge)
+      {
+      case 0:
+	  prev_in = (px >= value);
+	  break;
+      case 1:
+	  prev_in = (px <= value);
+	  break;
+      case 2:
+	  prev_in = (py >= value);
+	  break;
+      default:
+	  prev_in = (py <= value);
+	  break;
+      };
+    for (iv = 0; iv < in->points; iv++)
+      {
+	  double cx = in->coords[iv * 2];
+	  double cy = in->coords[iv * 2 + 1];
+	  int cur_in;
+	  switch (edge)
+	    {
+	    case 0:
+		cur_in = (cx >= value);
+		break;
+	    case 1:
+		cur_in = (cx <= value);
+		break;
+	    case 2:
+		cur_in = (cy >= value);
+		break;
+	    default:
+		cur_in = (cy <= value);
+		break;
+	    };
+	  if (cur_in != prev_in)
+	    {
+		/* crossing the edge: adding the intersection point */
+		double ix;
+		double iy;
+		if (edge < 2)
+		  {
+		      ix = value;
+		      iy = py + ((value - px) / (cx - px)) * (cy - py);
+		  }
+		else
+		  {
+		      ix = px + ((value - py) / (cy - py)) * (cx - px);
+		      iy = value;
+		  }
+		if (!clip_buffer_add (out, ix, iy))
+		    return 0;
+	    }
+	  if (cur_in)
+	    {
+		if (!clip_buffer_add (out, cx, cy))
+		    return 0;
+	    }
+	  px = cx;
+	  py = cy;
+	  prev_in = cur_in;
+      }
+    return 1;
+}
+
+static int
+clip_ring (rl2RingPtr ring, double minx, double miny, double maxx,
+	   double maxy, double tol_x, double tol_y,
+	   struct rl2_clip_buffer *out, struct rl2_clip_buffer *tmp)
+{
+/*
+/ clipping and decimating a Ring
+/ on completion OUT will contain a closed ring (or no points at all)
+*/
+    int stride = clip_coord_stride (ring->dims);
+    int iv;
+    double rminx = DBL_MAX;
+    double rminy = DBL_MAX;
+    double rmaxx = 0.0 - DBL_MAX;
+    double rmaxy = 0.0 - DBL_MAX;
+    struct rl2_clip_buffer *src;
+    struct rl2_clip_buffer *dst;
+    struct rl2_clip_buffer *swap;
+
+    out->points = 0;
+    tmp->points = 0;
+    if (ring->points < 4)
+	return 1;
+    for (iv = 0; iv < ring->points - 1; iv++)
+      {
+	  /* copying the open ring */
+	  double x = ring->coords[iv * stride];
+	  double y = ring->coords[iv * stride + 1];
+	  if (x < rminx)
+	      rminx = x;
+	  if (x > rmaxx)
+	      rmaxx = x;
+	  if (y < rminy)
+	      rminy = y;
+	  if (y > rmaxy)
+	      rmaxy = y;
+	  if (!clip_buffer_add (tmp, x, y))
+	      return 0;
+      }
+    if (rminx > maxx || rmaxx < minx || rminy > maxy || rmaxy < miny)
+      {
+	  /* fully outside the frame */
+	  tmp->points = 0;
+	  return 1;
+      }
+    src = tmp;
+    dst = out;
+    if (rminx < minx || rmaxx > maxx || rminy < miny || rmaxy > maxy)
+      {
+	  /* crossing the frame: clipping against all four edges */
+	  if (!clip_ring_edge (src, dst, 0, minx))
+	      return 0;
+	  swap = src;
+	  src = dst;
+	  dst = swap;
+	  if (!clip_ring_edge (src, dst, 1, maxx))
+	      return 0;
+	  swap = src;
+	  src = dst;
+	  dst = swap;
+	  if (!clip_ring_edge (src, dst, 2, miny))
+	      return 0;
+	  swap = src;
+	  src = dst;
+	  dst = swap;
+	  if (!clip_ring_edge (src, dst, 3, maxy))
+	      return 0;
+	  swap = src;
+	  src = dst;
+	  dst = swap;
+      }
+
+/* decimating into DST (always OUT) and then closing the ring */
+    dst->points = 0;
+    for (iv = 0; iv < src->points; iv++)
+      {
+	  double x = src->coords[iv * 2];
+	  double y = src->coords[iv * 2 + 1];
+	  if (!clip_buffer_add_decimated (dst, x, y, tol_x, tol_y, 0))
+	      return 0;
+      }
+    src->points = 0;
+    if (dst->points < 3)
+      {
+	  /* degenerate ring */
+	  dst->points = 0;
+	  return 1;
+      }
+    if (!clip_buffer_add (dst, dst->coords[0], dst->coords[1]))
+	return 0;
+    return 1;
+}
+
+static void
+clip_copy_ring (rl2RingPtr ring, struct rl2_clip_buffer *buf)
+{
+/* copying a clipped ring into the output Polygon */
+    int iv;
+    for (iv = 0; iv < buf->points; iv++)
+      {
+	  double x = buf->coords[iv * 2];
+	  double y = buf->coords[iv * 2 + 1];
+	  rl2SetPoint (ring->coords, iv, x, y);
+      }
+}
+
+RL2_PRIVATE rl2GeometryPtr
+rl2_clip_geometry (rl2GeometryPtr geom, double minx, double miny,
+		   double maxx, double maxy, double tol_x, double tol_y)
+{
+/*
+/ natively clipping a Geometry against some rectangular frame
+/ (Liang-Barsky for Linestrings, Sutherland-Hodgman for Rings)
+/ and dropping all vertices closer than the given tolerances
+/ (i.e. sub-pixel steps) to the previous one
+/
+/ the returned Geometry is always XY, or NULL if nothing remains
+*/
+    rl2GeometryPtr out;
+    rl2PointPtr pt;
+    rl2LinestringPtr ln;
+    rl2PolygonPtr pg;
+    struct rl2_clip_buffer buf;
+    struct rl2_clip_buffer tmp;
+    struct rl2_clip_buffer *holes = NULL;
+    int max_holes = 0;
+    int n_points = 0;
+    int n_lines = 0;
+    int n_polygs = 0;
+    int ib;
+
+    if (geom == NULL)
+	return NULL;
+    buf.coords = NULL;
+    buf.points = 0;
+    buf.max = 0;
+    tmp.coords = NULL;
+    tmp.points = 0;
+    tmp.max = 0;
+    out = rl2CreateGeometry (GAIA_XY, geom->type);
+    out->srid = geom->srid;
+
+    pt = geom->first_point;
+    while (pt != NULL)
+      {
+	  /* Points: simply discarding all the outer ones */
+	  if (pt->x >= minx && pt->x <= maxx && pt->y >= miny
+	      && pt->y <= maxy)
+	    {
+		rl2AddPointXYToGeometry (out, pt->x, pt->y);
+		n_points++;
+	    }
+	  pt = pt->next;
+      }
+
+    ln = geom->first_linestring;
+    while (ln != NULL)
+      {
+	  /* Linestrings */
+	  if (!clip_linestring
+	      (out, ln, minx, miny, maxx, maxy, tol_x, tol_y, &buf))
+	      goto error;
+	  ln = ln->next;
+      }
+    ln = out->first_linestring;
+    while (ln != NULL)
+      {
+	  n_lines++;
+	  ln = ln->next;
+      }
+
+    pg = geom->first_polygon;
+    while (pg != NULL)
+      {
+	  /* Polygons */
+	  rl2PolygonPtr pg_out;
+	  int n_holes = 0;
+	  if (!clip_ring
+	      (pg->exterior, minx, miny, maxx, maxy, tol_x, tol_y, &buf, &tmp))
+	      goto error;
+	  if (buf.points == 0)
+	    {
+		/* the exterior ring is outside the frame */
+		pg = pg->next;
+		continue;
+	    }
+	  if (pg->num_interiors > max_holes)
+	    {
+		struct rl2_clip_buffer *p =
+		    realloc (holes,
+			     sizeof (struct rl2_clip_buffer) *
+			     pg->num_interiors);
+		if (p == NULL)
+		    goto error;
+		holes = p;
+		for (ib = max_holes; ib < pg->num_interiors; ib++)
+		  {
+		      holes[ib].coords = NULL;
+		      holes[ib].points = 0;
+		      holes[ib].max = 0;
+		  }
+		max_holes = pg->num_interiors;
+	    }
+	  for (ib = 0; ib < pg->num_interiors; ib++)
+	    {
+		struct rl2_clip_buffer *hole = holes + n_holes;
+		if (!clip_ring
+		    (pg->interiors + ib, minx, miny, maxx, maxy, tol_x, tol_y,
+		     hole, &tmp))
+		    goto error;
+		if (hole->points > 0)
+		    n_holes++;
+	    }
+	  pg_out = rl2AddPolygonToGeometry (out, buf.points, n_holes);
+	  clip_copy_ring (pg_out->exterior, &buf);
+	  for (ib = 0; ib < n_holes; ib++)
+	    {
+		rl2RingPtr rng =
+		    rl2AddInteriorRing (pg_out, ib, holes[ib].points);
+		clip_copy_ring (rng, holes + ib);
+	    }
+	  n_polygs++;
+	  pg = pg->next;
+      }
+
+    clip_buffer_reset (&buf);
+    clip_buffer_reset (&tmp);
+    for (ib = 0; ib < max_holes; ib++)
+	clip_buffer_reset (holes + ib);
+    if (holes != NULL)
+	free (holes);
+    if (n_points == 0 && n_lines == 0 && n_polygs == 0)
+      {
+	  rl2_destroy_geometry (out);
+	  return NULL;
+      }
+    if (out->type == GAIA_LINESTRING && n_lines > 1)
+	out->type = GAIA_MULTILINESTRING;
+    if (out->type == GAIA_POLYGON && n_polygs > 1)
+	out->type = GAIA_MULTIPOLYGON;
+    do_update_mbr (out);
+    return out;
+
+  error:
+    clip_buffer_reset (&buf);
+    clip_buffer_reset (&tmp);
+    for (ib = 0; ib < max_holes; ib++)
+	clip_buffer_reset (holes + ib);
+    if (holes != NULL)
+	free (holes);
+    rl2_destroy_geometry (out);
+    return NULL;
+}
+
+static double
+simplify_sq_dist (double x, double y, double x0, double y0, double x1,
+		  double y1)
+{
+/* squared distance between a Point and a Segment */
+    double dx = x1 - x0;
+    double dy = y1 - y0;
+    double len2 = (dx * dx) + (dy * dy);
+    double t;
+    if (len2 > 0.0)
+      {
+	  t = (((x - x0) * dx) + ((y - y0) * dy)) / len2;
+	  if (t > 1.0)
+	    {
+		x0 = x1;
+		y0 = y1;
+	    }
+	  else if (t > 0.0)
+	    {
+		x0 += dx * t;
+		y0 += dy * t;
+	    }
+      }
+    dx = x - x0;
+    dy = y - y0;
+    return (dx * dx) + (dy * dy);
+}
+
+static int
+simplify_path (const double *coords, int stride, int points,
+	       double tolerance, struct rl2_clip_buffer *out)
+{
+/*
+/ Douglas-Peucker simplification of a path (iterative, so to safely
+/ support paths of any length); on completion OUT will contain all
+/ the retained vertices (always including the first and last one)
+*/
+    unsigned char *keep;
+    int *stack;
+    int top = 0;
+    int iv;
+    double sq_tol = tolerance * tolerance;
+
+    out->points = 0;
+    if (points < 2)
+	return 1;
+    keep = calloc (points, sizeof (unsigned char));
+    stack = malloc (sizeof (int) * 2 * points);
+    if (keep == NULL || stack == NULL)
+      {
+	  if (keep != NULL)
+	      free (keep);
+	  if (stack != NULL)
+	      free (stack);
+	  return 0;
+      }
+    keep[0] = 1;
+    keep[points - 1] = 1;
+    stack[top++] = 0;
+    stack[top++] = points - 1;
+    while (top > 0)
+      {
+	  int last = stack[--top];
+	  int first = stack[--top];
+	  int max_iv = -1;
+	  double max_dist = sq_tol;
+	  double x0 = coords[first * stride];
+	  double y0 = coords[first * stride + 1];
+	  double x1 = coords[last * stride];
+	  double y1 = coords[last * stride + 1];
+	  for (iv = first + 1; iv < last; iv++)
+	    {
+		double d = simplify_sq_dist (coords[iv * stride],
+					     coords[iv * stride + 1], x0, y0,
+					     x1, y1);
+		if (d > max_dist)
+		  {
+		      max_dist = d;
+		      max_iv = iv;
+		  }
+	    }
+	  if (max_iv < 0)
+	      continue;
+	  keep[max_iv] = 1;
+	  stack[top++] = first;
+	  stack[top++] = max_iv;
+	  stack[top++] = max_iv;
+	  stack[top++] = last;
+      }
+    for (iv = 0; iv < points; iv++)
+      {
+	  if (!keep[iv])
+	      continue;
+	  if (!clip_buffer_add
+	      (out, coords[iv * stride], coords[iv * stride + 1]))
+	    {
+		free (keep);
+		free (stack);
+		return 0;
+	    }
+      }
+    free (keep);
+    free (stack);
+    return 1;
+}
+
+static int
+simplify_ring (rl2RingPtr ring, double tolerance, struct rl2_clip_buffer *out)
+{
+/*
+/ simplifying a Ring; on completion OUT will contain a closed
+/ ring, or no points at all if the ring collapsed
+*/
+    int stride = clip_coord_stride (ring->dims);
+    int iv;
+    double minx = DBL_MAX;
+    double miny = DBL_MAX;
+    double maxx = 0.0 - DBL_MAX;
+    double maxy = 0.0 - DBL_MAX;
+
+    out->points = 0;
+    if (ring->points < 4)
+	return 1;
+    for (iv = 0; iv < ring->points; iv++)
+      {
+	  double x = ring->coords[iv * stride];
+	  double y = ring->coords[iv * stride + 1];
+	  if (x < minx)
+	      minx = x;
+	  if (x > maxx)
+	      maxx = x;
+	  if (y < miny)
+	      miny = y;
+	  if (y > maxy)
+	      maxy = y;
+      }
+    if ((maxx - minx) < tolerance && (maxy - miny) < tolerance)
+	return 1;		/* too small to be ever noticed */
+    if (!simplify_path (ring->coords, stride, ring->points, tolerance, out))
+	return 0;
+    if (out->points < 4)
+	out->points = 0;	/* degenerate ring */
+    return 1;
+}
+
+RL2_PRIVATE rl2GeometryPtr
+rl2_simplify_geometry (rl2GeometryPtr geom, double tolerance)
+{
+/*
+/ natively simplifying a Geometry (Douglas-Peucker), so that
+/ no vertex will move more than the given tolerance; Rings
+/ smaller than the tolerance will be discarded at all
+/
+/ the returned Geometry is always XY, or NULL if nothing remains
+*/
+    rl2GeometryPtr out;
+    rl2PointPtr pt;
+    rl2LinestringPtr ln;
+    rl2PolygonPtr pg;
+    struct rl2_clip_buffer buf;
+    struct rl2_clip_buffer *holes = NULL;
+    int max_holes = 0;
+    int n_points = 0;
+    int n_lines = 0;
+    int n_polygs = 0;
+    int ib;
+
+    if (geom == NULL)
+	return NULL;
+    buf.coords = NULL;
+    buf.points = 0;
+    buf.max = 0;
+    out = rl2CreateGeometry (GAIA_XY, geom->type);
+    out->srid = geom->srid;
+
+    pt = geom->first_point;
+    while (pt != NULL)
+      {
+	  /* Points: simply copied */
+	  rl2AddPointXYToGeometry (out, pt->x, pt->y);
+	  n_points++;
+	  pt = pt->next;
+      }
+
+    ln = geom->first_linestring;
+    while (ln != NULL)
+      {
+	  /* Linestrings */
+	  if (!simplify_path
+	      (ln->coords, clip_coord_stride (ln->dims), ln->points, tolerance,
+	       &buf))
+	      goto error;
+	  if (buf.points >= 2)
+	    {
+		clip_flush_linestring (out, &buf);
+		n_lines++;
+	    }
+	  ln = ln->next;
+      }
+
+    pg = geom->first_polygon;
+    while (pg != NULL)
+      {
+	  /* Polygons */
+	  rl2PolygonPtr pg_out;
+	  int n_holes = 0;
+	  if (!simplify_ring (pg->exterior, tolerance, &buf))
+	      goto error;
+	  if (buf.points == 0)
+	    {
+		/* the exterior ring collapsed */
+		pg = pg->next;
+		continue;
+	    }
+	  if (pg->num_interiors > max_holes)
+	    {
+		struct rl2_clip_buffer *p =
+		    realloc (holes,
+			     sizeof (struct rl2_clip_buffer) *
+			     pg->num_interiors);
+		if (p == NULL)
+		    goto error;
+		holes = p;
+		for (ib = max_holes; ib < pg->num_interiors; ib++)
+		  {
+		      holes[ib].coords = NULL;
+		      holes[ib].points = 0;
+		      holes[ib].max = 0;
+		  }
+		max_holes = pg->num_interiors;
+	    }
+	  for (ib = 0; ib < pg->num_interiors; ib++)
+	    {
+		struct rl2_clip_buffer *hole = holes + n_holes;
+		if (!simplify_ring (pg->interiors + ib, tolerance, hole))
+		    goto error;
+		if (hole->points > 0)
+		    n_holes++;
+	    }
+	  pg_out = rl2AddPolygonToGeometry (out, buf.points, n_holes);
+	  clip_copy_ring (pg_out->exterior, &buf);
+	  for (ib = 0; ib < n_holes; ib++)
+	    {
+		rl2RingPtr rng =
+		    rl2AddInteriorRing (pg_out, ib, holes[ib].points);
+		clip_copy_ring (rng, holes + ib);
+	    }
+	  n_polygs++;
+	  pg = pg->next;
+      }
+
+    clip_buffer_reset (&buf);
+    for (ib = 0; ib < max_holes; ib++)
+	clip_buffer_reset (holes + ib);
+    if (holes != NULL)
+	free (holes);
+    if (n_points == 0 && n_lines == 0 && n_polygs == 0)
+      {
+	  rl2_destroy_geometry (out);
+	  return NULL;
+      }
+    if (out->type == GAIA_LINESTRING && n_lines > 1)
+	out->type = GAIA_MULTILINESTRING;
+    if (out->type == GAIA_POLYGON && n_polygs > 1)
+	out->type = GAIA_MULTIPOLYGON;
+    do_update_mbr (out);
+    return out;
+
+  error:
+    clip_buffer_reset (&buf);
+    for (ib = 0; ib < max_holes; ib++)
+	clip_buffer_reset (holes + ib);
+    if (holes != NULL)
+	free (holes);
+    rl2_destroy_geometry (out);
+    return NULL;
+}
+
 RL2_PRIVATE rl2GeometryPtr
 rl2_build_circle (double cx, double cy, double radius)
 {
@@ -1010,194 +1010,472 @@ RL2_PRIVATE int
 rl2_aux_render_image (struct aux_renderer *aux)
 {
 /* rendering a raster image */
+    int ret;
+    double t0 = rl2_perf_clock ();
     if (aux->is_blob_image == 0)
-	return do_aux_render_image_graphics (aux);
+	ret = do_aux_render_image_graphics (aux);
     else
-	return do_aux_render_image_blob (aux);
+	ret = do_aux_render_image_blob (aux);
+    rl2_perf_add (RL2_PERF_RENDER, t0, 0);
+    return ret;
 }
 
-static void
-do_copy_rgb (unsigned char *out, const unsigned char *in, unsigned int width,
-	     unsigned int height, unsigned int w, unsigned int h,
-	     int base_x, int base_y, unsigned char bg_red,
-	     unsigned char bg_green, unsigned char bg_blue)
+struct mixed_compositor
 {
-/* copying RGB pixels */
-    int x;
-    int y;
-    unsigned char r;
-    unsigned char g;
-    unsigned char b;
-    unsigned char *p_out;
-    const unsigned char *p_in = in;
+/* common arguments shared by all Mixed Resolutions Section decoders */
+    sqlite3 *handle;
+    rl2CoveragePtr cvg;
+    int transparent;
+    unsigned char out_pixel;
+    rl2PixelPtr no_data;
+    rl2RasterSymbolizerPtr style;
+    rl2RasterStatisticsPtr stats;
+    rl2PalettePtr *palette;
+};
+
+struct mixed_section
+{
+/* a Section to be composited into a Mixed Resolutions output */
+    struct mixed_compositor *comp;
+    sqlite3_int64 section_id;
+    double minx;
+    double miny;
+    double maxx;
+    double maxy;
+    double xx_res;
+    double yy_res;
+    unsigned int w;
+    unsigned int h;
+    unsigned int w2;
+    unsigned int h2;
+    int base_x;
+    int base_y;
+    unsigned char *bufpix;
+    int bufpix_size;
+    unsigned char *bufmask;
+    int bufmask_size;
+    rl2PalettePtr palette;
+};
+
+static int
+do_decode_mixed_section (struct mixed_section *sect, int max_threads)
+{
+/*
+/ decoding (and rescaling) the visible portion of a single Section
+/
+/ all SQL queries (Tiles and BLOBs) are always performed by the calling
+/ thread, while the Tiles are concurrently decoded and composited by
+/ up to max_threads children threads
+*/
+    struct mixed_compositor *comp = sect->comp;
+    rl2PalettePtr *palette = NULL;
+    int ret;
+
+    if (comp->palette != NULL)
+	palette = &(sect->palette);
+    if (comp->transparent)
+	ret =
+	    rl2_get_raw_raster_data_common_transparent (comp->handle,
+							max_threads,
+							comp->cvg, 1,
+							sect->section_id,
+							sect->w, sect->h,
+							sect->minx, sect->miny,
+							sect->maxx, sect->maxy,
+							sect->xx_res,
+							sect->yy_res,
+							&(sect->bufpix),
+							&(sect->bufpix_size),
+							&(sect->bufmask),
+							&(sect->bufmask_size),
+							RL2_SYNTETIC_NONE,
+							palette,
+							comp->out_pixel,
+							comp->no_data,
+							comp->style,
+							comp->stats);
+    else
+	ret =
+	    rl2_get_raw_raster_data_common (comp->handle, max_threads,
+					    comp->cvg, 1, sect->section_id,
+					    sect->w, sect->h, sect->minx,
+					    sect->miny, sect->maxx, sect->maxy,
+					    sect->xx_res, sect->yy_res,
+					    &(sect->bufpix),
+					    &(sect->bufpix_size),
+					    RL2_SYNTETIC_NONE, palette,
+					    comp->out_pixel, comp->no_data,
+					    comp->style, comp->stats);
+    if (ret != RL2_OK)
+	goto error;
 
-    for (y = 0; y < (int) h; y++)
+    if (sect->w != sect->w2 || sect->h != sect->h2)
       {
-	  if ((base_y + y) >= (int) height)
-	      break;
-	  if ((base_y + y) < 0)
-	    {
-		p_in += w * 3;
-		continue;
-	    }
-	  for (x = 0; x < (int) w; x++)
+	  /* rescaling the pixbuf */
+	  unsigned char *rescaled = NULL;
+	  unsigned char *rescaled_mask = NULL;
+	  int pix_sz = 1;
+	  if (comp->out_pixel == RL2_PIXEL_RGB)
+	      pix_sz = 3;
+	  rescaled = malloc (pix_sz * sect->w2 * sect->h2);
+	  if (rescaled == NULL)
+	      goto error;
+	  if (comp->transparent)
 	    {
-		if ((base_x + x) < 0 || (base_x + x) >= (int) width)
-		  {
-		      p_in += 3;
-		      continue;
-		  }
-		p_out = out + ((base_y + y) * width * 3) + ((base_x + x) * 3);
-		r = *p_in++;
-		g = *p_in++;
-		b = *p_in++;
-		if (r == bg_red && g == bg_green && b == bg_blue)
+		rescaled_mask = malloc (sect->w2 * sect->h2);
+		if (rescaled_mask == NULL)
 		  {
-		      /* transparent pixel */
-		      p_out += 3;
-		  }
-		else
-		  {
-		      /* opaque pixel */
-		      *p_out++ = r;
-		      *p_out++ = g;
-		      *p_out++ = b;
+		      free (rescaled);
+		      goto error;
 		  }
+		ret =
+		    rl2_rescale_pixbuf_transparent (sect->bufpix,
+						    sect->bufmask, sect->w,
+						    sect->h, comp->out_pixel,
+						    rescaled, rescaled_mask,
+						    sect->w2, sect->h2);
 	    }
+	  else
+	      ret =
+		  rl2_rescale_pixbuf (sect->bufpix, sect->w, sect->h,
+				      comp->out_pixel, rescaled, sect->w2,
+				      sect->h2);
+	  if (!ret)
+	    {
+		free (rescaled);
+		if (rescaled_mask != NULL)
+		    free (rescaled_mask);
+		goto error;
+	    }
+	  free (sect->bufpix);
+	  sect->bufpix = rescaled;
+	  if (sect->bufmask != NULL)
+	      free (sect->bufmask);
+	  sect->bufmask = rescaled_mask;
       }
+    return 1;
+
+  error:
+    return 0;
 }
 
-static void
-do_copy_gray (unsigned char *out, const unsigned char *in, unsigned int width,
-	      unsigned int height, unsigned int w, unsigned int h,
-	      int base_x, int base_y, unsigned char bg_gray)
+static int
+is_mixed_section_hidden (const unsigned char *covered, unsigned int width,
+			 unsigned int height, struct mixed_section *sect)
 {
-/* copying Grayscale pixels */
+/* testing if a Section is fully hidden under already composited pixels */
     int x;
     int y;
-    unsigned char gray;
-    unsigned char *p_out;
-    const unsigned char *p_in = in;
-
-    for (y = 0; y < (int) h; y++)
+    int x0 = sect->base_x;
+    int y0 = sect->base_y;
+    int x1 = sect->base_x + (int) (sect->w2);
+    int y1 = sect->base_y + (int) (sect->h2);
+    if (x0 < 0)
+	x0 = 0;
+    if (y0 < 0)
+	y0 = 0;
+    if (x1 > (int) width)
+	x1 = width;
+    if (y1 > (int) height)
+	y1 = height;
+    for (y = y0; y < y1; y++)
       {
-	  if ((base_y + y) >= (int) height)
-	      break;
-	  if ((base_y + y) < 0)
+	  const unsigned char *p = covered + (y * width) + x0;
+	  for (x = x0; x < x1; x++)
 	    {
-		p_in += w;
-		continue;
-	    }
-	  for (x = 0; x < (int) w; x++)
-	    {
-		if ((base_x + x) < 0 || (base_x + x) >= (int) width)
-		  {
-		      p_in++;
-		      continue;
-		  }
-		p_out = out + ((base_y + y) * width) + (base_x + x);
-		gray = *p_in++;
-		if (gray == bg_gray)
-		  {
-		      /* transparent pixel */
-		      p_out++;
-		  }
-		else
-		  {
-		      /* opaque pixel */
-		      *p_out++ = gray;
-		  }
+		if (*p++ == 0)
+		    return 0;
 	    }
       }
+    return 1;
 }
 
 static void
-do_copy_rgb_transparent (unsigned char *out, unsigned char *out_mask,
-			 const unsigned char *in, const unsigned char *mask,
-			 unsigned int width, unsigned int height,
-			 unsigned int w, unsigned int h, int base_x, int base_y)
+do_blend_mixed_section (struct mixed_section *sect, unsigned char *outbuf,
+			unsigned char *outmask, unsigned char *covered,
+			unsigned int width, unsigned int height,
+			unsigned char bg_red, unsigned char bg_green,
+			unsigned char bg_blue)
 {
-/* copying RGB pixels */
+/*
+/ blending a decoded Section into the output
+/ Sections are blended front-to-back, so only still uncovered output
+/ pixels are painted; transparent pixels (matching the background color
+/ or masked) leave the underlying Sections visible
+*/
+    struct mixed_compositor *comp = sect->comp;
+    int pix_sz = (comp->out_pixel == RL2_PIXEL_RGB) ? 3 : 1;
     int x;
     int y;
-    unsigned char *p_out;
-    unsigned char *p_outmsk;
-    const unsigned char *p_in = in;
-    const unsigned char *p_msk = mask;
 
-    for (y = 0; y < (int) h; y++)
+    for (y = 0; y < (int) (sect->h2); y++)
       {
-	  if ((base_y + y) >= (int) height)
+	  int out_y = sect->base_y + y;
+	  if (out_y < 0)
+	      continue;
+	  if (out_y >= (int) height)
 	      break;
-	  if ((base_y + y) < 0)
+	  for (x = 0; x < (int) (sect->w2); x++)
 	    {
-		p_in += w * 3;
-		p_msk += w;
-		continue;
-	    }
-	  for (x = 0; x < (int) w; x++)
-	    {
-		if ((base_x + x) < 0 || (base_x + x) >= (int) width)
+		int out_x = sect->base_x + x;
+		int in_idx = (y * sect->w2) + x;
+		int out_idx = (out_y * width) + out_x;
+		const unsigned char *p_in;
+		unsigned char *p_out;
+		if (out_x < 0 || out_x >= (int) width)
+		    continue;
+		if (covered[out_idx])
+		    continue;
+		p_in = sect->bufpix + (in_idx * pix_sz);
+		if (comp->transparent)
 		  {
-		      p_in += 3;
-		      p_msk++;
-		      continue;
+		      if (sect->bufmask != NULL && sect->bufmask[in_idx] != 0)
+			  continue;	/* transparent pixel */
+		      outmask[out_idx] = 0;
 		  }
-		p_out = out + ((base_y + y) * width * 3) + ((base_x + x) * 3);
-		p_outmsk = out_mask + ((base_y + y) * width) + (base_x + x);
-		*p_out++ = *p_in++;
-		*p_out++ = *p_in++;
-		*p_out++ = *p_in++;
-		if (p_msk != NULL)
-		    *p_outmsk++ = *p_msk++;
 		else
-		    *p_outmsk++ = 0;
+		  {
+		      if (pix_sz == 3)
+			{
+			    if (p_in[0] == bg_red && p_in[1] == bg_green
+				&& p_in[2] == bg_blue)
+				continue;	/* transparent pixel */
+			}
+		      else if (p_in[0] == bg_red)
+			  continue;	/* transparent pixel */
+		  }
+		p_out = outbuf + (out_idx * pix_sz);
+		*p_out++ = *p_in++;
+		if (pix_sz == 3)
+		  {
+		      *p_out++ = *p_in++;
+		      *p_out++ = *p_in++;
+		  }
+		covered[out_idx] = 1;
 	    }
       }
 }
 
 static void
-do_copy_gray_transparent (unsigned char *out, unsigned char *out_mask,
-			  const unsigned char *in, const unsigned char *mask,
-			  unsigned int width, unsigned int height,
-			  unsigned int w, unsigned int h, int base_x,
-			  int base_y)
+do_cleanup_mixed_section (struct mixed_section *sect)
 {
-/* copying Grayscale pixels */
-    int x;
-    int y;
-    unsigned char *p_out;
-    unsigned char *p_outmsk;
-    const unsigned char *p_in = in;
-    const unsigned char *p_msk = mask;
+/* releasing the decoded buffers of some Section */
+    if (sect->bufpix != NULL)
+	free (sect->bufpix);
+    if (sect->bufmask != NULL)
+	free (sect->bufmask);
+    sect->bufpix = NULL;
+    sect->bufmask = NULL;
+}
 
-    for (y = 0; y < (int) h; y++)
+static int
+do_composite_mixed_sections (struct mixed_compositor *comp, int max_threads,
+			     unsigned int width, unsigned int height,
+			     double minx, double miny, double maxx,
+			     double maxy, double x_res, double y_res,
+			     unsigned char *outbuf, unsigned char *outmask,
+			     unsigned char bg_red, unsigned char bg_green,
+			     unsigned char bg_blue)
+{
+/*
+/ occlusion-aware compositing of all Sections intersecting the output
+/
+/ Sections are visited front-to-back (the most recent Section is the
+/ topmost one) while tracking which output pixels are already painted;
+/ Sections fully hidden under already painted pixels are culled before
+/ any decoding, and still visible ones are decoded one at a time (their
+/ Tiles being decoded by up to max_threads concurrent threads) and then
+/ blended in priority order
+*/
+    sqlite3 *handle = comp->handle;
+    const char *db_prefix;
+    const char *coverage;
+    char *xdb_prefix;
+    char *xsections;
+    char *xxsections;
+    char *sql;
+    sqlite3_stmt *stmt = NULL;
+    int ret;
+    struct mixed_section *sections = NULL;
+    unsigned char *covered = NULL;
+    int count = 0;
+    int max_count = 0;
+    int i;
+    double img_res_x = (maxx - minx) / (double) width;
+    double img_res_y = (maxy - miny) / (double) height;
+
+    db_prefix = rl2_get_coverage_prefix (comp->cvg);
+    coverage = rl2_get_coverage_name (comp->cvg);
+
+/* preparing the "sections" SQL query */
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    xsections = sqlite3_mprintf ("%s_sections", coverage);
+    xxsections = rl2_double_quoted_sql (xsections);
+    sqlite3_free (xsections);
+    xsections = sqlite3_mprintf ("DB=%s.%s_sections", db_prefix, coverage);
+    sql =
+	sqlite3_mprintf
+	("SELECT section_id, MbrMinX(geometry), MbrMinY(geometry), "
+	 "MbrMaxX(geometry), MbrMaxY(geometry) "
+	 "FROM \"%s\".\"%s\" WHERE ROWID IN ( "
+	 "SELECT ROWID FROM SpatialIndex WHERE f_table_name = %Q "
+	 "AND search_frame = BuildMBR(?, ?, ?, ?)) ORDER BY section_id",
+	 xdb_prefix, xxsections, xsections);
+    sqlite3_free (xsections);
+    free (xdb_prefix);
+    free (xxsections);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
       {
-	  if ((base_y + y) >= (int) height)
-	      break;
-	  if ((base_y + y) < 0)
-	    {
-		p_in += w;
-		p_msk += w;
-		continue;
-	    }
-	  for (x = 0; x < (int) w; x++)
+	  printf ("SELECT mixed-res Sections SQL error: %s\n",
+		  sqlite3_errmsg (handle));
+	  goto error;
+      }
+
+/* collecting all Sections intersecting the output (in priority order) */
+    sqlite3_reset (stmt);
+    sqlite3_clear_bindings (stmt);
+    sqlite3_bind_double (stmt, 1, minx);
+    sqlite3_bind_double (stmt, 2, miny);
+    sqlite3_bind_double (stmt, 3, maxx);
+    sqlite3_bind_double (stmt, 4, maxy);
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
 	    {
-		if ((base_x + x) < 0 || (base_x + x) >= (int) width)
+		struct mixed_section *sect;
+		double mnx = minx;
+		double mny = miny;
+		double mxx = maxx;
+		double mxy = maxy;
+		double section_minx = sqlite3_column_double (stmt, 1);
+		double section_miny = sqlite3_column_double (stmt, 2);
+		double section_maxx = sqlite3_column_double (stmt, 3);
+		double section_maxy = sqlite3_column_double (stmt, 4);
+		/* normalizing the visible portion of the Section */
+		if (mnx < section_minx)
+		    mnx = section_minx;
+		if (mny < section_miny)
+		    mny = section_miny;
+		if (mxx > section_maxx)
+		    mxx = section_maxx;
+		if (mxy > section_maxy)
+		    mxy = section_maxy;
+		if (mxx <= mnx || mxy <= mny)
+		    continue;
+		if (count == max_count)
 		  {
-		      p_in++;
-		      p_msk++;
-		      continue;
+		      int max = (max_count == 0) ? 64 : max_count * 2;
+		      struct mixed_section *p =
+			  realloc (sections,
+				   sizeof (struct mixed_section) * max);
+		      if (p == NULL)
+			  goto error;
+		      sections = p;
+		      max_count = max;
 		  }
-		p_out = out + ((base_y + y) * width) + (base_x + x);
-		p_outmsk = out_mask + ((base_y + y) * width) + (base_x + x);
-		*p_out++ = *p_in++;
-		if (p_msk != NULL)
-		    *p_outmsk++ = *p_msk++;
-		else
-		    *p_outmsk++ = 0;
+		sect = sections + count++;
+		memset (sect, 0, sizeof (struct mixed_section));
+		sect->comp = comp;
+		sect->section_id = sqlite3_column_int64 (stmt, 0);
+		sect->minx = mnx;
+		sect->miny = mny;
+		sect->maxx = mxx;
+		sect->maxy = mxy;
+		sect->w2 = (unsigned int) ((mxx - mnx) / img_res_x);
+		if (((double) (sect->w2) * img_res_x) < (mxx - mnx))
+		    sect->w2 += 1;
+		sect->h2 = (unsigned int) ((mxy - mny) / img_res_y);
+		if (((double) (sect->h2) * img_res_y) < (mxy - mny))
+		    sect->h2 += 1;
+		sect->base_x = (int) ((mnx - minx) / img_res_x);
+		sect->base_y = (int) ((maxy - mxy) / img_res_y);
+	    }
+	  else
+	    {
+		fprintf (stderr, "SQL error: %s\n", sqlite3_errmsg (handle));
+		goto error;
 	    }
       }
+    sqlite3_finalize (stmt);
+    stmt = NULL;
+    if (count == 0)
+	return 1;
+
+    covered = calloc (width * height, 1);
+    if (covered == NULL)
+	goto error;
+
+    for (i = count - 1; i >= 0; i--)
+      {
+	  /* decoding and blending all visible Sections (topmost first) */
+	  struct mixed_section *sect = sections + i;
+	  int level_id;
+	  int scale;
+	  int xscale;
+	  if (is_mixed_section_hidden (covered, width, height, sect))
+	      continue;		/* culling a fully hidden Section */
+	  /* retrieving the optimal resolution level */
+	  if (!rl2_find_best_resolution_level
+	      (handle, db_prefix, coverage, 1, sect->section_id, x_res,
+	       y_res, &level_id, &scale, &xscale, &(sect->xx_res),
+	       &(sect->yy_res)))
+	      goto error;
+	  sect->w = (unsigned int) ((sect->maxx - sect->minx) / sect->xx_res);
+	  if (((double) (sect->w) * sect->xx_res) < (sect->maxx - sect->minx))
+	      sect->w += 1;
+	  sect->h = (unsigned int) ((sect->maxy - sect->miny) / sect->yy_res);
+	  if (((double) (sect->h) * sect->yy_res) < (sect->maxy - sect->miny))
+	      sect->h += 1;
+	  if (!do_decode_mixed_section (sect, max_threads))
+	    {
+		fprintf (stderr, "mixed-res: unable to decode Section %lld\n",
+			 (long long) (sect->section_id));
+		goto error;
+	    }
+	  do_blend_mixed_section (sect, outbuf, outmask, covered, width,
+				  height, bg_red, bg_green, bg_blue);
+	  do_cleanup_mixed_section (sect);
+      }
+
+/* returning the palette (if any) of the topmost decoded Section */
+    for (i = count - 1; i >= 0; i--)
+      {
+	  struct mixed_section *sect = sections + i;
+	  if (sect->palette == NULL)
+	      continue;
+	  if (comp->palette != NULL && *(comp->palette) == NULL)
+	      *(comp->palette) = sect->palette;
+	  else
+	      rl2_destroy_palette (sect->palette);
+	  sect->palette = NULL;
+      }
+    free (covered);
+    free (sections);
+    return 1;
+
+  error:
+    if (stmt != NULL)
+	sqlite3_finalize (stmt);
+    for (i = 0; i < count; i++)
+      {
+	  struct mixed_section *sect = sections + i;
+	  do_cleanup_mixed_section (sect);
+	  if (sect->palette != NULL)
+	      rl2_destroy_palette (sect->palette);
+      }
+    if (sections != NULL)
+	free (sections);
+    if (covered != NULL)
+	free (covered);
+    return 0;
 }
 
 RL2_DECLARE int
@@ -1219,9 +1497,7 @@ rl2_get_raw_raster_data_mixed_resolutions (sqlite3 * handle, int max_threads,
 					   rl2RasterStatisticsPtr stats)
 {
 /* attempting to return raw pixels from the DBMS Coverage - Mixed Resolutions */
-    int ret;
     rl2PixelPtr no_data = NULL;
-    const char *db_prefix;
     const char *coverage;
     unsigned char sample_type;
     unsigned char pixel_type;
@@ -1233,18 +1509,13 @@ rl2_get_raw_raster_data_mixed_resolutions (sqlite3 * handle, int max_threads,
     unsigned int x;
     unsigned int y;
     rl2RasterSymbolizerPtr xstyle = style;
-    char *xdb_prefix;
-    char *xsections;
-    char *xxsections;
-    char *sql;
-    sqlite3_stmt *stmt = NULL;
+    struct mixed_compositor comp;
 
     if (cvg == NULL || handle == NULL)
 	return RL2_ERROR;
     if (rl2_get_coverage_type (cvg, &sample_type, &pixel_type, &num_bands) !=
 	RL2_OK)
 	return RL2_ERROR;
-    db_prefix = rl2_get_coverage_prefix (cvg);
     coverage = rl2_get_coverage_name (cvg);
     if (coverage == NULL)
 	return RL2_ERROR;
@@ -1279,40 +1550,14 @@ rl2_get_raw_raster_data_mixed_resolutions (sqlite3 * handle, int max_threads,
     if (pixel_type == RL2_PIXEL_MONOCHROME)
 	xstyle = NULL;
 
-/* preparing the "sections" SQL query */
-    if (db_prefix == NULL)
-	db_prefix = "main";
-    xdb_prefix = rl2_double_quoted_sql (db_prefix);
-    xsections = sqlite3_mprintf ("%s_sections", coverage);
-    xxsections = rl2_double_quoted_sql (xsections);
-    sqlite3_free (xsections);
-    xsections = sqlite3_mprintf ("DB=%s.%s_sections", db_prefix, coverage);
-    sql =
-	sqlite3_mprintf
-	("SELECT section_id, MbrMinX(geometry), MbrMinY(geometry), "
-	 "MbrMaxX(geometry), MbrMaxY(geometry) "
-	 "FROM \"%s\".\"%s\" WHERE ROWID IN ( "
-	 "SELECT ROWID FROM SpatialIndex WHERE f_table_name = %Q "
-	 "AND search_frame = BuildMBR(?, ?, ?, ?))", xdb_prefix, xxsections,
-	 xsections);
-    sqlite3_free (xsections);
-    free (xdb_prefix);
-    free (xxsections);
-    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
-    sqlite3_free (sql);
-    if (ret != SQLITE_OK)
-      {
-	  printf ("SELECT mixed-res Sections SQL error: %s\n",
-		  sqlite3_errmsg (handle));
-	  goto error;
-      }
-
 /* allocating the output buffer */
     if (*out_pixel == RL2_PIXEL_RGB)
 	out_size = width * height * 3;
     else
 	out_size = width * height;
     outbuf = malloc (out_size);
+    if (outbuf == NULL)
+	goto error;
     p = outbuf;
     for (y = 0; y < height; y++)
       {
@@ -1330,121 +1575,19 @@ rl2_get_raw_raster_data_mixed_resolutions (sqlite3 * handle, int max_threads,
 	    }
       }
 
-    sqlite3_reset (stmt);
-    sqlite3_clear_bindings (stmt);
-    sqlite3_bind_double (stmt, 1, minx);
-    sqlite3_bind_double (stmt, 2, miny);
-    sqlite3_bind_double (stmt, 3, maxx);
-    sqlite3_bind_double (stmt, 4, maxy);
-    while (1)
-      {
-	  /* scrolling the result set rows */
-	  ret = sqlite3_step (stmt);
-	  if (ret == SQLITE_DONE)
-	      break;		/* end of result set */
-	  if (ret == SQLITE_ROW)
-	    {
-		sqlite3_int64 section_id = sqlite3_column_int64 (stmt, 0);
-		double section_minx = sqlite3_column_double (stmt, 1);
-		double section_miny = sqlite3_column_double (stmt, 2);
-		double section_maxx = sqlite3_column_double (stmt, 3);
-		double section_maxy = sqlite3_column_double (stmt, 4);
-		double xx_res;
-		double yy_res;
-		int level_id;
-		int scale;
-		int xscale;
-		unsigned int w;
-		unsigned int h;
-		unsigned int w2;
-		unsigned int h2;
-		int base_x;
-		int base_y;
-		unsigned char *bufpix = NULL;
-		int bufpix_size;
-		double img_res_x = (maxx - minx) / (double) width;
-		double img_res_y = (maxy - miny) / (double) height;
-		double mnx = minx;
-		double mny = miny;
-		double mxx = maxx;
-		double mxy = maxy;
-		/* normalizing the visible portion of the Section */
-		if (mnx < section_minx)
-		    mnx = section_minx;
-		if (mny < section_miny)
-		    mny = section_miny;
-		if (mxx > section_maxx)
-		    mxx = section_maxx;
-		if (mxy > section_maxy)
-		    mxy = section_maxy;
-		/* retrieving the optimal resolution level */
-		if (!rl2_find_best_resolution_level
-		    (handle, db_prefix, coverage, 1, section_id, x_res, y_res,
-		     &level_id, &scale, &xscale, &xx_res, &yy_res))
-		    goto error;
-		w = (unsigned int) ((mxx - mnx) / xx_res);
-		if (((double) w * xx_res) < (mxx - mnx))
-		    w++;
-		h = (unsigned int) ((mxy - mny) / yy_res);
-		if (((double) h * yy_res) < (mxy - mny))
-		    h++;
-		base_x = (int) ((mnx - minx) / img_res_x);
-		base_y = (int) ((maxy - mxy) / img_res_y);
-
-		if (rl2_get_raw_raster_data_common
-		    (handle, max_threads, cvg, 1, section_id, w, h, mnx, mny,
-		     mxx, mxy, xx_res, yy_res, &bufpix, &bufpix_size,
-		     RL2_SYNTETIC_NONE, palette, *out_pixel, no_data, xstyle,
-		     stats) != RL2_OK)
-		    goto error;
-
-		w2 = (unsigned int) ((mxx - mnx) / img_res_x);
-		if (((double) w2 * img_res_x) < (mxx - mnx))
-		    w2++;
-		h2 = (unsigned int) ((mxy - mny) / img_res_y);
-		if (((double) h2 * img_res_y) < (mxy - mny))
-		    h2++;
-		if (w == w2 && h == h2)
-		  {
-		      /* already rescaled */
-		  }
-		else
-		  {
-		      /* rescaling the pixbuf */
-		      unsigned char *rescaled = NULL;
-		      int pix_sz = 1;
-		      if (*out_pixel == RL2_PIXEL_RGB)
-			  pix_sz = 3;
-		      rescaled = malloc (pix_sz * w2 * h2);
-		      if (rescaled == NULL)
-			{
-			    fprintf (stderr,
-				     "rl2_get_raw_raster_data_mixed_resolutions: Insufficient Memory !!!\n");
-			    goto error;
-			}
-		      if (!rl2_rescale_pixbuf
-			  (bufpix, w, h, *out_pixel, rescaled, w2, h2))
-			  goto error;
-		      free (bufpix);
-		      bufpix = rescaled;
-		  }
-
-		if (*out_pixel == RL2_PIXEL_RGB)
-		    do_copy_rgb (outbuf, bufpix, width, height, w2, h2, base_x,
-				 base_y, bg_red, bg_green, bg_blue);
-		else
-		    do_copy_gray (outbuf, bufpix, width, height, w2, h2, base_x,
-				  base_y, bg_red);
-		free (bufpix);
-	    }
-	  else
-	    {
-		fprintf (stderr, "SQL error: %s\n%s\n", sql,
-			 sqlite3_errmsg (handle));
-		goto error;
-	    }
-      }
-    sqlite3_finalize (stmt);
+/* compositing all visible Sections */
+    comp.handle = handle;
+    comp.cvg = cvg;
+    comp.transparent = 0;
+    comp.out_pixel = *out_pixel;
+    comp.no_data = no_data;
+    comp.style = xstyle;
+    comp.stats = stats;
+    comp.palette = palette;
+    if (!do_composite_mixed_sections
+	(&comp, max_threads, width, height, minx, miny, maxx, maxy, x_res,
+	 y_res, outbuf, NULL, bg_red, bg_green, bg_blue))
+	goto error;
 
     if (no_data != NULL)
 	rl2_destroy_pixel (no_data);
@@ -1454,8 +1597,6 @@ rl2_get_raw_raster_data_mixed_resolutions (sqlite3 * handle, int max_threads,
     return RL2_OK;
 
   error:
-    if (stmt != NULL)
-	sqlite3_finalize (stmt);
     if (no_data != NULL)
 	rl2_destroy_pixel (no_data);
     if (outbuf != NULL)
@@ -1486,8 +1627,6 @@ rl2_get_raw_raster_data_mixed_resolutions_transparent (sqlite3 * handle,
 						       stats)
 {
 /* attempting to return raw pixels from the DBMS Coverage - Mixed Resolutions */
-    int ret;
-    const char *db_prefix;
     const char *coverage;
     unsigned char sample_type;
     unsigned char pixel_type;
@@ -1497,22 +1636,14 @@ rl2_get_raw_raster_data_mixed_resolutions_transparent (sqlite3 * handle,
     int out_size;
     unsigned char *outmask = NULL;
     int out_masksize;
-    unsigned char *p;
-    unsigned int x;
-    unsigned int y;
     rl2RasterSymbolizerPtr xstyle = style;
-    char *xdb_prefix;
-    char *xsections;
-    char *xxsections;
-    char *sql;
-    sqlite3_stmt *stmt = NULL;
+    struct mixed_compositor comp;
 
     if (cvg == NULL || handle == NULL)
 	return RL2_ERROR;
     if (rl2_get_coverage_type (cvg, &sample_type, &pixel_type, &num_bands) !=
 	RL2_OK)
 	return RL2_ERROR;
-    db_prefix = rl2_get_coverage_prefix (cvg);
     coverage = rl2_get_coverage_name (cvg);
     if (coverage == NULL)
 	return RL2_ERROR;
@@ -1535,191 +1666,34 @@ rl2_get_raw_raster_data_mixed_resolutions_transparent (sqlite3 * handle,
     if (pixel_type == RL2_PIXEL_MONOCHROME)
 	xstyle = NULL;
 
-/* preparing the "sections" SQL query */
-    if (db_prefix == NULL)
-	db_prefix = "main";
-    xdb_prefix = rl2_double_quoted_sql (db_prefix);
-    xsections = sqlite3_mprintf ("%s_sections", coverage);
-    xxsections = rl2_double_quoted_sql (xsections);
-    sqlite3_free (xsections);
-    xsections = sqlite3_mprintf ("DB=%s.%s_sections", db_prefix, coverage);
-    sql =
-	sqlite3_mprintf
-	("SELECT section_id, MbrMinX(geometry), MbrMinY(geometry), "
-	 "MbrMaxX(geometry), MbrMaxY(geometry) "
-	 "FROM \"%s\".\"%s\" WHERE ROWID IN ( "
-	 "SELECT ROWID FROM SpatialIndex WHERE f_table_name = %Q "
-	 "AND search_frame = BuildMBR(?, ?, ?, ?))", xdb_prefix, xxsections,
-	 xsections);
-    sqlite3_free (xsections);
-    free (xdb_prefix);
-    free (xxsections);
-    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
-    sqlite3_free (sql);
-    if (ret != SQLITE_OK)
-      {
-	  printf ("SELECT mixed-res Sections SQL error: %s\n",
-		  sqlite3_errmsg (handle));
-	  goto error;
-      }
-
 /* allocating the output buffer */
     if (*out_pixel == RL2_PIXEL_RGB)
 	out_size = width * height * 3;
     else
 	out_size = width * height;
     outbuf = malloc (out_size);
-    p = outbuf;
-    for (y = 0; y < height; y++)
-      {
-	  /* priming the background color */
-	  for (x = 0; x < width; x++)
-	    {
-		if (*out_pixel == RL2_PIXEL_RGB)
-		  {
-		      *p++ = 0;
-		      *p++ = 0;
-		      *p++ = 0;
-		  }
-		else
-		    *p++ = 0;
-	    }
-      }
+    if (outbuf == NULL)
+	goto error;
+    memset (outbuf, 0, out_size);
     out_masksize = width * height;
     outmask = malloc (out_masksize);
-    p = outmask;
-    for (y = 0; y < height; y++)
-      {
-	  /* priming a full transparent mask */
-	  for (x = 0; x < width; x++)
-	      *p++ = 1;
-      }
-
-    sqlite3_reset (stmt);
-    sqlite3_clear_bindings (stmt);
-    sqlite3_bind_double (stmt, 1, minx);
-    sqlite3_bind_double (stmt, 2, miny);
-    sqlite3_bind_double (stmt, 3, maxx);
-    sqlite3_bind_double (stmt, 4, maxy);
-    while (1)
-      {
-	  /* scrolling the result set rows */
-	  ret = sqlite3_step (stmt);
-	  if (ret == SQLITE_DONE)
-	      break;		/* end of result set */
-	  if (ret == SQLITE_ROW)
-	    {
-		sqlite3_int64 section_id = sqlite3_column_int64 (stmt, 0);
-		double section_minx = sqlite3_column_double (stmt, 1);
-		double section_miny = sqlite3_column_double (stmt, 2);
-		double section_maxx = sqlite3_column_double (stmt, 3);
-		double section_maxy = sqlite3_column_double (stmt, 4);
-		double xx_res;
-		double yy_res;
-		int level_id;
-		int scale;
-		int xscale;
-		unsigned int w;
-		unsigned int h;
-		unsigned int w2;
-		unsigned int h2;
-		int base_x;
-		int base_y;
-		unsigned char *bufpix = NULL;
-		int bufpix_size;
-		unsigned char *bufmask = NULL;
-		int bufmask_size;
-		double img_res_x = (maxx - minx) / (double) width;
-		double img_res_y = (maxy - miny) / (double) height;
-		double mnx = minx;
-		double mny = miny;
-		double mxx = maxx;
-		double mxy = maxy;
-		/* normalizing the visible portion of the Section */
-		if (mnx < section_minx)
-		    mnx = section_minx;
-		if (mny < section_miny)
-		    mny = section_miny;
-		if (mxx > section_maxx)
-		    mxx = section_maxx;
-		if (mxy > section_maxy)
-		    mxy = section_maxy;
-		/* retrieving the optimal resolution level */
-		if (!rl2_find_best_resolution_level
-		    (handle, db_prefix, coverage, 1, section_id, x_res, y_res,
-		     &level_id, &scale, &xscale, &xx_res, &yy_res))
-		    goto error;
-		w = (unsigned int) ((mxx - mnx) / xx_res);
-		if (((double) w * xx_res) < (mxx - mnx))
-		    w++;
-		h = (unsigned int) ((mxy - mny) / yy_res);
-		if (((double) h * yy_res) < (mxy - mny))
-		    h++;
-		base_x = (int) ((mnx - minx) / img_res_x);
-		base_y = (int) ((maxy - mxy) / img_res_y);
-
-		if (rl2_get_raw_raster_data_common_transparent
-		    (handle, max_threads, cvg, 1, section_id, w, h, mnx, mny,
-		     mxx, mxy, xx_res, yy_res, &bufpix, &bufpix_size, &bufmask,
-		     &bufmask_size, RL2_SYNTETIC_NONE, palette, *out_pixel,
-		     no_data, xstyle, stats) != RL2_OK)
-		    goto error;
-
-		w2 = (unsigned int) ((mxx - mnx) / img_res_x);
-		if (((double) w2 * img_res_x) < (mxx - mnx))
-		    w2++;
-		h2 = (unsigned int) ((mxy - mny) / img_res_y);
-		if (((double) h2 * img_res_y) < (mxy - mny))
-		    h2++;
-		if (w == w2 && h == h2)
-		  {
-		      /* already rescaled */
-		  }
-		else
-		  {
-		      /* rescaling the pixbuf */
-		      unsigned char *rescaled = NULL;
-		      unsigned char *rescaled_mask = NULL;
-		      int pix_sz = 1;
-		      if (*out_pixel == RL2_PIXEL_RGB)
-			  pix_sz = 3;
-		      rescaled = malloc (pix_sz * w2 * h2);
-		      rescaled_mask = malloc (w2 * h2);
-		      if (rescaled == NULL || rescaled_mask == NULL)
-			{
-			    fprintf (stderr,
-				     "rl2_get_raw_raster_data_mixed_resolutions: Insufficient Memory !!!\n");
-			    goto error;
-			}
-		      if (!rl2_rescale_pixbuf_transparent
-			  (bufpix, bufmask, w, h, *out_pixel, rescaled,
-			   rescaled_mask, w2, h2))
-			  goto error;
-		      free (bufpix);
-		      free (bufmask);
-		      bufpix = rescaled;
-		      bufmask = rescaled_mask;
-		  }
-
-		if (*out_pixel == RL2_PIXEL_RGB)
-		    do_copy_rgb_transparent (outbuf, outmask, bufpix, bufmask,
-					     width, height, w2, h2, base_x,
-					     base_y);
-		else
-		    do_copy_gray_transparent (outbuf, outmask, bufpix, bufmask,
-					      width, height, w2, h2, base_x,
-					      base_y);
-		free (bufpix);
-		free (bufmask);
-	    }
-	  else
-	    {
-		fprintf (stderr, "SQL error: %s\n%s\n", sql,
-			 sqlite3_errmsg (handle));
-		goto error;
-	    }
-      }
-    sqlite3_finalize (stmt);
+    if (outmask == NULL)
+	goto error;
+    memset (outmask, 1, out_masksize);	/* priming a full transparent mask */
+
+/* compositing all visible Sections */
+    comp.handle = handle;
+    comp.cvg = cvg;
+    comp.transparent = 1;
+    comp.out_pixel = *out_pixel;
+    comp.no_data = no_data;
+    comp.style = xstyle;
+    comp.stats = stats;
+    comp.palette = palette;
+    if (!do_composite_mixed_sections
+	(&comp, max_threads, width, height, minx, miny, maxx, maxy, x_res,
+	 y_res, outbuf, outmask, 0, 0, 0))
+	goto error;
 
     *buffer = outbuf;
     *buf_size = out_size;
@@ -1728,8 +1702,6 @@ rl2_get_raw_raster_data_mixed_resolutions_transparent (sqlite3 * handle,
     return RL2_OK;
 
   error:
-    if (stmt != NULL)
-	sqlite3_finalize (stmt);
     if (outbuf != NULL)
 	free (outbuf);
     if (outmask != NULL)
@@ -4559,9 +4531,11 @@ rl2_draw_vector_feature (void *p_ctx, sqlite3 * handle, const void *priv_data,
     rl2PrivVectorSymbolizerPtr sym = (rl2PrivVectorSymbolizerPtr) symbolizer;
     rl2PrivVectorSymbolizerPtr default_symbolizer = NULL;
     rl2PrivVectorSymbolizerPtr dyn_symbolizer = NULL;
+    double t0;
 
     if (ctx == NULL || geom == NULL)
 	return;
+    t0 = rl2_perf_clock ();
 
     if (sym != NULL)
       {
@@ -4690,6 +4664,301 @@ rl2_draw_vector_feature (void *p_ctx, sqlite3 * handle, const void *priv_data,
 	rl2_destroy_vector_symbolizer (default_symbolizer);
     if (dyn_symbolizer != NULL)
 	rl2_destroy_vector_symbolizer (dyn_symbolizer);
+    rl2_perf_add (RL2_PERF_SYMBOLIZE, t0, 0);
+}
+
+/* the default size of each Label candidates Arena block */
+#define RL2_LABEL_ARENA_BLOCK	65536
+
+RL2_PRIVATE rl2LabelCandidatesPtr
+rl2_create_label_candidates (const char *db_prefix, const char *coverage,
+			     int width, int height, double minx, double miny,
+			     double maxx, double maxy)
+{
+/*
+/ creating an empty container of Label candidates
+/
+/ the Feature pass retains all Labels to be painted, so that the
+/ Label pass will never need to query the Vector Coverage again
+*/
+    int len;
+    rl2LabelCandidatesPtr labels;
+    if (coverage == NULL)
+	return NULL;
+    labels = malloc (sizeof (rl2LabelCandidates));
+    if (labels == NULL)
+	return NULL;
+    if (db_prefix == NULL)
+	labels->db_prefix = NULL;
+    else
+      {
+	  len = strlen (db_prefix);
+	  labels->db_prefix = malloc (len + 1);
+	  strcpy (labels->db_prefix, db_prefix);
+      }
+    len = strlen (coverage);
+    labels->coverage = malloc (len + 1);
+    strcpy (labels->coverage, coverage);
+    labels->width = width;
+    labels->height = height;
+    labels->minx = minx;
+    labels->miny = miny;
+    labels->maxx = maxx;
+    labels->maxy = maxy;
+    labels->first_block = NULL;
+    labels->last_block = NULL;
+    labels->index = NULL;
+    labels->count = 0;
+    labels->max = 0;
+    return labels;
+}
+
+RL2_PRIVATE void
+rl2_destroy_label_candidates (rl2LabelCandidatesPtr labels)
+{
+/* memory cleanup - destroying all Label candidates */
+    int i;
+    rl2LabelArenaBlockPtr block;
+    rl2LabelArenaBlockPtr block_n;
+    if (labels == NULL)
+	return;
+    for (i = 0; i < labels->count; i++)
+      {
+	  rl2LabelCandidatePtr candidate = *(labels->index + i);
+	  if (candidate->text != NULL)
+	      rl2_destroy_text_symbolizer (candidate->text);
+      }
+    block = labels->first_block;
+    while (block != NULL)
+      {
+	  block_n = block->next;
+	  free (block->buf);
+	  free (block);
+	  block = block_n;
+      }
+    if (labels->index != NULL)
+	free (labels->index);
+    if (labels->db_prefix != NULL)
+	free (labels->db_prefix);
+    if (labels->coverage != NULL)
+	free (labels->coverage);
+    free (labels);
+}
+
+static void *
+label_arena_alloc (rl2LabelCandidatesPtr labels, size_t size)
+{
+/* allocating some memory from the Label candidates Arena */
+    rl2LabelArenaBlockPtr block = labels->last_block;
+    void *ptr;
+    size = (size + 7) & ~((size_t) 7);	/* always 8-bytes aligned */
+    if (block == NULL || block->used + size > block->size)
+      {
+	  /* adding a further block */
+	  size_t block_sz = RL2_LABEL_ARENA_BLOCK;
+	  if (size > block_sz)
+	      block_sz = size;
+	  block = malloc (sizeof (rl2LabelArenaBlock));
+	  if (block == NULL)
+	      return NULL;
+	  block->buf = malloc (block_sz);
+	  if (block->buf == NULL)
+	    {
+		free (block);
+		return NULL;
+	    }
+	  block->size = block_sz;
+	  block->used = 0;
+	  block->next = NULL;
+	  if (labels->first_block == NULL)
+	      labels->first_block = block;
+	  if (labels->last_block != NULL)
+	      labels->last_block->next = block;
+	  labels->last_block = block;
+      }
+    ptr = block->buf + block->used;
+    block->used += size;
+    return ptr;
+}
+
+RL2_PRIVATE int
+rl2_add_label_candidates (rl2LabelCandidatesPtr labels,
+			  rl2VectorSymbolizerPtr symbolizer,
+			  rl2GeometryPtr geom, rl2VariantArrayPtr variant)
+{
+/* retaining all Labels of a Feature (one for each TextSymbolizer) */
+    rl2PrivVectorSymbolizerPtr sym = (rl2PrivVectorSymbolizerPtr) symbolizer;
+    rl2PrivVectorSymbolizerItemPtr item;
+    unsigned char *blob = NULL;
+    int blob_sz = 0;
+    const unsigned char *arena_blob = NULL;
+
+    if (labels == NULL || sym == NULL || geom == NULL)
+	return 1;
+
+    item = sym->first;
+    while (item != NULL)
+      {
+	  rl2PrivTextSymbolizerPtr text;
+	  rl2LabelCandidatePtr candidate;
+	  if (item->symbolizer_type != RL2_TEXT_SYMBOLIZER
+	      || item->symbolizer == NULL)
+	    {
+		item = item->next;
+		continue;
+	    }
+	  /* resolving all dynamic (column based) values */
+	  text = rl2_clone_text_symbolizer (item->symbolizer);
+	  if (text == NULL)
+	      goto error;
+	  rl2_set_text_symbolizer_dyn_values ((rl2PrivVariantArrayPtr)
+					      variant, text);
+	  if (text->label == NULL)
+	    {
+		/* nothing to be painted */
+		rl2_destroy_text_symbolizer (text);
+		item = item->next;
+		continue;
+	    }
+	  if (arena_blob == NULL)
+	    {
+		/* the Geometry is stored just once for all Labels */
+		unsigned char *p;
+		if (!rl2_geometry_to_blob (geom, &blob, &blob_sz))
+		  {
+		      rl2_destroy_text_symbolizer (text);
+		      goto error;
+		  }
+		p = label_arena_alloc (labels, blob_sz);
+		if (p == NULL)
+		  {
+		      rl2_destroy_text_symbolizer (text);
+		      goto error;
+		  }
+		memcpy (p, blob, blob_sz);
+		free (blob);
+		blob = NULL;
+		arena_blob = p;
+	    }
+	  if (labels->count >= labels->max)
+	    {
+		int max = (labels->max == 0) ? 1024 : labels->max * 2;
+		rl2LabelCandidatePtr *p =
+		    realloc (labels->index, sizeof (rl2LabelCandidatePtr) * max);
+		if (p == NULL)
+		  {
+		      rl2_destroy_text_symbolizer (text);
+		      goto error;
+		  }
+		labels->index = p;
+		labels->max = max;
+	    }
+	  candidate = label_arena_alloc (labels, sizeof (rl2LabelCandidate));
+	  if (candidate == NULL)
+	    {
+		rl2_destroy_text_symbolizer (text);
+		goto error;
+	    }
+	  candidate->seq = labels->count;
+	  candidate->priority = text->font_size;
+	  candidate->text = text;
+	  candidate->blob = arena_blob;
+	  candidate->blob_sz = blob_sz;
+	  *(labels->index + labels->count) = candidate;
+	  labels->count += 1;
+	  item = item->next;
+      }
+    return 1;
+
+  error:
+    if (blob != NULL)
+	free (blob);
+    return 0;
+}
+
+static int
+cmp_label_candidates (const void *p1, const void *p2)
+{
+/* sorting Label candidates: higher priority first, then fetch order */
+    rl2LabelCandidatePtr c1 = *((rl2LabelCandidatePtr *) p1);
+    rl2LabelCandidatePtr c2 = *((rl2LabelCandidatePtr *) p2);
+    if (c1->priority > c2->priority)
+	return -1;
+    if (c1->priority < c2->priority)
+	return 1;
+    if (c1->seq < c2->seq)
+	return -1;
+    if (c1->seq > c2->seq)
+	return 1;
+    return 0;
+}
+
+static int
+label_strcmp (const char *str1, const char *str2)
+{
+/* comparing two (possibly NULL) strings */
+    if (str1 == NULL && str2 == NULL)
+	return 0;
+    if (str1 == NULL || str2 == NULL)
+	return 1;
+    return strcmp (str1, str2);
+}
+
+RL2_PRIVATE int
+rl2_match_label_candidates (rl2LabelCandidatesPtr labels,
+			    const char *db_prefix, const char *coverage,
+			    int width, int height, double minx, double miny,
+			    double maxx, double maxy)
+{
+/* checking if some Label candidates exactly match the current request */
+    if (labels == NULL)
+	return 0;
+    if (label_strcmp (labels->db_prefix, db_prefix) != 0)
+	return 0;
+    if (label_strcmp (labels->coverage, coverage) != 0)
+	return 0;
+    if (labels->width != width || labels->height != height)
+	return 0;
+    if (labels->minx != minx || labels->miny != miny)
+	return 0;
+    if (labels->maxx != maxx || labels->maxy != maxy)
+	return 0;
+    return 1;
+}
+
+RL2_PRIVATE void
+rl2_draw_label_candidates (void *p_ctx, sqlite3 * handle,
+			   const void *priv_data, rl2LabelCandidatesPtr labels)
+{
+/* painting all retained Labels, by decreasing priority */
+    rl2GraphicsContextPtr ctx = (rl2GraphicsContextPtr) p_ctx;
+    double x_res;
+    double y_res;
+    int i;
+    double t0;
+
+    if (ctx == NULL || labels == NULL)
+	return;
+    if (labels->count == 0)
+	return;
+    t0 = rl2_perf_clock ();
+    x_res = (labels->maxx - labels->minx) / (double) (labels->width);
+    y_res = (labels->maxy - labels->miny) / (double) (labels->height);
+    qsort (labels->index, labels->count, sizeof (rl2LabelCandidatePtr),
+	   cmp_label_candidates);
+    for (i = 0; i < labels->count; i++)
+      {
+	  rl2LabelCandidatePtr candidate = *(labels->index + i);
+	  rl2GeometryPtr geom =
+	      rl2_geometry_from_blob (candidate->blob, candidate->blob_sz);
+	  if (geom == NULL)
+	      continue;
+	  draw_labels (ctx, handle, priv_data, candidate->text,
+		       labels->height, labels->minx, labels->miny,
+		       labels->maxx, labels->maxy, x_res, y_res, geom);
+	  rl2_destroy_geometry (geom);
+      }
+    rl2_perf_add (RL2_PERF_SYMBOLIZE, t0, 0);
 }
 
 RL2_PRIVATE int
@@ -0,0 +1,323 @@
+/*
+
+ rl2cancel -- per-request deadlines and cooperative cancellation
+
+ version 0.1, 2026 October 18
+
+ Author: Sandro Furieri a.furieri@lqt.it
+
+ -----------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2026
+the Initial Developer. All Rights Reserved.
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "config.h"
+
+#ifdef LOADABLE_EXTENSION
+#include "rasterlite2/sqlite.h"
+#endif
+
+#include "rasterlite2/rasterlite2.h"
+#include "rasterlite2_private.h"
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+#define RL2_THREAD_LOCAL __declspec(thread)
+#else
+#define RL2_THREAD_LOCAL __thread
+#endif
+
+/* 
+/ the Cancellation Token currently attached to the calling thread
+/ (NULL when the thread isn't servicing any cancellable request)
+*/
+static RL2_THREAD_LOCAL struct rl2_cancel_token *rl2_thread_cancel = NULL;
+
+static double
+cancel_now (void)
+{
+/* returns a monotonic timestamp (in seconds) */
+#if defined(_WIN32)
+    LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+    QueryPerformanceFrequency (&freq);
+    QueryPerformanceCounter (&count);
+    return (double) (count.QuadPart) / (double) (freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (double) (ts.tv_sec) + ((double) (ts.tv_nsec) / 1000000000.0);
+#endif
+}
+
+static void
+cancel_lock (struct rl2_cancel_token *token)
+{
+/* locking the Cancellation Token */
+    if (token->mutex != NULL)
+	sqlite3_mutex_enter ((sqlite3_mutex *) (token->mutex));
+}
+
+static void
+cancel_unlock (struct rl2_cancel_token *token)
+{
+/* unlocking the Cancellation Token */
+    if (token->mutex != NULL)
+	sqlite3_mutex_leave ((sqlite3_mutex *) (token->mutex));
+}
+
+static int
+is_token_cancelled (struct rl2_cancel_token *token)
+{
+/* checking if a request has been cancelled or has expired */
+    if (token->cancelled)
+	return 1;
+    if (token->deadline > 0.0 && cancel_now () > token->deadline)
+      {
+	  /* the deadline has expired */
+	  token->cancelled = 1;
+	  return 1;
+      }
+    return 0;
+}
+
+static int
+cancel_progress_handler (void *arg)
+{
+/* 
+/ SQLite progress handler: a non-zero return value will
+/ interrupt the currently running SQL statement
+*/
+    struct rl2_cancel_token *token = (struct rl2_cancel_token *) arg;
+    return is_token_cancelled (token);
+}
+
+RL2_PRIVATE struct rl2_cancel_token *
+rl2_alloc_cancel_token (void)
+{
+/* allocating an idle Cancellation Token */
+    struct rl2_cancel_token *token =
+	malloc (sizeof (struct rl2_cancel_token));
+    if (token == NULL)
+	return NULL;
+    token->mutex = sqlite3_mutex_alloc (SQLITE_MUTEX_FAST);
+    token->cancelled = 0;
+    token->timeout = 0.0;
+    token->deadline = 0.0;
+    token->depth = 0;
+    token->handle = NULL;
+    token->progress = 0;
+    return token;
+}
+
+RL2_PRIVATE void
+rl2_destroy_cancel_token (struct rl2_cancel_token *token)
+{
+/* destroying a Cancellation Token */
+    if (token == NULL)
+	return;
+    if (rl2_thread_cancel == token)
+	rl2_thread_cancel = NULL;
+    if (token->mutex != NULL)
+	sqlite3_mutex_free ((sqlite3_mutex *) (token->mutex));
+    free (token);
+}
+
+RL2_PRIVATE struct rl2_cancel_token *
+rl2_cancel_get_thread_token (void)
+{
+/* returns the Cancellation Token attached to the calling thread */
+    return rl2_thread_cancel;
+}
+
+RL2_PRIVATE void
+rl2_cancel_set_thread_token (struct rl2_cancel_token *token)
+{
+/* attaching a Cancellation Token to the calling thread */
+    rl2_thread_cancel = token;
+}
+
+RL2_PRIVATE int
+rl2_is_cancelled (void)
+{
+/* 
+/ checking if the request serviced by the calling thread has been
+/ cancelled (or has exceeded its deadline) and should stop ASAP
+*/
+    struct rl2_cancel_token *token = rl2_thread_cancel;
+    if (token == NULL)
+	return 0;
+    return is_token_cancelled (token);
+}
+
+RL2_PRIVATE void
+rl2_cancel_begin_request (const void *priv_data, sqlite3 * handle)
+{
+/* starting a cancellable request */
+    struct rl2_cancel_token *token;
+    struct rl2_private_data *priv = (struct rl2_private_data *) priv_data;
+    if (priv == NULL)
+	return;
+    token = priv->cancel;
+    if (token == NULL)
+	return;
+
+    cancel_lock (token);
+    if (token->depth == 0)
+      {
+	  /* outermost request: arming the token */
+	  token->cancelled = 0;
+	  if (token->timeout > 0.0)
+	      token->deadline = cancel_now () + token->timeout;
+	  else
+	      token->deadline = 0.0;
+	  token->handle = handle;
+	  token->progress = 0;
+	  if (handle != NULL && token->deadline > 0.0)
+	    {
+		/* 
+		/ only a deadline requires the progress handler, thus
+		/ replacing any handler set by the application
+		*/
+		sqlite3_progress_handler (handle, RL2_CANCEL_PROGRESS_OPS,
+					  cancel_progress_handler, token);
+		token->progress = 1;
+	    }
+      }
+    token->depth += 1;
+    cancel_unlock (token);
+    rl2_thread_cancel = token;
+}
+
+RL2_PRIVATE void
+rl2_cancel_end_request (const void *priv_data)
+{
+/* completing a cancellable request */
+    struct rl2_cancel_token *token;
+    struct rl2_private_data *priv = (struct rl2_private_data *) priv_data;
+    if (priv == NULL)
+	return;
+    token = priv->cancel;
+    if (token == NULL)
+	return;
+
+    cancel_lock (token);
+    token->depth -= 1;
+    if (token->depth > 0)
+      {
+	  /* still within some outer request */
+	  cancel_unlock (token);
+	  return;
+      }
+    token->depth = 0;
+    if (token->handle != NULL && token->progress)
+	sqlite3_progress_handler (token->handle, 0, NULL, NULL);
+    token->progress = 0;
+    token->handle = NULL;
+    token->deadline = 0.0;
+    token->cancelled = 0;
+    cancel_unlock (token);
+    rl2_thread_cancel = NULL;
+}
+
+RL2_DECLARE int
+rl2_set_request_timeout (const void *ptr, double seconds)
+{
+/* setting the deadline (in seconds) applying to each further request */
+    struct rl2_cancel_token *token;
+    struct rl2_private_data *priv = (struct rl2_private_data *) ptr;
+    if (priv == NULL)
+	return RL2_ERROR;
+    token = priv->cancel;
+    if (token == NULL)
+	return RL2_ERROR;
+    if (seconds < 0.0)
+	return RL2_ERROR;
+    cancel_lock (token);
+    token->timeout = seconds;
+    cancel_unlock (token);
+    return RL2_OK;
+}
+
+RL2_DECLARE int
+rl2_get_request_timeout (const void *ptr, double *seconds)
+{
+/* returning the currently set per-request deadline (in seconds) */
+    struct rl2_cancel_token *token;
+    struct rl2_private_data *priv = (struct rl2_private_data *) ptr;
+    *seconds = 0.0;
+    if (priv == NULL)
+	return RL2_ERROR;
+    token = priv->cancel;
+    if (token == NULL)
+	return RL2_ERROR;
+    cancel_lock (token);
+    *seconds = token->timeout;
+    cancel_unlock (token);
+    return RL2_OK;
+}
+
+RL2_DECLARE int
+rl2_cancel_request (const void *ptr)
+{
+/* 
+/ cancelling the request currently in progress (if any)
+/ safe to be called from any other thread
+*/
+    struct rl2_cancel_token *token;
+    struct rl2_private_data *priv = (struct rl2_private_data *) ptr;
+    if (priv == NULL)
+	return RL2_ERROR;
+    token = priv->cancel;
+    if (token == NULL)
+	return RL2_ERROR;
+    cancel_lock (token);
+    if (token->depth > 0)
+      {
+	  token->cancelled = 1;
+	  /* immediately stopping the currently running SQL statement */
+	  if (token->handle != NULL)
+	      sqlite3_interrupt (token->handle);
+      }
+    cancel_unlock (token);
+    return RL2_OK;
+}
@@ -2065,11 +2065,11 @@ odd_even_rows (rl2PrivRasterPtr raster, int *odd_rows, int *row_stride_odd,
     return 1;
 }
 
-RL2_DECLARE int
-rl2_raster_encode (rl2RasterPtr rst, int compression,
-		   unsigned char **blob_odd, int *blob_odd_sz,
-		   unsigned char **blob_even, int *blob_even_sz, int quality,
-		   int little_endian)
+static int
+do_raster_encode (rl2RasterPtr rst, int compression,
+		  unsigned char **blob_odd, int *blob_odd_sz,
+		  unsigned char **blob_even, int *blob_even_sz, int quality,
+		  int little_endian, rl2CoveragePtr cvg)
 {
 /* encoding a Raster into the internal RL2 binary format */
     rl2PrivRasterPtr raster = (rl2PrivRasterPtr) rst;
@@ -2100,6 +2100,7 @@ rl2_raster_encode (rl2RasterPtr rst, int compression,
     uLong crc;
     int endian_arch = endianArch ();
     int delta_dist;
+    double t0;
     *blob_odd = NULL;
     *blob_odd_sz = 0;
     *blob_even = NULL;
@@ -2110,6 +2111,7 @@ rl2_raster_encode (rl2RasterPtr rst, int compression,
     if (!check_encode_self_consistency
 	(raster->sampleType, raster->pixelType, raster->nBands, compression))
 	return RL2_ERROR;
+    t0 = rl2_perf_clock ();
 
     switch (raster->pixelType)
       {
@@ -2575,8 +2577,8 @@ rl2_raster_encode (rl2RasterPtr rst, int compression,
 	  if (rl2_delta_encode (pixels_odd, size_odd, delta_dist) != RL2_OK)
 	      goto error;
 	  compressed_data_size =
-	      ZSTD_compress (zstd_buf, cBuffSize, pixels_odd, (size_t) size_odd,
-			     ZSTD_LEVEL);
+	      rl2_zstd_compress (zstd_buf, cBuffSize, pixels_odd,
+				 (size_t) size_odd, ZSTD_LEVEL, cvg);
 	  if (compressed_data_size > 0)
 	    {
 		/* ok, ZSTD compression was successful */
@@ -2628,8 +2630,8 @@ rl2_raster_encode (rl2RasterPtr rst, int compression,
 		goto error;
 	    }
 	  compressed_data_size =
-	      ZSTD_compress (zstd_buf, cBuffSize, pixels_odd, (size_t) size_odd,
-			     ZSTD_LEVEL);
+	      rl2_zstd_compress (zstd_buf, cBuffSize, pixels_odd,
+				 (size_t) size_odd, ZSTD_LEVEL, cvg);
 	  if (compressed_data_size > 0)
 	    {
 		/* ok, ZSTD compression was successful */
@@ -3206,8 +3208,9 @@ rl2_raster_encode (rl2RasterPtr rst, int compression,
 		    RL2_OK)
 		    goto error;
 		compressed_data_size =
-		    ZSTD_compress (zstd_buf, cBuffSize, pixels_even,
-				   (size_t) size_even, ZSTD_LEVEL);
+		    rl2_zstd_compress (zstd_buf, cBuffSize, pixels_even,
+				       (size_t) size_even, ZSTD_LEVEL,
+				       cvg);
 		if (rl2_delta_encode (pixels_even, size_even, delta_dist) !=
 		    RL2_OK)
 		    goto error;
@@ -3256,8 +3259,9 @@ rl2_raster_encode (rl2RasterPtr rst, int compression,
 		      goto error;
 		  }
 		compressed_data_size =
-		    ZSTD_compress (zstd_buf, cBuffSize, pixels_even,
-				   (size_t) size_even, ZSTD_LEVEL);
+		    rl2_zstd_compress (zstd_buf, cBuffSize, pixels_even,
+				       (size_t) size_even, ZSTD_LEVEL,
+				       cvg);
 		if (compressed_data_size > 0)
 		  {
 		      /* ok, ZSTD compression was successful */
@@ -3365,6 +3369,7 @@ rl2_raster_encode (rl2RasterPtr rst, int compression,
     *blob_odd_sz = block_odd_size;
     *blob_even = block_even;
     *blob_even_sz = block_even_size;
+    rl2_perf_add (RL2_PERF_RASTER_ENCODE, t0, block_odd_size + block_even_size);
     return RL2_OK;
 
   error:
@@ -3386,6 +3391,35 @@ rl2_raster_encode (rl2RasterPtr rst, int compression,
     return RL2_ERROR;
 }
 
+RL2_DECLARE int
+rl2_raster_encode (rl2RasterPtr rst, int compression,
+		   unsigned char **blob_odd, int *blob_odd_sz,
+		   unsigned char **blob_even, int *blob_even_sz, int quality,
+		   int little_endian)
+{
+/* encoding a Raster into the internal RL2 binary format */
+    return do_raster_encode (rst, compression, blob_odd, blob_odd_sz,
+			     blob_even, blob_even_sz, quality, little_endian,
+			     NULL);
+}
+
+RL2_PRIVATE int
+rl2_raster_encode_dict (rl2RasterPtr rst, int compression,
+			unsigned char **blob_odd, int *blob_odd_sz,
+			unsigned char **blob_even, int *blob_even_sz,
+			int quality, int little_endian, rl2CoveragePtr cvg)
+{
+/*
+/ encoding a Raster into the internal RL2 binary format
+/ ZSTD payloads will be compressed by using the current Dictionary
+/ of the given Coverage (a NULL Coverage or no Dictionary at all
+/ simply means no dictionary)
+*/
+    return do_raster_encode (rst, compression, blob_odd, blob_odd_sz,
+			     blob_even, blob_even_sz, quality, little_endian,
+			     cvg);
+}
+
 RL2_DECLARE int
 rl2_query_dbms_raster_tile (const unsigned char *blob, int blob_sz,
 			    unsigned int *tile_width,
@@ -3688,6 +3722,7 @@ check_blob_odd (const unsigned char *blob, int blob_sz, unsigned int *xwidth,
       case RL2_COMPRESSION_CCITTFAX4:
       case RL2_COMPRESSION_LOSSY_JP2:
       case RL2_COMPRESSION_LOSSLESS_JP2:
+      case RL2_COMPRESSION_UNIFORM:
 	  break;
       default:
 	  return 0;
@@ -3857,6 +3892,12 @@ check_scale (int scale, unsigned char sample_type, unsigned char compression,
 	      || sample_type == RL2_SAMPLE_2_BIT
 	      || sample_type == RL2_SAMPLE_4_BIT)
 	      ;
+	  else if (compression == RL2_COMPRESSION_UNIFORM)
+	    {
+		/* Uniform tiles never have an EvenBlock */
+		if (blob_even != NULL)
+		    return 0;
+	    }
 	  else if (compression == RL2_COMPRESSION_JPEG
 		   || compression == RL2_COMPRESSION_LOSSY_WEBP
 		   || compression == RL2_COMPRESSION_LOSSLESS_WEBP
@@ -5541,6 +5582,424 @@ unpack_4bit (unsigned short width, unsigned short height,
     return 1;
 }
 
+static int
+sparse_sample_size (unsigned char sample_type)
+{
+/* returning the size (in bytes) of a single sample into a Raster buffer */
+    switch (sample_type)
+      {
+      case RL2_SAMPLE_INT16:
+      case RL2_SAMPLE_UINT16:
+	  return 2;
+      case RL2_SAMPLE_INT32:
+      case RL2_SAMPLE_UINT32:
+      case RL2_SAMPLE_FLOAT:
+	  return 4;
+      case RL2_SAMPLE_DOUBLE:
+	  return 8;
+      };
+    return 1;
+}
+
+static unsigned char *
+sparse_no_data_value (rl2PrivRasterPtr raster, int sample_sz)
+{
+/* serializing the NO-DATA pixel exactly as it would be into a Raster buffer */
+    int ib;
+    unsigned char *value;
+    unsigned char *p;
+    rl2PrivPixelPtr no_data = raster->noData;
+    if (no_data == NULL)
+	return NULL;
+    if (no_data->sampleType != raster->sampleType
+	|| no_data->nBands != raster->nBands)
+	return NULL;
+    value = malloc (sample_sz * raster->nBands);
+    if (value == NULL)
+	return NULL;
+    p = value;
+    for (ib = 0; ib < raster->nBands; ib++)
+      {
+	  rl2PrivSamplePtr sample = no_data->Samples + ib;
+	  switch (raster->sampleType)
+	    {
+	    case RL2_SAMPLE_INT8:
+		memcpy (p, &(sample->int8), 1);
+		break;
+	    case RL2_SAMPLE_INT16:
+		memcpy (p, &(sample->int16), 2);
+		break;
+	    case RL2_SAMPLE_UINT16:
+		memcpy (p, &(sample->uint16), 2);
+		break;
+	    case RL2_SAMPLE_INT32:
+		memcpy (p, &(sample->int32), 4);
+		break;
+	    case RL2_SAMPLE_UINT32:
+		memcpy (p, &(sample->uint32), 4);
+		break;
+	    case RL2_SAMPLE_FLOAT:
+		memcpy (p, &(sample->float32), 4);
+		break;
+	    case RL2_SAMPLE_DOUBLE:
+		memcpy (p, &(sample->float64), 8);
+		break;
+	    default:
+		*p = sample->uint8;
+		break;
+	    };
+	  p += sample_sz;
+      }
+    return value;
+}
+
+static int
+classify_sparse_raster (rl2PrivRasterPtr raster,
+			const unsigned char **uniform_value)
+{
+/*
+/ checking if a Raster tile is sparse:
+/ - RL2_SPARSE_EMPTY: all pixels are transparent or NO-DATA
+/ - RL2_SPARSE_UNIFORM: all pixels are opaque and share the same value
+/ - RL2_SPARSE_NONE: any other case
+*/
+    int sample_sz = sparse_sample_size (raster->sampleType);
+    int pixel_sz = sample_sz * raster->nBands;
+    unsigned int n_pixels = raster->width * raster->height;
+    unsigned int i;
+    unsigned int n_void = 0;
+    int uniform = 1;
+    const unsigned char *first = NULL;
+    const unsigned char *p_in = raster->rasterBuffer;
+    const unsigned char *p_mask = raster->maskBuffer;
+    unsigned char *no_data = sparse_no_data_value (raster, sample_sz);
+
+    *uniform_value = NULL;
+    for (i = 0; i < n_pixels; i++, p_in += pixel_sz)
+      {
+	  if (p_mask != NULL)
+	    {
+		unsigned char msk = *p_mask++;
+		if (msk == 0)
+		  {
+		      /* transparent pixel */
+		      n_void++;
+		      continue;
+		  }
+		if (raster->alpha_mask && msk != 255)
+		    uniform = 0;	/* semi-transparent pixel */
+	    }
+	  if (no_data != NULL && memcmp (p_in, no_data, pixel_sz) == 0)
+	    {
+		/* NO-DATA pixel */
+		n_void++;
+		continue;
+	    }
+	  if (first == NULL)
+	      first = p_in;
+	  else if (memcmp (p_in, first, pixel_sz) != 0)
+	    {
+		/* not uniform and not empty: no reason to go further */
+		uniform = 0;
+		break;
+	    }
+      }
+    if (no_data != NULL)
+	free (no_data);
+    if (first == NULL)
+	return RL2_SPARSE_EMPTY;
+    if (uniform && n_void == 0)
+      {
+	  *uniform_value = first;
+	  return RL2_SPARSE_UNIFORM;
+      }
+    return RL2_SPARSE_NONE;
+}
+
+static int
+encode_uniform_raster (rl2PrivRasterPtr raster, const unsigned char *value,
+		       unsigned char **blob_odd, int *blob_odd_sz,
+		       int little_endian)
+{
+/*
+/ encoding a Uniform tile: an OddBlock simply containing a single
+/ pixel value (and no EvenBlock at all)
+*/
+    int sample_sz = sparse_sample_size (raster->sampleType);
+    int pixel_sz = sample_sz * raster->nBands;
+    int endian_arch = endianArch ();
+    int swap = (little_endian != endian_arch) ? 1 : 0;
+    int ib;
+    int is;
+    uLong crc;
+    unsigned char *block;
+    unsigned char *ptr;
+    int block_sz = 40 + pixel_sz;
+
+    block = malloc (block_sz);
+    if (block == NULL)
+	return RL2_ERROR;
+    ptr = block;
+    *ptr++ = 0x00;		/* start marker */
+    *ptr++ = RL2_ODD_BLOCK_START;	/* OddBlock marker */
+    if (little_endian)		/* endian marker */
+	*ptr++ = RL2_LITTLE_ENDIAN;
+    else
+	*ptr++ = RL2_BIG_ENDIAN;
+    *ptr++ = RL2_COMPRESSION_UNIFORM;	/* compression marker */
+    *ptr++ = raster->sampleType;	/* sample type marker */
+    *ptr++ = raster->pixelType;	/* pixel type marker */
+    *ptr++ = raster->nBands;	/* # Bands marker */
+    exportU16 (ptr, raster->width, little_endian, endian_arch);	/* the raster width */
+    ptr += 2;
+    exportU16 (ptr, raster->height, little_endian, endian_arch);	/* the raster height */
+    ptr += 2;
+    exportU16 (ptr, 0, little_endian, endian_arch);	/* no row stride */
+    ptr += 2;
+    exportU16 (ptr, raster->height, little_endian, endian_arch);	/* block #rows */
+    ptr += 2;
+    exportU32 (ptr, pixel_sz, little_endian, endian_arch);	/* uncompressed payload size in bytes */
+    ptr += 4;
+    exportU32 (ptr, pixel_sz, little_endian, endian_arch);	/* compressed payload size in bytes */
+    ptr += 4;
+    exportU32 (ptr, 0, little_endian, endian_arch);	/* no mask */
+    ptr += 4;
+    exportU32 (ptr, 0, little_endian, endian_arch);
+    ptr += 4;
+    *ptr++ = RL2_DATA_START;
+    for (ib = 0; ib < raster->nBands; ib++)
+      {
+	  /* the uniform pixel value */
+	  const unsigned char *p_in = value + (ib * sample_sz);
+	  for (is = 0; is < sample_sz; is++)
+	    {
+		if (swap)
+		    *ptr++ = *(p_in + (sample_sz - 1 - is));
+		else
+		    *ptr++ = *(p_in + is);
+	    }
+      }
+    *ptr++ = RL2_DATA_END;
+    *ptr++ = RL2_MASK_START;
+    *ptr++ = RL2_MASK_END;
+/* computing the CRC32 */
+    crc = crc32 (0L, block, ptr - block);
+    exportU32 (ptr, crc, little_endian, endian_arch);	/* the OddBlock own CRC */
+    ptr += 4;
+    *ptr = RL2_ODD_BLOCK_END;
+    *blob_odd = block;
+    *blob_odd_sz = block_sz;
+    return RL2_OK;
+}
+
+RL2_PRIVATE int
+rl2_raster_encode_sparse (rl2RasterPtr rst, int compression,
+			  unsigned char **blob_odd, int *blob_odd_sz,
+			  unsigned char **blob_even, int *blob_even_sz,
+			  int quality, int little_endian, rl2CoveragePtr cvg)
+{
+/*
+/ encoding a Raster into the internal RL2 binary format - sparse tiles
+/
+/ an empty tile (fully transparent or NO-DATA) will return RL2_OK
+/ and NULL BLOBs, meaning that it shouldn't be stored at all;
+/ a uniform tile will be encoded as a tiny single-value marker
+/ any other tile will be encoded exactly as rl2_raster_encode() does
+*/
+    rl2PrivRasterPtr raster = (rl2PrivRasterPtr) rst;
+    const unsigned char *value;
+    int ret;
+    double t0;
+
+    *blob_odd = NULL;
+    *blob_odd_sz = 0;
+    *blob_even = NULL;
+    *blob_even_sz = 0;
+    if (raster == NULL)
+	return RL2_ERROR;
+
+    t0 = rl2_perf_clock ();
+    switch (classify_sparse_raster (raster, &value))
+      {
+      case RL2_SPARSE_EMPTY:
+	  rl2_perf_add (RL2_PERF_RASTER_ENCODE, t0, 0);
+	  return RL2_OK;
+      case RL2_SPARSE_UNIFORM:
+	  ret =
+	      encode_uniform_raster (raster, value, blob_odd, blob_odd_sz,
+				     little_endian);
+	  if (ret == RL2_OK)
+	      rl2_perf_add (RL2_PERF_RASTER_ENCODE, t0, *blob_odd_sz);
+	  return ret;
+      };
+    return do_raster_encode (rst, compression, blob_odd, blob_odd_sz,
+			     blob_even, blob_even_sz, quality, little_endian,
+			     cvg);
+}
+
+static rl2RasterPtr
+decode_uniform_raster (int scale, const unsigned char *blob_odd,
+		       unsigned int width, unsigned int height,
+		       unsigned char sample_type, unsigned char pixel_type,
+		       unsigned char num_bands, rl2PalettePtr ext_palette)
+{
+/* synthesizing a Raster from a Uniform tile (no decompression at all) */
+    rl2RasterPtr raster;
+    int sample_sz = sparse_sample_size (sample_type);
+    int pixel_sz = sample_sz * num_bands;
+    int endian = *(blob_odd + 2);
+    int endian_arch = endianArch ();
+    int swap = (endian != endian_arch) ? 1 : 0;
+    unsigned char value[8 * 256];
+    const unsigned char *p_in = blob_odd + 32;
+    unsigned int factor = 1;
+    unsigned char *pixels;
+    unsigned char *p_out;
+    int pixels_sz;
+    unsigned int i;
+    int ib;
+    int is;
+
+    if (pixel_sz > (int) sizeof (value))
+	goto error;
+    for (ib = 0; ib < num_bands; ib++)
+      {
+	  for (is = 0; is < sample_sz; is++)
+	    {
+		if (swap)
+		    value[(ib * sample_sz) + (sample_sz - 1 - is)] = *p_in++;
+		else
+		    value[(ib * sample_sz) + is] = *p_in++;
+	    }
+      }
+
+    /* rescaling: same rounding as the regular decoder */
+    switch (scale)
+      {
+      case RL2_SCALE_2:
+	  factor = 2;
+	  break;
+      case RL2_SCALE_4:
+	  factor = 4;
+	  break;
+      case RL2_SCALE_8:
+	  factor = 8;
+	  break;
+      };
+    width = (width + factor - 1) / factor;
+    height = (height + factor - 1) / factor;
+    if (pixel_type != RL2_PIXEL_PALETTE && ext_palette != NULL)
+      {
+	  rl2_destroy_palette (ext_palette);
+	  ext_palette = NULL;
+      }
+    pixels_sz = width * height * pixel_sz;
+    pixels = malloc (pixels_sz);
+    if (pixels == NULL)
+	goto error;
+    p_out = pixels;
+    if (pixel_sz == 1)
+	memset (pixels, value[0], pixels_sz);
+    else
+      {
+	  for (i = 0; i < width * height; i++)
+	    {
+		memcpy (p_out, value, pixel_sz);
+		p_out += pixel_sz;
+	    }
+      }
+    raster =
+	rl2_create_raster (width, height, sample_type, pixel_type, num_bands,
+			   pixels, pixels_sz, ext_palette, NULL, 0, NULL);
+    if (raster == NULL)
+      {
+	  free (pixels);
+	  goto error;
+      }
+    return raster;
+
+  error:
+    if (ext_palette != NULL)
+	rl2_destroy_palette (ext_palette);
+    return NULL;
+}
+
+RL2_PRIVATE int
+rl2_is_uniform_tile (const unsigned char *blob_odd, int blob_odd_sz)
+{
+/* testing for a Uniform tile */
+    if (blob_odd == NULL || blob_odd_sz < 41)
+	return 0;
+    if (*(blob_odd + 1) == RL2_ODD_BLOCK_START
+	&& *(blob_odd + 3) == RL2_COMPRESSION_UNIFORM)
+	return 1;
+    return 0;
+}
+
+RL2_PRIVATE int
+rl2_get_zstd_payload (const unsigned char *blob, int blob_sz,
+		      unsigned char **payload, int *payload_sz,
+		      rl2CoveragePtr cvg)
+{
+/*
+/ extracting the uncompressed ZSTD payload from an Odd or Even Block,
+/ i.e. exactly the same bytes originally passed to the compressor
+/ (used for sampling existing tiles when training a dictionary)
+*/
+    int endian;
+    int endian_arch = endianArch ();
+    unsigned int uncompressed;
+    unsigned int compressed;
+    int offset;
+    unsigned char *buf;
+    size_t ret;
+
+    *payload = NULL;
+    *payload_sz = 0;
+    if (blob == NULL || blob_sz < 33 || *blob != 0x00)
+	return RL2_ERROR;
+    if (*(blob + 3) != RL2_COMPRESSION_ZSTD
+	&& *(blob + 3) != RL2_COMPRESSION_ZSTD_NO)
+	return RL2_ERROR;
+    endian = *(blob + 2);
+    if (*(blob + 1) == RL2_ODD_BLOCK_START)
+      {
+	  uncompressed = importU32 (blob + 15, endian, endian_arch);
+	  compressed = importU32 (blob + 19, endian, endian_arch);
+	  offset = 32;
+      }
+    else if (*(blob + 1) == RL2_EVEN_BLOCK_START)
+      {
+	  uncompressed = importU32 (blob + 17, endian, endian_arch);
+	  compressed = importU32 (blob + 21, endian, endian_arch);
+	  offset = 26;
+      }
+    else
+	return RL2_ERROR;
+    if (uncompressed == 0 || compressed == uncompressed)
+	return RL2_ERROR;	/* stored as uncompressed data */
+    if ((unsigned int) blob_sz < offset + compressed)
+	return RL2_ERROR;
+    buf = malloc (uncompressed);
+    if (buf == NULL)
+	return RL2_ERROR;
+#ifndef OMIT_ZSTD		/* only if ZSTD is enabled */
+    ret =
+	rl2_zstd_decompress (buf, uncompressed, blob + offset, compressed,
+			     cvg);
+#else
+    ret = 0;
+#endif
+    if (ret != uncompressed)
+      {
+	  free (buf);
+	  return RL2_ERROR;
+      }
+    *payload = buf;
+    *payload_sz = uncompressed;
+    return RL2_OK;
+}
+
 RL2_DECLARE int
 rl2_is_valid_dbms_raster_tile (unsigned short level, unsigned int tile_width,
 			       unsigned int tile_height,
@@ -5558,6 +6017,7 @@ rl2_is_valid_dbms_raster_tile (unsigned short level, unsigned int tile_width,
     unsigned char xpixel_type;
     unsigned char xnum_bands;
     unsigned char xcompression;
+    int uniform;
     uLong crc;
     if (!check_blob_odd
 	(blob_odd, blob_odd_sz, &width, &height, &xsample_type, &xpixel_type,
@@ -5572,11 +6032,14 @@ rl2_is_valid_dbms_raster_tile (unsigned short level, unsigned int tile_width,
       }
     if (width != tile_width || height != tile_height)
 	return RL2_ERROR;
+    /* a Uniform tile is compatible with any compression */
+    uniform = (xcompression == RL2_COMPRESSION_UNIFORM) ? 1 : 0;
     if (level == 0)
       {
 	  /* base-level tile */
 	  if (sample_type == xsample_type && pixel_type == xpixel_type
-	      && num_bands == xnum_bands && compression == xcompression)
+	      && num_bands == xnum_bands
+	      && (uniform || compression == xcompression))
 	      return RL2_OK;
       }
     else
@@ -5588,7 +6051,7 @@ rl2_is_valid_dbms_raster_tile (unsigned short level, unsigned int tile_width,
 		/* MONOCHROME: expecting a GRAYSCALE/PNG Pyramid tile */
 		if (xsample_type == RL2_SAMPLE_UINT8
 		    && xpixel_type == RL2_PIXEL_GRAYSCALE && xnum_bands == 1
-		    && xcompression == RL2_COMPRESSION_PNG)
+		    && (uniform || xcompression == RL2_COMPRESSION_PNG))
 		    return RL2_OK;
 	    }
 	  if ((sample_type == RL2_SAMPLE_1_BIT
@@ -5601,7 +6064,7 @@ rl2_is_valid_dbms_raster_tile (unsigned short level, unsigned int tile_width,
 		/* small-PALETTE: expecting an RGB/PNG Pyramid tile */
 		if (xsample_type == RL2_SAMPLE_UINT8
 		    && xpixel_type == RL2_PIXEL_RGB && xnum_bands == 3
-		    && xcompression == RL2_COMPRESSION_PNG)
+		    && (uniform || xcompression == RL2_COMPRESSION_PNG))
 		    return RL2_OK;
 	    }
 	  if (sample_type == RL2_SAMPLE_UINT8
@@ -5610,24 +6073,29 @@ rl2_is_valid_dbms_raster_tile (unsigned short level, unsigned int tile_width,
 		/* PALETTE 8bits: expecting an RGB/PNG Pyramid tile */
 		if (xsample_type == RL2_SAMPLE_UINT8
 		    && xpixel_type == RL2_PIXEL_RGB && xnum_bands == 3
-		    && xcompression == RL2_COMPRESSION_PNG)
+		    && (uniform || xcompression == RL2_COMPRESSION_PNG))
 		    return RL2_OK;
 	    }
 	  /* any other: expecting unchanged params */
 	  if (xsample_type == sample_type
 	      && xpixel_type == pixel_type && xnum_bands == num_bands
-	      && xcompression == compression)
+	      && (uniform || xcompression == compression))
 	      return RL2_OK;
       }
     return RL2_ERROR;
 }
 
-RL2_DECLARE rl2RasterPtr
-rl2_raster_decode (int scale, const unsigned char *blob_odd,
-		   int blob_odd_sz, const unsigned char *blob_even,
-		   int blob_even_sz, rl2PalettePtr ext_palette)
+RL2_PRIVATE rl2RasterPtr
+rl2_raster_decode_dict (int scale, const unsigned char *blob_odd,
+			int blob_odd_sz, const unsigned char *blob_even,
+			int blob_even_sz, rl2PalettePtr ext_palette,
+			rl2CoveragePtr cvg)
 {
-/* decoding from internal RL2 binary format to Raster */
+/* 
+/ decoding from internal RL2 binary format to Raster
+/ ZSTD payloads compressed by using some trained dictionary can only
+/ be decoded by passing the Coverage that loaded it
+*/
     rl2RasterPtr raster;
     rl2PalettePtr palette = NULL;
     rl2PalettePtr palette2 = NULL;
@@ -5667,22 +6135,34 @@ rl2_raster_decode (int scale, const unsigned char *blob_odd,
     int endian;
     int endian_arch = endianArch ();
     int delta_dist;
+    double t0 = rl2_perf_clock ();
 
     if (blob_odd == NULL)
-	return NULL;
+	goto error;
     if (!check_blob_odd
 	(blob_odd, blob_odd_sz, &width, &height, &sample_type, &pixel_type,
 	 &num_bands, &compression, &crc))
-	return NULL;
+	goto error;
     if (blob_even != NULL)
       {
 	  if (!check_blob_even
 	      (blob_even, blob_even_sz, width, height, sample_type,
 	       pixel_type, num_bands, compression, crc))
-	      return NULL;
+	      goto error;
       }
     if (!check_scale (scale, sample_type, compression, blob_even))
-	return NULL;
+	goto error;
+    if (compression == RL2_COMPRESSION_UNIFORM)
+      {
+	  /* Uniform tile: directly synthesized */
+	  raster =
+	      decode_uniform_raster (scale, blob_odd, width, height,
+				     sample_type, pixel_type, num_bands,
+				     ext_palette);
+	  if (raster != NULL)
+	      rl2_perf_add (RL2_PERF_DECODE, t0, blob_odd_sz);
+	  return raster;
+      }
 
     switch (pixel_type)
       {
@@ -5749,22 +6229,22 @@ rl2_raster_decode (int scale, const unsigned char *blob_odd,
     compressed_mask = importU32 (ptr, endian, endian_arch);
     ptr += 4;
     if (*ptr++ != RL2_DATA_START)
-	return NULL;
+	goto error;
     pixels_odd = ptr;
     if (uncompressed_mask > 0)
       {
 	  /* retrieving the mask */
 	  ptr += compressed_odd;
 	  if (*ptr++ != RL2_DATA_END)
-	      return NULL;
+	      goto error;
 	  if (*ptr++ != RL2_MASK_START)
-	      return NULL;
+	      goto error;
 	  pixels_mask = ptr;
 	  mask_width = width;
 	  mask_height = height;
 	  ptr += compressed_mask;
 	  if (*ptr++ != RL2_MASK_END)
-	      return NULL;
+	      goto error;
       }
     if (blob_even != NULL)
       {
@@ -5777,7 +6257,7 @@ rl2_raster_decode (int scale, const unsigned char *blob_odd,
 	  compressed_even = importU32 (ptr, endian, endian_arch);
 	  ptr += 4;
 	  if (*ptr++ != RL2_DATA_START)
-	      return NULL;
+	      goto error;
 	  pixels_even = ptr;
       }
     else
@@ -6049,7 +6529,8 @@ rl2_raster_decode (int scale, const unsigned char *blob_odd,
 	  odd_data = malloc (rSize);
 	  if (odd_data == NULL)
 	      goto error;
-	  dSize = ZSTD_decompress (odd_data, rSize, pixels_odd, cSize);
+	  dSize =
+	      rl2_zstd_decompress (odd_data, rSize, pixels_odd, cSize, cvg);
 	  if (dSize != rSize)
 	      goto error;
 	  if (rl2_delta_decode (odd_data, uncompressed_odd, delta_dist) !=
@@ -6065,7 +6546,9 @@ rl2_raster_decode (int scale, const unsigned char *blob_odd,
 		even_data = malloc (rSize);
 		if (even_data == NULL)
 		    goto error;
-		dSize = ZSTD_decompress (even_data, rSize, pixels_even, cSize);
+		dSize =
+		    rl2_zstd_decompress (even_data, rSize, pixels_even, cSize,
+					 cvg);
 		if (dSize != rSize)
 		    goto error;
 		if (rl2_delta_decode
@@ -6090,7 +6573,8 @@ rl2_raster_decode (int scale, const unsigned char *blob_odd,
 	  odd_data = malloc (rSize);
 	  if (odd_data == NULL)
 	      goto error;
-	  dSize = ZSTD_decompress (odd_data, rSize, pixels_odd, cSize);
+	  dSize =
+	      rl2_zstd_decompress (odd_data, rSize, pixels_odd, cSize, cvg);
 	  if (dSize != rSize)
 	      goto error;
 	  pixels_odd = odd_data;
@@ -6103,7 +6587,9 @@ rl2_raster_decode (int scale, const unsigned char *blob_odd,
 		even_data = malloc (rSize);
 		if (even_data == NULL)
 		    goto error;
-		dSize = ZSTD_decompress (even_data, rSize, pixels_even, cSize);
+		dSize =
+		    rl2_zstd_decompress (even_data, rSize, pixels_even, cSize,
+					 cvg);
 		if (dSize != rSize)
 		    goto error;
 		pixels_even = even_data;
@@ -6384,6 +6870,7 @@ rl2_raster_decode (int scale, const unsigned char *blob_odd,
 	free (odd_data);
     if (even_data != NULL)
 	free (even_data);
+    rl2_perf_add (RL2_PERF_DECODE, t0, blob_odd_sz + blob_even_sz);
     return raster;
   error:
     if (odd_mask != NULL)
@@ -6405,6 +6892,16 @@ rl2_raster_decode (int scale, const unsigned char *blob_odd,
     return NULL;
 }
 
+RL2_DECLARE rl2RasterPtr
+rl2_raster_decode (int scale, const unsigned char *blob_odd,
+		   int blob_odd_sz, const unsigned char *blob_even,
+		   int blob_even_sz, rl2PalettePtr ext_palette)
+{
+/* decoding from internal RL2 binary format to Raster */
+    return rl2_raster_decode_dict (scale, blob_odd, blob_odd_sz, blob_even,
+				   blob_even_sz, ext_palette, NULL);
+}
+
 RL2_PRIVATE rl2RasterPtr
 rl2_raster_decode_mask (int scale, const unsigned char *blob_odd,
 			int blob_odd_sz, int *status)
@@ -7948,20 +8445,22 @@ rl2_build_raster_statistics (rl2RasterPtr raster, rl2PixelPtr noData)
     return NULL;
 }
 
-RL2_DECLARE rl2RasterStatisticsPtr
-rl2_get_raster_statistics (const unsigned char *blob_odd,
-			   int blob_odd_sz, const unsigned char *blob_even,
-			   int blob_even_sz, rl2PalettePtr palette,
-			   rl2PixelPtr noData)
+RL2_PRIVATE rl2RasterStatisticsPtr
+rl2_get_raster_statistics_dict (const unsigned char *blob_odd,
+				int blob_odd_sz,
+				const unsigned char *blob_even,
+				int blob_even_sz, rl2PalettePtr palette,
+				rl2PixelPtr noData, rl2CoveragePtr cvg)
 {
 /* 
 / decoding from internal RL2 binary format to Raster and 
 / building the corresponding statistics object
+/ (the Coverage is required by ZSTD payloads using some dictionary)
 */
     rl2RasterStatisticsPtr stats = NULL;
     rl2RasterPtr raster =
-	rl2_raster_decode (RL2_SCALE_1, blob_odd, blob_odd_sz, blob_even,
-			   blob_even_sz, palette);
+	rl2_raster_decode_dict (RL2_SCALE_1, blob_odd, blob_odd_sz, blob_even,
+				blob_even_sz, palette, cvg);
     if (raster == NULL)
 	goto error;
     palette = NULL;
@@ -7982,6 +8481,21 @@ rl2_get_raster_statistics (const unsigned char *blob_odd,
     return NULL;
 }
 
+RL2_DECLARE rl2RasterStatisticsPtr
+rl2_get_raster_statistics (const unsigned char *blob_odd,
+			   int blob_odd_sz, const unsigned char *blob_even,
+			   int blob_even_sz, rl2PalettePtr palette,
+			   rl2PixelPtr noData)
+{
+/* 
+/ decoding from internal RL2 binary format to Raster and 
+/ building the corresponding statistics object
+*/
+    return rl2_get_raster_statistics_dict (blob_odd, blob_odd_sz, blob_even,
+					   blob_even_sz, palette, noData,
+					   NULL);
+}
+
 RL2_DECLARE int
 rl2_serialize_dbms_palette (rl2PalettePtr palette, unsigned char **blob,
 			    int *blob_size)
@@ -398,7 +398,10 @@ create_sections (sqlite3 * handle, const char *coverage, int srid)
     char *xtrigger;
     char *xxtrigger;
 
-/* creating the SECTIONS table */
+/* creating the SECTIONS table
+/ (for historical reasons the Source checksum column is named md5_checksum,
+/ but it may hold an XXH64 digest as well: see RL2_SetSectionChecksum)
+*/
     xcoverage = sqlite3_mprintf ("%s_sections", coverage);
     xxcoverage = rl2_double_quoted_sql (xcoverage);
     sqlite3_free (xcoverage);
@@ -549,9 +552,196 @@ create_sections (sqlite3 * handle, const char *coverage, int srid)
     return 1;
 }
 
+static char *
+dedup_quoted_name (const char *prefix, const char *coverage,
+		   const char *suffix)
+{
+/* building a double-quoted SQL object name */
+    char *quoted;
+    char *name = sqlite3_mprintf ("%s%s%s", prefix, coverage, suffix);
+    quoted = rl2_double_quoted_sql (name);
+    sqlite3_free (name);
+    return quoted;
+}
+
+static int
+do_exec_dedup_sql (sqlite3 * handle, char *sql, const char *object)
+{
+/* executing a single SQL statement defining a deduplicated TILE_DATA */
+    int ret;
+    char *sql_err = NULL;
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CREATE %s error: %s\n", object, sql_err);
+	  sqlite3_free (sql_err);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+create_dedup_tile_data (sqlite3 * handle, const char *coverage)
+{
+/*
+/ creating a deduplicated TILE_DATA
+/
+/ - TILE_BLOBS stores every distinct tile payload just once, keyed
+/   by its content hash and carrying a reference count (payloads
+/   colliding on the same hash are stored as distinct rows)
+/ - TILE_REFS binds each tile_id to its payload
+/ - TILE_DATA is a writable View exposing the usual layout, so that
+/   all readers and writers will continue to work unchanged
+*/
+    char *sql;
+    char *xblobs;
+    char *xrefs;
+    char *xdata;
+    char *xtiles;
+    char *xfk;
+    char *xtrigger;
+    char *tile_data;
+    int ok = 0;
+
+    xblobs = dedup_quoted_name ("", coverage, "_tile_blobs");
+    xrefs = dedup_quoted_name ("", coverage, "_tile_refs");
+    xdata = dedup_quoted_name ("", coverage, "_tile_data");
+    xtiles = dedup_quoted_name ("", coverage, "_tiles");
+    tile_data = sqlite3_mprintf ("%s_tile_data", coverage);
+
+/* creating the TILE_BLOBS table */
+    sql = sqlite3_mprintf ("CREATE TABLE \"%s\" ("
+			   "\ttile_hash TEXT NOT NULL PRIMARY KEY,\n"
+			   "\tref_count INTEGER NOT NULL,\n"
+			   "\ttile_data_odd BLOB NOT NULL,\n"
+			   "\ttile_data_even BLOB)", xblobs);
+    if (!do_exec_dedup_sql (handle, sql, "TABLE tile_blobs"))
+	goto stop;
+
+/* creating the TILE_REFS table */
+    xfk = dedup_quoted_name ("fk_", coverage, "_tile_refs");
+    sql = sqlite3_mprintf ("CREATE TABLE \"%s\" ("
+			   "\ttile_id INTEGER NOT NULL PRIMARY KEY,\n"
+			   "\ttile_hash TEXT NOT NULL,\n"
+			   "CONSTRAINT \"%s\" FOREIGN KEY (tile_id) "
+			   "REFERENCES \"%s\" (tile_id) ON DELETE CASCADE)",
+			   xrefs, xfk, xtiles);
+    free (xfk);
+    if (!do_exec_dedup_sql (handle, sql, "TABLE tile_refs"))
+	goto stop;
+
+/* creating the TILE_DATA view */
+    sql = sqlite3_mprintf ("CREATE VIEW \"%s\" AS "
+			   "SELECT r.tile_id AS tile_id, "
+			   "b.tile_data_odd AS tile_data_odd, "
+			   "b.tile_data_even AS tile_data_even "
+			   "FROM \"%s\" AS r JOIN \"%s\" AS b "
+			   "ON (b.tile_hash = r.tile_hash)", xdata, xrefs,
+			   xblobs);
+    if (!do_exec_dedup_sql (handle, sql, "VIEW tile_data"))
+	goto stop;
+
+/* reference counting Triggers on TILE_REFS */
+    xtrigger = dedup_quoted_name ("", coverage, "_tile_refs_insert");
+    sql = sqlite3_mprintf ("CREATE TRIGGER \"%s\"\n"
+			   "AFTER INSERT ON \"%s\"\nFOR EACH ROW BEGIN\n"
+			   "UPDATE \"%s\" SET ref_count = ref_count + 1 "
+			   "WHERE tile_hash = NEW.tile_hash;\nEND",
+			   xtrigger, xrefs, xblobs);
+    free (xtrigger);
+    if (!do_exec_dedup_sql (handle, sql, "TRIGGER tile_refs_insert"))
+	goto stop;
+    xtrigger = dedup_quoted_name ("", coverage, "_tile_refs_update");
+    sql = sqlite3_mprintf ("CREATE TRIGGER \"%s\"\n"
+			   "AFTER UPDATE OF tile_hash ON \"%s\"\n"
+			   "FOR EACH ROW BEGIN\n"
+			   "UPDATE \"%s\" SET ref_count = ref_count + 1 "
+			   "WHERE tile_hash = NEW.tile_hash;\n"
+			   "UPDATE \"%s\" SET ref_count = ref_count - 1 "
+			   "WHERE tile_hash = OLD.tile_hash;\n"
+			   "DELETE FROM \"%s\" WHERE tile_hash = OLD.tile_hash "
+			   "AND ref_count <= 0;\nEND", xtrigger, xrefs, xblobs,
+			   xblobs, xblobs);
+    free (xtrigger);
+    if (!do_exec_dedup_sql (handle, sql, "TRIGGER tile_refs_update"))
+	goto stop;
+    xtrigger = dedup_quoted_name ("", coverage, "_tile_refs_delete");
+    sql = sqlite3_mprintf ("CREATE TRIGGER \"%s\"\n"
+			   "AFTER DELETE ON \"%s\"\nFOR EACH ROW BEGIN\n"
+			   "UPDATE \"%s\" SET ref_count = ref_count - 1 "
+			   "WHERE tile_hash = OLD.tile_hash;\n"
+			   "DELETE FROM \"%s\" WHERE tile_hash = OLD.tile_hash "
+			   "AND ref_count <= 0;\nEND", xtrigger, xrefs, xblobs,
+			   xblobs);
+    free (xtrigger);
+    if (!do_exec_dedup_sql (handle, sql, "TRIGGER tile_refs_delete"))
+	goto stop;
+
+/* INSTEAD OF Triggers making the TILE_DATA view writable */
+    xtrigger = dedup_quoted_name ("", coverage, "_tile_data_insert");
+    sql = sqlite3_mprintf ("CREATE TRIGGER \"%s\"\n"
+			   "INSTEAD OF INSERT ON \"%s\"\nFOR EACH ROW BEGIN\n"
+			   "SELECT RAISE(ABORT,'insert on %s violates constraint: "
+			   "invalid tile_data')\nWHERE IsValidRasterTile(NULL, %Q, "
+			   "(SELECT t.pyramid_level FROM \"%s\" AS t WHERE t.tile_id = NEW.tile_id), "
+			   "NEW.tile_data_odd, NEW.tile_data_even) <> 1;\n"
+			   "INSERT OR IGNORE INTO \"%s\" (tile_hash, ref_count, "
+			   "tile_data_odd, tile_data_even) VALUES "
+			   "(TileHash(NULL, %Q, NEW.tile_data_odd, "
+			   "NEW.tile_data_even), 0, "
+			   "NEW.tile_data_odd, NEW.tile_data_even);\n"
+			   "INSERT INTO \"%s\" (tile_id, tile_hash) VALUES "
+			   "(NEW.tile_id, TileHash(NULL, %Q, NEW.tile_data_odd, "
+			   "NEW.tile_data_even));\nEND", xtrigger, xdata,
+			   tile_data, coverage, xtiles, xblobs, coverage,
+			   xrefs, coverage);
+    free (xtrigger);
+    if (!do_exec_dedup_sql (handle, sql, "TRIGGER tile_data_insert"))
+	goto stop;
+    xtrigger = dedup_quoted_name ("", coverage, "_tile_data_update");
+    sql = sqlite3_mprintf ("CREATE TRIGGER \"%s\"\n"
+			   "INSTEAD OF UPDATE ON \"%s\"\nFOR EACH ROW BEGIN\n"
+			   "SELECT RAISE(ABORT, 'update on %s violates constraint: "
+			   "invalid tile_data')\nWHERE IsValidRasterTile(NULL, %Q, "
+			   "(SELECT t.pyramid_level FROM \"%s\" AS t WHERE t.tile_id = NEW.tile_id), "
+			   "NEW.tile_data_odd, NEW.tile_data_even) <> 1;\n"
+			   "INSERT OR IGNORE INTO \"%s\" (tile_hash, ref_count, "
+			   "tile_data_odd, tile_data_even) VALUES "
+			   "(TileHash(NULL, %Q, NEW.tile_data_odd, "
+			   "NEW.tile_data_even), 0, "
+			   "NEW.tile_data_odd, NEW.tile_data_even);\n"
+			   "UPDATE \"%s\" SET tile_hash = "
+			   "TileHash(NULL, %Q, NEW.tile_data_odd, "
+			   "NEW.tile_data_even) "
+			   "WHERE tile_id = OLD.tile_id;\nEND", xtrigger, xdata,
+			   tile_data, coverage, xtiles, xblobs, coverage,
+			   xrefs, coverage);
+    free (xtrigger);
+    if (!do_exec_dedup_sql (handle, sql, "TRIGGER tile_data_update"))
+	goto stop;
+    xtrigger = dedup_quoted_name ("", coverage, "_tile_data_delete");
+    sql = sqlite3_mprintf ("CREATE TRIGGER \"%s\"\n"
+			   "INSTEAD OF DELETE ON \"%s\"\nFOR EACH ROW BEGIN\n"
+			   "DELETE FROM \"%s\" WHERE tile_id = OLD.tile_id;\nEND",
+			   xtrigger, xdata, xrefs);
+    free (xtrigger);
+    if (!do_exec_dedup_sql (handle, sql, "TRIGGER tile_data_delete"))
+	goto stop;
+    ok = 1;
+
+  stop:
+    free (xblobs);
+    free (xrefs);
+    free (xdata);
+    free (xtiles);
+    sqlite3_free (tile_data);
+    return ok;
+}
+
 static int
 create_tiles (sqlite3 * handle, const char *coverage, int srid,
-	      int mixed_resolutions)
+	      int mixed_resolutions, int dedup_tiles)
 {
 /* creating the TILES table */
     int ret;
@@ -712,6 +902,8 @@ create_tiles (sqlite3 * handle, const char *coverage, int srid,
     free (xxindex);
 
 /* creating the TILE_DATA table */
+    if (dedup_tiles)
+	return create_dedup_tile_data (handle, coverage);
     xcoverage = sqlite3_mprintf ("%s_tile_data", coverage);
     xxcoverage = rl2_double_quoted_sql (xcoverage);
     sqlite3_free (xcoverage);
@@ -801,19 +993,21 @@ create_tiles (sqlite3 * handle, const char *coverage, int srid,
 }
 
 RL2_DECLARE int
-rl2_create_dbms_coverage (sqlite3 * handle, const char *coverage,
-			  unsigned char sample, unsigned char pixel,
-			  unsigned char num_bands, unsigned char compression,
-			  int quality, unsigned int tile_width,
-			  unsigned int tile_height, int srid, double x_res,
-			  double y_res, rl2PixelPtr no_data,
-			  rl2PalettePtr palette, int strict_resolution,
-			  int mixed_resolutions, int section_paths,
-			  int section_md5, int section_summary,
-			  int is_queryable, int is_opaque, double min_scale,
-			  double max_scale)
+rl2_create_dbms_coverage_ex (sqlite3 * handle, const char *coverage,
+			     unsigned char sample, unsigned char pixel,
+			     unsigned char num_bands,
+			     unsigned char compression, int quality,
+			     unsigned int tile_width,
+			     unsigned int tile_height, int srid,
+			     double x_res, double y_res, rl2PixelPtr no_data,
+			     rl2PalettePtr palette, int strict_resolution,
+			     int mixed_resolutions, int section_paths,
+			     int section_md5, int section_summary,
+			     int is_queryable, int is_opaque,
+			     double min_scale, double max_scale,
+			     int dedup_tiles)
 {
-/* creating a DBMS-based Coverage */
+/* creating a DBMS-based Coverage - optionally deduplicating tiles */
     unsigned char *blob = NULL;
     int blob_size = 0;
     unsigned char *blob_no_data = NULL;
@@ -849,13 +1043,38 @@ rl2_create_dbms_coverage (sqlite3 * handle, const char *coverage,
       }
     if (!create_sections (handle, coverage, srid))
 	goto error;
-    if (!create_tiles (handle, coverage, srid, mixed_resolutions))
+    if (!create_tiles
+	(handle, coverage, srid, mixed_resolutions, dedup_tiles))
 	goto error;
     return RL2_OK;
   error:
     return RL2_ERROR;
 }
 
+RL2_DECLARE int
+rl2_create_dbms_coverage (sqlite3 * handle, const char *coverage,
+			  unsigned char sample, unsigned char pixel,
+			  unsigned char num_bands, unsigned char compression,
+			  int quality, unsigned int tile_width,
+			  unsigned int tile_height, int srid, double x_res,
+			  double y_res, rl2PixelPtr no_data,
+			  rl2PalettePtr palette, int strict_resolution,
+			  int mixed_resolutions, int section_paths,
+			  int section_md5, int section_summary,
+			  int is_queryable, int is_opaque, double min_scale,
+			  double max_scale)
+{
+/* creating a DBMS-based Coverage */
+    return rl2_create_dbms_coverage_ex (handle, coverage, sample, pixel,
+					num_bands, compression, quality,
+					tile_width, tile_height, srid, x_res,
+					y_res, no_data, palette,
+					strict_resolution, mixed_resolutions,
+					section_paths, section_md5,
+					section_summary, is_queryable,
+					is_opaque, min_scale, max_scale, 0);
+}
+
 RL2_DECLARE int
 rl2_set_dbms_coverage_default_bands (sqlite3 * handle, const char *coverage,
 				     unsigned char red_band,
@@ -1748,6 +1967,11 @@ rl2_delete_dbms_section (sqlite3 * handle, const char *coverage,
 	  goto error;
       }
     sqlite3_finalize (stmt);
+    stmt = NULL;
+
+/* releasing any deduplicated tile no longer referenced */
+    if (!rl2_purge_dedup_tiles (handle, coverage))
+	goto error;
 
     rl2_destroy_coverage (cvg);
     return RL2_OK;
@@ -1760,6 +1984,253 @@ rl2_delete_dbms_section (sqlite3 * handle, const char *coverage,
     return RL2_ERROR;
 }
 
+RL2_PRIVATE char *
+rl2_tile_content_hash (const unsigned char *blob_odd, int blob_odd_sz,
+		       const unsigned char *blob_even, int blob_even_sz)
+{
+/*
+/ computing the content hash identifying a tile into a deduplicated
+/ Coverage: MD5 of both BLOBs, qualified by their lengths
+*/
+    char *md5;
+    char *hash;
+    void *p_md5;
+    if (blob_odd == NULL || blob_odd_sz <= 0)
+	return NULL;
+    p_md5 = rl2_CreateMD5Checksum ();
+    if (p_md5 == NULL)
+	return NULL;
+    rl2_UpdateMD5Checksum (p_md5, blob_odd, blob_odd_sz);
+    if (blob_even != NULL && blob_even_sz > 0)
+	rl2_UpdateMD5Checksum (p_md5, blob_even, blob_even_sz);
+    md5 = rl2_FinalizeMD5Checksum (p_md5);
+    rl2_FreeMD5Checksum (p_md5);
+    if (md5 == NULL)
+	return NULL;
+    hash = sqlite3_mprintf ("%s:%d:%d", md5, blob_odd_sz, blob_even_sz);
+    free (md5);
+    return hash;
+}
+
+static int
+same_tile_blob (const unsigned char *blob_1, int blob_1_sz,
+		const unsigned char *blob_2, int blob_2_sz)
+{
+/* checking if two (possibly NULL) tile BLOBs are identical */
+    if (blob_1_sz <= 0 || blob_1 == NULL)
+	blob_1_sz = 0;
+    if (blob_2_sz <= 0 || blob_2 == NULL)
+	blob_2_sz = 0;
+    if (blob_1_sz != blob_2_sz)
+	return 0;
+    if (blob_1_sz == 0)
+	return 1;
+    if (memcmp (blob_1, blob_2, blob_1_sz) == 0)
+	return 1;
+    return 0;
+}
+
+RL2_PRIVATE char *
+rl2_resolve_tile_hash (sqlite3 * handle, const char *db_prefix,
+		       const char *coverage, const unsigned char *blob_odd,
+		       int blob_odd_sz, const unsigned char *blob_even,
+		       int blob_even_sz)
+{
+/*
+/ returning the TILE_BLOBS key of a tile into a deduplicated Coverage
+/
+/ the content hash alone could collide: all payloads sharing the same
+/ hash are compared byte by byte, and a payload differing from all of
+/ them will be keyed as "hash/N" so to be stored as a distinct row
+*/
+    int ret;
+    char *sql;
+    char *table;
+    char *xtable;
+    char *xdb_prefix;
+    char *hash;
+    char *lower;
+    char *upper;
+    char *key = NULL;
+    sqlite3_stmt *stmt = NULL;
+    int hash_len;
+    int found = 0;
+    int max_suffix = 0;
+
+    hash = rl2_tile_content_hash (blob_odd, blob_odd_sz, blob_even,
+				  blob_even_sz);
+    if (hash == NULL)
+	return NULL;
+    hash_len = strlen (hash);
+
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    table = sqlite3_mprintf ("%s_tile_blobs", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql =
+	sqlite3_mprintf
+	("SELECT tile_hash, tile_data_odd, tile_data_even FROM \"%s\".\"%s\" "
+	 "WHERE tile_hash = ? OR (tile_hash > ? AND tile_hash < ?)",
+	 xdb_prefix, xtable);
+    free (xdb_prefix);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "SQL error: %s\n", sqlite3_errmsg (handle));
+	  sqlite3_free (hash);
+	  return NULL;
+      }
+
+/* any "hash/N" key sorts between "hash/" and "hash0" */
+    lower = sqlite3_mprintf ("%s/", hash);
+    upper = sqlite3_mprintf ("%s0", hash);
+    sqlite3_bind_text (stmt, 1, hash, hash_len, SQLITE_STATIC);
+    sqlite3_bind_text (stmt, 2, lower, strlen (lower), SQLITE_STATIC);
+    sqlite3_bind_text (stmt, 3, upper, strlen (upper), SQLITE_STATIC);
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		const char *value =
+		    (const char *) sqlite3_column_text (stmt, 0);
+		if (same_tile_blob
+		    (sqlite3_column_blob (stmt, 1),
+		     sqlite3_column_bytes (stmt, 1), blob_odd, blob_odd_sz)
+		    && same_tile_blob (sqlite3_column_blob (stmt, 2),
+				       sqlite3_column_bytes (stmt, 2),
+				       blob_even, blob_even_sz))
+		  {
+		      /* an identical payload is already stored */
+		      key = sqlite3_mprintf ("%s", value);
+		      break;
+		  }
+		found = 1;
+		if ((int) strlen (value) > hash_len + 1)
+		  {
+		      int suffix = atoi (value + hash_len + 1);
+		      if (suffix > max_suffix)
+			  max_suffix = suffix;
+		  }
+	    }
+	  else
+	    {
+		fprintf (stderr, "SQL error: %s\n", sqlite3_errmsg (handle));
+		break;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    sqlite3_free (lower);
+    sqlite3_free (upper);
+    if (ret != SQLITE_DONE && ret != SQLITE_ROW)
+      {
+	  sqlite3_free (hash);
+	  return NULL;
+      }
+
+    if (key == NULL)
+      {
+	  if (!found)
+	    {
+		/* a brand new payload */
+		return hash;
+	    }
+	  /* a genuine hash collision: storing a distinct payload */
+	  key = sqlite3_mprintf ("%s/%d", hash, max_suffix + 1);
+      }
+    sqlite3_free (hash);
+    return key;
+}
+
+RL2_PRIVATE int
+rl2_is_dedup_coverage (sqlite3 * handle, const char *db_prefix,
+		       const char *coverage)
+{
+/* checking if a Coverage stores deduplicated tiles */
+    int ret;
+    int i;
+    char **results;
+    int rows;
+    int columns;
+    char *sql;
+    char *table;
+    char *xdb_prefix;
+    int dedup = 0;
+
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    table = sqlite3_mprintf ("%s_tile_blobs", coverage);
+    sql =
+	sqlite3_mprintf
+	("SELECT Count(*) FROM \"%s\".sqlite_master WHERE type = 'table' "
+	 "AND Lower(name) = Lower(%Q)", xdb_prefix, table);
+    free (xdb_prefix);
+    sqlite3_free (table);
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    for (i = 1; i <= rows; i++)
+      {
+	  if (atoi (results[(i * columns) + 0]) > 0)
+	      dedup = 1;
+      }
+    sqlite3_free_table (results);
+    return dedup;
+}
+
+RL2_PRIVATE int
+rl2_purge_dedup_tiles (sqlite3 * handle, const char *coverage)
+{
+/*
+/ reference-counted cleanup of a deduplicated Coverage
+/
+/ tile references are normally released by ON DELETE CASCADE, but
+/ they could be left behind when Foreign Keys aren't enforced;
+/ deleting any orphan reference will decrement the reference count
+/ of its payload, that will be removed as soon as it drops to zero
+*/
+    int ret;
+    char *sql;
+    char *sql_err = NULL;
+    char *xrefs;
+    char *xtiles;
+    char *xblobs;
+
+    if (!rl2_is_dedup_coverage (handle, NULL, coverage))
+	return 1;
+    xrefs = dedup_quoted_name ("", coverage, "_tile_refs");
+    xtiles = dedup_quoted_name ("", coverage, "_tiles");
+    xblobs = dedup_quoted_name ("", coverage, "_tile_blobs");
+    sql =
+	sqlite3_mprintf
+	("DELETE FROM main.\"%s\" WHERE tile_id NOT IN "
+	 "(SELECT tile_id FROM main.\"%s\");\n"
+	 "DELETE FROM main.\"%s\" WHERE ref_count <= 0", xrefs, xtiles,
+	 xblobs);
+    free (xrefs);
+    free (xtiles);
+    free (xblobs);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "PURGE \"%s_tile_blobs\" error: %s\n", coverage,
+		   sql_err);
+	  sqlite3_free (sql_err);
+	  return 0;
+      }
+    return 1;
+}
+
 RL2_DECLARE int
 rl2_drop_dbms_coverage (sqlite3 * handle, const char *coverage)
 {
@@ -1837,7 +2308,52 @@ rl2_drop_dbms_coverage (sqlite3 * handle, const char *coverage)
 /* dropping the TILE_DATA table */
     table = sqlite3_mprintf ("%s_tile_data", coverage);
     xtable = rl2_double_quoted_sql (table);
-    sql = sqlite3_mprintf ("DROP TABLE main.\"%s\"", xtable);
+    if (rl2_is_dedup_coverage (handle, NULL, coverage))
+      {
+	  /* deduplicated tiles: TILE_DATA view, TILE_REFS and TILE_BLOBS */
+	  char *xrefs = dedup_quoted_name ("", coverage, "_tile_refs");
+	  char *xblobs = dedup_quoted_name ("", coverage, "_tile_blobs");
+	  sql = sqlite3_mprintf ("DROP VIEW main.\"%s\";\n"
+				 "DROP TABLE main.\"%s\";\n"
+				 "DROP TABLE main.\"%s\"", xtable, xrefs,
+				 xblobs);
+	  free (xrefs);
+	  free (xblobs);
+      }
+    else
+	sql = sqlite3_mprintf ("DROP TABLE main.\"%s\"", xtable);
+    free (xtable);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "DROP TABLE \"%s\" error: %s\n", table, sql_err);
+	  sqlite3_free (sql_err);
+	  sqlite3_free (table);
+	  goto error;
+      }
+    sqlite3_free (table);
+
+/* dropping the ZSTD_DICTS table (if any) */
+    table = sqlite3_mprintf ("%s_zstd_dicts", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sql = sqlite3_mprintf ("DROP TABLE IF EXISTS main.\"%s\"", xtable);
+    free (xtable);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "DROP TABLE \"%s\" error: %s\n", table, sql_err);
+	  sqlite3_free (sql_err);
+	  sqlite3_free (table);
+	  goto error;
+      }
+    sqlite3_free (table);
+
+/* dropping the PYRAMID_DIRTY table (if any) */
+    table = sqlite3_mprintf ("%s_pyramid_dirty", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sql = sqlite3_mprintf ("DROP TABLE IF EXISTS main.\"%s\"", xtable);
     free (xtable);
     ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
     sqlite3_free (sql);
@@ -2695,6 +3211,14 @@ rl2_create_coverage_from_dbms (sqlite3 * handle, const char *db_prefix,
 	  rl2_destroy_coverage (cvg);
 	  return NULL;
       }
+    if (rl2_load_zstd_dictionaries (handle, db_prefix, cvg) != RL2_OK)
+      {
+	  fprintf (stderr,
+		   "ERROR: unable to load the ZSTD Dictionaries supporting \"%s\"\n",
+		   coverage);
+	  rl2_destroy_coverage (cvg);
+	  return NULL;
+      }
     return cvg;
 }
 
@@ -3672,46 +4196,133 @@ void_raw_buffer_palette_transparent (unsigned char *buffer, unsigned char *mask,
       }
 }
 
+static void
+release_decoder_cache (rl2AuxDecoderPtr decoder)
+{
+/* releasing the last decoded tile retained by an AuxDecoder */
+    if (decoder->cached_odd != NULL)
+	free (decoder->cached_odd);
+    if (decoder->cached_even != NULL)
+	free (decoder->cached_even);
+    if (decoder->cached_raster != NULL)
+	rl2_destroy_raster ((rl2RasterPtr) (decoder->cached_raster));
+    decoder->cached_odd = NULL;
+    decoder->cached_even = NULL;
+    decoder->cached_odd_sz = 0;
+    decoder->cached_even_sz = 0;
+    decoder->cached_raster = NULL;
+}
+
+static int
+is_cached_tile (rl2AuxDecoderPtr decoder)
+{
+/*
+/ checking if the current tile has exactly the same content of
+/ the last one decoded by this AuxDecoder (e.g. deduplicated or
+/ uniform tiles): if so, there is no need to decode it again
+*/
+    int sz = decoder->blob_odd_sz;
+    if (decoder->cached_raster == NULL || decoder->cached_odd == NULL)
+	return 0;
+    if (sz != decoder->cached_odd_sz
+	|| decoder->blob_even_sz != decoder->cached_even_sz)
+	return 0;
+    if (sz >= 5)
+      {
+	  /* quick check: the OddBlock's own CRC */
+	  if (memcmp
+	      (decoder->blob_odd + sz - 5, decoder->cached_odd + sz - 5,
+	       4) != 0)
+	      return 0;
+      }
+    if (memcmp (decoder->blob_odd, decoder->cached_odd, sz) != 0)
+	return 0;
+    if (decoder->blob_even != NULL || decoder->cached_even != NULL)
+      {
+	  if (decoder->blob_even == NULL || decoder->cached_even == NULL)
+	      return 0;
+	  if (memcmp
+	      (decoder->blob_even, decoder->cached_even,
+	       decoder->blob_even_sz) != 0)
+	      return 0;
+      }
+    return 1;
+}
+
 static void
 do_decode_tile (rl2AuxDecoderPtr decoder)
 {
 /* servicing an AuxDecoder Tile request */
-    decoder->raster =
-	(rl2PrivRasterPtr) rl2_raster_decode (decoder->scale,
-					      decoder->blob_odd,
-					      decoder->blob_odd_sz,
-					      decoder->blob_even,
-					      decoder->blob_even_sz,
-					      (rl2PalettePtr)
-					      (decoder->palette));
-    if (decoder->blob_odd != NULL)
-	free (decoder->blob_odd);
-    if (decoder->blob_even != NULL)
-	free (decoder->blob_even);
+    int ok;
+    double t0;
+    if (rl2_is_cancelled ())
+      {
+	  /* the request has been cancelled: skipping this Tile */
+	  if (decoder->blob_odd != NULL)
+	      free (decoder->blob_odd);
+	  if (decoder->blob_even != NULL)
+	      free (decoder->blob_even);
+	  if (decoder->palette != NULL)
+	      rl2_destroy_palette ((rl2PalettePtr) (decoder->palette));
+	  decoder->blob_odd = NULL;
+	  decoder->blob_even = NULL;
+	  decoder->palette = NULL;
+	  decoder->retcode = RL2_ERROR;
+	  return;
+      }
+    if (is_cached_tile (decoder))
+      {
+	  /* cache hit: reusing the already decoded Raster */
+	  if (decoder->blob_odd != NULL)
+	      free (decoder->blob_odd);
+	  if (decoder->blob_even != NULL)
+	      free (decoder->blob_even);
+	  if (decoder->palette != NULL)
+	      rl2_destroy_palette ((rl2PalettePtr) (decoder->palette));
+      }
+    else
+      {
+	  /* decoding the tile, then retaining it for further reuse */
+	  release_decoder_cache (decoder);
+	  decoder->cached_raster =
+	      (rl2PrivRasterPtr) rl2_raster_decode_dict (decoder->scale,
+							 decoder->blob_odd,
+							 decoder->blob_odd_sz,
+							 decoder->blob_even,
+							 decoder->blob_even_sz,
+							 (rl2PalettePtr)
+							 (decoder->palette),
+							 decoder->coverage);
+	  decoder->cached_odd = decoder->blob_odd;
+	  decoder->cached_odd_sz = decoder->blob_odd_sz;
+	  decoder->cached_even = decoder->blob_even;
+	  decoder->cached_even_sz = decoder->blob_even_sz;
+      }
     decoder->blob_odd = NULL;
     decoder->blob_even = NULL;
     decoder->palette = NULL;
-    if (decoder->raster == NULL)
+    if (decoder->cached_raster == NULL)
       {
 	  decoder->retcode = RL2_ERROR;
 	  return;
       }
-    if (!rl2_copy_raw_pixels_transparent
-	((rl2RasterPtr) (decoder->raster), decoder->outbuf, decoder->mask,
-	 decoder->width, decoder->height, decoder->sample_type,
+    t0 = rl2_perf_clock ();
+    ok = rl2_copy_raw_pixels_transparent
+	((rl2RasterPtr) (decoder->cached_raster), decoder->outbuf,
+	 decoder->mask, decoder->width, decoder->height, decoder->sample_type,
 	 decoder->num_bands, decoder->auto_band, decoder->syntetic_band,
 	 decoder->red_band_index, decoder->green_band_index,
 	 decoder->blue_band_index, decoder->nir_band_index, decoder->x_res,
 	 decoder->y_res, decoder->minx, decoder->maxy, decoder->tile_minx,
 	 decoder->tile_maxy, (rl2PixelPtr) (decoder->no_data),
 	 (rl2RasterSymbolizerPtr) (decoder->style),
-	 (rl2RasterStatisticsPtr) (decoder->stats)))
+	 (rl2RasterStatisticsPtr) (decoder->stats));
+    rl2_perf_add (RL2_PERF_PIXEL_COPY, t0, 0);
+    if (!ok)
       {
 	  decoder->retcode = RL2_ERROR;
 	  return;
       }
-    rl2_destroy_raster ((rl2RasterPtr) (decoder->raster));
-    decoder->raster = NULL;
     decoder->retcode = RL2_OK;
 }
 
@@ -3757,6 +4368,8 @@ doRunDecoderThread (void *arg)
 {
 /* threaded function: decoding a Tile */
     rl2AuxDecoderPtr decoder = (rl2AuxDecoderPtr) arg;
+    rl2_perf_set_thread_counters (decoder->perf);
+    rl2_cancel_set_thread_token (decoder->cancel);
     do_decode_tile (decoder);
 #if defined(_WIN32) && !defined(__MINGW32__)
     return 0;
@@ -3776,6 +4389,7 @@ doRunMaskDecoderThread (void *arg)
 {
 /* threaded function: decoding a Tile */
     rl2AuxMaskDecoderPtr decoder = (rl2AuxMaskDecoderPtr) arg;
+    rl2_perf_set_thread_counters (decoder->perf);
     do_decode_masktile (decoder);
 #if defined(_WIN32) && !defined(__MINGW32__)
     return 0;
@@ -3954,7 +4568,8 @@ do_run_decoder_children (rl2AuxDecoderPtr * thread_slots, int thread_count)
 	  decoder = *(thread_slots + i);
 	  if (decoder->retcode != RL2_OK)
 	    {
-		fprintf (stderr, ERR_FRMT64, decoder->tile_id);
+		if (!rl2_is_cancelled ())
+		    fprintf (stderr, ERR_FRMT64, decoder->tile_id);
 		goto error;
 	    }
       }
@@ -4053,6 +4668,7 @@ rl2_load_dbms_masktiles (sqlite3 * handle, int max_threads, int by_section,
     rl2AuxMaskDecoderPtr *thread_slots = NULL;
     int thread_count;
     int iaux;
+    struct rl2_perf_counters *perf = rl2_perf_get_thread_counters ();
 
     if (max_threads < 1)
 	max_threads = 1;
@@ -4078,6 +4694,7 @@ rl2_load_dbms_masktiles (sqlite3 * handle, int max_threads, int by_section,
 	  decoder->minx = minx;
 	  decoder->maxy = maxy;
 	  decoder->raster = NULL;
+	  decoder->perf = perf;
       }
 
 /* preparing the thread_slots stuct */
@@ -4110,6 +4727,8 @@ rl2_load_dbms_masktiles (sqlite3 * handle, int max_threads, int by_section,
 /* querying the tiles */
     while (1)
       {
+	  if (rl2_is_cancelled ())
+	      goto error;
 	  ret = sqlite3_step (stmt_tiles);
 	  if (ret == SQLITE_DONE)
 	      break;
@@ -4247,7 +4866,7 @@ rl2_load_dbms_tiles_common (sqlite3 * handle, int max_threads,
 			    double y_res, double minx, double maxy, int scale,
 			    rl2PalettePtr palette, rl2PixelPtr no_data,
 			    rl2RasterSymbolizerPtr style,
-			    rl2RasterStatisticsPtr stats)
+			    rl2RasterStatisticsPtr stats, rl2CoveragePtr cvg)
 {
 /* retrieving a full image from DBMS tiles */
     rl2RasterPtr raster = NULL;
@@ -4258,6 +4877,9 @@ rl2_load_dbms_tiles_common (sqlite3 * handle, int max_threads,
     rl2AuxDecoderPtr *thread_slots = NULL;
     int thread_count;
     int iaux;
+    double t0;
+    struct rl2_perf_counters *perf = rl2_perf_get_thread_counters ();
+    struct rl2_cancel_token *cancel = rl2_cancel_get_thread_token ();
 
     if (max_threads < 1)
 	max_threads = 1;
@@ -4298,6 +4920,14 @@ rl2_load_dbms_tiles_common (sqlite3 * handle, int max_threads,
 	  decoder->stats = (rl2PrivRasterStatisticsPtr) stats;
 	  decoder->raster = NULL;
 	  decoder->palette = NULL;
+	  decoder->cached_odd = NULL;
+	  decoder->cached_even = NULL;
+	  decoder->cached_odd_sz = 0;
+	  decoder->cached_even_sz = 0;
+	  decoder->cached_raster = NULL;
+	  decoder->perf = perf;
+	  decoder->cancel = cancel;
+	  decoder->coverage = cvg;
       }
 
 /* preparing the thread_slots stuct */
@@ -4309,7 +4939,11 @@ rl2_load_dbms_tiles_common (sqlite3 * handle, int max_threads,
 /* querying the tiles */
     while (1)
       {
+	  if (rl2_is_cancelled ())
+	      goto error;
+	  t0 = rl2_perf_clock ();
 	  ret = sqlite3_step (stmt_tiles);
+	  rl2_perf_add (RL2_PERF_TILE_QUERY, t0, 0);
 	  if (ret == SQLITE_DONE)
 	      break;
 	  if (ret == SQLITE_ROW)
@@ -4328,6 +4962,7 @@ rl2_load_dbms_tiles_common (sqlite3 * handle, int max_threads,
 		decoder->tile_maxy = tile_maxy;
 
 		/* retrieving tile raw data from BLOBs */
+		t0 = rl2_perf_clock ();
 		sqlite3_reset (stmt_data);
 		sqlite3_clear_bindings (stmt_data);
 		sqlite3_bind_int64 (stmt_data, 1, tile_id);
@@ -4373,6 +5008,8 @@ rl2_load_dbms_tiles_common (sqlite3 * handle, int max_threads,
 			       sqlite3_errmsg (handle));
 		      goto error;
 		  }
+		rl2_perf_add (RL2_PERF_BLOB_FETCH, t0,
+			      blob_odd_sz + blob_even_sz);
 		if (!ok)
 		  {
 		      if (decoder->blob_odd != NULL)
@@ -4408,7 +5045,8 @@ rl2_load_dbms_tiles_common (sqlite3 * handle, int max_threads,
 			    do_decode_tile (decoder);
 			    if (decoder->retcode != RL2_OK)
 			      {
-				  fprintf (stderr, ERR_FRMT64, tile_id);
+				  if (!rl2_is_cancelled ())
+				      fprintf (stderr, ERR_FRMT64, tile_id);
 				  goto error;
 			      }
 			}
@@ -4429,6 +5067,8 @@ rl2_load_dbms_tiles_common (sqlite3 * handle, int max_threads,
 	      goto error;
       }
 
+    for (iaux = 0; iaux < max_threads; iaux++)
+	release_decoder_cache (aux + iaux);
     free (aux);
     free (thread_slots);
     return 1;
@@ -4448,6 +5088,7 @@ rl2_load_dbms_tiles_common (sqlite3 * handle, int max_threads,
 		    rl2_destroy_raster ((rl2RasterPtr) (decoder->raster));
 		if (decoder->palette != NULL)
 		    rl2_destroy_palette ((rl2PalettePtr) (decoder->palette));
+		release_decoder_cache (decoder);
 		if (decoder->opaque_thread_id != NULL)
 		    free (decoder->opaque_thread_id);
 	    }
@@ -4481,7 +5122,8 @@ load_dbms_tiles_common_transparent (sqlite3 * handle, int max_threads,
 				    int scale, rl2PalettePtr palette,
 				    rl2PixelPtr no_data,
 				    rl2RasterSymbolizerPtr style,
-				    rl2RasterStatisticsPtr stats)
+				    rl2RasterStatisticsPtr stats,
+				    rl2CoveragePtr cvg)
 {
 /* retrieving a full image from DBMS tiles */
     rl2RasterPtr raster = NULL;
@@ -4492,6 +5134,9 @@ load_dbms_tiles_common_transparent (sqlite3 * handle, int max_threads,
     rl2AuxDecoderPtr *thread_slots = NULL;
     int thread_count;
     int iaux;
+    double t0;
+    struct rl2_perf_counters *perf = rl2_perf_get_thread_counters ();
+    struct rl2_cancel_token *cancel = rl2_cancel_get_thread_token ();
 
     if (max_threads < 1)
 	max_threads = 1;
@@ -4532,6 +5177,14 @@ load_dbms_tiles_common_transparent (sqlite3 * handle, int max_threads,
 	  decoder->stats = (rl2PrivRasterStatisticsPtr) stats;
 	  decoder->raster = NULL;
 	  decoder->palette = NULL;
+	  decoder->cached_odd = NULL;
+	  decoder->cached_even = NULL;
+	  decoder->cached_odd_sz = 0;
+	  decoder->cached_even_sz = 0;
+	  decoder->cached_raster = NULL;
+	  decoder->perf = perf;
+	  decoder->cancel = cancel;
+	  decoder->coverage = cvg;
       }
 
 /* preparing the thread_slots stuct */
@@ -4543,7 +5196,11 @@ load_dbms_tiles_common_transparent (sqlite3 * handle, int max_threads,
 /* querying the tiles */
     while (1)
       {
+	  if (rl2_is_cancelled ())
+	      goto error;
+	  t0 = rl2_perf_clock ();
 	  ret = sqlite3_step (stmt_tiles);
+	  rl2_perf_add (RL2_PERF_TILE_QUERY, t0, 0);
 	  if (ret == SQLITE_DONE)
 	      break;
 	  if (ret == SQLITE_ROW)
@@ -4562,6 +5219,7 @@ load_dbms_tiles_common_transparent (sqlite3 * handle, int max_threads,
 		decoder->tile_maxy = tile_maxy;
 
 		/* retrieving tile raw data from BLOBs */
+		t0 = rl2_perf_clock ();
 		sqlite3_reset (stmt_data);
 		sqlite3_clear_bindings (stmt_data);
 		sqlite3_bind_int64 (stmt_data, 1, tile_id);
@@ -4607,6 +5265,8 @@ load_dbms_tiles_common_transparent (sqlite3 * handle, int max_threads,
 			       sqlite3_errmsg (handle));
 		      goto error;
 		  }
+		rl2_perf_add (RL2_PERF_BLOB_FETCH, t0,
+			      blob_odd_sz + blob_even_sz);
 		if (!ok)
 		  {
 		      if (decoder->blob_odd != NULL)
@@ -4642,7 +5302,8 @@ load_dbms_tiles_common_transparent (sqlite3 * handle, int max_threads,
 			    do_decode_tile (decoder);
 			    if (decoder->retcode != RL2_OK)
 			      {
-				  fprintf (stderr, ERR_FRMT64, tile_id);
+				  if (!rl2_is_cancelled ())
+				      fprintf (stderr, ERR_FRMT64, tile_id);
 				  goto error;
 			      }
 			}
@@ -4663,6 +5324,8 @@ load_dbms_tiles_common_transparent (sqlite3 * handle, int max_threads,
 	      goto error;
       }
 
+    for (iaux = 0; iaux < max_threads; iaux++)
+	release_decoder_cache (aux + iaux);
     free (aux);
     free (thread_slots);
     return 1;
@@ -4682,6 +5345,7 @@ load_dbms_tiles_common_transparent (sqlite3 * handle, int max_threads,
 		    rl2_destroy_raster ((rl2RasterPtr) (decoder->raster));
 		if (decoder->palette != NULL)
 		    rl2_destroy_palette ((rl2PalettePtr) (decoder->palette));
+		release_decoder_cache (decoder);
 		if (decoder->opaque_thread_id != NULL)
 		    free (decoder->opaque_thread_id);
 	    }
@@ -5048,7 +5712,7 @@ load_triple_band_dbms_tiles (sqlite3 * handle, sqlite3_stmt * stmt_tiles,
 			     unsigned char blue_band, double x_res,
 			     double y_res, double minx, double miny,
 			     double maxx, double maxy, int level, int scale,
-			     rl2PixelPtr no_data)
+			     rl2PixelPtr no_data, rl2CoveragePtr cvg)
 {
 /* retrieving a full image from DBMS tiles */
     rl2RasterPtr raster = NULL;
@@ -5066,6 +5730,8 @@ load_triple_band_dbms_tiles (sqlite3 * handle, sqlite3_stmt * stmt_tiles,
 /* querying the tiles */
     while (1)
       {
+	  if (rl2_is_cancelled ())
+	      goto error;
 	  ret = sqlite3_step (stmt_tiles);
 	  if (ret == SQLITE_DONE)
 	      break;
@@ -5107,8 +5773,8 @@ load_triple_band_dbms_tiles (sqlite3 * handle, sqlite3_stmt * stmt_tiles,
 		      goto error;
 		  }
 		raster =
-		    rl2_raster_decode (scale, blob_odd, blob_odd_sz,
-				       blob_even, blob_even_sz, NULL);
+		    rl2_raster_decode_dict (scale, blob_odd, blob_odd_sz,
+					    blob_even, blob_even_sz, NULL, cvg);
 		if (raster == NULL)
 		  {
 		      fprintf (stderr, ERR_FRMT64, tile_id);
@@ -5406,7 +6072,7 @@ load_mono_band_dbms_tiles (sqlite3 * handle, sqlite3_stmt * stmt_tiles,
 			   unsigned char mono_band, double x_res,
 			   double y_res, double minx, double miny,
 			   double maxx, double maxy, int level, int scale,
-			   rl2PixelPtr no_data)
+			   rl2PixelPtr no_data, rl2CoveragePtr cvg)
 {
 /* retrieving a full image from DBMS tiles */
     rl2RasterPtr raster = NULL;
@@ -5424,6 +6090,8 @@ load_mono_band_dbms_tiles (sqlite3 * handle, sqlite3_stmt * stmt_tiles,
 /* querying the tiles */
     while (1)
       {
+	  if (rl2_is_cancelled ())
+	      goto error;
 	  ret = sqlite3_step (stmt_tiles);
 	  if (ret == SQLITE_DONE)
 	      break;
@@ -5465,8 +6133,8 @@ load_mono_band_dbms_tiles (sqlite3 * handle, sqlite3_stmt * stmt_tiles,
 		      goto error;
 		  }
 		raster =
-		    rl2_raster_decode (scale, blob_odd, blob_odd_sz,
-				       blob_even, blob_even_sz, NULL);
+		    rl2_raster_decode_dict (scale, blob_odd, blob_odd_sz,
+					    blob_even, blob_even_sz, NULL, cvg);
 		if (raster == NULL)
 		  {
 		      fprintf (stderr, ERR_FRMT64, tile_id);
@@ -5509,7 +6177,7 @@ rl2_load_dbms_tiles (sqlite3 * handle, int max_threads,
 		     double minx, double miny, double maxx, double maxy,
 		     int level, int scale, rl2PalettePtr palette,
 		     rl2PixelPtr no_data, rl2RasterSymbolizerPtr style,
-		     rl2RasterStatisticsPtr stats)
+		     rl2RasterStatisticsPtr stats, rl2CoveragePtr cvg)
 {
 /* binding the query args */
     sqlite3_reset (stmt_tiles);
@@ -5524,7 +6192,7 @@ rl2_load_dbms_tiles (sqlite3 * handle, int max_threads,
 	(handle, max_threads, stmt_tiles, stmt_data, outbuf, width, height,
 	 sample_type, num_bands, auto_band, syntetic_band, red_band_index,
 	 green_band_index, blue_band_index, nir_band_index, x_res, y_res, minx,
-	 maxy, scale, palette, no_data, style, stats))
+	 maxy, scale, palette, no_data, style, stats, cvg))
 	return 0;
     return 1;
 }
@@ -5544,7 +6212,8 @@ rl2_load_dbms_tiles_section (sqlite3 * handle, int max_threads,
 			     unsigned char nir_band_index, double x_res,
 			     double y_res, double minx, double miny,
 			     double maxx, double maxy, int level, int scale,
-			     rl2PalettePtr palette, rl2PixelPtr no_data)
+			     rl2PalettePtr palette, rl2PixelPtr no_data,
+			     rl2CoveragePtr cvg)
 {
 /* binding the query args */
     sqlite3_reset (stmt_tiles);
@@ -5560,7 +6229,7 @@ rl2_load_dbms_tiles_section (sqlite3 * handle, int max_threads,
 	(handle, max_threads, stmt_tiles, stmt_data, outbuf, width, height,
 	 sample_type, num_bands, auto_band, syntetic_band, red_band_index,
 	 green_band_index, blue_band_index, nir_band_index, x_res, y_res, minx,
-	 maxy, scale, palette, no_data, NULL, NULL))
+	 maxy, scale, palette, no_data, NULL, NULL, cvg))
 	return 0;
     return 1;
 }
@@ -5583,7 +6252,7 @@ rl2_load_dbms_tiles_transparent (sqlite3 * handle, int max_threads,
 				 double maxx, double maxy, int level, int scale,
 				 rl2PalettePtr palette, rl2PixelPtr no_data,
 				 rl2RasterSymbolizerPtr style,
-				 rl2RasterStatisticsPtr stats)
+				 rl2RasterStatisticsPtr stats, rl2CoveragePtr cvg)
 {
 /* binding the query args */
     sqlite3_reset (stmt_tiles);
@@ -5598,7 +6267,8 @@ rl2_load_dbms_tiles_transparent (sqlite3 * handle, int max_threads,
 	(handle, max_threads, stmt_tiles, stmt_data, outbuf, mask, width,
 	 height, sample_type, num_bands, auto_band, syntetic_band,
 	 red_band_index, green_band_index, blue_band_index, nir_band_index,
-	 x_res, y_res, minx, maxy, scale, palette, no_data, style, stats))
+	 x_res, y_res, minx, maxy, scale, palette, no_data, style, stats,
+	 cvg))
 	return 0;
     return 1;
 }
@@ -5624,7 +6294,7 @@ rl2_load_dbms_tiles_section_transparent (sqlite3 * handle, int max_threads,
 					 double minx, double miny, double maxx,
 					 double maxy, int level, int scale,
 					 rl2PalettePtr palette,
-					 rl2PixelPtr no_data)
+					 rl2PixelPtr no_data, rl2CoveragePtr cvg)
 {
 /* binding the query args */
     sqlite3_reset (stmt_tiles);
@@ -5640,11 +6310,65 @@ rl2_load_dbms_tiles_section_transparent (sqlite3 * handle, int max_threads,
 	(handle, max_threads, stmt_tiles, stmt_data, outbuf, mask, width,
 	 height, sample_type, num_bands, auto_band, syntetic_band,
 	 red_band_index, green_band_index, blue_band_index, nir_band_index,
-	 x_res, y_res, minx, maxy, scale, palette, no_data, NULL, NULL))
+	 x_res, y_res, minx, maxy, scale, palette, no_data, NULL, NULL,
+	 cvg))
 	return 0;
     return 1;
 }
 
+static int
+find_cached_matching_resolution (struct rl2_cached_coverage *entry,
+				 double *x_res, double *y_res,
+				 unsigned char *level, unsigned char *scale)
+{
+/* identifying the corresponding resolution level - Metadata Cache */
+    static const unsigned char scales[4] =
+	{ RL2_SCALE_1, RL2_SCALE_2, RL2_SCALE_4, RL2_SCALE_8 };
+    int found = 0;
+    int x_level;
+    int x_scale;
+    double z_x_res;
+    double z_y_res;
+    int i;
+    int s;
+
+    for (i = entry->num_levels - 1; i >= 0; i--)
+      {
+	  /* cached levels are sorted by descending pyramid_level */
+	  struct rl2_cached_level *lvl = entry->levels + i;
+	  for (s = 0; s < 4; s++)
+	    {
+		double confidence;
+		double xx_res = lvl->x_res[s];
+		double yy_res = lvl->y_res[s];
+		if (!(lvl->valid & (1 << s)))
+		    continue;
+		confidence = xx_res / 100.0;
+		if (*x_res < (xx_res - confidence)
+		    || *x_res > (xx_res + confidence))
+		    continue;
+		confidence = yy_res / 100.0;
+		if (*y_res < (yy_res - confidence)
+		    || *y_res > (yy_res + confidence))
+		    continue;
+		found = 1;
+		x_level = lvl->level;
+		x_scale = scales[s];
+		z_x_res = xx_res;
+		z_y_res = yy_res;
+	    }
+      }
+    if (found)
+      {
+	  *level = x_level;
+	  *scale = x_scale;
+	  *x_res = z_x_res;
+	  *y_res = z_y_res;
+	  return RL2_OK;
+      }
+    return RL2_ERROR;
+}
+
 RL2_DECLARE int
 rl2_find_matching_resolution (sqlite3 * handle, rl2CoveragePtr cvg,
 			      int by_section, sqlite3_int64 section_id,
@@ -5672,6 +6396,10 @@ rl2_find_matching_resolution (sqlite3 * handle, rl2CoveragePtr cvg,
     if (coverage->coverageName == NULL)
 	return RL2_ERROR;
 
+    if (coverage->cached != NULL && !(coverage->cached->mixed_resolutions))
+	return find_cached_matching_resolution (coverage->cached, x_res,
+						y_res, level, scale);
+
     if (rl2_is_mixed_resolutions_coverage
 	(handle, coverage->dbPrefix, coverage->coverageName) > 0)
 	mixed_resolutions = 1;
@@ -6183,7 +6911,7 @@ rl2_get_raw_raster_data_common (sqlite3 * handle, int max_threads,
 	  /* Pyramid tiles PALETTE */
 	  rl2PixelPtr nd = NULL;
 	  nd = rl2_get_coverage_no_data (cvg);
-	  plt = rl2_get_dbms_palette (handle, db_prefix, coverage);
+	  plt = rl2_get_coverage_palette (handle, cvg);
 	  if (nd != NULL)
 	    {
 		/* creating an RGB NoData pixel */
@@ -6253,7 +6981,7 @@ rl2_get_raw_raster_data_common (sqlite3 * handle, int max_threads,
 	  if (pixel_type == RL2_PIXEL_PALETTE)
 	    {
 		/* attempting to retrieve the Coverage's Palette */
-		plt = rl2_get_dbms_palette (handle, db_prefix, coverage);
+		plt = rl2_get_coverage_palette (handle, cvg);
 		if (plt == NULL)
 		    goto error;
 	    }
@@ -6476,7 +7204,7 @@ rl2_get_raw_raster_data_common (sqlite3 * handle, int max_threads,
 	      (handle, max_threads, section_id, stmt_tiles, stmt_data, bufpix,
 	       width, height, sample_type, num_bands, auto_ndvi, syntetic_band,
 	       red_band, green_band, blue_band, nir_band, xx_res, yy_res, minx,
-	       miny, maxx, maxy, level, scale, plt, no_data))
+	       miny, maxx, maxy, level, scale, plt, no_data, cvg))
 	      goto error;
       }
     else
@@ -6486,7 +7214,8 @@ rl2_get_raw_raster_data_common (sqlite3 * handle, int max_threads,
 	      (handle, max_threads, stmt_tiles, stmt_data, bufpix, width,
 	       height, sample_type, num_bands, auto_ndvi, syntetic_band,
 	       red_band, green_band, blue_band, nir_band, xx_res, yy_res, minx,
-	       miny, maxx, maxy, level, scale, plt, no_data, style, stats))
+	       miny, maxx, maxy, level, scale, plt, no_data, style, stats,
+	       cvg))
 	      goto error;
       }
     if (kill_no_data != NULL)
@@ -6863,7 +7592,8 @@ rl2_get_raw_raster_data_common_transparent (sqlite3 * handle, int max_threads,
 	      (handle, max_threads, section_id, stmt_tiles, stmt_data, bufpix,
 	       bufmask, width, height, sample_type, num_bands, auto_ndvi,
 	       syntetic_band, red_band, green_band, blue_band, nir_band, xx_res,
-	       yy_res, minx, miny, maxx, maxy, level, scale, plt, no_data))
+	       yy_res, minx, miny, maxx, maxy, level, scale, plt, no_data,
+	       cvg))
 	      goto error;
       }
     else
@@ -6873,7 +7603,8 @@ rl2_get_raw_raster_data_common_transparent (sqlite3 * handle, int max_threads,
 	      (handle, max_threads, stmt_tiles, stmt_data, bufpix, bufmask,
 	       width, height, sample_type, num_bands, auto_ndvi, syntetic_band,
 	       red_band, green_band, blue_band, nir_band, xx_res, yy_res, minx,
-	       miny, maxx, maxy, level, scale, plt, no_data, style, stats))
+	       miny, maxx, maxy, level, scale, plt, no_data, style, stats,
+	       cvg))
 	      goto error;
       }
     sqlite3_finalize (stmt_tiles);
@@ -7027,7 +7758,7 @@ get_raw_raster_data_nodata (sqlite3 * handle, int max_threads,
 	  if (pixel_type == RL2_PIXEL_PALETTE)
 	    {
 		/* attempting to retrieve the Coverage's Palette */
-		plt = rl2_get_dbms_palette (handle, db_prefix, coverage);
+		plt = rl2_get_coverage_palette (handle, cvg);
 		if (plt == NULL)
 		    goto error;
 	    }
@@ -7267,7 +7998,8 @@ get_raw_raster_data_nodata (sqlite3 * handle, int max_threads,
 	      (handle, max_threads, section_id, stmt_tiles, stmt_data, bufpix,
 	       bufmask, width, height, sample_type, num_bands, auto_ndvi,
 	       syntetic_band, red_band, green_band, blue_band, nir_band, xx_res,
-	       yy_res, minx, miny, maxx, maxy, level, scale, plt, no_data))
+	       yy_res, minx, miny, maxx, maxy, level, scale, plt, no_data,
+	       cvg))
 	      goto error;
       }
     else
@@ -7277,7 +8009,8 @@ get_raw_raster_data_nodata (sqlite3 * handle, int max_threads,
 	      (handle, max_threads, stmt_tiles, stmt_data, bufpix, bufmask,
 	       width, height, sample_type, num_bands, auto_ndvi, syntetic_band,
 	       red_band, green_band, blue_band, nir_band, xx_res, yy_res, minx,
-	       miny, maxx, maxy, level, scale, plt, no_data, style, stats))
+	       miny, maxx, maxy, level, scale, plt, no_data, style, stats,
+	       cvg))
 	      goto error;
       }
     sqlite3_finalize (stmt_tiles);
@@ -7522,7 +8255,7 @@ get_triple_band_raw_raster_data_common (int by_section, sqlite3 * handle,
     if (!load_triple_band_dbms_tiles
 	(handle, stmt_tiles, stmt_data, bufpix, width, height, red_band,
 	 green_band, blue_band, xx_res, yy_res, minx, miny, maxx, maxy, level,
-	 scale, no_data))
+	 scale, no_data, cvg))
 	goto error;
     sqlite3_finalize (stmt_tiles);
     sqlite3_finalize (stmt_data);
@@ -7730,7 +8463,7 @@ get_mono_band_raw_raster_data_common (int by_section, sqlite3 * handle,
     void_raw_buffer (bufpix, width, height, sample_type, 1, no_data);
     if (!load_mono_band_dbms_tiles
 	(handle, stmt_tiles, stmt_data, bufpix, width, height, mono_band,
-	 xx_res, yy_res, minx, miny, maxx, maxy, level, scale, no_data))
+	 xx_res, yy_res, minx, miny, maxx, maxy, level, scale, no_data, cvg))
 	goto error;
     sqlite3_finalize (stmt_tiles);
     sqlite3_finalize (stmt_data);
@@ -7848,8 +8581,7 @@ rl2_get_raw_raster_data_bgcolor (sqlite3 * handle, int max_threads,
       {
 	  /* Palette */
 	  int index = -1;
-	  rl2PalettePtr palette =
-	      rl2_get_dbms_palette (handle, db_prefix, coverage);
+	  rl2PalettePtr palette = rl2_get_coverage_palette (handle, cvg);
 	  if (palette != NULL)
 	    {
 		/* searching the background color from within the palette */
@@ -1891,8 +1891,9 @@ do_drape_geoms (rl2AuxDrapeGeometriesPtr aux)
 		if (raster == NULL)
 		  {
 		      raster =
-			  rl2_raster_decode (RL2_SCALE_1, odd_blob, odd_sz,
-					     even_blob, even_sz, NULL);
+			  rl2_raster_decode_dict (RL2_SCALE_1, odd_blob,
+						  odd_sz, even_blob, even_sz,
+						  NULL, aux->coverage);
 		      if (raster == NULL)
 			{
 			    if (aux->message != NULL)
@@ -1956,6 +1957,7 @@ do_drape_geometries (sqlite3 * sqlite, const char *db_prefix,
     sqlite3_stmt *stmt_tile = NULL;
     sqlite3_stmt *stmt_geom = NULL;
     sqlite3_stmt *stmt_upd = NULL;
+    rl2CoveragePtr cvg = NULL;
     int ret;
     int has_no_data;
     double no_data;
@@ -1979,6 +1981,10 @@ do_drape_geometries (sqlite3 * sqlite, const char *db_prefix,
 /* checking the Spatial Table for validity */
     if (!check_table (sqlite, spatial_table, geom_name, &has_z, &has_m))
 	goto error;
+/* loading the Raster Coverage (required by ZSTD dictionaries) */
+    cvg = rl2_create_coverage_from_dbms (sqlite, db_prefix, raster_coverage);
+    if (cvg == NULL)
+	goto error;
 
 /* preparing the SQL query - raster tiles */
     if (db_prefix == NULL)
@@ -2095,6 +2101,7 @@ do_drape_geometries (sqlite3 * sqlite, const char *db_prefix,
 			    aux.odd_sz = odd_sz;
 			    aux.even_blob = even_blob;
 			    aux.even_sz = even_sz;
+			    aux.coverage = cvg;
 			    aux.horz_res = horz_res;
 			    aux.vert_res = vert_res;
 			    aux.update_m = update_m;
@@ -2125,6 +2132,7 @@ do_drape_geometries (sqlite3 * sqlite, const char *db_prefix,
     sqlite3_finalize (stmt_tile);
     sqlite3_finalize (stmt_geom);
     sqlite3_finalize (stmt_upd);
+    rl2_destroy_coverage (cvg);
     return 1;
 
   error:
@@ -2134,6 +2142,8 @@ do_drape_geometries (sqlite3 * sqlite, const char *db_prefix,
 	sqlite3_finalize (stmt_geom);
     if (stmt_upd != NULL)
 	sqlite3_finalize (stmt_upd);
+    if (cvg != NULL)
+	rl2_destroy_coverage (cvg);
     return 0;
 }
 
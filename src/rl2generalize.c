@@ -0,0 +1,968 @@
+/*
+
+ rl2generalize -- multi-resolution generalized Vector Coverages
+
+ version 0.1, 2026 October 18
+
+ Author: Sandro Furieri a.furieri@lqt.it
+
+ -----------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2026
+the Initial Developer. All Rights Reserved.
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <float.h>
+
+#include "config.h"
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef LOADABLE_EXTENSION
+#include "rasterlite2/sqlite.h"
+#endif
+
+#include "rasterlite2/rasterlite2.h"
+#include "rasterlite2_private.h"
+
+/*
+/ a Vector Coverage can optionally have a precomputed generalization
+/ store: simplified copies of all Features, one for each scale band,
+/ stored into the "<coverage>_generalized" table (supported by its
+/ own Spatial Index)
+/
+/ each band applies to all scales greater or equal than its minimum
+/ scale, and no vertex of a generalized Geometry is moved by more
+/ than half a pixel at that scale
+/
+/ the store is kept in sync by Triggers on the Features table: any
+/ inserted or updated Feature is stored at full resolution for all
+/ bands (until the next rebuild) and deleted Features are removed;
+/ unregistering the Coverage empties the store
+*/
+
+/* the minimum scale (denominator) of each band */
+static const double rl2_gen_band_scales[RL2_VECTOR_GEN_BANDS] = {
+    50000.0, 200000.0, 800000.0, 3200000.0, 12800000.0, 51200000.0
+};
+
+/* how many Features are generalized by a single thread each time */
+#define RL2_GEN_FEATURES_PER_THREAD	256
+
+static char *
+gen_table_name (const char *coverage)
+{
+/* returns the (double quoted) name of the generalization table */
+    char *table = sqlite3_mprintf ("%s_generalized", coverage);
+    char *xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    return xtable;
+}
+
+static char *
+gen_trigger_name (const char *coverage, const char *suffix)
+{
+/* returns the (double quoted) name of a generalization Trigger */
+    char *trigger = sqlite3_mprintf ("%s_gen_%s", coverage, suffix);
+    char *xtrigger = rl2_double_quoted_sql (trigger);
+    sqlite3_free (trigger);
+    return xtrigger;
+}
+
+static int
+do_exec_sql (sqlite3 * handle, char *sql, const char *what)
+{
+/* executing an SQL statement (will free the SQL text) */
+    int ret;
+    char *sql_err = NULL;
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "%s error: %s\n", what, sql_err);
+	  sqlite3_free (sql_err);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+gen_table_exists (sqlite3 * handle, const char *db_prefix,
+		  const char *coverage)
+{
+/* checking if the generalization table does exist */
+    char *sql;
+    char *table;
+    char *xdb_prefix;
+    char **results;
+    int rows;
+    int columns;
+    int i;
+    int ret;
+    int exists = 0;
+
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    table = sqlite3_mprintf ("%s_generalized", coverage);
+    sql =
+	sqlite3_mprintf ("SELECT Count(*) FROM \"%s\".sqlite_master "
+			 "WHERE type = 'table' AND Lower(name) = Lower(%Q)",
+			 xdb_prefix, table);
+    free (xdb_prefix);
+    sqlite3_free (table);
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    for (i = 1; i <= rows; i++)
+      {
+	  if (atoi (results[(i * columns) + 0]) > 0)
+	      exists = 1;
+      }
+    sqlite3_free_table (results);
+    return exists;
+}
+
+static int
+gen_store_is_live (sqlite3 * handle, const char *db_prefix,
+		   const char *coverage, const char *f_table_name)
+{
+/*
+/ checking if all the Triggers keeping the generalization store
+/ in sync are still defined on the Features table; a store left
+/ behind by a dropped (or re-registered) Coverage is stale
+*/
+    char *sql;
+    char *xdb_prefix;
+    char *ins;
+    char *upd;
+    char *del;
+    char **results;
+    int rows;
+    int columns;
+    int i;
+    int ret;
+    int count = 0;
+
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    ins = sqlite3_mprintf ("%s_gen_ins", coverage);
+    upd = sqlite3_mprintf ("%s_gen_upd", coverage);
+    del = sqlite3_mprintf ("%s_gen_del", coverage);
+    sql =
+	sqlite3_mprintf ("SELECT Count(*) FROM \"%s\".sqlite_master "
+			 "WHERE type = 'trigger' AND Lower(tbl_name) = Lower(%Q) "
+			 "AND Lower(name) IN (Lower(%Q), Lower(%Q), Lower(%Q))",
+			 xdb_prefix, f_table_name, ins, upd, del);
+    free (xdb_prefix);
+    sqlite3_free (ins);
+    sqlite3_free (upd);
+    sqlite3_free (del);
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    for (i = 1; i <= rows; i++)
+	count = atoi (results[(i * columns) + 0]);
+    sqlite3_free_table (results);
+    return (count == 3) ? 1 : 0;
+}
+
+RL2_PRIVATE int
+rl2_find_vector_generalization (sqlite3 * handle, const char *db_prefix,
+				const char *coverage,
+				rl2VectorMultiLayerPtr multi, double scale)
+{
+/*
+/ returns the generalization band to be used at a given scale
+/ or -1 if full resolution Geometries should be used instead
+*/
+    rl2PrivVectorMultiLayerPtr mlyr = (rl2PrivVectorMultiLayerPtr) multi;
+    rl2PrivVectorLayerPtr lyr;
+    int band = -1;
+    int i;
+    if (coverage == NULL || mlyr == NULL)
+	return -1;
+    if (mlyr->count != 1)
+	return -1;
+    lyr = *(mlyr->layers + 0);
+    if (lyr == NULL)
+	return -1;
+    for (i = 0; i < RL2_VECTOR_GEN_BANDS; i++)
+      {
+	  if (scale >= rl2_gen_band_scales[i])
+	      band = i;
+      }
+    if (band < 0)
+	return -1;
+    if (!gen_table_exists (handle, db_prefix, coverage))
+	return -1;
+    if (!gen_store_is_live (handle, db_prefix, coverage, lyr->f_table_name))
+	return -1;
+    return band;
+}
+
+RL2_PRIVATE char *
+rl2_generalized_geometry_sql (const char *db_prefix, const char *coverage,
+			      rl2PrivVectorLayerPtr lyr, int band)
+{
+/* SQL expression fetching the generalized Geometry of each Feature */
+    char *sql;
+    char *xdb_prefix;
+    char *xgen;
+    char *xtable;
+    char *xrowid = NULL;
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    xgen = gen_table_name (coverage);
+    if (lyr->view_name != NULL)
+      {
+	  xtable = rl2_double_quoted_sql (lyr->view_name);
+	  xrowid = rl2_double_quoted_sql (lyr->view_rowid);
+      }
+    else
+	xtable = rl2_double_quoted_sql (lyr->f_table_name);
+    if (xrowid != NULL)
+	sql =
+	    sqlite3_mprintf
+	    ("(SELECT g.geometry FROM \"%s\".\"%s\" AS g WHERE g.band = %d "
+	     "AND g.feature_id = \"%s\".\"%s\")", xdb_prefix, xgen, band,
+	     xtable, xrowid);
+    else
+	sql =
+	    sqlite3_mprintf
+	    ("(SELECT g.geometry FROM \"%s\".\"%s\" AS g WHERE g.band = %d "
+	     "AND g.feature_id = \"%s\".ROWID)", xdb_prefix, xgen, band,
+	     xtable);
+    free (xdb_prefix);
+    free (xgen);
+    free (xtable);
+    if (xrowid != NULL)
+	free (xrowid);
+    return sql;
+}
+
+RL2_PRIVATE char *
+rl2_generalized_filter_sql (const char *db_prefix, const char *coverage,
+			    rl2PrivVectorLayerPtr lyr, int band,
+			    const char *search_frame)
+{
+/* SQL spatial filter based on the Spatial Index of the generalized Geometries */
+    char *sql;
+    char *xdb_prefix;
+    char *xgen;
+    char *rtree_name;
+    char *rowid;
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    xgen = gen_table_name (coverage);
+    rtree_name =
+	sqlite3_mprintf ("DB=%s.%s_generalized", db_prefix, coverage);
+    if (lyr->view_rowid != NULL)
+      {
+	  char *qrowid = rl2_double_quoted_sql (lyr->view_rowid);
+	  rowid = sqlite3_mprintf ("\"%s\"", qrowid);
+	  free (qrowid);
+      }
+    else
+	rowid = sqlite3_mprintf ("ROWID");
+    sql =
+	sqlite3_mprintf
+	("%s IN (SELECT feature_id FROM \"%s\".\"%s\" WHERE band = %d "
+	 "AND ROWID IN (SELECT ROWID FROM SpatialIndex WHERE f_table_name = %Q "
+	 "AND f_geometry_column = 'geometry' AND search_frame = %s))", rowid,
+	 xdb_prefix, xgen, band, rtree_name, search_frame);
+    free (xdb_prefix);
+    free (xgen);
+    sqlite3_free (rtree_name);
+    sqlite3_free (rowid);
+    return sql;
+}
+
+static int
+drop_gen_triggers (sqlite3 * handle, const char *coverage)
+{
+/* dropping all Triggers supporting the generalization store */
+    const char *suffixes[] = { "ins", "upd", "del", "unreg", NULL };
+    int i;
+    char *xtrigger;
+    char *sql;
+
+    for (i = 0; suffixes[i] != NULL; i++)
+      {
+	  xtrigger = gen_trigger_name (coverage, suffixes[i]);
+	  sql = sqlite3_mprintf ("DROP TRIGGER IF EXISTS main.\"%s\"", xtrigger);
+	  free (xtrigger);
+	  if (!do_exec_sql (handle, sql, "DROP TRIGGER"))
+	      return 0;
+      }
+    return 1;
+}
+
+static char *
+gen_bands_sql (void)
+{
+/* an inline table listing all the bands */
+    int k;
+    char *sql = sqlite3_mprintf ("SELECT 0 AS band");
+    for (k = 1; k < RL2_VECTOR_GEN_BANDS; k++)
+      {
+	  char *prev = sql;
+	  sql = sqlite3_mprintf ("%s UNION ALL SELECT %d", prev, k);
+	  sqlite3_free (prev);
+      }
+    return sql;
+}
+
+static int
+create_gen_triggers (sqlite3 * handle, const char *coverage,
+		     const char *f_table_name, const char *f_geometry_column)
+{
+/* creating all Triggers keeping the generalization store in sync */
+    char *xtrigger;
+    char *xgen;
+    char *xtable;
+    char *xgeom;
+    char *bands;
+    char *sql;
+    int ok = 0;
+
+    xgen = gen_table_name (coverage);
+    xtable = rl2_double_quoted_sql (f_table_name);
+    xgeom = rl2_double_quoted_sql (f_geometry_column);
+    bands = gen_bands_sql ();
+
+/* inserted Features: full resolution Geometry for all bands */
+    xtrigger = gen_trigger_name (coverage, "ins");
+    sql =
+	sqlite3_mprintf ("CREATE TRIGGER main.\"%s\" AFTER INSERT ON \"%s\"\n"
+			 "FOR EACH ROW WHEN NEW.\"%s\" IS NOT NULL BEGIN\n"
+			 "INSERT INTO \"%s\" (id, band, feature_id, geometry) "
+			 "SELECT NULL, b.band, NEW.ROWID, CastToXY(NEW.\"%s\") "
+			 "FROM (%s) AS b;\nEND", xtrigger, xtable, xgeom, xgen,
+			 xgeom, bands);
+    free (xtrigger);
+    if (!do_exec_sql (handle, sql, "CREATE TRIGGER"))
+	goto end;
+
+/* updated Features: replacing all their generalized Geometries */
+    xtrigger = gen_trigger_name (coverage, "upd");
+    sql =
+	sqlite3_mprintf ("CREATE TRIGGER main.\"%s\" AFTER UPDATE ON \"%s\"\n"
+			 "FOR EACH ROW WHEN OLD.ROWID <> NEW.ROWID "
+			 "OR NEW.\"%s\" IS NOT OLD.\"%s\" BEGIN\n"
+			 "DELETE FROM \"%s\" WHERE feature_id = OLD.ROWID;\n"
+			 "INSERT INTO \"%s\" (id, band, feature_id, geometry) "
+			 "SELECT NULL, b.band, NEW.ROWID, CastToXY(NEW.\"%s\") "
+			 "FROM (%s) AS b WHERE NEW.\"%s\" IS NOT NULL;\nEND",
+			 xtrigger, xtable, xgeom, xgeom, xgen, xgen, xgeom,
+			 bands, xgeom);
+    free (xtrigger);
+    if (!do_exec_sql (handle, sql, "CREATE TRIGGER"))
+	goto end;
+
+/* deleted Features */
+    xtrigger = gen_trigger_name (coverage, "del");
+    sql =
+	sqlite3_mprintf ("CREATE TRIGGER main.\"%s\" AFTER DELETE ON \"%s\"\n"
+			 "FOR EACH ROW BEGIN\n"
+			 "DELETE FROM \"%s\" WHERE feature_id = OLD.ROWID;\nEND",
+			 xtrigger, xtable, xgen);
+    free (xtrigger);
+    if (!do_exec_sql (handle, sql, "CREATE TRIGGER"))
+	goto end;
+
+/* unregistering the Coverage empties the store */
+    xtrigger = gen_trigger_name (coverage, "unreg");
+    sql =
+	sqlite3_mprintf ("CREATE TRIGGER main.\"%s\" AFTER DELETE ON "
+			 "vector_coverages\nFOR EACH ROW "
+			 "WHEN Lower(OLD.coverage_name) = Lower(%Q) BEGIN\n"
+			 "DELETE FROM \"%s\";\nEND", xtrigger, coverage, xgen);
+    free (xtrigger);
+    if (!do_exec_sql (handle, sql, "CREATE TRIGGER"))
+	goto end;
+    ok = 1;
+
+  end:
+    free (xgen);
+    free (xtable);
+    free (xgeom);
+    sqlite3_free (bands);
+    return ok;
+}
+
+RL2_PRIVATE int
+rl2_drop_vector_generalization (sqlite3 * handle, const char *coverage)
+{
+/* dropping the generalization store of some Vector Coverage (if any) */
+    int ret;
+    char *sql;
+    char *sql_err = NULL;
+    char *table;
+    char *xtable;
+
+    if (!drop_gen_triggers (handle, coverage))
+	return RL2_ERROR;
+    if (!gen_table_exists (handle, NULL, coverage))
+	return RL2_OK;
+
+/* disabling the spatial index */
+    table = sqlite3_mprintf ("%s_generalized", coverage);
+    sql = sqlite3_mprintf ("SELECT DisableSpatialIndex("
+			   "%Q, 'geometry')", table);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "DisableSpatialIndex \"%s\" error: %s\n", table,
+		   sql_err);
+	  sqlite3_free (sql_err);
+	  sqlite3_free (table);
+	  return RL2_ERROR;
+      }
+
+/* unregistering the geometry column */
+    sql = sqlite3_mprintf ("SELECT DiscardGeometryColumn("
+			   "%Q, 'geometry')", table);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "DiscardGeometryColumn \"%s\" error: %s\n", table,
+		   sql_err);
+	  sqlite3_free (sql_err);
+	  sqlite3_free (table);
+	  return RL2_ERROR;
+      }
+    sqlite3_free (table);
+
+/* dropping the spatial index */
+    table = sqlite3_mprintf ("idx_%s_generalized_geometry", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sql = sqlite3_mprintf ("DROP TABLE IF EXISTS main.\"%s\"", xtable);
+    free (xtable);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "DROP TABLE \"%s\" error: %s\n", table, sql_err);
+	  sqlite3_free (sql_err);
+	  sqlite3_free (table);
+	  return RL2_ERROR;
+      }
+    sqlite3_free (table);
+
+/* dropping the generalization table */
+    xtable = gen_table_name (coverage);
+    sql = sqlite3_mprintf ("DROP TABLE main.\"%s\"", xtable);
+    free (xtable);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "DROP TABLE \"%s_generalized\" error: %s\n",
+		   coverage, sql_err);
+	  sqlite3_free (sql_err);
+	  return RL2_ERROR;
+      }
+    return RL2_OK;
+}
+
+static int
+create_gen_table (sqlite3 * handle, const char *coverage, int srid)
+{
+/* creating the generalization table and its Spatial Index */
+    int ret;
+    char *sql;
+    char *sql_err = NULL;
+    char *table;
+    char *xtable;
+    char *xindex;
+
+    xtable = gen_table_name (coverage);
+    sql = sqlite3_mprintf ("CREATE TABLE main.\"%s\" ("
+			   "id INTEGER PRIMARY KEY AUTOINCREMENT,\n"
+			   "band INTEGER NOT NULL,\n"
+			   "feature_id INTEGER NOT NULL)", xtable);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CREATE TABLE \"%s_generalized\" error: %s\n",
+		   coverage, sql_err);
+	  sqlite3_free (sql_err);
+	  free (xtable);
+	  return 0;
+      }
+
+/* creating the index by Feature and Band */
+    table = sqlite3_mprintf ("idx_%s_gen_feature", coverage);
+    xindex = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql =
+	sqlite3_mprintf
+	("CREATE UNIQUE INDEX main.\"%s\" ON \"%s\" (feature_id, band)",
+	 xindex, xtable);
+    free (xindex);
+    free (xtable);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CREATE INDEX \"idx_%s_gen_feature\" error: %s\n",
+		   coverage, sql_err);
+	  sqlite3_free (sql_err);
+	  return 0;
+      }
+
+/* creating the generalized geometry */
+    table = sqlite3_mprintf ("%s_generalized", coverage);
+    sql = sqlite3_mprintf ("SELECT AddGeometryColumn("
+			   "%Q, 'geometry', %d, 'GEOMETRY', 'XY')", table,
+			   srid);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "AddGeometryColumn \"%s\" error: %s\n", table,
+		   sql_err);
+	  sqlite3_free (sql_err);
+	  sqlite3_free (table);
+	  return 0;
+      }
+
+/* creating the spatial index */
+    sql = sqlite3_mprintf ("SELECT CreateSpatialIndex("
+			   "%Q, 'geometry')", table);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CreateSpatialIndex \"%s\" error: %s\n", table,
+		   sql_err);
+	  sqlite3_free (sql_err);
+	  sqlite3_free (table);
+	  return 0;
+      }
+    sqlite3_free (table);
+    return 1;
+}
+
+static void
+do_generalize_features (rl2GenWorkerPtr worker)
+{
+/* generalizing a slice of Features for all bands */
+    int i;
+    int k;
+    for (i = 0; i < worker->count; i++)
+      {
+	  rl2GenFeaturePtr feature = worker->features + i;
+	  rl2GeometryPtr geom =
+	      rl2_geometry_from_blob (feature->blob, feature->blob_sz);
+	  if (geom == NULL)
+	      continue;
+	  for (k = 0; k < RL2_VECTOR_GEN_BANDS; k++)
+	    {
+		rl2GeometryPtr simpl =
+		    rl2_simplify_geometry (geom, worker->tolerances[k]);
+		if (simpl == NULL)
+		    continue;	/* collapsed at this band */
+		if (!rl2_geometry_to_blob
+		    (simpl, &(feature->gen_blob[k]),
+		     &(feature->gen_blob_sz[k])))
+		  {
+		      feature->gen_blob[k] = NULL;
+		      feature->gen_blob_sz[k] = 0;
+		  }
+		rl2_destroy_geometry (simpl);
+	    }
+	  rl2_destroy_geometry (geom);
+      }
+}
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+DWORD WINAPI
+doRunGeneralizeThread (void *arg)
+#else
+void *
+doRunGeneralizeThread (void *arg)
+#endif
+{
+/* threaded function: generalizing a slice of Features */
+    rl2GenWorkerPtr worker = (rl2GenWorkerPtr) arg;
+    do_generalize_features (worker);
+#if defined(_WIN32) && !defined(__MINGW32__)
+    return 0;
+#else
+    pthread_exit (NULL);
+    return NULL;
+#endif
+}
+
+static void
+start_generalize_thread (rl2GenWorkerPtr worker)
+{
+/* starting a concurrent thread */
+#if defined(_WIN32) && !defined(__MINGW32__)
+    HANDLE thread_handle;
+    HANDLE *p_thread;
+    DWORD dwThreadId;
+    thread_handle =
+	CreateThread (NULL, 0, doRunGeneralizeThread, worker, 0, &dwThreadId);
+    if (thread_handle == NULL)
+      {
+	  /* failure: generalizing on the main thread */
+	  do_generalize_features (worker);
+	  return;
+      }
+    p_thread = malloc (sizeof (HANDLE));
+    *p_thread = thread_handle;
+    worker->opaque_thread_id = p_thread;
+#else
+    pthread_t thread_id;
+    pthread_t *p_thread;
+    if (pthread_create (&thread_id, NULL, doRunGeneralizeThread, worker) != 0)
+      {
+	  /* failure: generalizing on the main thread */
+	  do_generalize_features (worker);
+	  return;
+      }
+    p_thread = malloc (sizeof (pthread_t));
+    *p_thread = thread_id;
+    worker->opaque_thread_id = p_thread;
+#endif
+}
+
+static void
+join_generalize_thread (rl2GenWorkerPtr worker)
+{
+/* waiting until a concurrent thread exits */
+    if (worker->opaque_thread_id == NULL)
+	return;
+#if defined(_WIN32) && !defined(__MINGW32__)
+    WaitForSingleObject (*((HANDLE *) (worker->opaque_thread_id)), INFINITE);
+    CloseHandle (*((HANDLE *) (worker->opaque_thread_id)));
+#else
+    pthread_join (*((pthread_t *) (worker->opaque_thread_id)), NULL);
+#endif
+    free (worker->opaque_thread_id);
+    worker->opaque_thread_id = NULL;
+}
+
+static void
+reset_gen_features (rl2GenFeaturePtr features, int count)
+{
+/* releasing all BLOBs of a batch of Features */
+    int i;
+    int k;
+    for (i = 0; i < count; i++)
+      {
+	  rl2GenFeaturePtr feature = features + i;
+	  if (feature->blob != NULL)
+	      free (feature->blob);
+	  feature->blob = NULL;
+	  feature->blob_sz = 0;
+	  for (k = 0; k < RL2_VECTOR_GEN_BANDS; k++)
+	    {
+		if (feature->gen_blob[k] != NULL)
+		    free (feature->gen_blob[k]);
+		feature->gen_blob[k] = NULL;
+		feature->gen_blob_sz[k] = 0;
+	    }
+      }
+}
+
+static int
+do_generalize_batch (sqlite3_stmt * stmt_ins, rl2GenFeaturePtr features,
+		     int count, rl2GenWorkerPtr workers, int max_threads,
+		     const double *tolerances)
+{
+/* generalizing (possibly in parallel) and then storing a batch of Features */
+    int n_workers = 0;
+    int first = 0;
+    int i;
+    int k;
+    int ret;
+
+    while (first < count)
+      {
+	  /* splitting the batch into slices */
+	  rl2GenWorkerPtr worker = workers + n_workers;
+	  int n = (count + max_threads - 1) / max_threads;
+	  if (first + n > count)
+	      n = count - first;
+	  worker->opaque_thread_id = NULL;
+	  worker->features = features + first;
+	  worker->count = n;
+	  worker->tolerances = tolerances;
+	  first += n;
+	  n_workers++;
+      }
+    if (n_workers > 1)
+      {
+	  for (i = 0; i < n_workers; i++)
+	      start_generalize_thread (workers + i);
+	  for (i = 0; i < n_workers; i++)
+	      join_generalize_thread (workers + i);
+      }
+    else if (n_workers == 1)
+	do_generalize_features (workers);
+
+    for (i = 0; i < count; i++)
+      {
+	  /* inserting all generalized Geometries */
+	  rl2GenFeaturePtr feature = features + i;
+	  for (k = 0; k < RL2_VECTOR_GEN_BANDS; k++)
+	    {
+		if (feature->gen_blob[k] == NULL)
+		    continue;
+		sqlite3_reset (stmt_ins);
+		sqlite3_clear_bindings (stmt_ins);
+		sqlite3_bind_int (stmt_ins, 1, k);
+		sqlite3_bind_int64 (stmt_ins, 2, feature->feature_id);
+		sqlite3_bind_blob (stmt_ins, 3, feature->gen_blob[k],
+				   feature->gen_blob_sz[k], SQLITE_STATIC);
+		ret = sqlite3_step (stmt_ins);
+		if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+		    ;
+		else
+		  {
+		      fprintf (stderr,
+			       "INSERT INTO generalized; sqlite3_step() error: %s\n",
+			       sqlite3_errmsg (sqlite3_db_handle (stmt_ins)));
+		      return 0;
+		  }
+	    }
+      }
+    return 1;
+}
+
+RL2_PRIVATE int
+rl2_build_vector_generalization (sqlite3 * handle, const void *priv_data,
+				 const char *coverage)
+{
+/* (re)building the generalization store of some Vector Coverage */
+    struct rl2_private_data *priv = (struct rl2_private_data *) priv_data;
+    rl2VectorMultiLayerPtr multi = NULL;
+    rl2PrivVectorMultiLayerPtr mlyr;
+    rl2PrivVectorLayerPtr lyr;
+    rl2GenFeaturePtr features = NULL;
+    rl2GenWorkerPtr workers = NULL;
+    sqlite3_stmt *stmt_in = NULL;
+    sqlite3_stmt *stmt_ins = NULL;
+    double tolerances[RL2_VECTOR_GEN_BANDS];
+    double unit_scale;
+    int max_threads = 1;
+    int max_features;
+    int count = 0;
+    int i;
+    int k;
+    int ret;
+    char *sql;
+    char *xtable;
+    char *xgeom;
+    char *rowid;
+
+    multi = rl2_create_vector_layer_from_dbms (handle, NULL, coverage);
+    if (multi == NULL)
+	goto error;
+    mlyr = (rl2PrivVectorMultiLayerPtr) multi;
+    if (mlyr->is_topogeo || mlyr->is_toponet || mlyr->count != 1)
+      {
+	  /* Topology based Coverages are not supported */
+	  goto error;
+      }
+    lyr = *(mlyr->layers + 0);
+    if (lyr == NULL)
+	goto error;
+
+/* computing the tolerance (half pixel, in map units) for each band */
+    unit_scale = rl2_standard_scale (handle, lyr->srid, 1, 1, 1.0, 1.0);
+    if (unit_scale <= 0.0)
+	goto error;
+    for (k = 0; k < RL2_VECTOR_GEN_BANDS; k++)
+	tolerances[k] = 0.5 * rl2_gen_band_scales[k] / unit_scale;
+
+/* (re)creating the generalization table */
+    if (rl2_drop_vector_generalization (handle, coverage) != RL2_OK)
+	goto error;
+    if (!create_gen_table (handle, coverage, lyr->srid))
+	goto error;
+
+/* preparing the SQL statements */
+    if (lyr->view_name != NULL)
+      {
+	  char *xrowid = rl2_double_quoted_sql (lyr->view_rowid);
+	  rowid = sqlite3_mprintf ("\"%s\"", xrowid);
+	  free (xrowid);
+	  xtable = rl2_double_quoted_sql (lyr->view_name);
+	  xgeom = rl2_double_quoted_sql (lyr->view_geometry);
+      }
+    else
+      {
+	  rowid = sqlite3_mprintf ("ROWID");
+	  xtable = rl2_double_quoted_sql (lyr->f_table_name);
+	  xgeom = rl2_double_quoted_sql (lyr->f_geometry_column);
+      }
+    sql =
+	sqlite3_mprintf ("SELECT %s, \"%s\" FROM main.\"%s\" "
+			 "WHERE \"%s\" IS NOT NULL", rowid, xgeom, xtable,
+			 xgeom);
+    sqlite3_free (rowid);
+    free (xtable);
+    free (xgeom);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt_in, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "SELECT features SQL error: %s\n",
+		   sqlite3_errmsg (handle));
+	  goto error;
+      }
+    xtable = gen_table_name (coverage);
+    sql =
+	sqlite3_mprintf
+	("INSERT INTO main.\"%s\" (id, band, feature_id, geometry) "
+	 "VALUES (NULL, ?, ?, ?)", xtable);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt_ins, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "INSERT INTO generalized SQL error: %s\n",
+		   sqlite3_errmsg (handle));
+	  goto error;
+      }
+
+/* allocating the batch of Features */
+    if (priv != NULL)
+	max_threads = priv->max_threads;
+    if (max_threads < 1)
+	max_threads = 1;
+    if (max_threads > 64)
+	max_threads = 64;
+    max_features = max_threads * RL2_GEN_FEATURES_PER_THREAD;
+    features = calloc (max_features, sizeof (rl2GenFeature));
+    workers = malloc (sizeof (rl2GenWorker) * max_threads);
+    if (features == NULL || workers == NULL)
+	goto error;
+
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt_in);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	    {
+		fprintf (stderr, "SELECT features; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (handle));
+		goto error;
+	    }
+	  if (sqlite3_column_type (stmt_in, 1) == SQLITE_BLOB)
+	    {
+		rl2GenFeaturePtr feature = features + count;
+		const unsigned char *blob = sqlite3_column_blob (stmt_in, 1);
+		int blob_sz = sqlite3_column_bytes (stmt_in, 1);
+		feature->feature_id = sqlite3_column_int64 (stmt_in, 0);
+		feature->blob = malloc (blob_sz);
+		if (feature->blob == NULL)
+		    goto error;
+		memcpy (feature->blob, blob, blob_sz);
+		feature->blob_sz = blob_sz;
+		count++;
+	    }
+	  if (count == max_features)
+	    {
+		/* processing a full batch */
+		if (!do_generalize_batch
+		    (stmt_ins, features, count, workers, max_threads,
+		     tolerances))
+		    goto error;
+		reset_gen_features (features, count);
+		count = 0;
+	    }
+      }
+    if (count > 0)
+      {
+	  /* processing the last batch */
+	  if (!do_generalize_batch
+	      (stmt_ins, features, count, workers, max_threads, tolerances))
+	      goto error;
+	  reset_gen_features (features, count);
+	  count = 0;
+      }
+
+    sqlite3_finalize (stmt_in);
+    stmt_in = NULL;
+    sqlite3_finalize (stmt_ins);
+    stmt_ins = NULL;
+
+/* keeping the store in sync from now on */
+    if (!create_gen_triggers
+	(handle, coverage, lyr->f_table_name, lyr->f_geometry_column))
+	goto error;
+
+    free (features);
+    free (workers);
+    rl2_destroy_multi_layer (multi);
+    return RL2_OK;
+
+  error:
+    if (stmt_in != NULL)
+	sqlite3_finalize (stmt_in);
+    if (stmt_ins != NULL)
+	sqlite3_finalize (stmt_ins);
+    if (features != NULL)
+      {
+	  reset_gen_features (features, count);
+	  free (features);
+      }
+    if (workers != NULL)
+	free (workers);
+    if (multi != NULL)
+	rl2_destroy_multi_layer (multi);
+    return RL2_ERROR;
+}
@@ -88,6 +88,8 @@ destroyAuxImporterTile (rl2AuxImporterTilePtr tile)
 	free (tile->blob_odd);
     if (tile->blob_even != NULL)
 	free (tile->blob_even);
+    if (tile->stats != NULL)
+	rl2_destroy_raster_statistics (tile->stats);
     free (tile);
 }
 
@@ -116,6 +118,7 @@ addTile2AuxImporter (rl2AuxImporterPtr aux, unsigned int row,
     tile->opaque_thread_id = NULL;
     tile->mother = aux;
     tile->raster = NULL;
+    tile->stats = NULL;
     tile->row = row;
     tile->col = col;
     tile->minx = minx;
@@ -145,7 +148,8 @@ createAuxImporter (rl2PrivCoveragePtr coverage, int srid, double maxx,
 		   double miny, unsigned int tile_w, unsigned int tile_h,
 		   double res_x, double res_y, unsigned char origin_type,
 		   const void *origin, unsigned char forced_conversion,
-		   int verbose, unsigned char compression, int quality)
+		   int verbose, unsigned char compression, int quality,
+		   int sparse)
 {
 /* creating an AuxImporter container */
     rl2AuxImporterPtr aux = malloc (sizeof (rl2AuxImporter));
@@ -163,6 +167,8 @@ createAuxImporter (rl2PrivCoveragePtr coverage, int srid, double maxx,
     aux->verbose = verbose;
     aux->compression = compression;
     aux->quality = quality;
+    aux->sparse = sparse;
+    aux->perf = rl2_perf_get_thread_counters ();
     aux->first = NULL;
     aux->last = NULL;
     return aux;
@@ -186,6 +192,232 @@ destroyAuxImporter (rl2AuxImporterPtr aux)
     free (aux);
 }
 
+static rl2AuxImportFilePtr
+createAuxImportFile (const char *src_path, rl2PrivCoveragePtr coverage,
+		     int worldfile, int force_srid, unsigned char sample_type,
+		     unsigned char pixel_type, unsigned char num_bands,
+		     unsigned int tile_w, unsigned int tile_h,
+		     unsigned char compression, int quality, int sparse,
+		     unsigned char checksum_algorithm, int verbose)
+{
+/* creating an AuxImportFile container */
+    rl2AuxImportFilePtr file = malloc (sizeof (rl2AuxImportFile));
+    if (file == NULL)
+	return NULL;
+    file->opaque_thread_id = NULL;
+    file->src_path = sqlite3_mprintf ("%s", src_path);
+    file->coverage = coverage;
+    file->worldfile = worldfile;
+    file->force_srid = force_srid;
+    file->sample_type = sample_type;
+    file->pixel_type = pixel_type;
+    file->num_bands = num_bands;
+    file->tile_w = tile_w;
+    file->tile_h = tile_h;
+    file->compression = compression;
+    file->quality = quality;
+    file->sparse = sparse;
+    file->checksum_algorithm = checksum_algorithm;
+    file->verbose = verbose;
+    file->sequential = 0;
+    file->origin_type = RL2_ORIGIN_TIFF;
+    file->origin = NULL;
+    file->orig_srid = -1;
+    file->srid = -1;
+    file->width = 0;
+    file->height = 0;
+    file->minx = 0.0;
+    file->miny = 0.0;
+    file->maxx = 0.0;
+    file->maxy = 0.0;
+    file->res_x = 0.0;
+    file->res_y = 0.0;
+    file->xml_summary = NULL;
+    file->md5 = NULL;
+    file->aux = NULL;
+    file->error_message = NULL;
+    file->start = 0;
+    file->perf = rl2_perf_get_thread_counters ();
+    file->retcode = RL2_ERROR;
+    return file;
+}
+
+static void
+destroyAuxImportFile (rl2AuxImportFilePtr file)
+{
+/* destroying an AuxImportFile container */
+    if (file == NULL)
+	return;
+    if (file->opaque_thread_id != NULL)
+	free (file->opaque_thread_id);
+    if (file->src_path != NULL)
+	sqlite3_free (file->src_path);
+    if (file->aux != NULL)
+	destroyAuxImporter (file->aux);
+    if (file->origin != NULL)
+	rl2_destroy_tiff_origin ((rl2TiffOriginPtr) (file->origin));
+    if (file->xml_summary != NULL)
+	free (file->xml_summary);
+    if (file->md5 != NULL)
+	free (file->md5);
+    if (file->error_message != NULL)
+	sqlite3_free (file->error_message);
+    free (file);
+}
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+DWORD WINAPI
+doRunFileChecksumThread (void *arg)
+#else
+void *
+doRunFileChecksumThread (void *arg)
+#endif
+{
+/* threaded function: computing the checksum of a whole Source file */
+    rl2AuxFileChecksumPtr sum = (rl2AuxFileChecksumPtr) arg;
+    sum->checksum = rl2_compute_file_checksum (sum->src_path, sum->algorithm);
+#if defined(_WIN32) && !defined(__MINGW32__)
+    return 0;
+#else
+    pthread_exit (NULL);
+    return NULL;
+#endif
+}
+
+static rl2AuxFileChecksumPtr
+start_file_checksum (const char *src_path, unsigned char algorithm)
+{
+/*
+/ starting to compute the Section checksum on behalf of a concurrent
+/ thread, so to overlap hashing and decoding/encoding of the same file;
+/ should the thread fail to start the checksum will be computed later
+/ by finish_file_checksum()
+*/
+    rl2AuxFileChecksumPtr sum = malloc (sizeof (rl2AuxFileChecksum));
+    if (sum == NULL)
+	return NULL;
+    sum->opaque_thread_id = NULL;
+    sum->src_path = sqlite3_mprintf ("%s", src_path);
+    sum->algorithm = algorithm;
+    sum->checksum = NULL;
+    {
+#if defined(_WIN32) && !defined(__MINGW32__)
+	HANDLE thread_handle;
+	HANDLE *p_thread;
+	DWORD dwThreadId;
+	thread_handle =
+	    CreateThread (NULL, 0, doRunFileChecksumThread, sum, 0,
+			  &dwThreadId);
+	if (thread_handle == NULL)
+	    return sum;
+	p_thread = malloc (sizeof (HANDLE));
+	*p_thread = thread_handle;
+	sum->opaque_thread_id = p_thread;
+#else
+	pthread_t thread_id;
+	pthread_t *p_thread;
+	if (pthread_create (&thread_id, NULL, doRunFileChecksumThread, sum) !=
+	    0)
+	    return sum;
+	p_thread = malloc (sizeof (pthread_t));
+	*p_thread = thread_id;
+	sum->opaque_thread_id = p_thread;
+#endif
+    }
+    return sum;
+}
+
+static char *
+finish_file_checksum (rl2AuxFileChecksumPtr sum)
+{
+/* waiting for the Section checksum; the object will be destroyed */
+    char *checksum;
+    if (sum == NULL)
+	return NULL;
+    if (sum->opaque_thread_id != NULL)
+      {
+#if defined(_WIN32) && !defined(__MINGW32__)
+	  WaitForSingleObject (*((HANDLE *) (sum->opaque_thread_id)),
+			       INFINITE);
+	  CloseHandle (*((HANDLE *) (sum->opaque_thread_id)));
+#else
+	  pthread_join (*((pthread_t *) (sum->opaque_thread_id)), NULL);
+#endif
+	  free (sum->opaque_thread_id);
+      }
+    else
+	sum->checksum =
+	    rl2_compute_file_checksum (sum->src_path, sum->algorithm);
+    checksum = sum->checksum;
+    sqlite3_free (sum->src_path);
+    free (sum);
+    return checksum;
+}
+
+static void
+cancel_file_checksum (rl2AuxFileChecksumPtr sum)
+{
+/* discarding a Section checksum (error recovery) */
+    char *checksum;
+    if (sum == NULL)
+	return;
+    if (sum->opaque_thread_id == NULL)
+      {
+	  /* nothing is running: no reason to compute it at all */
+	  sqlite3_free (sum->src_path);
+	  free (sum);
+	  return;
+      }
+    checksum = finish_file_checksum (sum);
+    if (checksum != NULL)
+	free (checksum);
+}
+
+static int
+do_update_section_checksum (sqlite3 * handle, const char *coverage,
+			    sqlite3_int64 section_id,
+			    rl2AuxFileChecksumPtr sum)
+{
+/* UPDATing the Section checksum once it has been computed */
+    int ret;
+    char *sql;
+    char *table;
+    char *xtable;
+    char *checksum;
+    sqlite3_stmt *stmt = NULL;
+
+    if (sum == NULL)
+	return 1;
+    checksum = finish_file_checksum (sum);
+    if (checksum == NULL)
+	return 1;
+    table = sqlite3_mprintf ("%s_sections", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql =
+	sqlite3_mprintf
+	("UPDATE main.\"%s\" SET md5_checksum = ? WHERE section_id = ?",
+	 xtable);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "SQL error: %s\n", sqlite3_errmsg (handle));
+	  free (checksum);
+	  return 0;
+      }
+    sqlite3_bind_text (stmt, 1, checksum, strlen (checksum), free);
+    sqlite3_bind_int64 (stmt, 2, section_id);
+    ret = sqlite3_step (stmt);
+    sqlite3_finalize (stmt);
+    if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+	return 1;
+    fprintf (stderr, "UPDATE sections checksum; sqlite3_step() error: %s\n",
+	     sqlite3_errmsg (handle));
+    return 0;
+}
+
 static char *
 formatFloat (double value)
 {
@@ -242,24 +474,19 @@ formatLat (double value)
 }
 
 static int
-do_insert_tile (sqlite3 * handle, unsigned char *blob_odd, int blob_odd_sz,
-		unsigned char *blob_even, int blob_even_sz,
-		sqlite3_int64 section_id, int srid, double tile_minx,
-		double tile_miny, double tile_maxx, double tile_maxy,
-		rl2PalettePtr aux_palette, rl2PixelPtr no_data,
-		sqlite3_stmt * stmt_tils, sqlite3_stmt * stmt_data,
-		rl2RasterStatisticsPtr section_stats)
+do_store_tile (sqlite3 * handle, unsigned char *blob_odd, int blob_odd_sz,
+	       unsigned char *blob_even, int blob_even_sz,
+	       sqlite3_int64 section_id, int srid, double tile_minx,
+	       double tile_miny, double tile_maxx, double tile_maxy,
+	       sqlite3_stmt * stmt_tils, sqlite3_stmt * stmt_data)
 {
-/* INSERTing the tile */
+/* INSERTing the tile - statistics already aggregated */
     int ret;
     sqlite3_int64 tile_id;
-    rl2RasterStatisticsPtr stats = NULL;
+    int blob_sz = blob_odd_sz + blob_even_sz;
+    double t0;
 
-    stats = rl2_get_raster_statistics
-	(blob_odd, blob_odd_sz, blob_even, blob_even_sz, aux_palette, no_data);
-    if (stats == NULL)
-	goto error;
-    rl2_aggregate_raster_statistics (stats, section_stats);
+    t0 = rl2_perf_clock ();
     sqlite3_reset (stmt_tils);
     sqlite3_clear_bindings (stmt_tils);
     sqlite3_bind_int64 (stmt_tils, 1, section_id);
@@ -276,7 +503,7 @@ do_insert_tile (sqlite3 * handle, unsigned char *blob_odd, int blob_odd_sz,
 	  fprintf (stderr,
 		   "INSERT INTO tiles; sqlite3_step() error: %s\n",
 		   sqlite3_errmsg (handle));
-	  goto error;
+	  return 0;
       }
     tile_id = sqlite3_last_insert_rowid (handle);
     /* INSERTing tile data */
@@ -295,8 +522,40 @@ do_insert_tile (sqlite3 * handle, unsigned char *blob_odd, int blob_odd_sz,
       {
 	  fprintf (stderr, "INSERT INTO tile_data; sqlite3_step() error: %s\n",
 		   sqlite3_errmsg (handle));
-	  goto error;
+	  return 0;
       }
+    rl2_perf_add (RL2_PERF_TILE_INSERT, t0, blob_sz);
+    return 1;
+}
+
+static int
+do_insert_tile (sqlite3 * handle, unsigned char *blob_odd, int blob_odd_sz,
+		unsigned char *blob_even, int blob_even_sz,
+		sqlite3_int64 section_id, int srid, double tile_minx,
+		double tile_miny, double tile_maxx, double tile_maxy,
+		rl2PalettePtr aux_palette, rl2PixelPtr no_data,
+		sqlite3_stmt * stmt_tils, sqlite3_stmt * stmt_data,
+		rl2RasterStatisticsPtr section_stats, rl2CoveragePtr cvg)
+{
+/* INSERTing the tile */
+    rl2RasterStatisticsPtr stats = NULL;
+
+    if (blob_odd == NULL)
+      {
+	  /* empty sparse tile: intentionally not stored */
+	  return 1;
+      }
+    stats = rl2_get_raster_statistics_dict
+	(blob_odd, blob_odd_sz, blob_even, blob_even_sz, aux_palette, no_data,
+	 cvg);
+    if (stats == NULL)
+	goto error;
+    rl2_aggregate_raster_statistics (stats, section_stats);
+    if (!do_store_tile
+	(handle, blob_odd, blob_odd_sz, blob_even, blob_even_sz, section_id,
+	 srid, tile_minx, tile_miny, tile_maxx, tile_maxy, stmt_tils,
+	 stmt_data))
+	goto error;
     rl2_destroy_raster_statistics (stats);
     return 1;
   error:
@@ -395,6 +654,7 @@ do_encode_tile (rl2AuxImporterTilePtr tile)
 {
 /* servicising an AuxImporter Tile request */
     rl2AuxImporterPtr aux;
+    int ret;
     if (tile == NULL)
 	goto error;
 
@@ -406,10 +666,21 @@ do_encode_tile (rl2AuxImporterTilePtr tile)
 		   tile->row, tile->col);
 	  goto error;
       }
-    if (rl2_raster_encode
-	(tile->raster, aux->compression, &(tile->blob_odd),
-	 &(tile->blob_odd_sz), &(tile->blob_even), &(tile->blob_even_sz),
-	 aux->quality, 1) != RL2_OK)
+    if (aux->sparse)
+	ret =
+	    rl2_raster_encode_sparse (tile->raster, aux->compression,
+				      &(tile->blob_odd), &(tile->blob_odd_sz),
+				      &(tile->blob_even),
+				      &(tile->blob_even_sz), aux->quality, 1,
+				      (rl2CoveragePtr) (aux->coverage));
+    else
+	ret =
+	    rl2_raster_encode_dict (tile->raster, aux->compression,
+				    &(tile->blob_odd), &(tile->blob_odd_sz),
+				    &(tile->blob_even), &(tile->blob_even_sz),
+				    aux->quality, 1,
+				    (rl2CoveragePtr) (aux->coverage));
+    if (ret != RL2_OK)
       {
 	  fprintf (stderr,
 		   "ERROR: unable to encode a tile [Row=%d Col=%d]\n",
@@ -434,6 +705,7 @@ doRunImportThread (void *arg)
 {
 /* threaded function: preparing a compressed Tile to be imported */
     rl2AuxImporterTilePtr aux_tile = (rl2AuxImporterTilePtr) arg;
+    rl2_perf_set_thread_counters (aux_tile->mother->perf);
     do_encode_tile (aux_tile);
 #if defined(_WIN32) && !defined(__MINGW32__)
     return 0;
@@ -541,10 +813,16 @@ do_import_ascii_grid (sqlite3 * handle, const void *priv_data,
     rl2AuxImporterTilePtr *thread_slots = NULL;
     int thread_count;
     int max_threads;
+    rl2AuxFileChecksumPtr checksum = NULL;
 
     if (cache == NULL)
 	goto error;
     max_threads = cache->max_threads;
+    if (coverage->sectionMD5)
+      {
+	  /* hashing the Source file in parallel while decoding it */
+	  checksum = start_file_checksum (src_path, cache->section_checksum);
+      }
 
     time (&start);
     if (rl2_get_coverage_resolution (cvg, &base_res_x, &base_res_y) != RL2_OK)
@@ -655,9 +933,9 @@ do_import_ascii_grid (sqlite3 * handle, const void *priv_data,
     no_data = rl2_get_coverage_no_data (cvg);
 
 /* INSERTing the section */
-    if (!rl2_do_insert_section
+    if (!rl2_do_insert_section_md5
 	(handle, src_path, section, srid, width, height, minx, miny, maxx,
-	 maxy, xml_summary, coverage->sectionPaths, coverage->sectionMD5,
+	 maxy, xml_summary, coverage->sectionPaths, NULL,
 	 coverage->sectionSummary, stmt_sect, &section_id))
 	goto error;
     section_stats = rl2_create_raster_statistics (sample_type, 1);
@@ -683,7 +961,8 @@ do_import_ascii_grid (sqlite3 * handle, const void *priv_data,
     aux =
 	createAuxImporter (coverage, srid, maxx, miny, tile_w, tile_h, res_x,
 			   res_y, RL2_ORIGIN_ASCII_GRID, origin,
-			   RL2_CONVERT_NO, verbose, compression, 100);
+			   RL2_CONVERT_NO, verbose, compression, 100,
+			   cache->sparse_tiles);
     tile_maxy = maxy;
     for (row = 0; row < height; row += tile_h)
       {
@@ -804,7 +1083,7 @@ do_import_ascii_grid (sqlite3 * handle, const void *priv_data,
 		    (handle, pTile->blob_odd, pTile->blob_odd_sz,
 		     pTile->blob_even, pTile->blob_even_sz, section_id, srid,
 		     pTile->minx, pTile->miny, pTile->maxx, pTile->maxy,
-		     NULL, no_data, stmt_tils, stmt_data, section_stats))
+		     NULL, no_data, stmt_tils, stmt_data, section_stats, cvg))
 		  {
 		      pTile->blob_odd = NULL;
 		      pTile->blob_even = NULL;
@@ -826,6 +1105,15 @@ do_import_ascii_grid (sqlite3 * handle, const void *priv_data,
     compute_aggregate_sq_diff (section_stats);
     if (!rl2_do_insert_stats (handle, section_stats, section_id, stmt_upd_sect))
 	goto error;
+/* updating the Section's checksum */
+    if (checksum != NULL)
+      {
+	  rl2AuxFileChecksumPtr pending = checksum;
+	  checksum = NULL;
+	  if (!do_update_section_checksum
+	      (handle, coverage->coverageName, section_id, pending))
+	      goto error;
+      }
 
     rl2_destroy_ascii_grid_origin (origin);
     rl2_destroy_raster_statistics (section_stats);
@@ -856,6 +1144,8 @@ do_import_ascii_grid (sqlite3 * handle, const void *priv_data,
     return 1;
 
   error:
+    if (checksum != NULL)
+	cancel_file_checksum (checksum);
     if (aux != NULL)
 	destroyAuxImporter (aux);
     if (thread_slots != NULL)
@@ -1227,10 +1517,16 @@ do_import_jpeg_image (sqlite3 * handle, const void *priv_data,
     rl2AuxImporterTilePtr *thread_slots = NULL;
     int thread_count;
     int max_threads;
+    rl2AuxFileChecksumPtr checksum = NULL;
 
     if (cache == NULL)
 	goto error;
     max_threads = cache->max_threads;
+    if (coverage->sectionMD5)
+      {
+	  /* hashing the Source file in parallel while decoding it */
+	  checksum = start_file_checksum (src_path, cache->section_checksum);
+      }
 
     if (rl2_get_coverage_resolution (cvg, &base_res_x, &base_res_y) != RL2_OK)
       {
@@ -1355,9 +1651,9 @@ do_import_jpeg_image (sqlite3 * handle, const void *priv_data,
     no_data = rl2_get_coverage_no_data (cvg);
 
 /* INSERTing the section */
-    if (!rl2_do_insert_section
+    if (!rl2_do_insert_section_md5
 	(handle, src_path, section, srid, width, height, minx, miny, maxx,
-	 maxy, xml_summary, coverage->sectionPaths, coverage->sectionMD5,
+	 maxy, xml_summary, coverage->sectionPaths, NULL,
 	 coverage->sectionSummary, stmt_sect, &section_id))
 	goto error;
     section_stats = rl2_create_raster_statistics (sample_type, num_bands);
@@ -1383,7 +1679,7 @@ do_import_jpeg_image (sqlite3 * handle, const void *priv_data,
     aux =
 	createAuxImporter (coverage, srid, maxx, miny, tile_w, tile_h, res_x,
 			   res_y, RL2_ORIGIN_JPEG, rst_in, forced_conversion,
-			   verbose, compression, quality);
+			   verbose, compression, quality, cache->sparse_tiles);
     tile_maxy = maxy;
     for (row = 0; row < height; row += tile_h)
       {
@@ -1503,7 +1799,7 @@ do_import_jpeg_image (sqlite3 * handle, const void *priv_data,
 		    (handle, pTile->blob_odd, pTile->blob_odd_sz,
 		     pTile->blob_even, pTile->blob_even_sz, section_id, srid,
 		     pTile->minx, pTile->miny, pTile->maxx, pTile->maxy,
-		     NULL, no_data, stmt_tils, stmt_data, section_stats))
+		     NULL, no_data, stmt_tils, stmt_data, section_stats, cvg))
 		  {
 		      pTile->blob_odd = NULL;
 		      pTile->blob_even = NULL;
@@ -1525,6 +1821,15 @@ do_import_jpeg_image (sqlite3 * handle, const void *priv_data,
     compute_aggregate_sq_diff (section_stats);
     if (!rl2_do_insert_stats (handle, section_stats, section_id, stmt_upd_sect))
 	goto error;
+/* updating the Section's checksum */
+    if (checksum != NULL)
+      {
+	  rl2AuxFileChecksumPtr pending = checksum;
+	  checksum = NULL;
+	  if (!do_update_section_checksum
+	      (handle, coverage->coverageName, section_id, pending))
+	      goto error;
+      }
 
     rl2_destroy_section (origin);
     rl2_destroy_raster_statistics (section_stats);
@@ -1555,6 +1860,8 @@ do_import_jpeg_image (sqlite3 * handle, const void *priv_data,
     return 1;
 
   error:
+    if (checksum != NULL)
+	cancel_file_checksum (checksum);
     if (aux != NULL)
 	destroyAuxImporter (aux);
     if (thread_slots != NULL)
@@ -1683,10 +1990,16 @@ do_import_jpeg2000_image (sqlite3 * handle, const void *priv_data,
     rl2AuxImporterTilePtr *thread_slots = NULL;
     int thread_count;
     int max_threads;
+    rl2AuxFileChecksumPtr checksum = NULL;
 
     if (cache == NULL)
 	goto error;
     max_threads = cache->max_threads;
+    if (coverage->sectionMD5)
+      {
+	  /* hashing the Source file in parallel while decoding it */
+	  checksum = start_file_checksum (src_path, cache->section_checksum);
+      }
 
     if (rl2_get_coverage_resolution (cvg, &base_res_x, &base_res_y) != RL2_OK)
       {
@@ -1823,9 +2136,9 @@ do_import_jpeg2000_image (sqlite3 * handle, const void *priv_data,
     no_data = rl2_get_coverage_no_data (cvg);
 
 /* INSERTing the section */
-    if (!rl2_do_insert_section
+    if (!rl2_do_insert_section_md5
 	(handle, src_path, section, srid, width, height, minx, miny, maxx,
-	 maxy, xml_summary, coverage->sectionPaths, coverage->sectionMD5,
+	 maxy, xml_summary, coverage->sectionPaths, NULL,
 	 coverage->sectionSummary, stmt_sect, &section_id))
 	goto error;
     section_stats = rl2_create_raster_statistics (sample_type, num_bands);
@@ -1851,7 +2164,8 @@ do_import_jpeg2000_image (sqlite3 * handle, const void *priv_data,
     aux =
 	createAuxImporter (coverage, srid, maxx, miny, tile_w, tile_h, res_x,
 			   res_y, RL2_ORIGIN_JPEG2000, rst_in,
-			   forced_conversion, verbose, compression, quality);
+			   forced_conversion, verbose, compression, quality,
+			   cache->sparse_tiles);
     tile_maxy = maxy;
     for (row = 0; row < height; row += tile_h)
       {
@@ -1971,7 +2285,7 @@ do_import_jpeg2000_image (sqlite3 * handle, const void *priv_data,
 		    (handle, pTile->blob_odd, pTile->blob_odd_sz,
 		     pTile->blob_even, pTile->blob_even_sz, section_id, srid,
 		     pTile->minx, pTile->miny, pTile->maxx, pTile->maxy,
-		     NULL, no_data, stmt_tils, stmt_data, section_stats))
+		     NULL, no_data, stmt_tils, stmt_data, section_stats, cvg))
 		  {
 		      pTile->blob_odd = NULL;
 		      pTile->blob_even = NULL;
@@ -1993,6 +2307,15 @@ do_import_jpeg2000_image (sqlite3 * handle, const void *priv_data,
     compute_aggregate_sq_diff (section_stats);
     if (!rl2_do_insert_stats (handle, section_stats, section_id, stmt_upd_sect))
 	goto error;
+/* updating the Section's checksum */
+    if (checksum != NULL)
+      {
+	  rl2AuxFileChecksumPtr pending = checksum;
+	  checksum = NULL;
+	  if (!do_update_section_checksum
+	      (handle, coverage->coverageName, section_id, pending))
+	      goto error;
+      }
 
     rl2_destroy_section (origin);
     rl2_destroy_raster_statistics (section_stats);
@@ -2023,6 +2346,8 @@ do_import_jpeg2000_image (sqlite3 * handle, const void *priv_data,
     return 1;
 
   error:
+    if (checksum != NULL)
+	cancel_file_checksum (checksum);
     if (aux != NULL)
 	destroyAuxImporter (aux);
     if (thread_slots != NULL)
@@ -2132,6 +2457,7 @@ do_import_file (sqlite3 * handle, const void *priv_data, const char *src_path,
     rl2AuxImporterTilePtr *thread_slots = NULL;
     int thread_count;
     int max_threads;
+    rl2AuxFileChecksumPtr checksum = NULL;
 
     if (cache == NULL)
 	goto error;
@@ -2164,6 +2490,11 @@ do_import_file (sqlite3 * handle, const void *priv_data, const char *src_path,
 					 total);
 #endif /* end OpenJpeg conditonal */
 
+    if (coverage->sectionMD5)
+      {
+	  /* hashing the Source file in parallel while decoding it */
+	  checksum = start_file_checksum (src_path, cache->section_checksum);
+      }
     time (&start);
     if (rl2_get_coverage_resolution (cvg, &base_res_x, &base_res_y) != RL2_OK)
       {
@@ -2314,9 +2645,9 @@ do_import_file (sqlite3 * handle, const void *priv_data, const char *src_path,
     no_data = rl2_get_coverage_no_data (cvg);
 
 /* INSERTing the section */
-    if (!rl2_do_insert_section
+    if (!rl2_do_insert_section_md5
 	(handle, src_path, section, srid, width, height, minx, miny, maxx,
-	 maxy, xml_summary, coverage->sectionPaths, coverage->sectionMD5,
+	 maxy, xml_summary, coverage->sectionPaths, NULL,
 	 coverage->sectionSummary, stmt_sect, &section_id))
 	goto error;
     section_stats = rl2_create_raster_statistics (sample_type, num_bands);
@@ -2342,7 +2673,7 @@ do_import_file (sqlite3 * handle, const void *priv_data, const char *src_path,
     aux =
 	createAuxImporter (coverage, srid, maxx, miny, tile_w, tile_h, res_x,
 			   res_y, RL2_ORIGIN_TIFF, origin, RL2_CONVERT_NO,
-			   verbose, compression, quality);
+			   verbose, compression, quality, cache->sparse_tiles);
     tile_maxy = maxy;
     for (row = 0; row < height; row += tile_h)
       {
@@ -2464,7 +2795,8 @@ do_import_file (sqlite3 * handle, const void *priv_data, const char *src_path,
 		    (handle, pTile->blob_odd, pTile->blob_odd_sz,
 		     pTile->blob_even, pTile->blob_even_sz, section_id, srid,
 		     pTile->minx, pTile->miny, pTile->maxx, pTile->maxy,
-		     aux_palette, no_data, stmt_tils, stmt_data, section_stats))
+		     aux_palette, no_data, stmt_tils, stmt_data, section_stats,
+		     cvg))
 		  {
 		      pTile->blob_odd = NULL;
 		      pTile->blob_even = NULL;
@@ -2486,6 +2818,15 @@ do_import_file (sqlite3 * handle, const void *priv_data, const char *src_path,
     compute_aggregate_sq_diff (section_stats);
     if (!rl2_do_insert_stats (handle, section_stats, section_id, stmt_upd_sect))
 	goto error;
+/* updating the Section's checksum */
+    if (checksum != NULL)
+      {
+	  rl2AuxFileChecksumPtr pending = checksum;
+	  checksum = NULL;
+	  if (!do_update_section_checksum
+	      (handle, coverage->coverageName, section_id, pending))
+	      goto error;
+      }
 
     rl2_destroy_tiff_origin (origin);
     rl2_destroy_raster_statistics (section_stats);
@@ -2516,6 +2857,8 @@ do_import_file (sqlite3 * handle, const void *priv_data, const char *src_path,
     return 1;
 
   error:
+    if (checksum != NULL)
+	cancel_file_checksum (checksum);
     if (aux != NULL)
 	destroyAuxImporter (aux);
     if (thread_slots != NULL)
@@ -2569,6 +2912,580 @@ check_extension_match (const char *file_name, const char *file_ext)
     return 0;
 }
 
+#define RL2_MT_IMPORT_MAX_PIXELS	(4096 * 4096)
+
+static int
+is_sequential_import (const char *path)
+{
+/* testing for a Source file always requiring a sequential import */
+    if (is_ascii_grid (path))
+	return 1;
+    if (is_jpeg_image (path))
+	return 1;
+#ifndef OMIT_OPENJPEG		/* only if OpenJpeg is enabled */
+    if (is_jpeg2000_image (path))
+	return 1;
+#endif /* end OpenJpeg conditional */
+    return 0;
+}
+
+static int
+check_import_file_resolution (rl2AuxImportFilePtr file)
+{
+/* checking the TIFF resolution against the Coverage */
+    rl2PrivCoveragePtr coverage = file->coverage;
+    double confidence;
+    if (coverage->mixedResolutions)
+      {
+	  /* accepting any resolution */
+      }
+    else if (coverage->strictResolution)
+      {
+	  /* enforcing Strict Resolution check */
+	  double x_diff = fabs (coverage->hResolution - file->res_x);
+	  double y_diff = fabs (coverage->vResolution - file->res_y);
+	  double x_lim = coverage->hResolution / 1000000.0;
+	  double y_lim = coverage->vResolution / 1000000.0;
+	  if (x_diff > x_lim)
+	    {
+		if (file->verbose)
+		    file->error_message =
+			sqlite3_mprintf
+			("Mismatching Horizontal Resolution (Strict) !!!");
+		return 0;
+	    }
+	  if (y_diff > y_lim)
+	    {
+		if (file->verbose)
+		    file->error_message =
+			sqlite3_mprintf
+			("Mismatching Vertical Resolution (Strict) !!!");
+		return 0;
+	    }
+      }
+    else
+      {
+	  /* permissive Resolution check */
+	  confidence = coverage->hResolution / 100.0;
+	  if (file->res_x < (coverage->hResolution - confidence)
+	      || file->res_x > (coverage->hResolution + confidence))
+	    {
+		if (file->verbose)
+		    file->error_message =
+			sqlite3_mprintf
+			("Mismatching Horizontal Resolution (Permissive) !!!");
+		return 0;
+	    }
+	  confidence = coverage->vResolution / 100.0;
+	  if (file->res_y < (coverage->vResolution - confidence)
+	      || file->res_y > (coverage->vResolution + confidence))
+	    {
+		if (file->verbose)
+		    file->error_message =
+			sqlite3_mprintf
+			("Mismatching Vertical Resolution !(Permissive) !!");
+		return 0;
+	    }
+      }
+    return 1;
+}
+
+static void
+do_prepare_import_file (rl2AuxImportFilePtr file)
+{
+/*
+/ preparing a whole TIFF Source file to be imported:
+/ opening the origin, checking it against the Coverage and
+/ then encoding all tiles; no DBMS access at all
+*/
+    rl2CoveragePtr cvg = (rl2CoveragePtr) (file->coverage);
+    rl2TiffOriginPtr origin;
+    rl2AuxImporterTilePtr tile;
+    rl2PixelPtr no_data;
+    unsigned int row;
+    unsigned int col;
+    double tile_minx;
+    double tile_maxy;
+    int xsrid;
+    rl2AuxFileChecksumPtr checksum = NULL;
+
+    time (&(file->start));
+    if (file->coverage->sectionMD5)
+      {
+	  /* hashing the Source file in parallel while decoding it */
+	  checksum =
+	      start_file_checksum (file->src_path, file->checksum_algorithm);
+      }
+    if (file->worldfile)
+	origin =
+	    rl2_create_tiff_origin (file->src_path, RL2_TIFF_WORLDFILE,
+				    file->force_srid, file->sample_type,
+				    file->pixel_type, file->num_bands);
+    else
+	origin =
+	    rl2_create_tiff_origin (file->src_path, RL2_TIFF_GEOTIFF,
+				    file->force_srid, file->sample_type,
+				    file->pixel_type, file->num_bands);
+    if (origin == NULL)
+      {
+	  if (file->verbose)
+	      file->error_message =
+		  sqlite3_mprintf ("Invalid TIFF Origin: %s", file->src_path);
+	  goto error;
+      }
+    file->origin = origin;
+    if (rl2_get_coverage_srid (cvg, &xsrid) == RL2_OK)
+      {
+	  if (xsrid == RL2_GEOREFERENCING_NONE)
+	      rl2_set_tiff_origin_not_referenced (origin);
+      }
+    rl2_get_tiff_origin_size (origin, &(file->width), &(file->height));
+    if ((double) (file->width) * (double) (file->height) >
+	RL2_MT_IMPORT_MAX_PIXELS)
+      {
+	  /* too big to be kept in memory: importing it later */
+	  rl2_destroy_tiff_origin (origin);
+	  file->origin = NULL;
+	  file->sequential = 1;
+	  file->retcode = RL2_OK;
+	  cancel_file_checksum (checksum);
+	  return;
+      }
+    file->xml_summary = rl2_build_tiff_xml_summary (origin);
+    if (rl2_get_tiff_origin_srid (origin, &(file->orig_srid)) == RL2_OK)
+      {
+	  file->srid = file->orig_srid;
+	  if (file->force_srid > 0 && file->force_srid != file->srid)
+	      file->srid = file->force_srid;
+      }
+    rl2_get_tiff_origin_extent (origin, &(file->minx), &(file->miny),
+				&(file->maxx), &(file->maxy));
+    rl2_get_tiff_origin_resolution (origin, &(file->res_x), &(file->res_y));
+    if (!check_import_file_resolution (file))
+	goto error;
+    if (rl2_eval_tiff_origin_compatibility
+	(cvg, origin, file->force_srid, file->verbose) != RL2_TRUE)
+      {
+	  file->error_message = sqlite3_mprintf ("Coverage/TIFF mismatch");
+	  goto error;
+      }
+    no_data = rl2_get_coverage_no_data (cvg);
+
+/* encoding all tiles */
+    file->aux =
+	createAuxImporter (file->coverage, file->srid, file->maxx, file->miny,
+			   file->tile_w, file->tile_h, file->res_x,
+			   file->res_y, RL2_ORIGIN_TIFF, origin,
+			   RL2_CONVERT_NO, file->verbose, file->compression,
+			   file->quality, file->sparse);
+    tile_maxy = file->maxy;
+    for (row = 0; row < file->height; row += file->tile_h)
+      {
+	  tile_minx = file->minx;
+	  for (col = 0; col < file->width; col += file->tile_w)
+	    {
+		/* adding a Tile request */
+		addTile2AuxImporter (file->aux, row, col, tile_minx,
+				     tile_maxy);
+		tile_minx += (double) (file->tile_w) * file->res_x;
+	    }
+	  tile_maxy -= (double) (file->tile_h) * file->res_y;
+      }
+    tile = file->aux->first;
+    while (tile != NULL)
+      {
+	  do_get_tile (tile);
+	  do_encode_tile (tile);
+	  if (tile->retcode != RL2_OK)
+	      goto error;
+	  if (tile->blob_odd != NULL)
+	    {
+		/* computing the tile statistics */
+		rl2PalettePtr aux_palette =
+		    rl2_clone_palette (rl2_get_raster_palette (tile->raster));
+		tile->stats =
+		    rl2_get_raster_statistics_dict (tile->blob_odd,
+						    tile->blob_odd_sz,
+						    tile->blob_even,
+						    tile->blob_even_sz,
+						    aux_palette, no_data,
+						    (rl2CoveragePtr)
+						    (file->coverage));
+		if (tile->stats == NULL)
+		    goto error;
+	    }
+	  rl2_destroy_raster (tile->raster);
+	  tile->raster = NULL;
+	  tile = tile->next;
+      }
+    file->md5 = finish_file_checksum (checksum);
+    file->retcode = RL2_OK;
+    return;
+
+  error:
+    cancel_file_checksum (checksum);
+    file->retcode = RL2_ERROR;
+}
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+DWORD WINAPI
+doRunImportFileThread (void *arg)
+#else
+void *
+doRunImportFileThread (void *arg)
+#endif
+{
+/* threaded function: preparing a whole Source file to be imported */
+    rl2AuxImportFilePtr file = (rl2AuxImportFilePtr) arg;
+    rl2_perf_set_thread_counters (file->perf);
+    do_prepare_import_file (file);
+#if defined(_WIN32) && !defined(__MINGW32__)
+    return 0;
+#else
+    pthread_exit (NULL);
+    return NULL;
+#endif
+}
+
+static void
+start_import_file_thread (rl2AuxImportFilePtr file)
+{
+/* starting a concurrent thread */
+#if defined(_WIN32) && !defined(__MINGW32__)
+    HANDLE thread_handle;
+    HANDLE *p_thread;
+    DWORD dwThreadId;
+    thread_handle =
+	CreateThread (NULL, 0, doRunImportFileThread, file, 0, &dwThreadId);
+    p_thread = malloc (sizeof (HANDLE));
+    *p_thread = thread_handle;
+    file->opaque_thread_id = p_thread;
+#else
+    pthread_t thread_id;
+    pthread_t *p_thread;
+    if (pthread_create (&thread_id, NULL, doRunImportFileThread, file) != 0)
+      {
+	  /* failure: preparing the file on the main thread */
+	  do_prepare_import_file (file);
+	  return;
+      }
+    p_thread = malloc (sizeof (pthread_t));
+    *p_thread = thread_id;
+    file->opaque_thread_id = p_thread;
+#endif
+}
+
+static void
+join_import_file_thread (rl2AuxImportFilePtr file)
+{
+/* waiting until a concurrent thread exits */
+    if (file->opaque_thread_id == NULL)
+	return;
+#if defined(_WIN32) && !defined(__MINGW32__)
+    WaitForSingleObject (*((HANDLE *) (file->opaque_thread_id)), INFINITE);
+    CloseHandle (*((HANDLE *) (file->opaque_thread_id)));
+#else
+    pthread_join (*((pthread_t *) (file->opaque_thread_id)), NULL);
+#endif
+    free (file->opaque_thread_id);
+    file->opaque_thread_id = NULL;
+}
+
+static int
+commit_prepared_file (sqlite3 * handle, const void *priv_data,
+		      rl2AuxImportFilePtr file, const char *section,
+		      int pyramidize, sqlite3_stmt * stmt_data,
+		      sqlite3_stmt * stmt_tils, sqlite3_stmt * stmt_sect,
+		      sqlite3_stmt * stmt_levl, sqlite3_stmt * stmt_upd_sect,
+		      int verbose, int current, int total)
+{
+/* INSERTing an already prepared Source file - main thread only */
+    rl2CoveragePtr cvg = (rl2CoveragePtr) (file->coverage);
+    rl2RasterStatisticsPtr section_stats = NULL;
+    rl2AuxImporterTilePtr tile;
+    sqlite3_int64 section_id;
+    double base_res_x;
+    double base_res_y;
+    char *dumb1;
+    char *dumb2;
+    time_t now;
+    time_t diff;
+    int mins;
+    int secs;
+
+    if (file->origin == NULL)
+      {
+	  /* invalid origin: no report at all */
+	  if (file->error_message != NULL)
+	      fprintf (stderr, "%s\n", file->error_message);
+	  goto error;
+      }
+    if (rl2_get_coverage_resolution (cvg, &base_res_x, &base_res_y) != RL2_OK)
+      {
+	  if (verbose)
+	      fprintf (stderr, "Unknown Coverage Resolution\n");
+	  goto error;
+      }
+
+    printf ("------------------\n");
+    if (total > 1)
+	printf ("%d/%d) Importing: %s\n", current, total, file->src_path);
+    else
+	printf ("Importing: %s\n", file->src_path);
+    printf ("    Image Size (pixels): %d x %d\n", file->width, file->height);
+    if (file->force_srid > 0 && file->force_srid != file->orig_srid)
+	printf ("                   SRID: %d (forced to %d)\n",
+		file->orig_srid, file->force_srid);
+    else
+	printf ("                   SRID: %d\n", file->srid);
+    dumb1 = formatLong (file->minx);
+    dumb2 = formatLat (file->miny);
+    printf ("       LowerLeft Corner: X=%s Y=%s\n", dumb1, dumb2);
+    sqlite3_free (dumb1);
+    sqlite3_free (dumb2);
+    dumb1 = formatLong (file->maxx);
+    dumb2 = formatLat (file->maxy);
+    printf ("      UpperRight Corner: X=%s Y=%s\n", dumb1, dumb2);
+    sqlite3_free (dumb1);
+    sqlite3_free (dumb2);
+    dumb1 = formatFloat (file->res_x);
+    dumb2 = formatFloat (file->res_y);
+    printf ("       Pixel resolution: X=%s Y=%s\n", dumb1, dumb2);
+    sqlite3_free (dumb1);
+    sqlite3_free (dumb2);
+    if (file->retcode != RL2_OK)
+      {
+	  if (file->error_message != NULL)
+	      fprintf (stderr, "%s\n", file->error_message);
+	  goto error;
+      }
+
+/* INSERTing the section */
+    if (!rl2_do_insert_section_md5
+	(handle, file->src_path, section, file->srid, file->width,
+	 file->height, file->minx, file->miny, file->maxx, file->maxy,
+	 file->xml_summary, file->coverage->sectionPaths, file->md5,
+	 file->coverage->sectionSummary, stmt_sect, &section_id))
+      {
+	  file->xml_summary = NULL;
+	  file->md5 = NULL;
+	  goto error;
+      }
+    file->xml_summary = NULL;
+    file->md5 = NULL;
+    section_stats =
+	rl2_create_raster_statistics (file->sample_type, file->num_bands);
+    if (section_stats == NULL)
+	goto error;
+/* INSERTing the base-levels */
+    if (file->coverage->mixedResolutions)
+      {
+	  /* multiple resolutions Coverage */
+	  if (!rl2_do_insert_section_levels
+	      (handle, section_id, file->res_x, file->res_y, 1.0,
+	       file->sample_type, stmt_levl))
+	      goto error;
+      }
+    else
+      {
+	  /* single resolution Coverage */
+	  if (!rl2_do_insert_levels
+	      (handle, base_res_x, base_res_y, 1.0, file->sample_type,
+	       stmt_levl))
+	      goto error;
+      }
+
+/* INSERTing all tiles */
+    tile = file->aux->first;
+    while (tile != NULL)
+      {
+	  if (tile->blob_odd != NULL)
+	    {
+		rl2_aggregate_raster_statistics (tile->stats, section_stats);
+		if (!do_store_tile
+		    (handle, tile->blob_odd, tile->blob_odd_sz,
+		     tile->blob_even, tile->blob_even_sz, section_id,
+		     file->srid, tile->minx, tile->miny, tile->maxx,
+		     tile->maxy, stmt_tils, stmt_data))
+		  {
+		      tile->blob_odd = NULL;
+		      tile->blob_even = NULL;
+		      goto error;
+		  }
+		tile->blob_odd = NULL;
+		tile->blob_even = NULL;
+	    }
+	  tile = tile->next;
+      }
+    destroyAuxImporter (file->aux);
+    file->aux = NULL;
+
+/* updating the Section's Statistics */
+    compute_aggregate_sq_diff (section_stats);
+    if (!rl2_do_insert_stats (handle, section_stats, section_id, stmt_upd_sect))
+	goto error;
+    rl2_destroy_raster_statistics (section_stats);
+    section_stats = NULL;
+    time (&now);
+    diff = now - file->start;
+    mins = diff / 60;
+    secs = diff - (mins * 60);
+    printf (">> Image successfully imported in: %d mins %02d secs\n", mins,
+	    secs);
+
+    if (pyramidize)
+      {
+	  /* immediately building the Section's Pyramid */
+	  const char *coverage_name = rl2_get_coverage_name (cvg);
+	  if (coverage_name == NULL)
+	      goto error;
+	  if (rl2_build_section_pyramid
+	      (handle, priv_data, coverage_name, section_id, 1,
+	       verbose) != RL2_OK)
+	    {
+		fprintf (stderr, "unable to build the Section's Pyramid\n");
+		goto error;
+	    }
+      }
+    return 1;
+
+  error:
+    if (section_stats != NULL)
+	rl2_destroy_raster_statistics (section_stats);
+    return 0;
+}
+
+static int
+do_import_file_list (sqlite3 * handle, const void *priv_data, char **paths,
+		     int total, rl2CoveragePtr cvg, const char *section,
+		     int worldfile, int force_srid, int pyramidize,
+		     unsigned char sample_type, unsigned char pixel_type,
+		     unsigned char num_bands, unsigned int tile_w,
+		     unsigned int tile_h, unsigned char compression,
+		     int quality, sqlite3_stmt * stmt_data,
+		     sqlite3_stmt * stmt_tils, sqlite3_stmt * stmt_sect,
+		     sqlite3_stmt * stmt_levl, sqlite3_stmt * stmt_upd_sect,
+		     int verbose)
+{
+/*
+/ importing a list of Source files
+/
+/ when multithreading is enabled up to max_threads TIFF files will be
+/ concurrently opened, checked and encoded by children threads;
+/ all the INSERTs are then performed by the main thread (the only
+/ SQLite writer) strictly following the list order, so that Section
+/ IDs and error reporting exactly match a sequential import
+*/
+    struct rl2_private_data *cache = (struct rl2_private_data *) priv_data;
+    rl2AuxImportFilePtr *batch = NULL;
+    int max_threads = 1;
+    int cnt = 0;
+    int base;
+    int n;
+    int i;
+    int ret;
+
+    if (cache != NULL)
+	max_threads = cache->max_threads;
+    if (max_threads > 64)
+	max_threads = 64;
+    if (max_threads <= 1 || total < 2 || pixel_type == RL2_PIXEL_PALETTE)
+      {
+	  /* sequential import */
+	  for (i = 0; i < total; i++)
+	    {
+		ret =
+		    do_import_file (handle, priv_data, *(paths + i), cvg,
+				    section, worldfile, force_srid,
+				    pyramidize, sample_type, pixel_type,
+				    num_bands, tile_w, tile_h, compression,
+				    quality, stmt_data, stmt_tils, stmt_sect,
+				    stmt_levl, stmt_upd_sect, verbose,
+				    cnt + 1, total);
+		if (!ret)
+		    break;
+		cnt++;
+	    }
+	  return cnt;
+      }
+
+/* concurrent import */
+    batch = malloc (sizeof (rl2AuxImportFilePtr) * max_threads);
+    if (batch == NULL)
+      {
+	  fprintf (stderr, "ERROR: insufficient memory\n");
+	  return 0;
+      }
+    for (base = 0; base < total; base += max_threads)
+      {
+	  n = total - base;
+	  if (n > max_threads)
+	      n = max_threads;
+	  ret = 1;
+	  for (i = 0; i < n; i++)
+	    {
+		/* preparing the next batch of files */
+		const char *path = *(paths + base + i);
+		rl2AuxImportFilePtr file =
+		    createAuxImportFile (path, (rl2PrivCoveragePtr) cvg,
+					 worldfile, force_srid, sample_type,
+					 pixel_type, num_bands, tile_w,
+					 tile_h, compression, quality,
+					 cache->sparse_tiles,
+					 cache->section_checksum, verbose);
+		if (file == NULL)
+		  {
+		      /* insufficient memory: only joining the started threads */
+		      fprintf (stderr, "ERROR: insufficient memory\n");
+		      n = i;
+		      ret = 0;
+		      break;
+		  }
+		*(batch + i) = file;
+		if (is_sequential_import (path))
+		    file->sequential = 1;
+		else
+		    start_import_file_thread (file);
+	    }
+	  for (i = 0; i < n; i++)
+	      join_import_file_thread (*(batch + i));
+	  /* all children threads have now finished: INSERTing in list order */
+	  for (i = 0; i < n; i++)
+	    {
+		rl2AuxImportFilePtr file = *(batch + i);
+		if (ret)
+		  {
+		      if (file->sequential)
+			  ret =
+			      do_import_file (handle, priv_data,
+					      file->src_path, cvg, section,
+					      worldfile, force_srid,
+					      pyramidize, sample_type,
+					      pixel_type, num_bands, tile_w,
+					      tile_h, compression, quality,
+					      stmt_data, stmt_tils, stmt_sect,
+					      stmt_levl, stmt_upd_sect,
+					      verbose, cnt + 1, total);
+		      else
+			  ret =
+			      commit_prepared_file (handle, priv_data, file,
+						    section, pyramidize,
+						    stmt_data, stmt_tils,
+						    stmt_sect, stmt_levl,
+						    stmt_upd_sect, verbose,
+						    cnt + 1, total);
+		      if (ret)
+			  cnt++;
+		  }
+		destroyAuxImportFile (file);
+	    }
+	  if (!ret)
+	      break;
+      }
+    free (batch);
+    return cnt;
+}
+
 static int
 do_import_dir (sqlite3 * handle, const void *priv_data, const char *dir_path,
 	       const char *file_ext, rl2CoveragePtr cvg, const char *section,
@@ -2581,15 +3498,15 @@ do_import_dir (sqlite3 * handle, const void *priv_data, const char *dir_path,
 	       sqlite3_stmt * stmt_upd_sect, int verbose)
 {
 /* importing a whole directory */
+    char **paths = NULL;
+    int cnt = 0;
+    int total = 0;
+    int i;
 #if defined(_WIN32) && !defined(__MINGW32__)
 /* Visual Studio .NET */
     struct _finddata_t c_file;
     intptr_t hFile;
-    int cnt = 0;
-    int total = 0;
     char *search;
-    char *path;
-    int ret;
     if (_chdir (dir_path) < 0)
 	return 0;
     search = sqlite3_mprintf ("*%s", file_ext);
@@ -2606,49 +3523,32 @@ do_import_dir (sqlite3 * handle, const void *priv_data, const char *dir_path,
 		    break;
 	    }
 	  _findclose (hFile);
+	  if (total > 0)
+	      paths = malloc (sizeof (char *) * total);
 	  if ((hFile = _findfirst (search, &c_file)) == -1L)
 	      ;
 	  else
 	    {
-		while (1)
+		while (cnt < total)
 		  {
 		      if ((c_file.attrib & _A_RDONLY) == _A_RDONLY
 			  || (c_file.attrib & _A_NORMAL) == _A_NORMAL)
 			{
-			    path =
+			    *(paths + cnt) =
 				sqlite3_mprintf ("%s/%s", dir_path,
 						 c_file.name);
-			    ret =
-				do_import_file (handle, priv_data, path,
-						cvg, section, worldfile,
-						force_srid, pyramidize,
-						sample_type, pixel_type,
-						num_bands, tile_w, tile_h,
-						compression, quality,
-						stmt_data, stmt_tils,
-						stmt_sect, stmt_levl,
-						stmt_upd_sect, verbose,
-						cnt + 1, total);
-			    sqlite3_free (path);
-			    if (!ret)
-				goto error;
 			    cnt++;
 			}
 		      if (_findnext (hFile, &c_file) != 0)
 			  break;
 		  }
-	      error:
 		_findclose (hFile);
 	    }
-	  sqlite3_free (search);
-	  return cnt;
+      }
+    sqlite3_free (search);
 #else
 /* not Visual Studio .NET */
-    int cnt = 0;
-    int total = 0;
-    char *path;
     struct dirent *entry;
-    int ret;
     DIR *dir = opendir (dir_path);
     if (!dir)
 	return 0;
@@ -2662,8 +3562,10 @@ do_import_dir (sqlite3 * handle, const void *priv_data, const char *dir_path,
 	      continue;
 	  total++;
       }
+    if (total > 0)
+	paths = malloc (sizeof (char *) * total);
     rewinddir (dir);
-    while (1)
+    while (cnt < total)
       {
 	  /* scanning dir-entries */
 	  entry = readdir (dir);
@@ -2671,23 +3573,25 @@ do_import_dir (sqlite3 * handle, const void *priv_data, const char *dir_path,
 	      break;
 	  if (!check_extension_match (entry->d_name, file_ext))
 	      continue;
-	  path = sqlite3_mprintf ("%s/%s", dir_path, entry->d_name);
-	  ret =
-	      do_import_file (handle, priv_data, path, cvg, section,
-			      worldfile, force_srid, pyramidize, sample_type,
-			      pixel_type, num_bands, tile_w, tile_h,
-			      compression, quality, stmt_data, stmt_tils,
-			      stmt_sect, stmt_levl, stmt_upd_sect, verbose,
-			      cnt + 1, total);
-	  sqlite3_free (path);
-	  if (!ret)
-	      goto error;
+	  *(paths + cnt) = sqlite3_mprintf ("%s/%s", dir_path, entry->d_name);
 	  cnt++;
       }
-  error:
     closedir (dir);
-    return cnt;
 #endif
+
+/* importing all files (may be under concurrent execution) */
+    total = cnt;
+    cnt =
+	do_import_file_list (handle, priv_data, paths, total, cvg, section,
+			     worldfile, force_srid, pyramidize, sample_type,
+			     pixel_type, num_bands, tile_w, tile_h,
+			     compression, quality, stmt_data, stmt_tils,
+			     stmt_sect, stmt_levl, stmt_upd_sect, verbose);
+    for (i = 0; i < total; i++)
+	sqlite3_free (*(paths + i));
+    if (paths != NULL)
+	free (paths);
+    return cnt;
 }
 
 static int
@@ -6021,7 +6925,7 @@ rl2_load_raw_raster_into_dbms (sqlite3 * handle, const void *priv_data,
     aux =
 	createAuxImporter (privcvg, srid, maxx, miny, tile_w, tile_h, res_x,
 			   res_y, RL2_ORIGIN_RAW, rst, RL2_CONVERT_NO, 1,
-			   compression, quality);
+			   compression, quality, cache->sparse_tiles);
     tile_maxy = maxy;
     for (row = 0; row < height; row += tile_h)
       {
@@ -6139,7 +7043,8 @@ rl2_load_raw_raster_into_dbms (sqlite3 * handle, const void *priv_data,
 	      (handle, aux_tile->blob_odd, aux_tile->blob_odd_sz,
 	       aux_tile->blob_even, aux_tile->blob_even_sz, section_id, srid,
 	       aux_tile->minx, aux_tile->miny, aux_tile->maxx, aux_tile->maxy,
-	       aux_palette, no_data, stmt_tils, stmt_data, section_stats))
+	       aux_palette, no_data, stmt_tils, stmt_data, section_stats,
+	       cvg))
 	    {
 		aux_tile->blob_odd = NULL;
 		aux_tile->blob_even = NULL;
@@ -6278,7 +7183,11 @@ rl2_load_raw_tiles_into_dbms (sqlite3 * handle, const void *priv_data,
     sqlite3_int64 section_id;
     int pixel_size;
     int bufpix_sz;
+    int sparse = 0;
+    struct rl2_private_data *cache = (struct rl2_private_data *) priv_data;
 
+    if (cache != NULL)
+	sparse = cache->sparse_tiles;
     if (cvg == NULL)
 	goto error;
     if (section == NULL)
@@ -6514,9 +7423,19 @@ rl2_load_raw_tiles_into_dbms (sqlite3 * handle, const void *priv_data,
 		  }
 
 		/* encoding the Tile */
-		if (rl2_raster_encode
-		    (tile, compression, &blob_odd, &blob_odd_sz, &blob_even,
-		     &blob_even_sz, quality, 1) != RL2_OK)
+		if (sparse)
+		    ret =
+			rl2_raster_encode_sparse (tile, compression, &blob_odd,
+						  &blob_odd_sz, &blob_even,
+						  &blob_even_sz, quality, 1,
+						  cvg);
+		else
+		    ret =
+			rl2_raster_encode_dict (tile, compression, &blob_odd,
+						&blob_odd_sz, &blob_even,
+						&blob_even_sz, quality, 1,
+						cvg);
+		if (ret != RL2_OK)
 		  {
 		      fprintf (stderr,
 			       "ERROR: unable to encode a tile [Row=%d Col=%d]\n",
@@ -6532,7 +7451,7 @@ rl2_load_raw_tiles_into_dbms (sqlite3 * handle, const void *priv_data,
 		    (handle, blob_odd, blob_odd_sz, blob_even, blob_even_sz,
 		     section_id, srid, tile_minx, tile_miny, tile_maxx,
 		     tile_maxy, aux_palette, no_data, stmt_tils, stmt_data,
-		     section_stats))
+		     section_stats, cvg))
 		    goto error;
 
 		/* next tile */
@@ -788,13 +788,16 @@ rl2_rgb_to_jpeg (unsigned int width, unsigned int height,
 /* creating a PNG image from an RGB buffer */
     unsigned char *blob;
     int blob_size;
+    double t0;
     if (rgb == NULL)
 	return RL2_ERROR;
 
+    t0 = rl2_perf_clock ();
     if (rl2_data_to_jpeg
 	(rgb, NULL, NULL, width, height, RL2_SAMPLE_UINT8, RL2_PIXEL_RGB,
 	 &blob, &blob_size, quality) != RL2_OK)
 	return RL2_ERROR;
+    rl2_perf_add (RL2_PERF_IMAGE_ENCODE, t0, blob_size);
     *jpeg = blob;
     *jpeg_size = blob_size;
     return RL2_OK;
@@ -808,13 +811,16 @@ rl2_gray_to_jpeg (unsigned int width, unsigned int height,
 /* creating a PNG image from a Grayscale buffer */
     unsigned char *blob;
     int blob_size;
+    double t0;
     if (gray == NULL)
 	return RL2_ERROR;
 
+    t0 = rl2_perf_clock ();
     if (rl2_data_to_jpeg
 	(gray, NULL, NULL, width, height, RL2_SAMPLE_UINT8,
 	 RL2_PIXEL_GRAYSCALE, &blob, &blob_size, quality) != RL2_OK)
 	return RL2_ERROR;
+    rl2_perf_add (RL2_PERF_IMAGE_ENCODE, t0, blob_size);
     *jpeg = blob;
     *jpeg_size = blob_size;
     return RL2_OK;
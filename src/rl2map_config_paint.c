@@ -85,6 +85,11 @@ do_paint_layer_vector (sqlite3 * sqlite, const void *data,
 	return;
     if (aux_lyr->layer == NULL)
 	return;
+    if (aux_lyr->has_labels && aux_lyr->canvas != NULL)
+      {
+	  /* the Label pass will reuse the Labels found by the Feature pass */
+	  rl2_set_canvas_retain_labels (aux_lyr->canvas, 1);
+      }
 
 /* building the Map's Bounding Box */
     sql = "SELECT BuildMbr(?, ?, ?, ?, ?)";
@@ -207,6 +212,8 @@ do_paint_layer_labels (sqlite3 * sqlite, const void *data,
 		      unsigned char *blob =
 			  (unsigned char *) sqlite3_column_blob (stmt, 0);
 		      int blob_sz = sqlite3_column_bytes (stmt, 0);
+		      rl2_move_canvas_labels ((rl2CanvasPtr) (aux_lyr->canvas),
+					      aux->canvas_labels);
 		      ret = rl2_map_image_paint_labels (sqlite, data,
 							aux->canvas_labels,
 							aux_lyr->prefix,
@@ -114,3 +114,206 @@ rl2_FinalizeMD5Checksum (void *p_md5)
       }
     return hex;
 }
+
+/*
+/ XXH64 - a fast non-cryptographic 64 bit digest
+/ (self-contained implementation of the public XXH64 algorithm,
+/ fully compatible with the reference "xxhsum" output)
+*/
+
+#define RL2_XXH_PRIME64_1	0x9E3779B185EBCA87ULL
+#define RL2_XXH_PRIME64_2	0xC2B2AE3D27D4EB4FULL
+#define RL2_XXH_PRIME64_3	0x165667B19E3779F9ULL
+#define RL2_XXH_PRIME64_4	0x85EBCA77C2B2AE63ULL
+#define RL2_XXH_PRIME64_5	0x27D4EB2F165667C5ULL
+
+typedef struct rl2_xxh64_state
+{
+    unsigned long long total_len;
+    unsigned long long v1;
+    unsigned long long v2;
+    unsigned long long v3;
+    unsigned long long v4;
+    unsigned char buf[32];
+    int buf_len;
+} rl2Xxh64State;
+
+static unsigned long long
+xxh_rotl64 (unsigned long long x, int r)
+{
+/* 64 bit left rotation */
+    return (x << r) | (x >> (64 - r));
+}
+
+static unsigned long long
+xxh_read64 (const unsigned char *p)
+{
+/* reading a 64 bit Little Endian value */
+    return ((unsigned long long) p[0]) | ((unsigned long long) p[1] << 8) |
+	((unsigned long long) p[2] << 16) | ((unsigned long long) p[3] << 24)
+	| ((unsigned long long) p[4] << 32) | ((unsigned long long) p[5] << 40)
+	| ((unsigned long long) p[6] << 48) | ((unsigned long long) p[7] << 56);
+}
+
+static unsigned long long
+xxh_read32 (const unsigned char *p)
+{
+/* reading a 32 bit Little Endian value */
+    return ((unsigned long long) p[0]) | ((unsigned long long) p[1] << 8) |
+	((unsigned long long) p[2] << 16) | ((unsigned long long) p[3] << 24);
+}
+
+static unsigned long long
+xxh64_round (unsigned long long acc, unsigned long long input)
+{
+/* XXH64 accumulator round */
+    acc += input * RL2_XXH_PRIME64_2;
+    acc = xxh_rotl64 (acc, 31);
+    acc *= RL2_XXH_PRIME64_1;
+    return acc;
+}
+
+static unsigned long long
+xxh64_merge_round (unsigned long long acc, unsigned long long val)
+{
+/* XXH64 accumulator merging */
+    acc ^= xxh64_round (0, val);
+    acc = acc * RL2_XXH_PRIME64_1 + RL2_XXH_PRIME64_4;
+    return acc;
+}
+
+static void
+xxh64_reset (rl2Xxh64State * state)
+{
+/* initializing the XXH64 state (seed = 0) */
+    state->total_len = 0;
+    state->v1 = RL2_XXH_PRIME64_1 + RL2_XXH_PRIME64_2;
+    state->v2 = RL2_XXH_PRIME64_2;
+    state->v3 = 0;
+    state->v4 = 0 - RL2_XXH_PRIME64_1;
+    state->buf_len = 0;
+}
+
+static void
+xxh64_stripe (rl2Xxh64State * state, const unsigned char *p)
+{
+/* consuming a 32 bytes stripe */
+    state->v1 = xxh64_round (state->v1, xxh_read64 (p));
+    state->v2 = xxh64_round (state->v2, xxh_read64 (p + 8));
+    state->v3 = xxh64_round (state->v3, xxh_read64 (p + 16));
+    state->v4 = xxh64_round (state->v4, xxh_read64 (p + 24));
+}
+
+RL2_PRIVATE void *
+rl2_CreateXXH64Checksum (void)
+{
+/* Creates and initializes an XXH64 checksum object */
+    rl2Xxh64State *state = malloc (sizeof (rl2Xxh64State));
+    if (state == NULL)
+	return NULL;
+    xxh64_reset (state);
+    return state;
+}
+
+RL2_PRIVATE void
+rl2_FreeXXH64Checksum (void *p_xxh)
+{
+/* memory cleanup - destroying an XXH64 checksum object */
+    if (p_xxh != NULL)
+	free (p_xxh);
+}
+
+RL2_PRIVATE void
+rl2_UpdateXXH64Checksum (void *p_xxh, const unsigned char *blob,
+			 int blob_len)
+{
+/* progressively updating the XXH64 checksum */
+    rl2Xxh64State *state = (rl2Xxh64State *) p_xxh;
+    const unsigned char *p = blob;
+    const unsigned char *end = blob + blob_len;
+    if (state == NULL || blob == NULL || blob_len <= 0)
+	return;
+    state->total_len += blob_len;
+    if (state->buf_len + blob_len < 32)
+      {
+	  /* not enough data for a whole stripe: just buffering */
+	  memcpy (state->buf + state->buf_len, blob, blob_len);
+	  state->buf_len += blob_len;
+	  return;
+      }
+    if (state->buf_len > 0)
+      {
+	  /* completing the pending stripe */
+	  int fill = 32 - state->buf_len;
+	  memcpy (state->buf + state->buf_len, p, fill);
+	  xxh64_stripe (state, state->buf);
+	  p += fill;
+	  state->buf_len = 0;
+      }
+    while (p + 32 <= end)
+      {
+	  xxh64_stripe (state, p);
+	  p += 32;
+      }
+    if (p < end)
+      {
+	  /* buffering the trailing bytes */
+	  state->buf_len = end - p;
+	  memcpy (state->buf, p, state->buf_len);
+      }
+}
+
+RL2_PRIVATE char *
+rl2_FinalizeXXH64Checksum (void *p_xxh)
+{
+/* return the current XXH64 checksum and resets the XXH64 object */
+    rl2Xxh64State *state = (rl2Xxh64State *) p_xxh;
+    unsigned long long h;
+    const unsigned char *p;
+    const unsigned char *end;
+    char *hex;
+    if (state == NULL)
+	return NULL;
+    if (state->total_len >= 32)
+      {
+	  h = xxh_rotl64 (state->v1, 1) + xxh_rotl64 (state->v2, 7) +
+	      xxh_rotl64 (state->v3, 12) + xxh_rotl64 (state->v4, 18);
+	  h = xxh64_merge_round (h, state->v1);
+	  h = xxh64_merge_round (h, state->v2);
+	  h = xxh64_merge_round (h, state->v3);
+	  h = xxh64_merge_round (h, state->v4);
+      }
+    else
+	h = RL2_XXH_PRIME64_5;
+    h += state->total_len;
+    p = state->buf;
+    end = state->buf + state->buf_len;
+    while (p + 8 <= end)
+      {
+	  h ^= xxh64_round (0, xxh_read64 (p));
+	  h = xxh_rotl64 (h, 27) * RL2_XXH_PRIME64_1 + RL2_XXH_PRIME64_4;
+	  p += 8;
+      }
+    if (p + 4 <= end)
+      {
+	  h ^= xxh_read32 (p) * RL2_XXH_PRIME64_1;
+	  h = xxh_rotl64 (h, 23) * RL2_XXH_PRIME64_2 + RL2_XXH_PRIME64_3;
+	  p += 4;
+      }
+    while (p < end)
+      {
+	  h ^= (*p) * RL2_XXH_PRIME64_5;
+	  h = xxh_rotl64 (h, 11) * RL2_XXH_PRIME64_1;
+	  p++;
+      }
+    h ^= h >> 33;
+    h *= RL2_XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= RL2_XXH_PRIME64_3;
+    h ^= h >> 32;
+    xxh64_reset (state);
+/* formatting the XXH64 checksum as hex-text (canonical Big Endian) */
+    hex = malloc (17);
+    sprintf (hex, "%016llx", h);
+    return hex;
+}
@@ -0,0 +1,714 @@
+/*
+
+ rl2metacache -- per-connection Coverage metadata cache
+
+ version 0.1, 2026 October 18
+
+ Author: Sandro Furieri a.furieri@lqt.it
+
+ -----------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2026
+the Initial Developer. All Rights Reserved.
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#ifdef LOADABLE_EXTENSION
+#include "rasterlite2/sqlite.h"
+#endif
+
+#include "rasterlite2/rasterlite2.h"
+#include "rasterlite2_private.h"
+
+/* max number of Coverages kept into the Metadata Cache */
+#define RL2_METADATA_CACHE_MAX	32
+
+/* max number of stable PNG8/GIF Palettes kept into the Metadata Cache */
+#define RL2_PALETTE_CACHE_MAX	32
+
+static int
+same_db_prefix (const char *a, const char *b)
+{
+/* comparing two DB prefixes (NULL always means MAIN) */
+    if (a == NULL)
+	a = "main";
+    if (b == NULL)
+	b = "main";
+    if (strcasecmp (a, b) == 0)
+	return 1;
+    return 0;
+}
+
+static char *
+clone_name (const char *name)
+{
+/* allocating a copy of some name */
+    char *clone;
+    if (name == NULL)
+	return NULL;
+    clone = malloc (strlen (name) + 1);
+    strcpy (clone, name);
+    return clone;
+}
+
+static int
+same_name (const char *a, const char *b)
+{
+/* comparing two (possibly NULL) names */
+    if (a == NULL && b == NULL)
+	return 1;
+    if (a == NULL || b == NULL)
+	return 0;
+    if (strcasecmp (a, b) == 0)
+	return 1;
+    return 0;
+}
+
+static void
+destroy_cached_palette (struct rl2_cached_palette *entry)
+{
+/* destroying a cached Palette */
+    if (entry->db_prefix != NULL)
+	free (entry->db_prefix);
+    if (entry->coverage_name != NULL)
+	free (entry->coverage_name);
+    if (entry->style_name != NULL)
+	free (entry->style_name);
+    if (entry->lut != NULL)
+	free (entry->lut);
+    if (entry->seed != NULL)
+	free (entry->seed);
+    free (entry);
+}
+
+static void
+flush_cached_palettes (struct rl2_metadata_cache *cache, const char *db_prefix,
+		       const char *coverage)
+{
+/* 
+/ removing the stable Palettes of some Coverage
+/ (or all stable Palettes when Coverage is NULL)
+*/
+    struct rl2_cached_palette *prev = NULL;
+    struct rl2_cached_palette *pP = cache->first_palette;
+    while (pP != NULL)
+      {
+	  struct rl2_cached_palette *pPn = pP->next;
+	  if (coverage == NULL
+	      || (same_db_prefix (pP->db_prefix, db_prefix)
+		  && strcasecmp (pP->coverage_name, coverage) == 0))
+	    {
+		if (prev == NULL)
+		    cache->first_palette = pPn;
+		else
+		    prev->next = pPn;
+		if (cache->last_palette == pP)
+		    cache->last_palette = prev;
+		cache->palette_count -= 1;
+		destroy_cached_palette (pP);
+	    }
+	  else
+	      prev = pP;
+	  pP = pPn;
+      }
+}
+
+static void
+destroy_cached_coverage (struct rl2_cached_coverage *entry)
+{
+/* destroying a cached Coverage and all its dependent objects */
+    struct rl2_cached_style *pS;
+    struct rl2_cached_style *pSn;
+    rl2PrivCoveragePtr cvg = (rl2PrivCoveragePtr) (entry->coverage);
+    if (entry->db_prefix != NULL)
+	free (entry->db_prefix);
+    if (entry->coverage_name != NULL)
+	free (entry->coverage_name);
+    if (cvg != NULL)
+      {
+	  cvg->cached = NULL;
+	  rl2_destroy_coverage ((rl2CoveragePtr) cvg);
+      }
+    if (entry->levels != NULL)
+	free (entry->levels);
+    if (entry->palette != NULL)
+	rl2_destroy_palette ((rl2PalettePtr) (entry->palette));
+    if (entry->stats != NULL)
+	rl2_destroy_raster_statistics ((rl2RasterStatisticsPtr)
+				       (entry->stats));
+    pS = entry->first_style;
+    while (pS != NULL)
+      {
+	  pSn = pS->next;
+	  free (pS->name);
+	  rl2_destroy_coverage_style ((rl2CoverageStylePtr) (pS->style));
+	  free (pS);
+	  pS = pSn;
+      }
+    free (entry);
+}
+
+RL2_PRIVATE struct rl2_metadata_cache *
+rl2_alloc_metadata_cache (void)
+{
+/* allocating an empty Metadata Cache */
+    struct rl2_metadata_cache *cache =
+	malloc (sizeof (struct rl2_metadata_cache));
+    if (cache == NULL)
+	return NULL;
+    cache->total_changes = -1;
+    cache->count = 0;
+    cache->first = NULL;
+    cache->last = NULL;
+    cache->palette_count = 0;
+    cache->first_palette = NULL;
+    cache->last_palette = NULL;
+    return cache;
+}
+
+RL2_PRIVATE void
+rl2_flush_metadata_cache (struct rl2_metadata_cache *cache)
+{
+/* removing all cached Coverages and stable Palettes */
+    struct rl2_cached_coverage *entry;
+    struct rl2_cached_coverage *entry_n;
+    if (cache == NULL)
+	return;
+    entry = cache->first;
+    while (entry != NULL)
+      {
+	  entry_n = entry->next;
+	  destroy_cached_coverage (entry);
+	  entry = entry_n;
+      }
+    cache->count = 0;
+    cache->first = NULL;
+    cache->last = NULL;
+    flush_cached_palettes (cache, NULL, NULL);
+}
+
+RL2_PRIVATE void
+rl2_destroy_metadata_cache (struct rl2_metadata_cache *cache)
+{
+/* destroying the Metadata Cache */
+    if (cache == NULL)
+	return;
+    rl2_flush_metadata_cache (cache);
+    free (cache);
+}
+
+static void
+unlink_cached_coverage (struct rl2_metadata_cache *cache,
+			struct rl2_cached_coverage *entry)
+{
+/* removing a single Coverage from the Metadata Cache */
+    struct rl2_cached_coverage *prev = NULL;
+    struct rl2_cached_coverage *pC = cache->first;
+    while (pC != NULL)
+      {
+	  if (pC == entry)
+	    {
+		if (prev == NULL)
+		    cache->first = pC->next;
+		else
+		    prev->next = pC->next;
+		if (cache->last == pC)
+		    cache->last = prev;
+		cache->count -= 1;
+		flush_cached_palettes (cache, pC->db_prefix,
+				       pC->coverage_name);
+		destroy_cached_coverage (pC);
+		return;
+	    }
+	  prev = pC;
+	  pC = pC->next;
+      }
+}
+
+static void
+touch_cached_coverage (struct rl2_metadata_cache *cache,
+		       struct rl2_cached_coverage *entry)
+{
+/* moving a Coverage just used to the tail (most recently used) */
+    struct rl2_cached_coverage *prev = NULL;
+    struct rl2_cached_coverage *pC = cache->first;
+    if (cache->last == entry)
+	return;
+    while (pC != NULL)
+      {
+	  if (pC == entry)
+	    {
+		if (prev == NULL)
+		    cache->first = pC->next;
+		else
+		    prev->next = pC->next;
+		pC->next = NULL;
+		cache->last->next = pC;
+		cache->last = pC;
+		return;
+	    }
+	  prev = pC;
+	  pC = pC->next;
+      }
+}
+
+static void
+check_total_changes (struct rl2_metadata_cache *cache, sqlite3 * handle)
+{
+/* invalidating the whole cache if this connection has changed something */
+    int total_changes = sqlite3_total_changes (handle);
+    if (total_changes != cache->total_changes)
+      {
+	  rl2_flush_metadata_cache (cache);
+	  cache->total_changes = total_changes;
+      }
+}
+
+static int
+get_data_version (sqlite3 * handle, const char *db_prefix)
+{
+/* querying the current Data Version of some attached DB */
+    char *sql;
+    char *xdb_prefix;
+    int ret;
+    sqlite3_stmt *stmt = NULL;
+    int version = -1;
+
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    sql = sqlite3_mprintf ("PRAGMA \"%s\".data_version", xdb_prefix);
+    free (xdb_prefix);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return -1;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW)
+	version = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return version;
+}
+
+static int
+load_cached_levels (sqlite3 * handle, struct rl2_cached_coverage *entry)
+{
+/* loading the Pyramid Levels of some ordinary Coverage */
+    char *sql;
+    char *xdb_prefix;
+    char *xcoverage;
+    char *xxcoverage;
+    const char *db_prefix = entry->db_prefix;
+    int ret;
+    int max_levels = 0;
+    sqlite3_stmt *stmt = NULL;
+
+    if (db_prefix == NULL)
+	db_prefix = "MAIN";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    xcoverage = sqlite3_mprintf ("%s_levels", entry->coverage_name);
+    xxcoverage = rl2_double_quoted_sql (xcoverage);
+    sqlite3_free (xcoverage);
+    sql =
+	sqlite3_mprintf
+	("SELECT pyramid_level, x_resolution_1_1, y_resolution_1_1, "
+	 "x_resolution_1_2, y_resolution_1_2, x_resolution_1_4, y_resolution_1_4, "
+	 "x_resolution_1_8, y_resolution_1_8 FROM \"%s\".\"%s\" "
+	 "ORDER BY pyramid_level DESC", xdb_prefix, xxcoverage);
+    free (xdb_prefix);
+    free (xxcoverage);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "SQL error: %s\n%s\n", sql, sqlite3_errmsg (handle));
+	  sqlite3_free (sql);
+	  return 0;
+      }
+    sqlite3_free (sql);
+
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		struct rl2_cached_level *lvl;
+		int i;
+		if (entry->num_levels == max_levels)
+		  {
+		      int max = (max_levels == 0) ? 8 : max_levels * 2;
+		      struct rl2_cached_level *p =
+			  realloc (entry->levels,
+				   sizeof (struct rl2_cached_level) * max);
+		      if (p == NULL)
+			  goto error;
+		      entry->levels = p;
+		      max_levels = max;
+		  }
+		lvl = entry->levels + entry->num_levels;
+		entry->num_levels += 1;
+		lvl->level = sqlite3_column_int (stmt, 0);
+		lvl->valid = 0;
+		for (i = 0; i < 4; i++)
+		  {
+		      int col = 1 + (i * 2);
+		      lvl->x_res[i] = 0.0;
+		      lvl->y_res[i] = 0.0;
+		      if (sqlite3_column_type (stmt, col) == SQLITE_FLOAT
+			  && sqlite3_column_type (stmt, col + 1) ==
+			  SQLITE_FLOAT)
+			{
+			    lvl->valid |= (1 << i);
+			    lvl->x_res[i] = sqlite3_column_double (stmt, col);
+			    lvl->y_res[i] =
+				sqlite3_column_double (stmt, col + 1);
+			}
+		  }
+	    }
+	  else
+	    {
+		fprintf (stderr, "SQL error: %s\n", sqlite3_errmsg (handle));
+		goto error;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    return 1;
+
+  error:
+    sqlite3_finalize (stmt);
+    return 0;
+}
+
+RL2_PRIVATE rl2CoveragePtr
+rl2_get_cached_coverage (const void *priv_data, sqlite3 * handle,
+			 const char *db_prefix, const char *coverage)
+{
+/*
+/ returning a Coverage object from the Metadata Cache
+/
+/ the returned object (and any Style, Statistics or Palette obtained
+/ from it) is owned by the cache and must never be destroyed by the
+/ caller; the whole cache is invalidated as soon as this connection
+/ changes anything, and each single Coverage is reloaded when some
+/ other connection commits a change into its DB (PRAGMA data_version)
+/ NULL is returned when the cache is unavailable: callers are then
+/ expected to directly create a Coverage object from the DBMS
+*/
+    struct rl2_private_data *priv = (struct rl2_private_data *) priv_data;
+    struct rl2_metadata_cache *cache;
+    struct rl2_cached_coverage *entry;
+    rl2PrivCoveragePtr cvg;
+    int version;
+
+    if (priv == NULL || handle == NULL || coverage == NULL)
+	return NULL;
+    cache = priv->meta_cache;
+    if (cache == NULL)
+	return NULL;
+
+    check_total_changes (cache, handle);
+    version = get_data_version (handle, db_prefix);
+    if (version < 0)
+	return NULL;
+
+    entry = cache->first;
+    while (entry != NULL)
+      {
+	  if (same_db_prefix (entry->db_prefix, db_prefix)
+	      && strcasecmp (entry->coverage_name, coverage) == 0)
+	    {
+		if (entry->data_version == version)
+		  {
+		      touch_cached_coverage (cache, entry);
+		      return (rl2CoveragePtr) (entry->coverage);
+		  }
+		/* changed by some other connection: reloading */
+		unlink_cached_coverage (cache, entry);
+		break;
+	    }
+	  entry = entry->next;
+      }
+
+/* loading the Coverage from the DBMS */
+    cvg =
+	(rl2PrivCoveragePtr) rl2_create_coverage_from_dbms (handle, db_prefix,
+							    coverage);
+    if (cvg == NULL)
+	return NULL;
+    entry = malloc (sizeof (struct rl2_cached_coverage));
+    if (entry == NULL)
+      {
+	  rl2_destroy_coverage ((rl2CoveragePtr) cvg);
+	  return NULL;
+      }
+    entry->db_prefix = clone_name (db_prefix);
+    entry->coverage_name = clone_name (coverage);
+    entry->data_version = version;
+    entry->coverage = cvg;
+    entry->mixed_resolutions = cvg->mixedResolutions;
+    entry->num_levels = 0;
+    entry->levels = NULL;
+    entry->palette = NULL;
+    entry->stats_loaded = 0;
+    entry->stats = NULL;
+    entry->first_style = NULL;
+    entry->last_style = NULL;
+    entry->next = NULL;
+    if (!entry->mixed_resolutions)
+      {
+	  if (!load_cached_levels (handle, entry))
+	    {
+		destroy_cached_coverage (entry);
+		return NULL;
+	    }
+      }
+    if (cvg->pixelType == RL2_PIXEL_PALETTE)
+	entry->palette = rl2_get_dbms_palette (handle, db_prefix, coverage);
+    cvg->cached = entry;
+
+    if (cache->count >= RL2_METADATA_CACHE_MAX)
+      {
+	  /* evicting the least recently used Coverage */
+	  unlink_cached_coverage (cache, cache->first);
+      }
+    if (cache->first == NULL)
+	cache->first = entry;
+    if (cache->last != NULL)
+	cache->last->next = entry;
+    cache->last = entry;
+    cache->count += 1;
+    return (rl2CoveragePtr) cvg;
+}
+
+RL2_PRIVATE void
+rl2_sync_metadata_cache (const void *priv_data, sqlite3 * handle)
+{
+/*
+/ acknowledging changes made by a rendering request itself
+/ (e.g. temporary tables), so that they will not invalidate the cache
+*/
+    struct rl2_private_data *priv = (struct rl2_private_data *) priv_data;
+    if (priv == NULL || priv->meta_cache == NULL || handle == NULL)
+	return;
+    priv->meta_cache->total_changes = sqlite3_total_changes (handle);
+}
+
+RL2_PRIVATE rl2CoverageStylePtr
+rl2_get_cached_coverage_style (sqlite3 * handle, rl2CoveragePtr ptr,
+			       const char *style)
+{
+/* returning a parsed Coverage Style from the Metadata Cache */
+    rl2PrivCoveragePtr cvg = (rl2PrivCoveragePtr) ptr;
+    struct rl2_cached_coverage *entry;
+    struct rl2_cached_style *pS;
+    rl2CoverageStylePtr stl;
+
+    if (cvg == NULL || style == NULL)
+	return NULL;
+    entry = cvg->cached;
+    if (entry == NULL)
+	return NULL;
+    pS = entry->first_style;
+    while (pS != NULL)
+      {
+	  if (strcasecmp (pS->name, style) == 0)
+	      return (rl2CoverageStylePtr) (pS->style);
+	  pS = pS->next;
+      }
+
+/* loading and parsing the Style */
+    stl =
+	rl2_create_coverage_style_from_dbms (handle, entry->db_prefix,
+					     entry->coverage_name, style);
+    if (stl == NULL)
+	return NULL;
+    pS = malloc (sizeof (struct rl2_cached_style));
+    if (pS == NULL)
+      {
+	  rl2_destroy_coverage_style (stl);
+	  return NULL;
+      }
+    pS->name = clone_name (style);
+    pS->style = stl;
+    pS->next = NULL;
+    if (entry->first_style == NULL)
+	entry->first_style = pS;
+    if (entry->last_style != NULL)
+	entry->last_style->next = pS;
+    entry->last_style = pS;
+    return stl;
+}
+
+RL2_PRIVATE rl2RasterStatisticsPtr
+rl2_get_cached_raster_statistics (sqlite3 * handle, rl2CoveragePtr ptr)
+{
+/* returning the Raster Statistics from the Metadata Cache */
+    rl2PrivCoveragePtr cvg = (rl2PrivCoveragePtr) ptr;
+    struct rl2_cached_coverage *entry;
+
+    if (cvg == NULL)
+	return NULL;
+    entry = cvg->cached;
+    if (entry == NULL)
+	return NULL;
+    if (!entry->stats_loaded)
+      {
+	  entry->stats =
+	      rl2_create_raster_statistics_from_dbms (handle, entry->db_prefix,
+						      entry->coverage_name);
+	  entry->stats_loaded = 1;
+      }
+    return (rl2RasterStatisticsPtr) (entry->stats);
+}
+
+RL2_PRIVATE rl2PalettePtr
+rl2_get_coverage_palette (sqlite3 * handle, rl2CoveragePtr ptr)
+{
+/* 
+/ returning a copy of the Coverage's Palette
+/ (directly from the Metadata Cache whenever possible) 
+*/
+    rl2PrivCoveragePtr cvg = (rl2PrivCoveragePtr) ptr;
+    if (cvg == NULL)
+	return NULL;
+    if (cvg->cached != NULL && cvg->cached->palette != NULL)
+	return rl2_clone_palette ((rl2PalettePtr) (cvg->cached->palette));
+    return rl2_get_dbms_palette (handle, cvg->dbPrefix, cvg->coverageName);
+}
+
+RL2_PRIVATE struct rl2_cached_palette *
+rl2_get_cached_quantize_palette (const void *priv_data, sqlite3 * handle,
+				 const char *db_prefix, const char *coverage,
+				 const char *style)
+{
+/* 
+/ searching the stable PNG8/GIF Palette of some Coverage + Style
+/ (Palettes are discarded as soon as the Coverage could have changed,
+/ exactly as the cached Coverages are)
+*/
+    struct rl2_cached_palette *pP;
+    struct rl2_metadata_cache *cache;
+    int version;
+    struct rl2_private_data *priv = (struct rl2_private_data *) priv_data;
+    if (priv == NULL || priv->meta_cache == NULL || handle == NULL
+	|| coverage == NULL)
+	return NULL;
+    cache = priv->meta_cache;
+    check_total_changes (cache, handle);
+    version = get_data_version (handle, db_prefix);
+    if (version < 0)
+	return NULL;
+    pP = cache->first_palette;
+    while (pP != NULL)
+      {
+	  if (same_db_prefix (pP->db_prefix, db_prefix)
+	      && strcasecmp (pP->coverage_name, coverage) == 0
+	      && same_name (pP->style_name, style))
+	    {
+		if (pP->data_version == version)
+		    return pP;
+		/* changed by some other connection: discarding */
+		flush_cached_palettes (cache, db_prefix, coverage);
+		return NULL;
+	    }
+	  pP = pP->next;
+      }
+    return NULL;
+}
+
+RL2_PRIVATE struct rl2_cached_palette *
+rl2_add_cached_quantize_palette (const void *priv_data, sqlite3 * handle,
+				 const char *db_prefix, const char *coverage,
+				 const char *style)
+{
+/* 
+/ inserting a stable PNG8/GIF Palette into the Metadata Cache
+/ (initially empty: the Palette will be computed by sampling images)
+*/
+    int i;
+    int version;
+    struct rl2_cached_palette *entry;
+    struct rl2_metadata_cache *cache;
+    struct rl2_private_data *priv = (struct rl2_private_data *) priv_data;
+    if (priv == NULL || priv->meta_cache == NULL || handle == NULL
+	|| coverage == NULL)
+	return NULL;
+    cache = priv->meta_cache;
+    version = get_data_version (handle, db_prefix);
+    if (version < 0)
+	return NULL;
+
+    entry = malloc (sizeof (struct rl2_cached_palette));
+    if (entry == NULL)
+	return NULL;
+    entry->db_prefix = clone_name (db_prefix);
+    entry->coverage_name = clone_name (coverage);
+    entry->style_name = clone_name (style);
+    entry->data_version = version;
+    entry->num_entries = 0;
+    entry->samples = 0;
+    entry->seed = NULL;
+    entry->lut = malloc (sizeof (unsigned short) * 32768);
+    if (entry->lut == NULL)
+      {
+	  destroy_cached_palette (entry);
+	  return NULL;
+      }
+    for (i = 0; i < 32768; i++)
+	entry->lut[i] = 0xffff;	/* not yet resolved */
+    entry->next = NULL;
+
+    if (cache->palette_count >= RL2_PALETTE_CACHE_MAX)
+      {
+	  /* evicting the oldest cached Palette */
+	  struct rl2_cached_palette *old = cache->first_palette;
+	  cache->first_palette = old->next;
+	  if (cache->last_palette == old)
+	      cache->last_palette = NULL;
+	  destroy_cached_palette (old);
+	  cache->palette_count -= 1;
+      }
+    if (cache->first_palette == NULL)
+	cache->first_palette = entry;
+    if (cache->last_palette != NULL)
+	cache->last_palette->next = entry;
+    cache->last_palette = entry;
+    cache->palette_count += 1;
+    return entry;
+}
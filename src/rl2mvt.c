@@ -0,0 +1,1283 @@
+/*
+
+ rl2mvt -- Mapbox Vector Tiles from Vector Coverages
+
+ version 0.1, 2026 October 18
+
+ Author: Sandro Furieri a.furieri@lqt.it
+
+ -----------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2026
+the Initial Developer. All Rights Reserved.
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "config.h"
+
+#ifdef LOADABLE_EXTENSION
+#include "rasterlite2/sqlite.h"
+#endif
+
+#include "rasterlite2/rasterlite2.h"
+#include "rasterlite2_private.h"
+
+#include <spatialite/gg_const.h>
+
+/*
+/ encoding Vector Tiles (Mapbox Vector Tile specification 2.1)
+/ from a Vector Coverage
+/
+/ tiles always are in the Google/OSM XYZ scheme (EPSG:3857, the
+/ origin of the grid being the upper left corner of the World);
+/ each Layer of the Coverage becomes an MVT Layer, and each Feature
+/ carries all attributes referenced by the Coverage's own Styles
+*/
+
+#define RL2_MVT_WORLD_EXTENT	20037508.342789244
+#define RL2_MVT_VALUE_BUCKETS	1024
+
+#define RL2_MVT_POINT		1
+#define RL2_MVT_LINESTRING	2
+#define RL2_MVT_POLYGON		3
+
+#define RL2_MVT_CMD_MOVE_TO	1
+#define RL2_MVT_CMD_LINE_TO	2
+#define RL2_MVT_CMD_CLOSE_PATH	7
+
+#define RL2_MVT_WIRE_VARINT	0
+#define RL2_MVT_WIRE_64BIT	1
+#define RL2_MVT_WIRE_LEN	2
+
+struct mvt_buffer
+{
+/* a growable protobuf output buffer */
+    unsigned char *buf;
+    int size;
+    int max;
+    int error;
+};
+
+struct mvt_ints
+{
+/* a growable array of packed uint32 values */
+    unsigned int *values;
+    int count;
+    int max;
+    int error;
+};
+
+struct mvt_value
+{
+/* an attribute Value of some MVT Layer */
+    int type;
+    sqlite3_int64 int_value;
+    double dbl_value;
+    char *txt_value;
+    int txt_len;
+    unsigned int hash;
+    int index;
+    struct mvt_value *next;
+};
+
+struct mvt_layer
+{
+/* an MVT Layer under construction */
+    char *name;
+    int extent;
+    int n_keys;
+    char **keys;
+    int n_values;
+    int max_values;
+    struct mvt_value **values;
+    struct mvt_value *buckets[RL2_MVT_VALUE_BUCKETS];
+    struct mvt_buffer features;
+    int n_features;
+};
+
+struct mvt_tile
+{
+/* the georeferencing of the requested Tile */
+    int extent;
+    double minx;
+    double miny;
+    double maxx;
+    double maxy;
+    double scale_x;
+    double scale_y;
+    double frame_minx;
+    double frame_miny;
+    double frame_maxx;
+    double frame_maxy;
+    double tolerance;
+};
+
+static void
+mvt_buffer_init (struct mvt_buffer *b)
+{
+/* initializing an empty output buffer */
+    b->buf = NULL;
+    b->size = 0;
+    b->max = 0;
+    b->error = 0;
+}
+
+static void
+mvt_buffer_reset (struct mvt_buffer *b)
+{
+/* memory cleanup - resetting an output buffer */
+    if (b->buf != NULL)
+	free (b->buf);
+    mvt_buffer_init (b);
+}
+
+static int
+mvt_grow (struct mvt_buffer *b, int bytes)
+{
+/* ensuring that the output buffer could store more bytes */
+    unsigned char *p;
+    int max;
+    if (b->error)
+	return 0;
+    if (b->size + bytes <= b->max)
+	return 1;
+    max = (b->max == 0) ? 256 : b->max;
+    while (max < b->size + bytes)
+	max *= 2;
+    p = realloc (b->buf, max);
+    if (p == NULL)
+      {
+	  b->error = 1;
+	  return 0;
+      }
+    b->buf = p;
+    b->max = max;
+    return 1;
+}
+
+static void
+mvt_put_varint (struct mvt_buffer *b, sqlite3_uint64 value)
+{
+/* appending a protobuf Varint */
+    if (!mvt_grow (b, 10))
+	return;
+    while (value >= 0x80)
+      {
+	  b->buf[b->size++] = (unsigned char) ((value & 0x7f) | 0x80);
+	  value >>= 7;
+      }
+    b->buf[b->size++] = (unsigned char) value;
+}
+
+static void
+mvt_put_key (struct mvt_buffer *b, int field, int wire_type)
+{
+/* appending a protobuf field key */
+    mvt_put_varint (b, ((sqlite3_uint64) field << 3) | wire_type);
+}
+
+static void
+mvt_put_bytes (struct mvt_buffer *b, int field, const void *data, int len)
+{
+/* appending a length-delimited protobuf field */
+    mvt_put_key (b, field, RL2_MVT_WIRE_LEN);
+    mvt_put_varint (b, len);
+    if (!mvt_grow (b, len))
+	return;
+    memcpy (b->buf + b->size, data, len);
+    b->size += len;
+}
+
+static void
+mvt_put_double (struct mvt_buffer *b, int field, double value)
+{
+/* appending a 64-bit (little endian) protobuf double */
+    union
+    {
+	double dbl;
+	sqlite3_uint64 bits;
+    } cvt;
+    int i;
+    mvt_put_key (b, field, RL2_MVT_WIRE_64BIT);
+    if (!mvt_grow (b, 8))
+	return;
+    cvt.dbl = value;
+    for (i = 0; i < 8; i++)
+	b->buf[b->size++] = (unsigned char) ((cvt.bits >> (i * 8)) & 0xff);
+}
+
+static void
+mvt_put_packed (struct mvt_buffer *b, int field, struct mvt_ints *ints)
+{
+/* appending a packed repeated uint32 protobuf field */
+    struct mvt_buffer tmp;
+    int i;
+    mvt_buffer_init (&tmp);
+    for (i = 0; i < ints->count; i++)
+	mvt_put_varint (&tmp, ints->values[i]);
+    if (tmp.error)
+	b->error = 1;
+    else
+	mvt_put_bytes (b, field, tmp.buf, tmp.size);
+    mvt_buffer_reset (&tmp);
+}
+
+static void
+mvt_ints_push (struct mvt_ints *ints, unsigned int value)
+{
+/* appending a value into a packed uint32 array */
+    if (ints->error)
+	return;
+    if (ints->count >= ints->max)
+      {
+	  int max = (ints->max == 0) ? 64 : ints->max * 2;
+	  unsigned int *p = realloc (ints->values, sizeof (unsigned int) * max);
+	  if (p == NULL)
+	    {
+		ints->error = 1;
+		return;
+	    }
+	  ints->values = p;
+	  ints->max = max;
+      }
+    ints->values[ints->count++] = value;
+}
+
+static unsigned int
+mvt_command (int id, int count)
+{
+/* encoding a geometry CommandInteger */
+    return (unsigned int) ((id & 0x7) | (count << 3));
+}
+
+static unsigned int
+mvt_zigzag (int value)
+{
+/* encoding a geometry ParameterInteger (ZigZag) */
+    return ((unsigned int) value << 1) ^ (unsigned int) (value >> 31);
+}
+
+static int
+mvt_quantize (struct mvt_tile *tile, const double *coords, int points,
+	      int *out)
+{
+/*
+/ quantizing XY coordinates to the Tile grid
+/ consecutive repeated vertices are always discarded
+/ returns the number of the surviving vertices
+*/
+    int iv;
+    int n = 0;
+    for (iv = 0; iv < points; iv++)
+      {
+	  int x = (int) floor (((coords[iv * 2] - tile->minx) * tile->scale_x)
+			       + 0.5);
+	  int y =
+	      (int) floor (((tile->maxy - coords[iv * 2 + 1]) * tile->scale_y) +
+			   0.5);
+	  if (n > 0 && out[(n - 1) * 2] == x && out[(n - 1) * 2 + 1] == y)
+	      continue;
+	  out[n * 2] = x;
+	  out[n * 2 + 1] = y;
+	  n++;
+      }
+    return n;
+}
+
+static void
+mvt_encode_path (struct mvt_ints *geom, int *cursor, const int *pts, int n,
+		 int closed)
+{
+/* encoding a path (Linestring or Ring) as MoveTo + LineTo [+ ClosePath] */
+    int iv;
+    mvt_ints_push (geom, mvt_command (RL2_MVT_CMD_MOVE_TO, 1));
+    mvt_ints_push (geom, mvt_zigzag (pts[0] - cursor[0]));
+    mvt_ints_push (geom, mvt_zigzag (pts[1] - cursor[1]));
+    cursor[0] = pts[0];
+    cursor[1] = pts[1];
+    mvt_ints_push (geom, mvt_command (RL2_MVT_CMD_LINE_TO, n - 1));
+    for (iv = 1; iv < n; iv++)
+      {
+	  mvt_ints_push (geom, mvt_zigzag (pts[iv * 2] - cursor[0]));
+	  mvt_ints_push (geom, mvt_zigzag (pts[iv * 2 + 1] - cursor[1]));
+	  cursor[0] = pts[iv * 2];
+	  cursor[1] = pts[iv * 2 + 1];
+      }
+    if (closed)
+	mvt_ints_push (geom, mvt_command (RL2_MVT_CMD_CLOSE_PATH, 1));
+}
+
+static int
+mvt_prepare_ring (struct mvt_tile *tile, rl2RingPtr ring, int *pts,
+		  int exterior)
+{
+/*
+/ quantizing a Ring; returns the number of vertices (not repeating
+/ the first one), or 0 if the Ring collapsed into a degenerate one
+/
+/ the exterior ring is always oriented so to have a positive area
+/ (clockwise on screen), and interior rings the opposite way
+*/
+    int n;
+    int iv;
+    double area = 0.0;
+    n = mvt_quantize (tile, ring->coords, ring->points, pts);
+    if (n > 1 && pts[0] == pts[(n - 1) * 2] && pts[1] == pts[(n - 1) * 2 + 1])
+	n--;
+    if (n < 3)
+	return 0;
+    for (iv = 0; iv < n; iv++)
+      {
+	  int iv2 = (iv + 1) % n;
+	  area +=
+	      ((double) pts[iv * 2] * (double) pts[iv2 * 2 + 1]) -
+	      ((double) pts[iv2 * 2] * (double) pts[iv * 2 + 1]);
+      }
+    if (area == 0.0)
+	return 0;
+    if ((exterior && area < 0.0) || (!exterior && area > 0.0))
+      {
+	  /* reversing the Ring orientation */
+	  for (iv = 0; iv < n / 2; iv++)
+	    {
+		int iv2 = n - 1 - iv;
+		int x = pts[iv * 2];
+		int y = pts[iv * 2 + 1];
+		pts[iv * 2] = pts[iv2 * 2];
+		pts[iv * 2 + 1] = pts[iv2 * 2 + 1];
+		pts[iv2 * 2] = x;
+		pts[iv2 * 2 + 1] = y;
+	    }
+      }
+    return n;
+}
+
+static int *
+mvt_alloc_points (rl2GeometryPtr geom)
+{
+/* allocating a quantization buffer fitting the largest path */
+    int max = 1;
+    rl2LinestringPtr ln;
+    rl2PolygonPtr pg;
+    int ib;
+    ln = geom->first_linestring;
+    while (ln != NULL)
+      {
+	  if (ln->points > max)
+	      max = ln->points;
+	  ln = ln->next;
+      }
+    pg = geom->first_polygon;
+    while (pg != NULL)
+      {
+	  if (pg->exterior->points > max)
+	      max = pg->exterior->points;
+	  for (ib = 0; ib < pg->num_interiors; ib++)
+	    {
+		rl2RingPtr rng = pg->interiors + ib;
+		if (rng->points > max)
+		    max = rng->points;
+	    }
+	  pg = pg->next;
+      }
+    return malloc (sizeof (int) * 2 * max);
+}
+
+static int
+mvt_encode_points (struct mvt_tile *tile, rl2GeometryPtr geom,
+		   struct mvt_ints *out)
+{
+/* encoding all Points of some Geometry as a single MoveTo */
+    rl2PointPtr pt;
+    int cursor[2] = { 0, 0 };
+    int count = 0;
+    pt = geom->first_point;
+    while (pt != NULL)
+      {
+	  count++;
+	  pt = pt->next;
+      }
+    if (count == 0)
+	return 0;
+    mvt_ints_push (out, mvt_command (RL2_MVT_CMD_MOVE_TO, count));
+    pt = geom->first_point;
+    while (pt != NULL)
+      {
+	  double xy[2];
+	  int q[2];
+	  xy[0] = pt->x;
+	  xy[1] = pt->y;
+	  mvt_quantize (tile, xy, 1, q);
+	  mvt_ints_push (out, mvt_zigzag (q[0] - cursor[0]));
+	  mvt_ints_push (out, mvt_zigzag (q[1] - cursor[1]));
+	  cursor[0] = q[0];
+	  cursor[1] = q[1];
+	  pt = pt->next;
+      }
+    return 1;
+}
+
+static int
+mvt_encode_lines (struct mvt_tile *tile, rl2GeometryPtr geom, int *pts,
+		  struct mvt_ints *out)
+{
+/* encoding all Linestrings of some Geometry */
+    rl2LinestringPtr ln;
+    int cursor[2] = { 0, 0 };
+    int count = 0;
+    ln = geom->first_linestring;
+    while (ln != NULL)
+      {
+	  int n = mvt_quantize (tile, ln->coords, ln->points, pts);
+	  if (n >= 2)
+	    {
+		mvt_encode_path (out, cursor, pts, n, 0);
+		count++;
+	    }
+	  ln = ln->next;
+      }
+    return count;
+}
+
+static int
+mvt_encode_polygons (struct mvt_tile *tile, rl2GeometryPtr geom, int *pts,
+		     struct mvt_ints *out)
+{
+/* encoding all Polygons of some Geometry */
+    rl2PolygonPtr pg;
+    int cursor[2] = { 0, 0 };
+    int count = 0;
+    int ib;
+    pg = geom->first_polygon;
+    while (pg != NULL)
+      {
+	  int n = mvt_prepare_ring (tile, pg->exterior, pts, 1);
+	  if (n == 0)
+	    {
+		/* degenerate exterior ring: skipping the whole Polygon */
+		pg = pg->next;
+		continue;
+	    }
+	  mvt_encode_path (out, cursor, pts, n, 1);
+	  for (ib = 0; ib < pg->num_interiors; ib++)
+	    {
+		n = mvt_prepare_ring (tile, pg->interiors + ib, pts, 0);
+		if (n > 0)
+		    mvt_encode_path (out, cursor, pts, n, 1);
+	    }
+	  count++;
+	  pg = pg->next;
+      }
+    return count;
+}
+
+static unsigned int
+mvt_hash (int type, sqlite3_int64 int_value, double dbl_value,
+	  const char *txt_value, int txt_len)
+{
+/* FNV-1a hash of some attribute Value */
+    unsigned int hash = 2166136261u;
+    const unsigned char *p;
+    int len;
+    int i;
+    if (type == SQLITE_TEXT)
+      {
+	  p = (const unsigned char *) txt_value;
+	  len = txt_len;
+      }
+    else if (type == SQLITE_INTEGER)
+      {
+	  p = (const unsigned char *) &int_value;
+	  len = sizeof (sqlite3_int64);
+      }
+    else
+      {
+	  p = (const unsigned char *) &dbl_value;
+	  len = sizeof (double);
+      }
+    hash ^= (unsigned int) type;
+    hash *= 16777619u;
+    for (i = 0; i < len; i++)
+      {
+	  hash ^= p[i];
+	  hash *= 16777619u;
+      }
+    return hash;
+}
+
+static int
+mvt_find_value (struct mvt_layer *lyr, sqlite3_stmt * stmt, int col)
+{
+/* returns the index of some attribute Value (inserting a new one if required) */
+    int type = sqlite3_column_type (stmt, col);
+    sqlite3_int64 int_value = 0;
+    double dbl_value = 0.0;
+    const char *txt_value = NULL;
+    int txt_len = 0;
+    unsigned int hash;
+    struct mvt_value *val;
+
+    if (type == SQLITE_INTEGER)
+	int_value = sqlite3_column_int64 (stmt, col);
+    else if (type == SQLITE_FLOAT)
+	dbl_value = sqlite3_column_double (stmt, col);
+    else if (type == SQLITE_TEXT)
+      {
+	  txt_value = (const char *) sqlite3_column_text (stmt, col);
+	  txt_len = sqlite3_column_bytes (stmt, col);
+      }
+    else
+	return -1;
+    hash = mvt_hash (type, int_value, dbl_value, txt_value, txt_len);
+
+    val = lyr->buckets[hash % RL2_MVT_VALUE_BUCKETS];
+    while (val != NULL)
+      {
+	  if (val->hash == hash && val->type == type)
+	    {
+		if (type == SQLITE_INTEGER && val->int_value == int_value)
+		    return val->index;
+		if (type == SQLITE_FLOAT && val->dbl_value == dbl_value)
+		    return val->index;
+		if (type == SQLITE_TEXT && val->txt_len == txt_len
+		    && memcmp (val->txt_value, txt_value, txt_len) == 0)
+		    return val->index;
+	    }
+	  val = val->next;
+      }
+
+/* inserting a new Value */
+    if (lyr->n_values >= lyr->max_values)
+      {
+	  int max = (lyr->max_values == 0) ? 256 : lyr->max_values * 2;
+	  struct mvt_value **p =
+	      realloc (lyr->values, sizeof (struct mvt_value *) * max);
+	  if (p == NULL)
+	      return -1;
+	  lyr->values = p;
+	  lyr->max_values = max;
+      }
+    val = malloc (sizeof (struct mvt_value));
+    if (val == NULL)
+	return -1;
+    val->type = type;
+    val->int_value = int_value;
+    val->dbl_value = dbl_value;
+    val->txt_value = NULL;
+    val->txt_len = txt_len;
+    if (type == SQLITE_TEXT)
+      {
+	  val->txt_value = malloc (txt_len + 1);
+	  memcpy (val->txt_value, txt_value, txt_len);
+	  *(val->txt_value + txt_len) = '\0';
+      }
+    val->hash = hash;
+    val->index = lyr->n_values;
+    val->next = lyr->buckets[hash % RL2_MVT_VALUE_BUCKETS];
+    lyr->buckets[hash % RL2_MVT_VALUE_BUCKETS] = val;
+    lyr->values[lyr->n_values++] = val;
+    return val->index;
+}
+
+static struct mvt_layer *
+mvt_create_layer (const char *name, int extent, char **keys, int n_keys)
+{
+/* creating an empty MVT Layer */
+    int i;
+    struct mvt_layer *lyr = malloc (sizeof (struct mvt_layer));
+    if (lyr == NULL)
+	return NULL;
+    lyr->name = malloc (strlen (name) + 1);
+    strcpy (lyr->name, name);
+    lyr->extent = extent;
+    lyr->n_keys = n_keys;
+    lyr->keys = keys;
+    lyr->n_values = 0;
+    lyr->max_values = 0;
+    lyr->values = NULL;
+    for (i = 0; i < RL2_MVT_VALUE_BUCKETS; i++)
+	lyr->buckets[i] = NULL;
+    mvt_buffer_init (&(lyr->features));
+    lyr->n_features = 0;
+    return lyr;
+}
+
+static void
+mvt_destroy_keys (char **keys, int n_keys)
+{
+/* memory cleanup - destroying a list of attribute Keys */
+    int i;
+    if (keys == NULL)
+	return;
+    for (i = 0; i < n_keys; i++)
+	free (keys[i]);
+    free (keys);
+}
+
+static void
+mvt_destroy_layer (struct mvt_layer *lyr)
+{
+/* memory cleanup - destroying an MVT Layer */
+    int i;
+    if (lyr == NULL)
+	return;
+    free (lyr->name);
+    mvt_destroy_keys (lyr->keys, lyr->n_keys);
+    for (i = 0; i < lyr->n_values; i++)
+      {
+	  struct mvt_value *val = lyr->values[i];
+	  if (val->txt_value != NULL)
+	      free (val->txt_value);
+	  free (val);
+      }
+    if (lyr->values != NULL)
+	free (lyr->values);
+    mvt_buffer_reset (&(lyr->features));
+    free (lyr);
+}
+
+static void
+mvt_add_feature (struct mvt_layer *lyr, sqlite3_int64 id, int has_id,
+		 struct mvt_ints *tags, int type, struct mvt_ints *geom)
+{
+/* appending an encoded Feature into some MVT Layer */
+    struct mvt_buffer feature;
+    mvt_buffer_init (&feature);
+    if (has_id)
+      {
+	  mvt_put_key (&feature, 1, RL2_MVT_WIRE_VARINT);
+	  mvt_put_varint (&feature, (sqlite3_uint64) id);
+      }
+    if (tags->count > 0)
+	mvt_put_packed (&feature, 2, tags);
+    mvt_put_key (&feature, 3, RL2_MVT_WIRE_VARINT);
+    mvt_put_varint (&feature, type);
+    mvt_put_packed (&feature, 4, geom);
+    if (feature.error)
+	lyr->features.error = 1;
+    else
+	mvt_put_bytes (&(lyr->features), 2, feature.buf, feature.size);
+    mvt_buffer_reset (&feature);
+    lyr->n_features += 1;
+}
+
+static void
+mvt_encode_layer (struct mvt_buffer *tile, struct mvt_layer *lyr)
+{
+/* appending a complete MVT Layer into the Tile */
+    struct mvt_buffer layer;
+    struct mvt_buffer value;
+    int i;
+    mvt_buffer_init (&layer);
+    mvt_put_key (&layer, 15, RL2_MVT_WIRE_VARINT);
+    mvt_put_varint (&layer, 2);
+    mvt_put_bytes (&layer, 1, lyr->name, strlen (lyr->name));
+    if (mvt_grow (&layer, lyr->features.size))
+      {
+	  memcpy (layer.buf + layer.size, lyr->features.buf,
+		  lyr->features.size);
+	  layer.size += lyr->features.size;
+      }
+    for (i = 0; i < lyr->n_keys; i++)
+	mvt_put_bytes (&layer, 3, lyr->keys[i], strlen (lyr->keys[i]));
+    for (i = 0; i < lyr->n_values; i++)
+      {
+	  struct mvt_value *val = lyr->values[i];
+	  mvt_buffer_init (&value);
+	  if (val->type == SQLITE_TEXT)
+	      mvt_put_bytes (&value, 1, val->txt_value, val->txt_len);
+	  else if (val->type == SQLITE_FLOAT)
+	      mvt_put_double (&value, 3, val->dbl_value);
+	  else
+	    {
+		/* sint_value (ZigZag encoded) */
+		sqlite3_uint64 zz =
+		    ((sqlite3_uint64) val->int_value << 1) ^ (sqlite3_uint64)
+		    (val->int_value >> 63);
+		mvt_put_key (&value, 6, RL2_MVT_WIRE_VARINT);
+		mvt_put_varint (&value, zz);
+	    }
+	  if (value.error)
+	      layer.error = 1;
+	  else
+	      mvt_put_bytes (&layer, 4, value.buf, value.size);
+	  mvt_buffer_reset (&value);
+      }
+    mvt_put_key (&layer, 5, RL2_MVT_WIRE_VARINT);
+    mvt_put_varint (&layer, lyr->extent);
+    if (layer.error || lyr->features.error)
+	tile->error = 1;
+    else
+	mvt_put_bytes (tile, 3, layer.buf, layer.size);
+    mvt_buffer_reset (&layer);
+}
+
+static int
+mvt_add_column (char ***columns, int *count, const char *name)
+{
+/* adding a column name into a list (avoiding duplicates) */
+    int i;
+    char **p;
+    for (i = 0; i < *count; i++)
+      {
+	  if (strcasecmp ((*columns)[i], name) == 0)
+	      return 1;
+      }
+    p = realloc (*columns, sizeof (char *) * (*count + 1));
+    if (p == NULL)
+	return 0;
+    *columns = p;
+    p[*count] = malloc (strlen (name) + 1);
+    strcpy (p[*count], name);
+    *count += 1;
+    return 1;
+}
+
+static char **
+mvt_style_columns (sqlite3 * handle, const char *db_prefix,
+		   const char *coverage, int *count)
+{
+/* collecting all columns referenced by the Styles of some Vector Coverage */
+    char *sql;
+    char *xdb_prefix;
+    sqlite3_stmt *stmt = NULL;
+    char **columns = NULL;
+    int ret;
+    int i;
+
+    *count = 0;
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    sql = sqlite3_mprintf ("SELECT s.style_name, XB_GetDocument(s.style) "
+			   "FROM \"%s\".SE_vector_styled_layers AS v "
+			   "JOIN \"%s\".SE_vector_styles AS s ON (v.style_id = s.style_id) "
+			   "WHERE Lower(v.coverage_name) = Lower(?)",
+			   xdb_prefix, xdb_prefix);
+    free (xdb_prefix);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return NULL;
+    sqlite3_bind_text (stmt, 1, coverage, strlen (coverage), SQLITE_STATIC);
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		rl2FeatureTypeStylePtr stl;
+		if (sqlite3_column_type (stmt, 0) != SQLITE_TEXT
+		    || sqlite3_column_type (stmt, 1) != SQLITE_TEXT)
+		    continue;
+		stl =
+		    rl2_feature_type_style_from_xml ((const char *)
+						     sqlite3_column_text (stmt,
+									  0),
+						     sqlite3_column_text (stmt,
+									  1));
+		if (stl == NULL)
+		    continue;
+		for (i = 0; i < rl2_get_feature_type_style_columns_count (stl);
+		     i++)
+		  {
+		      const char *name =
+			  rl2_get_feature_type_style_column_name (stl, i);
+		      if (name != NULL)
+			  mvt_add_column (&columns, count, name);
+		  }
+		rl2_destroy_feature_type_style (stl);
+	    }
+	  else
+	      break;
+      }
+    sqlite3_finalize (stmt);
+    return columns;
+}
+
+static char **
+mvt_layer_keys (sqlite3 * handle, const char *db_prefix, const char *table,
+		char **columns, int n_columns, int *count)
+{
+/* filtering the Style columns actually existing in some table (or view) */
+    char *sql;
+    char *xdb_prefix;
+    char *xtable;
+    char **results;
+    int rows;
+    int cols;
+    int i;
+    int c;
+    int ret;
+    char **keys = NULL;
+
+    *count = 0;
+    if (n_columns == 0)
+	return NULL;
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    xtable = rl2_double_quoted_sql (table);
+    sql = sqlite3_mprintf ("PRAGMA \"%s\".table_info(\"%s\")", xdb_prefix,
+			   xtable);
+    free (xdb_prefix);
+    free (xtable);
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &cols, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return NULL;
+    for (c = 0; c < n_columns; c++)
+      {
+	  for (i = 1; i <= rows; i++)
+	    {
+		const char *name = results[(i * cols) + 1];
+		if (strcasecmp (name, columns[c]) == 0)
+		  {
+		      mvt_add_column (&keys, count, name);
+		      break;
+		  }
+	    }
+      }
+    sqlite3_free_table (results);
+    return keys;
+}
+
+static char *
+mvt_layer_query (sqlite3 * handle, const char *db_prefix,
+		 rl2PrivVectorLayerPtr lyr, int is_topogeo, char **keys,
+		 int n_keys, struct mvt_tile *tile)
+{
+/* composing the SQL query fetching all Features of some Layer */
+    char *sql;
+    char *oldsql;
+    char *xdb_prefix;
+    char *quoted;
+    char *geom_expr;
+    char *rowid;
+    char *frame;
+    char *toponame = NULL;
+    int face_cache = 0;
+    int is_face = 0;
+    int len;
+    int i;
+
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    len = strlen (lyr->f_table_name);
+    if (is_topogeo && len > 5
+	&& strcasecmp (lyr->f_table_name + len - 5, "_face") == 0)
+      {
+	  /* TopoGeo Faces */
+	  is_face = 1;
+	  toponame = sqlite3_mprintf ("%s", lyr->f_table_name);
+	  *(toponame + len - 5) = '\0';
+	  face_cache = rl2_find_topo_face_cache (handle, db_prefix, toponame);
+      }
+
+/* the (buffered) Tile frame, expressed in the Layer's own SRID */
+    if (lyr->srid > 0 && lyr->srid != 3857)
+	frame =
+	    sqlite3_mprintf
+	    ("ST_Transform(BuildMbr(%1.6f, %1.6f, %1.6f, %1.6f, 3857), %d)",
+	     tile->frame_minx, tile->frame_miny, tile->frame_maxx,
+	     tile->frame_maxy, lyr->srid);
+    else
+	frame =
+	    sqlite3_mprintf ("BuildMbr(%1.6f, %1.6f, %1.6f, %1.6f, %d)",
+			     tile->frame_minx, tile->frame_miny,
+			     tile->frame_maxx, tile->frame_maxy, lyr->srid);
+
+/* the Geometry expression */
+    if (face_cache)
+	geom_expr =
+	    rl2_topo_face_cache_geometry_sql (db_prefix, toponame,
+					      lyr->f_table_name);
+    else if (is_face)
+	geom_expr =
+	    sqlite3_mprintf ("ST_GetFaceGeometry(%Q, face_id)", toponame);
+    else
+      {
+	  if (lyr->view_geometry != NULL)
+	      quoted = rl2_double_quoted_sql (lyr->view_geometry);
+	  else
+	      quoted = rl2_double_quoted_sql (lyr->f_geometry_column);
+	  geom_expr = sqlite3_mprintf ("\"%s\"", quoted);
+	  free (quoted);
+      }
+    if (lyr->view_rowid != NULL)
+      {
+	  quoted = rl2_double_quoted_sql (lyr->view_rowid);
+	  rowid = sqlite3_mprintf ("\"%s\"", quoted);
+	  free (quoted);
+      }
+    else if (is_face)
+	rowid = sqlite3_mprintf ("face_id");
+    else
+	rowid = sqlite3_mprintf ("ROWID");
+    if (lyr->srid > 0 && lyr->srid != 3857)
+	sql =
+	    sqlite3_mprintf ("SELECT %s, ST_Transform(%s, 3857)", rowid,
+			     geom_expr);
+    else
+	sql = sqlite3_mprintf ("SELECT %s, %s", rowid, geom_expr);
+    sqlite3_free (geom_expr);
+
+/* adding the attribute columns */
+    for (i = 0; i < n_keys; i++)
+      {
+	  oldsql = sql;
+	  quoted = rl2_double_quoted_sql (keys[i]);
+	  sql = sqlite3_mprintf ("%s, \"%s\"", oldsql, quoted);
+	  free (quoted);
+	  sqlite3_free (oldsql);
+      }
+
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    if (lyr->view_name != NULL)
+	quoted = rl2_double_quoted_sql (lyr->view_name);
+    else
+	quoted = rl2_double_quoted_sql (lyr->f_table_name);
+    oldsql = sql;
+    sql = sqlite3_mprintf ("%s FROM \"%s\".\"%s\"", oldsql, xdb_prefix, quoted);
+    free (xdb_prefix);
+    free (quoted);
+    sqlite3_free (oldsql);
+
+/* the spatial filter */
+    oldsql = sql;
+    if (face_cache)
+      {
+	  char *filter =
+	      rl2_topo_face_cache_filter_sql (db_prefix, lyr->f_table_name,
+					      frame);
+	  sql = sqlite3_mprintf ("%s WHERE %s", oldsql, filter);
+	  sqlite3_free (filter);
+      }
+    else if (lyr->spatial_index)
+      {
+	  /* queryng the R*Tree Spatial Index */
+	  char *rtree_name = sqlite3_mprintf ("DB=%s.%s", db_prefix,
+					      lyr->f_table_name);
+	  sql =
+	      sqlite3_mprintf
+	      ("%s WHERE %s IN (SELECT ROWID FROM SpatialIndex "
+	       "WHERE f_table_name = %Q AND f_geometry_column = %Q "
+	       "AND search_frame = %s)", oldsql, rowid, rtree_name,
+	       lyr->f_geometry_column, frame);
+	  sqlite3_free (rtree_name);
+      }
+    else
+      {
+	  /* applying MBR filtering */
+	  if (lyr->view_geometry != NULL)
+	      quoted = rl2_double_quoted_sql (lyr->view_geometry);
+	  else
+	      quoted = rl2_double_quoted_sql (lyr->f_geometry_column);
+	  sql =
+	      sqlite3_mprintf ("%s WHERE MbrIntersects(\"%s\", %s)", oldsql,
+			       quoted, frame);
+	  free (quoted);
+      }
+    sqlite3_free (oldsql);
+    if (is_face)
+      {
+	  oldsql = sql;
+	  sql = sqlite3_mprintf ("%s AND face_id > 0", oldsql);
+	  sqlite3_free (oldsql);
+      }
+    sqlite3_free (rowid);
+    sqlite3_free (frame);
+    if (toponame != NULL)
+	sqlite3_free (toponame);
+    return sql;
+}
+
+static int
+mvt_fetch_layer (sqlite3 * handle, struct mvt_layer *layer, const char *sql,
+		 struct mvt_tile *tile)
+{
+/* fetching and encoding all Features of some Layer */
+    sqlite3_stmt *stmt = NULL;
+    struct mvt_ints tags;
+    struct mvt_ints geom;
+    int ret;
+    int i;
+
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "SQL error: %s\n%s\n", sql, sqlite3_errmsg (handle));
+	  return 0;
+      }
+    tags.values = NULL;
+    tags.count = 0;
+    tags.max = 0;
+    tags.error = 0;
+    geom.values = NULL;
+    geom.count = 0;
+    geom.max = 0;
+    geom.error = 0;
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		rl2GeometryPtr full;
+		rl2GeometryPtr clipped;
+		sqlite3_int64 id = 0;
+		int has_id = 0;
+		int *pts;
+		if (rl2_is_cancelled ())
+		    goto error;
+		if (sqlite3_column_type (stmt, 1) != SQLITE_BLOB)
+		    continue;
+		full =
+		    rl2_geometry_from_blob (sqlite3_column_blob (stmt, 1),
+					    sqlite3_column_bytes (stmt, 1));
+		if (full == NULL)
+		    continue;
+		clipped =
+		    rl2_clip_geometry (full, tile->frame_minx,
+				       tile->frame_miny, tile->frame_maxx,
+				       tile->frame_maxy, tile->tolerance,
+				       tile->tolerance);
+		rl2_destroy_geometry (full);
+		if (clipped == NULL)
+		    continue;
+		if (sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+		  {
+		      id = sqlite3_column_int64 (stmt, 0);
+		      if (id >= 0)
+			  has_id = 1;
+		  }
+
+		/* encoding the attributes */
+		tags.count = 0;
+		for (i = 0; i < layer->n_keys; i++)
+		  {
+		      int idx = mvt_find_value (layer, stmt, i + 2);
+		      if (idx < 0)
+			  continue;
+		      mvt_ints_push (&tags, i);
+		      mvt_ints_push (&tags, idx);
+		  }
+
+		/* encoding the Geometry (one Feature for each geometry class) */
+		pts = mvt_alloc_points (clipped);
+		if (pts == NULL)
+		  {
+		      rl2_destroy_geometry (clipped);
+		      goto error;
+		  }
+		geom.count = 0;
+		if (mvt_encode_points (tile, clipped, &geom))
+		    mvt_add_feature (layer, id, has_id, &tags, RL2_MVT_POINT,
+				     &geom);
+		geom.count = 0;
+		if (mvt_encode_lines (tile, clipped, pts, &geom))
+		    mvt_add_feature (layer, id, has_id, &tags,
+				     RL2_MVT_LINESTRING, &geom);
+		geom.count = 0;
+		if (mvt_encode_polygons (tile, clipped, pts, &geom))
+		    mvt_add_feature (layer, id, has_id, &tags, RL2_MVT_POLYGON,
+				     &geom);
+		free (pts);
+		rl2_destroy_geometry (clipped);
+		if (tags.error || geom.error || layer->features.error)
+		    goto error;
+	    }
+	  else
+	    {
+		fprintf (stderr, "SQL error: %s\n%s\n", sql,
+			 sqlite3_errmsg (handle));
+		goto error;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    if (tags.values != NULL)
+	free (tags.values);
+    if (geom.values != NULL)
+	free (geom.values);
+    return 1;
+
+  error:
+    sqlite3_finalize (stmt);
+    if (tags.values != NULL)
+	free (tags.values);
+    if (geom.values != NULL)
+	free (geom.values);
+    return 0;
+}
+
+static int
+mvt_tile_frame (int z, int x, int y, double *minx, double *miny,
+		    double *maxx, double *maxy)
+{
+/* computing the EPSG:3857 extent of some XYZ Tile */
+    double size;
+    int n;
+    if (z < 0 || z > 30)
+	return 0;
+    n = 1 << z;
+    if (x < 0 || x >= n || y < 0 || y >= n)
+	return 0;
+    size = (RL2_MVT_WORLD_EXTENT * 2.0) / (double) n;
+    *minx = (0.0 - RL2_MVT_WORLD_EXTENT) + ((double) x * size);
+    *maxx = *minx + size;
+    *maxy = RL2_MVT_WORLD_EXTENT - ((double) y * size);
+    *miny = *maxy - size;
+    return 1;
+}
+
+RL2_DECLARE int
+rl2_vector_tile_blob (sqlite3 * handle, const char *db_prefix,
+		      const char *cvg_name, int z, int x, int y, int extent,
+		      int buffer, unsigned char **blob, int *blob_size)
+{
+/* encoding a Mapbox Vector Tile from some Vector Coverage */
+    rl2VectorMultiLayerPtr multi = NULL;
+    struct mvt_tile tile;
+    struct mvt_buffer out;
+    char **columns = NULL;
+    int n_columns = 0;
+    int is_topogeo = 0;
+    int j;
+    double buf_x;
+    double buf_y;
+
+    *blob = NULL;
+    *blob_size = 0;
+    if (cvg_name == NULL)
+	return RL2_ERROR;
+    if (extent < 1 || buffer < 0 || buffer > extent)
+	return RL2_ERROR;
+    if (!mvt_tile_frame
+	(z, x, y, &(tile.minx), &(tile.miny), &(tile.maxx), &(tile.maxy)))
+	return RL2_ERROR;
+    tile.extent = extent;
+    tile.scale_x = (double) extent / (tile.maxx - tile.minx);
+    tile.scale_y = (double) extent / (tile.maxy - tile.miny);
+    buf_x = (double) buffer / tile.scale_x;
+    buf_y = (double) buffer / tile.scale_y;
+    tile.frame_minx = tile.minx - buf_x;
+    tile.frame_miny = tile.miny - buf_y;
+    tile.frame_maxx = tile.maxx + buf_x;
+    tile.frame_maxy = tile.maxy + buf_y;
+/* vertices closer than half a grid cell will collapse anyway */
+    tile.tolerance = 0.5 / tile.scale_x;
+
+    multi = rl2_create_vector_layer_from_dbms (handle, db_prefix, cvg_name);
+    if (multi == NULL)
+	return RL2_ERROR;
+    rl2_is_multilayer_topogeo (multi, &is_topogeo);
+    columns = mvt_style_columns (handle, db_prefix, cvg_name, &n_columns);
+
+    mvt_buffer_init (&out);
+    for (j = 0; j < rl2_get_multilayer_count (multi); j++)
+      {
+	  /* looping on MultiLayer individual Layers */
+	  rl2VectorLayerPtr layer = rl2_get_multilayer_item (multi, j);
+	  rl2PrivVectorLayerPtr lyr;
+	  struct mvt_layer *mvt;
+	  const char *table;
+	  const char *name;
+	  char **keys;
+	  int n_keys;
+	  char *sql;
+	  int visible = 0;
+	  int ok;
+	  if (layer == NULL)
+	      continue;
+	  if (rl2_is_vector_visible (layer, &visible) != RL2_OK)
+	      visible = 0;
+	  if (!visible)
+	      continue;
+	  lyr = (rl2PrivVectorLayerPtr) layer;
+	  table = (lyr->view_name != NULL) ? lyr->view_name : lyr->f_table_name;
+	  if (rl2_get_multilayer_count (multi) > 1)
+	      name = lyr->f_table_name;
+	  else
+	      name = cvg_name;
+	  keys =
+	      mvt_layer_keys (handle, db_prefix, table, columns, n_columns,
+			      &n_keys);
+	  mvt = mvt_create_layer (name, extent, keys, n_keys);
+	  if (mvt == NULL)
+	    {
+		mvt_destroy_keys (keys, n_keys);
+		goto error;
+	    }
+	  sql =
+	      mvt_layer_query (handle, db_prefix, lyr, is_topogeo, keys, n_keys,
+			       &tile);
+	  ok = mvt_fetch_layer (handle, mvt, sql, &tile);
+	  sqlite3_free (sql);
+	  if (!ok)
+	    {
+		mvt_destroy_layer (mvt);
+		goto error;
+	    }
+	  if (mvt->n_features > 0)
+	      mvt_encode_layer (&out, mvt);
+	  mvt_destroy_layer (mvt);
+	  if (out.error)
+	      goto error;
+      }
+    rl2_destroy_multi_layer (multi);
+    mvt_destroy_keys (columns, n_columns);
+
+    if (out.size == 0)
+      {
+	  /* an empty Tile is a perfectly valid (zero length) MVT */
+	  out.buf = malloc (1);
+	  if (out.buf == NULL)
+	      return RL2_ERROR;
+      }
+    *blob = out.buf;
+    *blob_size = out.size;
+    return RL2_OK;
+
+  error:
+    mvt_buffer_reset (&out);
+    rl2_destroy_multi_layer (multi);
+    mvt_destroy_keys (columns, n_columns);
+    return RL2_ERROR;
+}
@@ -292,6 +292,8 @@ rl2_graph_create_context (const void *priv_data, int width, int height)
 
     do_initialize_context (ctx);
     ctx->labeling = &(cache->labeling);
+    ctx->text_cache = cache->text_cache;
+    ctx->font_key = NULL;
     if (ctx->labeling != NULL)
 	do_cleanup_advanced_labeling (ctx->labeling);
 
@@ -398,6 +400,8 @@ rl2_graph_create_context_rgba (const void *priv_data, int width, int height,
 
     do_initialize_context (ctx);
     ctx->labeling = &(cache->labeling);
+    ctx->text_cache = cache->text_cache;
+    ctx->font_key = NULL;
     return (rl2GraphicsContextPtr) ctx;
   error2:
     cairo_destroy (ctx->cairo);
@@ -458,6 +462,8 @@ rl2_graph_destroy_context (rl2GraphicsContextPtr context)
     RL2GraphContextPtr ctx = (RL2GraphContextPtr) context;
     if (ctx == NULL)
 	return;
+    if (ctx->font_key != NULL)
+	sqlite3_free (ctx->font_key);
     if (ctx->type == RL2_SURFACE_SVG)
 	destroy_svg_context (ctx);
     else if (ctx->type == RL2_SURFACE_PDF)
@@ -535,6 +541,8 @@ rl2_graph_create_svg_context (const void *priv_data, const char *path,
     ctx->halo_blue = 1.0;
     ctx->halo_alpha = 1.0;
     ctx->labeling = &(cache->labeling);
+    ctx->text_cache = cache->text_cache;
+    ctx->font_key = NULL;
     return (rl2GraphicsContextPtr) ctx;
   error2:
     cairo_destroy (ctx->cairo);
@@ -635,6 +643,8 @@ rl2_graph_create_pdf_context (const void *priv_data, const char *path, int dpi,
     ctx->halo_blue = 1.0;
     ctx->halo_alpha = 1.0;
     ctx->labeling = &(cache->labeling);
+    ctx->text_cache = cache->text_cache;
+    ctx->font_key = NULL;
     return (rl2GraphicsContextPtr) ctx;
   error4:
     cairo_destroy (ctx->clip_cairo);
@@ -782,6 +792,8 @@ rl2_graph_create_mem_pdf_context (const void *priv_data, rl2MemPdfPtr mem_pdf,
     ctx->halo_blue = 1.0;
     ctx->halo_alpha = 1.0;
     ctx->labeling = &(cache->labeling);
+    ctx->text_cache = cache->text_cache;
+    ctx->font_key = NULL;
     return (rl2GraphicsContextPtr) ctx;
   error4:
     cairo_destroy (ctx->clip_cairo);
@@ -1285,6 +1297,7 @@ rl2_graph_set_font (rl2GraphicsContextPtr context, rl2GraphicsFontPtr font)
     int style = CAIRO_FONT_SLANT_NORMAL;
     int weight = CAIRO_FONT_WEIGHT_NORMAL;
     double size;
+    const char *facename = NULL;
     RL2GraphFontPtr fnt = (RL2GraphFontPtr) font;
     RL2GraphContextPtr ctx = (RL2GraphContextPtr) context;
 
@@ -1340,6 +1353,18 @@ rl2_graph_set_font (rl2GraphicsContextPtr context, rl2GraphicsFontPtr font)
 	  cairo_set_scaled_font (cairo, fnt->cairo_scaled_font);
       }
 
+/* identifying the current font for the Text Cache */
+    if (ctx->font_key != NULL)
+	sqlite3_free (ctx->font_key);
+    ctx->font_key = NULL;
+    if (fnt->toy_font)
+	facename = fnt->facename;
+    else if (fnt->tt_font != NULL)
+	facename = fnt->tt_font->facename;
+    if (facename != NULL)
+	ctx->font_key =
+	    sqlite3_mprintf ("%d|%s|%d|%d|%1.6f", fnt->toy_font, facename,
+			     fnt->style, fnt->weight, size);
     return 1;
 }
 
@@ -2042,6 +2067,9 @@ rl2_graph_release_font (rl2GraphicsContextPtr context)
     cairo_select_font_face (cairo, "", CAIRO_FONT_SLANT_NORMAL,
 			    CAIRO_FONT_WEIGHT_NORMAL);
     cairo_set_font_size (cairo, 10.0);
+    if (ctx->font_key != NULL)
+	sqlite3_free (ctx->font_key);
+    ctx->font_key = NULL;
     return 1;
 }
 
@@ -2559,6 +2587,329 @@ rl2_graph_fill_path (rl2GraphicsContextPtr context, int preserve)
     return 1;
 }
 
+RL2_PRIVATE struct rl2_text_cache *
+rl2_alloc_text_cache (void)
+{
+/* allocating an empty Text Cache (shaped glyph runs) */
+    int i;
+    struct rl2_text_cache *cache = malloc (sizeof (struct rl2_text_cache));
+    if (cache == NULL)
+	return NULL;
+    cache->mutex = sqlite3_mutex_alloc (SQLITE_MUTEX_FAST);
+    cache->count = 0;
+    cache->max_runs = RL2_TEXT_CACHE_MAX_RUNS;
+    cache->hits = 0;
+    cache->misses = 0;
+    for (i = 0; i < RL2_TEXT_CACHE_BUCKETS; i++)
+	cache->buckets[i] = NULL;
+    cache->first = NULL;
+    cache->last = NULL;
+    return cache;
+}
+
+static void
+destroy_text_run (struct rl2_text_run *run)
+{
+/* memory cleanup - destroying a cached Text Run */
+    if (run == NULL)
+	return;
+    if (run->font_key != NULL)
+	free (run->font_key);
+    if (run->text != NULL)
+	free (run->text);
+    if (run->glyphs != NULL)
+	cairo_glyph_free (run->glyphs);
+    free (run);
+}
+
+RL2_PRIVATE void
+rl2_destroy_text_cache (struct rl2_text_cache *cache)
+{
+/* memory cleanup - destroying the Text Cache */
+    struct rl2_text_run *run;
+    struct rl2_text_run *run_n;
+    if (cache == NULL)
+	return;
+    run = cache->first;
+    while (run != NULL)
+      {
+	  run_n = run->next;
+	  destroy_text_run (run);
+	  run = run_n;
+      }
+    if (cache->mutex != NULL)
+	sqlite3_mutex_free ((sqlite3_mutex *) (cache->mutex));
+    free (cache);
+}
+
+static void
+text_cache_lock (struct rl2_text_cache *cache)
+{
+/* locking the Text Cache */
+    if (cache->mutex != NULL)
+	sqlite3_mutex_enter ((sqlite3_mutex *) (cache->mutex));
+}
+
+static void
+text_cache_unlock (struct rl2_text_cache *cache)
+{
+/* unlocking the Text Cache */
+    if (cache->mutex != NULL)
+	sqlite3_mutex_leave ((sqlite3_mutex *) (cache->mutex));
+}
+
+static struct rl2_text_cache *
+get_text_cache (const void *priv_data)
+{
+/* returning the Text Cache from some Private Data */
+    struct rl2_private_data *cache = (struct rl2_private_data *) priv_data;
+    if (cache == NULL)
+	return NULL;
+    return cache->text_cache;
+}
+
+RL2_PRIVATE int
+rl2_get_text_cache_stats (const void *priv_data, int *runs, int *hits,
+			  int *misses)
+{
+/* retrieving the Text Cache statistics */
+    struct rl2_text_cache *cache = get_text_cache (priv_data);
+    if (cache == NULL)
+	return 0;
+    text_cache_lock (cache);
+    *runs = cache->count;
+    *hits = cache->hits;
+    *misses = cache->misses;
+    text_cache_unlock (cache);
+    return 1;
+}
+
+RL2_PRIVATE void
+rl2_reset_text_cache_stats (const void *priv_data)
+{
+/* resetting the Text Cache hit and miss counters (cached Runs are kept) */
+    struct rl2_text_cache *cache = get_text_cache (priv_data);
+    if (cache == NULL)
+	return;
+    text_cache_lock (cache);
+    cache->hits = 0;
+    cache->misses = 0;
+    text_cache_unlock (cache);
+}
+
+static unsigned int
+text_cache_hash (const char *font_key, const char *text)
+{
+/* FNV-1a hash of Font key + Text */
+    unsigned int hash = 2166136261u;
+    const unsigned char *p = (const unsigned char *) font_key;
+    while (*p != '\0')
+      {
+	  hash ^= *p++;
+	  hash *= 16777619u;
+      }
+    hash ^= 0xff;
+    hash *= 16777619u;
+    p = (const unsigned char *) text;
+    while (*p != '\0')
+      {
+	  hash ^= *p++;
+	  hash *= 16777619u;
+      }
+    return hash;
+}
+
+static void
+text_cache_unlink (struct rl2_text_cache *cache, struct rl2_text_run *run)
+{
+/* removing a Text Run from the LRU list */
+    if (run->prev != NULL)
+	run->prev->next = run->next;
+    else
+	cache->first = run->next;
+    if (run->next != NULL)
+	run->next->prev = run->prev;
+    else
+	cache->last = run->prev;
+    run->prev = NULL;
+    run->next = NULL;
+}
+
+static void
+text_cache_push_front (struct rl2_text_cache *cache, struct rl2_text_run *run)
+{
+/* inserting a Text Run as the most recently used one */
+    run->prev = NULL;
+    run->next = cache->first;
+    if (cache->first != NULL)
+	cache->first->prev = run;
+    cache->first = run;
+    if (cache->last == NULL)
+	cache->last = run;
+}
+
+static struct rl2_text_run *
+text_cache_find (struct rl2_text_cache *cache, unsigned int hash,
+		 const char *font_key, const char *text)
+{
+/* searching a Text Run into the Text Cache */
+    struct rl2_text_run *run =
+	cache->buckets[hash % RL2_TEXT_CACHE_BUCKETS];
+    while (run != NULL)
+      {
+	  if (run->hash == hash && strcmp (run->font_key, font_key) == 0
+	      && strcmp (run->text, text) == 0)
+	      return run;
+	  run = run->hash_next;
+      }
+    return NULL;
+}
+
+static void
+text_cache_evict (struct rl2_text_cache *cache)
+{
+/* discarding the least recently used Text Run */
+    struct rl2_text_run **pp;
+    struct rl2_text_run *run = cache->last;
+    if (run == NULL)
+	return;
+    text_cache_unlink (cache, run);
+    pp = &(cache->buckets[run->hash % RL2_TEXT_CACHE_BUCKETS]);
+    while (*pp != NULL)
+      {
+	  if (*pp == run)
+	    {
+		*pp = run->hash_next;
+		break;
+	    }
+	  pp = &((*pp)->hash_next);
+      }
+    destroy_text_run (run);
+    cache->count -= 1;
+}
+
+static cairo_glyph_t *
+text_run_copy_glyphs (struct rl2_text_run *run)
+{
+/* returning a private copy of the Glyphs of some Text Run */
+    cairo_glyph_t *glyphs;
+    if (run->num_glyphs <= 0)
+	return NULL;
+    glyphs = malloc (sizeof (cairo_glyph_t) * run->num_glyphs);
+    if (glyphs == NULL)
+	return NULL;
+    memcpy (glyphs, run->glyphs, sizeof (cairo_glyph_t) * run->num_glyphs);
+    return glyphs;
+}
+
+static int
+do_fetch_text_run (RL2GraphContextPtr ctx, cairo_t * cairo, const char *text,
+		   cairo_text_extents_t * extents, cairo_glyph_t ** glyphs,
+		   int *num_glyphs)
+{
+/*
+/ retrieving the Extents (and optionally the Glyphs) of some Text
+/ string using the current Font
+/
+/ shaping only happens the first time a given Font/Text pair is
+/ seen; later requests are resolved by the shared Text Cache.
+/ the Glyphs are always returned as a private copy (to be freed
+/ by the caller), so to never hold the lock while drawing
+*/
+    struct rl2_text_cache *cache = ctx->text_cache;
+    struct rl2_text_run *run;
+    struct rl2_text_run *old;
+    cairo_scaled_font_t *scaled_font;
+    cairo_glyph_t *new_glyphs = NULL;
+    int new_num_glyphs = 0;
+    unsigned int hash;
+
+    if (glyphs != NULL)
+	*glyphs = NULL;
+    if (num_glyphs != NULL)
+	*num_glyphs = 0;
+    if (cache == NULL || ctx->font_key == NULL || text == NULL)
+	return 0;
+    hash = text_cache_hash (ctx->font_key, text);
+
+    text_cache_lock (cache);
+    run = text_cache_find (cache, hash, ctx->font_key, text);
+    if (run != NULL)
+      {
+	  /* cache hit */
+	  cache->hits += 1;
+	  text_cache_unlink (cache, run);
+	  text_cache_push_front (cache, run);
+	  *extents = run->extents;
+	  if (glyphs != NULL)
+	    {
+		*glyphs = text_run_copy_glyphs (run);
+		*num_glyphs = run->num_glyphs;
+	    }
+	  text_cache_unlock (cache);
+	  if (glyphs != NULL && *glyphs == NULL && *num_glyphs > 0)
+	      return 0;
+	  return 1;
+      }
+    text_cache_unlock (cache);
+
+/* cache miss: shaping the Text string */
+    scaled_font = cairo_get_scaled_font (cairo);
+    if (cairo_scaled_font_status (scaled_font) != CAIRO_STATUS_SUCCESS)
+	return 0;
+    if (cairo_scaled_font_text_to_glyphs
+	(scaled_font, 0.0, 0.0, text, -1, &new_glyphs, &new_num_glyphs,
+	 NULL, NULL, NULL) != CAIRO_STATUS_SUCCESS)
+	return 0;
+    run = malloc (sizeof (struct rl2_text_run));
+    if (run == NULL)
+      {
+	  cairo_glyph_free (new_glyphs);
+	  return 0;
+      }
+    run->font_key = malloc (strlen (ctx->font_key) + 1);
+    strcpy (run->font_key, ctx->font_key);
+    run->text = malloc (strlen (text) + 1);
+    strcpy (run->text, text);
+    run->hash = hash;
+    run->glyphs = new_glyphs;
+    run->num_glyphs = new_num_glyphs;
+    cairo_glyph_extents (cairo, new_glyphs, new_num_glyphs, &(run->extents));
+    run->hash_next = NULL;
+    run->prev = NULL;
+    run->next = NULL;
+    *extents = run->extents;
+    if (glyphs != NULL)
+      {
+	  *glyphs = text_run_copy_glyphs (run);
+	  *num_glyphs = run->num_glyphs;
+      }
+
+/* inserting into the Text Cache */
+    text_cache_lock (cache);
+    cache->misses += 1;
+    old = text_cache_find (cache, hash, ctx->font_key, text);
+    if (old != NULL)
+      {
+	  /* already inserted by some concurrent thread */
+	  text_cache_unlock (cache);
+	  destroy_text_run (run);
+      }
+    else
+      {
+	  run->hash_next = cache->buckets[hash % RL2_TEXT_CACHE_BUCKETS];
+	  cache->buckets[hash % RL2_TEXT_CACHE_BUCKETS] = run;
+	  text_cache_push_front (cache, run);
+	  cache->count += 1;
+	  while (cache->count > cache->max_runs)
+	      text_cache_evict (cache);
+	  text_cache_unlock (cache);
+      }
+    if (glyphs != NULL && *glyphs == NULL && *num_glyphs > 0)
+	return 0;
+    return 1;
+}
+
 RL2_DECLARE int
 rl2_graph_get_text_extent (rl2GraphicsContextPtr context, const char *text,
 			   double *pre_x, double *pre_y, double *width,
@@ -2578,7 +2929,8 @@ rl2_graph_get_text_extent (rl2GraphicsContextPtr context, const char *text,
     else
 	cairo = ctx->cairo;
 
-    cairo_text_extents (cairo, text, &extents);
+    if (!do_fetch_text_run (ctx, cairo, text, &extents, NULL, NULL))
+	cairo_text_extents (cairo, text, &extents);
     *pre_x = extents.x_bearing;
     *pre_y = extents.y_bearing;
     *width = extents.width;
@@ -2823,6 +3175,10 @@ draw_text_common (rl2GraphicsContextPtr context, const char *text,
     double cx;
     double cy;
     cairo_t *cairo;
+    cairo_text_extents_t extents;
+    cairo_glyph_t *glyphs = NULL;
+    int num_glyphs = 0;
+    int cached;
     int anti_collision = 0;
     RL2GraphContextPtr ctx = (RL2GraphContextPtr) context;
 
@@ -2838,8 +3194,20 @@ draw_text_common (rl2GraphicsContextPtr context, const char *text,
     else
 	cairo = ctx->cairo;
 
-    rl2_graph_get_text_extent (ctx, text, &pre_x, &pre_y, &width, &height,
-			       &post_x, &post_y);
+    cached =
+	do_fetch_text_run (ctx, cairo, text, &extents, &glyphs, &num_glyphs);
+    if (cached)
+      {
+	  pre_x = extents.x_bearing;
+	  pre_y = extents.y_bearing;
+	  width = extents.width;
+	  height = extents.height;
+	  post_x = extents.x_advance;
+	  post_y = extents.y_advance;
+      }
+    else
+	rl2_graph_get_text_extent (ctx, text, &pre_x, &pre_y, &width, &height,
+				   &post_x, &post_y);
     if (anti_collision)
       {
 	  int ret;
@@ -2849,7 +3217,11 @@ draw_text_common (rl2GraphicsContextPtr context, const char *text,
 	  const char *sql = "SELECT ST_Intersects(?, ?)";
 	  ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
 	  if (ret != SQLITE_OK)
-	      return 0;
+	    {
+		if (glyphs != NULL)
+		    free (glyphs);
+		return 0;
+	    }
 	  real_intersection =
 	      do_check_collision (ctx->labeling, stmt, x, y, angle,
 				  anchor_point_x, anchor_point_y, pre_x,
@@ -2857,7 +3229,11 @@ draw_text_common (rl2GraphicsContextPtr context, const char *text,
 				  1, pre_checked);
 	  sqlite3_finalize (stmt);
 	  if (real_intersection)
-	      return 1;
+	    {
+		if (glyphs != NULL)
+		    free (glyphs);
+		return 1;
+	    }
       }
 
 /* setting the Anchor Point */
@@ -2876,6 +3252,35 @@ draw_text_common (rl2GraphicsContextPtr context, const char *text,
     cairo_translate (cairo, x, y);
     rads = angle * .0174532925199432958;
     cairo_rotate (cairo, rads);
+    if (cached)
+      {
+	  /* drawing the cached Glyph Run */
+	  cairo_translate (cairo, cx, cy);
+	  if (ctx->with_font_halo)
+	    {
+		/* font with Halo */
+		cairo_new_path (cairo);
+		cairo_glyph_path (cairo, glyphs, num_glyphs);
+		cairo_set_source_rgba (cairo, ctx->font_red, ctx->font_green,
+				       ctx->font_blue, ctx->font_alpha);
+		cairo_fill_preserve (cairo);
+		cairo_set_source_rgba (cairo, ctx->halo_red, ctx->halo_green,
+				       ctx->halo_blue, ctx->halo_alpha);
+		cairo_set_line_width (cairo, ctx->halo_radius);
+		cairo_stroke (cairo);
+	    }
+	  else
+	    {
+		/* no Halo */
+		cairo_set_source_rgba (cairo, ctx->font_red, ctx->font_green,
+				       ctx->font_blue, ctx->font_alpha);
+		cairo_show_glyphs (cairo, glyphs, num_glyphs);
+	    }
+	  cairo_restore (cairo);
+	  if (glyphs != NULL)
+	      free (glyphs);
+	  return 1;
+      }
     if (ctx->with_font_halo)
       {
 	  /* font with Halo */
@@ -4625,6 +5030,106 @@ rl2_graph_merge (rl2GraphicsContextPtr context_out,
     return RL2_OK;
 }
 
+RL2_PRIVATE void *
+rl2_graph_create_band_context (void *context, int band_y, int band_height)
+{
+/*
+/ creating a Graphics Context covering an horizontal band of an Image
+/ Context; the band directly shares the pixel rows of the full Image,
+/ so painting on it is exactly the same of painting on the full Image
+/ (all drawing coordinates are unchanged, rows out of the band are
+/ simply discarded)
+/
+/ disjoint bands never touch the same memory, so they can be safely
+/ painted by concurrent threads; a band never touches Advanced
+/ Labeling: it is intended for painting geometries, not labels
+*/
+    RL2GraphContextPtr ref = (RL2GraphContextPtr) context;
+    RL2GraphContextPtr ctx;
+    unsigned char *data;
+    int width;
+    int height;
+    int stride;
+
+    if (ref == NULL)
+	return NULL;
+    if (ref->type != RL2_SURFACE_IMG)
+	return NULL;
+    if (cairo_image_surface_get_format (ref->surface) != CAIRO_FORMAT_ARGB32)
+	return NULL;
+    width = cairo_image_surface_get_width (ref->surface);
+    height = cairo_image_surface_get_height (ref->surface);
+    if (band_y < 0 || band_height <= 0 || band_y + band_height > height)
+	return NULL;
+    cairo_surface_flush (ref->surface);
+    data = cairo_image_surface_get_data (ref->surface);
+    stride = cairo_image_surface_get_stride (ref->surface);
+    if (data == NULL)
+	return NULL;
+
+    ctx = malloc (sizeof (RL2GraphContext));
+    if (!ctx)
+	return NULL;
+
+    ctx->type = RL2_SURFACE_IMG;
+    ctx->clip_surface = NULL;
+    ctx->clip_cairo = NULL;
+    ctx->surface =
+	cairo_image_surface_create_for_data (data + (band_y * stride),
+					     CAIRO_FORMAT_ARGB32, width,
+					     band_height, stride);
+    if (cairo_surface_status (ctx->surface) == CAIRO_STATUS_SUCCESS)
+	;
+    else
+	goto error1;
+/* shifting the origin to the top of the band */
+    cairo_surface_set_device_offset (ctx->surface, 0.0, 0.0 - band_y);
+    ctx->cairo = cairo_create (ctx->surface);
+    if (cairo_status (ctx->cairo) == CAIRO_STATUS_NO_MEMORY)
+	goto error2;
+
+    do_initialize_context (ctx);
+    ctx->labeling = NULL;
+    ctx->text_cache = ref->text_cache;
+    ctx->font_key = NULL;
+    return ctx;
+
+  error2:
+    cairo_destroy (ctx->cairo);
+    cairo_surface_destroy (ctx->surface);
+    free (ctx);
+    return NULL;
+  error1:
+    cairo_surface_destroy (ctx->surface);
+    free (ctx);
+    return NULL;
+}
+
+RL2_PRIVATE int
+rl2_graph_merge_band (void *context_out, void *band, int band_y)
+{
+/*
+/ completing an horizontal band: its pixels already belong to the
+/ full Image, that simply has to be notified about the changes
+*/
+    RL2GraphContextPtr ctx_in = (RL2GraphContextPtr) band;
+    RL2GraphContextPtr ctx_out = (RL2GraphContextPtr) context_out;
+    int width;
+    int height;
+
+    if (ctx_in == NULL || ctx_out == NULL)
+	return RL2_ERROR;
+    width = cairo_image_surface_get_width (ctx_in->surface);
+    height = cairo_image_surface_get_height (ctx_in->surface);
+    if (width != cairo_image_surface_get_width (ctx_out->surface))
+	return RL2_ERROR;
+
+    cairo_surface_flush (ctx_in->surface);
+    cairo_surface_mark_dirty_rectangle (ctx_out->surface, 0, band_y, width,
+					height);
+    return RL2_OK;
+}
+
 RL2_DECLARE unsigned char *
 rl2_graph_get_context_rgba_array (rl2GraphicsContextPtr context)
 {
@@ -5477,6 +5982,8 @@ rl2_create_vector_canvas (rl2GraphicsContextPtr ref_ctx)
     canvas->ctx_edge_seeds_ready = RL2_FALSE;
     canvas->ctx_link_seeds_ready = RL2_FALSE;
     canvas->ctx_face_seeds_ready = RL2_FALSE;
+    canvas->retain_labels = 0;
+    canvas->labels = NULL;
     return (rl2CanvasPtr) canvas;
 }
 
@@ -5516,6 +6023,8 @@ rl2_create_topology_canvas (rl2GraphicsContextPtr ref_ctx,
     canvas->ctx_edge_seeds_ready = RL2_FALSE;
     canvas->ctx_link_seeds_ready = RL2_FALSE;
     canvas->ctx_face_seeds_ready = RL2_FALSE;
+    canvas->retain_labels = 0;
+    canvas->labels = NULL;
     return (rl2CanvasPtr) canvas;
 }
 
@@ -5552,6 +6061,8 @@ rl2_create_network_canvas (rl2GraphicsContextPtr ref_ctx,
     canvas->ctx_edge_seeds_ready = RL2_FALSE;
     canvas->ctx_link_seeds_ready = RL2_FALSE;
     canvas->ctx_face_seeds_ready = RL2_FALSE;
+    canvas->retain_labels = 0;
+    canvas->labels = NULL;
     return (rl2CanvasPtr) canvas;
 }
 
@@ -5583,6 +6094,8 @@ rl2_create_raster_canvas (rl2GraphicsContextPtr ref_ctx)
     canvas->ctx_edge_seeds_ready = RL2_FALSE;
     canvas->ctx_link_seeds_ready = RL2_FALSE;
     canvas->ctx_face_seeds_ready = RL2_FALSE;
+    canvas->retain_labels = 0;
+    canvas->labels = NULL;
     return (rl2CanvasPtr) canvas;
 }
 
@@ -5614,6 +6127,8 @@ rl2_create_wms_canvas (rl2GraphicsContextPtr ref_ctx)
     canvas->ctx_edge_seeds_ready = RL2_FALSE;
     canvas->ctx_link_seeds_ready = RL2_FALSE;
     canvas->ctx_face_seeds_ready = RL2_FALSE;
+    canvas->retain_labels = 0;
+    canvas->labels = NULL;
     return (rl2CanvasPtr) canvas;
 }
 
@@ -5624,9 +6139,39 @@ rl2_destroy_canvas (rl2CanvasPtr ptr)
     rl2PrivCanvasPtr canvas = (rl2PrivCanvasPtr) ptr;
     if (canvas == NULL)
 	return;
+    if (canvas->labels != NULL)
+	rl2_destroy_label_candidates ((rl2LabelCandidatesPtr) (canvas->labels));
     free (canvas);
 }
 
+RL2_PRIVATE int
+rl2_set_canvas_retain_labels (rl2CanvasPtr ptr, int retain)
+{
+/* enabling or disabling the retention of Label candidates */
+    rl2PrivCanvasPtr canvas = (rl2PrivCanvasPtr) ptr;
+    if (canvas == NULL)
+	return RL2_ERROR;
+    canvas->retain_labels = (retain) ? 1 : 0;
+    return RL2_OK;
+}
+
+RL2_PRIVATE void
+rl2_move_canvas_labels (rl2CanvasPtr from, rl2CanvasPtr to)
+{
+/*
+/ handing over all retained Label candidates from a Canvas to another
+/ (any candidate already retained by the target Canvas is discarded)
+*/
+    rl2PrivCanvasPtr in = (rl2PrivCanvasPtr) from;
+    rl2PrivCanvasPtr out = (rl2PrivCanvasPtr) to;
+    if (in == NULL || out == NULL || in == out)
+	return;
+    if (out->labels != NULL)
+	rl2_destroy_label_candidates ((rl2LabelCandidatesPtr) (out->labels));
+    out->labels = in->labels;
+    in->labels = NULL;
+}
+
 RL2_DECLARE int
 rl2_get_canvas_type (rl2CanvasPtr ptr)
 {
@@ -0,0 +1,364 @@
+/*
+
+ rl2perf -- per-stage performance counters and tracing hooks
+
+ version 0.1, 2026 October 18
+
+ Author: Sandro Furieri a.furieri@lqt.it
+
+ -----------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2026
+the Initial Developer. All Rights Reserved.
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "config.h"
+
+#ifdef LOADABLE_EXTENSION
+#include "rasterlite2/sqlite.h"
+#endif
+
+#include "rasterlite2/rasterlite2.h"
+#include "rasterlite2_private.h"
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+#define RL2_THREAD_LOCAL __declspec(thread)
+#else
+#define RL2_THREAD_LOCAL __thread
+#endif
+
+/* 
+/ the Performance Counters currently attached to the calling thread
+/ (NULL when the thread isn't servicing any instrumented request)
+*/
+static RL2_THREAD_LOCAL struct rl2_perf_counters *rl2_thread_perf = NULL;
+
+static const char *rl2_perf_stage_names[RL2_PERF_MAX_STAGES] = {
+    "tile_query", "blob_fetch", "decode", "pixel_copy", "render",
+    "symbolize", "raster_encode", "image_encode", "tile_insert"
+};
+
+static double
+perf_now (void)
+{
+/* returns a monotonic timestamp (in seconds) */
+#if defined(_WIN32)
+    LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+    QueryPerformanceFrequency (&freq);
+    QueryPerformanceCounter (&count);
+    return (double) (count.QuadPart) / (double) (freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (double) (ts.tv_sec) + ((double) (ts.tv_nsec) / 1000000000.0);
+#endif
+}
+
+static void
+perf_lock (struct rl2_perf_counters *perf)
+{
+/* locking the Performance Counters */
+    if (perf->mutex != NULL)
+	sqlite3_mutex_enter ((sqlite3_mutex *) (perf->mutex));
+}
+
+static void
+perf_unlock (struct rl2_perf_counters *perf)
+{
+/* unlocking the Performance Counters */
+    if (perf->mutex != NULL)
+	sqlite3_mutex_leave ((sqlite3_mutex *) (perf->mutex));
+}
+
+static void
+perf_clear_stages (struct rl2_perf_stage *stages)
+{
+/* resetting an array of Stage counters */
+    int i;
+    for (i = 0; i < RL2_PERF_MAX_STAGES; i++)
+      {
+	  struct rl2_perf_stage *stage = stages + i;
+	  stage->count = 0;
+	  stage->bytes = 0;
+	  stage->seconds = 0.0;
+      }
+}
+
+RL2_PRIVATE struct rl2_perf_counters *
+rl2_alloc_perf_counters (void)
+{
+/* allocating an empty set of Performance Counters */
+    struct rl2_perf_counters *perf =
+	malloc (sizeof (struct rl2_perf_counters));
+    if (perf == NULL)
+	return NULL;
+    perf->mutex = sqlite3_mutex_alloc (SQLITE_MUTEX_FAST);
+    perf->requests = 0;
+    perf->request_seconds = 0.0;
+    perf_clear_stages (perf->stages);
+    perf->depth = 0;
+    perf->request_name = NULL;
+    perf->request_start = 0.0;
+    perf_clear_stages (perf->snapshot);
+    perf->callback = NULL;
+    perf->callback_data = NULL;
+    return perf;
+}
+
+RL2_PRIVATE void
+rl2_destroy_perf_counters (struct rl2_perf_counters *perf)
+{
+/* destroying a set of Performance Counters */
+    if (perf == NULL)
+	return;
+    if (rl2_thread_perf == perf)
+	rl2_thread_perf = NULL;
+    if (perf->mutex != NULL)
+	sqlite3_mutex_free ((sqlite3_mutex *) (perf->mutex));
+    free (perf);
+}
+
+RL2_PRIVATE void
+rl2_reset_perf_counters (struct rl2_perf_counters *perf)
+{
+/* resetting all Performance Counters */
+    if (perf == NULL)
+	return;
+    perf_lock (perf);
+    perf->requests = 0;
+    perf->request_seconds = 0.0;
+    perf_clear_stages (perf->stages);
+    /* any request still in progress will start again from zero */
+    perf_clear_stages (perf->snapshot);
+    perf_unlock (perf);
+}
+
+RL2_PRIVATE char *
+rl2_perf_counters_to_json (struct rl2_perf_counters *perf, int text_runs,
+			   int text_hits, int text_misses)
+{
+/* 
+/ returns a JSON representation of all Performance Counters 
+/ and of the Text Cache statistics
+/ (the returned string is expected to be freed by sqlite3_free)
+*/
+    int i;
+    char *json;
+    char *prev;
+    if (perf == NULL)
+	return NULL;
+
+    perf_lock (perf);
+    json =
+	sqlite3_mprintf
+	("{\"requests\": %lld, \"request_ms\": %1.3f, \"stages\": {",
+	 perf->requests, perf->request_seconds * 1000.0);
+    for (i = 0; i < RL2_PERF_MAX_STAGES; i++)
+      {
+	  struct rl2_perf_stage *stage = perf->stages + i;
+	  prev = json;
+	  json =
+	      sqlite3_mprintf
+	      ("%s%s\"%s\": {\"count\": %lld, \"ms\": %1.3f, \"bytes\": %lld}",
+	       prev, (i == 0) ? "" : ", ", rl2_perf_stage_names[i],
+	       stage->count, stage->seconds * 1000.0, stage->bytes);
+	  sqlite3_free (prev);
+      }
+    perf_unlock (perf);
+    prev = json;
+    json =
+	sqlite3_mprintf
+	("%s}, \"text_cache\": {\"runs\": %d, \"hits\": %d, \"misses\": %d}}",
+	 prev, text_runs, text_hits, text_misses);
+    sqlite3_free (prev);
+    return json;
+}
+
+RL2_PRIVATE struct rl2_perf_counters *
+rl2_perf_get_thread_counters (void)
+{
+/* returns the Performance Counters attached to the calling thread */
+    return rl2_thread_perf;
+}
+
+RL2_PRIVATE void
+rl2_perf_set_thread_counters (struct rl2_perf_counters *perf)
+{
+/* attaching some Performance Counters to the calling thread */
+    rl2_thread_perf = perf;
+}
+
+RL2_PRIVATE double
+rl2_perf_clock (void)
+{
+/* 
+/ starting a timed Stage: returns 0.0 when the calling thread
+/ has no attached Performance Counters (nothing to measure)
+*/
+    if (rl2_thread_perf == NULL)
+	return 0.0;
+    return perf_now ();
+}
+
+RL2_PRIVATE void
+rl2_perf_add (int stage, double start, sqlite3_int64 bytes)
+{
+/* completing a timed Stage started by rl2_perf_clock() */
+    struct rl2_perf_stage *st;
+    double elapsed;
+    struct rl2_perf_counters *perf = rl2_thread_perf;
+    if (perf == NULL || start <= 0.0)
+	return;
+    if (stage < 0 || stage >= RL2_PERF_MAX_STAGES)
+	return;
+
+    elapsed = perf_now () - start;
+    perf_lock (perf);
+    st = perf->stages + stage;
+    st->count += 1;
+    st->bytes += bytes;
+    st->seconds += elapsed;
+    perf_unlock (perf);
+}
+
+RL2_PRIVATE void
+rl2_perf_begin_request (const void *priv_data, const char *request)
+{
+/* starting an instrumented request (span) */
+    struct rl2_perf_counters *perf;
+    struct rl2_private_data *priv = (struct rl2_private_data *) priv_data;
+    if (priv == NULL)
+	return;
+    perf = priv->perf;
+    if (perf == NULL)
+	return;
+
+    perf_lock (perf);
+    if (perf->depth == 0)
+      {
+	  /* outermost request: taking a snapshot of all counters */
+	  perf->request_name = request;
+	  perf->request_start = perf_now ();
+	  memcpy (perf->snapshot, perf->stages,
+		  sizeof (struct rl2_perf_stage) * RL2_PERF_MAX_STAGES);
+      }
+    perf->depth += 1;
+    perf_unlock (perf);
+    rl2_thread_perf = perf;
+}
+
+RL2_PRIVATE void
+rl2_perf_end_request (const void *priv_data)
+{
+/* completing an instrumented request (span) */
+    int i;
+    double elapsed;
+    const char *request;
+    struct rl2_perf_stage delta[RL2_PERF_MAX_STAGES];
+    struct rl2_perf_counters *perf;
+    struct rl2_private_data *priv = (struct rl2_private_data *) priv_data;
+    if (priv == NULL)
+	return;
+    perf = priv->perf;
+    if (perf == NULL)
+	return;
+
+    perf_lock (perf);
+    perf->depth -= 1;
+    if (perf->depth > 0)
+      {
+	  /* still within some outer request */
+	  perf_unlock (perf);
+	  return;
+      }
+    perf->depth = 0;
+    elapsed = perf_now () - perf->request_start;
+    perf->requests += 1;
+    perf->request_seconds += elapsed;
+    request = perf->request_name;
+    for (i = 0; i < RL2_PERF_MAX_STAGES; i++)
+      {
+	  delta[i].count = perf->stages[i].count - perf->snapshot[i].count;
+	  delta[i].bytes = perf->stages[i].bytes - perf->snapshot[i].bytes;
+	  delta[i].seconds =
+	      perf->stages[i].seconds - perf->snapshot[i].seconds;
+      }
+    perf_unlock (perf);
+    rl2_thread_perf = NULL;
+
+    if (perf->callback == NULL)
+	return;
+/* notifying all span events to the user callback */
+    for (i = 0; i < RL2_PERF_MAX_STAGES; i++)
+      {
+	  if (delta[i].count <= 0)
+	      continue;
+	  perf->callback (perf->callback_data, request,
+			  rl2_perf_stage_names[i], (int) (delta[i].count),
+			  delta[i].seconds * 1000.0, delta[i].bytes);
+      }
+    perf->callback (perf->callback_data, request, "request", 1,
+		    elapsed * 1000.0, 0);
+}
+
+RL2_DECLARE int
+rl2_set_perf_callback (const void *ptr,
+		       void (*callback) (void *user_data, const char *request,
+					 const char *stage, int count,
+					 double elapsed_ms,
+					 sqlite3_int64 bytes), void *user_data)
+{
+/* registering (or removing) the user callback receiving span events */
+    struct rl2_perf_counters *perf;
+    struct rl2_private_data *priv = (struct rl2_private_data *) ptr;
+    if (priv == NULL)
+	return RL2_ERROR;
+    perf = priv->perf;
+    if (perf == NULL)
+	return RL2_ERROR;
+    perf_lock (perf);
+    perf->callback = callback;
+    perf->callback_data = user_data;
+    perf_unlock (perf);
+    return RL2_OK;
+}
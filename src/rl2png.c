@@ -46,6 +46,15 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include <string.h>
 
 #include <png.h>
+#include <zlib.h>
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+#include <windows.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#include <pthread.h>
+#endif
 
 #include "config.h"
 
@@ -56,6 +65,12 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include "rasterlite2/rasterlite2.h"
 #include "rasterlite2_private.h"
 
+#if defined(_WIN32) && !defined(__MINGW32__)
+#define RL2_THREAD_LOCAL __declspec(thread)
+#else
+#define RL2_THREAD_LOCAL __thread
+#endif
+
 struct png_memory_buffer
 {
     unsigned char *buffer;
@@ -988,6 +1003,699 @@ check_png_compatibility (unsigned char sample_type, unsigned char pixel_type,
     return RL2_OK;
 }
 
+/*
+/ the PNG encoder options currently attached to the calling thread
+/ (inactive when the thread isn't servicing any Map Image request)
+*/
+static RL2_THREAD_LOCAL int rl2_thread_png_active = 0;
+static RL2_THREAD_LOCAL int rl2_thread_png_level = Z_DEFAULT_COMPRESSION;
+static RL2_THREAD_LOCAL unsigned char rl2_thread_png_filter =
+    RL2_PNG_FILTER_ADAPTIVE;
+static RL2_THREAD_LOCAL int rl2_thread_png_max_threads = 1;
+static RL2_THREAD_LOCAL const void *rl2_thread_png_priv_data = NULL;
+static RL2_THREAD_LOCAL sqlite3 *rl2_thread_png_handle = NULL;
+static RL2_THREAD_LOCAL const char *rl2_thread_png_db_prefix = NULL;
+static RL2_THREAD_LOCAL const char *rl2_thread_png_coverage = NULL;
+static RL2_THREAD_LOCAL const char *rl2_thread_png_style = NULL;
+
+RL2_PRIVATE void
+rl2_png_begin_request (const void *data, sqlite3 * handle,
+		       const char *db_prefix, const char *coverage,
+		       const char *style)
+{
+/* 
+/ attaching the connection's PNG encoder options to the calling thread
+/ Coverage and Style (when not NULL) identify the stable PNG8 Palette
+*/
+    struct rl2_private_data *priv_data = (struct rl2_private_data *) data;
+    if (priv_data == NULL)
+	return;
+    rl2_thread_png_active = 1;
+    rl2_thread_png_level = priv_data->png_level;
+    rl2_thread_png_filter = priv_data->png_filter;
+    rl2_thread_png_max_threads = priv_data->max_threads;
+    rl2_thread_png_priv_data = data;
+    rl2_thread_png_handle = handle;
+    rl2_thread_png_db_prefix = db_prefix;
+    rl2_thread_png_coverage = coverage;
+    rl2_thread_png_style = style;
+}
+
+RL2_PRIVATE void
+rl2_png_end_request (void)
+{
+/* detaching the PNG encoder options from the calling thread */
+    rl2_thread_png_active = 0;
+    rl2_thread_png_level = Z_DEFAULT_COMPRESSION;
+    rl2_thread_png_filter = RL2_PNG_FILTER_ADAPTIVE;
+    rl2_thread_png_max_threads = 1;
+    rl2_thread_png_priv_data = NULL;
+    rl2_thread_png_handle = NULL;
+    rl2_thread_png_db_prefix = NULL;
+    rl2_thread_png_coverage = NULL;
+    rl2_thread_png_style = NULL;
+}
+
+RL2_PRIVATE const void *
+rl2_png_get_request (sqlite3 ** handle, const char **db_prefix,
+		     const char **coverage, const char **style)
+{
+/* returning the Map Image request attached to the calling thread (if any) */
+    *handle = rl2_thread_png_handle;
+    *db_prefix = rl2_thread_png_db_prefix;
+    *coverage = rl2_thread_png_coverage;
+    *style = rl2_thread_png_style;
+    return rl2_thread_png_priv_data;
+}
+
+struct png_stripe_source
+{
+/* the pixel buffers to be encoded */
+    const unsigned char *pixels;
+    const unsigned char *alpha;
+    int real_alpha;
+    unsigned char opacity;
+    unsigned int width;
+    unsigned int height;
+    int in_bands;
+    int out_bands;
+};
+
+struct png_stripe
+{
+/* a horizontal stripe to be independently filtered and deflated */
+    const struct png_stripe_source *src;
+    unsigned int first_row;
+    unsigned int num_rows;
+    int level;
+    unsigned char filter;
+    int last;
+    unsigned char *out;
+    size_t out_size;
+    size_t out_max;
+    uLong adler;
+    uLong raw_len;
+    int retcode;
+    struct rl2_perf_counters *perf;
+    void *opaque_thread_id;
+};
+
+static void
+build_png_stripe_row (const struct png_stripe_source *src, unsigned int row,
+		      unsigned char *out)
+{
+/* building a raw (unfiltered) PNG scanline */
+    unsigned int col;
+    int b;
+    const unsigned char *p_in =
+	src->pixels + ((size_t) row * src->width * src->in_bands);
+    const unsigned char *p_alpha = NULL;
+    if (src->alpha != NULL)
+	p_alpha = src->alpha + ((size_t) row * src->width);
+    for (col = 0; col < src->width; col++)
+      {
+	  for (b = 0; b < src->in_bands; b++)
+	      *out++ = *p_in++;
+	  if (p_alpha != NULL)
+	    {
+		/* ALPHA channel */
+		if (src->real_alpha)
+		    *out++ = *p_alpha++;
+		else if (*p_alpha++ == 0)
+		    *out++ = 0;
+		else
+		    *out++ = src->opacity;
+	    }
+      }
+}
+
+static unsigned char
+png_paeth_predictor (int a, int b, int c)
+{
+/* the PNG Paeth predictor */
+    int p = a + b - c;
+    int pa = abs (p - a);
+    int pb = abs (p - b);
+    int pc = abs (p - c);
+    if (pa <= pb && pa <= pc)
+	return (unsigned char) a;
+    if (pb <= pc)
+	return (unsigned char) b;
+    return (unsigned char) c;
+}
+
+static void
+do_filter_png_row (unsigned char filter, const unsigned char *cur,
+		   const unsigned char *prev, size_t row_bytes, int bpp,
+		   unsigned char *out)
+{
+/* applying a PNG filter to a scanline (the first byte is the filter type) */
+    size_t i;
+    *out++ = filter;
+    for (i = 0; i < row_bytes; i++)
+      {
+	  int a = (i >= (size_t) bpp) ? cur[i - bpp] : 0;
+	  int b = (prev != NULL) ? prev[i] : 0;
+	  int c = (prev != NULL && i >= (size_t) bpp) ? prev[i - bpp] : 0;
+	  switch (filter)
+	    {
+	    case RL2_PNG_FILTER_SUB:
+		*out++ = (unsigned char) (cur[i] - a);
+		break;
+	    case RL2_PNG_FILTER_UP:
+		*out++ = (unsigned char) (cur[i] - b);
+		break;
+	    case RL2_PNG_FILTER_AVERAGE:
+		*out++ = (unsigned char) (cur[i] - ((a + b) / 2));
+		break;
+	    case RL2_PNG_FILTER_PAETH:
+		*out++ = (unsigned char) (cur[i] - png_paeth_predictor (a, b, c));
+		break;
+	    default:
+		*out++ = cur[i];
+		break;
+	    };
+      }
+}
+
+static unsigned long
+png_filter_cost (const unsigned char *filtered, size_t row_bytes)
+{
+/* minimum sum of absolute differences heuristic */
+    size_t i;
+    unsigned long cost = 0;
+    for (i = 1; i <= row_bytes; i++)
+      {
+	  int v = (signed char) filtered[i];
+	  cost += (v < 0) ? -v : v;
+      }
+    return cost;
+}
+
+static int
+do_deflate_png_stripe (struct png_stripe *stripe, z_stream * strm, int flush)
+{
+/* deflating into the Stripe's output buffer, growing it as required */
+    int ret;
+    while (1)
+      {
+	  if (strm->avail_out == 0)
+	    {
+		size_t new_max = stripe->out_max * 2;
+		unsigned char *new_out = realloc (stripe->out, new_max);
+		if (new_out == NULL)
+		    return 0;
+		stripe->out = new_out;
+		stripe->out_max = new_max;
+		strm->next_out = stripe->out + stripe->out_size;
+		strm->avail_out = (uInt) (stripe->out_max - stripe->out_size);
+	    }
+	  ret = deflate (strm, flush);
+	  stripe->out_size = stripe->out_max - strm->avail_out;
+	  if (ret == Z_STREAM_ERROR)
+	      return 0;
+	  if (flush == Z_FINISH)
+	    {
+		if (ret == Z_STREAM_END)
+		    return 1;
+	    }
+	  else if (strm->avail_in == 0 && strm->avail_out != 0)
+	      return 1;
+      }
+}
+
+static void
+do_encode_png_stripe (struct png_stripe *stripe)
+{
+/* filtering and deflating a single Stripe */
+    const struct png_stripe_source *src = stripe->src;
+    size_t row_bytes = (size_t) src->width * src->out_bands;
+    unsigned char *prev = NULL;
+    unsigned char *cur = NULL;
+    unsigned char *filtered = NULL;
+    unsigned char *tmp;
+    unsigned int row;
+    int strategy = Z_FILTERED;
+    int z_init = 0;
+    z_stream strm;
+
+    stripe->retcode = RL2_ERROR;
+    stripe->adler = adler32 (0L, Z_NULL, 0);
+    stripe->raw_len = 0;
+    prev = malloc (row_bytes);
+    cur = malloc (row_bytes);
+    filtered = malloc ((row_bytes + 1) * 2);
+    if (prev == NULL || cur == NULL || filtered == NULL)
+	goto error;
+    stripe->out_max = ((row_bytes + 1) * stripe->num_rows) / 4 + 1024;
+    stripe->out = malloc (stripe->out_max);
+    if (stripe->out == NULL)
+	goto error;
+    stripe->out_size = 0;
+
+    if (stripe->filter == RL2_PNG_FILTER_NONE)
+	strategy = Z_DEFAULT_STRATEGY;
+    memset (&strm, 0, sizeof (z_stream));
+    if (deflateInit2
+	(&strm, stripe->level, Z_DEFLATED, -15, 8, strategy) != Z_OK)
+	goto error;
+    z_init = 1;
+    strm.next_out = stripe->out;
+    strm.avail_out = (uInt) stripe->out_max;
+
+/* filters always refer to the true previous image row */
+    if (stripe->first_row > 0)
+	build_png_stripe_row (src, stripe->first_row - 1, prev);
+    for (row = stripe->first_row;
+	 row < stripe->first_row + stripe->num_rows; row++)
+      {
+	  const unsigned char *p_prev = (row > 0) ? prev : NULL;
+	  unsigned char *best = filtered;
+	  build_png_stripe_row (src, row, cur);
+	  if (stripe->filter == RL2_PNG_FILTER_ADAPTIVE)
+	    {
+		/* testing all filters and retaining the cheapest one */
+		unsigned char flt;
+		unsigned long best_cost;
+		unsigned char *candidate = filtered + row_bytes + 1;
+		do_filter_png_row (RL2_PNG_FILTER_NONE, cur, p_prev, row_bytes,
+				   src->out_bands, best);
+		best_cost = png_filter_cost (best, row_bytes);
+		for (flt = RL2_PNG_FILTER_SUB; flt <= RL2_PNG_FILTER_PAETH;
+		     flt++)
+		  {
+		      unsigned long cost;
+		      do_filter_png_row (flt, cur, p_prev, row_bytes,
+					 src->out_bands, candidate);
+		      cost = png_filter_cost (candidate, row_bytes);
+		      if (cost < best_cost)
+			{
+			    best_cost = cost;
+			    tmp = best;
+			    best = candidate;
+			    candidate = tmp;
+			}
+		  }
+	    }
+	  else
+	      do_filter_png_row (stripe->filter, cur, p_prev, row_bytes,
+				 src->out_bands, best);
+	  stripe->adler = adler32 (stripe->adler, best, (uInt) (row_bytes + 1));
+	  stripe->raw_len += row_bytes + 1;
+	  strm.next_in = best;
+	  strm.avail_in = (uInt) (row_bytes + 1);
+	  if (!do_deflate_png_stripe (stripe, &strm, Z_NO_FLUSH))
+	      goto error;
+	  tmp = prev;
+	  prev = cur;
+	  cur = tmp;
+      }
+
+/* non-final Stripes end on a byte-aligned full flush point */
+    strm.next_in = NULL;
+    strm.avail_in = 0;
+    if (!do_deflate_png_stripe
+	(stripe, &strm, stripe->last ? Z_FINISH : Z_FULL_FLUSH))
+	goto error;
+    deflateEnd (&strm);
+    free (prev);
+    free (cur);
+    free (filtered);
+    stripe->retcode = RL2_OK;
+    return;
+
+  error:
+    if (z_init)
+	deflateEnd (&strm);
+    if (prev != NULL)
+	free (prev);
+    if (cur != NULL)
+	free (cur);
+    if (filtered != NULL)
+	free (filtered);
+    if (stripe->out != NULL)
+	free (stripe->out);
+    stripe->out = NULL;
+    stripe->out_size = 0;
+}
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+static DWORD WINAPI
+doRunPngStripeThread (void *arg)
+#else
+static void *
+doRunPngStripeThread (void *arg)
+#endif
+{
+/* threaded function: encoding a PNG Stripe */
+    struct png_stripe *stripe = (struct png_stripe *) arg;
+    rl2_perf_set_thread_counters (stripe->perf);
+    do_encode_png_stripe (stripe);
+#if defined(_WIN32) && !defined(__MINGW32__)
+    return 0;
+#else
+    pthread_exit (NULL);
+    return NULL;
+#endif
+}
+
+static void
+start_png_stripe_thread (struct png_stripe *stripe)
+{
+/* starting a concurrent thread */
+#if defined(_WIN32) && !defined(__MINGW32__)
+    HANDLE thread_handle;
+    HANDLE *p_thread;
+    DWORD dwThreadId;
+    thread_handle =
+	CreateThread (NULL, 0, doRunPngStripeThread, stripe, 0, &dwThreadId);
+    SetThreadPriority (thread_handle, THREAD_PRIORITY_IDLE);
+    p_thread = malloc (sizeof (HANDLE));
+    *p_thread = thread_handle;
+    stripe->opaque_thread_id = p_thread;
+#else
+    pthread_t thread_id;
+    pthread_t *p_thread;
+    int ok_prior = 0;
+    int policy;
+    int min_prio;
+    pthread_attr_t attr;
+    struct sched_param sp;
+    pthread_attr_init (&attr);
+    if (pthread_attr_setschedpolicy (&attr, SCHED_RR) == 0)
+      {
+	  /* attempting to set the lowest priority */
+	  if (pthread_attr_getschedpolicy (&attr, &policy) == 0)
+	    {
+		min_prio = sched_get_priority_min (policy);
+		sp.sched_priority = min_prio;
+		if (pthread_attr_setschedparam (&attr, &sp) == 0)
+		  {
+		      /* ok, setting the lowest priority */
+		      ok_prior = 1;
+		      pthread_create (&thread_id, &attr,
+				      doRunPngStripeThread, stripe);
+		  }
+	    }
+      }
+    if (!ok_prior)
+      {
+	  /* failure: using standard priority */
+	  pthread_create (&thread_id, NULL, doRunPngStripeThread, stripe);
+      }
+    p_thread = malloc (sizeof (pthread_t));
+    *p_thread = thread_id;
+    stripe->opaque_thread_id = p_thread;
+#endif
+}
+
+static void
+do_run_png_stripe_children (struct png_stripe *stripes, int thread_count)
+{
+/* concurrent execution of all PNG Stripe encoder children threads */
+    struct png_stripe *stripe;
+    int i;
+#if defined(_WIN32) && !defined(__MINGW32__)
+    HANDLE *handles;
+#endif
+
+    for (i = 0; i < thread_count; i++)
+      {
+	  /* starting all children threads */
+	  stripe = stripes + i;
+	  start_png_stripe_thread (stripe);
+      }
+
+/* waiting until all child threads exit */
+#if defined(_WIN32) && !defined(__MINGW32__)
+    handles = malloc (sizeof (HANDLE) * thread_count);
+    for (i = 0; i < thread_count; i++)
+      {
+	  /* initializing the HANDLEs array */
+	  HANDLE *pOpaque;
+	  stripe = stripes + i;
+	  pOpaque = (HANDLE *) (stripe->opaque_thread_id);
+	  *(handles + i) = *pOpaque;
+      }
+    WaitForMultipleObjects (thread_count, handles, TRUE, INFINITE);
+    free (handles);
+#else
+    for (i = 0; i < thread_count; i++)
+      {
+	  pthread_t *pOpaque;
+	  stripe = stripes + i;
+	  pOpaque = (pthread_t *) (stripe->opaque_thread_id);
+	  pthread_join (*pOpaque, NULL);
+      }
+#endif
+
+    for (i = 0; i < thread_count; i++)
+      {
+	  /* cleaning up a thread slot */
+	  stripe = stripes + i;
+	  if (stripe->opaque_thread_id != NULL)
+	      free (stripe->opaque_thread_id);
+	  stripe->opaque_thread_id = NULL;
+      }
+}
+
+static unsigned char *
+png_put_uint32 (unsigned char *p, uLong value)
+{
+/* exporting a 32-bit value in network byte order */
+    *p++ = (unsigned char) ((value >> 24) & 0xff);
+    *p++ = (unsigned char) ((value >> 16) & 0xff);
+    *p++ = (unsigned char) ((value >> 8) & 0xff);
+    *p++ = (unsigned char) (value & 0xff);
+    return p;
+}
+
+static unsigned char *
+png_put_chunk_crc (unsigned char *p, const unsigned char *chunk_type)
+{
+/* appending the CRC covering the Chunk Type and Chunk Data */
+    uLong crc = crc32 (0L, Z_NULL, 0);
+    crc = crc32 (crc, chunk_type, (uInt) (p - chunk_type));
+    return png_put_uint32 (p, crc);
+}
+
+static int
+compress_png_stripes (const struct png_stripe_source *src,
+		      unsigned char **png, int *png_size)
+{
+/*
+/ compressing an 8 bits PNG image by independently filtering and
+/ deflating horizontal Stripes, possibly by concurrent threads
+/ the Stripes are joined at full-flush boundaries so to form a
+/ single valid zlib stream split across many IDAT chunks
+*/
+    static const unsigned char signature[8] =
+	{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    struct png_stripe *stripes = NULL;
+    int num_stripes;
+    int max_stripes;
+    int i;
+    int level = rl2_thread_png_level;
+    unsigned int rows_per_stripe;
+    unsigned int row;
+    unsigned char color_type;
+    unsigned char cmf = 0x78;
+    unsigned char flg;
+    uLong adler;
+    size_t total;
+    unsigned char *blob = NULL;
+    unsigned char *p;
+    unsigned char *chunk_type;
+
+    if (src->width == 0 || src->height == 0)
+	return RL2_ERROR;
+    if (level < 0 || level > 9)
+	level = Z_DEFAULT_COMPRESSION;
+
+/* determining how many Stripes (at least 64 rows each) */
+    max_stripes = rl2_thread_png_max_threads;
+    if (max_stripes < 1)
+	max_stripes = 1;
+    num_stripes = src->height / 64;
+    if (num_stripes > max_stripes)
+	num_stripes = max_stripes;
+    if (num_stripes < 1)
+	num_stripes = 1;
+    rows_per_stripe = src->height / num_stripes;
+    stripes = malloc (sizeof (struct png_stripe) * num_stripes);
+    if (stripes == NULL)
+	return RL2_ERROR;
+    row = 0;
+    for (i = 0; i < num_stripes; i++)
+      {
+	  struct png_stripe *stripe = stripes + i;
+	  stripe->src = src;
+	  stripe->first_row = row;
+	  stripe->num_rows = rows_per_stripe;
+	  if (i == num_stripes - 1)
+	      stripe->num_rows = src->height - row;
+	  stripe->level = level;
+	  stripe->filter = rl2_thread_png_filter;
+	  stripe->last = (i == num_stripes - 1) ? 1 : 0;
+	  stripe->out = NULL;
+	  stripe->out_size = 0;
+	  stripe->out_max = 0;
+	  stripe->retcode = RL2_ERROR;
+	  stripe->perf = rl2_perf_get_thread_counters ();
+	  stripe->opaque_thread_id = NULL;
+	  row += stripe->num_rows;
+      }
+
+    if (num_stripes == 1)
+	do_encode_png_stripe (stripes);
+    else
+	do_run_png_stripe_children (stripes, num_stripes);
+    for (i = 0; i < num_stripes; i++)
+      {
+	  if ((stripes + i)->retcode != RL2_OK)
+	      goto error;
+      }
+
+/* combining the Adler-32 checksums */
+    adler = stripes->adler;
+    for (i = 1; i < num_stripes; i++)
+      {
+	  struct png_stripe *stripe = stripes + i;
+	  adler =
+	      adler32_combine (adler, stripe->adler, (z_off_t) stripe->raw_len);
+      }
+
+/* computing the output size */
+    total = 8 + 25 + 12;	/* signature + IHDR + IEND */
+    for (i = 0; i < num_stripes; i++)
+	total += (stripes + i)->out_size + 12;
+    total += 2 + 4;		/* zlib header and trailer */
+    blob = malloc (total);
+    if (blob == NULL)
+	goto error;
+
+/* PNG signature and IHDR */
+    switch (src->out_bands)
+      {
+      case 1:
+	  color_type = 0;
+	  break;
+      case 2:
+	  color_type = 4;
+	  break;
+      case 4:
+	  color_type = 6;
+	  break;
+      default:
+	  color_type = 2;
+	  break;
+      };
+    p = blob;
+    memcpy (p, signature, 8);
+    p += 8;
+    p = png_put_uint32 (p, 13);
+    chunk_type = p;
+    memcpy (p, "IHDR", 4);
+    p += 4;
+    p = png_put_uint32 (p, src->width);
+    p = png_put_uint32 (p, src->height);
+    *p++ = 8;			/* bit depth */
+    *p++ = color_type;
+    *p++ = 0;			/* compression method */
+    *p++ = 0;			/* filter method */
+    *p++ = 0;			/* no interlace */
+    p = png_put_chunk_crc (p, chunk_type);
+
+/* one IDAT chunk for each Stripe */
+    if (level == Z_DEFAULT_COMPRESSION || level == 6)
+	flg = 2 << 6;
+    else if (level < 2)
+	flg = 0;
+    else if (level < 6)
+	flg = 1 << 6;
+    else
+	flg = 3 << 6;
+    flg += 31 - (((cmf << 8) + flg) % 31);
+    for (i = 0; i < num_stripes; i++)
+      {
+	  struct png_stripe *stripe = stripes + i;
+	  size_t len = stripe->out_size;
+	  if (i == 0)
+	      len += 2;
+	  if (stripe->last)
+	      len += 4;
+	  p = png_put_uint32 (p, (uLong) len);
+	  chunk_type = p;
+	  memcpy (p, "IDAT", 4);
+	  p += 4;
+	  if (i == 0)
+	    {
+		*p++ = cmf;
+		*p++ = flg;
+	    }
+	  memcpy (p, stripe->out, stripe->out_size);
+	  p += stripe->out_size;
+	  if (stripe->last)
+	      p = png_put_uint32 (p, adler);
+	  p = png_put_chunk_crc (p, chunk_type);
+      }
+
+/* IEND */
+    p = png_put_uint32 (p, 0);
+    chunk_type = p;
+    memcpy (p, "IEND", 4);
+    p += 4;
+    p = png_put_chunk_crc (p, chunk_type);
+
+    for (i = 0; i < num_stripes; i++)
+      {
+	  if ((stripes + i)->out != NULL)
+	      free ((stripes + i)->out);
+      }
+    free (stripes);
+    *png = blob;
+    *png_size = p - blob;
+    return RL2_OK;
+
+  error:
+    for (i = 0; i < num_stripes; i++)
+      {
+	  if ((stripes + i)->out != NULL)
+	      free ((stripes + i)->out);
+      }
+    free (stripes);
+    if (blob != NULL)
+	free (blob);
+    return RL2_ERROR;
+}
+
+static int
+compress_striped_png8 (const unsigned char *pixels,
+		       const unsigned char *alpha, int real_alpha,
+		       double opacity, int in_bands, unsigned int width,
+		       unsigned int height, unsigned char **png, int *png_size)
+{
+/* preparing the Source for the Striped PNG encoder */
+    struct png_stripe_source src;
+    if (opacity < 0.0)
+	opacity = 0.0;
+    if (opacity > 1.0)
+	opacity = 1.0;
+    src.pixels = pixels;
+    src.alpha = alpha;
+    src.real_alpha = real_alpha;
+    src.opacity = 255;
+    if (opacity < 1.0)
+	src.opacity = (unsigned char) (255.0 * opacity);
+    src.width = width;
+    src.height = height;
+    src.in_bands = in_bands;
+    src.out_bands = in_bands;
+    if (alpha != NULL)
+	src.out_bands += 1;
+    return compress_png_stripes (&src, png, png_size);
+}
+
 RL2_DECLARE int
 rl2_section_to_png (rl2SectionPtr scn, const char *path)
 {
@@ -1050,13 +1758,23 @@ rl2_rgb_to_png (unsigned int width, unsigned int height,
 /* creating a PNG image from an RGB buffer */
     unsigned char *blob;
     int blob_size;
+    double t0;
     if (rgb == NULL)
 	return RL2_ERROR;
 
-    if (rl2_data_to_png
-	(rgb, NULL, 1.0, NULL, width, height, RL2_SAMPLE_UINT8, RL2_PIXEL_RGB,
-	 3, &blob, &blob_size) != RL2_OK)
+    t0 = rl2_perf_clock ();
+    if (rl2_thread_png_active)
+      {
+	  if (compress_striped_png8
+	      (rgb, NULL, 0, 1.0, 3, width, height, &blob,
+	       &blob_size) != RL2_OK)
+	      return RL2_ERROR;
+      }
+    else if (rl2_data_to_png
+	     (rgb, NULL, 1.0, NULL, width, height, RL2_SAMPLE_UINT8,
+	      RL2_PIXEL_RGB, 3, &blob, &blob_size) != RL2_OK)
 	return RL2_ERROR;
+    rl2_perf_add (RL2_PERF_IMAGE_ENCODE, t0, blob_size);
     *png = blob;
     *png_size = blob_size;
     return RL2_OK;
@@ -1070,13 +1788,23 @@ rl2_rgb_alpha_to_png (unsigned int width, unsigned int height,
 /* creating a PNG image from two distinct RGB + Alpha buffer */
     unsigned char *blob;
     int blob_size;
+    double t0;
     if (rgb == NULL || alpha == NULL)
 	return RL2_ERROR;
 
-    if (rl2_data_to_png
-	(rgb, alpha, opacity, NULL, width, height, RL2_SAMPLE_UINT8,
-	 RL2_PIXEL_RGB, 3, &blob, &blob_size) != RL2_OK)
+    t0 = rl2_perf_clock ();
+    if (rl2_thread_png_active)
+      {
+	  if (compress_striped_png8
+	      (rgb, alpha, 0, opacity, 3, width, height, &blob,
+	       &blob_size) != RL2_OK)
+	      return RL2_ERROR;
+      }
+    else if (rl2_data_to_png
+	     (rgb, alpha, opacity, NULL, width, height, RL2_SAMPLE_UINT8,
+	      RL2_PIXEL_RGB, 3, &blob, &blob_size) != RL2_OK)
 	return RL2_ERROR;
+    rl2_perf_add (RL2_PERF_IMAGE_ENCODE, t0, blob_size);
     *png = blob;
     *png_size = blob_size;
     return RL2_OK;
@@ -1091,12 +1819,22 @@ rl2_rgb_real_alpha_to_png (unsigned int width, unsigned int height,
 /* creating a PNG image from two distinct RGB + Alpha buffer */
     unsigned char *blob;
     int blob_size;
+    double t0;
     if (rgb == NULL || alpha == NULL)
 	return RL2_ERROR;
 
-    if (compress_rgba_png8 (rgb, alpha, width, height,
-			    &blob, &blob_size) != RL2_OK)
+    t0 = rl2_perf_clock ();
+    if (rl2_thread_png_active)
+      {
+	  if (compress_striped_png8
+	      (rgb, alpha, 1, 1.0, 3, width, height, &blob,
+	       &blob_size) != RL2_OK)
+	      return RL2_ERROR;
+      }
+    else if (compress_rgba_png8 (rgb, alpha, width, height,
+				 &blob, &blob_size) != RL2_OK)
 	return RL2_ERROR;
+    rl2_perf_add (RL2_PERF_IMAGE_ENCODE, t0, blob_size);
     *png = blob;
     *png_size = blob_size;
     return RL2_OK;
@@ -1109,13 +1847,23 @@ rl2_gray_to_png (unsigned int width, unsigned int height,
 /* creating a PNG image from a Grayscale buffer */
     unsigned char *blob;
     int blob_size;
+    double t0;
     if (gray == NULL)
 	return RL2_ERROR;
 
-    if (rl2_data_to_png
-	(gray, NULL, 1.0, NULL, width, height, RL2_SAMPLE_UINT8,
-	 RL2_PIXEL_GRAYSCALE, 1, &blob, &blob_size) != RL2_OK)
+    t0 = rl2_perf_clock ();
+    if (rl2_thread_png_active)
+      {
+	  if (compress_striped_png8
+	      (gray, NULL, 0, 1.0, 1, width, height, &blob,
+	       &blob_size) != RL2_OK)
+	      return RL2_ERROR;
+      }
+    else if (rl2_data_to_png
+	     (gray, NULL, 1.0, NULL, width, height, RL2_SAMPLE_UINT8,
+	      RL2_PIXEL_GRAYSCALE, 1, &blob, &blob_size) != RL2_OK)
 	return RL2_ERROR;
+    rl2_perf_add (RL2_PERF_IMAGE_ENCODE, t0, blob_size);
     *png = blob;
     *png_size = blob_size;
     return RL2_OK;
@@ -1129,13 +1877,23 @@ rl2_gray_alpha_to_png (unsigned int width, unsigned int height,
 /* creating a PNG image from two distinct Grayscale + Alpha buffer */
     unsigned char *blob;
     int blob_size;
+    double t0;
     if (gray == NULL)
 	return RL2_ERROR;
 
-    if (rl2_data_to_png
-	(gray, alpha, opacity, NULL, width, height, RL2_SAMPLE_UINT8,
-	 RL2_PIXEL_GRAYSCALE, 1, &blob, &blob_size) != RL2_OK)
+    t0 = rl2_perf_clock ();
+    if (rl2_thread_png_active)
+      {
+	  if (compress_striped_png8
+	      (gray, alpha, 0, opacity, 1, width, height, &blob,
+	       &blob_size) != RL2_OK)
+	      return RL2_ERROR;
+      }
+    else if (rl2_data_to_png
+	     (gray, alpha, opacity, NULL, width, height, RL2_SAMPLE_UINT8,
+	      RL2_PIXEL_GRAYSCALE, 1, &blob, &blob_size) != RL2_OK)
 	return RL2_ERROR;
+    rl2_perf_add (RL2_PERF_IMAGE_ENCODE, t0, blob_size);
     *png = blob;
     *png_size = blob_size;
     return RL2_OK;
@@ -1150,6 +1908,7 @@ rl2_palette_pixbuf_to_png (unsigned int width, unsigned int height,
     unsigned char sample_type = RL2_SAMPLE_UINT8;
     unsigned char *blob;
     int blob_size;
+    double t0;
     rl2PrivPalettePtr plt = (rl2PrivPalettePtr) palette;
     if (pixbuf == NULL)
 	return RL2_ERROR;
@@ -1163,9 +1922,11 @@ rl2_palette_pixbuf_to_png (unsigned int width, unsigned int height,
     else if (plt->nEntries <= 16)
 	sample_type = RL2_SAMPLE_4_BIT;
 
+    t0 = rl2_perf_clock ();
     if (compress_palette_png (pixbuf, width, height, palette, sample_type,
 			      &blob, &blob_size) != RL2_OK)
 	return RL2_ERROR;
+    rl2_perf_add (RL2_PERF_IMAGE_ENCODE, t0, blob_size);
     *png = blob;
     *png_size = blob_size;
     return RL2_OK;
@@ -45,6 +45,7 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include <stdio.h>
 #include <string.h>
 #include <float.h>
+#include <math.h>
 
 #include <sys/types.h>
 #if defined(_WIN32) && !defined(__MINGW32__)
@@ -68,8 +69,12 @@ the terms of any one of the MPL, the GPL or the LGPL.
 /* 64 bit integer: portable format for printf() */
 #if defined(_WIN32) && !defined(__MINGW32__)
 #define ERR_FRMT64 "ERROR: unable to decode Tile ID=%I64d\n"
+#define ERR_RGBA64 "ERROR: unable to convert Tile ID=%I64d into RGBA\n"
+#define ERR_MISS64 "ERROR: missing Tile ID=%I64d\n"
 #else
 #define ERR_FRMT64 "ERROR: unable to decode Tile ID=%lld\n"
+#define ERR_RGBA64 "ERROR: unable to convert Tile ID=%lld into RGBA\n"
+#define ERR_MISS64 "ERROR: missing Tile ID=%lld\n"
 #endif
 
 static int
@@ -138,6 +143,22 @@ do_insert_pyramid_section_levels (sqlite3 * handle, sqlite3_int64 section_id,
     return 0;
 }
 
+static int
+do_encode_pyramid_tile (rl2RasterPtr raster, unsigned char compression,
+			unsigned char **blob_odd, int *blob_odd_sz,
+			unsigned char **blob_even, int *blob_even_sz,
+			int quality, int sparse, rl2CoveragePtr cvg)
+{
+/* encoding a Pyramid tile - optionally skipping empty or uniform tiles */
+    if (sparse)
+	return rl2_raster_encode_sparse (raster, compression, blob_odd,
+					 blob_odd_sz, blob_even, blob_even_sz,
+					 quality, 1, cvg);
+    return rl2_raster_encode_dict (raster, compression, blob_odd,
+				   blob_odd_sz, blob_even, blob_even_sz,
+				   quality, 1, cvg);
+}
+
 static int
 do_insert_pyramid_tile (sqlite3 * handle, unsigned char *blob_odd,
 			int blob_odd_sz, unsigned char *blob_even,
@@ -150,6 +171,11 @@ do_insert_pyramid_tile (sqlite3 * handle, unsigned char *blob_odd,
     int ret;
     sqlite3_int64 tile_id;
 
+    if (blob_odd == NULL)
+      {
+	  /* empty sparse tile: intentionally not stored */
+	  return 1;
+      }
     sqlite3_reset (stmt_tils);
     sqlite3_clear_bindings (stmt_tils);
     sqlite3_bind_int (stmt_tils, 1, id_level);
@@ -438,6 +464,8 @@ alloc_sect_pyramid (sqlite3_int64 sect_id, unsigned int sect_width,
     pyr->num_samples = num_samples;
     pyr->compression = compression;
     pyr->quality = quality;
+    pyr->sparse = 0;
+    pyr->coverage = NULL;
     pyr->srid = srid;
     pyr->res_x = res_x;
     pyr->res_y = res_y;
@@ -591,7 +619,7 @@ set_pyramid_tile_destination (SectionPyramidPtr pyr, double minx, double miny,
 
 static unsigned char *
 load_tile_base (sqlite3_stmt * stmt, sqlite3_int64 tile_id,
-		rl2PalettePtr palette, rl2PixelPtr no_data)
+		rl2PalettePtr palette, rl2PixelPtr no_data, rl2CoveragePtr cvg)
 {
 /* attempting to read a lower-level tile */
     int ret;
@@ -628,8 +656,9 @@ load_tile_base (sqlite3_stmt * stmt, sqlite3_int64 tile_id,
 		  }
 		plt = rl2_clone_palette (palette);
 		raster =
-		    rl2_raster_decode (RL2_SCALE_1, blob_odd, blob_odd_sz,
-				       blob_even, blob_even_sz, plt);
+		    rl2_raster_decode_dict (RL2_SCALE_1, blob_odd,
+					    blob_odd_sz, blob_even,
+					    blob_even_sz, plt, cvg);
 		if (raster == NULL)
 		  {
 		      fprintf (stderr, ERR_FRMT64, tile_id);
@@ -639,18 +668,28 @@ load_tile_base (sqlite3_stmt * stmt, sqlite3_int64 tile_id,
 		rl2_set_raster_no_data (raster, nd);
 		if (rl2_raster_data_to_RGBA (raster, &rgba_tile, &rgba_sz) !=
 		    RL2_OK)
-		    rgba_tile = NULL;
+		  {
+		      fprintf (stderr, ERR_RGBA64, tile_id);
+		      rgba_tile = NULL;
+		  }
 		rl2_destroy_raster (raster);
-		break;
+		return rgba_tile;
 	    }
 	  else
-	      return NULL;
+	    {
+		fprintf (stderr,
+			 "SELECT tile_data; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (sqlite3_db_handle (stmt)));
+		return NULL;
+	    }
       }
-    return rgba_tile;
+    fprintf (stderr, ERR_MISS64, tile_id);
+    return NULL;
 }
 
 static rl2RasterPtr
-load_tile_base_generic (sqlite3_stmt * stmt, sqlite3_int64 tile_id)
+load_tile_base_generic (sqlite3_stmt * stmt, sqlite3_int64 tile_id,
+			rl2CoveragePtr cvg)
 {
 /* attempting to read a lower-level tile */
     int ret;
@@ -682,8 +721,9 @@ load_tile_base_generic (sqlite3_stmt * stmt, sqlite3_int64 tile_id)
 		      blob_even_sz = sqlite3_column_bytes (stmt, 1);
 		  }
 		raster =
-		    rl2_raster_decode (RL2_SCALE_1, blob_odd, blob_odd_sz,
-				       blob_even, blob_even_sz, NULL);
+		    rl2_raster_decode_dict (RL2_SCALE_1, blob_odd,
+					    blob_odd_sz, blob_even,
+					    blob_even_sz, NULL, cvg);
 		if (raster == NULL)
 		  {
 		      fprintf (stderr, ERR_FRMT64, tile_id);
@@ -691,7 +731,15 @@ load_tile_base_generic (sqlite3_stmt * stmt, sqlite3_int64 tile_id)
 		  }
 		return raster;
 	    }
+	  else
+	    {
+		fprintf (stderr,
+			 "SELECT tile_data; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (sqlite3_db_handle (stmt)));
+		return NULL;
+	    }
       }
+    fprintf (stderr, ERR_MISS64, tile_id);
     return NULL;
 }
 
@@ -1496,7 +1544,8 @@ update_sect_pyramid_grid (sqlite3 * handle, sqlite3_stmt * stmt_rd,
 	    {
 		/* loading and rescaling the base tiles */
 		raster_in =
-		    load_tile_base_generic (stmt_rd, tile_in->child->tile_id);
+		    load_tile_base_generic (stmt_rd, tile_in->child->tile_id,
+					    pyr->coverage);
 		if (raster_in == NULL)
 		    goto error;
 		pos_y = tile_out->maxy;
@@ -1541,9 +1590,10 @@ update_sect_pyramid_grid (sqlite3 * handle, sqlite3_stmt * stmt_rd,
 		fprintf (stderr, "ERROR: unable to create a Pyramid Tile\n");
 		goto error;
 	    }
-	  if (rl2_raster_encode
+	  if (do_encode_pyramid_tile
 	      (raster_out, compression, &blob_odd, &blob_odd_sz,
-	       &blob_even, &blob_even_sz, 100, 1) != RL2_OK)
+	       &blob_even, &blob_even_sz, 100, pyr->sparse,
+	       pyr->coverage) != RL2_OK)
 	    {
 		fprintf (stderr, "ERROR: unable to encode a Pyramid tile\n");
 		goto error;
@@ -1879,7 +1929,8 @@ update_sect_pyramid_multiband (sqlite3 * handle, sqlite3_stmt * stmt_rd,
 	    {
 		/* loading and rescaling the base tiles */
 		raster_in =
-		    load_tile_base_generic (stmt_rd, tile_in->child->tile_id);
+		    load_tile_base_generic (stmt_rd, tile_in->child->tile_id,
+					    pyr->coverage);
 		if (raster_in == NULL)
 		    goto error;
 		pos_y = tile_out->maxy;
@@ -1924,9 +1975,10 @@ update_sect_pyramid_multiband (sqlite3 * handle, sqlite3_stmt * stmt_rd,
 		fprintf (stderr, "ERROR: unable to create a Pyramid Tile\n");
 		goto error;
 	    }
-	  if (rl2_raster_encode
+	  if (do_encode_pyramid_tile
 	      (raster_out, compression, &blob_odd, &blob_odd_sz,
-	       &blob_even, &blob_even_sz, 100, 1) != RL2_OK)
+	       &blob_even, &blob_even_sz, 100, pyr->sparse,
+	       pyr->coverage) != RL2_OK)
 	    {
 		fprintf (stderr, "ERROR: unable to encode a Pyramid tile\n");
 		goto error;
@@ -2015,7 +2067,7 @@ update_sect_pyramid (sqlite3 * handle, const void *priv_data,
 		/* loading and rescaling the base tiles */
 		buf_in =
 		    load_tile_base (stmt_rd, tile_in->child->tile_id, palette,
-				    no_data);
+				    no_data, pyr->coverage);
 		if (buf_in == NULL)
 		    goto error;
 		base_tile =
@@ -2148,9 +2200,10 @@ update_sect_pyramid (sqlite3 * handle, const void *priv_data,
 		fprintf (stderr, "ERROR: unable to create a Pyramid Tile\n");
 		goto error;
 	    }
-	  if (rl2_raster_encode
+	  if (do_encode_pyramid_tile
 	      (raster, compression, &blob_odd, &blob_odd_sz, &blob_even,
-	       &blob_even_sz, 80, 1) != RL2_OK)
+	       &blob_even_sz, 80, pyr->sparse,
+	       pyr->coverage) != RL2_OK)
 	    {
 		fprintf (stderr, "ERROR: unable to encode a Pyramid tile\n");
 		goto error;
@@ -2189,7 +2242,8 @@ rescale_monolithic_rgba (const void *priv_data, int id_level,
 			 unsigned char *buffer, int buf_size,
 			 unsigned char *mask, int *mask_size,
 			 rl2PalettePtr palette, rl2PixelPtr no_data,
-			 sqlite3_stmt * stmt_geo, sqlite3_stmt * stmt_data)
+			 sqlite3_stmt * stmt_geo, sqlite3_stmt * stmt_data,
+			 rl2CoveragePtr cvg)
 {
 /* rescaling a monolithic RGBA tile */
     rl2GraphicsContextPtr ctx = NULL;
@@ -2234,7 +2288,9 @@ rescale_monolithic_rgba (const void *priv_data, int id_level,
 		double tile_x = sqlite3_column_double (stmt_geo, 1);
 		double tile_y = sqlite3_column_double (stmt_geo, 2);
 
-		rgba = load_tile_base (stmt_data, tile_id, palette, no_data);
+		rgba =
+		    load_tile_base (stmt_data, tile_id, palette, no_data,
+				    cvg);
 		if (rgba == NULL)
 		    goto error;
 		base_tile =
@@ -2254,6 +2310,13 @@ rescale_monolithic_rgba (const void *priv_data, int id_level,
 						scale_x, scale_y, x, y);
 		rl2_graph_destroy_bitmap (base_tile);
 	    }
+	  else
+	    {
+		fprintf (stderr,
+			 "SELECT monolithic tiles; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (sqlite3_db_handle (stmt_geo)));
+		goto error;
+	    }
       }
 
     rgb = rl2_graph_get_context_rgb_array (ctx);
@@ -2659,7 +2722,8 @@ rescale_monolithic_124 (int id_level,
 			double maxy, unsigned char *buffer, int buf_size,
 			unsigned char *mask, int *mask_size,
 			rl2PalettePtr palette, rl2PixelPtr no_data,
-			sqlite3_stmt * stmt_geo, sqlite3_stmt * stmt_data)
+			sqlite3_stmt * stmt_geo, sqlite3_stmt * stmt_data,
+			rl2CoveragePtr cvg)
 {
 /* rescaling a monolithic 1,2 or 4 bit tile */
     rl2RasterPtr raster = NULL;
@@ -2748,7 +2812,9 @@ rescale_monolithic_124 (int id_level,
 		double tile_x = sqlite3_column_double (stmt_geo, 1);
 		double tile_y = sqlite3_column_double (stmt_geo, 2);
 
-		rgba = load_tile_base (stmt_data, tile_id, palette, no_data);
+		rgba =
+		    load_tile_base (stmt_data, tile_id, palette, no_data,
+				    cvg);
 		if (rgba == NULL)
 		    goto error;
 		base_tile =
@@ -2764,6 +2830,13 @@ rescale_monolithic_124 (int id_level,
 		copy_124_rescaled (raster, base_tile, x, y);
 		rl2_destroy_raster (base_tile);
 	    }
+	  else
+	    {
+		fprintf (stderr,
+			 "SELECT monolithic tiles; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (sqlite3_db_handle (stmt_geo)));
+		goto error;
+	    }
       }
 
 /* releasing buffers ownership */
@@ -4108,7 +4181,7 @@ rescale_monolithic_multiband (int id_level,
 			      unsigned char *buffer, int buf_size,
 			      unsigned char *mask, int *mask_size,
 			      rl2PixelPtr no_data, sqlite3_stmt * stmt_geo,
-			      sqlite3_stmt * stmt_data)
+			      sqlite3_stmt * stmt_data, rl2CoveragePtr cvg)
 {
 /* rescaling monolithic MultiBand */
     rl2RasterPtr raster = NULL;
@@ -4164,7 +4237,9 @@ rescale_monolithic_multiband (int id_level,
 		double tile_x = sqlite3_column_double (stmt_geo, 1);
 		double tile_y = sqlite3_column_double (stmt_geo, 2);
 
-		raster_in = load_tile_base_generic (stmt_data, tile_id);
+		raster_in = load_tile_base_generic (stmt_data, tile_id, cvg);
+		if (raster_in == NULL)
+		    goto error;
 		rst_in = (rl2PrivRasterPtr) raster_in;
 		base_tile =
 		    create_rescaled_multiband_raster (factor, tileWidth,
@@ -4185,6 +4260,13 @@ rescale_monolithic_multiband (int id_level,
 		copy_multiband_rescaled (raster, base_tile, x, y);
 		rl2_destroy_raster (base_tile);
 	    }
+	  else
+	    {
+		fprintf (stderr,
+			 "SELECT monolithic tiles; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (sqlite3_db_handle (stmt_geo)));
+		goto error;
+	    }
       }
 
 /* releasing buffers ownership */
@@ -4230,7 +4312,7 @@ rescale_monolithic_datagrid (int id_level,
 			     unsigned char *buffer, int buf_size,
 			     unsigned char *mask, int *mask_size,
 			     rl2PixelPtr no_data, sqlite3_stmt * stmt_geo,
-			     sqlite3_stmt * stmt_data)
+			     sqlite3_stmt * stmt_data, rl2CoveragePtr cvg)
 {
 /* rescaling monolithic DataGrid */
     rl2RasterPtr raster = NULL;
@@ -4286,7 +4368,9 @@ rescale_monolithic_datagrid (int id_level,
 		double tile_x = sqlite3_column_double (stmt_geo, 1);
 		double tile_y = sqlite3_column_double (stmt_geo, 2);
 
-		raster_in = load_tile_base_generic (stmt_data, tile_id);
+		raster_in = load_tile_base_generic (stmt_data, tile_id, cvg);
+		if (raster_in == NULL)
+		    goto error;
 		rst_in = (rl2PrivRasterPtr) raster_in;
 		base_tile =
 		    create_rescaled_datagrid_raster (factor, tileWidth,
@@ -4305,6 +4389,13 @@ rescale_monolithic_datagrid (int id_level,
 		copy_datagrid_rescaled (raster, base_tile, x, y);
 		rl2_destroy_raster (base_tile);
 	    }
+	  else
+	    {
+		fprintf (stderr,
+			 "SELECT monolithic tiles; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (sqlite3_db_handle (stmt_geo)));
+		goto error;
+	    }
       }
 
 /* releasing buffers ownership */
@@ -4475,7 +4566,8 @@ do_build_section_pyramid (sqlite3 * handle, const void *priv_data,
 			  unsigned char sample_type, unsigned char pixel_type,
 			  unsigned char num_samples, unsigned char compression,
 			  int mixed_resolutions, int quality, int srid,
-			  unsigned int tileWidth, unsigned int tileHeight)
+			  unsigned int tileWidth, unsigned int tileHeight,
+			  rl2CoveragePtr cvg)
 {
 /* attempting to (re)build a section pyramid from scratch */
     char *table_levels;
@@ -4507,6 +4599,7 @@ do_build_section_pyramid (sqlite3 * handle, const void *priv_data,
     int ret;
     int first;
     int scale;
+    struct rl2_private_data *cache = (struct rl2_private_data *) priv_data;
     rl2PalettePtr palette = NULL;
     rl2PixelPtr no_data = NULL;
 
@@ -4607,6 +4700,9 @@ do_build_section_pyramid (sqlite3 * handle, const void *priv_data,
 			    first = 0;
 			    if (pyr == NULL)
 				goto error;
+			    if (cache != NULL)
+				pyr->sparse = cache->sparse_tiles;
+			    pyr->coverage = cvg;
 			}
 		      if (!insert_tile_into_section_pyramid
 			  (pyr, tile_id, tminx, tminy, tmaxx, tmaxy))
@@ -4981,7 +5077,7 @@ get_section_raw_raster_data (sqlite3 * handle, int max_threads,
 			     double maxx, double maxy, double x_res,
 			     double y_res, unsigned char **buffer,
 			     int *buf_size, rl2PalettePtr palette,
-			     rl2PixelPtr no_data)
+			     rl2PixelPtr no_data, rl2CoveragePtr cvg)
 {
 /* attempting to return a buffer containing raw pixels from the whole DBMS Section */
     unsigned char *bufpix = NULL;
@@ -5066,7 +5162,7 @@ get_section_raw_raster_data (sqlite3 * handle, int max_threads,
 	(handle, max_threads, sect_id, stmt_tiles, stmt_data, bufpix, width,
 	 height, sample_type, num_bands, 0, RL2_SYNTETIC_NONE, 0, 0, 0, 0,
 	 x_res, y_res, minx, miny, maxx, maxy, 0, RL2_SCALE_1, palette,
-	 no_data))
+	 no_data, cvg))
 	goto error;
     sqlite3_finalize (stmt_tiles);
     sqlite3_finalize (stmt_data);
@@ -5387,7 +5483,8 @@ do_build_124_bit_section_pyramid (sqlite3 * handle, int max_threads,
 				  unsigned int tileWidth,
 				  unsigned int tileHeight,
 				  unsigned char bgRed, unsigned char bgGreen,
-				  unsigned char bgBlue)
+				  unsigned char bgBlue, int sparse,
+				  rl2CoveragePtr cvg)
 {
 /* attempting to (re)build a 1,2,4-bit section pyramid from scratch */
     double base_res_x;
@@ -5450,7 +5547,8 @@ do_build_124_bit_section_pyramid (sqlite3 * handle, int max_threads,
     if (!get_section_raw_raster_data
 	(handle, max_threads, coverage, section_id, sect_width, sect_height,
 	 sample_type, pixel_type, num_samples, minx, miny, maxx, maxy,
-	 base_res_x, base_res_y, &inbuf, &inbuf_size, palette, no_data))
+	 base_res_x, base_res_y, &inbuf, &inbuf_size, palette, no_data,
+	 cvg))
 	goto error;
 
     if (!prepare_section_pyramid_stmts
@@ -5597,10 +5695,10 @@ do_build_124_bit_section_pyramid (sqlite3 * handle, int max_threads,
 				     "ERROR: unable to create a Pyramid Tile\n");
 			    goto error;
 			}
-		      if (rl2_raster_encode
+		      if (do_encode_pyramid_tile
 			  (raster, RL2_COMPRESSION_PNG, &blob_odd,
 			   &blob_odd_sz, &blob_even, &blob_even_sz, 100,
-			   1) != RL2_OK)
+			   sparse, 0) != RL2_OK)
 			{
 			    fprintf (stderr,
 				     "ERROR: unable to encode a Pyramid tile\n");
@@ -5672,7 +5770,8 @@ do_build_palette_section_pyramid (sqlite3 * handle, int max_threads,
 				  unsigned int tileWidth,
 				  unsigned int tileHeight,
 				  unsigned char bgRed, unsigned char bgGreen,
-				  unsigned char bgBlue)
+				  unsigned char bgBlue, int sparse,
+				  rl2CoveragePtr cvg)
 {
 /* attempting to (re)build a Palette section pyramid from scratch */
     double base_res_x;
@@ -5737,7 +5836,8 @@ do_build_palette_section_pyramid (sqlite3 * handle, int max_threads,
     if (!get_section_raw_raster_data
 	(handle, max_threads, coverage, section_id, sect_width, sect_height,
 	 RL2_SAMPLE_UINT8, RL2_PIXEL_PALETTE, 1, minx, miny, maxx, maxy,
-	 base_res_x, base_res_y, &inbuf, &inbuf_size, palette, no_data))
+	 base_res_x, base_res_y, &inbuf, &inbuf_size, palette, no_data,
+	 cvg))
 	goto error;
 
     if (!prepare_section_pyramid_stmts
@@ -5844,10 +5944,10 @@ do_build_palette_section_pyramid (sqlite3 * handle, int max_threads,
 				     "ERROR: unable to create a Pyramid Tile\n");
 			    goto error;
 			}
-		      if (rl2_raster_encode
+		      if (do_encode_pyramid_tile
 			  (raster, RL2_COMPRESSION_PNG, &blob_odd,
 			   &blob_odd_sz, &blob_even, &blob_even_sz, 100,
-			   1) != RL2_OK)
+			   sparse, 0) != RL2_OK)
 			{
 			    fprintf (stderr,
 				     "ERROR: unable to encode a Pyramid tile\n");
@@ -6080,7 +6180,8 @@ rl2_build_section_pyramid (sqlite3 * handle, const void *priv_data,
 		if (!do_build_124_bit_section_pyramid
 		    (handle, max_threads, coverage, ptrcvg->mixedResolutions,
 		     section_id, sample_type, pixel_type, num_bands, srid,
-		     tileWidth, tileHeight, bgRed, bgGreen, bgBlue))
+		     tileWidth, tileHeight, bgRed, bgGreen, bgBlue,
+		     cache->sparse_tiles, cvg))
 		    goto error;
 	    }
 	  else if (sample_type == RL2_SAMPLE_UINT8
@@ -6091,7 +6192,7 @@ rl2_build_section_pyramid (sqlite3 * handle, const void *priv_data,
 		if (!do_build_palette_section_pyramid
 		    (handle, max_threads, coverage, ptrcvg->mixedResolutions,
 		     section_id, srid, tileWidth, tileHeight, bgRed, bgGreen,
-		     bgBlue))
+		     bgBlue, cache->sparse_tiles, cvg))
 		    goto error;
 	    }
 	  else
@@ -6101,7 +6202,7 @@ rl2_build_section_pyramid (sqlite3 * handle, const void *priv_data,
 		    (handle, priv_data, coverage, section_id, sample_type,
 		     pixel_type, num_bands, compression,
 		     ptrcvg->mixedResolutions, quality, srid, tileWidth,
-		     tileHeight))
+		     tileHeight, cvg))
 		    goto error;
 	    }
 	  if (verbose)
@@ -6196,68 +6297,47 @@ is_full_mask (const unsigned char *mask, int mask_size)
     return 0;
 }
 
-RL2_DECLARE int
-rl2_build_monolithic_pyramid (sqlite3 * handle, const void *priv_data,
-			      const char *coverage, int virt_levels,
-			      int verbose)
+static void
+reset_monolithic_pyramid (MonolithicPyramidPtr pyr)
 {
-/* (re)building monolithic pyramid for a whole coverage */
-    rl2CoveragePtr cvg = NULL;
+/* releasing all resources owned by a Monolithic Pyramid context */
+    if (pyr->stmt_geo != NULL)
+	sqlite3_finalize (pyr->stmt_geo);
+    if (pyr->stmt_rd != NULL)
+	sqlite3_finalize (pyr->stmt_rd);
+    if (pyr->stmt_levl != NULL)
+	sqlite3_finalize (pyr->stmt_levl);
+    if (pyr->stmt_tils != NULL)
+	sqlite3_finalize (pyr->stmt_tils);
+    if (pyr->stmt_data != NULL)
+	sqlite3_finalize (pyr->stmt_data);
+    if (pyr->coverage != NULL)
+	rl2_destroy_coverage (pyr->coverage);
+    if (pyr->palette != NULL)
+	rl2_destroy_palette (pyr->palette);
+    memset (pyr, 0, sizeof (MonolithicPyramid));
+}
+
+static int
+init_monolithic_pyramid (sqlite3 * handle, const void *priv_data,
+			 const char *coverage, MonolithicPyramidPtr pyr,
+			 int *virt_levels)
+{
+/* initializing a Monolithic Pyramid context */
     rl2PrivCoveragePtr cov;
-    unsigned char sample_type;
-    unsigned char pixel_type;
-    unsigned char num_bands;
     unsigned char compression;
     int quality;
-    unsigned int tileWidth;
-    unsigned int tileHeight;
-    int srid;
-    double minx;
-    double miny;
-    double maxx;
-    double maxy;
-    unsigned int row;
-    unsigned int col;
-    unsigned int tot_rows;
-    double res_x;
-    double res_y;
-    int factor;
-    int resize_factor;
-    int id_level = 0;
-    unsigned char out_sample_type;
-    unsigned char out_pixel_type;
-    unsigned char out_num_bands;
-    unsigned char out_compression;
-    int out_quality;
-    rl2PixelPtr no_data = NULL;
-    rl2PixelPtr nd = NULL;
-    rl2PalettePtr palette = NULL;
-    unsigned char *buffer = NULL;
-    int buf_size;
-    int sample_sz;
-    unsigned char *mask = NULL;
-    int mask_size;
-    rl2RasterPtr raster = NULL;
-    unsigned char *blob_odd = NULL;
-    unsigned char *blob_even = NULL;
-    int blob_odd_sz;
-    int blob_even_sz;
-    sqlite3_stmt *stmt_geo = NULL;
-    sqlite3_stmt *stmt_rd = NULL;
-    sqlite3_stmt *stmt_levl = NULL;
-    sqlite3_stmt *stmt_tils = NULL;
-    sqlite3_stmt *stmt_data = NULL;
     char *xtiles;
     char *xxtiles;
-    int ret;
     char *sql;
-    double tile_minx;
-    double tile_miny;
-    double tile_maxx;
-    double tile_maxy;
-    double end_x;
-    double end_y;
-    int stop = 0;
+    int ret;
+    int sample_sz;
+    struct rl2_private_data *cache = (struct rl2_private_data *) priv_data;
+
+    memset (pyr, 0, sizeof (MonolithicPyramid));
+    pyr->priv_data = priv_data;
+    if (cache != NULL)
+	pyr->sparse = cache->sparse_tiles;
 
 /* preparing the "tiles" SQL query */
     xtiles = sqlite3_mprintf ("%s_tiles", coverage);
@@ -6270,7 +6350,8 @@ rl2_build_monolithic_pyramid (sqlite3 * handle, const void *priv_data,
 	 "ORDER BY ST_Area(geometry)", xxtiles, xtiles);
     sqlite3_free (xtiles);
     free (xxtiles);
-    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt_geo, NULL);
+    ret =
+	sqlite3_prepare_v2 (handle, sql, strlen (sql), &(pyr->stmt_geo), NULL);
     sqlite3_free (sql);
     if (ret != SQLITE_OK)
       {
@@ -6279,10 +6360,10 @@ rl2_build_monolithic_pyramid (sqlite3 * handle, const void *priv_data,
 	  goto error;
       }
 
-    cvg = rl2_create_coverage_from_dbms (handle, NULL, coverage);
-    if (cvg == NULL)
+    pyr->coverage = rl2_create_coverage_from_dbms (handle, NULL, coverage);
+    if (pyr->coverage == NULL)
 	goto error;
-    cov = (rl2PrivCoveragePtr) cvg;
+    cov = (rl2PrivCoveragePtr) (pyr->coverage);
     if (cov->mixedResolutions)
       {
 	  fprintf (stderr,
@@ -6291,88 +6372,79 @@ rl2_build_monolithic_pyramid (sqlite3 * handle, const void *priv_data,
 	  goto error;
       }
 
-    if (rl2_get_coverage_type (cvg, &sample_type, &pixel_type, &num_bands) !=
-	RL2_OK)
-	goto error;
-    if (rl2_get_coverage_compression (cvg, &compression, &quality) != RL2_OK)
+    if (rl2_get_coverage_type
+	(pyr->coverage, &(pyr->sample_type), &(pyr->pixel_type),
+	 &(pyr->num_bands)) != RL2_OK)
 	goto error;
-    if (rl2_get_coverage_tile_size (cvg, &tileWidth, &tileHeight) != RL2_OK)
+    if (rl2_get_coverage_compression (pyr->coverage, &compression, &quality)
+	!= RL2_OK)
 	goto error;
-    if (rl2_get_coverage_srid (cvg, &srid) != RL2_OK)
+    if (rl2_get_coverage_tile_size
+	(pyr->coverage, &(pyr->tile_width), &(pyr->tile_height)) != RL2_OK)
 	goto error;
-    if (!get_coverage_extent (handle, coverage, &minx, &miny, &maxx, &maxy))
+    if (rl2_get_coverage_srid (pyr->coverage, &(pyr->srid)) != RL2_OK)
 	goto error;
-    no_data = rl2_get_coverage_no_data (cvg);
-    palette = rl2_get_dbms_palette (handle, NULL, coverage);
+    pyr->no_data = rl2_get_coverage_no_data (pyr->coverage);
+    pyr->palette = rl2_get_dbms_palette (handle, NULL, coverage);
+    if (pyr->pixel_type == RL2_PIXEL_PALETTE && pyr->palette == NULL)
+      {
+	  fprintf (stderr, "ERROR: unable to load the Palette of \"%s\"\n",
+		   coverage);
+	  goto error;
+      }
     if (!prepare_section_pyramid_stmts
-	(handle, coverage, 0, &stmt_rd, &stmt_levl, &stmt_tils, &stmt_data))
+	(handle, coverage, 0, &(pyr->stmt_rd), &(pyr->stmt_levl),
+	 &(pyr->stmt_tils), &(pyr->stmt_data)))
 	goto error;
 
-    if (sample_type == RL2_SAMPLE_1_BIT
-	&& pixel_type == RL2_PIXEL_MONOCHROME && num_bands == 1)
+    if (pyr->sample_type == RL2_SAMPLE_1_BIT
+	&& pyr->pixel_type == RL2_PIXEL_MONOCHROME && pyr->num_bands == 1)
       {
 	  /* monochrome: output colorspace is Grayscale compression PNG */
-	  out_sample_type = RL2_SAMPLE_UINT8;
-	  out_pixel_type = RL2_PIXEL_GRAYSCALE;
-	  out_num_bands = 1;
-	  out_compression = RL2_COMPRESSION_PNG;
-	  out_quality = 100;
-	  virt_levels = 1;
-      }
-    else if ((sample_type == RL2_SAMPLE_1_BIT
-	      && pixel_type == RL2_PIXEL_PALETTE && num_bands == 1)
-	     || (sample_type == RL2_SAMPLE_2_BIT
-		 && pixel_type == RL2_PIXEL_PALETTE && num_bands == 1)
-	     || (sample_type == RL2_SAMPLE_4_BIT))
+	  pyr->out_sample_type = RL2_SAMPLE_UINT8;
+	  pyr->out_pixel_type = RL2_PIXEL_GRAYSCALE;
+	  pyr->out_num_bands = 1;
+	  pyr->out_compression = RL2_COMPRESSION_PNG;
+	  pyr->out_quality = 100;
+	  *virt_levels = 1;
+      }
+    else if ((pyr->sample_type == RL2_SAMPLE_1_BIT
+	      && pyr->pixel_type == RL2_PIXEL_PALETTE && pyr->num_bands == 1)
+	     || (pyr->sample_type == RL2_SAMPLE_2_BIT
+		 && pyr->pixel_type == RL2_PIXEL_PALETTE
+		 && pyr->num_bands == 1)
+	     || (pyr->sample_type == RL2_SAMPLE_4_BIT))
       {
 	  /* palette 1,2,4: output colorspace is RGB compression PNG */
-	  out_sample_type = RL2_SAMPLE_UINT8;
-	  out_pixel_type = RL2_PIXEL_RGB;
-	  out_num_bands = 3;
-	  out_compression = RL2_COMPRESSION_PNG;
-	  out_quality = 100;
-	  virt_levels = 1;
+	  pyr->out_sample_type = RL2_SAMPLE_UINT8;
+	  pyr->out_pixel_type = RL2_PIXEL_RGB;
+	  pyr->out_num_bands = 3;
+	  pyr->out_compression = RL2_COMPRESSION_PNG;
+	  pyr->out_quality = 100;
+	  *virt_levels = 1;
       }
-    else if (sample_type == RL2_SAMPLE_UINT8
-	     && pixel_type == RL2_PIXEL_PALETTE && num_bands == 1)
+    else if (pyr->sample_type == RL2_SAMPLE_UINT8
+	     && pyr->pixel_type == RL2_PIXEL_PALETTE && pyr->num_bands == 1)
       {
 	  /* palette 8: output colorspace is RGB compression PNG */
-	  out_sample_type = RL2_SAMPLE_UINT8;
-	  out_pixel_type = RL2_PIXEL_RGB;
-	  out_num_bands = 3;
-	  out_compression = RL2_COMPRESSION_PNG;
-	  out_quality = 100;
+	  pyr->out_sample_type = RL2_SAMPLE_UINT8;
+	  pyr->out_pixel_type = RL2_PIXEL_RGB;
+	  pyr->out_num_bands = 3;
+	  pyr->out_compression = RL2_COMPRESSION_PNG;
+	  pyr->out_quality = 100;
       }
     else
       {
 	  /* unaltered output colorspace */
-	  out_sample_type = sample_type;
-	  out_pixel_type = pixel_type;
-	  out_num_bands = num_bands;
-	  out_compression = compression;
-	  out_quality = quality;
+	  pyr->out_sample_type = pyr->sample_type;
+	  pyr->out_pixel_type = pyr->pixel_type;
+	  pyr->out_num_bands = pyr->num_bands;
+	  pyr->out_compression = compression;
+	  pyr->out_quality = quality;
       }
 
-    /* setting the requested virt_levels */
-    switch (virt_levels)
-      {
-      case 1:			/* separating each physical level */
-	  resize_factor = 2;
-	  break;
-      case 2:			/* one physical + one virtual */
-	  resize_factor = 4;
-	  break;
-      case 3:			/* one physical + two virtuals */
-	  resize_factor = 8;
-	  break;
-      default:
-	  resize_factor = 8;
-	  break;
-      };
-    factor = resize_factor;
-
 /* computing output tile buffers */
-    switch (out_sample_type)
+    switch (pyr->out_sample_type)
       {
       case RL2_SAMPLE_INT16:
       case RL2_SAMPLE_UINT16:
@@ -6390,302 +6462,1130 @@ rl2_build_monolithic_pyramid (sqlite3 * handle, const void *priv_data,
 	  sample_sz = 1;
 	  break;
       }
-    buf_size = tileWidth * tileHeight * out_num_bands * sample_sz;
+    pyr->buf_size =
+	pyr->tile_width * pyr->tile_height * pyr->out_num_bands * sample_sz;
+    return 1;
 
-/* attempting to delete the section pyramid */
-    if (rl2_delete_all_pyramids (handle, coverage) != RL2_OK)
-	goto error;
+  error:
+    reset_monolithic_pyramid (pyr);
+    return 0;
+}
 
-/* attempting to (re)build the section pyramid */
-    while (1)
+static int
+do_build_monolithic_tile (sqlite3 * handle, MonolithicPyramidPtr pyr,
+			  int id_level, int resize_factor, double res_x,
+			  double res_y, double tile_minx, double tile_miny,
+			  double tile_maxx, double tile_maxy, double end_x,
+			  double end_y)
+{
+/* building and INSERTing a single Monolithic Pyramid tile */
+    unsigned char sample_type = pyr->sample_type;
+    unsigned char pixel_type = pyr->pixel_type;
+    unsigned char num_bands = pyr->num_bands;
+    unsigned int tileWidth = pyr->tile_width;
+    unsigned int tileHeight = pyr->tile_height;
+    int buf_size = pyr->buf_size;
+    rl2PixelPtr no_data = pyr->no_data;
+    rl2PixelPtr nd = NULL;
+    unsigned char *buffer = NULL;
+    unsigned char *mask = NULL;
+    int mask_size;
+    rl2RasterPtr raster = NULL;
+    unsigned char *blob_odd = NULL;
+    unsigned char *blob_even = NULL;
+    int blob_odd_sz;
+    int blob_even_sz;
+
+/* allocating output tile buffers */
+    buffer = malloc (buf_size);
+    if (buffer == NULL)
+	goto error;
+    memset (buffer, 0, buf_size);
+    mask_size = tileWidth * tileHeight;
+    mask = malloc (mask_size);
+    if (mask == NULL)
+	goto error;
+    memset (mask, 0, mask_size);
+
+    if ((sample_type == RL2_SAMPLE_UINT8
+	 && pixel_type == RL2_PIXEL_GRAYSCALE && num_bands == 1)
+	|| (sample_type == RL2_SAMPLE_UINT8
+	    && pixel_type == RL2_PIXEL_RGB && num_bands == 3)
+	|| (sample_type == RL2_SAMPLE_UINT8
+	    && pixel_type == RL2_PIXEL_PALETTE && num_bands == 1))
+      {
+	  /* RGB, PALETTE or GRAYSCALE datasource (UINT8) */
+	  if (!rescale_monolithic_rgba
+	      (pyr->priv_data, id_level, tileWidth, tileHeight, resize_factor,
+	       res_x, res_y, tile_minx, tile_miny, tile_maxx, tile_maxy,
+	       buffer, buf_size, mask, &mask_size, pyr->palette, no_data,
+	       pyr->stmt_geo, pyr->stmt_rd, pyr->coverage))
+	      goto error;
+	  if (mask_size == 0)
+	      mask = NULL;
+      }
+    else if (((sample_type == RL2_SAMPLE_1_BIT
+	       || sample_type == RL2_SAMPLE_2_BIT
+	       || sample_type == RL2_SAMPLE_4_BIT)
+	      && pixel_type == RL2_PIXEL_PALETTE && num_bands == 1)
+	     || (sample_type == RL2_SAMPLE_1_BIT
+		 && pixel_type == RL2_PIXEL_MONOCHROME && num_bands == 1))
+      {
+	  /* MONOCHROME and 1,2,4 bit PALETTE */
+	  if (!rescale_monolithic_124
+	      (id_level, tileWidth, tileHeight, resize_factor, pixel_type,
+	       res_x, res_y, tile_minx, tile_miny, tile_maxx, tile_maxy,
+	       buffer, buf_size, mask, &mask_size, pyr->palette, no_data,
+	       pyr->stmt_geo, pyr->stmt_rd, pyr->coverage))
+	      goto error;
+	  if (mask_size == 0)
+	      mask = NULL;
+      }
+    else if (pixel_type == RL2_PIXEL_MULTIBAND)
       {
-	  /* looping on pyramid levels */
-	  tile_maxy = maxy;
-	  row = 0;
-	  res_x = cov->hResolution * (double) factor;
-	  res_y = cov->vResolution * (double) factor;
-	  if (!do_insert_pyramid_levels
-	      (handle, id_level + 1, res_x, res_y, stmt_levl))
+	  /* MultiBand */
+	  if (!rescale_monolithic_multiband
+	      (id_level, tileWidth, tileHeight, sample_type, num_bands,
+	       resize_factor, res_x, res_y, tile_minx, tile_miny, tile_maxx,
+	       tile_maxy, buffer, buf_size, mask, &mask_size, no_data,
+	       pyr->stmt_geo, pyr->stmt_rd, pyr->coverage))
 	      goto error;
-	  tot_rows = 0;
-	  while (1)
+	  if (mask_size == 0)
+	      mask = NULL;
+      }
+    else if (pixel_type == RL2_PIXEL_DATAGRID)
+      {
+	  /* DataGrid */
+	  if (!rescale_monolithic_datagrid
+	      (id_level, tileWidth, tileHeight, sample_type, resize_factor,
+	       res_x, res_y, tile_minx, tile_miny, tile_maxx, tile_maxy,
+	       buffer, buf_size, mask, &mask_size, no_data, pyr->stmt_geo,
+	       pyr->stmt_rd, pyr->coverage))
+	      goto error;
+	  if (mask_size == 0)
+	      mask = NULL;
+      }
+    else
+      {
+	  /* unknown */
+	  fprintf (stderr, "ERROR: unsupported Monolithic pyramid type\n");
+	  goto error;
+      }
+    if (is_full_mask (mask, mask_size))
+      {
+	  /* skipping a completely void tile */
+	  free (buffer);
+	  free (mask);
+	  return 1;
+      }
+    if (pixel_type == RL2_PIXEL_MONOCHROME)
+      {
+	  if (no_data == NULL)
+	      nd = NULL;
+	  else
 	    {
-		/* pre-computing the max row-number */
-		tile_miny = tile_maxy - ((double) tileHeight * res_y);
-		tile_minx = minx;
-		if (tile_maxy < miny)
-		    break;
-		tot_rows++;
-		tile_maxy = tile_miny;
+		nd = rl2_create_pixel (RL2_SAMPLE_UINT8, RL2_PIXEL_GRAYSCALE,
+				       1);
+		rl2_set_pixel_sample_uint8 (nd, RL2_GRAYSCALE_BAND, 255);
 	    }
-
-	  tile_maxy = maxy;
-	  while (1)
+      }
+    else if (pixel_type == RL2_PIXEL_PALETTE)
+      {
+	  if (no_data == NULL)
+	      nd = NULL;
+	  else
 	    {
-		/* looping on rows */
-		tile_miny = tile_maxy - ((double) tileHeight * res_y);
-		tile_minx = minx;
-		if (tile_maxy < miny)
-		    break;
-		col = 0;
-		while (1)
-		  {
-		      /* looping on columns */
-		      tile_maxx = tile_minx + ((double) tileWidth * res_x);
-		      if (tile_minx > maxx)
-			  break;
-		      /* allocating output tile buffers */
-		      buffer = malloc (buf_size);
-		      if (buffer == NULL)
-			  goto error;
-		      memset (buffer, 0, buf_size);
-		      mask_size = tileWidth * tileHeight;
-		      mask = malloc (mask_size);
-		      if (mask == NULL)
-			  goto error;
-		      memset (mask, 0, mask_size);
-		      end_x = tile_maxx;
-		      if (tile_maxx > maxx)
-			  end_x = maxx;
-		      end_y = tile_miny;
-		      if (tile_miny < miny)
-			  end_y = miny;
+		nd = rl2_create_pixel (RL2_SAMPLE_UINT8, RL2_PIXEL_RGB, 3);
+		rl2_set_pixel_sample_uint8 (nd, RL2_RED_BAND, 255);
+		rl2_set_pixel_sample_uint8 (nd, RL2_GREEN_BAND, 255);
+		rl2_set_pixel_sample_uint8 (nd, RL2_BLUE_BAND, 255);
+	    }
+      }
+    else
+	nd = rl2_clone_pixel (no_data);
 
-		      if ((sample_type == RL2_SAMPLE_UINT8
-			   && pixel_type == RL2_PIXEL_GRAYSCALE
-			   && num_bands == 1)
-			  || (sample_type == RL2_SAMPLE_UINT8
-			      && pixel_type == RL2_PIXEL_RGB
-			      && num_bands == 3)
-			  || (sample_type == RL2_SAMPLE_UINT8
-			      && pixel_type == RL2_PIXEL_PALETTE
-			      && num_bands == 1))
-			{
-			    /* RGB, PALETTE or GRAYSCALE datasource (UINT8) */
-			    if (!rescale_monolithic_rgba
-				(priv_data, id_level, tileWidth, tileHeight,
-				 resize_factor, res_x, res_y, tile_minx,
-				 tile_miny, tile_maxx, tile_maxy, buffer,
-				 buf_size, mask, &mask_size, palette, no_data,
-				 stmt_geo, stmt_rd))
-				goto error;
-			    if (mask_size == 0)
-				mask = NULL;
-			}
-		      else if (((sample_type == RL2_SAMPLE_1_BIT
-				 || sample_type == RL2_SAMPLE_2_BIT
-				 || sample_type == RL2_SAMPLE_4_BIT)
-				&& pixel_type == RL2_PIXEL_PALETTE
-				&& num_bands == 1)
-			       || (sample_type == RL2_SAMPLE_1_BIT
-				   && pixel_type == RL2_PIXEL_MONOCHROME
-				   && num_bands == 1))
-			{
-			    /* MONOCHROME and 1,2,4 bit PALETTE */
-			    if (!rescale_monolithic_124
-				(id_level, tileWidth,
-				 tileHeight, resize_factor, pixel_type,
-				 res_x, res_y, tile_minx, tile_miny,
-				 tile_maxx, tile_maxy, buffer, buf_size, mask,
-				 &mask_size, palette, no_data, stmt_geo,
-				 stmt_rd))
-				goto error;
-			    if (mask_size == 0)
-				mask = NULL;
-			}
-		      else if (pixel_type == RL2_PIXEL_MULTIBAND)
-			{
-			    /* MultiBand */
-			    if (!rescale_monolithic_multiband
-				(id_level, tileWidth, tileHeight, sample_type,
-				 num_bands, resize_factor, res_x, res_y,
-				 tile_minx, tile_miny, tile_maxx, tile_maxy,
-				 buffer, buf_size, mask, &mask_size, no_data,
-				 stmt_geo, stmt_rd))
-				goto error;
-			    if (mask_size == 0)
-				mask = NULL;
-			}
-		      else if (pixel_type == RL2_PIXEL_DATAGRID)
-			{
-			    /* DataGrid */
-			    if (!rescale_monolithic_datagrid
-				(id_level, tileWidth, tileHeight, sample_type,
-				 resize_factor, res_x, res_y, tile_minx,
-				 tile_miny, tile_maxx, tile_maxy, buffer,
-				 buf_size, mask, &mask_size, no_data,
-				 stmt_geo, stmt_rd))
-				goto error;
-			    if (mask_size == 0)
-				mask = NULL;
-			}
-		      else
-			{
-			    /* unknown */
-			    fprintf (stderr,
-				     "ERROR: unsupported Monolithic pyramid type\n");
-			    goto error;
-			}
-		      if (is_full_mask (mask, mask_size))
-			{
-			    /* skipping a completely void tile */
-			    free (buffer);
-			    free (mask);
-			    buffer = NULL;
-			    mask = NULL;
-			    goto done;
-			}
-		      if (pixel_type == RL2_PIXEL_MONOCHROME)
-			{
-			    if (no_data == NULL)
-				nd = NULL;
-			    else
-			      {
-				  nd = rl2_create_pixel (RL2_SAMPLE_UINT8,
-							 RL2_PIXEL_GRAYSCALE,
-							 1);
-				  rl2_set_pixel_sample_uint8 (nd,
-							      RL2_GRAYSCALE_BAND,
-							      255);
-			      }
-			}
-		      else if (pixel_type == RL2_PIXEL_PALETTE)
+    raster =
+	rl2_create_raster (tileWidth, tileHeight, pyr->out_sample_type,
+			   pyr->out_pixel_type, pyr->out_num_bands, buffer,
+			   buf_size, NULL, mask, mask_size, nd);
+    buffer = NULL;
+    mask = NULL;
+    if (raster == NULL)
+      {
+	  fprintf (stderr, "ERROR: unable to create a Pyramid Tile\n");
+	  goto error;
+      }
+    if (do_encode_pyramid_tile
+	(raster, pyr->out_compression, &blob_odd, &blob_odd_sz, &blob_even,
+	 &blob_even_sz, pyr->out_quality, pyr->sparse,
+	 pyr->coverage) != RL2_OK)
+      {
+	  fprintf (stderr, "ERROR: unable to encode a Pyramid tile\n");
+	  goto error;
+      }
+
+    /* INSERTing the tile */
+    if (!do_insert_pyramid_tile
+	(handle, blob_odd, blob_odd_sz, blob_even, blob_even_sz, id_level + 1,
+	 -1, pyr->srid, tile_minx, end_y, end_x, tile_maxy, pyr->stmt_tils,
+	 pyr->stmt_data))
+	goto error;
+    rl2_destroy_raster (raster);
+    return 1;
+
+  error:
+    if (buffer != NULL)
+	free (buffer);
+    if (mask != NULL)
+	free (mask);
+    if (raster != NULL)
+	rl2_destroy_raster (raster);
+    return 0;
+}
+
+static int
+enable_pyramid_tracking (sqlite3 * handle, const char *coverage)
+{
+/*
+/ creating (if not already existing) the PYRAMID_DIRTY table
+/ and the Triggers recording the footprint of any Section
+/ INSERTed, UPDATEd or DELETEd after the Monolithic Pyramid was built
+/ (an UPDATE records both the OLD and the NEW footprint)
+*/
+    char *table;
+    char *xtable;
+    char *xsections;
+    char *trigger;
+    char *xtrigger;
+    char *sql1;
+    char *sql;
+    char *sql_err = NULL;
+    int ret;
+
+    table = sqlite3_mprintf ("%s_pyramid_dirty", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    table = sqlite3_mprintf ("%s_sections", coverage);
+    xsections = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    trigger = sqlite3_mprintf ("%s_sections_pyramid_insert", coverage);
+    xtrigger = rl2_double_quoted_sql (trigger);
+    sqlite3_free (trigger);
+    sql1 = sqlite3_mprintf ("CREATE TABLE IF NOT EXISTS main.\"%s\" (\n"
+			    "\tdirty_id INTEGER PRIMARY KEY AUTOINCREMENT,\n"
+			    "\tsection_id INTEGER NOT NULL,\n"
+			    "\tminx DOUBLE NOT NULL,\n"
+			    "\tminy DOUBLE NOT NULL,\n"
+			    "\tmaxx DOUBLE NOT NULL,\n"
+			    "\tmaxy DOUBLE NOT NULL);\n"
+			    "CREATE TRIGGER IF NOT EXISTS main.\"%s\"\n"
+			    "AFTER INSERT ON \"%s\"\nFOR EACH ROW BEGIN\n"
+			    "INSERT INTO \"%s\" (section_id, minx, miny, maxx, maxy) "
+			    "VALUES (NEW.section_id, MbrMinX(NEW.geometry), "
+			    "MbrMinY(NEW.geometry), MbrMaxX(NEW.geometry), "
+			    "MbrMaxY(NEW.geometry));\nEND;\n", xtable, xtrigger,
+			    xsections, xtable);
+    free (xtrigger);
+    trigger = sqlite3_mprintf ("%s_sections_pyramid_delete", coverage);
+    xtrigger = rl2_double_quoted_sql (trigger);
+    sqlite3_free (trigger);
+    sql = sqlite3_mprintf ("%s"
+			   "CREATE TRIGGER IF NOT EXISTS main.\"%s\"\n"
+			   "AFTER DELETE ON \"%s\"\nFOR EACH ROW BEGIN\n"
+			   "INSERT INTO \"%s\" (section_id, minx, miny, maxx, maxy) "
+			   "VALUES (OLD.section_id, MbrMinX(OLD.geometry), "
+			   "MbrMinY(OLD.geometry), MbrMaxX(OLD.geometry), "
+			   "MbrMaxY(OLD.geometry));\nEND;\n", sql1, xtrigger,
+			   xsections, xtable);
+    sqlite3_free (sql1);
+    free (xtrigger);
+    sql1 = sql;
+    trigger = sqlite3_mprintf ("%s_sections_pyramid_update", coverage);
+    xtrigger = rl2_double_quoted_sql (trigger);
+    sqlite3_free (trigger);
+    sql = sqlite3_mprintf ("%s"
+			   "CREATE TRIGGER IF NOT EXISTS main.\"%s\"\n"
+			   "AFTER UPDATE ON \"%s\"\nFOR EACH ROW BEGIN\n"
+			   "INSERT INTO \"%s\" (section_id, minx, miny, maxx, maxy) "
+			   "VALUES (OLD.section_id, MbrMinX(OLD.geometry), "
+			   "MbrMinY(OLD.geometry), MbrMaxX(OLD.geometry), "
+			   "MbrMaxY(OLD.geometry));\n"
+			   "INSERT INTO \"%s\" (section_id, minx, miny, maxx, maxy) "
+			   "VALUES (NEW.section_id, MbrMinX(NEW.geometry), "
+			   "MbrMinY(NEW.geometry), MbrMaxX(NEW.geometry), "
+			   "MbrMaxY(NEW.geometry));\nEND;\n"
+			   "DELETE FROM main.\"%s\"", sql1, xtrigger, xsections,
+			   xtable, xtable, xtable);
+    sqlite3_free (sql1);
+    free (xtrigger);
+    free (xsections);
+    free (xtable);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CREATE TABLE \"%s_pyramid_dirty\" error: %s\n",
+		   coverage, sql_err);
+	  sqlite3_free (sql_err);
+	  sqlite3_free (sql);
+	  return 0;
+      }
+    sqlite3_free (sql);
+    return 1;
+}
+
+RL2_DECLARE int
+rl2_build_monolithic_pyramid (sqlite3 * handle, const void *priv_data,
+			      const char *coverage, int virt_levels,
+			      int verbose)
+{
+/* (re)building monolithic pyramid for a whole coverage */
+    MonolithicPyramid pyr;
+    rl2PrivCoveragePtr cov;
+    unsigned int tileWidth;
+    unsigned int tileHeight;
+    double minx;
+    double miny;
+    double maxx;
+    double maxy;
+    unsigned int row;
+    unsigned int tot_rows;
+    double res_x;
+    double res_y;
+    int factor;
+    int resize_factor;
+    int id_level = 0;
+    double tile_minx;
+    double tile_miny;
+    double tile_maxx;
+    double tile_maxy;
+    double end_x;
+    double end_y;
+    int stop = 0;
+
+    if (!init_monolithic_pyramid
+	(handle, priv_data, coverage, &pyr, &virt_levels))
+	return RL2_ERROR;
+    cov = (rl2PrivCoveragePtr) (pyr.coverage);
+    tileWidth = pyr.tile_width;
+    tileHeight = pyr.tile_height;
+    if (!get_coverage_extent (handle, coverage, &minx, &miny, &maxx, &maxy))
+	goto error;
+
+    /* setting the requested virt_levels */
+    switch (virt_levels)
+      {
+      case 1:			/* separating each physical level */
+	  resize_factor = 2;
+	  break;
+      case 2:			/* one physical + one virtual */
+	  resize_factor = 4;
+	  break;
+      case 3:			/* one physical + two virtuals */
+	  resize_factor = 8;
+	  break;
+      default:
+	  resize_factor = 8;
+	  break;
+      };
+    factor = resize_factor;
+
+/* attempting to delete the section pyramid */
+    if (rl2_delete_all_pyramids (handle, coverage) != RL2_OK)
+	goto error;
+
+/* attempting to (re)build the section pyramid */
+    while (1)
+      {
+	  /* looping on pyramid levels */
+	  tile_maxy = maxy;
+	  row = 0;
+	  res_x = cov->hResolution * (double) factor;
+	  res_y = cov->vResolution * (double) factor;
+	  if (!do_insert_pyramid_levels
+	      (handle, id_level + 1, res_x, res_y, pyr.stmt_levl))
+	      goto error;
+	  tot_rows = 0;
+	  while (1)
+	    {
+		/* pre-computing the max row-number */
+		tile_miny = tile_maxy - ((double) tileHeight * res_y);
+		tile_minx = minx;
+		if (tile_maxy < miny)
+		    break;
+		tot_rows++;
+		tile_maxy = tile_miny;
+	    }
+
+	  tile_maxy = maxy;
+	  while (1)
+	    {
+		/* looping on rows */
+		tile_miny = tile_maxy - ((double) tileHeight * res_y);
+		tile_minx = minx;
+		if (tile_maxy < miny)
+		    break;
+		while (1)
+		  {
+		      /* looping on columns */
+		      tile_maxx = tile_minx + ((double) tileWidth * res_x);
+		      if (tile_minx > maxx)
+			  break;
+		      end_x = tile_maxx;
+		      if (tile_maxx > maxx)
+			  end_x = maxx;
+		      end_y = tile_miny;
+		      if (tile_miny < miny)
+			  end_y = miny;
+		      if (!do_build_monolithic_tile
+			  (handle, &pyr, id_level, resize_factor, res_x, res_y,
+			   tile_minx, tile_miny, tile_maxx, tile_maxy, end_x,
+			   end_y))
+			  goto error;
+		      tile_minx = tile_maxx;
+		  }
+		tile_maxy = tile_miny;
+		row++;
+		if (verbose)
+		  {
+		      printf ("  ----------\n");
+		      printf
+			  ("    %s: Monolithic Pyramid Level %d - Row %d of %d  successfully built\n",
+			   coverage, id_level + 1, row, tot_rows);
+		  }
+	    }
+	  if (stop)
+	      break;
+	  if ((minx +
+	       ((double) tileWidth * res_x) > maxx)
+	      && (maxy - ((double) tileHeight * res_y) < miny))
+	      stop = 1;
+	  /* setting the requested virt_levels */
+	  switch (virt_levels)
+	    {
+	    case 1:		/* separating each physical level */
+		resize_factor = 2;
+		break;
+	    case 2:		/* one physical + one virtual */
+		resize_factor = 4;
+		break;
+	    case 3:		/* one physical + two virtuals */
+		resize_factor = 8;
+		break;
+	    };
+	  factor *= resize_factor;
+	  id_level++;
+	  if (pyr.palette != NULL)
+	    {
+		/* destroying an eventual Palette after completing the first level */
+		rl2_destroy_palette (pyr.palette);
+		pyr.palette = NULL;
+	    }
+      }
+
+/* enabling the incremental maintenance of the Monolithic Pyramid */
+    if (!enable_pyramid_tracking (handle, coverage))
+	goto error;
+    reset_monolithic_pyramid (&pyr);
+    if (verbose)
+      {
+	  printf ("  ----------\n");
+	  printf
+	      ("    Monolithic Pyramid levels successfully built for: %s\n",
+	       coverage);
+      }
+    return RL2_OK;
+
+  error:
+    reset_monolithic_pyramid (&pyr);
+    return RL2_ERROR;
+}
+
+static int
+check_table_exists (sqlite3 * handle, const char *table)
+{
+/* testing if some table does actually exist (-1 on SQL error) */
+    char *sql;
+    char **results;
+    int rows;
+    int columns;
+    int ret;
+    int exists = 0;
+
+    sql =
+	sqlite3_mprintf ("SELECT name FROM main.sqlite_master WHERE "
+			 "type = 'table' AND Lower(name) = Lower(%Q)", table);
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "SELECT sqlite_master SQL error: %s\n",
+		   sqlite3_errmsg (handle));
+	  return -1;
+      }
+    if (rows >= 1)
+	exists = 1;
+    sqlite3_free_table (results);
+    return exists;
+}
+
+static int
+has_monolithic_pyramid (sqlite3 * handle, const char *coverage)
+{
+/* 
+/ testing if a Coverage is currently supported by a Monolithic Pyramid
+/ (-1 on SQL error)
+*/
+    char *table;
+    char *xtable;
+    char *sql;
+    char **results;
+    int rows;
+    int columns;
+    int ret;
+    int exists = 0;
+
+    table = sqlite3_mprintf ("%s_tiles", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql =
+	sqlite3_mprintf ("SELECT tile_id FROM main.\"%s\" WHERE "
+			 "pyramid_level > 0 AND section_id IS NULL LIMIT 1",
+			 xtable);
+    free (xtable);
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "SELECT Monolithic Pyramid tiles SQL error: %s\n",
+		   sqlite3_errmsg (handle));
+	  return -1;
+      }
+    if (rows >= 1)
+	exists = 1;
+    sqlite3_free_table (results);
+    return exists;
+}
+
+static int
+load_pyramid_dirty (sqlite3 * handle, const char *coverage, double **rects,
+		    int *count)
+{
+/* loading all the dirty footprints (MinX, MinY, MaxX, MaxY) */
+    char *table;
+    char *xtable;
+    char *sql;
+    sqlite3_stmt *stmt = NULL;
+    double *list = NULL;
+    int max = 0;
+    int cnt = 0;
+    int ret;
+
+    *rects = NULL;
+    *count = 0;
+    table = sqlite3_mprintf ("%s_pyramid_dirty", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql =
+	sqlite3_mprintf ("SELECT minx, miny, maxx, maxy FROM main.\"%s\" "
+			 "WHERE minx IS NOT NULL AND miny IS NOT NULL AND "
+			 "maxx IS NOT NULL AND maxy IS NOT NULL", xtable);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "SELECT pyramid_dirty SQL error: %s\n",
+		   sqlite3_errmsg (handle));
+	  goto error;
+      }
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		double *p;
+		if (cnt == max)
+		  {
+		      double *save = list;
+		      max += 64;
+		      list = realloc (list, sizeof (double) * 4 * max);
+		      if (list == NULL)
 			{
-			    if (no_data == NULL)
-				nd = NULL;
-			    else
-			      {
-				  nd = rl2_create_pixel (RL2_SAMPLE_UINT8,
-							 RL2_PIXEL_RGB, 3);
-				  rl2_set_pixel_sample_uint8 (nd,
-							      RL2_RED_BAND,
-							      255);
-				  rl2_set_pixel_sample_uint8 (nd,
-							      RL2_GREEN_BAND,
-							      255);
-				  rl2_set_pixel_sample_uint8 (nd,
-							      RL2_BLUE_BAND,
-							      255);
-			      }
+			    free (save);
+			    goto error;
 			}
-		      else
-			  nd = rl2_clone_pixel (no_data);
+		  }
+		p = list + (cnt * 4);
+		*(p + 0) = sqlite3_column_double (stmt, 0);
+		*(p + 1) = sqlite3_column_double (stmt, 1);
+		*(p + 2) = sqlite3_column_double (stmt, 2);
+		*(p + 3) = sqlite3_column_double (stmt, 3);
+		cnt++;
+	    }
+	  else
+	    {
+		fprintf (stderr, "SELECT pyramid_dirty; sqlite3_step() error: "
+			 "%s\n", sqlite3_errmsg (handle));
+		if (list != NULL)
+		    free (list);
+		goto error;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    *rects = list;
+    *count = cnt;
+    return 1;
+
+  error:
+    if (stmt != NULL)
+	sqlite3_finalize (stmt);
+    return 0;
+}
+
+static int
+load_monolithic_levels (sqlite3 * handle, const char *coverage,
+			double base_res_x, int *factors, int max_levels,
+			int *count)
+{
+/*
+/ retrieving the scale factor of each Monolithic Pyramid level
+/ (level 1 is the first one); the levels must be contiguous and
+/ each one must rescale the previous by 2, 4 or 8
+/
+/ returns 1 on success, 0 on unexpected levels layout
+/ or -1 on SQL error
+*/
+    char *table;
+    char *xtable;
+    char *sql;
+    sqlite3_stmt *stmt = NULL;
+    int cnt = 0;
+    int prev = 1;
+    int ret;
+
+    *count = 0;
+    table = sqlite3_mprintf ("%s_levels", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql =
+	sqlite3_mprintf ("SELECT pyramid_level, x_resolution_1_1 "
+			 "FROM main.\"%s\" WHERE pyramid_level > 0 "
+			 "ORDER BY pyramid_level", xtable);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "SELECT levels SQL error: %s\n",
+		   sqlite3_errmsg (handle));
+	  return -1;
+      }
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		int level = sqlite3_column_int (stmt, 0);
+		double res = sqlite3_column_double (stmt, 1);
+		int factor = (int) ((res / base_res_x) + 0.5);
+		int resize;
+		if (level != cnt + 1 || cnt >= max_levels)
+		    goto error;
+		resize = factor / prev;
+		if (resize != 2 && resize != 4 && resize != 8)
+		    goto error;
+		if (prev * resize != factor)
+		    goto error;
+		*(factors + cnt) = factor;
+		prev = factor;
+		cnt++;
+	    }
+	  else
+	    {
+		fprintf (stderr, "SELECT levels; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (handle));
+		sqlite3_finalize (stmt);
+		return -1;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    *count = cnt;
+    return 1;
 
-		      raster =
-			  rl2_create_raster (tileWidth, tileHeight,
-					     out_sample_type, out_pixel_type,
-					     out_num_bands, buffer, buf_size,
-					     NULL, mask, mask_size, nd);
-		      buffer = NULL;
-		      mask = NULL;
-		      if (raster == NULL)
-			{
-			    fprintf (stderr,
-				     "ERROR: unable to create a Pyramid Tile\n");
-			    goto error;
-			}
-		      if (rl2_raster_encode
-			  (raster, out_compression, &blob_odd, &blob_odd_sz,
-			   &blob_even, &blob_even_sz, out_quality, 1) != RL2_OK)
+  error:
+    if (stmt != NULL)
+	sqlite3_finalize (stmt);
+    return 0;
+}
+
+static int
+get_monolithic_grid_origin (sqlite3 * handle, const char *coverage,
+			    int id_level, double *origin_x, double *origin_y)
+{
+/* 
+/ retrieving the tile grid origin of some Monolithic Pyramid level;
+/ any tile will do, because all tiles share the same grid alignment
+/ (the output args are left untouched if the level is empty)
+*/
+    char *table;
+    char *xtable;
+    char *sql;
+    sqlite3_stmt *stmt = NULL;
+    int ret;
+
+    table = sqlite3_mprintf ("%s_tiles", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql =
+	sqlite3_mprintf ("SELECT MbrMinX(geometry), MbrMaxY(geometry) "
+			 "FROM main.\"%s\" WHERE pyramid_level = ? AND "
+			 "section_id IS NULL LIMIT 1", xtable);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "SELECT tiles origin SQL error: %s\n",
+		   sqlite3_errmsg (handle));
+	  return 0;
+      }
+    sqlite3_bind_int (stmt, 1, id_level);
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW)
+      {
+	  if (sqlite3_column_type (stmt, 0) == SQLITE_FLOAT
+	      && sqlite3_column_type (stmt, 1) == SQLITE_FLOAT)
+	    {
+		*origin_x = sqlite3_column_double (stmt, 0);
+		*origin_y = sqlite3_column_double (stmt, 1);
+	    }
+      }
+    else if (ret != SQLITE_DONE)
+      {
+	  fprintf (stderr, "SELECT tiles origin; sqlite3_step() error: %s\n",
+		   sqlite3_errmsg (handle));
+	  sqlite3_finalize (stmt);
+	  return 0;
+      }
+    sqlite3_finalize (stmt);
+    return 1;
+}
+
+static void
+snap_dirty_rect (double *rect, double origin_x, double origin_y,
+		 double tile_w, double tile_h)
+{
+/* expanding a dirty footprint so to exactly match the tile grid */
+    double c0 = floor (((*(rect + 0) - origin_x) / tile_w) + 0.0000001);
+    double c1 = ceil (((*(rect + 2) - origin_x) / tile_w) - 0.0000001);
+    double r0 = floor (((origin_y - *(rect + 3)) / tile_h) + 0.0000001);
+    double r1 = ceil (((origin_y - *(rect + 1)) / tile_h) - 0.0000001);
+    if (c1 <= c0)
+	c1 = c0 + 1.0;
+    if (r1 <= r0)
+	r1 = r0 + 1.0;
+    *(rect + 0) = origin_x + (c0 * tile_w);
+    *(rect + 2) = origin_x + (c1 * tile_w);
+    *(rect + 3) = origin_y - (r0 * tile_h);
+    *(rect + 1) = origin_y - (r1 * tile_h);
+}
+
+static int
+merge_dirty_rects (double *rects, int count)
+{
+/* merging overlapping footprints, so that no tile will be built twice */
+    int i;
+    int j;
+    int merged = 1;
+    while (merged)
+      {
+	  merged = 0;
+	  for (i = 0; i < count; i++)
+	    {
+		double *a = rects + (i * 4);
+		for (j = i + 1; j < count; j++)
+		  {
+		      double *b = rects + (j * 4);
+		      if (*(a + 0) < *(b + 2) && *(b + 0) < *(a + 2)
+			  && *(a + 1) < *(b + 3) && *(b + 1) < *(a + 3))
 			{
-			    fprintf (stderr,
-				     "ERROR: unable to encode a Pyramid tile\n");
-			    goto error;
+			    /* overlapping: merging B into A */
+			    if (*(b + 0) < *(a + 0))
+				*(a + 0) = *(b + 0);
+			    if (*(b + 1) < *(a + 1))
+				*(a + 1) = *(b + 1);
+			    if (*(b + 2) > *(a + 2))
+				*(a + 2) = *(b + 2);
+			    if (*(b + 3) > *(a + 3))
+				*(a + 3) = *(b + 3);
+			    count--;
+			    memcpy (b, rects + (count * 4), sizeof (double) * 4);
+			    merged = 1;
+			    j--;
 			}
+		  }
+	    }
+      }
+    return count;
+}
 
-		      /* INSERTing the tile */
-		      if (!do_insert_pyramid_tile
-			  (handle, blob_odd, blob_odd_sz, blob_even,
-			   blob_even_sz, id_level + 1, -1, srid, tile_minx,
-			   end_y, end_x, tile_maxy, stmt_tils, stmt_data))
-			  goto error;
-		      rl2_destroy_raster (raster);
-		      raster = NULL;
+static int
+do_update_monolithic_rect (sqlite3 * handle, MonolithicPyramidPtr pyr,
+			   sqlite3_stmt * stmt_del, int id_level,
+			   int resize_factor, double res_x, double res_y,
+			   const double *rect, double minx, double miny,
+			   double maxx, double maxy, int *n_tiles)
+{
+/* rebuilding all Monolithic Pyramid tiles covered by a (snapped) footprint */
+    double tile_w = (double) (pyr->tile_width) * res_x;
+    double tile_h = (double) (pyr->tile_height) * res_y;
+    int cols = (int) (((*(rect + 2) - *(rect + 0)) / tile_w) + 0.5);
+    int rows = (int) (((*(rect + 3) - *(rect + 1)) / tile_h) + 0.5);
+    int row;
+    int col;
+    int ret;
 
-		    done:
-		      tile_minx = tile_maxx;
-		      col++;
-		  }
-		tile_maxy = tile_miny;
-		row++;
-		if (verbose)
+    for (row = 0; row < rows; row++)
+      {
+	  double tile_maxy = *(rect + 3) - ((double) row * tile_h);
+	  double tile_miny = tile_maxy - tile_h;
+	  for (col = 0; col < cols; col++)
+	    {
+		double tile_minx = *(rect + 0) + ((double) col * tile_w);
+		double tile_maxx = tile_minx + tile_w;
+		double end_x = tile_maxx;
+		double end_y = tile_miny;
+		/* removing the obsolete tile (if any) */
+		sqlite3_reset (stmt_del);
+		sqlite3_clear_bindings (stmt_del);
+		sqlite3_bind_int (stmt_del, 1, id_level + 1);
+		sqlite3_bind_double (stmt_del, 2, tile_minx + (res_x / 2.0));
+		sqlite3_bind_double (stmt_del, 3, tile_miny + (res_y / 2.0));
+		sqlite3_bind_double (stmt_del, 4, tile_maxx - (res_x / 2.0));
+		sqlite3_bind_double (stmt_del, 5, tile_maxy - (res_y / 2.0));
+		sqlite3_bind_double (stmt_del, 6, tile_minx - (res_x / 2.0));
+		sqlite3_bind_double (stmt_del, 7, tile_minx + (res_x / 2.0));
+		sqlite3_bind_double (stmt_del, 8, tile_maxy - (res_y / 2.0));
+		sqlite3_bind_double (stmt_del, 9, tile_maxy + (res_y / 2.0));
+		ret = sqlite3_step (stmt_del);
+		if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+		    ;
+		else
 		  {
-		      printf ("  ----------\n");
-		      printf
-			  ("    %s: Monolithic Pyramid Level %d - Row %d of %d  successfully built\n",
-			   coverage, id_level + 1, row, tot_rows);
+		      fprintf (stderr,
+			       "DELETE FROM tiles; sqlite3_step() error: %s\n",
+			       sqlite3_errmsg (handle));
+		      return 0;
 		  }
+		if (tile_minx > maxx || tile_maxx < minx || tile_maxy < miny
+		    || tile_miny > maxy)
+		    continue;	/* outside the Coverage extent */
+		if (tile_maxx > maxx)
+		    end_x = maxx;
+		if (tile_miny < miny)
+		    end_y = miny;
+		if (!do_build_monolithic_tile
+		    (handle, pyr, id_level, resize_factor, res_x, res_y,
+		     tile_minx, tile_miny, tile_maxx, tile_maxy, end_x, end_y))
+		    return 0;
+		*n_tiles += 1;
 	    }
-	  if (stop)
-	      break;
-	  if ((minx +
-	       ((double) tileWidth * res_x) > maxx)
-	      && (maxy - ((double) tileHeight * res_y) < maxy))
-	      stop = 1;
-	  /* setting the requested virt_levels */
-	  switch (virt_levels)
+      }
+    return 1;
+}
+
+static int
+guess_virt_levels (const int *factors, int count)
+{
+/* guessing the virt_levels arg originally used to build the Pyramid */
+    if (count < 1)
+	return 0;
+    switch (*factors)
+      {
+      case 2:
+	  return 1;
+      case 4:
+	  return 2;
+      };
+    return 3;
+}
+
+#define RL2_MAX_PYRAMID_LEVELS	64
+
+static int
+do_update_monolithic_pyramid (sqlite3 * handle, const void *priv_data,
+			      const char *coverage, int verbose)
+{
+/* incrementally updating a Monolithic Pyramid */
+    MonolithicPyramid pyr;
+    rl2PrivCoveragePtr cov;
+    int factors[RL2_MAX_PYRAMID_LEVELS];
+    int n_levels;
+    int virt_levels = 0;
+    double *rects = NULL;
+    int n_rects;
+    double minx;
+    double miny;
+    double maxx;
+    double maxy;
+    double res_x;
+    double res_y;
+    double origin_x;
+    double origin_y;
+    double tile_w;
+    double tile_h;
+    int prev_factor = 1;
+    int resize_factor;
+    int id_level;
+    int i;
+    int n_tiles;
+    char *table;
+    char *xtable;
+    char *xxtable;
+    char *sql;
+    sqlite3_stmt *stmt_del = NULL;
+    char *sql_err = NULL;
+    int ret;
+
+    memset (&pyr, 0, sizeof (MonolithicPyramid));
+    table = sqlite3_mprintf ("%s_pyramid_dirty", coverage);
+    ret = check_table_exists (handle, table);
+    sqlite3_free (table);
+    if (ret < 0)
+	goto error;
+    if (!ret)
+      {
+	  /* untracked Pyramid: a full rebuild is the only safe option */
+	  if (verbose)
+	      printf ("    %s: untracked Monolithic Pyramid; full rebuild\n",
+		      coverage);
+	  goto full_rebuild;
+      }
+    if (!load_pyramid_dirty (handle, coverage, &rects, &n_rects))
+	goto error;
+    if (n_rects == 0)
+      {
+	  if (verbose)
+	      printf ("    %s: Monolithic Pyramid already up to date\n",
+		      coverage);
+	  return RL2_OK;
+      }
+
+    if (!init_monolithic_pyramid
+	(handle, priv_data, coverage, &pyr, &virt_levels))
+	goto error;
+    cov = (rl2PrivCoveragePtr) (pyr.coverage);
+    ret =
+	load_monolithic_levels (handle, coverage, cov->hResolution, factors,
+				RL2_MAX_PYRAMID_LEVELS, &n_levels);
+    if (ret < 0)
+	goto error;
+    if (ret == 0 || n_levels == 0)
+      {
+	  /* unexpected levels layout */
+	  if (verbose)
+	      printf ("    %s: unexpected Pyramid levels; full rebuild\n",
+		      coverage);
+	  reset_monolithic_pyramid (&pyr);
+	  free (rects);
+	  rects = NULL;
+	  goto full_rebuild;
+      }
+    if (!get_coverage_extent (handle, coverage, &minx, &miny, &maxx, &maxy))
+	goto error;
+
+    table = sqlite3_mprintf ("%s_tiles", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sql =
+	sqlite3_mprintf
+	("DELETE FROM main.\"%s\" WHERE pyramid_level = ? AND section_id IS NULL "
+	 "AND ROWID IN (SELECT ROWID FROM SpatialIndex WHERE f_table_name = %Q "
+	 "AND search_frame = BuildMBR(?, ?, ?, ?)) AND "
+	 "MbrMinX(geometry) BETWEEN ? AND ? AND MbrMaxY(geometry) BETWEEN ? AND ?",
+	 xtable, table);
+    sqlite3_free (table);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt_del, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "DELETE FROM tiles SQL error: %s\n",
+		   sqlite3_errmsg (handle));
+	  goto error;
+      }
+
+/* rebuilding the dirty tiles of each existing level */
+    origin_x = minx;
+    origin_y = maxy;
+    for (id_level = 0; id_level < n_levels; id_level++)
+      {
+	  resize_factor = factors[id_level] / prev_factor;
+	  prev_factor = factors[id_level];
+	  res_x = cov->hResolution * (double) (factors[id_level]);
+	  res_y = cov->vResolution * (double) (factors[id_level]);
+	  tile_w = (double) (pyr.tile_width) * res_x;
+	  tile_h = (double) (pyr.tile_height) * res_y;
+	  if (!get_monolithic_grid_origin (handle, coverage, id_level + 1,
+					   &origin_x, &origin_y))
+	      goto error;
+	  /* 
+	     / snapping the footprints to this level's grid: the rebuilt
+	     / tiles will be the dirty footprints of the next level
+	   */
+	  for (i = 0; i < n_rects; i++)
+	      snap_dirty_rect (rects + (i * 4), origin_x, origin_y, tile_w,
+			       tile_h);
+	  n_rects = merge_dirty_rects (rects, n_rects);
+	  n_tiles = 0;
+	  for (i = 0; i < n_rects; i++)
+	    {
+		if (!do_update_monolithic_rect
+		    (handle, &pyr, stmt_del, id_level, resize_factor, res_x,
+		     res_y, rects + (i * 4), minx, miny, maxx, maxy, &n_tiles))
+		    goto error;
+	    }
+	  if (verbose)
 	    {
-	    case 1:		/* separating each physical level */
-		resize_factor = 2;
-		break;
-	    case 2:		/* one physical + one virtual */
-		resize_factor = 4;
-		break;
-	    case 3:		/* one physical + two virtuals */
-		resize_factor = 8;
-		break;
-	    };
-	  factor *= resize_factor;
-	  id_level++;
-	  if (palette != NULL)
+		printf ("  ----------\n");
+		printf
+		    ("    %s: Monolithic Pyramid Level %d - %d tiles successfully updated\n",
+		     coverage, id_level + 1, n_tiles);
+	    }
+	  if (pyr.palette != NULL)
 	    {
 		/* destroying an eventual Palette after completing the first level */
-		rl2_destroy_palette (palette);
-		palette = NULL;
+		rl2_destroy_palette (pyr.palette);
+		pyr.palette = NULL;
 	    }
       }
-    sqlite3_finalize (stmt_geo);
-    sqlite3_finalize (stmt_rd);
-    sqlite3_finalize (stmt_levl);
-    sqlite3_finalize (stmt_tils);
-    sqlite3_finalize (stmt_data);
+
+/* the Coverage could have grown: adding any further required level */
+    while (n_levels < 2
+	   || (double) (pyr.tile_width) * cov->hResolution *
+	   (double) (factors[n_levels - 2]) <= (maxx - minx)
+	   || (double) (pyr.tile_height) * cov->vResolution *
+	   (double) (factors[n_levels - 2]) <= (maxy - miny))
+      {
+	  double rect[4];
+	  if (n_levels >= RL2_MAX_PYRAMID_LEVELS)
+	      break;
+	  resize_factor =
+	      (n_levels < 2) ? factors[0] : factors[n_levels -
+						    1] / factors[n_levels - 2];
+	  factors[n_levels] = factors[n_levels - 1] * resize_factor;
+	  res_x = cov->hResolution * (double) (factors[n_levels]);
+	  res_y = cov->vResolution * (double) (factors[n_levels]);
+	  if (!do_insert_pyramid_levels
+	      (handle, n_levels + 1, res_x, res_y, pyr.stmt_levl))
+	      goto error;
+	  rect[0] = minx;
+	  rect[1] = miny;
+	  rect[2] = maxx;
+	  rect[3] = maxy;
+	  snap_dirty_rect (rect, minx, maxy, (double) (pyr.tile_width) * res_x,
+			   (double) (pyr.tile_height) * res_y);
+	  n_tiles = 0;
+	  if (!do_update_monolithic_rect
+	      (handle, &pyr, stmt_del, n_levels, resize_factor, res_x, res_y,
+	       rect, minx, miny, maxx, maxy, &n_tiles))
+	      goto error;
+	  n_levels++;
+	  if (verbose)
+	    {
+		printf ("  ----------\n");
+		printf
+		    ("    %s: Monolithic Pyramid Level %d - %d tiles successfully built\n",
+		     coverage, n_levels, n_tiles);
+	    }
+      }
+    sqlite3_finalize (stmt_del);
+    stmt_del = NULL;
+    free (rects);
+    rects = NULL;
+    reset_monolithic_pyramid (&pyr);
+
+/* resetting the dirty footprints */
+    table = sqlite3_mprintf ("%s_pyramid_dirty", coverage);
+    xxtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql = sqlite3_mprintf ("DELETE FROM main.\"%s\"", xxtable);
+    free (xxtable);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "DELETE FROM \"%s_pyramid_dirty\" error: %s\n",
+		   coverage, sql_err);
+	  sqlite3_free (sql_err);
+	  goto error;
+      }
+/* releasing any deduplicated tile no longer referenced */
+    if (!rl2_purge_dedup_tiles (handle, coverage))
+	goto error;
     if (verbose)
       {
 	  printf ("  ----------\n");
 	  printf
-	      ("    Monolithic Pyramid levels successfully built for: %s\n",
+	      ("    Monolithic Pyramid levels successfully updated for: %s\n",
 	       coverage);
       }
-    free (buffer);
-    free (mask);
-    rl2_destroy_coverage (cvg);
-
     return RL2_OK;
 
+  full_rebuild:
+    if (find_base_resolution (handle, coverage, &res_x, &res_y)
+	&& load_monolithic_levels (handle, coverage, res_x, factors,
+				   RL2_MAX_PYRAMID_LEVELS, &n_levels) > 0)
+	;
+    else
+	n_levels = 0;
+    return rl2_build_monolithic_pyramid (handle, priv_data, coverage,
+					 guess_virt_levels (factors, n_levels),
+					 verbose);
+
   error:
-    if (stmt_geo != NULL)
-	sqlite3_finalize (stmt_geo);
-    if (stmt_rd != NULL)
-	sqlite3_finalize (stmt_rd);
-    if (stmt_levl != NULL)
-	sqlite3_finalize (stmt_levl);
-    if (stmt_tils != NULL)
-	sqlite3_finalize (stmt_tils);
-    if (stmt_data != NULL)
-	sqlite3_finalize (stmt_data);
-    if (buffer != NULL)
-	free (buffer);
-    if (mask != NULL)
-	free (mask);
-    if (cvg != NULL)
-	rl2_destroy_coverage (cvg);
-    if (palette != NULL)
-	rl2_destroy_palette (palette);
-    if (raster != NULL)
-	rl2_destroy_raster (raster);
+    if (stmt_del != NULL)
+	sqlite3_finalize (stmt_del);
+    if (rects != NULL)
+	free (rects);
+    reset_monolithic_pyramid (&pyr);
     return RL2_ERROR;
 }
 
+RL2_DECLARE int
+rl2_build_incremental_pyramid (sqlite3 * handle, const void *priv_data,
+			       const char *coverage, int verbose)
+{
+/*
+/ incrementally updating the Pyramid of a whole Coverage:
+/ - Monolithic Pyramid: only the tiles affected by the footprint
+/   of the Sections INSERTed or DELETEd since the last build will
+/   be rebuilt, level by level
+/ - Section Pyramids: building the missing Section Pyramids
+*/
+    int mixed_resolutions =
+	rl2_is_mixed_resolutions_coverage (handle, NULL, coverage);
+    int monolithic;
+    if (mixed_resolutions < 0)
+	return RL2_ERROR;
+    if (!mixed_resolutions)
+      {
+	  monolithic = has_monolithic_pyramid (handle, coverage);
+	  if (monolithic < 0)
+	      return RL2_ERROR;
+	  if (monolithic)
+	      return do_update_monolithic_pyramid (handle, priv_data,
+						   coverage, verbose);
+      }
+    return rl2_build_all_section_pyramids (handle, priv_data, coverage, 0,
+					   verbose);
+}
+
 RL2_DECLARE int
 rl2_delete_all_pyramids (sqlite3 * handle, const char *coverage)
 {
@@ -6759,6 +7659,9 @@ rl2_delete_all_pyramids (sqlite3 * handle, const char *coverage)
 		return RL2_ERROR;
 	    }
       }
+/* releasing any deduplicated tile no longer referenced */
+    if (!rl2_purge_dedup_tiles (handle, coverage))
+	return RL2_ERROR;
     return RL2_OK;
 }
 
@@ -6769,5 +7672,7 @@ rl2_delete_section_pyramid (sqlite3 * handle, const char *coverage,
 /* deleting section-level pyramid for a single Section */
     if (!delete_section_pyramid (handle, coverage, section_id))
 	return RL2_ERROR;
+    if (!rl2_purge_dedup_tiles (handle, coverage))
+	return RL2_ERROR;
     return RL2_OK;
 }
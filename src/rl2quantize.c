@@ -44,6 +44,7 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
 
 #include "config.h"
 
@@ -54,123 +55,607 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include <leptonica/allheaders.h>
 #endif
 
-RL2_DECLARE int
-rl2_quantize_color (int width, int height, const unsigned char *rgb,
-		    int num_colors, unsigned char **pixbuf,
-		    rl2PalettePtr * palette)
+/* the RGB histogram is sampled at 5 bits per channel */
+#define RL2_QUANT_BINS	32768
+#define rl2_quant_bin(r, g, b)	((((r) >> 3) << 10) | (((g) >> 3) << 5) | ((b) >> 3))
+
+/* stable Palettes: how many images are sampled, and the min number of colors */
+#define RL2_QUANT_STABLE_SAMPLES	8
+#define RL2_QUANT_STABLE_MIN_COLORS	16
+#define RL2_QUANT_SEED_MAX_PIXELS	(1 << 23)
+
+/* 4x4 Bayer matrix for ordered dithering */
+static const int rl2_bayer4[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5}
+};
+
+struct quant_box
+{
+/* a Median Cut box in the 5-5-5 RGB space */
+    int r0;
+    int r1;
+    int g0;
+    int g1;
+    int b0;
+    int b1;
+    unsigned int count;
+};
+
+struct quant_histogram
+{
+/* the RGB histogram (population and color sums of each bin) */
+    unsigned int count[RL2_QUANT_BINS];
+    unsigned int sum_r[RL2_QUANT_BINS];
+    unsigned int sum_g[RL2_QUANT_BINS];
+    unsigned int sum_b[RL2_QUANT_BINS];
+};
+
+static struct quant_histogram *
+build_quant_histogram (int width, int height, const unsigned char *rgb)
+{
+/* building the RGB histogram */
+    int i;
+    int n_pixels = width * height;
+    const unsigned char *p_rgb = rgb;
+    struct quant_histogram *hist = calloc (1, sizeof (struct quant_histogram));
+    if (hist == NULL)
+	return NULL;
+    for (i = 0; i < n_pixels; i++)
+      {
+	  unsigned int red = *p_rgb++;
+	  unsigned int green = *p_rgb++;
+	  unsigned int blue = *p_rgb++;
+	  unsigned int bin = rl2_quant_bin (red, green, blue);
+	  hist->count[bin] += 1;
+	  hist->sum_r[bin] += red;
+	  hist->sum_g[bin] += green;
+	  hist->sum_b[bin] += blue;
+      }
+    return hist;
+}
+
+static void
+shrink_quant_box (const struct quant_histogram *hist, struct quant_box *box)
+{
+/* shrinking a box so to tightly fit its populated bins */
+    int r;
+    int g;
+    int b;
+    int r0 = 31;
+    int r1 = 0;
+    int g0 = 31;
+    int g1 = 0;
+    int b0 = 31;
+    int b1 = 0;
+    unsigned int count = 0;
+    for (r = box->r0; r <= box->r1; r++)
+      {
+	  for (g = box->g0; g <= box->g1; g++)
+	    {
+		for (b = box->b0; b <= box->b1; b++)
+		  {
+		      unsigned int n = hist->count[(r << 10) | (g << 5) | b];
+		      if (n == 0)
+			  continue;
+		      count += n;
+		      if (r < r0)
+			  r0 = r;
+		      if (r > r1)
+			  r1 = r;
+		      if (g < g0)
+			  g0 = g;
+		      if (g > g1)
+			  g1 = g;
+		      if (b < b0)
+			  b0 = b;
+		      if (b > b1)
+			  b1 = b;
+		  }
+	    }
+      }
+    box->count = count;
+    if (count == 0)
+	return;
+    box->r0 = r0;
+    box->r1 = r1;
+    box->g0 = g0;
+    box->g1 = g1;
+    box->b0 = b0;
+    box->b1 = b1;
+}
+
+static int
+split_quant_box (const struct quant_histogram *hist, struct quant_box *box,
+		 struct quant_box *other)
+{
+/* splitting a box at the population median of its longest side */
+    int axis;
+    int lo;
+    int hi;
+    int cut;
+    int r;
+    int g;
+    int b;
+    unsigned int half;
+    unsigned int acc = 0;
+    int len_r = box->r1 - box->r0;
+    int len_g = box->g1 - box->g0;
+    int len_b = box->b1 - box->b0;
+    if (len_r == 0 && len_g == 0 && len_b == 0)
+	return 0;
+    if (len_g >= len_r && len_g >= len_b)
+      {
+	  axis = 1;
+	  lo = box->g0;
+	  hi = box->g1;
+      }
+    else if (len_r >= len_b)
+      {
+	  axis = 0;
+	  lo = box->r0;
+	  hi = box->r1;
+      }
+    else
+      {
+	  axis = 2;
+	  lo = box->b0;
+	  hi = box->b1;
+      }
+    half = box->count / 2;
+    for (cut = lo; cut < hi; cut++)
+      {
+	  /* accumulating the population of each slice */
+	  for (r = box->r0; r <= box->r1; r++)
+	    {
+		if (axis == 0 && r != cut)
+		    continue;
+		for (g = box->g0; g <= box->g1; g++)
+		  {
+		      if (axis == 1 && g != cut)
+			  continue;
+		      for (b = box->b0; b <= box->b1; b++)
+			{
+			    if (axis == 2 && b != cut)
+				continue;
+			    acc += hist->count[(r << 10) | (g << 5) | b];
+			}
+		  }
+	    }
+	  if (acc >= half)
+	      break;
+      }
+    if (cut >= hi)
+	cut = hi - 1;
+    *other = *box;
+    switch (axis)
+      {
+      case 0:
+	  box->r1 = cut;
+	  other->r0 = cut + 1;
+	  break;
+      case 1:
+	  box->g1 = cut;
+	  other->g0 = cut + 1;
+	  break;
+      default:
+	  box->b1 = cut;
+	  other->b0 = cut + 1;
+	  break;
+      };
+    shrink_quant_box (hist, box);
+    shrink_quant_box (hist, other);
+    return 1;
+}
+
+static int
+median_cut_palette (const struct quant_histogram *hist, int num_colors,
+		    unsigned char *red, unsigned char *green,
+		    unsigned char *blue)
 {
 /* 
- * color quantization based on Leptonica support 
- * 
- * method: two-pass adaptive octree color quantization with no dithering
- * 
+/ Median Cut color quantization
+/ returns the number of Palette entries
 */
-#ifndef OMIT_LEPTONICA
-    unsigned char *pixels = NULL;
-    unsigned char *p_pix;
-    rl2PalettePtr plt = NULL;
-    const unsigned char *p_rgb;
-    int row;
-    int col;
-    int ret;
-    int red;
-    int green;
-    int blue;
-    unsigned int index;
-    int n_colors;
-    int out_colors;
-    PIX *rgb_pix = NULL;
-    PIX *palette_pix = NULL;
-    PIXCMAP *cmap;
+    struct quant_box boxes[256];
+    int n_boxes = 1;
+    int i;
+    int r;
+    int g;
+    int b;
 
-    *pixbuf = NULL;
-    *palette = NULL;
+    if (num_colors < 2)
+	num_colors = 2;
+    if (num_colors > 256)
+	num_colors = 256;
+    boxes[0].r0 = 0;
+    boxes[0].r1 = 31;
+    boxes[0].g0 = 0;
+    boxes[0].g1 = 31;
+    boxes[0].b0 = 0;
+    boxes[0].b1 = 31;
+    shrink_quant_box (hist, &boxes[0]);
+    if (boxes[0].count == 0)
+	return 0;
 
-/* creating and populating a Leptonica PIX for RGB input */
-    rgb_pix = pixCreate (width, height, 32);
-    if (rgb_pix == NULL)
-	goto error;
-    p_rgb = rgb;
-    for (row = 0; row < height; row++)
+    while (n_boxes < num_colors)
       {
-	  for (col = 0; col < width; col++)
+	  /* splitting the most populated box still allowing a split */
+	  int best = -1;
+	  double best_score = 0.0;
+	  for (i = 0; i < n_boxes; i++)
 	    {
-		/* populating Leptonica pixels */
-		red = *p_rgb++;
-		green = *p_rgb++;
-		blue = *p_rgb++;
-		ret = pixSetRGBPixel (rgb_pix, col, row, red, green, blue);
-		if (ret != 0)
-		    goto error;
+		double score;
+		int len = boxes[i].r1 - boxes[i].r0;
+		if (boxes[i].g1 - boxes[i].g0 > len)
+		    len = boxes[i].g1 - boxes[i].g0;
+		if (boxes[i].b1 - boxes[i].b0 > len)
+		    len = boxes[i].b1 - boxes[i].b0;
+		if (len == 0)
+		    continue;
+		score = (double) (boxes[i].count) * (double) len;
+		if (score > best_score)
+		  {
+		      best_score = score;
+		      best = i;
+		  }
 	    }
+	  if (best < 0)
+	      break;
+	  if (!split_quant_box (hist, &boxes[best], &boxes[n_boxes]))
+	      break;
+	  n_boxes++;
       }
 
-/* normalizing num_colors in the expected range 128-240 */
-    n_colors = num_colors;
-    if (n_colors < 128)
-	n_colors = 128;
-    if (n_colors > 240)
-	n_colors = 240;
-
-/* color quantization */
-    palette_pix = pixOctreeColorQuant (rgb_pix, n_colors, 0);
-    if (palette_pix == NULL)
-	goto error;
-    pixDestroy (&rgb_pix);
-    rgb_pix = NULL;
+    for (i = 0; i < n_boxes; i++)
+      {
+	  /* each Palette color is the mean color of its box */
+	  double sr = 0.0;
+	  double sg = 0.0;
+	  double sb = 0.0;
+	  double cnt = 0.0;
+	  for (r = boxes[i].r0; r <= boxes[i].r1; r++)
+	    {
+		for (g = boxes[i].g0; g <= boxes[i].g1; g++)
+		  {
+		      for (b = boxes[i].b0; b <= boxes[i].b1; b++)
+			{
+			    int bin = (r << 10) | (g << 5) | b;
+			    cnt += hist->count[bin];
+			    sr += hist->sum_r[bin];
+			    sg += hist->sum_g[bin];
+			    sb += hist->sum_b[bin];
+			}
+		  }
+	    }
+	  if (cnt <= 0.0)
+	      cnt = 1.0;
+	  red[i] = (unsigned char) (sr / cnt + 0.5);
+	  green[i] = (unsigned char) (sg / cnt + 0.5);
+	  blue[i] = (unsigned char) (sb / cnt + 0.5);
+      }
+    return n_boxes;
+}
 
-/* allocating the palette and the pixbuf to be returned */
-    cmap = pixGetColormap (palette_pix);
-    if (cmap == NULL)
-	goto error;
-    out_colors = pixcmapGetCount (cmap);
-    plt = rl2_create_palette (out_colors);
-    if (plt == NULL)
-	goto error;
-    for (col = 0; col < out_colors; col++)
+static unsigned short
+nearest_palette_color (int num_entries, const unsigned char *red,
+		       const unsigned char *green, const unsigned char *blue,
+		       int bin)
+{
+/* searching the Palette color nearest to the center of some bin */
+    int i;
+    int best = 0;
+    int best_dist = INT_MAX;
+    int r = ((bin >> 10) & 0x1f) * 8 + 4;
+    int g = ((bin >> 5) & 0x1f) * 8 + 4;
+    int b = (bin & 0x1f) * 8 + 4;
+    for (i = 0; i < num_entries; i++)
       {
-	  /* populating the palette */
-	  ret = pixcmapGetColor (cmap, col, &red, &green, &blue);
-	  if (ret != 0)
-	      goto error;
-	  rl2_set_palette_color (plt, col, red, green, blue);
+	  int dr = r - red[i];
+	  int dg = g - green[i];
+	  int db = b - blue[i];
+	  int dist = (dr * dr * 3) + (dg * dg * 4) + (db * db * 2);
+	  if (dist < best_dist)
+	    {
+		best_dist = dist;
+		best = i;
+	    }
       }
+    return (unsigned short) best;
+}
+
+static unsigned char
+clamp_dither (int value)
+{
+/* clamping a dithered value into the 0-255 range */
+    if (value < 0)
+	return 0;
+    if (value > 255)
+	return 255;
+    return (unsigned char) value;
+}
 
-    pixels = malloc (width * height);
+static int
+map_palette_pixels (int width, int height, const unsigned char *rgb,
+		    int num_entries, const unsigned char *red,
+		    const unsigned char *green, const unsigned char *blue,
+		    unsigned short *lut, int dithering, unsigned char **pixbuf)
+{
+/* 
+/ mapping RGB pixels to their nearest Palette color
+/ the lookup table is lazily resolved (0xffff marks a still unresolved bin)
+*/
+    int row;
+    int col;
+    const unsigned char *p_rgb = rgb;
+    unsigned char *p_pix;
+    unsigned char *pixels = malloc (width * height);
     if (pixels == NULL)
-	goto error;
+	return 0;
     p_pix = pixels;
     for (row = 0; row < height; row++)
       {
 	  for (col = 0; col < width; col++)
 	    {
-		/* populating pixbuf pixels */
-		ret = pixGetPixel (palette_pix, col, row, &index);
-		if (ret != 0)
-		    goto error;
-		*p_pix++ = index;
+		int red_v = *p_rgb++;
+		int green_v = *p_rgb++;
+		int blue_v = *p_rgb++;
+		int bin;
+		if (dithering)
+		  {
+		      /* ordered dithering: -15 to +15 */
+		      int offset = (rl2_bayer4[row & 3][col & 3] * 2) - 15;
+		      red_v = clamp_dither (red_v + offset);
+		      green_v = clamp_dither (green_v + offset);
+		      blue_v = clamp_dither (blue_v + offset);
+		  }
+		bin = rl2_quant_bin (red_v, green_v, blue_v);
+		if (lut[bin] == 0xffff)
+		    lut[bin] =
+			nearest_palette_color (num_entries, red, green, blue,
+					       bin);
+		*p_pix++ = (unsigned char) (lut[bin]);
 	    }
       }
+    *pixbuf = pixels;
+    return 1;
+}
+
+static rl2PalettePtr
+build_quant_palette (int num_entries, const unsigned char *red,
+		     const unsigned char *green, const unsigned char *blue)
+{
+/* creating the Palette object to be returned */
+    int i;
+    rl2PalettePtr plt = rl2_create_palette (num_entries);
+    if (plt == NULL)
+	return NULL;
+    for (i = 0; i < num_entries; i++)
+	rl2_set_palette_color (plt, i, red[i], green[i], blue[i]);
+    return plt;
+}
 
-/* final memory cleanup */
-    pixDestroy (&palette_pix);
+static int
+do_quantize_color (int width, int height, const unsigned char *rgb,
+		   int num_colors, int dithering, unsigned char **pixbuf,
+		   rl2PalettePtr * palette)
+{
+/* color quantization: computing a Palette specific to this image */
+    unsigned char red[256];
+    unsigned char green[256];
+    unsigned char blue[256];
+    int num_entries;
+    int i;
+    unsigned short *lut = NULL;
+    unsigned char *pixels = NULL;
+    rl2PalettePtr plt = NULL;
+    struct quant_histogram *hist = NULL;
+
+    *pixbuf = NULL;
+    *palette = NULL;
+    if (rgb == NULL || width <= 0 || height <= 0)
+	return RL2_ERROR;
+
+    hist = build_quant_histogram (width, height, rgb);
+    if (hist == NULL)
+	goto error;
+    num_entries = median_cut_palette (hist, num_colors, red, green, blue);
+    free (hist);
+    hist = NULL;
+    if (num_entries < 1)
+	goto error;
+    lut = malloc (sizeof (unsigned short) * RL2_QUANT_BINS);
+    if (lut == NULL)
+	goto error;
+    for (i = 0; i < RL2_QUANT_BINS; i++)
+	lut[i] = 0xffff;
+    if (!map_palette_pixels
+	(width, height, rgb, num_entries, red, green, blue, lut, dithering,
+	 &pixels))
+	goto error;
+    free (lut);
+    lut = NULL;
+    plt = build_quant_palette (num_entries, red, green, blue);
+    if (plt == NULL)
+	goto error;
     *pixbuf = pixels;
     *palette = plt;
     return RL2_OK;
 
   error:
-    if (rgb_pix != NULL)
-	pixDestroy (&rgb_pix);
-    if (palette_pix != NULL)
-	pixDestroy (&palette_pix);
+    if (hist != NULL)
+	free (hist);
+    if (lut != NULL)
+	free (lut);
     if (pixels != NULL)
 	free (pixels);
-    if (plt != NULL)
-	rl2_destroy_palette (plt);
-#endif
     return RL2_ERROR;
 }
 
+RL2_DECLARE int
+rl2_quantize_color (int width, int height, const unsigned char *rgb,
+		    int num_colors, unsigned char **pixbuf,
+		    rl2PalettePtr * palette)
+{
+/* 
+ * color quantization - native support
+ * 
+ * method: Median Cut on a 5-5-5 RGB histogram, nearest color mapping
+ * via a lazily resolved lookup table, no dithering
+ * 
+*/
+    return do_quantize_color (width, height, rgb, num_colors, 0, pixbuf,
+			      palette);
+}
+
+static int
+add_palette_sample (struct rl2_cached_palette *cached, int width, int height,
+		    const unsigned char *rgb)
+{
+/* adding one more sampled image to the seed of a stable Palette */
+    int i;
+    unsigned int total = 0;
+    struct quant_histogram *seed;
+    struct quant_histogram *hist = build_quant_histogram (width, height, rgb);
+    if (hist == NULL)
+	return 0;
+    if (cached->seed == NULL)
+      {
+	  cached->seed = hist;
+	  cached->samples = 1;
+	  return 1;
+      }
+    seed = (struct quant_histogram *) (cached->seed);
+    for (i = 0; i < RL2_QUANT_BINS; i++)
+	total += seed->count[i];
+    if (total > RL2_QUANT_SEED_MAX_PIXELS)
+      {
+	  /* halving the seed so to avoid any overflow */
+	  for (i = 0; i < RL2_QUANT_BINS; i++)
+	    {
+		seed->count[i] /= 2;
+		seed->sum_r[i] /= 2;
+		seed->sum_g[i] /= 2;
+		seed->sum_b[i] /= 2;
+	    }
+      }
+    for (i = 0; i < RL2_QUANT_BINS; i++)
+      {
+	  seed->count[i] += hist->count[i];
+	  seed->sum_r[i] += hist->sum_r[i];
+	  seed->sum_g[i] += hist->sum_g[i];
+	  seed->sum_b[i] += hist->sum_b[i];
+      }
+    free (hist);
+    cached->samples += 1;
+    return 1;
+}
+
+static void
+freeze_stable_palette (struct rl2_cached_palette *cached)
+{
+/* 
+/ computing the stable Palette from the sampled images
+/ degenerate Palettes (too few colors) are never kept: in this
+/ case sampling simply starts again from scratch
+*/
+    int i;
+    unsigned char red[256];
+    unsigned char green[256];
+    unsigned char blue[256];
+    int num_entries =
+	median_cut_palette ((struct quant_histogram *) (cached->seed), 256, red,
+			    green, blue);
+    free (cached->seed);
+    cached->seed = NULL;
+    cached->samples = 0;
+    if (num_entries < RL2_QUANT_STABLE_MIN_COLORS)
+	return;
+    for (i = 0; i < num_entries; i++)
+      {
+	  cached->red[i] = red[i];
+	  cached->green[i] = green[i];
+	  cached->blue[i] = blue[i];
+      }
+    cached->num_entries = num_entries;
+}
+
+RL2_PRIVATE int
+rl2_quantize_map_image (const void *priv_data, int width, int height,
+			const unsigned char *rgb, unsigned char **pixbuf,
+			rl2PalettePtr * palette)
+{
+/* 
+/ color quantization of a Map Image (PNG8, GIF, TIFF8)
+/ accordingly to the current connection's options:
+/ - optional ordered dithering
+/ - optional stable Palette shared by all tiles of the same
+/   Coverage + Style (computed from a sample of the first rendered
+/   images and then cached until the Coverage changes)
+*/
+    struct rl2_private_data *priv = (struct rl2_private_data *) priv_data;
+    struct rl2_cached_palette *cached;
+    sqlite3 *handle;
+    const char *db_prefix;
+    const char *coverage;
+    const char *style;
+    int dithering = 0;
+    unsigned char *pixels = NULL;
+    rl2PalettePtr plt;
+
+    if (priv != NULL)
+	dithering = priv->png8_dithering;
+    if (priv == NULL || !(priv->png8_stable_palette))
+	return do_quantize_color (width, height, rgb, 256, dithering, pixbuf,
+				  palette);
+    if (rl2_png_get_request (&handle, &db_prefix, &coverage, &style) !=
+	priv_data || handle == NULL || coverage == NULL)
+	return do_quantize_color (width, height, rgb, 256, dithering, pixbuf,
+				  palette);
+
+    *pixbuf = NULL;
+    *palette = NULL;
+    if (rgb == NULL || width <= 0 || height <= 0)
+	return RL2_ERROR;
+    cached =
+	rl2_get_cached_quantize_palette (priv_data, handle, db_prefix,
+					 coverage, style);
+    if (cached == NULL)
+	cached =
+	    rl2_add_cached_quantize_palette (priv_data, handle, db_prefix,
+					     coverage, style);
+    if (cached == NULL)
+	return RL2_ERROR;
+    if (cached->num_entries == 0)
+      {
+	  /* still sampling: this image gets its own Palette */
+	  if (!add_palette_sample (cached, width, height, rgb))
+	      return RL2_ERROR;
+	  if (cached->samples >= RL2_QUANT_STABLE_SAMPLES)
+	      freeze_stable_palette (cached);
+	  return do_quantize_color (width, height, rgb, 256, dithering, pixbuf,
+				    palette);
+      }
+
+    if (!map_palette_pixels
+	(width, height, rgb, cached->num_entries, cached->red, cached->green,
+	 cached->blue, cached->lut, dithering, &pixels))
+	return RL2_ERROR;
+    plt =
+	build_quant_palette (cached->num_entries, cached->red, cached->green,
+			     cached->blue);
+    if (plt == NULL)
+      {
+	  free (pixels);
+	  return RL2_ERROR;
+      }
+    *pixbuf = pixels;
+    *palette = plt;
+    return RL2_OK;
+}
+
 RL2_DECLARE char *
 rl2_leptonica_version (void)
 {
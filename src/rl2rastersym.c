@@ -8717,7 +8717,7 @@ rl2_build_shaded_relief_mask (sqlite3 * handle, int max_threads,
 	(handle, max_threads, stmt_tiles, stmt_data, rawbuf, width + 2,
 	 height + 2, sample_type, 1, 0, RL2_SYNTETIC_NONE, 0, 0, 0, 0, xx_res,
 	 yy_res, minx - xx_res, miny - yy_res, maxx + xx_res, maxy + yy_res,
-	 level, scale, NULL, no_data, NULL, NULL))
+	 level, scale, NULL, no_data, NULL, NULL, cvg))
 	goto error;
     sqlite3_finalize (stmt_tiles);
     sqlite3_finalize (stmt_data);
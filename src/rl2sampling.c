@@ -0,0 +1,1403 @@
+/*
+
+ rl2sampling -- batched sampling of Raster Coverages by Points
+
+ version 0.1, 2026 October 18
+
+ Author: Sandro Furieri a.furieri@lqt.it
+
+ -----------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2026
+the Initial Developer. All Rights Reserved.
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "config.h"
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef LOADABLE_EXTENSION
+#include "rasterlite2/sqlite.h"
+#endif
+
+#include "rasterlite2/rasterlite2.h"
+#include "rasterlite2_private.h"
+
+/*
+/ RL2_SamplePoints is an eponymous Virtual Table (aka Table-Valued
+/ Function) sampling a Raster Coverage at the position of every Point
+/ stored into some Spatial Table:
+/
+/ SELECT fid, band, value
+/ FROM RL2_SamplePoints(coverage, pyramid_level, point_table,
+/                       geometry_column [, bilinear [, db_prefix]])
+/
+/ all Points are transformed in a single pass, grouped by Tile and
+/ then each Tile is decoded just once (possibly in parallel)
+*/
+
+/* the hidden columns (i.e. the function arguments) */
+#define RL2_SAMPLE_COL_FID		0
+#define RL2_SAMPLE_COL_BAND		1
+#define RL2_SAMPLE_COL_VALUE		2
+#define RL2_SAMPLE_COL_COVERAGE		3
+#define RL2_SAMPLE_COL_LEVEL		4
+#define RL2_SAMPLE_COL_TABLE		5
+#define RL2_SAMPLE_COL_GEOMETRY		6
+#define RL2_SAMPLE_COL_BILINEAR		7
+#define RL2_SAMPLE_COL_DB_PREFIX	8
+#define RL2_SAMPLE_MAX_COLUMNS		9
+
+/* the max number of cells into the Tiles grid index */
+#define RL2_SAMPLE_MAX_GRID_CELLS	(4 * 1024 * 1024)
+
+typedef struct VirtualSamplePointsStruct
+{
+/* extends the sqlite3_vtab struct */
+    const sqlite3_module *pModule;	/* ptr to sqlite module: USED INTERNALLY BY SQLITE */
+    int nRef;			/* # references: USED INTERNALLY BY SQLITE */
+    char *zErrMsg;		/* error message: USE INTERNALLY BY SQLITE */
+    sqlite3 *db;		/* the sqlite db holding the virtual table */
+    const void *priv_data;	/* the RL2 internal cache */
+} VirtualSamplePoints;
+typedef VirtualSamplePoints *VirtualSamplePointsPtr;
+
+typedef struct VirtualSamplePointsCursorStruct
+{
+/* extends the sqlite3_vtab_cursor struct */
+    VirtualSamplePointsPtr pVtab;	/* Virtual table of this cursor */
+    rl2SamplePointsPtr samples;	/* the sampled values */
+    int current_point;		/* the current Point */
+    int current_band;		/* the current Band */
+    sqlite3_int64 current_row;	/* the current ROWID */
+    int eof;			/* the EOF marker */
+} VirtualSamplePointsCursor;
+typedef VirtualSamplePointsCursor *VirtualSamplePointsCursorPtr;
+
+static rl2SamplePointsPtr
+create_sample_points (void)
+{
+/* creating an empty Sample Points container */
+    rl2SamplePointsPtr pts = malloc (sizeof (rl2SamplePoints));
+    if (pts == NULL)
+	return NULL;
+    pts->count = 0;
+    pts->max_count = 0;
+    pts->fids = NULL;
+    pts->x = NULL;
+    pts->y = NULL;
+    pts->tile_of = NULL;
+    pts->by_tile = NULL;
+    pts->sample_type = RL2_SAMPLE_UNKNOWN;
+    pts->num_bands = 0;
+    pts->no_data = NULL;
+    pts->bilinear = 0;
+    pts->values = NULL;
+    pts->valid = NULL;
+    return pts;
+}
+
+static void
+destroy_sample_points (rl2SamplePointsPtr pts)
+{
+/* memory cleanup - destroying a Sample Points container */
+    if (pts == NULL)
+	return;
+    if (pts->fids != NULL)
+	free (pts->fids);
+    if (pts->x != NULL)
+	free (pts->x);
+    if (pts->y != NULL)
+	free (pts->y);
+    if (pts->tile_of != NULL)
+	free (pts->tile_of);
+    if (pts->by_tile != NULL)
+	free (pts->by_tile);
+    if (pts->no_data != NULL)
+	free (pts->no_data);
+    if (pts->values != NULL)
+	free (pts->values);
+    if (pts->valid != NULL)
+	free (pts->valid);
+    free (pts);
+}
+
+static int
+add_sample_point (rl2SamplePointsPtr pts, sqlite3_int64 fid, double x,
+		  double y, int has_coords)
+{
+/* appending a Point to the Sample Points container */
+    if (pts->count >= pts->max_count)
+      {
+	  int max = (pts->max_count == 0) ? 1024 : pts->max_count * 2;
+	  sqlite3_int64 *fids = realloc (pts->fids, sizeof (sqlite3_int64) * max);
+	  double *px;
+	  double *py;
+	  int *tile_of;
+	  if (fids == NULL)
+	      return 0;
+	  pts->fids = fids;
+	  px = realloc (pts->x, sizeof (double) * max);
+	  if (px == NULL)
+	      return 0;
+	  pts->x = px;
+	  py = realloc (pts->y, sizeof (double) * max);
+	  if (py == NULL)
+	      return 0;
+	  pts->y = py;
+	  tile_of = realloc (pts->tile_of, sizeof (int) * max);
+	  if (tile_of == NULL)
+	      return 0;
+	  pts->tile_of = tile_of;
+	  pts->max_count = max;
+      }
+    pts->fids[pts->count] = fid;
+    pts->x[pts->count] = x;
+    pts->y[pts->count] = y;
+/* -2 marks a Point lacking valid coordinates */
+    pts->tile_of[pts->count] = (has_coords) ? -1 : -2;
+    pts->count += 1;
+    return 1;
+}
+
+static int
+load_sample_points (sqlite3 * handle, const char *point_table,
+		    const char *geom_column, int srid, rl2SamplePointsPtr pts)
+{
+/*
+/ loading all Points from the Spatial Table; any Point not in the
+/ same SRID of the Coverage is transformed on the fly by the same
+/ SQL query, thus avoiding one query per Point
+*/
+    int ret;
+    char *sql;
+    char *xtable;
+    char *xgeom;
+    sqlite3_stmt *stmt = NULL;
+
+    xtable = rl2_double_quoted_sql (point_table);
+    xgeom = rl2_double_quoted_sql (geom_column);
+    sql =
+	sqlite3_mprintf
+	("SELECT ROWID, CASE WHEN ST_SRID(\"%s\") = %d THEN \"%s\" "
+	 "ELSE ST_Transform(\"%s\", %d) END FROM MAIN.\"%s\"", xgeom, srid,
+	 xgeom, xgeom, srid, xtable);
+    free (xtable);
+    free (xgeom);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		sqlite3_int64 fid = sqlite3_column_int64 (stmt, 0);
+		double x = 0.0;
+		double y = 0.0;
+		int has_coords = 0;
+		if (sqlite3_column_type (stmt, 1) == SQLITE_BLOB)
+		  {
+		      const unsigned char *blob = sqlite3_column_blob (stmt, 1);
+		      int blob_sz = sqlite3_column_bytes (stmt, 1);
+		      rl2GeometryPtr geom =
+			  rl2_geometry_from_blob (blob, blob_sz);
+		      if (geom != NULL)
+			{
+			    if (geom->first_point != NULL
+				&& geom->first_point == geom->last_point
+				&& geom->first_linestring == NULL
+				&& geom->first_polygon == NULL)
+			      {
+				  x = geom->first_point->x;
+				  y = geom->first_point->y;
+				  has_coords = 1;
+			      }
+			    rl2_destroy_geometry (geom);
+			}
+		  }
+		if (!add_sample_point (pts, fid, x, y, has_coords))
+		    goto error;
+	    }
+	  else
+	    {
+		fprintf (stderr, "RL2_SamplePoints; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (handle));
+		goto error;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    return 1;
+
+  error:
+    if (stmt != NULL)
+	sqlite3_finalize (stmt);
+    return 0;
+}
+
+static int
+get_sample_points_extent (rl2SamplePointsPtr pts, double *minx, double *miny,
+			  double *maxx, double *maxy)
+{
+/* computing the full extent of all valid Points */
+    int i;
+    int count = 0;
+    for (i = 0; i < pts->count; i++)
+      {
+	  if (pts->tile_of[i] == -2)
+	      continue;
+	  if (count == 0)
+	    {
+		*minx = pts->x[i];
+		*maxx = pts->x[i];
+		*miny = pts->y[i];
+		*maxy = pts->y[i];
+	    }
+	  else
+	    {
+		if (pts->x[i] < *minx)
+		    *minx = pts->x[i];
+		if (pts->x[i] > *maxx)
+		    *maxx = pts->x[i];
+		if (pts->y[i] < *miny)
+		    *miny = pts->y[i];
+		if (pts->y[i] > *maxy)
+		    *maxy = pts->y[i];
+	    }
+	  count++;
+      }
+    return count;
+}
+
+static int
+load_sample_tiles (sqlite3 * handle, const char *db_prefix,
+		   const char *coverage, int pyramid_level, double minx,
+		   double miny, double maxx, double maxy,
+		   rl2SampleTilePtr * tiles, int *count)
+{
+/* loading the BBOXes of all Tiles intersecting the Points extent */
+    int ret;
+    char *sql;
+    char *xdb_prefix;
+    char *table;
+    char *xtable;
+    char *idx_name;
+    sqlite3_stmt *stmt = NULL;
+    rl2SampleTilePtr list = NULL;
+    int max = 0;
+    int n = 0;
+
+    *tiles = NULL;
+    *count = 0;
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    table = sqlite3_mprintf ("%s_tiles", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    idx_name = sqlite3_mprintf ("DB=%s.%s_tiles", db_prefix, coverage);
+    sql =
+	sqlite3_mprintf
+	("SELECT tile_id, MbrMinX(geometry), MbrMinY(geometry), "
+	 "MbrMaxX(geometry), MbrMaxY(geometry) FROM \"%s\".\"%s\" "
+	 "WHERE pyramid_level = ? AND ROWID IN (SELECT ROWID FROM SpatialIndex "
+	 "WHERE f_table_name = %Q AND search_frame = BuildMbr(?, ?, ?, ?))",
+	 xdb_prefix, xtable, idx_name);
+    free (xdb_prefix);
+    free (xtable);
+    sqlite3_free (idx_name);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    sqlite3_bind_int (stmt, 1, pyramid_level);
+    sqlite3_bind_double (stmt, 2, minx);
+    sqlite3_bind_double (stmt, 3, miny);
+    sqlite3_bind_double (stmt, 4, maxx);
+    sqlite3_bind_double (stmt, 5, maxy);
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		rl2SampleTilePtr tile;
+		if (n >= max)
+		  {
+		      rl2SampleTilePtr xlist;
+		      max = (max == 0) ? 256 : max * 2;
+		      xlist = realloc (list, sizeof (rl2SampleTile) * max);
+		      if (xlist == NULL)
+			  goto error;
+		      list = xlist;
+		  }
+		tile = list + n;
+		tile->opaque_thread_id = NULL;
+		tile->tile_id = sqlite3_column_int64 (stmt, 0);
+		tile->minx = sqlite3_column_double (stmt, 1);
+		tile->miny = sqlite3_column_double (stmt, 2);
+		tile->maxx = sqlite3_column_double (stmt, 3);
+		tile->maxy = sqlite3_column_double (stmt, 4);
+		tile->first = 0;
+		tile->count = 0;
+		tile->blob_odd = NULL;
+		tile->blob_odd_sz = 0;
+		tile->blob_even = NULL;
+		tile->blob_even_sz = 0;
+		tile->palette = NULL;
+		tile->coverage = NULL;
+		tile->points = NULL;
+		tile->retcode = RL2_ERROR;
+		n++;
+	    }
+	  else
+	    {
+		fprintf (stderr, "RL2_SamplePoints; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (handle));
+		goto error;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    *tiles = list;
+    *count = n;
+    return 1;
+
+  error:
+    if (stmt != NULL)
+	sqlite3_finalize (stmt);
+    if (list != NULL)
+	free (list);
+    return 0;
+}
+
+static int
+assign_points_to_tiles (rl2SamplePointsPtr pts, rl2SampleTilePtr tiles,
+			int n_tiles)
+{
+/*
+/ assigning each Point to the Tile containing it; a regular grid
+/ indexing all Tiles is built first, so to avoid testing each Point
+/ against each Tile
+*/
+    int i;
+    int t;
+    int c;
+    int r;
+    int cols;
+    int rows;
+    int n_cells;
+    double gminx;
+    double gminy;
+    double gmaxx;
+    double gmaxy;
+    double cell_w;
+    double cell_h;
+    int *cell_first = NULL;
+    int *cell_tiles = NULL;
+    int *fill = NULL;
+    int n_refs = 0;
+
+    if (n_tiles <= 0)
+	return 1;
+    gminx = tiles->minx;
+    gminy = tiles->miny;
+    gmaxx = tiles->maxx;
+    gmaxy = tiles->maxy;
+    for (t = 1; t < n_tiles; t++)
+      {
+	  rl2SampleTilePtr tile = tiles + t;
+	  if (tile->minx < gminx)
+	      gminx = tile->minx;
+	  if (tile->miny < gminy)
+	      gminy = tile->miny;
+	  if (tile->maxx > gmaxx)
+	      gmaxx = tile->maxx;
+	  if (tile->maxy > gmaxy)
+	      gmaxy = tile->maxy;
+      }
+    cell_w = tiles->maxx - tiles->minx;
+    cell_h = tiles->maxy - tiles->miny;
+    if (cell_w <= 0.0 || cell_h <= 0.0)
+	return 0;
+    while (1)
+      {
+	  /* the grid cell is roughly as big as a Tile */
+	  double dc = floor ((gmaxx - gminx) / cell_w) + 1.0;
+	  double dr = floor ((gmaxy - gminy) / cell_h) + 1.0;
+	  if (dc * dr <= RL2_SAMPLE_MAX_GRID_CELLS)
+	    {
+		cols = (int) dc;
+		rows = (int) dr;
+		break;
+	    }
+	  cell_w *= 2.0;
+	  cell_h *= 2.0;
+      }
+    n_cells = cols * rows;
+
+/* counting the Tile references of each grid cell */
+    cell_first = calloc (n_cells + 1, sizeof (int));
+    if (cell_first == NULL)
+	goto error;
+    for (t = 0; t < n_tiles; t++)
+      {
+	  rl2SampleTilePtr tile = tiles + t;
+	  int c0 = (int) ((tile->minx - gminx) / cell_w);
+	  int c1 = (int) ((tile->maxx - gminx) / cell_w);
+	  int r0 = (int) ((tile->miny - gminy) / cell_h);
+	  int r1 = (int) ((tile->maxy - gminy) / cell_h);
+	  if (c1 >= cols)
+	      c1 = cols - 1;
+	  if (r1 >= rows)
+	      r1 = rows - 1;
+	  for (r = r0; r <= r1; r++)
+	    {
+		for (c = c0; c <= c1; c++)
+		  {
+		      cell_first[(r * cols) + c + 1] += 1;
+		      n_refs++;
+		  }
+	    }
+      }
+    for (i = 0; i < n_cells; i++)
+	cell_first[i + 1] += cell_first[i];
+    cell_tiles = malloc (sizeof (int) * n_refs);
+    fill = calloc (n_cells, sizeof (int));
+    if (cell_tiles == NULL || fill == NULL)
+	goto error;
+    for (t = 0; t < n_tiles; t++)
+      {
+	  rl2SampleTilePtr tile = tiles + t;
+	  int c0 = (int) ((tile->minx - gminx) / cell_w);
+	  int c1 = (int) ((tile->maxx - gminx) / cell_w);
+	  int r0 = (int) ((tile->miny - gminy) / cell_h);
+	  int r1 = (int) ((tile->maxy - gminy) / cell_h);
+	  if (c1 >= cols)
+	      c1 = cols - 1;
+	  if (r1 >= rows)
+	      r1 = rows - 1;
+	  for (r = r0; r <= r1; r++)
+	    {
+		for (c = c0; c <= c1; c++)
+		  {
+		      int cell = (r * cols) + c;
+		      cell_tiles[cell_first[cell] + fill[cell]] = t;
+		      fill[cell] += 1;
+		  }
+	    }
+      }
+
+/* locating the Tile of each Point */
+    for (i = 0; i < pts->count; i++)
+      {
+	  double x = pts->x[i];
+	  double y = pts->y[i];
+	  int cell;
+	  int k;
+	  if (pts->tile_of[i] == -2)
+	      continue;
+	  if (x < gminx || x > gmaxx || y < gminy || y > gmaxy)
+	      continue;
+	  c = (int) ((x - gminx) / cell_w);
+	  r = (int) ((y - gminy) / cell_h);
+	  if (c >= cols)
+	      c = cols - 1;
+	  if (r >= rows)
+	      r = rows - 1;
+	  cell = (r * cols) + c;
+	  for (k = cell_first[cell]; k < cell_first[cell + 1]; k++)
+	    {
+		rl2SampleTilePtr tile = tiles + cell_tiles[k];
+		if (x >= tile->minx && x <= tile->maxx && y >= tile->miny
+		    && y <= tile->maxy)
+		  {
+		      pts->tile_of[i] = cell_tiles[k];
+		      tile->count += 1;
+		      break;
+		  }
+	    }
+      }
+    free (cell_first);
+    free (cell_tiles);
+    free (fill);
+    cell_first = NULL;
+
+/* grouping Points by Tile */
+    pts->by_tile = malloc (sizeof (int) * (pts->count + 1));
+    if (pts->by_tile == NULL)
+	goto error;
+    n_refs = 0;
+    for (t = 0; t < n_tiles; t++)
+      {
+	  rl2SampleTilePtr tile = tiles + t;
+	  tile->first = n_refs;
+	  n_refs += tile->count;
+	  tile->count = 0;
+      }
+    for (i = 0; i < pts->count; i++)
+      {
+	  rl2SampleTilePtr tile;
+	  if (pts->tile_of[i] < 0)
+	      continue;
+	  tile = tiles + pts->tile_of[i];
+	  pts->by_tile[tile->first + tile->count] = i;
+	  tile->count += 1;
+      }
+    return 1;
+
+  error:
+    if (cell_first != NULL)
+	free (cell_first);
+    if (cell_tiles != NULL)
+	free (cell_tiles);
+    if (fill != NULL)
+	free (fill);
+    return 0;
+}
+
+static double
+get_sample_value (rl2PrivRasterPtr rst, unsigned int row, unsigned int col,
+		  int band)
+{
+/* fetching a single sample from a Raster tile */
+    unsigned int idx = (((row * rst->width) + col) * rst->nBands) + band;
+    switch (rst->sampleType)
+      {
+      case RL2_SAMPLE_INT8:
+	  return *(((char *) (rst->rasterBuffer)) + idx);
+      case RL2_SAMPLE_INT16:
+	  return *(((short *) (rst->rasterBuffer)) + idx);
+      case RL2_SAMPLE_UINT16:
+	  return *(((unsigned short *) (rst->rasterBuffer)) + idx);
+      case RL2_SAMPLE_INT32:
+	  return *(((int *) (rst->rasterBuffer)) + idx);
+      case RL2_SAMPLE_UINT32:
+	  return *(((unsigned int *) (rst->rasterBuffer)) + idx);
+      case RL2_SAMPLE_FLOAT:
+	  return *(((float *) (rst->rasterBuffer)) + idx);
+      case RL2_SAMPLE_DOUBLE:
+	  return *(((double *) (rst->rasterBuffer)) + idx);
+      };
+    /* 1-BIT, 2-BIT, 4-BIT and UINT8 */
+    return *(rst->rasterBuffer + idx);
+}
+
+static int
+is_void_sample_pixel (rl2SamplePointsPtr pts, rl2PrivRasterPtr rst,
+		      unsigned int row, unsigned int col)
+{
+/* testing for a transparent or NO-DATA pixel */
+    int band;
+    if (rst->maskBuffer != NULL)
+      {
+	  if (*(rst->maskBuffer + (row * rst->width) + col) == 0)
+	      return 1;
+      }
+    if (pts->no_data == NULL)
+	return 0;
+    for (band = 0; band < rst->nBands; band++)
+      {
+	  if (get_sample_value (rst, row, col, band) != pts->no_data[band])
+	      return 0;
+      }
+    return 1;
+}
+
+static void
+do_sample_one_point (rl2SampleTilePtr tile, rl2PrivRasterPtr rst, int index)
+{
+/* sampling a single Point from its own Tile */
+    rl2SamplePointsPtr pts = tile->points;
+    double *values = pts->values + (index * pts->num_bands);
+    double hres = (tile->maxx - tile->minx) / (double) (rst->width);
+    double vres = (tile->maxy - tile->miny) / (double) (rst->height);
+    double fx = (pts->x[index] - tile->minx) / hres;
+    double fy = (tile->maxy - pts->y[index]) / vres;
+    int col = (int) fx;
+    int row = (int) fy;
+    int band;
+
+    if (col >= (int) (rst->width))
+	col = rst->width - 1;
+    if (row >= (int) (rst->height))
+	row = rst->height - 1;
+    if (col < 0 || row < 0)
+	return;
+    if (is_void_sample_pixel (pts, rst, row, col))
+	return;
+
+    if (pts->bilinear)
+      {
+	  /*
+	     / bilinear interpolation between the four nearest pixel
+	     / centers; the Tile edges are replicated, and the nearest
+	     / pixel is returned if any neighbour is void
+	   */
+	  double cx = fx - 0.5;
+	  double cy = fy - 0.5;
+	  int c0 = (int) floor (cx);
+	  int r0 = (int) floor (cy);
+	  int c1 = c0 + 1;
+	  int r1 = r0 + 1;
+	  double wx = cx - c0;
+	  double wy = cy - r0;
+	  if (c0 < 0)
+	      c0 = 0;
+	  if (r0 < 0)
+	      r0 = 0;
+	  if (c1 >= (int) (rst->width))
+	      c1 = rst->width - 1;
+	  if (r1 >= (int) (rst->height))
+	      r1 = rst->height - 1;
+	  if (!is_void_sample_pixel (pts, rst, r0, c0)
+	      && !is_void_sample_pixel (pts, rst, r0, c1)
+	      && !is_void_sample_pixel (pts, rst, r1, c0)
+	      && !is_void_sample_pixel (pts, rst, r1, c1))
+	    {
+		for (band = 0; band < rst->nBands; band++)
+		  {
+		      double v00 = get_sample_value (rst, r0, c0, band);
+		      double v01 = get_sample_value (rst, r0, c1, band);
+		      double v10 = get_sample_value (rst, r1, c0, band);
+		      double v11 = get_sample_value (rst, r1, c1, band);
+		      double top = v00 + ((v01 - v00) * wx);
+		      double bottom = v10 + ((v11 - v10) * wx);
+		      values[band] = top + ((bottom - top) * wy);
+		  }
+		pts->valid[index] = 1;
+		return;
+	    }
+      }
+
+    for (band = 0; band < rst->nBands; band++)
+	values[band] = get_sample_value (rst, row, col, band);
+    pts->valid[index] = 1;
+}
+
+static void
+do_sample_tile (rl2SampleTilePtr tile)
+{
+/* decoding a Tile and then sampling all its Points */
+    rl2SamplePointsPtr pts = tile->points;
+    rl2RasterPtr raster;
+    rl2PrivRasterPtr rst;
+    int i;
+
+    raster =
+	rl2_raster_decode_dict (RL2_SCALE_1, tile->blob_odd,
+				tile->blob_odd_sz, tile->blob_even,
+				tile->blob_even_sz, tile->palette,
+				tile->coverage);
+    tile->palette = NULL;
+    if (raster == NULL)
+      {
+	  tile->retcode = RL2_ERROR;
+	  return;
+      }
+    rst = (rl2PrivRasterPtr) raster;
+    if (rst->nBands != pts->num_bands || rst->width == 0 || rst->height == 0)
+      {
+	  rl2_destroy_raster (raster);
+	  tile->retcode = RL2_ERROR;
+	  return;
+      }
+    for (i = 0; i < tile->count; i++)
+	do_sample_one_point (tile, rst, pts->by_tile[tile->first + i]);
+    rl2_destroy_raster (raster);
+    tile->retcode = RL2_OK;
+}
+
+static void
+cleanup_sample_tile (rl2SampleTilePtr tile)
+{
+/* releasing the Tile encoded BLOBs */
+    if (tile->blob_odd != NULL)
+	free (tile->blob_odd);
+    if (tile->blob_even != NULL)
+	free (tile->blob_even);
+    if (tile->palette != NULL)
+	rl2_destroy_palette (tile->palette);
+    if (tile->opaque_thread_id != NULL)
+	free (tile->opaque_thread_id);
+    tile->blob_odd = NULL;
+    tile->blob_even = NULL;
+    tile->palette = NULL;
+    tile->opaque_thread_id = NULL;
+}
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+DWORD WINAPI
+doRunSampleTileThread (void *arg)
+#else
+void *
+doRunSampleTileThread (void *arg)
+#endif
+{
+/* threaded function: sampling a Tile */
+    rl2SampleTilePtr tile = (rl2SampleTilePtr) arg;
+    do_sample_tile (tile);
+#if defined(_WIN32) && !defined(__MINGW32__)
+    return 0;
+#else
+    pthread_exit (NULL);
+    return NULL;
+#endif
+}
+
+static void
+start_sample_tile_thread (rl2SampleTilePtr tile)
+{
+/* starting a concurrent thread */
+#if defined(_WIN32) && !defined(__MINGW32__)
+    HANDLE thread_handle;
+    HANDLE *p_thread;
+    DWORD dwThreadId;
+    thread_handle =
+	CreateThread (NULL, 0, doRunSampleTileThread, tile, 0, &dwThreadId);
+    if (thread_handle == NULL)
+      {
+	  /* failure: sampling the Tile on the main thread */
+	  do_sample_tile (tile);
+	  return;
+      }
+    p_thread = malloc (sizeof (HANDLE));
+    *p_thread = thread_handle;
+    tile->opaque_thread_id = p_thread;
+#else
+    pthread_t thread_id;
+    pthread_t *p_thread;
+    if (pthread_create (&thread_id, NULL, doRunSampleTileThread, tile) != 0)
+      {
+	  /* failure: sampling the Tile on the main thread */
+	  do_sample_tile (tile);
+	  return;
+      }
+    p_thread = malloc (sizeof (pthread_t));
+    *p_thread = thread_id;
+    tile->opaque_thread_id = p_thread;
+#endif
+}
+
+static void
+join_sample_tile_thread (rl2SampleTilePtr tile)
+{
+/* waiting until a concurrent thread exits */
+    if (tile->opaque_thread_id == NULL)
+	return;
+#if defined(_WIN32) && !defined(__MINGW32__)
+    WaitForSingleObject (*((HANDLE *) (tile->opaque_thread_id)), INFINITE);
+    CloseHandle (*((HANDLE *) (tile->opaque_thread_id)));
+#else
+    pthread_join (*((pthread_t *) (tile->opaque_thread_id)), NULL);
+#endif
+    free (tile->opaque_thread_id);
+    tile->opaque_thread_id = NULL;
+}
+
+static int
+fetch_sample_tile (sqlite3_stmt * stmt, rl2SampleTilePtr tile,
+		   rl2PalettePtr palette)
+{
+/* fetching the encoded BLOBs of some Tile */
+    int ret;
+    int ok = 0;
+    sqlite3_reset (stmt);
+    sqlite3_clear_bindings (stmt);
+    sqlite3_bind_int64 (stmt, 1, tile->tile_id);
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		if (sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+		  {
+		      tile->blob_odd_sz = sqlite3_column_bytes (stmt, 0);
+		      tile->blob_odd = malloc (tile->blob_odd_sz);
+		      if (tile->blob_odd == NULL)
+			  return 0;
+		      memcpy (tile->blob_odd, sqlite3_column_blob (stmt, 0),
+			      tile->blob_odd_sz);
+		      ok = 1;
+		  }
+		if (sqlite3_column_type (stmt, 1) == SQLITE_BLOB)
+		  {
+		      tile->blob_even_sz = sqlite3_column_bytes (stmt, 1);
+		      tile->blob_even = malloc (tile->blob_even_sz);
+		      if (tile->blob_even == NULL)
+			  return 0;
+		      memcpy (tile->blob_even, sqlite3_column_blob (stmt, 1),
+			      tile->blob_even_sz);
+		  }
+	    }
+	  else
+	      return 0;
+      }
+    if (ok)
+	tile->palette = rl2_clone_palette (palette);
+    return ok;
+}
+
+static double
+no_data_sample_value (rl2PrivPixelPtr pxl, int band)
+{
+/* returning the NO-DATA value of some Band */
+    rl2PrivSamplePtr sample = pxl->Samples + band;
+    switch (pxl->sampleType)
+      {
+      case RL2_SAMPLE_INT8:
+	  return sample->int8;
+      case RL2_SAMPLE_INT16:
+	  return sample->int16;
+      case RL2_SAMPLE_UINT16:
+	  return sample->uint16;
+      case RL2_SAMPLE_INT32:
+	  return sample->int32;
+      case RL2_SAMPLE_UINT32:
+	  return sample->uint32;
+      case RL2_SAMPLE_FLOAT:
+	  return sample->float32;
+      case RL2_SAMPLE_DOUBLE:
+	  return sample->float64;
+      };
+    return sample->uint8;
+}
+
+static rl2SamplePointsPtr
+do_sample_points (sqlite3 * handle, const void *priv_data,
+		  const char *db_prefix, const char *coverage,
+		  int pyramid_level, const char *point_table,
+		  const char *geom_column, int bilinear)
+{
+/* sampling a Raster Coverage by all Points from a Spatial Table */
+    struct rl2_private_data *cache = (struct rl2_private_data *) priv_data;
+    rl2CoveragePtr cvg = NULL;
+    rl2PalettePtr palette = NULL;
+    rl2SamplePointsPtr pts = NULL;
+    rl2SampleTilePtr tiles = NULL;
+    int n_tiles = 0;
+    sqlite3_stmt *stmt_data = NULL;
+    unsigned char sample_type;
+    unsigned char pixel_type;
+    unsigned char num_bands;
+    rl2PrivPixelPtr no_data;
+    int srid;
+    double minx;
+    double miny;
+    double maxx;
+    double maxy;
+    int max_threads = 1;
+    int t;
+    int i;
+    int ret;
+    char *sql;
+    char *xdb_prefix;
+    char *table;
+    char *xtable;
+
+    cvg = rl2_create_coverage_from_dbms (handle, db_prefix, coverage);
+    if (cvg == NULL)
+	goto error;
+    if (rl2_get_coverage_srid (cvg, &srid) != RL2_OK)
+	goto error;
+    if (rl2_get_coverage_type (cvg, &sample_type, &pixel_type, &num_bands) !=
+	RL2_OK)
+	goto error;
+    pts = create_sample_points ();
+    if (pts == NULL)
+	goto error;
+    pts->sample_type = sample_type;
+    pts->num_bands = num_bands;
+    pts->bilinear = bilinear;
+    no_data = (rl2PrivPixelPtr) rl2_get_coverage_no_data (cvg);
+    if (no_data != NULL && no_data->nBands == num_bands)
+      {
+	  pts->no_data = malloc (sizeof (double) * num_bands);
+	  if (pts->no_data == NULL)
+	      goto error;
+	  for (i = 0; i < num_bands; i++)
+	      pts->no_data[i] = no_data_sample_value (no_data, i);
+      }
+
+/* loading (and transforming) all Points */
+    if (!load_sample_points (handle, point_table, geom_column, srid, pts))
+	goto error;
+    if (pts->count > 0)
+      {
+	  pts->values = malloc (sizeof (double) * pts->count * num_bands);
+	  pts->valid = calloc (pts->count, sizeof (unsigned char));
+	  if (pts->values == NULL || pts->valid == NULL)
+	      goto error;
+      }
+    if (!get_sample_points_extent (pts, &minx, &miny, &maxx, &maxy))
+      {
+	  rl2_destroy_coverage (cvg);
+	  return pts;
+      }
+
+/* loading the Tiles and grouping Points by Tile */
+    if (!load_sample_tiles
+	(handle, db_prefix, coverage, pyramid_level, minx, miny, maxx, maxy,
+	 &tiles, &n_tiles))
+	goto error;
+    if (!assign_points_to_tiles (pts, tiles, n_tiles))
+	goto error;
+
+/* preparing the SQL query - tile data */
+    xdb_prefix = rl2_double_quoted_sql ((db_prefix == NULL) ? "main" : db_prefix);
+    table = sqlite3_mprintf ("%s_tile_data", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql =
+	sqlite3_mprintf
+	("SELECT tile_data_odd, tile_data_even FROM \"%s\".\"%s\" "
+	 "WHERE tile_id = ?", xdb_prefix, xtable);
+    free (xdb_prefix);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt_data, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    palette = rl2_get_dbms_palette (handle, db_prefix, coverage);
+
+/* decoding and sampling all Tiles - may be in parallel */
+    if (cache != NULL)
+	max_threads = cache->max_threads;
+    if (max_threads < 1)
+	max_threads = 1;
+    if (max_threads > 64)
+	max_threads = 64;
+    t = 0;
+    while (t < n_tiles)
+      {
+	  int first = t;
+	  int batch = 0;
+	  while (t < n_tiles && batch < max_threads)
+	    {
+		/* fetching the next batch of Tiles (main thread only) */
+		rl2SampleTilePtr tile = tiles + t;
+		t++;
+		if (tile->count == 0)
+		    continue;
+		tile->points = pts;
+		tile->coverage = cvg;
+		if (!fetch_sample_tile (stmt_data, tile, palette))
+		  {
+		      /* missing Tile: e.g. a sparse one */
+		      cleanup_sample_tile (tile);
+		      tile->count = 0;
+		      continue;
+		  }
+		batch++;
+	    }
+	  for (i = first; i < t; i++)
+	    {
+		rl2SampleTilePtr tile = tiles + i;
+		if (tile->count == 0)
+		    continue;
+		if (max_threads > 1 && batch > 1)
+		    start_sample_tile_thread (tile);
+		else
+		    do_sample_tile (tile);
+	    }
+	  for (i = first; i < t; i++)
+	    {
+		rl2SampleTilePtr tile = tiles + i;
+		if (tile->count == 0)
+		    continue;
+		join_sample_tile_thread (tile);
+		cleanup_sample_tile (tile);
+	    }
+      }
+    sqlite3_finalize (stmt_data);
+    if (palette != NULL)
+	rl2_destroy_palette (palette);
+    free (tiles);
+    rl2_destroy_coverage (cvg);
+    return pts;
+
+  error:
+    if (stmt_data != NULL)
+	sqlite3_finalize (stmt_data);
+    if (palette != NULL)
+	rl2_destroy_palette (palette);
+    if (tiles != NULL)
+      {
+	  for (t = 0; t < n_tiles; t++)
+	      cleanup_sample_tile (tiles + t);
+	  free (tiles);
+      }
+    if (cvg != NULL)
+	rl2_destroy_coverage (cvg);
+    if (pts != NULL)
+	destroy_sample_points (pts);
+    return NULL;
+}
+
+static int
+vsample_connect (sqlite3 * db, void *pAux, int argc, const char *const *argv,
+		 sqlite3_vtab ** ppVTab, char **pzErr)
+{
+/* connects the eponymous virtual table */
+    int ret;
+    VirtualSamplePointsPtr p_vt;
+    if (argc)
+	argc = argc;		/* unused arg warning suppression */
+    if (argv)
+	argv = argv;		/* unused arg warning suppression */
+    ret =
+	sqlite3_declare_vtab (db,
+			      "CREATE TABLE x(fid INTEGER, band INTEGER, "
+			      "value DOUBLE, coverage HIDDEN TEXT, "
+			      "pyramid_level HIDDEN INTEGER, "
+			      "point_table HIDDEN TEXT, "
+			      "geometry_column HIDDEN TEXT, "
+			      "bilinear HIDDEN INTEGER, "
+			      "db_prefix HIDDEN TEXT)");
+    if (ret != SQLITE_OK)
+      {
+	  *pzErr = sqlite3_mprintf ("[RL2_SamplePoints module] %s",
+				    sqlite3_errmsg (db));
+	  return ret;
+      }
+    p_vt = (VirtualSamplePointsPtr) sqlite3_malloc (sizeof (VirtualSamplePoints));
+    if (!p_vt)
+	return SQLITE_NOMEM;
+    p_vt->db = db;
+    p_vt->priv_data = pAux;
+    p_vt->pModule = NULL;
+    p_vt->nRef = 0;
+    p_vt->zErrMsg = NULL;
+    *ppVTab = (sqlite3_vtab *) p_vt;
+    return SQLITE_OK;
+}
+
+static int
+vsample_best_index (sqlite3_vtab * pVTab, sqlite3_index_info * pIdxInfo)
+{
+/* best index selection: mapping the function arguments */
+    int i;
+    int arg_index[RL2_SAMPLE_MAX_COLUMNS];
+    int mask = 0;
+    int n_args = 0;
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+
+    for (i = 0; i < RL2_SAMPLE_MAX_COLUMNS; i++)
+	arg_index[i] = -1;
+    for (i = 0; i < pIdxInfo->nConstraint; i++)
+      {
+	  const struct sqlite3_index_constraint *p = pIdxInfo->aConstraint + i;
+	  if (p->iColumn < RL2_SAMPLE_COL_COVERAGE)
+	      continue;
+	  if (!p->usable)
+	      continue;
+	  if (p->op != SQLITE_INDEX_CONSTRAINT_EQ)
+	      continue;
+	  arg_index[p->iColumn] = i;
+	  mask |= 1 << (p->iColumn - RL2_SAMPLE_COL_COVERAGE);
+      }
+/* coverage, pyramid_level, point_table and geometry_column are mandatory */
+    if ((mask & 0x0f) != 0x0f)
+      {
+	  /* unusable plan: the cursor will simply return no rows */
+	  pIdxInfo->idxNum = 0;
+	  pIdxInfo->estimatedCost = 1.0e+99;
+	  return SQLITE_OK;
+      }
+    for (i = RL2_SAMPLE_COL_COVERAGE; i < RL2_SAMPLE_MAX_COLUMNS; i++)
+      {
+	  if (arg_index[i] < 0)
+	      continue;
+	  n_args++;
+	  pIdxInfo->aConstraintUsage[arg_index[i]].argvIndex = n_args;
+	  pIdxInfo->aConstraintUsage[arg_index[i]].omit = 1;
+      }
+    pIdxInfo->idxNum = mask;
+    pIdxInfo->estimatedCost = 1000000.0;
+    return SQLITE_OK;
+}
+
+static int
+vsample_disconnect (sqlite3_vtab * pVTab)
+{
+/* disconnects the virtual table */
+    VirtualSamplePointsPtr p_vt = (VirtualSamplePointsPtr) pVTab;
+    sqlite3_free (p_vt);
+    return SQLITE_OK;
+}
+
+static int
+vsample_open (sqlite3_vtab * pVTab, sqlite3_vtab_cursor ** ppCursor)
+{
+/* opening a new cursor */
+    VirtualSamplePointsCursorPtr cursor =
+	(VirtualSamplePointsCursorPtr)
+	sqlite3_malloc (sizeof (VirtualSamplePointsCursor));
+    if (cursor == NULL)
+	return SQLITE_NOMEM;
+    cursor->pVtab = (VirtualSamplePointsPtr) pVTab;
+    cursor->samples = NULL;
+    cursor->current_point = 0;
+    cursor->current_band = 0;
+    cursor->current_row = 0;
+    cursor->eof = 1;
+    *ppCursor = (sqlite3_vtab_cursor *) cursor;
+    return SQLITE_OK;
+}
+
+static int
+vsample_close (sqlite3_vtab_cursor * pCursor)
+{
+/* closing the cursor */
+    VirtualSamplePointsCursorPtr cursor =
+	(VirtualSamplePointsCursorPtr) pCursor;
+    if (cursor->samples != NULL)
+	destroy_sample_points (cursor->samples);
+    sqlite3_free (pCursor);
+    return SQLITE_OK;
+}
+
+static int
+vsample_filter (sqlite3_vtab_cursor * pCursor, int idxNum, const char *idxStr,
+		int argc, sqlite3_value ** argv)
+{
+/* setting up a cursor filter: this is where sampling actually happens */
+    VirtualSamplePointsCursorPtr cursor =
+	(VirtualSamplePointsCursorPtr) pCursor;
+    const char *coverage = NULL;
+    int pyramid_level = 0;
+    const char *point_table = NULL;
+    const char *geom_column = NULL;
+    int bilinear = 0;
+    const char *db_prefix = NULL;
+    int arg = 0;
+    if (idxStr)
+	idxStr = idxStr;	/* unused arg warning suppression */
+
+    if (cursor->samples != NULL)
+	destroy_sample_points (cursor->samples);
+    cursor->samples = NULL;
+    cursor->current_point = 0;
+    cursor->current_band = 0;
+    cursor->current_row = 0;
+    cursor->eof = 1;
+    if (argc < 4)
+	return SQLITE_OK;
+
+    if (sqlite3_value_type (argv[arg]) == SQLITE_TEXT)
+	coverage = (const char *) sqlite3_value_text (argv[arg]);
+    arg++;
+    if (sqlite3_value_type (argv[arg]) == SQLITE_INTEGER)
+	pyramid_level = sqlite3_value_int (argv[arg]);
+    else
+	coverage = NULL;
+    arg++;
+    if (sqlite3_value_type (argv[arg]) == SQLITE_TEXT)
+	point_table = (const char *) sqlite3_value_text (argv[arg]);
+    arg++;
+    if (sqlite3_value_type (argv[arg]) == SQLITE_TEXT)
+	geom_column = (const char *) sqlite3_value_text (argv[arg]);
+    arg++;
+    if (idxNum & 0x10)
+      {
+	  if (sqlite3_value_type (argv[arg]) == SQLITE_INTEGER)
+	      bilinear = sqlite3_value_int (argv[arg]);
+	  arg++;
+      }
+    if (idxNum & 0x20)
+      {
+	  if (sqlite3_value_type (argv[arg]) == SQLITE_TEXT)
+	      db_prefix = (const char *) sqlite3_value_text (argv[arg]);
+	  arg++;
+      }
+    if (coverage == NULL || point_table == NULL || geom_column == NULL)
+	return SQLITE_OK;
+
+    cursor->samples =
+	do_sample_points (cursor->pVtab->db, cursor->pVtab->priv_data,
+			  db_prefix, coverage, pyramid_level, point_table,
+			  geom_column, bilinear);
+    if (cursor->samples != NULL && cursor->samples->count > 0
+	&& cursor->samples->num_bands > 0)
+	cursor->eof = 0;
+    return SQLITE_OK;
+}
+
+static int
+vsample_next (sqlite3_vtab_cursor * pCursor)
+{
+/* fetching the next row: one for each Point and Band */
+    VirtualSamplePointsCursorPtr cursor =
+	(VirtualSamplePointsCursorPtr) pCursor;
+    rl2SamplePointsPtr pts = cursor->samples;
+    if (pts == NULL)
+      {
+	  cursor->eof = 1;
+	  return SQLITE_OK;
+      }
+    cursor->current_row++;
+    cursor->current_band++;
+    if (cursor->current_band >= pts->num_bands)
+      {
+	  cursor->current_band = 0;
+	  cursor->current_point++;
+      }
+    if (cursor->current_point >= pts->count)
+	cursor->eof = 1;
+    return SQLITE_OK;
+}
+
+static int
+vsample_eof (sqlite3_vtab_cursor * pCursor)
+{
+/* cursor EOF */
+    VirtualSamplePointsCursorPtr cursor =
+	(VirtualSamplePointsCursorPtr) pCursor;
+    return cursor->eof;
+}
+
+static int
+vsample_column (sqlite3_vtab_cursor * pCursor, sqlite3_context * pContext,
+		int column)
+{
+/* fetching value for the Nth column */
+    VirtualSamplePointsCursorPtr cursor =
+	(VirtualSamplePointsCursorPtr) pCursor;
+    rl2SamplePointsPtr pts = cursor->samples;
+    int index = cursor->current_point;
+    if (pts == NULL || cursor->eof)
+      {
+	  sqlite3_result_null (pContext);
+	  return SQLITE_OK;
+      }
+    switch (column)
+      {
+      case RL2_SAMPLE_COL_FID:
+	  sqlite3_result_int64 (pContext, pts->fids[index]);
+	  break;
+      case RL2_SAMPLE_COL_BAND:
+	  sqlite3_result_int (pContext, cursor->current_band);
+	  break;
+      case RL2_SAMPLE_COL_VALUE:
+	  if (pts->valid[index])
+	    {
+		double value =
+		    pts->values[(index * pts->num_bands) +
+				cursor->current_band];
+		switch (pts->sample_type)
+		  {
+		  case RL2_SAMPLE_FLOAT:
+		  case RL2_SAMPLE_DOUBLE:
+		      sqlite3_result_double (pContext, value);
+		      break;
+		  default:
+		      if (pts->bilinear)
+			  sqlite3_result_double (pContext, value);
+		      else
+			  sqlite3_result_int64 (pContext,
+						(sqlite3_int64) value);
+		      break;
+		  };
+	    }
+	  else
+	      sqlite3_result_null (pContext);
+	  break;
+      default:
+	  sqlite3_result_null (pContext);
+	  break;
+      };
+    return SQLITE_OK;
+}
+
+static int
+vsample_rowid (sqlite3_vtab_cursor * pCursor, sqlite_int64 * pRowid)
+{
+/* fetching the ROWID */
+    VirtualSamplePointsCursorPtr cursor =
+	(VirtualSamplePointsCursorPtr) pCursor;
+    *pRowid = cursor->current_row;
+    return SQLITE_OK;
+}
+
+static sqlite3_module my_sample_module = {
+    0,				/* iVersion */
+    0,				/* xCreate: eponymous-only */
+    &vsample_connect,		/* xConnect */
+    &vsample_best_index,	/* xBestIndex */
+    &vsample_disconnect,	/* xDisconnect */
+    0,				/* xDestroy */
+    &vsample_open,		/* xOpen */
+    &vsample_close,		/* xClose */
+    &vsample_filter,		/* xFilter */
+    &vsample_next,		/* xNext */
+    &vsample_eof,		/* xEof */
+    &vsample_column,		/* xColumn */
+    &vsample_rowid,		/* xRowid */
+    0,				/* xUpdate */
+    0,				/* xBegin */
+    0,				/* xSync */
+    0,				/* xCommit */
+    0,				/* xRollback */
+    0,				/* xFindFunction */
+    0,				/* xRename */
+    0,				/* xSavepoint */
+    0,				/* xRelease */
+    0				/* xRollbackTo */
+};
+
+RL2_PRIVATE int
+rl2_register_sample_points (sqlite3 * db, const void *priv_data)
+{
+/* registering the RL2_SamplePoints table-valued function */
+    return sqlite3_create_module_v2 (db, "RL2_SamplePoints",
+				     &my_sample_module, (void *) priv_data,
+				     0);
+}
@@ -598,6 +598,62 @@ fnct_GetMaxThreads (sqlite3_context * context, int argc, sqlite3_value ** argv)
     sqlite3_result_int (context, max_threads);
 }
 
+static void
+fnct_GetPerfCounters (sqlite3_context * context, int argc,
+		      sqlite3_value ** argv)
+{
+/* SQL function:
+/ RL2_GetPerfCounters()
+/
+/ returns a JSON object reporting the cumulative Performance Counters
+/ (count, elapsed millis and bytes) for each pipeline stage, and the
+/ Text Cache statistics (cached runs, hits and misses)
+/ or NULL on failure
+*/
+    char *json;
+    int runs = 0;
+    int hits = 0;
+    int misses = 0;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (priv_data == NULL)
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
+    rl2_get_text_cache_stats (priv_data, &runs, &hits, &misses);
+    json = rl2_perf_counters_to_json (priv_data->perf, runs, hits, misses);
+    if (json == NULL)
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
+    sqlite3_result_text (context, json, strlen (json), sqlite3_free);
+}
+
+static void
+fnct_ResetPerfCounters (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
+{
+/* SQL function:
+/ RL2_ResetPerfCounters()
+/
+/ resets all Performance Counters and the Text Cache hits and misses
+/ returns 1 on success
+/ 0 on failure
+*/
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (priv_data == NULL || priv_data->perf == NULL)
+      {
+	  sqlite3_result_int (context, 0);
+	  return;
+      }
+    rl2_reset_perf_counters (priv_data->perf);
+    rl2_reset_text_cache_stats (priv_data);
+    sqlite3_result_int (context, 1);
+}
+
 static void
 fnct_SetMaxThreads (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
@@ -632,1325 +688,2025 @@ fnct_SetMaxThreads (sqlite3_context * context, int argc, sqlite3_value ** argv)
 }
 
 static void
-fnct_GetMaxWmsRetries (sqlite3_context * context, int argc,
-		       sqlite3_value ** argv)
+fnct_GetRequestTimeout (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_GetMaxWmsRetries()
+/ RL2_GetRequestTimeout()
 /
-/ return the currently set Max number of WMS Retries
+/ return the currently set per-request deadline (in seconds)
+/ 0.0 means no deadline at all
 */
-    int max_wms_retries = 5;
+    double seconds = 0.0;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (priv_data != NULL)
-	max_wms_retries = priv_data->max_wms_retries;
-    sqlite3_result_int (context, max_wms_retries);
+	rl2_get_request_timeout (priv_data, &seconds);
+    sqlite3_result_double (context, seconds);
 }
 
 static void
-fnct_SetMaxWmsRetries (sqlite3_context * context, int argc,
-		       sqlite3_value ** argv)
+fnct_SetRequestTimeout (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_SetMaxWmsRetries(INTEGER max)
+/ RL2_SetRequestTimeout(DOUBLE seconds)
 /
-/ return the currently set Max number of WMS Retries (after this call)
+/ sets the max time any further rendering or export request is
+/ allowed to run before being cancelled (0.0 disables the deadline)
+/ while a deadline is set each request installs its own progress
+/ handler on the connection, removing it when the request completes
+/ return 1 on success, 0 on failure
 / -1 on invalid arguments
 */
-    int max_wms_retries = 5;
+    double seconds;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
-    if (sqlite3_value_type (argv[0]) == SQLITE_INTEGER)
-	max_wms_retries = sqlite3_value_int (argv[0]);
+    if (sqlite3_value_type (argv[0]) == SQLITE_FLOAT)
+	seconds = sqlite3_value_double (argv[0]);
+    else if (sqlite3_value_type (argv[0]) == SQLITE_INTEGER)
+	seconds = sqlite3_value_int (argv[0]);
     else
       {
 	  sqlite3_result_int (context, -1);
 	  return;
       }
-
-/* normalizing between 1 and 10 */
-    if (max_wms_retries < 1)
-	max_wms_retries = 1;
-    if (max_wms_retries > 10)
-	max_wms_retries = 10;
-
-    if (priv_data != NULL)
-	priv_data->max_wms_retries = max_wms_retries;
+    if (seconds < 0.0)
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    if (rl2_set_request_timeout (priv_data, seconds) != RL2_OK)
+	sqlite3_result_int (context, 0);
     else
-	max_wms_retries = 1;
-    sqlite3_result_int (context, max_wms_retries);
+	sqlite3_result_int (context, 1);
+}
+
+static const char *
+png_filter_name (unsigned char filter)
+{
+/* returns the symbolic name of some PNG filter */
+    switch (filter)
+      {
+      case RL2_PNG_FILTER_NONE:
+	  return "none";
+      case RL2_PNG_FILTER_SUB:
+	  return "sub";
+      case RL2_PNG_FILTER_UP:
+	  return "up";
+      case RL2_PNG_FILTER_AVERAGE:
+	  return "average";
+      case RL2_PNG_FILTER_PAETH:
+	  return "paeth";
+      };
+    return "adaptive";
 }
 
 static void
-fnct_GetWmsPause (sqlite3_context * context, int argc, sqlite3_value ** argv)
+fnct_GetPNGCompression (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_GetWmsPause()
+/ RL2_GetPNGCompression()
 /
-/ return the currently set WMS Pause (in millis)
+/ return the currently set PNG compression level (-1 meaning the
+/ zlib default)
 */
-    int wms_pause = 5;
+    int level = -1;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (priv_data != NULL)
-	wms_pause = priv_data->wms_pause;
-    sqlite3_result_int (context, wms_pause);
+	level = priv_data->png_level;
+    sqlite3_result_int (context, level);
 }
 
 static void
-fnct_SetWmsPause (sqlite3_context * context, int argc, sqlite3_value ** argv)
+fnct_SetPNGCompression (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_SetWmsPause(INTEGER millis)
+/ RL2_SetPNGCompression(INTEGER level)
+/ RL2_SetPNGCompression(TEXT preset)
 /
-/ return the currently set WMS Pause (after this call)
-/ -1 on invalid arguments
+/ sets the compression level (0-9) used when encoding PNG map images;
+/ presets are: 'fast' (level 1 + SUB filter), 'default' and 'best'
+/ (level 9 + adaptive filtering)
+/ return the currently set PNG compression level (after this call)
+/ -2 on invalid arguments
 */
-    int wms_pause = 1000;
+    int level;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (priv_data == NULL)
+      {
+	  sqlite3_result_int (context, -2);
+	  return;
+      }
     if (sqlite3_value_type (argv[0]) == SQLITE_INTEGER)
-	wms_pause = sqlite3_value_int (argv[0]);
+      {
+	  level = sqlite3_value_int (argv[0]);
+	  if (level < 0 || level > 9)
+	    {
+		sqlite3_result_int (context, -2);
+		return;
+	    }
+	  priv_data->png_level = level;
+      }
+    else if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
+      {
+	  const char *preset = (const char *) sqlite3_value_text (argv[0]);
+	  if (strcasecmp (preset, "fast") == 0)
+	    {
+		priv_data->png_level = 1;
+		priv_data->png_filter = RL2_PNG_FILTER_SUB;
+	    }
+	  else if (strcasecmp (preset, "default") == 0)
+	    {
+		priv_data->png_level = -1;
+		priv_data->png_filter = RL2_PNG_FILTER_ADAPTIVE;
+	    }
+	  else if (strcasecmp (preset, "best") == 0)
+	    {
+		priv_data->png_level = 9;
+		priv_data->png_filter = RL2_PNG_FILTER_ADAPTIVE;
+	    }
+	  else
+	    {
+		sqlite3_result_int (context, -2);
+		return;
+	    }
+      }
     else
       {
-	  sqlite3_result_int (context, -1);
+	  sqlite3_result_int (context, -2);
 	  return;
       }
-
-/* normalizing between 1 and 30000 */
-    if (wms_pause < 1)
-	wms_pause = 1;
-    if (wms_pause > 30000)
-	wms_pause = 30000;
-
-    if (priv_data != NULL)
-	priv_data->wms_pause = wms_pause;
-    else
-	wms_pause = 1;
-    sqlite3_result_int (context, wms_pause);
+    sqlite3_result_int (context, priv_data->png_level);
 }
 
 static void
-fnct_GetPdfMarginUOM (sqlite3_context * context, int argc,
-		      sqlite3_value ** argv)
+fnct_GetPNGFilter (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_GetPdfMarginUOM()
+/ RL2_GetPNGFilter()
 /
-/ return the current Unity Of Measure for PDF empty margins
+/ return the currently set PNG row filter
 */
-    const char *uom = "in";
+    const char *filter = "adaptive";
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (priv_data != NULL)
-      {
-	  switch (priv_data->pdf_margin_uom)
-	    {
-	    case RL2_PDF_MARGIN_MILLIMS:
-		uom = "mm";
-		break;
-	    case RL2_PDF_MARGIN_INCHES:
-	    default:
-		uom = "in";
-		break;
-	    };
-      }
-    sqlite3_result_text (context, uom, strlen (uom), SQLITE_STATIC);
+	filter = png_filter_name (priv_data->png_filter);
+    sqlite3_result_text (context, filter, strlen (filter), SQLITE_STATIC);
 }
 
 static void
-fnct_SetPdfMarginUOM (sqlite3_context * context, int argc,
-		      sqlite3_value ** argv)
+fnct_SetPNGFilter (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_SetPdfMarginUOM(text UOM)
+/ RL2_SetPNGFilter(TEXT filter)
 /
-/ return the current Unity Of Measure for PDF empty margins (after this call)
+/ sets the row filter used when encoding PNG map images; one of
+/ 'none', 'sub', 'up', 'average', 'paeth' or 'adaptive'
+/ return the currently set PNG row filter (after this call)
 / NULL on invalid arguments
 */
-    const char *uom = "in";
+    const char *filter;
+    unsigned char flt;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
-	uom = (const char *) sqlite3_value_text (argv[0]);
+	filter = (const char *) sqlite3_value_text (argv[0]);
     else
       {
 	  sqlite3_result_null (context);
 	  return;
       }
 
-    if (priv_data != NULL)
+    if (strcasecmp (filter, "none") == 0)
+	flt = RL2_PNG_FILTER_NONE;
+    else if (strcasecmp (filter, "sub") == 0)
+	flt = RL2_PNG_FILTER_SUB;
+    else if (strcasecmp (filter, "up") == 0)
+	flt = RL2_PNG_FILTER_UP;
+    else if (strcasecmp (filter, "average") == 0)
+	flt = RL2_PNG_FILTER_AVERAGE;
+    else if (strcasecmp (filter, "paeth") == 0)
+	flt = RL2_PNG_FILTER_PAETH;
+    else if (strcasecmp (filter, "adaptive") == 0)
+	flt = RL2_PNG_FILTER_ADAPTIVE;
+    else
       {
-	  if (strcasecmp (uom, "mm") == 0)
-	    {
-		priv_data->pdf_margin_uom = RL2_PDF_MARGIN_MILLIMS;
-		uom = "mm";
-	    }
-	  else
-	    {
-		priv_data->pdf_margin_uom = RL2_PDF_MARGIN_INCHES;
-		uom = "in";
-	    }
+	  sqlite3_result_null (context);
+	  return;
       }
-    else
-	uom = "in";
-    sqlite3_result_text (context, uom, strlen (uom), SQLITE_STATIC);
+    if (priv_data == NULL)
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
+    priv_data->png_filter = flt;
+    filter = png_filter_name (flt);
+    sqlite3_result_text (context, filter, strlen (filter), SQLITE_STATIC);
 }
 
 static void
-fnct_GetPdfMarginHorz (sqlite3_context * context, int argc,
+fnct_GetPNG8Dithering (sqlite3_context * context, int argc,
 		       sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_GetPdfMarginHorz()
+/ RL2_GetPNG8Dithering()
 /
-/ return the currently set Horizontal PDF empty margin
+/ return 1 if ordered dithering is applied to PNG8 / GIF map images,
+/ 0 if not
 */
-    double margin = 0.5;
+    int dithering = 0;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (priv_data != NULL)
-	margin = priv_data->pdf_margin_horz;
-    sqlite3_result_double (context, margin);
+	dithering = priv_data->png8_dithering;
+    sqlite3_result_int (context, dithering);
 }
 
 static void
-fnct_SetPdfMarginHorz (sqlite3_context * context, int argc,
+fnct_SetPNG8Dithering (sqlite3_context * context, int argc,
 		       sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_SetPdfMarginHorz(double MARGIN)
+/ RL2_SetPNG8Dithering(INTEGER enable)
 /
-/ return the currently set Horizontal PDF empty margin (after this call)
+/ enables or disables ordered dithering for PNG8 / GIF map images
+/ return the current setting (after this call)
 / -1 on invalid arguments
 */
-    double margin = 0.5;
+    int dithering;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (sqlite3_value_type (argv[0]) == SQLITE_INTEGER)
-	margin = sqlite3_value_int (argv[0]);
-    else if (sqlite3_value_type (argv[0]) == SQLITE_FLOAT)
-	margin = sqlite3_value_double (argv[0]);
+	dithering = sqlite3_value_int (argv[0]);
     else
       {
 	  sqlite3_result_int (context, -1);
 	  return;
       }
-
-/* avoiding negative margins */
-    if (margin < 0.0)
-	margin = 0.0;
-
-    if (priv_data != NULL)
-	priv_data->pdf_margin_horz = margin;
-    else
-	margin = 0.5;
-    sqlite3_result_double (context, margin);
+    if (priv_data == NULL)
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    priv_data->png8_dithering = (dithering) ? 1 : 0;
+    sqlite3_result_int (context, priv_data->png8_dithering);
 }
 
 static void
-fnct_GetPdfMarginVert (sqlite3_context * context, int argc,
-		       sqlite3_value ** argv)
+fnct_GetPNG8StablePalette (sqlite3_context * context, int argc,
+			   sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_GetPdfMarginVert()
+/ RL2_GetPNG8StablePalette()
 /
-/ return the currently set Horizontal PDF empty margin
+/ return 1 if PNG8 / GIF map images share a stable Palette for
+/ each Coverage + Style, 0 if not
 */
-    double margin = 0.5;
+    int stable = 0;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (priv_data != NULL)
-	margin = priv_data->pdf_margin_vert;
-    sqlite3_result_double (context, margin);
+	stable = priv_data->png8_stable_palette;
+    sqlite3_result_int (context, stable);
 }
 
 static void
-fnct_SetPdfMarginVert (sqlite3_context * context, int argc,
-		       sqlite3_value ** argv)
+fnct_SetPNG8StablePalette (sqlite3_context * context, int argc,
+			   sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_SetPdfMarginVert(double MARGIN)
+/ RL2_SetPNG8StablePalette(INTEGER enable)
 /
-/ return the currently set Vertical PDF empty margin (after this call)
+/ enables or disables the stable Palette for PNG8 / GIF map images;
+/ when enabled the Palette is computed once for each Coverage + Style
+/ from a sample of the first rendered tiles, and then reused by all
+/ following tiles until the Coverage changes
+/ return the current setting (after this call)
 / -1 on invalid arguments
 */
-    double margin = 0.5;
+    int stable;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (sqlite3_value_type (argv[0]) == SQLITE_INTEGER)
-	margin = sqlite3_value_int (argv[0]);
-    else if (sqlite3_value_type (argv[0]) == SQLITE_FLOAT)
-	margin = sqlite3_value_double (argv[0]);
+	stable = sqlite3_value_int (argv[0]);
     else
       {
 	  sqlite3_result_int (context, -1);
 	  return;
       }
+    if (priv_data == NULL)
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    priv_data->png8_stable_palette = (stable) ? 1 : 0;
+    sqlite3_result_int (context, priv_data->png8_stable_palette);
+}
 
-/* avoiding negative margins */
-    if (margin < 0.0)
-	margin = 0.0;
-
+static void
+fnct_GetSparseTiles (sqlite3_context * context, int argc,
+		     sqlite3_value ** argv)
+{
+/* SQL function:
+/ RL2_GetSparseTiles()
+/
+/ return 1 if empty and uniform Raster tiles are skipped when
+/ importing or building Pyramids, 0 if not
+*/
+    int sparse = 0;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (priv_data != NULL)
-	priv_data->pdf_margin_vert = margin;
-    else
-	margin = 0.5;
-    sqlite3_result_double (context, margin);
+	sparse = priv_data->sparse_tiles;
+    sqlite3_result_int (context, sparse);
 }
 
 static void
-fnct_GetPdfPaperFormat (sqlite3_context * context, int argc,
-			sqlite3_value ** argv)
+fnct_SetSparseTiles (sqlite3_context * context, int argc,
+		     sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_GetPdfPaperFormat()
+/ RL2_SetSparseTiles(INTEGER enable)
 /
-/ return the current PDF Paper Format
+/ enables or disables sparse tiles; when enabled fully transparent
+/ or NO-DATA tiles are never stored, and tiles containing a single
+/ value are stored as a tiny Uniform marker
+/ return the current setting (after this call)
+/ -1 on invalid arguments
 */
-    const char *format = "A4";
+    int sparse;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
-    if (priv_data != NULL)
+    if (sqlite3_value_type (argv[0]) == SQLITE_INTEGER)
+	sparse = sqlite3_value_int (argv[0]);
+    else
       {
-	  switch (priv_data->pdf_paper_format)
-	    {
-	    case RL2_PDF_PAPER_FORMAT_A0:
-		format = "A0";
-		break;
-	    case RL2_PDF_PAPER_FORMAT_A1:
-		format = "A1";
-		break;
-	    case RL2_PDF_PAPER_FORMAT_A2:
-		format = "A2";
-		break;
-	    case RL2_PDF_PAPER_FORMAT_A3:
-		format = "A3";
-		break;
-	    case RL2_PDF_PAPER_FORMAT_A5:
-		format = "A5";
-		break;
-	    case RL2_PDF_PAPER_FORMAT_A4:
-	    default:
-		format = "A4";
-		break;
-	    };
+	  sqlite3_result_int (context, -1);
+	  return;
       }
-    sqlite3_result_text (context, format, strlen (format), SQLITE_STATIC);
+    if (priv_data == NULL)
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    priv_data->sparse_tiles = (sparse) ? 1 : 0;
+    sqlite3_result_int (context, priv_data->sparse_tiles);
+}
+
+static const char *
+section_checksum_name (unsigned char algorithm)
+{
+/* returning the name of some Section checksum algorithm */
+    if (algorithm == RL2_CHECKSUM_XXH64)
+	return "xxh64";
+    return "md5";
+}
+
+static int
+stored_checksum_algorithm (const char *stored)
+{
+/*
+/ identifying the algorithm of some stored Section checksum
+/ (despite its name, the md5_checksum column may hold either
+/ an MD5 or an XXH64 digest, both encoded as lowercase HEX;
+/ the length of the HEX string unambiguously tells them apart)
+*/
+    size_t len = strlen (stored);
+    if (len == 32)
+	return RL2_CHECKSUM_MD5;
+    if (len == 16)
+	return RL2_CHECKSUM_XXH64;
+    return -1;
 }
 
 static void
-fnct_SetPdfPaperFormat (sqlite3_context * context, int argc,
-			sqlite3_value ** argv)
+fnct_GetSectionChecksum (sqlite3_context * context, int argc,
+			 sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_SetPdfPaperFormat(text FORMAT)
+/ RL2_GetSectionChecksum()
 /
-/ return the current PDF Page Format (after this call)
+/ return the algorithm currently used for computing the md5_checksum
+/ of imported Sections
+*/
+    const char *algorithm = "md5";
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (priv_data != NULL)
+	algorithm = section_checksum_name (priv_data->section_checksum);
+    sqlite3_result_text (context, algorithm, strlen (algorithm),
+			 SQLITE_STATIC);
+}
+
+static void
+fnct_SetSectionChecksum (sqlite3_context * context, int argc,
+			 sqlite3_value ** argv)
+{
+/* SQL function:
+/ RL2_SetSectionChecksum(TEXT algorithm)
+/
+/ sets the algorithm used for computing the md5_checksum of imported
+/ Sections; one of 'MD5' (default) or 'XXH64' (a much faster but
+/ non-cryptographic digest)
+/ both digests are stored into the same md5_checksum column: 32 HEX
+/ digits for MD5, 16 HEX digits for XXH64
+/ return the currently set algorithm (after this call)
 / NULL on invalid arguments
 */
-    const char *format = "A4";
+    const char *algorithm;
+    unsigned char alg;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
-	format = (const char *) sqlite3_value_text (argv[0]);
+	algorithm = (const char *) sqlite3_value_text (argv[0]);
     else
       {
 	  sqlite3_result_null (context);
 	  return;
       }
 
-    if (priv_data != NULL)
+    if (strcasecmp (algorithm, "md5") == 0)
+	alg = RL2_CHECKSUM_MD5;
+    else if (strcasecmp (algorithm, "xxh64") == 0)
+	alg = RL2_CHECKSUM_XXH64;
+    else
       {
-	  if (strcasecmp (format, "A0") == 0)
-	    {
-		priv_data->pdf_paper_format = RL2_PDF_PAPER_FORMAT_A0;
-		format = "A0";
-	    }
-	  else if (strcasecmp (format, "A1") == 0)
-	    {
-		priv_data->pdf_paper_format = RL2_PDF_PAPER_FORMAT_A1;
-		format = "A1";
-	    }
-	  else if (strcasecmp (format, "A2") == 0)
-	    {
-		priv_data->pdf_paper_format = RL2_PDF_PAPER_FORMAT_A2;
-		format = "A2";
-	    }
-	  else if (strcasecmp (format, "A3") == 0)
-	    {
-		priv_data->pdf_paper_format = RL2_PDF_PAPER_FORMAT_A3;
-		format = "A3";
-	    }
-	  else if (strcasecmp (format, "A5") == 0)
-	    {
-		priv_data->pdf_paper_format = RL2_PDF_PAPER_FORMAT_A5;
-		format = "A5";
-	    }
-	  else
-	    {
-		priv_data->pdf_paper_format = RL2_PDF_PAPER_FORMAT_A4;
-		format = "A4";
-	    }
+	  sqlite3_result_null (context);
+	  return;
+      }
+    if (priv_data == NULL)
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
+    priv_data->section_checksum = alg;
+    algorithm = section_checksum_name (alg);
+    sqlite3_result_text (context, algorithm, strlen (algorithm),
+			 SQLITE_STATIC);
+}
+
+static void
+fnct_CheckSectionChecksum (sqlite3_context * context, int argc,
+			   sqlite3_value ** argv)
+{
+/* SQL function:
+/ CheckSectionChecksum(text coverage, integer section_id)
+/ CheckSectionChecksum(text coverage, integer section_id,
+/                      text path_to_raster)
+/
+/ hashes the Source file (by default: the file_path stored by the
+/ Section) and compares it with the stored md5_checksum; the digest
+/ algorithm is inferred from the length of the stored checksum
+/ (32 HEX digits: MD5, 16 HEX digits: XXH64)
+/
+/ will return 1 (TRUE, matching) or 0 (FALSE, mismatching or unreadable)
+/ or -1 (INVALID ARGS, no checksum stored or unknown digest)
+/
+*/
+    int err = 0;
+    const char *coverage;
+    sqlite3_int64 section_id;
+    const char *path = NULL;
+    char *stored = NULL;
+    char *src_path = NULL;
+    char *checksum;
+    int algorithm;
+    char *table;
+    char *xtable;
+    char *sql;
+    sqlite3 *sqlite;
+    sqlite3_stmt *stmt = NULL;
+    int ret;
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+	err = 1;
+    if (sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
+	err = 1;
+    if (argc > 2 && sqlite3_value_type (argv[2]) != SQLITE_TEXT)
+	err = 1;
+    if (err)
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    sqlite = sqlite3_context_db_handle (context);
+    coverage = (const char *) sqlite3_value_text (argv[0]);
+    section_id = sqlite3_value_int64 (argv[1]);
+    if (argc > 2)
+	path = (const char *) sqlite3_value_text (argv[2]);
+
+/* retrieving the stored checksum and path */
+    table = sqlite3_mprintf ("%s_sections", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql =
+	sqlite3_mprintf
+	("SELECT md5_checksum, file_path FROM main.\"%s\" WHERE section_id = ?",
+	 xtable);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto invalid;
+    sqlite3_bind_int64 (stmt, 1, section_id);
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW)
+      {
+	  if (sqlite3_column_type (stmt, 0) == SQLITE_TEXT)
+	      stored =
+		  sqlite3_mprintf ("%s",
+				   (const char *) sqlite3_column_text (stmt,
+								       0));
+	  if (path == NULL && sqlite3_column_type (stmt, 1) == SQLITE_TEXT)
+	      src_path =
+		  sqlite3_mprintf ("%s",
+				   (const char *) sqlite3_column_text (stmt,
+								       1));
       }
+    sqlite3_finalize (stmt);
+    if (path != NULL)
+	src_path = sqlite3_mprintf ("%s", path);
+    if (stored == NULL || src_path == NULL)
+	goto invalid;
+
+/* hashing the Source file */
+    algorithm = stored_checksum_algorithm (stored);
+    if (algorithm < 0)
+	goto invalid;
+    checksum = rl2_compute_file_checksum (src_path, algorithm);
+    if (checksum == NULL)
+	ret = 0;
     else
-	format = "A4";
-    sqlite3_result_text (context, format, strlen (format), SQLITE_STATIC);
+      {
+	  ret = (strcasecmp (checksum, stored) == 0) ? 1 : 0;
+	  free (checksum);
+      }
+    sqlite3_free (stored);
+    sqlite3_free (src_path);
+    sqlite3_result_int (context, ret);
+    return;
+
+  invalid:
+    if (stored != NULL)
+	sqlite3_free (stored);
+    if (src_path != NULL)
+	sqlite3_free (src_path);
+    sqlite3_result_int (context, -1);
 }
 
 static void
-fnct_GetPdfDPI (sqlite3_context * context, int argc, sqlite3_value ** argv)
+fnct_GetParallelVectorRendering (sqlite3_context * context, int argc,
+				 sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_GetPdfDPI()
+/ RL2_GetParallelVectorRendering()
 /
-/ return the current PDF DPI setting
+/ return 1 if Vector Coverages are rendered in parallel (horizontal
+/ bands, one for each thread), 0 if not
 */
-    int dpi = 300;
+    int parallel = 0;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (priv_data != NULL)
-      {
-	  switch (priv_data->pdf_dpi)
-	    {
-	    case RL2_PDF_DPI_72:
-		dpi = 72;
-		break;
-	    case RL2_PDF_DPI_150:
-		dpi = 150;
-		break;
-	    case RL2_PDF_DPI_600:
-		dpi = 600;
-		break;
-	    case RL2_PDF_DPI_300:
-	    default:
-		dpi = 300;
-		break;
-	    };
-      }
-    sqlite3_result_int (context, dpi);
+	parallel = priv_data->parallel_vector;
+    sqlite3_result_int (context, parallel);
 }
 
 static void
-fnct_SetPdfDPI (sqlite3_context * context, int argc, sqlite3_value ** argv)
+fnct_SetParallelVectorRendering (sqlite3_context * context, int argc,
+				 sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_SetPdfDPI(integer DPI)
+/ RL2_SetParallelVectorRendering(INTEGER enable)
 /
-/ return the current PDF DPI setting (after this call)
-/ NULL on invalid arguments
+/ enables or disables parallel rendering of Vector Coverages; when
+/ enabled (and MaxThreads is greater than 1) the canvas is split into
+/ horizontal bands, each one of them being painted by its own thread
+/ return the current setting (after this call)
+/ -1 on invalid arguments
 */
-    int dpi = 300;
+    int parallel;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (sqlite3_value_type (argv[0]) == SQLITE_INTEGER)
-	dpi = sqlite3_value_int (argv[0]);
+	parallel = sqlite3_value_int (argv[0]);
     else
       {
-	  sqlite3_result_null (context);
+	  sqlite3_result_int (context, -1);
 	  return;
       }
-
-    if (priv_data != NULL)
+    if (priv_data == NULL)
       {
-	  if (dpi == 72)
-	      priv_data->pdf_dpi = RL2_PDF_DPI_72;
-	  else if (dpi == 150)
-	      priv_data->pdf_dpi = RL2_PDF_DPI_150;
-	  else if (dpi == 600)
-	      priv_data->pdf_dpi = RL2_PDF_DPI_600;
-	  else
-	    {
-		priv_data->pdf_dpi = RL2_PDF_DPI_300;
-		dpi = 300;
-	    }
+	  sqlite3_result_int (context, -1);
+	  return;
       }
-    else
-	dpi = 300;
-    sqlite3_result_int (context, dpi);
+    priv_data->parallel_vector = (parallel) ? 1 : 0;
+    sqlite3_result_int (context, priv_data->parallel_vector);
 }
 
 static void
-fnct_GetPdfOrientation (sqlite3_context * context, int argc,
-			sqlite3_value ** argv)
+fnct_GetMaxWmsRetries (sqlite3_context * context, int argc,
+		       sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_GetPdfOrientation()
+/ RL2_GetMaxWmsRetries()
 /
-/ return the current PDF Orientation setting
+/ return the currently set Max number of WMS Retries
 */
-    const char *orientation = "Portrait";
+    int max_wms_retries = 5;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (priv_data != NULL)
-      {
-	  switch (priv_data->pdf_orientation)
-	    {
-	    case RL2_PDF_LANDSCAPE:
-		orientation = "Landscape";
-		break;
-	    case RL2_PDF_PORTRAIT:
-	    default:
-		orientation = "Portrait";
-		break;
-	    };
-      }
-    sqlite3_result_text (context, orientation, strlen (orientation),
-			 SQLITE_STATIC);
+	max_wms_retries = priv_data->max_wms_retries;
+    sqlite3_result_int (context, max_wms_retries);
 }
 
 static void
-fnct_SetPdfOrientation (sqlite3_context * context, int argc,
-			sqlite3_value ** argv)
+fnct_SetMaxWmsRetries (sqlite3_context * context, int argc,
+		       sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_SetPdfOrientation(text ORIENTATION)
+/ RL2_SetMaxWmsRetries(INTEGER max)
 /
-/ return the current PDF Orientation setting (after this call)
-/ NULL on invalid arguments
+/ return the currently set Max number of WMS Retries (after this call)
+/ -1 on invalid arguments
 */
-    const char *orientation = "Portrait";
+    int max_wms_retries = 5;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
-    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
-	orientation = (const char *) sqlite3_value_text (argv[0]);
+    if (sqlite3_value_type (argv[0]) == SQLITE_INTEGER)
+	max_wms_retries = sqlite3_value_int (argv[0]);
     else
       {
-	  sqlite3_result_null (context);
+	  sqlite3_result_int (context, -1);
 	  return;
       }
 
+/* normalizing between 1 and 10 */
+    if (max_wms_retries < 1)
+	max_wms_retries = 1;
+    if (max_wms_retries > 10)
+	max_wms_retries = 10;
+
     if (priv_data != NULL)
-      {
-	  if (strcasecmp (orientation, "Landscape") == 0)
-	    {
-		priv_data->pdf_orientation = RL2_PDF_LANDSCAPE;
-		orientation = "Landscape";
-	    }
-	  else
-	    {
-		priv_data->pdf_orientation = RL2_PDF_PORTRAIT;
-		orientation = "Portrait";
-	    }
-      }
+	priv_data->max_wms_retries = max_wms_retries;
     else
-	orientation = "Portrait";
-    sqlite3_result_text (context, orientation, strlen (orientation),
-			 SQLITE_STATIC);
+	max_wms_retries = 1;
+    sqlite3_result_int (context, max_wms_retries);
 }
 
 static void
-fnct_IsAntiLabelCollisionEnabled (sqlite3_context * context, int argc,
-				  sqlite3_value ** argv)
+fnct_GetWmsPause (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_IsAntiLabelCollisionEnabled()
+/ RL2_GetWmsPause()
 /
-/ return if AntiLabelCollision is enabled or not
+/ return the currently set WMS Pause (in millis)
 */
-    int anti = 0;
+    int wms_pause = 5;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (priv_data != NULL)
-	anti = priv_data->labeling.no_colliding_labels;
-    if (anti != 0)
-	anti = 1;
-    sqlite3_result_int (context, anti);
+	wms_pause = priv_data->wms_pause;
+    sqlite3_result_int (context, wms_pause);
 }
 
 static void
-fnct_EnableAntiLabelCollision (sqlite3_context * context, int argc,
-			       sqlite3_value ** argv)
+fnct_SetWmsPause (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_EnableAntiLabelCollision(void)
+/ RL2_SetWmsPause(INTEGER millis)
 /
-/ return if AntiLabelCollision has been enabled or not
+/ return the currently set WMS Pause (after this call)
+/ -1 on invalid arguments
 */
-    int anti = 0;
+    int wms_pause = 1000;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
-
-    if (priv_data != NULL)
+    if (sqlite3_value_type (argv[0]) == SQLITE_INTEGER)
+	wms_pause = sqlite3_value_int (argv[0]);
+    else
       {
-	  priv_data->labeling.no_colliding_labels = 1;
-	  anti = priv_data->labeling.no_colliding_labels;
+	  sqlite3_result_int (context, -1);
+	  return;
       }
-    sqlite3_result_int (context, anti);
-}
 
-static void
-fnct_DisableAntiLabelCollision (sqlite3_context * context, int argc,
-				sqlite3_value ** argv)
-{
-/* SQL function:
-/ RL2_DisableAntiLabelCollision(void)
-/
-/ return zero
-*/
-    struct rl2_private_data *priv_data = sqlite3_user_data (context);
-    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+/* normalizing between 1 and 30000 */
+    if (wms_pause < 1)
+	wms_pause = 1;
+    if (wms_pause > 30000)
+	wms_pause = 30000;
 
     if (priv_data != NULL)
-	priv_data->labeling.no_colliding_labels = 0;
-    sqlite3_result_int (context, 0);
+	priv_data->wms_pause = wms_pause;
+    else
+	wms_pause = 1;
+    sqlite3_result_int (context, wms_pause);
 }
 
 static void
-fnct_IsLabelWrapTextEnabled (sqlite3_context * context, int argc,
-			     sqlite3_value ** argv)
+fnct_GetPdfMarginUOM (sqlite3_context * context, int argc,
+		      sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_IsLabelWrapTextEnabled()
+/ RL2_GetPdfMarginUOM()
 /
-/ return if LabelWrapText is enabled or not
+/ return the current Unity Of Measure for PDF empty margins
 */
-    int anti = 0;
+    const char *uom = "in";
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
     if (priv_data != NULL)
-	anti = priv_data->labeling.label_wrap_text;
-    if (anti != 0)
-	anti = 1;
-    sqlite3_result_int (context, anti);
+      {
+	  switch (priv_data->pdf_margin_uom)
+	    {
+	    case RL2_PDF_MARGIN_MILLIMS:
+		uom = "mm";
+		break;
+	    case RL2_PDF_MARGIN_INCHES:
+	    default:
+		uom = "in";
+		break;
+	    };
+      }
+    sqlite3_result_text (context, uom, strlen (uom), SQLITE_STATIC);
 }
 
 static void
-fnct_EnableLabelWrapText (sqlite3_context * context, int argc,
-			  sqlite3_value ** argv)
+fnct_SetPdfMarginUOM (sqlite3_context * context, int argc,
+		      sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_EnableLabelWrapText(void)
+/ RL2_SetPdfMarginUOM(text UOM)
 /
-/ return if LabelWrapText has been enabled or not
+/ return the current Unity Of Measure for PDF empty margins (after this call)
+/ NULL on invalid arguments
 */
-    int anti = 0;
+    const char *uom = "in";
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
+	uom = (const char *) sqlite3_value_text (argv[0]);
+    else
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
 
     if (priv_data != NULL)
       {
-	  priv_data->labeling.label_wrap_text = 1;
-	  anti = priv_data->labeling.label_wrap_text;
+	  if (strcasecmp (uom, "mm") == 0)
+	    {
+		priv_data->pdf_margin_uom = RL2_PDF_MARGIN_MILLIMS;
+		uom = "mm";
+	    }
+	  else
+	    {
+		priv_data->pdf_margin_uom = RL2_PDF_MARGIN_INCHES;
+		uom = "in";
+	    }
       }
-    sqlite3_result_int (context, anti);
+    else
+	uom = "in";
+    sqlite3_result_text (context, uom, strlen (uom), SQLITE_STATIC);
 }
 
 static void
-fnct_DisableLabelWrapText (sqlite3_context * context, int argc,
-			   sqlite3_value ** argv)
+fnct_GetPdfMarginHorz (sqlite3_context * context, int argc,
+		       sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_DisableLabelWrapText(void)
+/ RL2_GetPdfMarginHorz()
 /
-/ return zero
+/ return the currently set Horizontal PDF empty margin
 */
+    double margin = 0.5;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
-
     if (priv_data != NULL)
-	priv_data->labeling.label_wrap_text = 0;
-    sqlite3_result_int (context, 0);
+	margin = priv_data->pdf_margin_horz;
+    sqlite3_result_double (context, margin);
 }
 
 static void
-fnct_IsLabelAutorotateEnabled (sqlite3_context * context, int argc,
-			       sqlite3_value ** argv)
+fnct_SetPdfMarginHorz (sqlite3_context * context, int argc,
+		       sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_IsLabelAutorotateEnabled()
+/ RL2_SetPdfMarginHorz(double MARGIN)
 /
-/ return if LabelAutorotate is enabled or not
+/ return the currently set Horizontal PDF empty margin (after this call)
+/ -1 on invalid arguments
 */
-    int anti = 0;
+    double margin = 0.5;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
-    if (priv_data != NULL)
-	anti = priv_data->labeling.label_autorotate;
-    if (anti != 0)
-	anti = 1;
-    sqlite3_result_int (context, anti);
-}
+    if (sqlite3_value_type (argv[0]) == SQLITE_INTEGER)
+	margin = sqlite3_value_int (argv[0]);
+    else if (sqlite3_value_type (argv[0]) == SQLITE_FLOAT)
+	margin = sqlite3_value_double (argv[0]);
+    else
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
 
-static void
-fnct_EnableLabelAutorotate (sqlite3_context * context, int argc,
-			    sqlite3_value ** argv)
-{
-/* SQL function:
-/ RL2_EnableLabelAutorotate(void)
-/
-/ return if LabelAutorotate has been enabled or not
-*/
-    int anti = 0;
-    struct rl2_private_data *priv_data = sqlite3_user_data (context);
-    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+/* avoiding negative margins */
+    if (margin < 0.0)
+	margin = 0.0;
 
     if (priv_data != NULL)
-      {
-	  priv_data->labeling.label_autorotate = 1;
-	  anti = priv_data->labeling.label_autorotate;
-      }
-    sqlite3_result_int (context, anti);
+	priv_data->pdf_margin_horz = margin;
+    else
+	margin = 0.5;
+    sqlite3_result_double (context, margin);
 }
 
 static void
-fnct_DisableLabelAutorotate (sqlite3_context * context, int argc,
-			     sqlite3_value ** argv)
+fnct_GetPdfMarginVert (sqlite3_context * context, int argc,
+		       sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_DisableLabelAutorotate(void)
+/ RL2_GetPdfMarginVert()
 /
-/ return zero
+/ return the currently set Horizontal PDF empty margin
 */
+    double margin = 0.5;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
-
     if (priv_data != NULL)
-	priv_data->labeling.label_autorotate = 0;
-    sqlite3_result_int (context, 0);
+	margin = priv_data->pdf_margin_vert;
+    sqlite3_result_double (context, margin);
 }
 
 static void
-fnct_IsLabelShiftPositionEnabled (sqlite3_context * context, int argc,
-				  sqlite3_value ** argv)
+fnct_SetPdfMarginVert (sqlite3_context * context, int argc,
+		       sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_IsLabelShiftPositionEnabled()
+/ RL2_SetPdfMarginVert(double MARGIN)
 /
-/ return if LabelShiftPosition is enabled or not
+/ return the currently set Vertical PDF empty margin (after this call)
+/ -1 on invalid arguments
 */
-    int anti = 0;
+    double margin = 0.5;
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) == SQLITE_INTEGER)
+	margin = sqlite3_value_int (argv[0]);
+    else if (sqlite3_value_type (argv[0]) == SQLITE_FLOAT)
+	margin = sqlite3_value_double (argv[0]);
+    else
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+
+/* avoiding negative margins */
+    if (margin < 0.0)
+	margin = 0.0;
+
     if (priv_data != NULL)
-	anti = priv_data->labeling.label_shift_position;
-    if (anti != 0)
-	anti = 1;
-    sqlite3_result_int (context, anti);
+	priv_data->pdf_margin_vert = margin;
+    else
+	margin = 0.5;
+    sqlite3_result_double (context, margin);
 }
 
 static void
-fnct_EnableLabelShiftPosition (sqlite3_context * context, int argc,
-			       sqlite3_value ** argv)
+fnct_GetPdfPaperFormat (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_EnableLabelShiftPosition(void)
+/ RL2_GetPdfPaperFormat()
 /
-/ return if LabelShiftPosition has been enabled or not
+/ return the current PDF Paper Format
 */
-    int anti = 0;
+    const char *format = "A4";
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
-
     if (priv_data != NULL)
       {
-	  priv_data->labeling.label_shift_position = 1;
-	  anti = priv_data->labeling.label_shift_position;
+	  switch (priv_data->pdf_paper_format)
+	    {
+	    case RL2_PDF_PAPER_FORMAT_A0:
+		format = "A0";
+		break;
+	    case RL2_PDF_PAPER_FORMAT_A1:
+		format = "A1";
+		break;
+	    case RL2_PDF_PAPER_FORMAT_A2:
+		format = "A2";
+		break;
+	    case RL2_PDF_PAPER_FORMAT_A3:
+		format = "A3";
+		break;
+	    case RL2_PDF_PAPER_FORMAT_A5:
+		format = "A5";
+		break;
+	    case RL2_PDF_PAPER_FORMAT_A4:
+	    default:
+		format = "A4";
+		break;
+	    };
       }
-    sqlite3_result_int (context, anti);
+    sqlite3_result_text (context, format, strlen (format), SQLITE_STATIC);
 }
 
 static void
-fnct_DisableLabelShiftPosition (sqlite3_context * context, int argc,
-				sqlite3_value ** argv)
+fnct_SetPdfPaperFormat (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
 {
 /* SQL function:
-/ RL2_DisableLabelShiftPosition(void)
+/ RL2_SetPdfPaperFormat(text FORMAT)
 /
-/ return zero
+/ return the current PDF Page Format (after this call)
+/ NULL on invalid arguments
 */
+    const char *format = "A4";
     struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
+	format = (const char *) sqlite3_value_text (argv[0]);
+    else
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
 
     if (priv_data != NULL)
-	priv_data->labeling.label_shift_position = 0;
-    sqlite3_result_int (context, 0);
+      {
+	  if (strcasecmp (format, "A0") == 0)
+	    {
+		priv_data->pdf_paper_format = RL2_PDF_PAPER_FORMAT_A0;
+		format = "A0";
+	    }
+	  else if (strcasecmp (format, "A1") == 0)
+	    {
+		priv_data->pdf_paper_format = RL2_PDF_PAPER_FORMAT_A1;
+		format = "A1";
+	    }
+	  else if (strcasecmp (format, "A2") == 0)
+	    {
+		priv_data->pdf_paper_format = RL2_PDF_PAPER_FORMAT_A2;
+		format = "A2";
+	    }
+	  else if (strcasecmp (format, "A3") == 0)
+	    {
+		priv_data->pdf_paper_format = RL2_PDF_PAPER_FORMAT_A3;
+		format = "A3";
+	    }
+	  else if (strcasecmp (format, "A5") == 0)
+	    {
+		priv_data->pdf_paper_format = RL2_PDF_PAPER_FORMAT_A5;
+		format = "A5";
+	    }
+	  else
+	    {
+		priv_data->pdf_paper_format = RL2_PDF_PAPER_FORMAT_A4;
+		format = "A4";
+	    }
+      }
+    else
+	format = "A4";
+    sqlite3_result_text (context, format, strlen (format), SQLITE_STATIC);
 }
 
 static void
-fnct_IsValidPixel (sqlite3_context * context, int argc, sqlite3_value ** argv)
+fnct_GetPdfDPI (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
 /* SQL function:
-/ IsValidPixel(BLOBencoded pixel, text sample_type, int num_bands)
-/
-/ will return 1 (TRUE, valid) or 0 (FALSE, invalid)
-/ or -1 (INVALID ARGS)
+/ RL2_GetPdfDPI()
 /
+/ return the current PDF DPI setting
 */
-    int ret;
-    const unsigned char *blob;
-    int blob_sz;
-    const char *sample;
-    int bands;
-    unsigned char sample_type = RL2_SAMPLE_UNKNOWN;
-    unsigned char num_bands = RL2_BANDS_UNKNOWN;
-    int err = 0;
+    int dpi = 300;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
-
-    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
-	err = 1;
-    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
-	err = 1;
-    if (sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
-	err = 1;
-    if (err)
-	sqlite3_result_int (context, -1);
-    else
+    if (priv_data != NULL)
       {
-	  blob = sqlite3_value_blob (argv[0]);
-	  blob_sz = sqlite3_value_bytes (argv[0]);
-	  sample = (const char *) sqlite3_value_text (argv[1]);
-	  bands = sqlite3_value_int (argv[2]);
-	  if (strcmp (sample, "1-BIT") == 0)
-	      sample_type = RL2_SAMPLE_1_BIT;
-	  if (strcmp (sample, "2-BIT") == 0)
-	      sample_type = RL2_SAMPLE_2_BIT;
-	  if (strcmp (sample, "4-BIT") == 0)
-	      sample_type = RL2_SAMPLE_4_BIT;
-	  if (strcmp (sample, "INT8") == 0)
-	      sample_type = RL2_SAMPLE_INT8;
-	  if (strcmp (sample, "UINT8") == 0)
-	      sample_type = RL2_SAMPLE_UINT8;
-	  if (strcmp (sample, "INT16") == 0)
-	      sample_type = RL2_SAMPLE_INT16;
-	  if (strcmp (sample, "UINT16") == 0)
-	      sample_type = RL2_SAMPLE_UINT16;
-	  if (strcmp (sample, "INT32") == 0)
-	      sample_type = RL2_SAMPLE_INT32;
-	  if (strcmp (sample, "UINT32") == 0)
-	      sample_type = RL2_SAMPLE_UINT32;
-	  if (strcmp (sample, "FLOAT") == 0)
-	      sample_type = RL2_SAMPLE_FLOAT;
-	  if (strcmp (sample, "DOUBLE") == 0)
-	      sample_type = RL2_SAMPLE_DOUBLE;
-	  if (bands > 0 && bands < 256)
-	      num_bands = bands;
-	  if (sample_type == RL2_SAMPLE_UNKNOWN
-	      || num_bands == RL2_BANDS_UNKNOWN)
+	  switch (priv_data->pdf_dpi)
 	    {
-		sqlite3_result_int (context, 0);
-		return;
-	    }
-	  ret = rl2_is_valid_dbms_pixel (blob, blob_sz, sample_type, num_bands);
-	  if (ret == RL2_OK)
-	      sqlite3_result_int (context, 1);
-	  else
-	      sqlite3_result_int (context, 0);
+	    case RL2_PDF_DPI_72:
+		dpi = 72;
+		break;
+	    case RL2_PDF_DPI_150:
+		dpi = 150;
+		break;
+	    case RL2_PDF_DPI_600:
+		dpi = 600;
+		break;
+	    case RL2_PDF_DPI_300:
+	    default:
+		dpi = 300;
+		break;
+	    };
       }
+    sqlite3_result_int (context, dpi);
 }
 
 static void
-fnct_IsPixelNone (sqlite3_context * context, int argc, sqlite3_value ** argv)
+fnct_SetPdfDPI (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
 /* SQL function:
-/ IsPixelNone(BLOBencoded pixel)
-/
-/ will return 1 (TRUE, it's a NONE Pixel) or 0 (FALSE, no it's not a NONE Pixel)
-/ or -1 (INVALID ARGS)
+/ RL2_SetPdfDPI(integer DPI)
 /
+/ return the current PDF DPI setting (after this call)
+/ NULL on invalid arguments
 */
-    const unsigned char *blob;
-    int blob_sz;
-    int err = 0;
-    rl2PixelPtr pixel;
+    int dpi = 300;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
-
-    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
-	err = 1;
-    if (err)
-	sqlite3_result_int (context, -1);
+    if (sqlite3_value_type (argv[0]) == SQLITE_INTEGER)
+	dpi = sqlite3_value_int (argv[0]);
     else
       {
-	  blob = sqlite3_value_blob (argv[0]);
-	  blob_sz = sqlite3_value_bytes (argv[0]);
-	  pixel = rl2_deserialize_dbms_pixel (blob, blob_sz);
-	  if (pixel == NULL)
-	      sqlite3_result_int (context, -1);
+	  sqlite3_result_null (context);
+	  return;
+      }
+
+    if (priv_data != NULL)
+      {
+	  if (dpi == 72)
+	      priv_data->pdf_dpi = RL2_PDF_DPI_72;
+	  else if (dpi == 150)
+	      priv_data->pdf_dpi = RL2_PDF_DPI_150;
+	  else if (dpi == 600)
+	      priv_data->pdf_dpi = RL2_PDF_DPI_600;
 	  else
 	    {
-		if (rl2_is_pixel_none (pixel) == RL2_TRUE)
-		    sqlite3_result_int (context, 1);
-		else
-		    sqlite3_result_int (context, 0);
-		rl2_destroy_pixel (pixel);
+		priv_data->pdf_dpi = RL2_PDF_DPI_300;
+		dpi = 300;
 	    }
       }
+    else
+	dpi = 300;
+    sqlite3_result_int (context, dpi);
 }
 
 static void
-fnct_IsValidRasterPalette (sqlite3_context * context, int argc,
-			   sqlite3_value ** argv)
+fnct_GetPdfOrientation (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
 {
 /* SQL function:
-/ IsValidRasterPalette(BLOBencoded palette, text sample_type)
-/
-/ will return 1 (TRUE, valid) or 0 (FALSE, invalid)
-/ or -1 (INVALID ARGS)
+/ RL2_GetPdfOrientation()
 /
+/ return the current PDF Orientation setting
 */
-    int ret;
-    const unsigned char *blob;
-    int blob_sz;
-    const char *sample;
-    unsigned char sample_type = RL2_SAMPLE_UNKNOWN;
-    int err = 0;
+    const char *orientation = "Portrait";
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
-
-    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
-	err = 1;
-    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
-	err = 1;
-    if (err)
-	sqlite3_result_int (context, -1);
-    else
+    if (priv_data != NULL)
       {
-	  blob = sqlite3_value_blob (argv[0]);
-	  blob_sz = sqlite3_value_bytes (argv[0]);
-	  sample = (const char *) sqlite3_value_text (argv[1]);
-	  if (strcmp (sample, "1-BIT") == 0)
-	      sample_type = RL2_SAMPLE_1_BIT;
-	  if (strcmp (sample, "2-BIT") == 0)
-	      sample_type = RL2_SAMPLE_2_BIT;
-	  if (strcmp (sample, "4-BIT") == 0)
-	      sample_type = RL2_SAMPLE_4_BIT;
-	  if (strcmp (sample, "INT8") == 0)
-	      sample_type = RL2_SAMPLE_INT8;
-	  if (strcmp (sample, "UINT8") == 0)
-	      sample_type = RL2_SAMPLE_UINT8;
-	  if (strcmp (sample, "INT16") == 0)
-	      sample_type = RL2_SAMPLE_INT16;
-	  if (strcmp (sample, "UINT16") == 0)
-	      sample_type = RL2_SAMPLE_UINT16;
-	  if (strcmp (sample, "INT32") == 0)
-	      sample_type = RL2_SAMPLE_INT32;
-	  if (strcmp (sample, "UINT32") == 0)
-	      sample_type = RL2_SAMPLE_UINT32;
-	  if (strcmp (sample, "FLOAT") == 0)
-	      sample_type = RL2_SAMPLE_FLOAT;
-	  if (strcmp (sample, "DOUBLE") == 0)
-	      sample_type = RL2_SAMPLE_DOUBLE;
-	  if (sample_type == RL2_SAMPLE_UNKNOWN)
+	  switch (priv_data->pdf_orientation)
 	    {
-		sqlite3_result_int (context, 0);
-		return;
-	    }
-	  ret = rl2_is_valid_dbms_palette (blob, blob_sz, sample_type);
-	  if (ret == RL2_OK)
-	      sqlite3_result_int (context, 1);
-	  else
-	      sqlite3_result_int (context, 0);
+	    case RL2_PDF_LANDSCAPE:
+		orientation = "Landscape";
+		break;
+	    case RL2_PDF_PORTRAIT:
+	    default:
+		orientation = "Portrait";
+		break;
+	    };
       }
+    sqlite3_result_text (context, orientation, strlen (orientation),
+			 SQLITE_STATIC);
 }
 
 static void
-fnct_IsValidRasterStatistics (sqlite3_context * context, int argc,
-			      sqlite3_value ** argv)
+fnct_SetPdfOrientation (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
 {
 /* SQL function:
-/ IsValidRasterStatistics(text db_prefix, text covarage, 
-/                         BLOBencoded statistics)
-/   or
-/ IsValidRasterStatistics(BLOBencoded statistics, text sample_type, 
-/                         int num_bands)
-/
-/ will return 1 (TRUE, valid) or 0 (FALSE, invalid)
-/ or -1 (INVALID ARGS)
+/ RL2_SetPdfOrientation(text ORIENTATION)
 /
+/ return the current PDF Orientation setting (after this call)
+/ NULL on invalid arguments
 */
-    int ret;
-    const unsigned char *blob;
-    int blob_sz;
-    const char *db_prefix = NULL;
-    const char *coverage;
-    const char *sample;
-    int bands;
-    unsigned char sample_type = RL2_SAMPLE_UNKNOWN;
-    unsigned char num_bands = RL2_BANDS_UNKNOWN;
-    sqlite3 *sqlite;
+    const char *orientation = "Portrait";
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
+	orientation = (const char *) sqlite3_value_text (argv[0]);
+    else
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
 
-    if (sqlite3_value_type (argv[0]) == SQLITE_BLOB
-	&& sqlite3_value_type (argv[1]) == SQLITE_TEXT
-	&& sqlite3_value_type (argv[2]) == SQLITE_INTEGER)
+    if (priv_data != NULL)
       {
-	  blob = sqlite3_value_blob (argv[0]);
-	  blob_sz = sqlite3_value_bytes (argv[0]);
-	  sample = (const char *) sqlite3_value_text (argv[1]);
-	  bands = sqlite3_value_int (argv[2]);
-	  if (strcmp (sample, "1-BIT") == 0)
-	      sample_type = RL2_SAMPLE_1_BIT;
-	  if (strcmp (sample, "2-BIT") == 0)
-	      sample_type = RL2_SAMPLE_2_BIT;
-	  if (strcmp (sample, "4-BIT") == 0)
-	      sample_type = RL2_SAMPLE_4_BIT;
-	  if (strcmp (sample, "INT8") == 0)
-	      sample_type = RL2_SAMPLE_INT8;
-	  if (strcmp (sample, "UINT8") == 0)
-	      sample_type = RL2_SAMPLE_UINT8;
-	  if (strcmp (sample, "INT16") == 0)
-	      sample_type = RL2_SAMPLE_INT16;
-	  if (strcmp (sample, "UINT16") == 0)
-	      sample_type = RL2_SAMPLE_UINT16;
-	  if (strcmp (sample, "INT32") == 0)
-	      sample_type = RL2_SAMPLE_INT32;
-	  if (strcmp (sample, "UINT32") == 0)
-	      sample_type = RL2_SAMPLE_UINT32;
-	  if (strcmp (sample, "FLOAT") == 0)
-	      sample_type = RL2_SAMPLE_FLOAT;
-	  if (strcmp (sample, "DOUBLE") == 0)
-	      sample_type = RL2_SAMPLE_DOUBLE;
-	  if (bands > 0 && bands < 256)
-	      num_bands = bands;
-	  if (sample_type == RL2_SAMPLE_UNKNOWN
-	      || num_bands == RL2_BANDS_UNKNOWN)
+	  if (strcasecmp (orientation, "Landscape") == 0)
 	    {
-		sqlite3_result_int (context, 0);
-		return;
+		priv_data->pdf_orientation = RL2_PDF_LANDSCAPE;
+		orientation = "Landscape";
 	    }
-      }
-    else if ((sqlite3_value_type (argv[0]) == SQLITE_TEXT
-	      || sqlite3_value_type (argv[0]) == SQLITE_NULL)
-	     && sqlite3_value_type (argv[1]) == SQLITE_TEXT
-	     && sqlite3_value_type (argv[2]) == SQLITE_BLOB)
-      {
-	  sqlite = sqlite3_context_db_handle (context);
-	  if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
-	      db_prefix = (const char *) sqlite3_value_text (argv[0]);
-	  coverage = (const char *) sqlite3_value_text (argv[1]);
-	  blob = sqlite3_value_blob (argv[2]);
-	  blob_sz = sqlite3_value_bytes (argv[2]);
-	  if (!get_coverage_sample_bands
-	      (sqlite, db_prefix, coverage, &sample_type, &num_bands))
+	  else
 	    {
-		sqlite3_result_int (context, -1);
-		return;
+		priv_data->pdf_orientation = RL2_PDF_PORTRAIT;
+		orientation = "Portrait";
 	    }
       }
     else
-      {
-	  sqlite3_result_int (context, -1);
-	  return;
-      }
-    ret =
-	rl2_is_valid_dbms_raster_statistics (blob, blob_sz, sample_type,
-					     num_bands);
-    if (ret == RL2_OK)
-	sqlite3_result_int (context, 1);
-    else
-	sqlite3_result_int (context, 0);
+	orientation = "Portrait";
+    sqlite3_result_text (context, orientation, strlen (orientation),
+			 SQLITE_STATIC);
 }
 
 static void
-fnct_IsValidRasterTile (sqlite3_context * context, int argc,
-			sqlite3_value ** argv)
+fnct_IsAntiLabelCollisionEnabled (sqlite3_context * context, int argc,
+				  sqlite3_value ** argv)
 {
 /* SQL function:
-/ IsValidRasterTile(text db_prefix, text coverage, integer level, 
-/                   BLOBencoded tile_odd, BLOBencoded tile_even)
-/
-/ will return 1 (TRUE, valid) or 0 (FALSE, invalid)
-/ or -1 (INVALID ARGS)
+/ RL2_IsAntiLabelCollisionEnabled()
 /
+/ return if AntiLabelCollision is enabled or not
 */
-    int ret;
-    int level;
-    const unsigned char *blob_odd;
-    int blob_odd_sz;
-    const unsigned char *blob_even;
-    int blob_even_sz;
-    const char *db_prefix = NULL;
-    const char *coverage;
-    unsigned int tile_width;
-    unsigned int tile_height;
-    unsigned char sample_type = RL2_SAMPLE_UNKNOWN;
-    unsigned char pixel_type = RL2_PIXEL_UNKNOWN;
-    unsigned char num_bands = RL2_BANDS_UNKNOWN;
-    unsigned char compression = RL2_COMPRESSION_UNKNOWN;
-    sqlite3 *sqlite;
-    int err = 0;
+    int anti = 0;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (priv_data != NULL)
+	anti = priv_data->labeling.no_colliding_labels;
+    if (anti != 0)
+	anti = 1;
+    sqlite3_result_int (context, anti);
+}
 
-    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT
-	|| sqlite3_value_type (argv[0]) == SQLITE_NULL)
-	;
-    else
-	err = 1;
-    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
-	err = 1;
-    if (sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
-	err = 1;
-    if (sqlite3_value_type (argv[3]) != SQLITE_BLOB)
-	err = 1;
-    if (sqlite3_value_type (argv[4]) != SQLITE_BLOB
-	&& sqlite3_value_type (argv[4]) != SQLITE_NULL)
-	err = 1;
-    if (err)
-      {
-	  sqlite3_result_int (context, -1);
-	  return;
-      }
-    sqlite = sqlite3_context_db_handle (context);
-    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
-	db_prefix = (const char *) sqlite3_value_text (argv[0]);
-    coverage = (const char *) sqlite3_value_text (argv[1]);
-    level = sqlite3_value_int (argv[2]);
-    blob_odd = sqlite3_value_blob (argv[3]);
-    blob_odd_sz = sqlite3_value_bytes (argv[3]);
-    if (sqlite3_value_type (argv[4]) == SQLITE_NULL)
-      {
-	  blob_even = NULL;
-	  blob_even_sz = 0;
-      }
-    else
-      {
-	  blob_even = sqlite3_value_blob (argv[4]);
-	  blob_even_sz = sqlite3_value_bytes (argv[4]);
-      }
+static void
+fnct_EnableAntiLabelCollision (sqlite3_context * context, int argc,
+			       sqlite3_value ** argv)
+{
+/* SQL function:
+/ RL2_EnableAntiLabelCollision(void)
+/
+/ return if AntiLabelCollision has been enabled or not
+*/
+    int anti = 0;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
 
-    if (!get_coverage_defs
-	(sqlite, db_prefix, coverage, &tile_width, &tile_height, &sample_type,
-	 &pixel_type, &num_bands, &compression))
+    if (priv_data != NULL)
       {
-	  sqlite3_result_int (context, -1);
-	  return;
+	  priv_data->labeling.no_colliding_labels = 1;
+	  anti = priv_data->labeling.no_colliding_labels;
       }
-    ret =
-	rl2_is_valid_dbms_raster_tile (level, tile_width, tile_height,
-				       blob_odd, blob_odd_sz, blob_even,
-				       blob_even_sz, sample_type, pixel_type,
-				       num_bands, compression);
-    if (ret == RL2_OK)
-	sqlite3_result_int (context, 1);
-    else
-	sqlite3_result_int (context, 0);
+    sqlite3_result_int (context, anti);
 }
 
 static void
-fnct_GetPaletteNumEntries (sqlite3_context * context, int argc,
-			   sqlite3_value ** argv)
+fnct_DisableAntiLabelCollision (sqlite3_context * context, int argc,
+				sqlite3_value ** argv)
 {
 /* SQL function:
-/ GetPaletteNumEntries(BLOB pixel_obj)
+/ RL2_DisableAntiLabelCollision(void)
 /
-/ will return the number of Color Entries
-/ or NULL on failure
+/ return zero
 */
-    const unsigned char *blob = NULL;
-    int blob_sz = 0;
-    rl2PalettePtr plt = NULL;
-    rl2PrivPalettePtr palette;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
 
-    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
-	goto error;
+    if (priv_data != NULL)
+	priv_data->labeling.no_colliding_labels = 0;
+    sqlite3_result_int (context, 0);
+}
 
-    blob = sqlite3_value_blob (argv[0]);
-    blob_sz = sqlite3_value_bytes (argv[0]);
-    plt = rl2_deserialize_dbms_palette (blob, blob_sz);
-    if (plt == NULL)
-	goto error;
-    palette = (rl2PrivPalettePtr) plt;
-    sqlite3_result_int (context, palette->nEntries);
-    rl2_destroy_palette (plt);
-    return;
-
-  error:
-    sqlite3_result_null (context);
-    if (plt != NULL)
-	rl2_destroy_palette (plt);
+static void
+fnct_IsLabelWrapTextEnabled (sqlite3_context * context, int argc,
+			     sqlite3_value ** argv)
+{
+/* SQL function:
+/ RL2_IsLabelWrapTextEnabled()
+/
+/ return if LabelWrapText is enabled or not
+*/
+    int anti = 0;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (priv_data != NULL)
+	anti = priv_data->labeling.label_wrap_text;
+    if (anti != 0)
+	anti = 1;
+    sqlite3_result_int (context, anti);
 }
 
 static void
-fnct_GetPaletteColorEntry (sqlite3_context * context, int argc,
-			   sqlite3_value ** argv)
+fnct_EnableLabelWrapText (sqlite3_context * context, int argc,
+			  sqlite3_value ** argv)
 {
 /* SQL function:
-/ GetPaletteColorEntry(BLOB pixel_obj, INT index)
+/ RL2_EnableLabelWrapText(void)
 /
-/ will return the corresponding Color entry
-/ or NULL on failure
+/ return if LabelWrapText has been enabled or not
 */
-    const unsigned char *blob = NULL;
-    int blob_sz = 0;
-    rl2PalettePtr plt = NULL;
-    rl2PrivPalettePtr palette;
-    rl2PrivPaletteEntryPtr entry;
-    int entry_id;
-    char color[16];
+    int anti = 0;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
 
-    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
-	goto error;
-    if (sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
-	goto error;
-
-    blob = sqlite3_value_blob (argv[0]);
-    blob_sz = sqlite3_value_bytes (argv[0]);
-    entry_id = sqlite3_value_int (argv[1]);
-    plt = rl2_deserialize_dbms_palette (blob, blob_sz);
-    if (plt == NULL)
-	goto error;
-    palette = (rl2PrivPalettePtr) plt;
-    if (entry_id >= 0 && entry_id < palette->nEntries)
-	;
-    else
-	goto error;
-    entry = palette->entries + entry_id;
-    sprintf (color, "#%02x%02x%02x", entry->red, entry->green, entry->blue);
-    sqlite3_result_text (context, color, strlen (color), SQLITE_TRANSIENT);
-    rl2_destroy_palette (plt);
-    return;
-
-  error:
-    sqlite3_result_null (context);
-    if (plt != NULL)
-	rl2_destroy_palette (plt);
+    if (priv_data != NULL)
+      {
+	  priv_data->labeling.label_wrap_text = 1;
+	  anti = priv_data->labeling.label_wrap_text;
+      }
+    sqlite3_result_int (context, anti);
 }
 
 static void
-fnct_SetPaletteColorEntry (sqlite3_context * context, int argc,
+fnct_DisableLabelWrapText (sqlite3_context * context, int argc,
 			   sqlite3_value ** argv)
 {
 /* SQL function:
-/ SetPaletteColorEntry(BLOB pixel_obj, INT index, TEXT color)
+/ RL2_DisableLabelWrapText(void)
 /
-/ will return a new palette including the changed color
-/ or NULL on failure
+/ return zero
 */
-    const unsigned char *blob = NULL;
-    unsigned char *blb;
-    int blob_sz = 0;
-    rl2PalettePtr plt = NULL;
-    rl2PrivPalettePtr palette;
-    rl2PrivPaletteEntryPtr entry;
-    int entry_id;
-    const char *color;
-    unsigned char red;
-    unsigned char green;
-    unsigned char blue;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
 
-    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
-	goto error;
-    if (sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
-	goto error;
-    if (sqlite3_value_type (argv[2]) != SQLITE_TEXT)
-	goto error;
-
-    blob = sqlite3_value_blob (argv[0]);
-    blob_sz = sqlite3_value_bytes (argv[0]);
-    entry_id = sqlite3_value_int (argv[1]);
-    color = (const char *) sqlite3_value_text (argv[2]);
-/* parsing the background color */
-    if (rl2_parse_hexrgb (color, &red, &green, &blue) != RL2_OK)
-	goto error;
-    plt = rl2_deserialize_dbms_palette (blob, blob_sz);
-    if (plt == NULL)
-	goto error;
-    palette = (rl2PrivPalettePtr) plt;
-    if (entry_id >= 0 && entry_id < palette->nEntries)
-	;
-    else
-	goto error;
-    entry = palette->entries + entry_id;
-    entry->red = red;
-    entry->green = green;
-    entry->blue = blue;
-    rl2_serialize_dbms_palette (plt, &blb, &blob_sz);
-    sqlite3_result_blob (context, blb, blob_sz, free);
-    rl2_destroy_palette (plt);
-    return;
-
-  error:
-    sqlite3_result_null (context);
-    if (plt != NULL)
-	rl2_destroy_palette (plt);
+    if (priv_data != NULL)
+	priv_data->labeling.label_wrap_text = 0;
+    sqlite3_result_int (context, 0);
 }
 
 static void
-fnct_PaletteEquals (sqlite3_context * context, int argc, sqlite3_value ** argv)
+fnct_IsLabelAutorotateEnabled (sqlite3_context * context, int argc,
+			       sqlite3_value ** argv)
 {
 /* SQL function:
-/ PaletteEquals(BLOB palette_obj1, BLOB palette_obj2)
+/ RL2_IsLabelAutorotateEnabled()
 /
-/ 1 (TRUE) or 0 (FALSE)
-/ or -1 on invalid argument
+/ return if LabelAutorotate is enabled or not
 */
-    const unsigned char *blob = NULL;
-    int blob_sz = 0;
-    rl2PalettePtr plt1 = NULL;
-    rl2PalettePtr plt2 = NULL;
-    int ret;
+    int anti = 0;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (priv_data != NULL)
+	anti = priv_data->labeling.label_autorotate;
+    if (anti != 0)
+	anti = 1;
+    sqlite3_result_int (context, anti);
+}
 
-    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
-	goto error;
-    if (sqlite3_value_type (argv[1]) != SQLITE_BLOB)
-	goto error;
-
-    blob = sqlite3_value_blob (argv[0]);
-    blob_sz = sqlite3_value_bytes (argv[0]);
-    plt1 = rl2_deserialize_dbms_palette (blob, blob_sz);
-    if (plt1 == NULL)
-	goto error;
-    blob = sqlite3_value_blob (argv[1]);
-    blob_sz = sqlite3_value_bytes (argv[1]);
-    plt2 = rl2_deserialize_dbms_palette (blob, blob_sz);
-    if (plt2 == NULL)
-	goto error;
-    ret = rl2_compare_palettes (plt1, plt2);
-    if (ret == RL2_TRUE)
-	sqlite3_result_int (context, 1);
-    else
-	sqlite3_result_int (context, 0);
-    rl2_destroy_palette (plt1);
-    rl2_destroy_palette (plt2);
-    return;
+static void
+fnct_EnableLabelAutorotate (sqlite3_context * context, int argc,
+			    sqlite3_value ** argv)
+{
+/* SQL function:
+/ RL2_EnableLabelAutorotate(void)
+/
+/ return if LabelAutorotate has been enabled or not
+*/
+    int anti = 0;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
 
-  error:
-    sqlite3_result_int (context, -1);
-    if (plt1 != NULL)
-	rl2_destroy_palette (plt1);
-    if (plt2 != NULL)
-	rl2_destroy_palette (plt2);
+    if (priv_data != NULL)
+      {
+	  priv_data->labeling.label_autorotate = 1;
+	  anti = priv_data->labeling.label_autorotate;
+      }
+    sqlite3_result_int (context, anti);
 }
 
 static void
-fnct_CreatePixel (sqlite3_context * context, int argc, sqlite3_value ** argv)
+fnct_DisableLabelAutorotate (sqlite3_context * context, int argc,
+			     sqlite3_value ** argv)
 {
 /* SQL function:
-/ CreatePixel(text sample_type, text pixel_type, int num_bands)
+/ RL2_DisableLabelAutorotate(void)
 /
-/ will return a serialized binary Pixel Object 
-/ or NULL on failure
+/ return zero
 */
-    int err = 0;
-    const char *sample_type;
-    const char *pixel_type;
-    int num_bands;
-    unsigned char sample;
-    unsigned char pixel;
-    rl2PixelPtr pxl = NULL;
-    unsigned char *blob = NULL;
-    int blob_sz = 0;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
 
-    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
-	err = 1;
-    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
-	err = 1;
-    if (sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
-	err = 1;
-    if (err)
-	goto error;
+    if (priv_data != NULL)
+	priv_data->labeling.label_autorotate = 0;
+    sqlite3_result_int (context, 0);
+}
 
-/* retrieving the arguments */
-    sample_type = (const char *) sqlite3_value_text (argv[0]);
-    pixel_type = (const char *) sqlite3_value_text (argv[1]);
-    num_bands = sqlite3_value_int (argv[2]);
+static void
+fnct_IsLabelShiftPositionEnabled (sqlite3_context * context, int argc,
+				  sqlite3_value ** argv)
+{
+/* SQL function:
+/ RL2_IsLabelShiftPositionEnabled()
+/
+/ return if LabelShiftPosition is enabled or not
+*/
+    int anti = 0;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (priv_data != NULL)
+	anti = priv_data->labeling.label_shift_position;
+    if (anti != 0)
+	anti = 1;
+    sqlite3_result_int (context, anti);
+}
 
-/* preliminary arg checking */
+static void
+fnct_EnableLabelShiftPosition (sqlite3_context * context, int argc,
+			       sqlite3_value ** argv)
+{
+/* SQL function:
+/ RL2_EnableLabelShiftPosition(void)
+/
+/ return if LabelShiftPosition has been enabled or not
+*/
+    int anti = 0;
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (priv_data != NULL)
+      {
+	  priv_data->labeling.label_shift_position = 1;
+	  anti = priv_data->labeling.label_shift_position;
+      }
+    sqlite3_result_int (context, anti);
+}
+
+static void
+fnct_DisableLabelShiftPosition (sqlite3_context * context, int argc,
+				sqlite3_value ** argv)
+{
+/* SQL function:
+/ RL2_DisableLabelShiftPosition(void)
+/
+/ return zero
+*/
+    struct rl2_private_data *priv_data = sqlite3_user_data (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (priv_data != NULL)
+	priv_data->labeling.label_shift_position = 0;
+    sqlite3_result_int (context, 0);
+}
+
+static void
+fnct_IsValidPixel (sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+/* SQL function:
+/ IsValidPixel(BLOBencoded pixel, text sample_type, int num_bands)
+/
+/ will return 1 (TRUE, valid) or 0 (FALSE, invalid)
+/ or -1 (INVALID ARGS)
+/
+*/
+    int ret;
+    const unsigned char *blob;
+    int blob_sz;
+    const char *sample;
+    int bands;
+    unsigned char sample_type = RL2_SAMPLE_UNKNOWN;
+    unsigned char num_bands = RL2_BANDS_UNKNOWN;
+    int err = 0;
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
+	err = 1;
+    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+	err = 1;
+    if (sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
+	err = 1;
+    if (err)
+	sqlite3_result_int (context, -1);
+    else
+      {
+	  blob = sqlite3_value_blob (argv[0]);
+	  blob_sz = sqlite3_value_bytes (argv[0]);
+	  sample = (const char *) sqlite3_value_text (argv[1]);
+	  bands = sqlite3_value_int (argv[2]);
+	  if (strcmp (sample, "1-BIT") == 0)
+	      sample_type = RL2_SAMPLE_1_BIT;
+	  if (strcmp (sample, "2-BIT") == 0)
+	      sample_type = RL2_SAMPLE_2_BIT;
+	  if (strcmp (sample, "4-BIT") == 0)
+	      sample_type = RL2_SAMPLE_4_BIT;
+	  if (strcmp (sample, "INT8") == 0)
+	      sample_type = RL2_SAMPLE_INT8;
+	  if (strcmp (sample, "UINT8") == 0)
+	      sample_type = RL2_SAMPLE_UINT8;
+	  if (strcmp (sample, "INT16") == 0)
+	      sample_type = RL2_SAMPLE_INT16;
+	  if (strcmp (sample, "UINT16") == 0)
+	      sample_type = RL2_SAMPLE_UINT16;
+	  if (strcmp (sample, "INT32") == 0)
+	      sample_type = RL2_SAMPLE_INT32;
+	  if (strcmp (sample, "UINT32") == 0)
+	      sample_type = RL2_SAMPLE_UINT32;
+	  if (strcmp (sample, "FLOAT") == 0)
+	      sample_type = RL2_SAMPLE_FLOAT;
+	  if (strcmp (sample, "DOUBLE") == 0)
+	      sample_type = RL2_SAMPLE_DOUBLE;
+	  if (bands > 0 && bands < 256)
+	      num_bands = bands;
+	  if (sample_type == RL2_SAMPLE_UNKNOWN
+	      || num_bands == RL2_BANDS_UNKNOWN)
+	    {
+		sqlite3_result_int (context, 0);
+		return;
+	    }
+	  ret = rl2_is_valid_dbms_pixel (blob, blob_sz, sample_type, num_bands);
+	  if (ret == RL2_OK)
+	      sqlite3_result_int (context, 1);
+	  else
+	      sqlite3_result_int (context, 0);
+      }
+}
+
+static void
+fnct_IsPixelNone (sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+/* SQL function:
+/ IsPixelNone(BLOBencoded pixel)
+/
+/ will return 1 (TRUE, it's a NONE Pixel) or 0 (FALSE, no it's not a NONE Pixel)
+/ or -1 (INVALID ARGS)
+/
+*/
+    const unsigned char *blob;
+    int blob_sz;
+    int err = 0;
+    rl2PixelPtr pixel;
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
+	err = 1;
+    if (err)
+	sqlite3_result_int (context, -1);
+    else
+      {
+	  blob = sqlite3_value_blob (argv[0]);
+	  blob_sz = sqlite3_value_bytes (argv[0]);
+	  pixel = rl2_deserialize_dbms_pixel (blob, blob_sz);
+	  if (pixel == NULL)
+	      sqlite3_result_int (context, -1);
+	  else
+	    {
+		if (rl2_is_pixel_none (pixel) == RL2_TRUE)
+		    sqlite3_result_int (context, 1);
+		else
+		    sqlite3_result_int (context, 0);
+		rl2_destroy_pixel (pixel);
+	    }
+      }
+}
+
+static void
+fnct_IsValidRasterPalette (sqlite3_context * context, int argc,
+			   sqlite3_value ** argv)
+{
+/* SQL function:
+/ IsValidRasterPalette(BLOBencoded palette, text sample_type)
+/
+/ will return 1 (TRUE, valid) or 0 (FALSE, invalid)
+/ or -1 (INVALID ARGS)
+/
+*/
+    int ret;
+    const unsigned char *blob;
+    int blob_sz;
+    const char *sample;
+    unsigned char sample_type = RL2_SAMPLE_UNKNOWN;
+    int err = 0;
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
+	err = 1;
+    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+	err = 1;
+    if (err)
+	sqlite3_result_int (context, -1);
+    else
+      {
+	  blob = sqlite3_value_blob (argv[0]);
+	  blob_sz = sqlite3_value_bytes (argv[0]);
+	  sample = (const char *) sqlite3_value_text (argv[1]);
+	  if (strcmp (sample, "1-BIT") == 0)
+	      sample_type = RL2_SAMPLE_1_BIT;
+	  if (strcmp (sample, "2-BIT") == 0)
+	      sample_type = RL2_SAMPLE_2_BIT;
+	  if (strcmp (sample, "4-BIT") == 0)
+	      sample_type = RL2_SAMPLE_4_BIT;
+	  if (strcmp (sample, "INT8") == 0)
+	      sample_type = RL2_SAMPLE_INT8;
+	  if (strcmp (sample, "UINT8") == 0)
+	      sample_type = RL2_SAMPLE_UINT8;
+	  if (strcmp (sample, "INT16") == 0)
+	      sample_type = RL2_SAMPLE_INT16;
+	  if (strcmp (sample, "UINT16") == 0)
+	      sample_type = RL2_SAMPLE_UINT16;
+	  if (strcmp (sample, "INT32") == 0)
+	      sample_type = RL2_SAMPLE_INT32;
+	  if (strcmp (sample, "UINT32") == 0)
+	      sample_type = RL2_SAMPLE_UINT32;
+	  if (strcmp (sample, "FLOAT") == 0)
+	      sample_type = RL2_SAMPLE_FLOAT;
+	  if (strcmp (sample, "DOUBLE") == 0)
+	      sample_type = RL2_SAMPLE_DOUBLE;
+	  if (sample_type == RL2_SAMPLE_UNKNOWN)
+	    {
+		sqlite3_result_int (context, 0);
+		return;
+	    }
+	  ret = rl2_is_valid_dbms_palette (blob, blob_sz, sample_type);
+	  if (ret == RL2_OK)
+	      sqlite3_result_int (context, 1);
+	  else
+	      sqlite3_result_int (context, 0);
+      }
+}
+
+static void
+fnct_IsValidRasterStatistics (sqlite3_context * context, int argc,
+			      sqlite3_value ** argv)
+{
+/* SQL function:
+/ IsValidRasterStatistics(text db_prefix, text covarage, 
+/                         BLOBencoded statistics)
+/   or
+/ IsValidRasterStatistics(BLOBencoded statistics, text sample_type, 
+/                         int num_bands)
+/
+/ will return 1 (TRUE, valid) or 0 (FALSE, invalid)
+/ or -1 (INVALID ARGS)
+/
+*/
+    int ret;
+    const unsigned char *blob;
+    int blob_sz;
+    const char *db_prefix = NULL;
+    const char *coverage;
+    const char *sample;
+    int bands;
+    unsigned char sample_type = RL2_SAMPLE_UNKNOWN;
+    unsigned char num_bands = RL2_BANDS_UNKNOWN;
+    sqlite3 *sqlite;
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (sqlite3_value_type (argv[0]) == SQLITE_BLOB
+	&& sqlite3_value_type (argv[1]) == SQLITE_TEXT
+	&& sqlite3_value_type (argv[2]) == SQLITE_INTEGER)
+      {
+	  blob = sqlite3_value_blob (argv[0]);
+	  blob_sz = sqlite3_value_bytes (argv[0]);
+	  sample = (const char *) sqlite3_value_text (argv[1]);
+	  bands = sqlite3_value_int (argv[2]);
+	  if (strcmp (sample, "1-BIT") == 0)
+	      sample_type = RL2_SAMPLE_1_BIT;
+	  if (strcmp (sample, "2-BIT") == 0)
+	      sample_type = RL2_SAMPLE_2_BIT;
+	  if (strcmp (sample, "4-BIT") == 0)
+	      sample_type = RL2_SAMPLE_4_BIT;
+	  if (strcmp (sample, "INT8") == 0)
+	      sample_type = RL2_SAMPLE_INT8;
+	  if (strcmp (sample, "UINT8") == 0)
+	      sample_type = RL2_SAMPLE_UINT8;
+	  if (strcmp (sample, "INT16") == 0)
+	      sample_type = RL2_SAMPLE_INT16;
+	  if (strcmp (sample, "UINT16") == 0)
+	      sample_type = RL2_SAMPLE_UINT16;
+	  if (strcmp (sample, "INT32") == 0)
+	      sample_type = RL2_SAMPLE_INT32;
+	  if (strcmp (sample, "UINT32") == 0)
+	      sample_type = RL2_SAMPLE_UINT32;
+	  if (strcmp (sample, "FLOAT") == 0)
+	      sample_type = RL2_SAMPLE_FLOAT;
+	  if (strcmp (sample, "DOUBLE") == 0)
+	      sample_type = RL2_SAMPLE_DOUBLE;
+	  if (bands > 0 && bands < 256)
+	      num_bands = bands;
+	  if (sample_type == RL2_SAMPLE_UNKNOWN
+	      || num_bands == RL2_BANDS_UNKNOWN)
+	    {
+		sqlite3_result_int (context, 0);
+		return;
+	    }
+      }
+    else if ((sqlite3_value_type (argv[0]) == SQLITE_TEXT
+	      || sqlite3_value_type (argv[0]) == SQLITE_NULL)
+	     && sqlite3_value_type (argv[1]) == SQLITE_TEXT
+	     && sqlite3_value_type (argv[2]) == SQLITE_BLOB)
+      {
+	  sqlite = sqlite3_context_db_handle (context);
+	  if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
+	      db_prefix = (const char *) sqlite3_value_text (argv[0]);
+	  coverage = (const char *) sqlite3_value_text (argv[1]);
+	  blob = sqlite3_value_blob (argv[2]);
+	  blob_sz = sqlite3_value_bytes (argv[2]);
+	  if (!get_coverage_sample_bands
+	      (sqlite, db_prefix, coverage, &sample_type, &num_bands))
+	    {
+		sqlite3_result_int (context, -1);
+		return;
+	    }
+      }
+    else
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    ret =
+	rl2_is_valid_dbms_raster_statistics (blob, blob_sz, sample_type,
+					     num_bands);
+    if (ret == RL2_OK)
+	sqlite3_result_int (context, 1);
+    else
+	sqlite3_result_int (context, 0);
+}
+
+static void
+fnct_TileHash (sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+/* SQL function:
+/ TileHash(BLOBencoded tile_odd, BLOBencoded tile_even)
+/ TileHash(text db_prefix, text coverage, BLOBencoded tile_odd,
+/          BLOBencoded tile_even)
+/
+/ will return the content hash identifying a Raster Tile
+/ into a deduplicated Coverage
+/ when db_prefix and coverage are specified the payloads already
+/ stored by the Coverage will be checked as well, so to return a
+/ distinct key in the case of hash collisions
+/ or NULL (INVALID ARGS)
+/
+*/
+    const char *db_prefix = NULL;
+    const char *coverage = NULL;
+    const unsigned char *blob_odd;
+    int blob_odd_sz;
+    const unsigned char *blob_even = NULL;
+    int blob_even_sz = 0;
+    int i_odd = 0;
+    char *hash;
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (argc == 4)
+      {
+	  if (sqlite3_value_type (argv[0]) != SQLITE_TEXT
+	      && sqlite3_value_type (argv[0]) != SQLITE_NULL)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
+	      db_prefix = (const char *) sqlite3_value_text (argv[0]);
+	  coverage = (const char *) sqlite3_value_text (argv[1]);
+	  i_odd = 2;
+      }
+    if (sqlite3_value_type (argv[i_odd]) != SQLITE_BLOB)
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
+    if (sqlite3_value_type (argv[i_odd + 1]) != SQLITE_BLOB
+	&& sqlite3_value_type (argv[i_odd + 1]) != SQLITE_NULL)
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
+    blob_odd = sqlite3_value_blob (argv[i_odd]);
+    blob_odd_sz = sqlite3_value_bytes (argv[i_odd]);
+    if (sqlite3_value_type (argv[i_odd + 1]) == SQLITE_BLOB)
+      {
+	  blob_even = sqlite3_value_blob (argv[i_odd + 1]);
+	  blob_even_sz = sqlite3_value_bytes (argv[i_odd + 1]);
+      }
+    if (coverage != NULL)
+	hash =
+	    rl2_resolve_tile_hash (sqlite3_context_db_handle (context),
+				   db_prefix, coverage, blob_odd, blob_odd_sz,
+				   blob_even, blob_even_sz);
+    else
+	hash = rl2_tile_content_hash (blob_odd, blob_odd_sz, blob_even,
+				      blob_even_sz);
+    if (hash == NULL)
+	sqlite3_result_null (context);
+    else
+	sqlite3_result_text (context, hash, strlen (hash), sqlite3_free);
+}
+
+static void
+fnct_IsValidRasterTile (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
+{
+/* SQL function:
+/ IsValidRasterTile(text db_prefix, text coverage, integer level, 
+/                   BLOBencoded tile_odd, BLOBencoded tile_even)
+/
+/ will return 1 (TRUE, valid) or 0 (FALSE, invalid)
+/ or -1 (INVALID ARGS)
+/
+*/
+    int ret;
+    int level;
+    const unsigned char *blob_odd;
+    int blob_odd_sz;
+    const unsigned char *blob_even;
+    int blob_even_sz;
+    const char *db_prefix = NULL;
+    const char *coverage;
+    unsigned int tile_width;
+    unsigned int tile_height;
+    unsigned char sample_type = RL2_SAMPLE_UNKNOWN;
+    unsigned char pixel_type = RL2_PIXEL_UNKNOWN;
+    unsigned char num_bands = RL2_BANDS_UNKNOWN;
+    unsigned char compression = RL2_COMPRESSION_UNKNOWN;
+    sqlite3 *sqlite;
+    int err = 0;
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT
+	|| sqlite3_value_type (argv[0]) == SQLITE_NULL)
+	;
+    else
+	err = 1;
+    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+	err = 1;
+    if (sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
+	err = 1;
+    if (sqlite3_value_type (argv[3]) != SQLITE_BLOB)
+	err = 1;
+    if (sqlite3_value_type (argv[4]) != SQLITE_BLOB
+	&& sqlite3_value_type (argv[4]) != SQLITE_NULL)
+	err = 1;
+    if (err)
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    sqlite = sqlite3_context_db_handle (context);
+    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
+	db_prefix = (const char *) sqlite3_value_text (argv[0]);
+    coverage = (const char *) sqlite3_value_text (argv[1]);
+    level = sqlite3_value_int (argv[2]);
+    blob_odd = sqlite3_value_blob (argv[3]);
+    blob_odd_sz = sqlite3_value_bytes (argv[3]);
+    if (sqlite3_value_type (argv[4]) == SQLITE_NULL)
+      {
+	  blob_even = NULL;
+	  blob_even_sz = 0;
+      }
+    else
+      {
+	  blob_even = sqlite3_value_blob (argv[4]);
+	  blob_even_sz = sqlite3_value_bytes (argv[4]);
+      }
+
+    if (!get_coverage_defs
+	(sqlite, db_prefix, coverage, &tile_width, &tile_height, &sample_type,
+	 &pixel_type, &num_bands, &compression))
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    ret =
+	rl2_is_valid_dbms_raster_tile (level, tile_width, tile_height,
+				       blob_odd, blob_odd_sz, blob_even,
+				       blob_even_sz, sample_type, pixel_type,
+				       num_bands, compression);
+    if (ret == RL2_OK)
+	sqlite3_result_int (context, 1);
+    else
+	sqlite3_result_int (context, 0);
+}
+
+static void
+fnct_GetPaletteNumEntries (sqlite3_context * context, int argc,
+			   sqlite3_value ** argv)
+{
+/* SQL function:
+/ GetPaletteNumEntries(BLOB pixel_obj)
+/
+/ will return the number of Color Entries
+/ or NULL on failure
+*/
+    const unsigned char *blob = NULL;
+    int blob_sz = 0;
+    rl2PalettePtr plt = NULL;
+    rl2PrivPalettePtr palette;
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
+	goto error;
+
+    blob = sqlite3_value_blob (argv[0]);
+    blob_sz = sqlite3_value_bytes (argv[0]);
+    plt = rl2_deserialize_dbms_palette (blob, blob_sz);
+    if (plt == NULL)
+	goto error;
+    palette = (rl2PrivPalettePtr) plt;
+    sqlite3_result_int (context, palette->nEntries);
+    rl2_destroy_palette (plt);
+    return;
+
+  error:
+    sqlite3_result_null (context);
+    if (plt != NULL)
+	rl2_destroy_palette (plt);
+}
+
+static void
+fnct_GetPaletteColorEntry (sqlite3_context * context, int argc,
+			   sqlite3_value ** argv)
+{
+/* SQL function:
+/ GetPaletteColorEntry(BLOB pixel_obj, INT index)
+/
+/ will return the corresponding Color entry
+/ or NULL on failure
+*/
+    const unsigned char *blob = NULL;
+    int blob_sz = 0;
+    rl2PalettePtr plt = NULL;
+    rl2PrivPalettePtr palette;
+    rl2PrivPaletteEntryPtr entry;
+    int entry_id;
+    char color[16];
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
+	goto error;
+    if (sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
+	goto error;
+
+    blob = sqlite3_value_blob (argv[0]);
+    blob_sz = sqlite3_value_bytes (argv[0]);
+    entry_id = sqlite3_value_int (argv[1]);
+    plt = rl2_deserialize_dbms_palette (blob, blob_sz);
+    if (plt == NULL)
+	goto error;
+    palette = (rl2PrivPalettePtr) plt;
+    if (entry_id >= 0 && entry_id < palette->nEntries)
+	;
+    else
+	goto error;
+    entry = palette->entries + entry_id;
+    sprintf (color, "#%02x%02x%02x", entry->red, entry->green, entry->blue);
+    sqlite3_result_text (context, color, strlen (color), SQLITE_TRANSIENT);
+    rl2_destroy_palette (plt);
+    return;
+
+  error:
+    sqlite3_result_null (context);
+    if (plt != NULL)
+	rl2_destroy_palette (plt);
+}
+
+static void
+fnct_SetPaletteColorEntry (sqlite3_context * context, int argc,
+			   sqlite3_value ** argv)
+{
+/* SQL function:
+/ SetPaletteColorEntry(BLOB pixel_obj, INT index, TEXT color)
+/
+/ will return a new palette including the changed color
+/ or NULL on failure
+*/
+    const unsigned char *blob = NULL;
+    unsigned char *blb;
+    int blob_sz = 0;
+    rl2PalettePtr plt = NULL;
+    rl2PrivPalettePtr palette;
+    rl2PrivPaletteEntryPtr entry;
+    int entry_id;
+    const char *color;
+    unsigned char red;
+    unsigned char green;
+    unsigned char blue;
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
+	goto error;
+    if (sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
+	goto error;
+    if (sqlite3_value_type (argv[2]) != SQLITE_TEXT)
+	goto error;
+
+    blob = sqlite3_value_blob (argv[0]);
+    blob_sz = sqlite3_value_bytes (argv[0]);
+    entry_id = sqlite3_value_int (argv[1]);
+    color = (const char *) sqlite3_value_text (argv[2]);
+/* parsing the background color */
+    if (rl2_parse_hexrgb (color, &red, &green, &blue) != RL2_OK)
+	goto error;
+    plt = rl2_deserialize_dbms_palette (blob, blob_sz);
+    if (plt == NULL)
+	goto error;
+    palette = (rl2PrivPalettePtr) plt;
+    if (entry_id >= 0 && entry_id < palette->nEntries)
+	;
+    else
+	goto error;
+    entry = palette->entries + entry_id;
+    entry->red = red;
+    entry->green = green;
+    entry->blue = blue;
+    rl2_serialize_dbms_palette (plt, &blb, &blob_sz);
+    sqlite3_result_blob (context, blb, blob_sz, free);
+    rl2_destroy_palette (plt);
+    return;
+
+  error:
+    sqlite3_result_null (context);
+    if (plt != NULL)
+	rl2_destroy_palette (plt);
+}
+
+static void
+fnct_PaletteEquals (sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+/* SQL function:
+/ PaletteEquals(BLOB palette_obj1, BLOB palette_obj2)
+/
+/ 1 (TRUE) or 0 (FALSE)
+/ or -1 on invalid argument
+*/
+    const unsigned char *blob = NULL;
+    int blob_sz = 0;
+    rl2PalettePtr plt1 = NULL;
+    rl2PalettePtr plt2 = NULL;
+    int ret;
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
+	goto error;
+    if (sqlite3_value_type (argv[1]) != SQLITE_BLOB)
+	goto error;
+
+    blob = sqlite3_value_blob (argv[0]);
+    blob_sz = sqlite3_value_bytes (argv[0]);
+    plt1 = rl2_deserialize_dbms_palette (blob, blob_sz);
+    if (plt1 == NULL)
+	goto error;
+    blob = sqlite3_value_blob (argv[1]);
+    blob_sz = sqlite3_value_bytes (argv[1]);
+    plt2 = rl2_deserialize_dbms_palette (blob, blob_sz);
+    if (plt2 == NULL)
+	goto error;
+    ret = rl2_compare_palettes (plt1, plt2);
+    if (ret == RL2_TRUE)
+	sqlite3_result_int (context, 1);
+    else
+	sqlite3_result_int (context, 0);
+    rl2_destroy_palette (plt1);
+    rl2_destroy_palette (plt2);
+    return;
+
+  error:
+    sqlite3_result_int (context, -1);
+    if (plt1 != NULL)
+	rl2_destroy_palette (plt1);
+    if (plt2 != NULL)
+	rl2_destroy_palette (plt2);
+}
+
+static void
+fnct_CreatePixel (sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+/* SQL function:
+/ CreatePixel(text sample_type, text pixel_type, int num_bands)
+/
+/ will return a serialized binary Pixel Object 
+/ or NULL on failure
+*/
+    int err = 0;
+    const char *sample_type;
+    const char *pixel_type;
+    int num_bands;
+    unsigned char sample;
+    unsigned char pixel;
+    rl2PixelPtr pxl = NULL;
+    unsigned char *blob = NULL;
+    int blob_sz = 0;
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+	err = 1;
+    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+	err = 1;
+    if (sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
+	err = 1;
+    if (err)
+	goto error;
+
+/* retrieving the arguments */
+    sample_type = (const char *) sqlite3_value_text (argv[0]);
+    pixel_type = (const char *) sqlite3_value_text (argv[1]);
+    num_bands = sqlite3_value_int (argv[2]);
+
+/* preliminary arg checking */
     if (num_bands < 1 || num_bands > 255)
 	goto error;
 
@@ -3248,6 +4004,15 @@ fnct_CreateRasterCoverage (sqlite3_context * context, int argc,
 /                      int section_paths, int section_md5,
 /                      int section_summary, int is_queryable,
 /                      int is_opaque, double min_scale, double max_scale)
+/ CreateRasterCoverage(text coverage, text sample_type, text pixel_type,
+/                      int num_bands, text compression, int quality,
+/                      int tile_width, int tile_height, int srid,
+/                      double horz_res, double vert_res, BLOB no_data,
+/                      int strict_resolution, int mixed_resolutions,
+/                      int section_paths, int section_md5,
+/                      int section_summary, int is_queryable,
+/                      int is_opaque, double min_scale, double max_scale,
+/                      int dedup_tiles)
 /
 / will return 1 (TRUE, success) or 0 (FALSE, failure)
 / or -1 (INVALID ARGS)
@@ -3277,6 +4042,7 @@ fnct_CreateRasterCoverage (sqlite3_context * context, int argc,
     int is_opaque = 0;
     double min_scale = -1.0;
     double max_scale = -1.0;
+    int dedup_tiles = 0;
     sqlite3 *sqlite;
     int ret;
     rl2PixelPtr no_data = NULL;
@@ -3342,6 +4108,8 @@ fnct_CreateRasterCoverage (sqlite3_context * context, int argc,
 	  else
 	      err = 1;
       }
+    if (argc > 21 && sqlite3_value_type (argv[21]) != SQLITE_INTEGER)
+	err = 1;
     if (err)
 	goto error;
 
@@ -3443,6 +4211,12 @@ fnct_CreateRasterCoverage (sqlite3_context * context, int argc,
 	  if (sqlite3_value_type (argv[20]) == SQLITE_FLOAT)
 	      max_scale = sqlite3_value_double (argv[20]);
       }
+    if (argc > 21)
+      {
+	  dedup_tiles = sqlite3_value_int (argv[21]);
+	  if (dedup_tiles)
+	      dedup_tiles = 1;
+      }
 
 /* preliminary arg checking */
     if (num_bands < 1 || num_bands > 255)
@@ -3544,16 +4318,17 @@ fnct_CreateRasterCoverage (sqlite3_context * context, int argc,
 
 /* attempting to create the DBMS Coverage */
     sqlite = sqlite3_context_db_handle (context);
-    ret = rl2_create_dbms_coverage (sqlite, coverage, sample, pixel,
-				    (unsigned char) num_bands,
-				    compr, quality,
-				    (unsigned short) tile_width,
-				    (unsigned short) tile_height, srid,
-				    horz_res, vert_res, no_data, palette,
-				    strict_resolution, mixed_resolutions,
-				    section_paths, section_md5,
-				    section_summary, is_queryable, is_opaque,
-				    min_scale, max_scale);
+    ret = rl2_create_dbms_coverage_ex (sqlite, coverage, sample, pixel,
+				       (unsigned char) num_bands,
+				       compr, quality,
+				       (unsigned short) tile_width,
+				       (unsigned short) tile_height, srid,
+				       horz_res, vert_res, no_data, palette,
+				       strict_resolution, mixed_resolutions,
+				       section_paths, section_md5,
+				       section_summary, is_queryable,
+				       is_opaque, min_scale, max_scale,
+				       dedup_tiles);
     if (ret == RL2_OK)
 	sqlite3_result_int (context, 1);
     else
@@ -3879,287 +4654,580 @@ fnct_SetRasterCoverageVisibilityRange (sqlite3_context * context, int argc,
     double min_scale = -1.0;
     double max_scale = -1.0;
     int ret;
-    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    coverage_name = (const char *) sqlite3_value_text (argv[0]);
+    if (sqlite3_value_type (argv[1]) == SQLITE_INTEGER)
+      {
+	  val = sqlite3_value_int (argv[1]);
+	  min_scale = val;
+      }
+    else if (sqlite3_value_type (argv[1]) == SQLITE_FLOAT)
+	min_scale = sqlite3_value_double (argv[1]);
+    else if (sqlite3_value_type (argv[1]) == SQLITE_NULL)
+	;
+    else
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    if (sqlite3_value_type (argv[2]) == SQLITE_INTEGER)
+      {
+	  val = sqlite3_value_int (argv[2]);
+	  max_scale = val;
+      }
+    else if (sqlite3_value_type (argv[2]) == SQLITE_FLOAT)
+	max_scale = sqlite3_value_double (argv[2]);
+    else if (sqlite3_value_type (argv[2]) == SQLITE_NULL)
+	;
+    else
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    ret =
+	rl2_set_dbms_coverage_visibility_range (sqlite, coverage_name,
+						min_scale, max_scale);
+    if (ret == RL2_TRUE)
+	sqlite3_result_int (context, 1);
+    else if (ret == RL2_FALSE)
+	sqlite3_result_int (context, 0);
+    else
+	sqlite3_result_int (context, -1);
+}
+
+static void
+fnct_GetRasterCoverageMinScaleDenominator (sqlite3_context * context, int argc,
+					   sqlite3_value ** argv)
+{
+/* SQL function:
+/ GetRasterCoverageMinScaleDenominator(String db_prefix, String coverage_name)
+/
+/ will return the Raster Coverage Visibility Range MinScale
+/ returns a Double value (if set) or NULL (if unset)
+/ -1 on invalid arguments or if the Raster Coverage does not exist
+*/
+    const char *db_prefix = NULL;
+    const char *coverage_name;
+    double min_scale;
+    double max_scale;
+    int ret;
+    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT
+	|| sqlite3_value_type (argv[0]) == SQLITE_NULL)
+	;
+    else
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
+	db_prefix = (const char *) sqlite3_value_text (argv[0]);
+    coverage_name = (const char *) sqlite3_value_text (argv[1]);
+    ret =
+	rl2_get_dbms_coverage_visibility_range (sqlite, db_prefix,
+						coverage_name, &min_scale,
+						&max_scale);
+    if (ret == RL2_TRUE)
+      {
+	  if (min_scale < 0.0)
+	      sqlite3_result_null (context);
+	  else
+	      sqlite3_result_double (context, min_scale);
+      }
+    else
+	sqlite3_result_int (context, -1);
+}
+
+static void
+fnct_GetRasterCoverageMaxScaleDenominator (sqlite3_context * context, int argc,
+					   sqlite3_value ** argv)
+{
+/* SQL function:
+/ GetRasterCoverageMaxScaleDenominator(String db_prefix, String coverage_name)
+/
+/ will return the Raster Coverage Visibility Range MaxScale
+/ returns a Double value (if set) or NULL (if unset)
+/ -1 on invalid arguments or if the Raster Coverage does not exist
+*/
+    const char *db_prefix = NULL;
+    const char *coverage_name;
+    double min_scale;
+    double max_scale;
+    int ret;
+    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT
+	|| sqlite3_value_type (argv[0]) == SQLITE_NULL)
+	;
+    else
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
+	db_prefix = (const char *) sqlite3_value_text (argv[0]);
+    coverage_name = (const char *) sqlite3_value_text (argv[1]);
+    ret =
+	rl2_get_dbms_coverage_visibility_range (sqlite, db_prefix,
+						coverage_name, &min_scale,
+						&max_scale);
+    if (ret == RL2_TRUE)
+      {
+	  if (max_scale < 0.0)
+	      sqlite3_result_null (context);
+	  else
+	      sqlite3_result_double (context, max_scale);
+      }
+    else
+	sqlite3_result_int (context, -1);
+}
+
+static void
+fnct_CopyRasterCoverage (sqlite3_context * context, int argc,
+			 sqlite3_value ** argv)
+{
+/* SQL function:
+/ CopyRasterCoverage(String db_prefix, String coverage_name)
+/   or
+/ CopyRasterCoverage(String db_prefix, String coverage_name, int transaction)
+/
+/ copies a whole Raster Coverage from an Attached DB
+/ returns 1 on success
+/ 0 on failure, -1 on invalid arguments
+*/
+    int ret;
+    const char *db_prefix;
+    const char *coverage_name;
+    int transaction = 0;
+    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    db_prefix = (const char *) sqlite3_value_text (argv[0]);
+    coverage_name = (const char *) sqlite3_value_text (argv[1]);
+    if (argc == 3)
+      {
+	  if (sqlite3_value_type (argv[2]) == SQLITE_INTEGER)
+	      transaction = sqlite3_value_int (argv[2]);
+	  else
+	    {
+		sqlite3_result_int (context, -1);
+		return;
+	    }
+      }
+
+    if (transaction)
+      {
+	  /* starting a DBMS Transaction */
+	  ret = sqlite3_exec (sqlite, "BEGIN", NULL, NULL, NULL);
+	  if (ret != SQLITE_OK)
+	    {
+		sqlite3_result_int (context, 0);
+		return;
+	    }
+      }
+
+/* just in case, attempting to (re)create raster meta-tables */
+    sqlite3_exec (sqlite, "SELECT CreateRasterCoveragesTable()", NULL, NULL,
+		  NULL);
+    sqlite3_exec (sqlite, "SELECT CreateStylingTables()", NULL, NULL, NULL);
+
+/* checks if a Raster Coverage of the same name already exists on Main */
+    if (rl2_check_raster_coverage_destination (sqlite, coverage_name) != RL2_OK)
+      {
+	  if (transaction)
+	      sqlite3_exec (sqlite, "ROLLBACK", NULL, NULL, NULL);
+	  sqlite3_result_int (context, 0);
+	  return;
+      }
+/* checks if the Raster Coverage origin do really exists */
+    if (rl2_check_raster_coverage_origin (sqlite, db_prefix, coverage_name) !=
+	RL2_OK)
+      {
+	  if (transaction)
+	      sqlite3_exec (sqlite, "ROLLBACK", NULL, NULL, NULL);
+	  sqlite3_result_int (context, 0);
+	  return;
+      }
+/* attemtping to copy */
+    if (rl2_copy_raster_coverage (sqlite, db_prefix, coverage_name) != RL2_OK)
+      {
+	  if (transaction)
+	      sqlite3_exec (sqlite, "ROLLBACK", NULL, NULL, NULL);
+	  sqlite3_result_int (context, 0);
+	  return;
+      }
+
+    if (transaction)
+      {
+	  /* committing the still pending Transaction */
+	  ret = sqlite3_exec (sqlite, "COMMIT", NULL, NULL, NULL);
+	  if (ret != SQLITE_OK)
+	    {
+		sqlite3_result_int (context, 0);
+		return;
+	    }
+      }
+    sqlite3_result_int (context, 1);
+}
+
+static void
+fnct_DeleteSection (sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+/* SQL function:
+/ DeleteSection(text coverage, integer section_id)
+/ DeleteSection(text coverage, integer section_id, int transaction)
+/
+/ will return 1 (TRUE, success) or 0 (FALSE, failure)
+/ or -1 (INVALID ARGS)
+/
+*/
+    int err = 0;
+    const char *coverage;
+    sqlite3_int64 section_id;
+    int transaction = 1;
+    sqlite3 *sqlite;
+    int ret;
+    rl2CoveragePtr cvg = NULL;
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
     if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+	err = 1;
+    if (sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
+	err = 1;
+    if (argc > 2 && sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
+	err = 1;
+    if (err)
+	goto invalid;
+
+/* retrieving the arguments */
+    sqlite = sqlite3_context_db_handle (context);
+    coverage = (const char *) sqlite3_value_text (argv[0]);
+    section_id = sqlite3_value_int64 (argv[1]);
+    if (argc > 2)
+	transaction = sqlite3_value_int (argv[2]);
+
+    cvg = rl2_create_coverage_from_dbms (sqlite, NULL, coverage);
+    if (cvg == NULL)
+	goto error;
+
+    if (transaction)
       {
-	  sqlite3_result_int (context, -1);
-	  return;
-      }
-    coverage_name = (const char *) sqlite3_value_text (argv[0]);
-    if (sqlite3_value_type (argv[1]) == SQLITE_INTEGER)
-      {
-	  val = sqlite3_value_int (argv[1]);
-	  min_scale = val;
-      }
-    else if (sqlite3_value_type (argv[1]) == SQLITE_FLOAT)
-	min_scale = sqlite3_value_double (argv[1]);
-    else if (sqlite3_value_type (argv[1]) == SQLITE_NULL)
-	;
-    else
-      {
-	  sqlite3_result_int (context, -1);
-	  return;
+	  /* starting a DBMS Transaction */
+	  ret = sqlite3_exec (sqlite, "BEGIN", NULL, NULL, NULL);
+	  if (ret != SQLITE_OK)
+	      goto error;
       }
-    if (sqlite3_value_type (argv[2]) == SQLITE_INTEGER)
+
+    if (rl2_delete_dbms_section (sqlite, coverage, section_id) != RL2_OK)
+	goto error;
+
+    if (transaction)
       {
-	  val = sqlite3_value_int (argv[2]);
-	  max_scale = val;
+	  /* committing the still pending transaction */
+	  ret = sqlite3_exec (sqlite, "COMMIT", NULL, NULL, NULL);
+	  if (ret != SQLITE_OK)
+	      goto error;
       }
-    else if (sqlite3_value_type (argv[2]) == SQLITE_FLOAT)
-	max_scale = sqlite3_value_double (argv[2]);
-    else if (sqlite3_value_type (argv[2]) == SQLITE_NULL)
-	;
-    else
+    sqlite3_result_int (context, 1);
+    rl2_destroy_coverage (cvg);
+    return;
+
+  invalid:
+    sqlite3_result_int (context, -1);
+    return;
+  error:
+    if (cvg != NULL)
+	rl2_destroy_coverage (cvg);
+    sqlite3_result_int (context, 0);
+    if (transaction)
       {
-	  sqlite3_result_int (context, -1);
-	  return;
+	  /* invalidating the pending transaction */
+	  sqlite3_exec (sqlite, "ROLLBACK", NULL, NULL, NULL);
       }
-    ret =
-	rl2_set_dbms_coverage_visibility_range (sqlite, coverage_name,
-						min_scale, max_scale);
-    if (ret == RL2_TRUE)
-	sqlite3_result_int (context, 1);
-    else if (ret == RL2_FALSE)
-	sqlite3_result_int (context, 0);
-    else
-	sqlite3_result_int (context, -1);
+    return;
 }
 
 static void
-fnct_GetRasterCoverageMinScaleDenominator (sqlite3_context * context, int argc,
-					   sqlite3_value ** argv)
+fnct_DropRasterCoverage (sqlite3_context * context, int argc,
+			 sqlite3_value ** argv)
 {
 /* SQL function:
-/ GetRasterCoverageMinScaleDenominator(String db_prefix, String coverage_name)
+/ DropRasterCoverage(text coverage)
+/ DropRasterCoverage(text coverage, int transaction)
+/
+/ will return 1 (TRUE, success) or 0 (FALSE, failure)
+/ or -1 (INVALID ARGS)
 /
-/ will return the Raster Coverage Visibility Range MinScale
-/ returns a Double value (if set) or NULL (if unset)
-/ -1 on invalid arguments or if the Raster Coverage does not exist
 */
-    const char *db_prefix = NULL;
-    const char *coverage_name;
-    double min_scale;
-    double max_scale;
+    int err = 0;
+    const char *coverage;
+    int transaction = 1;
+    sqlite3 *sqlite;
     int ret;
-    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    rl2CoveragePtr cvg = NULL;
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
-    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT
-	|| sqlite3_value_type (argv[0]) == SQLITE_NULL)
-	;
-    else
+
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+	err = 1;
+    if (argc > 1 && sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
+	err = 1;
+    if (err)
+	goto invalid;
+
+/* retrieving the arguments */
+    sqlite = sqlite3_context_db_handle (context);
+    coverage = (const char *) sqlite3_value_text (argv[0]);
+    if (argc > 1)
+	transaction = sqlite3_value_int (argv[1]);
+
+    cvg = rl2_create_coverage_from_dbms (sqlite, NULL, coverage);
+    if (cvg == NULL)
+	goto error;
+
+    if (transaction)
       {
-	  sqlite3_result_int (context, -1);
-	  return;
+	  /* starting a DBMS Transaction */
+	  ret = sqlite3_exec (sqlite, "BEGIN", NULL, NULL, NULL);
+	  if (ret != SQLITE_OK)
+	      goto error;
       }
-    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+
+    if (rl2_drop_dbms_coverage (sqlite, coverage) != RL2_OK)
+	goto error;
+
+    if (transaction)
       {
-	  sqlite3_result_int (context, -1);
-	  return;
+	  /* committing the still pending transaction */
+	  ret = sqlite3_exec (sqlite, "COMMIT", NULL, NULL, NULL);
+	  if (ret != SQLITE_OK)
+	      goto error;
       }
-    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
-	db_prefix = (const char *) sqlite3_value_text (argv[0]);
-    coverage_name = (const char *) sqlite3_value_text (argv[1]);
-    ret =
-	rl2_get_dbms_coverage_visibility_range (sqlite, db_prefix,
-						coverage_name, &min_scale,
-						&max_scale);
-    if (ret == RL2_TRUE)
+    sqlite3_result_int (context, 1);
+    rl2_destroy_coverage (cvg);
+    return;
+
+  invalid:
+    sqlite3_result_int (context, -1);
+    return;
+  error:
+    if (cvg != NULL)
+	rl2_destroy_coverage (cvg);
+    sqlite3_result_int (context, 0);
+    if (transaction)
       {
-	  if (min_scale < 0.0)
-	      sqlite3_result_null (context);
-	  else
-	      sqlite3_result_double (context, min_scale);
+	  /* invalidating the pending transaction */
+	  sqlite3_exec (sqlite, "ROLLBACK", NULL, NULL, NULL);
       }
-    else
-	sqlite3_result_int (context, -1);
+    return;
 }
 
 static void
-fnct_GetRasterCoverageMaxScaleDenominator (sqlite3_context * context, int argc,
-					   sqlite3_value ** argv)
+fnct_BuildVectorGeneralization (sqlite3_context * context, int argc,
+				sqlite3_value ** argv)
 {
 /* SQL function:
-/ GetRasterCoverageMaxScaleDenominator(String db_prefix, String coverage_name)
+/ BuildVectorGeneralization(text coverage)
+/ BuildVectorGeneralization(text coverage, int transaction)
+/
+/ (re)builds the multi-resolution generalization store
+/ (one simplified copy of each Feature for each scale band)
+/ of a Vector Coverage; requires a table-based or view-based
+/ Coverage (Topologies are not supported)
+/ Triggers keep the store in sync with later changes: edited
+/ Features are stored at full resolution until the next rebuild
+/
+/ will return 1 (TRUE, success) or 0 (FALSE, failure)
+/ or -1 (INVALID ARGS)
 /
-/ will return the Raster Coverage Visibility Range MaxScale
-/ returns a Double value (if set) or NULL (if unset)
-/ -1 on invalid arguments or if the Raster Coverage does not exist
 */
-    const char *db_prefix = NULL;
-    const char *coverage_name;
-    double min_scale;
-    double max_scale;
+    int err = 0;
+    const char *coverage;
+    int transaction = 1;
+    sqlite3 *sqlite;
     int ret;
-    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    struct rl2_private_data *priv_data = NULL;
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
-    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT
-	|| sqlite3_value_type (argv[0]) == SQLITE_NULL)
-	;
-    else
+
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+	err = 1;
+    if (argc > 1 && sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
+	err = 1;
+    if (err)
+	goto invalid;
+
+/* retrieving the arguments */
+    sqlite = sqlite3_context_db_handle (context);
+    priv_data = sqlite3_user_data (context);
+    coverage = (const char *) sqlite3_value_text (argv[0]);
+    if (argc > 1)
+	transaction = sqlite3_value_int (argv[1]);
+
+    if (transaction)
       {
-	  sqlite3_result_int (context, -1);
-	  return;
+	  /* starting a DBMS Transaction */
+	  ret = sqlite3_exec (sqlite, "BEGIN", NULL, NULL, NULL);
+	  if (ret != SQLITE_OK)
+	      goto error;
       }
-    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+
+    if (rl2_build_vector_generalization
+	(sqlite, priv_data, coverage) != RL2_OK)
+	goto error;
+
+    if (transaction)
       {
-	  sqlite3_result_int (context, -1);
-	  return;
+	  /* committing the still pending transaction */
+	  ret = sqlite3_exec (sqlite, "COMMIT", NULL, NULL, NULL);
+	  if (ret != SQLITE_OK)
+	      goto error;
       }
-    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
-	db_prefix = (const char *) sqlite3_value_text (argv[0]);
-    coverage_name = (const char *) sqlite3_value_text (argv[1]);
-    ret =
-	rl2_get_dbms_coverage_visibility_range (sqlite, db_prefix,
-						coverage_name, &min_scale,
-						&max_scale);
-    if (ret == RL2_TRUE)
+    sqlite3_result_int (context, 1);
+    return;
+
+  invalid:
+    sqlite3_result_int (context, -1);
+    return;
+  error:
+    sqlite3_result_int (context, 0);
+    if (transaction)
       {
-	  if (max_scale < 0.0)
-	      sqlite3_result_null (context);
-	  else
-	      sqlite3_result_double (context, max_scale);
+	  /* invalidating the pending transaction */
+	  sqlite3_exec (sqlite, "ROLLBACK", NULL, NULL, NULL);
       }
-    else
-	sqlite3_result_int (context, -1);
+    return;
 }
 
 static void
-fnct_CopyRasterCoverage (sqlite3_context * context, int argc,
-			 sqlite3_value ** argv)
+fnct_DropVectorGeneralization (sqlite3_context * context, int argc,
+			       sqlite3_value ** argv)
 {
 /* SQL function:
-/ CopyRasterCoverage(String db_prefix, String coverage_name)
-/   or
-/ CopyRasterCoverage(String db_prefix, String coverage_name, int transaction)
+/ DropVectorGeneralization(text coverage)
+/ DropVectorGeneralization(text coverage, int transaction)
+/
+/ drops the generalization store of a Vector Coverage (if any)
+/ and all its Triggers
+/
+/ will return 1 (TRUE, success) or 0 (FALSE, failure)
+/ or -1 (INVALID ARGS)
 /
-/ copies a whole Raster Coverage from an Attached DB
-/ returns 1 on success
-/ 0 on failure, -1 on invalid arguments
 */
+    int err = 0;
+    const char *coverage;
+    int transaction = 1;
+    sqlite3 *sqlite;
     int ret;
-    const char *db_prefix;
-    const char *coverage_name;
-    int transaction = 0;
-    sqlite3 *sqlite = sqlite3_context_db_handle (context);
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
     if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
-      {
-	  sqlite3_result_int (context, -1);
-	  return;
-      }
-    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
-      {
-	  sqlite3_result_int (context, -1);
-	  return;
-      }
-    db_prefix = (const char *) sqlite3_value_text (argv[0]);
-    coverage_name = (const char *) sqlite3_value_text (argv[1]);
-    if (argc == 3)
-      {
-	  if (sqlite3_value_type (argv[2]) == SQLITE_INTEGER)
-	      transaction = sqlite3_value_int (argv[2]);
-	  else
-	    {
-		sqlite3_result_int (context, -1);
-		return;
-	    }
-      }
+	err = 1;
+    if (argc > 1 && sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
+	err = 1;
+    if (err)
+	goto invalid;
+
+/* retrieving the arguments */
+    sqlite = sqlite3_context_db_handle (context);
+    coverage = (const char *) sqlite3_value_text (argv[0]);
+    if (argc > 1)
+	transaction = sqlite3_value_int (argv[1]);
 
     if (transaction)
       {
 	  /* starting a DBMS Transaction */
 	  ret = sqlite3_exec (sqlite, "BEGIN", NULL, NULL, NULL);
 	  if (ret != SQLITE_OK)
-	    {
-		sqlite3_result_int (context, 0);
-		return;
-	    }
+	      goto error;
       }
 
-/* just in case, attempting to (re)create raster meta-tables */
-    sqlite3_exec (sqlite, "SELECT CreateRasterCoveragesTable()", NULL, NULL,
-		  NULL);
-    sqlite3_exec (sqlite, "SELECT CreateStylingTables()", NULL, NULL, NULL);
-
-/* checks if a Raster Coverage of the same name already exists on Main */
-    if (rl2_check_raster_coverage_destination (sqlite, coverage_name) != RL2_OK)
-      {
-	  if (transaction)
-	      sqlite3_exec (sqlite, "ROLLBACK", NULL, NULL, NULL);
-	  sqlite3_result_int (context, 0);
-	  return;
-      }
-/* checks if the Raster Coverage origin do really exists */
-    if (rl2_check_raster_coverage_origin (sqlite, db_prefix, coverage_name) !=
-	RL2_OK)
-      {
-	  if (transaction)
-	      sqlite3_exec (sqlite, "ROLLBACK", NULL, NULL, NULL);
-	  sqlite3_result_int (context, 0);
-	  return;
-      }
-/* attemtping to copy */
-    if (rl2_copy_raster_coverage (sqlite, db_prefix, coverage_name) != RL2_OK)
-      {
-	  if (transaction)
-	      sqlite3_exec (sqlite, "ROLLBACK", NULL, NULL, NULL);
-	  sqlite3_result_int (context, 0);
-	  return;
-      }
+    if (rl2_drop_vector_generalization (sqlite, coverage) != RL2_OK)
+	goto error;
 
     if (transaction)
       {
-	  /* committing the still pending Transaction */
+	  /* committing the still pending transaction */
 	  ret = sqlite3_exec (sqlite, "COMMIT", NULL, NULL, NULL);
 	  if (ret != SQLITE_OK)
-	    {
-		sqlite3_result_int (context, 0);
-		return;
-	    }
+	      goto error;
       }
     sqlite3_result_int (context, 1);
+    return;
+
+  invalid:
+    sqlite3_result_int (context, -1);
+    return;
+  error:
+    sqlite3_result_int (context, 0);
+    if (transaction)
+      {
+	  /* invalidating the pending transaction */
+	  sqlite3_exec (sqlite, "ROLLBACK", NULL, NULL, NULL);
+      }
+    return;
 }
 
 static void
-fnct_DeleteSection (sqlite3_context * context, int argc, sqlite3_value ** argv)
+fnct_BuildTopoFaceCache (sqlite3_context * context, int argc,
+			 sqlite3_value ** argv)
 {
 /* SQL function:
-/ DeleteSection(text coverage, integer section_id)
-/ DeleteSection(text coverage, integer section_id, int transaction)
+/ BuildTopoFaceCache(text topology)
+/ BuildTopoFaceCache(text topology, int transaction)
+/
+/ (re)builds the Face Cache of a Topology, i.e. the materialized
+/ Geometries of all Faces (supported by a Spatial Index); the Cache
+/ is automatically kept in sync by Triggers and is directly used
+/ when painting a TopoGeo Coverage
 /
 / will return 1 (TRUE, success) or 0 (FALSE, failure)
 / or -1 (INVALID ARGS)
 /
 */
     int err = 0;
-    const char *coverage;
-    sqlite3_int64 section_id;
+    const char *topology;
     int transaction = 1;
     sqlite3 *sqlite;
     int ret;
-    rl2CoveragePtr cvg = NULL;
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
 
     if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
 	err = 1;
-    if (sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
-	err = 1;
-    if (argc > 2 && sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
+    if (argc > 1 && sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
 	err = 1;
     if (err)
 	goto invalid;
 
 /* retrieving the arguments */
     sqlite = sqlite3_context_db_handle (context);
-    coverage = (const char *) sqlite3_value_text (argv[0]);
-    section_id = sqlite3_value_int64 (argv[1]);
-    if (argc > 2)
-	transaction = sqlite3_value_int (argv[2]);
-
-    cvg = rl2_create_coverage_from_dbms (sqlite, NULL, coverage);
-    if (cvg == NULL)
-	goto error;
+    topology = (const char *) sqlite3_value_text (argv[0]);
+    if (argc > 1)
+	transaction = sqlite3_value_int (argv[1]);
 
     if (transaction)
       {
@@ -4169,7 +5237,7 @@ fnct_DeleteSection (sqlite3_context * context, int argc, sqlite3_value ** argv)
 	      goto error;
       }
 
-    if (rl2_delete_dbms_section (sqlite, coverage, section_id) != RL2_OK)
+    if (rl2_build_topo_face_cache (sqlite, topology) != RL2_OK)
 	goto error;
 
     if (transaction)
@@ -4180,15 +5248,12 @@ fnct_DeleteSection (sqlite3_context * context, int argc, sqlite3_value ** argv)
 	      goto error;
       }
     sqlite3_result_int (context, 1);
-    rl2_destroy_coverage (cvg);
     return;
 
   invalid:
     sqlite3_result_int (context, -1);
     return;
   error:
-    if (cvg != NULL)
-	rl2_destroy_coverage (cvg);
     sqlite3_result_int (context, 0);
     if (transaction)
       {
@@ -4199,23 +5264,24 @@ fnct_DeleteSection (sqlite3_context * context, int argc, sqlite3_value ** argv)
 }
 
 static void
-fnct_DropRasterCoverage (sqlite3_context * context, int argc,
-			 sqlite3_value ** argv)
+fnct_DropTopoFaceCache (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
 {
 /* SQL function:
-/ DropRasterCoverage(text coverage)
-/ DropRasterCoverage(text coverage, int transaction)
+/ DropTopoFaceCache(text topology)
+/ DropTopoFaceCache(text topology, int transaction)
+/
+/ drops the Face Cache of a Topology (if any)
 /
 / will return 1 (TRUE, success) or 0 (FALSE, failure)
 / or -1 (INVALID ARGS)
 /
 */
     int err = 0;
-    const char *coverage;
+    const char *topology;
     int transaction = 1;
     sqlite3 *sqlite;
     int ret;
-    rl2CoveragePtr cvg = NULL;
     RL2_UNUSED ();		/* LCOV_EXCL_LINE */
 
     if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
@@ -4227,14 +5293,10 @@ fnct_DropRasterCoverage (sqlite3_context * context, int argc,
 
 /* retrieving the arguments */
     sqlite = sqlite3_context_db_handle (context);
-    coverage = (const char *) sqlite3_value_text (argv[0]);
+    topology = (const char *) sqlite3_value_text (argv[0]);
     if (argc > 1)
 	transaction = sqlite3_value_int (argv[1]);
 
-    cvg = rl2_create_coverage_from_dbms (sqlite, NULL, coverage);
-    if (cvg == NULL)
-	goto error;
-
     if (transaction)
       {
 	  /* starting a DBMS Transaction */
@@ -4243,7 +5305,7 @@ fnct_DropRasterCoverage (sqlite3_context * context, int argc,
 	      goto error;
       }
 
-    if (rl2_drop_dbms_coverage (sqlite, coverage) != RL2_OK)
+    if (rl2_drop_topo_face_cache (sqlite, topology) != RL2_OK)
 	goto error;
 
     if (transaction)
@@ -4254,15 +5316,12 @@ fnct_DropRasterCoverage (sqlite3_context * context, int argc,
 	      goto error;
       }
     sqlite3_result_int (context, 1);
-    rl2_destroy_coverage (cvg);
     return;
 
   invalid:
     sqlite3_result_int (context, -1);
     return;
   error:
-    if (cvg != NULL)
-	rl2_destroy_coverage (cvg);
     sqlite3_result_int (context, 0);
     if (transaction)
       {
@@ -4855,6 +5914,13 @@ fnct_Pyramidize (sqlite3_context * context, int argc, sqlite3_value ** argv)
 / Pyramidize(text coverage, integer section_id, int force_rebuild)
 / Pyramidize(text coverage, integer section_id, int force_rebuild,
 /            int transaction)
+/ Pyramidize(text coverage, integer section_id, int force_rebuild,
+/            int transaction, int incremental)
+/
+/ incremental mode (section_id must be NULL, force_rebuild is ignored):
+/ a Monolithic Pyramid will be updated by rebuilding only the tiles
+/ affected by Sections imported or deleted since the last build;
+/ Section Pyramids will be built only for Sections still lacking them
 /
 / will return 1 (TRUE, success) or 0 (FALSE, failure)
 / or -1 (INVALID ARGS)
@@ -4866,6 +5932,7 @@ fnct_Pyramidize (sqlite3_context * context, int argc, sqlite3_value ** argv)
     int null_id = 1;
     int forced_rebuild = 0;
     int transaction = 1;
+    int incremental = 0;
     sqlite3 *sqlite;
     int ret;
     const void *data;
@@ -4880,6 +5947,8 @@ fnct_Pyramidize (sqlite3_context * context, int argc, sqlite3_value ** argv)
 	err = 1;
     if (argc > 3 && sqlite3_value_type (argv[3]) != SQLITE_INTEGER)
 	err = 1;
+    if (argc > 4 && sqlite3_value_type (argv[4]) != SQLITE_INTEGER)
+	err = 1;
     if (err)
       {
 	  sqlite3_result_int (context, -1);
@@ -4906,6 +5975,13 @@ fnct_Pyramidize (sqlite3_context * context, int argc, sqlite3_value ** argv)
 	forced_rebuild = sqlite3_value_int (argv[2]);
     if (argc > 3)
 	transaction = sqlite3_value_int (argv[3]);
+    if (argc > 4)
+	incremental = sqlite3_value_int (argv[4]);
+    if (incremental && !null_id)
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
     if (transaction)
       {
 	  /* starting a DBMS Transaction */
@@ -4916,7 +5992,9 @@ fnct_Pyramidize (sqlite3_context * context, int argc, sqlite3_value ** argv)
 		return;
 	    }
       }
-    if (null_id)
+    if (incremental)
+	ret = rl2_build_incremental_pyramid (sqlite, data, cvg_name, 1);
+    else if (null_id)
 	ret =
 	    rl2_build_all_section_pyramids (sqlite, data, cvg_name,
 					    forced_rebuild, 1);
@@ -5060,53 +6138,118 @@ fnct_DePyramidize (sqlite3_context * context, int argc, sqlite3_value ** argv)
 	  sqlite3_result_int (context, -1);
 	  return;
       }
-/* attempting to delete all Pyramid levels */
+/* attempting to delete all Pyramid levels */
+    sqlite = sqlite3_context_db_handle (context);
+    cvg_name = (const char *) sqlite3_value_text (argv[0]);
+    if (argc > 1)
+      {
+	  if (sqlite3_value_type (argv[1]) == SQLITE_INTEGER)
+	    {
+		section_id = sqlite3_value_int64 (argv[1]);
+		null_id = 0;
+	    }
+      }
+    if (argc > 2)
+	transaction = sqlite3_value_int (argv[2]);
+    if (transaction)
+      {
+	  /* starting a DBMS Transaction */
+	  ret = sqlite3_exec (sqlite, "BEGIN", NULL, NULL, NULL);
+	  if (ret != SQLITE_OK)
+	    {
+		sqlite3_result_int (context, -1);
+		return;
+	    }
+      }
+    if (null_id)
+	ret = rl2_delete_all_pyramids (sqlite, cvg_name);
+    else
+	ret = rl2_delete_section_pyramid (sqlite, cvg_name, section_id);
+    if (ret != RL2_OK)
+      {
+	  sqlite3_result_int (context, 0);
+	  if (transaction)
+	    {
+		/* invalidating the pending transaction */
+		sqlite3_exec (sqlite, "ROLLBACK", NULL, NULL, NULL);
+	    }
+	  return;
+      }
+    if (transaction)
+      {
+	  /* committing the still pending transaction */
+	  ret = sqlite3_exec (sqlite, "COMMIT", NULL, NULL, NULL);
+	  if (ret != SQLITE_OK)
+	    {
+		sqlite3_result_int (context, -1);
+		return;
+	    }
+      }
+    sqlite3_result_int (context, 1);
+}
+
+static void
+fnct_TrainCompressionDictionary (sqlite3_context * context, int argc,
+				 sqlite3_value ** argv)
+{
+/* SQL function:
+/ TrainCompressionDictionary(text coverage)
+/ TrainCompressionDictionary(text coverage, int max_samples)
+/ TrainCompressionDictionary(text coverage, int max_samples,
+/                            int dict_size)
+/
+/ samples the tiles already stored into a ZSTD compressed Coverage,
+/ trains a ZSTD Dictionary and permanently stores it; any further
+/ tile will then be compressed by using the Dictionary, while
+/ previously stored tiles will still remain perfectly readable
+/ will return 1 (TRUE, success) or 0 (FALSE, failure)
+/ or -1 (INVALID ARGS)
+/
+*/
+    int err = 0;
+    const char *cvg_name;
+    int max_samples = 256;
+    int dict_size = 112640;
+    unsigned int dict_id;
+    sqlite3 *sqlite;
+    int ret;
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+	err = 1;
+    if (argc > 1 && sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
+	err = 1;
+    if (argc > 2 && sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
+	err = 1;
+    if (argc > 1)
+      {
+	  max_samples = sqlite3_value_int (argv[1]);
+	  if (max_samples < 8 || max_samples > 65536)
+	      err = 1;
+      }
+    if (argc > 2)
+      {
+	  dict_size = sqlite3_value_int (argv[2]);
+	  if (dict_size < 1024 || dict_size > 1048576)
+	      err = 1;
+      }
+    if (err)
+      {
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+
+/* attempting to train the Dictionary */
     sqlite = sqlite3_context_db_handle (context);
     cvg_name = (const char *) sqlite3_value_text (argv[0]);
-    if (argc > 1)
-      {
-	  if (sqlite3_value_type (argv[1]) == SQLITE_INTEGER)
-	    {
-		section_id = sqlite3_value_int64 (argv[1]);
-		null_id = 0;
-	    }
-      }
-    if (argc > 2)
-	transaction = sqlite3_value_int (argv[2]);
-    if (transaction)
-      {
-	  /* starting a DBMS Transaction */
-	  ret = sqlite3_exec (sqlite, "BEGIN", NULL, NULL, NULL);
-	  if (ret != SQLITE_OK)
-	    {
-		sqlite3_result_int (context, -1);
-		return;
-	    }
-      }
-    if (null_id)
-	ret = rl2_delete_all_pyramids (sqlite, cvg_name);
-    else
-	ret = rl2_delete_section_pyramid (sqlite, cvg_name, section_id);
+    ret =
+	rl2_train_zstd_dictionary (sqlite, cvg_name, max_samples, dict_size,
+				   &dict_id);
     if (ret != RL2_OK)
       {
 	  sqlite3_result_int (context, 0);
-	  if (transaction)
-	    {
-		/* invalidating the pending transaction */
-		sqlite3_exec (sqlite, "ROLLBACK", NULL, NULL, NULL);
-	    }
 	  return;
       }
-    if (transaction)
-      {
-	  /* committing the still pending transaction */
-	  ret = sqlite3_exec (sqlite, "COMMIT", NULL, NULL, NULL);
-	  if (ret != SQLITE_OK)
-	    {
-		sqlite3_result_int (context, -1);
-		return;
-	    }
-      }
     sqlite3_result_int (context, 1);
 }
 
@@ -5670,8 +6813,8 @@ fnct_LoadRasterFromWMS (sqlite3_context * context, int argc,
 }
 
 static void
-common_write_geotiff (int by_section, sqlite3_context * context, int argc,
-		      sqlite3_value ** argv)
+do_write_geotiff (int by_section, sqlite3_context * context, int argc,
+		  sqlite3_value ** argv)
 {
 /* common implementation for Write GeoTIFF */
     int err = 0;
@@ -5984,6 +7127,18 @@ common_write_geotiff (int by_section, sqlite3_context * context, int argc,
     sqlite3_result_int (context, errcode);
 }
 
+static void
+common_write_geotiff (int by_section, sqlite3_context * context, int argc,
+		      sqlite3_value ** argv)
+{
+/* cancellable wrapper for the above */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    do_write_geotiff (by_section, context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+}
+
 static void
 fnct_WriteGeoTiff (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
@@ -6044,8 +7199,8 @@ fnct_WriteSectionGeoTiff (sqlite3_context * context, int argc,
 }
 
 static void
-common_write_triple_band_geotiff (int by_section, sqlite3_context * context,
-				  int argc, sqlite3_value ** argv)
+do_write_triple_band_geotiff (int by_section, sqlite3_context * context,
+			      int argc, sqlite3_value ** argv)
 {
 /* common implementation WriteTripleBandGeoTiff */
     int err = 0;
@@ -6395,6 +7550,18 @@ common_write_triple_band_geotiff (int by_section, sqlite3_context * context,
     sqlite3_result_int (context, errcode);
 }
 
+static void
+common_write_triple_band_geotiff (int by_section, sqlite3_context * context,
+				  int argc, sqlite3_value ** argv)
+{
+/* cancellable wrapper for the above */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    do_write_triple_band_geotiff (by_section, context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+}
+
 static void
 fnct_WriteTripleBandGeoTiff (sqlite3_context * context, int argc,
 			     sqlite3_value ** argv)
@@ -6466,8 +7633,8 @@ fnct_WriteSectionTripleBandGeoTiff (sqlite3_context * context, int argc,
 }
 
 static void
-common_write_mono_band_geotiff (int by_section, sqlite3_context * context,
-				int argc, sqlite3_value ** argv)
+do_write_mono_band_geotiff (int by_section, sqlite3_context * context,
+			    int argc, sqlite3_value ** argv)
 {
 /* common implementation Write MonoBand GeoTiff
 */
@@ -6790,6 +7957,18 @@ common_write_mono_band_geotiff (int by_section, sqlite3_context * context,
     sqlite3_result_int (context, errcode);
 }
 
+static void
+common_write_mono_band_geotiff (int by_section, sqlite3_context * context,
+				int argc, sqlite3_value ** argv)
+{
+/* cancellable wrapper for the above */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    do_write_mono_band_geotiff (by_section, context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+}
+
 static void
 fnct_WriteMonoBandGeoTiff (sqlite3_context * context, int argc,
 			   sqlite3_value ** argv)
@@ -6855,8 +8034,8 @@ fnct_WriteSectionMonoBandGeoTiff (sqlite3_context * context, int argc,
 }
 
 static void
-common_write_tiff (int by_section, int with_worldfile,
-		   sqlite3_context * context, int argc, sqlite3_value ** argv)
+do_write_tiff (int by_section, int with_worldfile, sqlite3_context * context,
+	       int argc, sqlite3_value ** argv)
 {
 /* common implementation Write TIFF */
     int err = 0;
@@ -7195,6 +8374,18 @@ common_write_tiff (int by_section, int with_worldfile,
     sqlite3_result_int (context, errcode);
 }
 
+static void
+common_write_tiff (int by_section, int with_worldfile,
+		   sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+/* cancellable wrapper for the above */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    do_write_tiff (by_section, with_worldfile, context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+}
+
 static void
 fnct_WriteTiffTfw (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
@@ -7293,8 +8484,8 @@ fnct_WriteSectionTiff (sqlite3_context * context, int argc,
 }
 
 static void
-common_write_jpeg (int with_worldfile, int by_section,
-		   sqlite3_context * context, int argc, sqlite3_value ** argv)
+do_write_jpeg (int with_worldfile, int by_section, sqlite3_context * context,
+	       int argc, sqlite3_value ** argv)
 {
 /* common implementation for Write JPEG */
     int err = 0;
@@ -7551,6 +8742,18 @@ common_write_jpeg (int with_worldfile, int by_section,
     sqlite3_result_int (context, errcode);
 }
 
+static void
+common_write_jpeg (int with_worldfile, int by_section,
+		   sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+/* cancellable wrapper for the above */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    do_write_jpeg (with_worldfile, by_section, context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+}
+
 static void
 fnct_WriteJpegJgw (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
@@ -7634,9 +8837,9 @@ fnct_WriteSectionJpeg (sqlite3_context * context, int argc,
 }
 
 static void
-common_write_triple_band_tiff (int with_worldfile, int by_section,
-			       sqlite3_context * context, int argc,
-			       sqlite3_value ** argv)
+do_write_triple_band_tiff (int with_worldfile, int by_section,
+			   sqlite3_context * context, int argc,
+			   sqlite3_value ** argv)
 {
 /* common implementation Write TripleBand TIFF */
     int err = 0;
@@ -8017,6 +9220,19 @@ common_write_triple_band_tiff (int with_worldfile, int by_section,
     sqlite3_result_int (context, errcode);
 }
 
+static void
+common_write_triple_band_tiff (int with_worldfile, int by_section,
+			       sqlite3_context * context, int argc,
+			       sqlite3_value ** argv)
+{
+/* cancellable wrapper for the above */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    do_write_triple_band_tiff (with_worldfile, by_section, context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+}
+
 static void
 fnct_WriteTripleBandTiffTfw (sqlite3_context * context, int argc,
 			     sqlite3_value ** argv)
@@ -8143,9 +9359,9 @@ fnct_WriteSectionTripleBandTiff (sqlite3_context * context, int argc,
 }
 
 static void
-common_write_mono_band_tiff (int with_worldfile, int by_section,
-			     sqlite3_context * context, int argc,
-			     sqlite3_value ** argv)
+do_write_mono_band_tiff (int with_worldfile, int by_section,
+			 sqlite3_context * context, int argc,
+			 sqlite3_value ** argv)
 {
 /* common implementation Write Mono Band TIFF */
     int err = 0;
@@ -8490,6 +9706,19 @@ common_write_mono_band_tiff (int with_worldfile, int by_section,
     sqlite3_result_int (context, errcode);
 }
 
+static void
+common_write_mono_band_tiff (int with_worldfile, int by_section,
+			     sqlite3_context * context, int argc,
+			     sqlite3_value ** argv)
+{
+/* cancellable wrapper for the above */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    do_write_mono_band_tiff (with_worldfile, by_section, context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+}
+
 static void
 fnct_WriteMonoBandTiffTfw (sqlite3_context * context, int argc,
 			   sqlite3_value ** argv)
@@ -8605,8 +9834,8 @@ fnct_WriteSectionMonoBandTiff (sqlite3_context * context, int argc,
 }
 
 static void
-common_write_ascii_grid (int by_section, sqlite3_context * context, int argc,
-			 sqlite3_value ** argv)
+do_write_ascii_grid (int by_section, sqlite3_context * context, int argc,
+		     sqlite3_value ** argv)
 {
 /* common export ASCII Grid implementation */
     int err = 0;
@@ -8854,6 +10083,18 @@ common_write_ascii_grid (int by_section, sqlite3_context * context, int argc,
     sqlite3_result_int (context, errcode);
 }
 
+static void
+common_write_ascii_grid (int by_section, sqlite3_context * context, int argc,
+			 sqlite3_value ** argv)
+{
+/* cancellable wrapper for the above */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    do_write_ascii_grid (by_section, context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+}
+
 static void
 fnct_WriteAsciiGrid (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
@@ -8945,8 +10186,8 @@ do_retrieve_ndvi_band_selection (sqlite3 * sqlite, const char *db_prefix,
 }
 
 static void
-common_write_ndvi_ascii_grid (int by_section, sqlite3_context * context,
-			      int argc, sqlite3_value ** argv, int ndwi_mode)
+do_write_ndvi_ascii_grid (int by_section, sqlite3_context * context, int argc,
+			  sqlite3_value ** argv, int ndwi_mode)
 {
 /* common export NDVI/NDWI ASCII Grid implementation */
     int err = 0;
@@ -9212,6 +10453,18 @@ common_write_ndvi_ascii_grid (int by_section, sqlite3_context * context,
     sqlite3_result_int (context, errcode);
 }
 
+static void
+common_write_ndvi_ascii_grid (int by_section, sqlite3_context * context,
+			      int argc, sqlite3_value ** argv, int ndwi_mode)
+{
+/* cancellable wrapper for the above */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    do_write_ndvi_ascii_grid (by_section, context, argc, argv, ndwi_mode);
+    rl2_cancel_end_request (priv_data);
+}
+
 static void
 fnct_WriteNdviAsciiGrid (sqlite3_context * context, int argc,
 			 sqlite3_value ** argv)
@@ -10269,6 +11522,79 @@ fnct_GetStyledMapImageFromVector (sqlite3_context * context, int argc,
 	sqlite3_result_blob (context, image, image_size, free);
 }
 
+static void
+fnct_GetVectorTile (sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+/* SQL function:
+/ GetVectorTile(text db_prefix, text coverage, int z, int x, int y)
+/ GetVectorTile(text db_prefix, text coverage, int z, int x, int y,
+/               int extent)
+/ GetVectorTile(text db_prefix, text coverage, int z, int x, int y,
+/               int extent, int buffer)
+/
+/ will return a BLOB containing a Mapbox Vector Tile (XYZ scheme,
+/ EPSG:3857) from a Vector Coverage
+/ or NULL (INVALID ARGS)
+/
+*/
+    int err = 0;
+    const char *db_prefix = NULL;
+    const char *cvg_name;
+    int z;
+    int x;
+    int y;
+    int extent = 4096;
+    int buffer = 64;
+    sqlite3 *sqlite;
+    unsigned char *tile = NULL;
+    int tile_size;
+    RL2_UNUSED ();		/* LCOV_EXCL_LINE */
+
+/* testing arguments for validity */
+    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT
+	|| sqlite3_value_type (argv[0]) == SQLITE_NULL)
+	;
+    else
+	err = 1;
+    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+	err = 1;
+    if (sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
+	err = 1;
+    if (sqlite3_value_type (argv[3]) != SQLITE_INTEGER)
+	err = 1;
+    if (sqlite3_value_type (argv[4]) != SQLITE_INTEGER)
+	err = 1;
+    if (argc > 5 && sqlite3_value_type (argv[5]) != SQLITE_INTEGER)
+	err = 1;
+    if (argc > 6 && sqlite3_value_type (argv[6]) != SQLITE_INTEGER)
+	err = 1;
+    if (err)
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
+
+/* retrieving the arguments */
+    sqlite = sqlite3_context_db_handle (context);
+    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
+	db_prefix = (const char *) sqlite3_value_text (argv[0]);
+    cvg_name = (const char *) sqlite3_value_text (argv[1]);
+    z = sqlite3_value_int (argv[2]);
+    x = sqlite3_value_int (argv[3]);
+    y = sqlite3_value_int (argv[4]);
+    if (argc > 5)
+	extent = sqlite3_value_int (argv[5]);
+    if (argc > 6)
+	buffer = sqlite3_value_int (argv[6]);
+
+    if (rl2_vector_tile_blob
+	(sqlite, db_prefix, cvg_name, z, x, y, extent, buffer, &tile,
+	 &tile_size) != RL2_OK)
+	sqlite3_result_null (context);
+    else
+	sqlite3_result_blob (context, tile, tile_size, free);
+}
+
 static void
 fnct_GetMapImageFromWMS (sqlite3_context * context, int argc,
 			 sqlite3_value ** argv)
@@ -10912,8 +12238,9 @@ fnct_GetTileImage (sqlite3_context * context, int argc, sqlite3_value ** argv)
 		      palette = NULL;
 		  }
 		raster =
-		    rl2_raster_decode (RL2_SCALE_1, blob_odd, blob_odd_sz,
-				       blob_even, blob_even_sz, palette);
+		    rl2_raster_decode_dict (RL2_SCALE_1, blob_odd,
+					    blob_odd_sz, blob_even,
+					    blob_even_sz, palette, coverage);
 		if (raster == NULL)
 		  {
 		      fprintf (stderr, ERR_FRMT64, tile_id);
@@ -11266,8 +12593,9 @@ get_triple_band_tile_image (sqlite3_context * context, const char *db_prefix,
 		      blob_even_sz = sqlite3_column_bytes (stmt, 1);
 		  }
 		raster =
-		    rl2_raster_decode (RL2_SCALE_1, blob_odd, blob_odd_sz,
-				       blob_even, blob_even_sz, NULL);
+		    rl2_raster_decode_dict (RL2_SCALE_1, blob_odd,
+					    blob_odd_sz, blob_even,
+					    blob_even_sz, NULL, coverage);
 		if (raster == NULL)
 		  {
 		      fprintf (stderr, ERR_FRMT64, tile_id);
@@ -11576,8 +12904,8 @@ fnct_GetMonoBandTileImage (sqlite3_context * context, int argc,
 }
 
 static void
-common_export_raw_pixels (int by_section, sqlite3_context * context, int argc,
-			  sqlite3_value ** argv)
+do_export_raw_pixels (int by_section, sqlite3_context * context, int argc,
+		      sqlite3_value ** argv)
 {
 /* common implementation Export RAW Pixels */
     int err = 0;
@@ -11811,6 +13139,18 @@ common_export_raw_pixels (int by_section, sqlite3_context * context, int argc,
     sqlite3_result_null (context);
 }
 
+static void
+common_export_raw_pixels (int by_section, sqlite3_context * context, int argc,
+			  sqlite3_value ** argv)
+{
+/* cancellable wrapper for the above */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    do_export_raw_pixels (by_section, context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+}
+
 static void
 fnct_ExportRawPixels (sqlite3_context * context, int argc,
 		      sqlite3_value ** argv)
@@ -12114,6 +13454,160 @@ fnct_ImportSectionRawPixels (sqlite3_context * context, int argc,
     sqlite3_result_int (context, errcode);
 }
 
+static void
+fnct_perf_LoadRaster (sqlite3_context * context, int argc,
+		      sqlite3_value ** argv)
+{
+/* RL2_LoadRaster() - instrumented by the Performance Counters */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_perf_begin_request (priv_data, "RL2_LoadRaster");
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    fnct_LoadRaster (context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+    rl2_perf_end_request (priv_data);
+}
+
+static void
+fnct_perf_LoadRastersFromDir (sqlite3_context * context, int argc,
+			      sqlite3_value ** argv)
+{
+/* RL2_LoadRastersFromDir() - instrumented by the Performance Counters */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_perf_begin_request (priv_data, "RL2_LoadRastersFromDir");
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    fnct_LoadRastersFromDir (context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+    rl2_perf_end_request (priv_data);
+}
+
+static void
+fnct_perf_Pyramidize (sqlite3_context * context, int argc,
+		      sqlite3_value ** argv)
+{
+/* RL2_Pyramidize() - instrumented by the Performance Counters */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_perf_begin_request (priv_data, "RL2_Pyramidize");
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    fnct_Pyramidize (context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+    rl2_perf_end_request (priv_data);
+}
+
+static void
+fnct_perf_PyramidizeMonolithic (sqlite3_context * context, int argc,
+				sqlite3_value ** argv)
+{
+/* RL2_PyramidizeMonolithic() - instrumented by the Performance Counters */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_perf_begin_request (priv_data, "RL2_PyramidizeMonolithic");
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    fnct_PyramidizeMonolithic (context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+    rl2_perf_end_request (priv_data);
+}
+
+static void
+fnct_perf_GetMapImageFromRaster (sqlite3_context * context, int argc,
+				 sqlite3_value ** argv)
+{
+/* RL2_GetMapImageFromRaster() - instrumented by the Performance Counters */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_perf_begin_request (priv_data, "RL2_GetMapImageFromRaster");
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    fnct_GetMapImageFromRaster (context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+    rl2_perf_end_request (priv_data);
+}
+
+static void
+fnct_perf_GetMapImageFromVector (sqlite3_context * context, int argc,
+				 sqlite3_value ** argv)
+{
+/* RL2_GetMapImageFromVector() - instrumented by the Performance Counters */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_perf_begin_request (priv_data, "RL2_GetMapImageFromVector");
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    fnct_GetMapImageFromVector (context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+    rl2_perf_end_request (priv_data);
+}
+
+static void
+fnct_perf_GetVectorTile (sqlite3_context * context, int argc,
+			 sqlite3_value ** argv)
+{
+/* RL2_GetVectorTile() - instrumented by the Performance Counters */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_perf_begin_request (priv_data, "RL2_GetVectorTile");
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    fnct_GetVectorTile (context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+    rl2_perf_end_request (priv_data);
+}
+
+static void
+fnct_perf_GetImageFromMapConfiguration (sqlite3_context * context, int argc,
+					sqlite3_value ** argv)
+{
+/* RL2_GetImageFromMapConfiguration() - instrumented by the Performance Counters */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_perf_begin_request (priv_data, "RL2_GetImageFromMapConfiguration");
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    fnct_GetImageFromMapConfiguration (context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+    rl2_perf_end_request (priv_data);
+}
+
+static void
+fnct_perf_GetTileImage (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
+{
+/* RL2_GetTileImage() - instrumented by the Performance Counters */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_perf_begin_request (priv_data, "RL2_GetTileImage");
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    fnct_GetTileImage (context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+    rl2_perf_end_request (priv_data);
+}
+
+static void
+fnct_perf_GetTripleBandTileImage (sqlite3_context * context, int argc,
+				  sqlite3_value ** argv)
+{
+/* RL2_GetTripleBandTileImage() - instrumented by the Performance Counters */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_perf_begin_request (priv_data, "RL2_GetTripleBandTileImage");
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    fnct_GetTripleBandTileImage (context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+    rl2_perf_end_request (priv_data);
+}
+
+static void
+fnct_perf_GetMonoBandTileImage (sqlite3_context * context, int argc,
+				sqlite3_value ** argv)
+{
+/* RL2_GetMonoBandTileImage() - instrumented by the Performance Counters */
+    const void *priv_data = sqlite3_user_data (context);
+    rl2_perf_begin_request (priv_data, "RL2_GetMonoBandTileImage");
+    rl2_cancel_begin_request (priv_data,
+			      sqlite3_context_db_handle (context));
+    fnct_GetMonoBandTileImage (context, argc, argv);
+    rl2_cancel_end_request (priv_data);
+    rl2_perf_end_request (priv_data);
+}
+
 static void
 register_rl2_sql_functions (void *p_db, const void *p_data)
 {
@@ -12224,6 +13718,44 @@ register_rl2_sql_functions (void *p_db, const void *p_data)
     sqlite3_create_function (db, "RL2_SetMaxThreads", 1,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
 			     fnct_SetMaxThreads, 0, 0);
+    sqlite3_create_function (db, "RL2_GetRequestTimeout", 0, SQLITE_UTF8,
+			     priv_data, fnct_GetRequestTimeout, 0, 0);
+    sqlite3_create_function (db, "RL2_SetRequestTimeout", 1, SQLITE_UTF8,
+			     priv_data, fnct_SetRequestTimeout, 0, 0);
+    sqlite3_create_function (db, "RL2_GetPerfCounters", 0, SQLITE_UTF8,
+			     priv_data, fnct_GetPerfCounters, 0, 0);
+    sqlite3_create_function (db, "RL2_ResetPerfCounters", 0, SQLITE_UTF8,
+			     priv_data, fnct_ResetPerfCounters, 0, 0);
+    sqlite3_create_function (db, "RL2_GetPNGCompression", 0, SQLITE_UTF8,
+			     priv_data, fnct_GetPNGCompression, 0, 0);
+    sqlite3_create_function (db, "RL2_SetPNGCompression", 1, SQLITE_UTF8,
+			     priv_data, fnct_SetPNGCompression, 0, 0);
+    sqlite3_create_function (db, "RL2_GetPNGFilter", 0, SQLITE_UTF8,
+			     priv_data, fnct_GetPNGFilter, 0, 0);
+    sqlite3_create_function (db, "RL2_SetPNGFilter", 1, SQLITE_UTF8,
+			     priv_data, fnct_SetPNGFilter, 0, 0);
+    sqlite3_create_function (db, "RL2_GetPNG8Dithering", 0, SQLITE_UTF8,
+			     priv_data, fnct_GetPNG8Dithering, 0, 0);
+    sqlite3_create_function (db, "RL2_SetPNG8Dithering", 1, SQLITE_UTF8,
+			     priv_data, fnct_SetPNG8Dithering, 0, 0);
+    sqlite3_create_function (db, "RL2_GetPNG8StablePalette", 0, SQLITE_UTF8,
+			     priv_data, fnct_GetPNG8StablePalette, 0, 0);
+    sqlite3_create_function (db, "RL2_SetPNG8StablePalette", 1, SQLITE_UTF8,
+			     priv_data, fnct_SetPNG8StablePalette, 0, 0);
+    sqlite3_create_function (db, "RL2_GetSparseTiles", 0, SQLITE_UTF8,
+			     priv_data, fnct_GetSparseTiles, 0, 0);
+    sqlite3_create_function (db, "RL2_SetSparseTiles", 1, SQLITE_UTF8,
+			     priv_data, fnct_SetSparseTiles, 0, 0);
+    sqlite3_create_function (db, "RL2_GetSectionChecksum", 0, SQLITE_UTF8,
+			     priv_data, fnct_GetSectionChecksum, 0, 0);
+    sqlite3_create_function (db, "RL2_SetSectionChecksum", 1, SQLITE_UTF8,
+			     priv_data, fnct_SetSectionChecksum, 0, 0);
+    sqlite3_create_function (db, "RL2_GetParallelVectorRendering", 0,
+			     SQLITE_UTF8, priv_data,
+			     fnct_GetParallelVectorRendering, 0, 0);
+    sqlite3_create_function (db, "RL2_SetParallelVectorRendering", 1,
+			     SQLITE_UTF8, priv_data,
+			     fnct_SetParallelVectorRendering, 0, 0);
     sqlite3_create_function (db, "RL2_GetMaxWmsRetries", 0,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
 			     fnct_GetMaxWmsRetries, 0, 0);
@@ -12338,6 +13870,16 @@ register_rl2_sql_functions (void *p_db, const void *p_data)
     sqlite3_create_function (db, "RL2_IsValidRasterTile", 5,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
 			     fnct_IsValidRasterTile, 0, 0);
+    sqlite3_create_function (db, "TileHash", 2,
+			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
+			     fnct_TileHash, 0, 0);
+    sqlite3_create_function (db, "RL2_TileHash", 2,
+			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
+			     fnct_TileHash, 0, 0);
+    sqlite3_create_function (db, "TileHash", 4, SQLITE_UTF8, 0,
+			     fnct_TileHash, 0, 0);
+    sqlite3_create_function (db, "RL2_TileHash", 4, SQLITE_UTF8, 0,
+			     fnct_TileHash, 0, 0);
     sqlite3_create_function (db, "CreateRasterCoverage", 10,
 			     SQLITE_UTF8, 0, fnct_CreateRasterCoverage, 0, 0);
     sqlite3_create_function (db, "CreateRasterCoverage", 11,
@@ -12352,6 +13894,8 @@ register_rl2_sql_functions (void *p_db, const void *p_data)
 			     SQLITE_UTF8, 0, fnct_CreateRasterCoverage, 0, 0);
     sqlite3_create_function (db, "CreateRasterCoverage", 21,
 			     SQLITE_UTF8, 0, fnct_CreateRasterCoverage, 0, 0);
+    sqlite3_create_function (db, "CreateRasterCoverage", 22,
+			     SQLITE_UTF8, 0, fnct_CreateRasterCoverage, 0, 0);
     sqlite3_create_function (db, "RL2_CreateRasterCoverage", 10,
 			     SQLITE_UTF8, 0, fnct_CreateRasterCoverage, 0, 0);
     sqlite3_create_function (db, "RL2_CreateRasterCoverage", 11,
@@ -12366,6 +13910,8 @@ register_rl2_sql_functions (void *p_db, const void *p_data)
 			     SQLITE_UTF8, 0, fnct_CreateRasterCoverage, 0, 0);
     sqlite3_create_function (db, "RL2_CreateRasterCoverage", 21,
 			     SQLITE_UTF8, 0, fnct_CreateRasterCoverage, 0, 0);
+    sqlite3_create_function (db, "RL2_CreateRasterCoverage", 22,
+			     SQLITE_UTF8, 0, fnct_CreateRasterCoverage, 0, 0);
     sqlite3_create_function (db, "CopyRasterCoverage", 2,
 			     SQLITE_UTF8, 0, fnct_CopyRasterCoverage, 0, 0);
     sqlite3_create_function (db, "RL2_CopyRasterCoverage", 2,
@@ -12382,6 +13928,14 @@ register_rl2_sql_functions (void *p_db, const void *p_data)
 			     SQLITE_UTF8, 0, fnct_DeleteSection, 0, 0);
     sqlite3_create_function (db, "RL2_DeleteSection", 3,
 			     SQLITE_UTF8, 0, fnct_DeleteSection, 0, 0);
+    sqlite3_create_function (db, "CheckSectionChecksum", 2,
+			     SQLITE_UTF8, 0, fnct_CheckSectionChecksum, 0, 0);
+    sqlite3_create_function (db, "RL2_CheckSectionChecksum", 2,
+			     SQLITE_UTF8, 0, fnct_CheckSectionChecksum, 0, 0);
+    sqlite3_create_function (db, "CheckSectionChecksum", 3,
+			     SQLITE_UTF8, 0, fnct_CheckSectionChecksum, 0, 0);
+    sqlite3_create_function (db, "RL2_CheckSectionChecksum", 3,
+			     SQLITE_UTF8, 0, fnct_CheckSectionChecksum, 0, 0);
     sqlite3_create_function (db, "DropRasterCoverage", 1,
 			     SQLITE_UTF8, 0, fnct_DropRasterCoverage, 0, 0);
     sqlite3_create_function (db, "RL2_DropRasterCoverage", 1,
@@ -12390,6 +13944,38 @@ register_rl2_sql_functions (void *p_db, const void *p_data)
 			     SQLITE_UTF8, 0, fnct_DropRasterCoverage, 0, 0);
     sqlite3_create_function (db, "RL2_DropRasterCoverage", 2,
 			     SQLITE_UTF8, 0, fnct_DropRasterCoverage, 0, 0);
+    sqlite3_create_function (db, "BuildVectorGeneralization", 1,
+			     SQLITE_UTF8, priv_data, fnct_BuildVectorGeneralization, 0, 0);
+    sqlite3_create_function (db, "RL2_BuildVectorGeneralization", 1,
+			     SQLITE_UTF8, priv_data, fnct_BuildVectorGeneralization, 0, 0);
+    sqlite3_create_function (db, "BuildVectorGeneralization", 2,
+			     SQLITE_UTF8, priv_data, fnct_BuildVectorGeneralization, 0, 0);
+    sqlite3_create_function (db, "RL2_BuildVectorGeneralization", 2,
+			     SQLITE_UTF8, priv_data, fnct_BuildVectorGeneralization, 0, 0);
+    sqlite3_create_function (db, "DropVectorGeneralization", 1,
+			     SQLITE_UTF8, 0, fnct_DropVectorGeneralization, 0, 0);
+    sqlite3_create_function (db, "RL2_DropVectorGeneralization", 1,
+			     SQLITE_UTF8, 0, fnct_DropVectorGeneralization, 0, 0);
+    sqlite3_create_function (db, "DropVectorGeneralization", 2,
+			     SQLITE_UTF8, 0, fnct_DropVectorGeneralization, 0, 0);
+    sqlite3_create_function (db, "RL2_DropVectorGeneralization", 2,
+			     SQLITE_UTF8, 0, fnct_DropVectorGeneralization, 0, 0);
+    sqlite3_create_function (db, "BuildTopoFaceCache", 1,
+			     SQLITE_UTF8, 0, fnct_BuildTopoFaceCache, 0, 0);
+    sqlite3_create_function (db, "RL2_BuildTopoFaceCache", 1,
+			     SQLITE_UTF8, 0, fnct_BuildTopoFaceCache, 0, 0);
+    sqlite3_create_function (db, "BuildTopoFaceCache", 2,
+			     SQLITE_UTF8, 0, fnct_BuildTopoFaceCache, 0, 0);
+    sqlite3_create_function (db, "RL2_BuildTopoFaceCache", 2,
+			     SQLITE_UTF8, 0, fnct_BuildTopoFaceCache, 0, 0);
+    sqlite3_create_function (db, "DropTopoFaceCache", 1,
+			     SQLITE_UTF8, 0, fnct_DropTopoFaceCache, 0, 0);
+    sqlite3_create_function (db, "RL2_DropTopoFaceCache", 1,
+			     SQLITE_UTF8, 0, fnct_DropTopoFaceCache, 0, 0);
+    sqlite3_create_function (db, "DropTopoFaceCache", 2,
+			     SQLITE_UTF8, 0, fnct_DropTopoFaceCache, 0, 0);
+    sqlite3_create_function (db, "RL2_DropTopoFaceCache", 2,
+			     SQLITE_UTF8, 0, fnct_DropTopoFaceCache, 0, 0);
     sqlite3_create_function (db, "SetRasterCoverageInfos", 3,
 			     SQLITE_UTF8, 0, fnct_SetRasterCoverageInfos, 0, 0);
     sqlite3_create_function (db, "SetRasterCoverageInfos", 4,
@@ -12647,33 +14233,37 @@ register_rl2_sql_functions (void *p_db, const void *p_data)
 			     fnct_GetBandHistogramFromImage, 0, 0);
     sqlite3_create_function (db, "Pyramidize", 1,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_Pyramidize, 0, 0);
+			     fnct_perf_Pyramidize, 0, 0);
     sqlite3_create_function (db, "RL2_Pyramidize", 1, SQLITE_UTF8, priv_data,
-			     fnct_Pyramidize, 0, 0);
+			     fnct_perf_Pyramidize, 0, 0);
     sqlite3_create_function (db, "Pyramidize", 2, SQLITE_UTF8, priv_data,
-			     fnct_Pyramidize, 0, 0);
+			     fnct_perf_Pyramidize, 0, 0);
     sqlite3_create_function (db, "RL2_Pyramidize", 2, SQLITE_UTF8, priv_data,
-			     fnct_Pyramidize, 0, 0);
+			     fnct_perf_Pyramidize, 0, 0);
     sqlite3_create_function (db, "Pyramidize", 3, SQLITE_UTF8, priv_data,
-			     fnct_Pyramidize, 0, 0);
+			     fnct_perf_Pyramidize, 0, 0);
     sqlite3_create_function (db, "RL2_Pyramidize", 3, SQLITE_UTF8, priv_data,
-			     fnct_Pyramidize, 0, 0);
+			     fnct_perf_Pyramidize, 0, 0);
     sqlite3_create_function (db, "Pyramidize", 4, SQLITE_UTF8, priv_data,
-			     fnct_Pyramidize, 0, 0);
+			     fnct_perf_Pyramidize, 0, 0);
     sqlite3_create_function (db, "RL2_Pyramidize", 4, SQLITE_UTF8, priv_data,
-			     fnct_Pyramidize, 0, 0);
+			     fnct_perf_Pyramidize, 0, 0);
+    sqlite3_create_function (db, "Pyramidize", 5, SQLITE_UTF8, priv_data,
+			     fnct_perf_Pyramidize, 0, 0);
+    sqlite3_create_function (db, "RL2_Pyramidize", 5, SQLITE_UTF8, priv_data,
+			     fnct_perf_Pyramidize, 0, 0);
     sqlite3_create_function (db, "PyramidizeMonolithic", 1, SQLITE_UTF8,
-			     priv_data, fnct_PyramidizeMonolithic, 0, 0);
+			     priv_data, fnct_perf_PyramidizeMonolithic, 0, 0);
     sqlite3_create_function (db, "RL2_PyramidizeMonolithic", 1, SQLITE_UTF8,
-			     priv_data, fnct_PyramidizeMonolithic, 0, 0);
+			     priv_data, fnct_perf_PyramidizeMonolithic, 0, 0);
     sqlite3_create_function (db, "PyramidizeMonolithic", 2, SQLITE_UTF8,
-			     priv_data, fnct_PyramidizeMonolithic, 0, 0);
+			     priv_data, fnct_perf_PyramidizeMonolithic, 0, 0);
     sqlite3_create_function (db, "RL2_PyramidizeMonolithic", 2, SQLITE_UTF8,
-			     priv_data, fnct_PyramidizeMonolithic, 0, 0);
+			     priv_data, fnct_perf_PyramidizeMonolithic, 0, 0);
     sqlite3_create_function (db, "PyramidizeMonolithic", 3, SQLITE_UTF8,
-			     priv_data, fnct_PyramidizeMonolithic, 0, 0);
+			     priv_data, fnct_perf_PyramidizeMonolithic, 0, 0);
     sqlite3_create_function (db, "RL2_PyramidizeMonolithic", 3, SQLITE_UTF8,
-			     priv_data, fnct_PyramidizeMonolithic, 0, 0);
+			     priv_data, fnct_perf_PyramidizeMonolithic, 0, 0);
     sqlite3_create_function (db, "DePyramidize", 1, SQLITE_UTF8, 0,
 			     fnct_DePyramidize, 0, 0);
     sqlite3_create_function (db, "RL2_DePyramidize", 1, SQLITE_UTF8, 0,
@@ -12686,6 +14276,24 @@ register_rl2_sql_functions (void *p_db, const void *p_data)
 			     fnct_DePyramidize, 0, 0);
     sqlite3_create_function (db, "RL2_DePyramidize", 3, SQLITE_UTF8, 0,
 			     fnct_DePyramidize, 0, 0);
+    sqlite3_create_function (db, "TrainCompressionDictionary", 1,
+			     SQLITE_UTF8, 0, fnct_TrainCompressionDictionary,
+			     0, 0);
+    sqlite3_create_function (db, "RL2_TrainCompressionDictionary", 1,
+			     SQLITE_UTF8, 0, fnct_TrainCompressionDictionary,
+			     0, 0);
+    sqlite3_create_function (db, "TrainCompressionDictionary", 2,
+			     SQLITE_UTF8, 0, fnct_TrainCompressionDictionary,
+			     0, 0);
+    sqlite3_create_function (db, "RL2_TrainCompressionDictionary", 2,
+			     SQLITE_UTF8, 0, fnct_TrainCompressionDictionary,
+			     0, 0);
+    sqlite3_create_function (db, "TrainCompressionDictionary", 3,
+			     SQLITE_UTF8, 0, fnct_TrainCompressionDictionary,
+			     0, 0);
+    sqlite3_create_function (db, "RL2_TrainCompressionDictionary", 3,
+			     SQLITE_UTF8, 0, fnct_TrainCompressionDictionary,
+			     0, 0);
     sqlite3_create_function (db, "GetPixelFromRasterByPoint", 4,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
 			     fnct_GetPixelFromRasterByPoint, 0, 0);
@@ -12698,48 +14306,50 @@ register_rl2_sql_functions (void *p_db, const void *p_data)
     sqlite3_create_function (db, "RL2_GetPixelFromRasterByPoint", 5,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
 			     fnct_GetPixelFromRasterByPoint, 0, 0);
+/* the RL2_SamplePoints table-valued function */
+    rl2_register_sample_points (db, priv_data);
     sqlite3_create_function (db, "GetMapImageFromRaster", 5,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromRaster", 5,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "GetMapImageFromRaster", 6,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromRaster", 6,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "GetMapImageFromRaster", 7,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromRaster", 7,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "GetMapImageFromRaster", 8,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromRaster", 8,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "GetMapImageFromRaster", 9,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromRaster", 9,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "GetMapImageFromRaster", 10,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromRaster", 10,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "GetMapImageFromRaster", 11,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromRaster", 11,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromRaster, 0, 0);
+			     fnct_perf_GetMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "GetStyledMapImageFromRaster", 6,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
 			     fnct_GetStyledMapImageFromRaster, 0, 0);
@@ -12778,46 +14388,64 @@ register_rl2_sql_functions (void *p_db, const void *p_data)
 			     fnct_GetStyledMapImageFromRaster, 0, 0);
     sqlite3_create_function (db, "GetMapImageFromVector", 5,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromVector", 5,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
     sqlite3_create_function (db, "GetMapImageFromVector", 6,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromVector", 6,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
     sqlite3_create_function (db, "GetMapImageFromVector", 7,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromVector", 7,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
     sqlite3_create_function (db, "GetMapImageFromVector", 8,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromVector", 8,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
     sqlite3_create_function (db, "GetMapImageFromVector", 9,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromVector", 9,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
     sqlite3_create_function (db, "GetMapImageFromVector", 10,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromVector", 10,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
     sqlite3_create_function (db, "GetMapImageFromVector", 11,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
     sqlite3_create_function (db, "RL2_GetMapImageFromVector", 11,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMapImageFromVector, 0, 0);
+			     fnct_perf_GetMapImageFromVector, 0, 0);
+    sqlite3_create_function (db, "GetVectorTile", 5,
+			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
+			     fnct_perf_GetVectorTile, 0, 0);
+    sqlite3_create_function (db, "RL2_GetVectorTile", 5,
+			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
+			     fnct_perf_GetVectorTile, 0, 0);
+    sqlite3_create_function (db, "GetVectorTile", 6,
+			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
+			     fnct_perf_GetVectorTile, 0, 0);
+    sqlite3_create_function (db, "RL2_GetVectorTile", 6,
+			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
+			     fnct_perf_GetVectorTile, 0, 0);
+    sqlite3_create_function (db, "GetVectorTile", 7,
+			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
+			     fnct_perf_GetVectorTile, 0, 0);
+    sqlite3_create_function (db, "RL2_GetVectorTile", 7,
+			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
+			     fnct_perf_GetVectorTile, 0, 0);
     sqlite3_create_function (db, "GetStyledMapImageFromVector", 6,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
 			     fnct_GetStyledMapImageFromVector, 0, 0);
@@ -12868,28 +14496,28 @@ register_rl2_sql_functions (void *p_db, const void *p_data)
 			     fnct_GetMapImageFromWMS, 0, 0);
     sqlite3_create_function (db, "GetImageFromMapConfiguration", 4,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetImageFromMapConfiguration, 0, 0);
+			     fnct_perf_GetImageFromMapConfiguration, 0, 0);
     sqlite3_create_function (db, "RL2_GetImageFromMapConfiguration", 4,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetImageFromMapConfiguration, 0, 0);
+			     fnct_perf_GetImageFromMapConfiguration, 0, 0);
     sqlite3_create_function (db, "GetImageFromMapConfiguration", 5,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetImageFromMapConfiguration, 0, 0);
+			     fnct_perf_GetImageFromMapConfiguration, 0, 0);
     sqlite3_create_function (db, "RL2_GetImageFromMapConfiguration", 5,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetImageFromMapConfiguration, 0, 0);
+			     fnct_perf_GetImageFromMapConfiguration, 0, 0);
     sqlite3_create_function (db, "GetImageFromMapConfiguration", 6,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetImageFromMapConfiguration, 0, 0);
+			     fnct_perf_GetImageFromMapConfiguration, 0, 0);
     sqlite3_create_function (db, "RL2_GetImageFromMapConfiguration", 6,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetImageFromMapConfiguration, 0, 0);
+			     fnct_perf_GetImageFromMapConfiguration, 0, 0);
     sqlite3_create_function (db, "GetImageFromMapConfiguration", 7,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetImageFromMapConfiguration, 0, 0);
+			     fnct_perf_GetImageFromMapConfiguration, 0, 0);
     sqlite3_create_function (db, "RL2_GetImageFromMapConfiguration", 7,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetImageFromMapConfiguration, 0, 0);
+			     fnct_perf_GetImageFromMapConfiguration, 0, 0);
     sqlite3_create_function (db, "GetRasterLegendGraphic", 12,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
 			     fnct_GetRasterLegendGraphic, 0, 0);
@@ -12904,46 +14532,46 @@ register_rl2_sql_functions (void *p_db, const void *p_data)
 			     fnct_GetVectorLegendGraphic, 0, 0);
     sqlite3_create_function (db, "GetTileImage", 3,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetTileImage, 0, 0);
+			     fnct_perf_GetTileImage, 0, 0);
     sqlite3_create_function (db, "RL2_GetTileImage", 3,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetTileImage, 0, 0);
+			     fnct_perf_GetTileImage, 0, 0);
     sqlite3_create_function (db, "GetTripleBandTileImage", 6,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetTripleBandTileImage, 0, 0);
+			     fnct_perf_GetTripleBandTileImage, 0, 0);
     sqlite3_create_function (db, "RL2_GetTripleBandTileImage", 6,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetTripleBandTileImage, 0, 0);
+			     fnct_perf_GetTripleBandTileImage, 0, 0);
     sqlite3_create_function (db, "GetTripleBandTileImage", 7,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetTripleBandTileImage, 0, 0);
+			     fnct_perf_GetTripleBandTileImage, 0, 0);
     sqlite3_create_function (db, "RL2_GetTripleBandTileImage", 7,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetTripleBandTileImage, 0, 0);
+			     fnct_perf_GetTripleBandTileImage, 0, 0);
     sqlite3_create_function (db, "GetTripleBandTileImage", 8,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetTripleBandTileImage, 0, 0);
+			     fnct_perf_GetTripleBandTileImage, 0, 0);
     sqlite3_create_function (db, "RL2_GetTripleBandTileImage", 8,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetTripleBandTileImage, 0, 0);
+			     fnct_perf_GetTripleBandTileImage, 0, 0);
     sqlite3_create_function (db, "GetMonoBandTileImage", 4,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMonoBandTileImage, 0, 0);
+			     fnct_perf_GetMonoBandTileImage, 0, 0);
     sqlite3_create_function (db, "RL2_GetMonoBandTileImage", 4,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMonoBandTileImage, 0, 0);
+			     fnct_perf_GetMonoBandTileImage, 0, 0);
     sqlite3_create_function (db, "GetMonoBandTileImage", 5,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMonoBandTileImage, 0, 0);
+			     fnct_perf_GetMonoBandTileImage, 0, 0);
     sqlite3_create_function (db, "RL2_GetMonoBandTileImage", 5,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMonoBandTileImage, 0, 0);
+			     fnct_perf_GetMonoBandTileImage, 0, 0);
     sqlite3_create_function (db, "GetMonoBandTileImage", 6,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMonoBandTileImage, 0, 0);
+			     fnct_perf_GetMonoBandTileImage, 0, 0);
     sqlite3_create_function (db, "RL2_GetMonoBandTileImage", 6,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
-			     fnct_GetMonoBandTileImage, 0, 0);
+			     fnct_perf_GetMonoBandTileImage, 0, 0);
     sqlite3_create_function (db, "ExportRawPixels", 6,
 			     SQLITE_UTF8 | SQLITE_DETERMINISTIC, priv_data,
 			     fnct_ExportRawPixels, 0, 0);
@@ -13070,55 +14698,61 @@ register_rl2_sql_functions (void *p_db, const void *p_data)
 	  sqlite3_create_function (db, "RL2_ExportFontToFile", 3, SQLITE_UTF8,
 				   0, fnct_ExportFontToFile, 0, 0);
 	  sqlite3_create_function (db, "LoadRaster", 2, SQLITE_UTF8,
-				   priv_data, fnct_LoadRaster, 0, 0);
+				   priv_data, fnct_perf_LoadRaster, 0, 0);
 	  sqlite3_create_function (db, "LoadRaster", 3, SQLITE_UTF8,
-				   priv_data, fnct_LoadRaster, 0, 0);
+				   priv_data, fnct_perf_LoadRaster, 0, 0);
 	  sqlite3_create_function (db, "LoadRaster", 4, SQLITE_UTF8,
-				   priv_data, fnct_LoadRaster, 0, 0);
+				   priv_data, fnct_perf_LoadRaster, 0, 0);
 	  sqlite3_create_function (db, "LoadRaster", 5, SQLITE_UTF8,
-				   priv_data, fnct_LoadRaster, 0, 0);
+				   priv_data, fnct_perf_LoadRaster, 0, 0);
 	  sqlite3_create_function (db, "LoadRaster", 6, SQLITE_UTF8,
-				   priv_data, fnct_LoadRaster, 0, 0);
+				   priv_data, fnct_perf_LoadRaster, 0, 0);
 	  sqlite3_create_function (db, "RL2_LoadRaster", 2, SQLITE_UTF8,
-				   priv_data, fnct_LoadRaster, 0, 0);
+				   priv_data, fnct_perf_LoadRaster, 0, 0);
 	  sqlite3_create_function (db, "RL2_LoadRaster", 3, SQLITE_UTF8,
-				   priv_data, fnct_LoadRaster, 0, 0);
+				   priv_data, fnct_perf_LoadRaster, 0, 0);
 	  sqlite3_create_function (db, "RL2_LoadRaster", 4, SQLITE_UTF8,
-				   priv_data, fnct_LoadRaster, 0, 0);
+				   priv_data, fnct_perf_LoadRaster, 0, 0);
 	  sqlite3_create_function (db, "RL2_LoadRaster", 5, SQLITE_UTF8,
-				   priv_data, fnct_LoadRaster, 0, 0);
+				   priv_data, fnct_perf_LoadRaster, 0, 0);
 	  sqlite3_create_function (db, "RL2_LoadRaster", 6, SQLITE_UTF8,
-				   priv_data, fnct_LoadRaster, 0, 0);
+				   priv_data, fnct_perf_LoadRaster, 0, 0);
 	  sqlite3_create_function (db, "LoadRastersFromDir", 2, SQLITE_UTF8,
-				   priv_data, fnct_LoadRastersFromDir, 0, 0);
+				   priv_data, fnct_perf_LoadRastersFromDir, 0,
+				   0);
 	  sqlite3_create_function (db, "LoadRastersFromDir", 3, SQLITE_UTF8,
-				   priv_data, fnct_LoadRastersFromDir, 0, 0);
+				   priv_data, fnct_perf_LoadRastersFromDir, 0,
+				   0);
 	  sqlite3_create_function (db, "LoadRastersFromDir", 4, SQLITE_UTF8,
-				   priv_data, fnct_LoadRastersFromDir, 0, 0);
+				   priv_data, fnct_perf_LoadRastersFromDir, 0,
+				   0);
 	  sqlite3_create_function (db, "LoadRastersFromDir", 5, SQLITE_UTF8,
-				   priv_data, fnct_LoadRastersFromDir, 0, 0);
+				   priv_data, fnct_perf_LoadRastersFromDir, 0,
+				   0);
 	  sqlite3_create_function (db, "LoadRastersFromDir", 6, SQLITE_UTF8,
-				   priv_data, fnct_LoadRastersFromDir, 0, 0);
+				   priv_data, fnct_perf_LoadRastersFromDir, 0,
+				   0);
 	  sqlite3_create_function (db, "LoadRastersFromDir", 7, SQLITE_UTF8,
-				   priv_data, fnct_LoadRastersFromDir, 0, 0);
+				   priv_data, fnct_perf_LoadRastersFromDir, 0,
+				   0);
 	  sqlite3_create_function (db, "RL2_LoadRastersFromDir", 2,
 				   SQLITE_UTF8, priv_data,
-				   fnct_LoadRastersFromDir, 0, 0);
+				   fnct_perf_LoadRastersFromDir, 0, 0);
 	  sqlite3_create_function (db, "RL2_LoadRastersFromDir", 3,
 				   SQLITE_UTF8, priv_data,
-				   fnct_LoadRastersFromDir, 0, 0);
+				   fnct_perf_LoadRastersFromDir, 0, 0);
 	  sqlite3_create_function (db, "RL2_LoadRastersFromDir", 4,
 				   SQLITE_UTF8, priv_data,
-				   fnct_LoadRastersFromDir, 0, 0);
+				   fnct_perf_LoadRastersFromDir, 0, 0);
 	  sqlite3_create_function (db, "RL2_LoadRastersFromDir", 5,
 				   SQLITE_UTF8, priv_data,
-				   fnct_LoadRastersFromDir, 0, 0);
+				   fnct_perf_LoadRastersFromDir, 0, 0);
 	  sqlite3_create_function (db, "RL2_LoadRastersFromDir", 6,
 				   SQLITE_UTF8, priv_data,
-				   fnct_LoadRastersFromDir, 0, 0);
+				   fnct_perf_LoadRastersFromDir, 0, 0);
 	  sqlite3_create_function (db, "RL2_LoadRastersFromDir", 7,
 				   SQLITE_UTF8, priv_data,
-				   fnct_LoadRastersFromDir, 0, 0);
+				   fnct_perf_LoadRastersFromDir, 0, 0);
 	  sqlite3_create_function (db, "LoadRasterFromWMS", 9, SQLITE_UTF8,
 				   priv_data, fnct_LoadRasterFromWMS, 0, 0);
 	  sqlite3_create_function (db, "RL2_LoadRasterFromWMS", 9,
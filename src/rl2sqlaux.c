@@ -1080,15 +1080,15 @@ get_section_name (const char *src_path)
     return name;
 }
 
-RL2_DECLARE char *
-rl2_compute_file_md5_checksum (const char *src_path)
+RL2_PRIVATE char *
+rl2_compute_file_checksum (const char *src_path, unsigned char algorithm)
 {
-/* attempting to compute an MD5 checksum from a file */
+/* attempting to compute an MD5 or XXH64 checksum from a file */
     size_t rd;
     size_t blk = 1024 * 1024;
     unsigned char *buf;
-    void *p_md5;
-    char *md5;
+    void *p_sum;
+    char *checksum;
 #ifdef _WIN32
     FILE *in = rl2_win_fopen (src_path, "rb");
 #else
@@ -1097,19 +1097,40 @@ rl2_compute_file_md5_checksum (const char *src_path)
     if (in == NULL)
 	return NULL;
     buf = malloc (blk);
-    p_md5 = rl2_CreateMD5Checksum ();
+    if (algorithm == RL2_CHECKSUM_XXH64)
+	p_sum = rl2_CreateXXH64Checksum ();
+    else
+	p_sum = rl2_CreateMD5Checksum ();
     while (1)
       {
 	  rd = fread (buf, 1, blk, in);
 	  if (rd == 0)
 	      break;
-	  rl2_UpdateMD5Checksum (p_md5, buf, rd);
+	  if (algorithm == RL2_CHECKSUM_XXH64)
+	      rl2_UpdateXXH64Checksum (p_sum, buf, rd);
+	  else
+	      rl2_UpdateMD5Checksum (p_sum, buf, rd);
       }
     free (buf);
     fclose (in);
-    md5 = rl2_FinalizeMD5Checksum (p_md5);
-    rl2_FreeMD5Checksum (p_md5);
-    return md5;
+    if (algorithm == RL2_CHECKSUM_XXH64)
+      {
+	  checksum = rl2_FinalizeXXH64Checksum (p_sum);
+	  rl2_FreeXXH64Checksum (p_sum);
+      }
+    else
+      {
+	  checksum = rl2_FinalizeMD5Checksum (p_sum);
+	  rl2_FreeMD5Checksum (p_sum);
+      }
+    return checksum;
+}
+
+RL2_DECLARE char *
+rl2_compute_file_md5_checksum (const char *src_path)
+{
+/* attempting to compute an MD5 checksum from a file */
+    return rl2_compute_file_checksum (src_path, RL2_CHECKSUM_MD5);
 }
 
 RL2_PRIVATE int
@@ -1122,6 +1143,24 @@ rl2_do_insert_section (sqlite3 * handle, const char *src_path,
 		       sqlite3_int64 * id)
 {
 /* INSERTing the section */
+    char *md5 = NULL;
+    if (section_md5)
+	md5 = rl2_compute_file_md5_checksum (src_path);
+    return rl2_do_insert_section_md5 (handle, src_path, section, srid, width,
+				      height, minx, miny, maxx, maxy,
+				      xml_summary, section_paths, md5,
+				      section_summary, stmt_sect, id);
+}
+
+RL2_PRIVATE int
+rl2_do_insert_section_md5 (sqlite3 * handle, const char *src_path,
+			   const char *section, int srid, unsigned int width,
+			   unsigned int height, double minx, double miny,
+			   double maxx, double maxy, char *xml_summary,
+			   int section_paths, char *md5, int section_summary,
+			   sqlite3_stmt * stmt_sect, sqlite3_int64 * id)
+{
+/* INSERTing the section - MD5 checksum already computed (may be NULL) */
     int ret;
     unsigned char *blob;
     int blob_size;
@@ -1144,16 +1183,10 @@ rl2_do_insert_section (sqlite3 * handle, const char *src_path,
 			   SQLITE_STATIC);
     else
 	sqlite3_bind_null (stmt_sect, 2);
-    if (section_md5)
-      {
-	  char *md5 = rl2_compute_file_md5_checksum (src_path);
-	  if (md5 == NULL)
-	      sqlite3_bind_null (stmt_sect, 3);
-	  else
-	      sqlite3_bind_text (stmt_sect, 3, md5, strlen (md5), free);
-      }
-    else
+    if (md5 == NULL)
 	sqlite3_bind_null (stmt_sect, 3);
+    else
+	sqlite3_bind_text (stmt_sect, 3, md5, strlen (md5), free);
     if (section_summary)
       {
 	  if (xml_summary == NULL)
@@ -1479,6 +1512,66 @@ add_base_resolution (ResolutionsListPtr list, int level, int scale,
     list->last = res;
 }
 
+static int
+select_best_resolution_level (ResolutionsListPtr list, double x_res,
+			      double y_res, int *level_id, int *scale,
+			      int *real_scale, double *xx_res, double *yy_res)
+{
+/* selecting the optimal resolution level from the candidates list */
+    int found = 0;
+    int z_level = 0;
+    int z_scale = 0;
+    int z_real = 0;
+    double z_x_res = 0.0;
+    double z_y_res = 0.0;
+    ResolutionLevelPtr res;
+
+/* adjusting real scale factors */
+    z_real = 1;
+    res = list->last;
+    while (res != NULL)
+      {
+	  res->real_scale = z_real;
+	  z_real *= 2;
+	  res = res->prev;
+      }
+/* retrieving the best resolution level */
+    found = 0;
+    res = list->last;
+    while (res != NULL)
+      {
+	  if (res->x_resolution <= x_res && res->y_resolution <= y_res)
+	    {
+		found = 1;
+		z_level = res->level;
+		z_scale = res->scale;
+		z_real = res->real_scale;
+		z_x_res = res->x_resolution;
+		z_y_res = res->y_resolution;
+	    }
+	  res = res->prev;
+      }
+    if (found)
+      {
+	  *level_id = z_level;
+	  *scale = z_scale;
+	  *real_scale = z_real;
+	  *xx_res = z_x_res;
+	  *yy_res = z_y_res;
+      }
+    else if (list->last != NULL)
+      {
+	  res = list->last;
+	  *level_id = res->level;
+	  *scale = res->scale;
+	  *xx_res = res->x_resolution;
+	  *yy_res = res->y_resolution;
+      }
+    else
+	return 0;
+    return 1;
+}
+
 RL2_PRIVATE int
 rl2_find_best_resolution_level (sqlite3 * handle, const char *db_prefix,
 				const char *coverage, int by_section,
@@ -1488,10 +1581,6 @@ rl2_find_best_resolution_level (sqlite3 * handle, const char *db_prefix,
 {
 /* attempting to identify the optimal resolution level */
     int ret;
-    int found = 0;
-    int z_level = 0;
-    int z_scale = 0;
-    int z_real = 0;
     double z_x_res = 0.0;
     double z_y_res = 0.0;
     char *xcoverage;
@@ -1499,7 +1588,6 @@ rl2_find_best_resolution_level (sqlite3 * handle, const char *db_prefix,
     char *sql;
     sqlite3_stmt *stmt = NULL;
     ResolutionsListPtr list = NULL;
-    ResolutionLevelPtr res;
     char *xdb_prefix;
 
     if (coverage == NULL)
@@ -1606,49 +1694,11 @@ rl2_find_best_resolution_level (sqlite3 * handle, const char *db_prefix,
 	    }
       }
     sqlite3_finalize (stmt);
+    stmt = NULL;
 
-/* adjusting real scale factors */
-    z_real = 1;
-    res = list->last;
-    while (res != NULL)
-      {
-	  res->real_scale = z_real;
-	  z_real *= 2;
-	  res = res->prev;
-      }
 /* retrieving the best resolution level */
-    found = 0;
-    res = list->last;
-    while (res != NULL)
-      {
-	  if (res->x_resolution <= x_res && res->y_resolution <= y_res)
-	    {
-		found = 1;
-		z_level = res->level;
-		z_scale = res->scale;
-		z_real = res->real_scale;
-		z_x_res = res->x_resolution;
-		z_y_res = res->y_resolution;
-	    }
-	  res = res->prev;
-      }
-    if (found)
-      {
-	  *level_id = z_level;
-	  *scale = z_scale;
-	  *real_scale = z_real;
-	  *xx_res = z_x_res;
-	  *yy_res = z_y_res;
-      }
-    else if (list->last != NULL)
-      {
-	  res = list->last;
-	  *level_id = res->level;
-	  *scale = res->scale;
-	  *xx_res = res->x_resolution;
-	  *yy_res = res->y_resolution;
-      }
-    else
+    if (!select_best_resolution_level
+	(list, x_res, y_res, level_id, scale, real_scale, xx_res, yy_res))
 	goto error;
     destroy_resolutions_list (list);
     return 1;
@@ -1661,6 +1711,50 @@ rl2_find_best_resolution_level (sqlite3 * handle, const char *db_prefix,
     return 0;
 }
 
+RL2_PRIVATE int
+rl2_find_cached_best_resolution_level (rl2CoveragePtr ptr, double x_res,
+				       double y_res, int *level_id, int *scale,
+				       int *real_scale, double *xx_res,
+				       double *yy_res)
+{
+/* identifying the optimal resolution level - Metadata Cache */
+    rl2PrivCoveragePtr cvg = (rl2PrivCoveragePtr) ptr;
+    struct rl2_cached_coverage *entry;
+    ResolutionsListPtr list = NULL;
+    int i;
+    int ok;
+
+    if (cvg == NULL)
+	return 0;
+    entry = cvg->cached;
+    if (entry == NULL || entry->mixed_resolutions)
+	return 0;
+
+    list = alloc_resolutions_list ();
+    if (list == NULL)
+	return 0;
+    for (i = 0; i < entry->num_levels; i++)
+      {
+	  struct rl2_cached_level *lvl = entry->levels + i;
+	  if (lvl->valid & 8)
+	      add_base_resolution (list, lvl->level, RL2_SCALE_8,
+				   lvl->x_res[3], lvl->y_res[3]);
+	  if (lvl->valid & 4)
+	      add_base_resolution (list, lvl->level, RL2_SCALE_4,
+				   lvl->x_res[2], lvl->y_res[2]);
+	  if (lvl->valid & 2)
+	      add_base_resolution (list, lvl->level, RL2_SCALE_2,
+				   lvl->x_res[1], lvl->y_res[1]);
+	  if (lvl->valid & 1)
+	      add_base_resolution (list, lvl->level, RL2_SCALE_1,
+				   lvl->x_res[0], lvl->y_res[0]);
+      }
+    ok = select_best_resolution_level (list, x_res, y_res, level_id, scale,
+				       real_scale, xx_res, yy_res);
+    destroy_resolutions_list (list);
+    return ok;
+}
+
 RL2_PRIVATE unsigned char
 get_palette_format (rl2PrivPalettePtr plt)
 {
@@ -4966,8 +5060,8 @@ get_payload_from_rgb_rgba_opaque (unsigned int width, unsigned int height,
 	  /* converting from TrueColor to PaletteBased */
 	  unsigned char *pixbuf;
 	  rl2PalettePtr palette;
-	  if (rl2_quantize_color (width, height, rgb, 256, &pixbuf, &palette) !=
-	      RL2_OK)
+	  if (rl2_quantize_map_image
+	      (priv_data, width, height, rgb, &pixbuf, &palette) != RL2_OK)
 	      goto error;
 	  if (pixbuf == NULL || palette == NULL)
 	    {
@@ -4992,8 +5086,8 @@ get_payload_from_rgb_rgba_opaque (unsigned int width, unsigned int height,
 	  unsigned char *pixbuf;
 	  rl2PalettePtr palette;
 	  rl2PrivPalettePtr plt;
-	  if (rl2_quantize_color (width, height, rgb, 256, &pixbuf, &palette) !=
-	      RL2_OK)
+	  if (rl2_quantize_map_image
+	      (priv_data, width, height, rgb, &pixbuf, &palette) != RL2_OK)
 	      goto error;
 	  if (pixbuf == NULL || palette == NULL)
 	    {
@@ -5040,8 +5134,8 @@ get_payload_from_rgb_rgba_opaque (unsigned int width, unsigned int height,
 	  /* converting from TrueColor to PaletteBased */
 	  unsigned char *pixbuf;
 	  rl2PalettePtr palette;
-	  if (rl2_quantize_color (width, height, rgb, 256, &pixbuf, &palette) !=
-	      RL2_OK)
+	  if (rl2_quantize_map_image
+	      (priv_data, width, height, rgb, &pixbuf, &palette) != RL2_OK)
 	      goto error;
 	  if (pixbuf == NULL || palette == NULL)
 	    {
@@ -6831,6 +6925,9 @@ do_paint_map_from_raster (struct aux_raster_render *args)
     int by_section = 0;
     int reproject_on_the_fly = 0;
     rl2PixelPtr no_data;
+    int cached_cvg = 0;
+    int cached_stl = 0;
+    int cached_stats = 0;
 
     sqlite = args->sqlite;
     data = args->data;
@@ -6955,8 +7052,13 @@ do_paint_map_from_raster (struct aux_raster_render *args)
     if (ext_x <= 0.0 || ext_y <= 0.0)
 	goto error;
 
-/* attempting to load the Coverage definitions from the DBMS */
-    coverage = rl2_create_coverage_from_dbms (sqlite, db_prefix, cvg_name);
+/* attempting to load the Coverage definitions (Metadata Cache or DBMS) */
+    coverage = rl2_get_cached_coverage (data, sqlite, db_prefix, cvg_name);
+    if (coverage != NULL)
+	cached_cvg = 1;
+    else
+	coverage =
+	    rl2_create_coverage_from_dbms (sqlite, db_prefix, cvg_name);
     if (coverage == NULL)
 	goto error;
     if (rl2_get_coverage_srid (coverage, &srid) != RL2_OK)
@@ -7044,9 +7146,15 @@ do_paint_map_from_raster (struct aux_raster_render *args)
 		    goto error;
 		goto done;
 	    }
-	  stats =
-	      rl2_create_raster_statistics_from_dbms (sqlite, db_prefix,
-						      cvg_name);
+	  if (cached_cvg)
+	    {
+		stats = rl2_get_cached_raster_statistics (sqlite, coverage);
+		cached_stats = 1;
+	    }
+	  else
+	      stats =
+		  rl2_create_raster_statistics_from_dbms (sqlite, db_prefix,
+							  cvg_name);
 	  if (stats == NULL)
 	      goto error;
 	  ok_style = 1;
@@ -7060,9 +7168,18 @@ do_paint_map_from_raster (struct aux_raster_render *args)
 	  else
 	    {
 		/* attempting to get a Coverage Style */
-		cvg_stl =
-		    rl2_create_coverage_style_from_dbms (sqlite, db_prefix,
-							 cvg_name, style_name);
+		if (cached_cvg)
+		  {
+		      cvg_stl =
+			  rl2_get_cached_coverage_style (sqlite, coverage,
+							 style_name);
+		      cached_stl = 1;
+		  }
+		else
+		    cvg_stl =
+			rl2_create_coverage_style_from_dbms (sqlite, db_prefix,
+							     cvg_name,
+							     style_name);
 		if (cvg_stl == NULL)
 		    goto error;
 		symbolizer =
@@ -7076,9 +7193,17 @@ do_paint_map_from_raster (struct aux_raster_render *args)
 			  goto error;
 		      goto done;
 		  }
-		stats =
-		    rl2_create_raster_statistics_from_dbms (sqlite, db_prefix,
-							    cvg_name);
+		if (cached_cvg)
+		  {
+		      stats =
+			  rl2_get_cached_raster_statistics (sqlite, coverage);
+		      cached_stats = 1;
+		  }
+		else
+		    stats =
+			rl2_create_raster_statistics_from_dbms (sqlite,
+								db_prefix,
+								cvg_name);
 		if (stats == NULL)
 		    goto error;
 		ok_style = 1;
@@ -7139,10 +7264,18 @@ do_paint_map_from_raster (struct aux_raster_render *args)
 		symbolizer = (rl2RasterSymbolizerPtr) symb;
 		if (stats == NULL)
 		  {
-		      stats =
-			  rl2_create_raster_statistics_from_dbms (sqlite,
-								  db_prefix,
-								  cvg_name);
+		      if (cached_cvg)
+			{
+			    stats =
+				rl2_get_cached_raster_statistics (sqlite,
+								  coverage);
+			    cached_stats = 1;
+			}
+		      else
+			  stats =
+			      rl2_create_raster_statistics_from_dbms (sqlite,
+								      db_prefix,
+								      cvg_name);
 		      if (stats == NULL)
 			  goto error;
 		  }
@@ -7170,10 +7303,17 @@ do_paint_map_from_raster (struct aux_raster_render *args)
 	  symbolizer = (rl2RasterSymbolizerPtr) symb;
 	  if (stats == NULL)
 	    {
-		stats =
-		    rl2_create_raster_statistics_from_dbms (sqlite,
-							    db_prefix,
-							    cvg_name);
+		if (cached_cvg)
+		  {
+		      stats =
+			  rl2_get_cached_raster_statistics (sqlite, coverage);
+		      cached_stats = 1;
+		  }
+		else
+		    stats =
+			rl2_create_raster_statistics_from_dbms (sqlite,
+								db_prefix,
+								cvg_name);
 		if (stats == NULL)
 		    goto error;
 	    }
@@ -7235,17 +7375,28 @@ do_paint_map_from_raster (struct aux_raster_render *args)
 	  goto error;
       }
 
-    if (rl2_is_mixed_resolutions_coverage (sqlite, db_prefix, cvg_name) > 0)
+    if (cached_cvg)
+	by_section = cvg->cached->mixed_resolutions;
+    else if (rl2_is_mixed_resolutions_coverage (sqlite, db_prefix, cvg_name)
+	     > 0)
+	by_section = 1;
+    if (by_section)
       {
 	  /* Mixed Resolutions Coverage */
-	  by_section = 1;
 	  xx_res = x_res;
 	  yy_res = y_res;
       }
+    else if (cached_cvg)
+      {
+	  /* ordinary Coverage - retrieving the optimal resolution level */
+	  if (!rl2_find_cached_best_resolution_level
+	      (coverage, x_res, y_res, &level_id, &scale, &xscale, &xx_res,
+	       &yy_res))
+	      goto error;
+      }
     else
       {
 	  /* ordinary Coverage */
-	  by_section = 0;
 	  /* retrieving the optimal resolution level */
 	  if (!rl2_find_best_resolution_level
 	      (sqlite, db_prefix, cvg_name, 0, 0, x_res, y_res, &level_id,
@@ -7316,7 +7467,7 @@ do_paint_map_from_raster (struct aux_raster_render *args)
     aux.coverage = coverage;
     aux.symbolizer = symbolizer;
     aux.stats = stats;
-    aux.cvg_stl = cvg_stl;
+    aux.cvg_stl = cached_stl ? NULL : cvg_stl;
     aux.level_id = level_id;
     aux.scale = scale;
     aux.outbuf = NULL;
@@ -7338,10 +7489,12 @@ do_paint_map_from_raster (struct aux_raster_render *args)
 
     if (!do_get_raw_raster_data (&aux, by_section))
       {
-	  cvg_stl = aux.cvg_stl;
+	  if (!cached_stl)
+	      cvg_stl = aux.cvg_stl;
 	  goto error;
       }
-    cvg_stl = aux.cvg_stl;
+    if (!cached_stl)
+	cvg_stl = aux.cvg_stl;
     if (rl2_aux_render_image (&aux) != RL2_OK)
 	goto error;
 
@@ -7354,30 +7507,35 @@ do_paint_map_from_raster (struct aux_raster_render *args)
 		args->output->img_size = aux.image_size;
 	    }
       }
-    rl2_destroy_coverage (coverage);
+    if (!cached_cvg)
+	rl2_destroy_coverage (coverage);
     if (palette != NULL)
 	rl2_destroy_palette (palette);
-    if (cvg_stl != NULL)
+    if (cvg_stl != NULL && !cached_stl)
 	rl2_destroy_coverage_style (cvg_stl);
-    if (stats != NULL)
+    if (stats != NULL && !cached_stats)
 	rl2_destroy_raster_statistics (stats);
     if (aux_symbolizer && symbolizer)
 	rl2_destroy_raster_symbolizer ((rl2PrivRasterSymbolizerPtr) symbolizer);
     if (args->is_map_canvas == 0)
 	do_set_canvas_ready (canvas, RL2_CANVAS_BASE_CTX);
+    if (cached_cvg)
+	rl2_sync_metadata_cache (data, sqlite);
     return RL2_OK;
 
   error:
-    if (coverage != NULL)
+    if (coverage != NULL && !cached_cvg)
 	rl2_destroy_coverage (coverage);
     if (palette != NULL)
 	rl2_destroy_palette (palette);
-    if (cvg_stl != NULL)
+    if (cvg_stl != NULL && !cached_stl)
 	rl2_destroy_coverage_style (cvg_stl);
-    if (stats != NULL)
+    if (stats != NULL && !cached_stats)
 	rl2_destroy_raster_statistics (stats);
     if (aux_symbolizer && symbolizer)
 	rl2_destroy_raster_symbolizer ((rl2PrivRasterSymbolizerPtr) symbolizer);
+    if (cached_cvg)
+	rl2_sync_metadata_cache (data, sqlite);
     if (args->output != NULL)
       {
 	  args->output->img = NULL;
@@ -7539,6 +7697,7 @@ rl2_map_image_blob_from_raster (sqlite3 * sqlite, const void *data,
 				unsigned char **img, int *img_size)
 {
 /* rendering a Map Image from a Raster Coverage - BLOB */
+    int ret;
     unsigned char bg_red = 0;
     unsigned char bg_green = 0;
     unsigned char bg_blue = 0;
@@ -7614,7 +7773,11 @@ rl2_map_image_blob_from_raster (sqlite3 * sqlite, const void *data,
 /* priming the background */
     rl2_prime_background (ctx, bg_red, bg_green, bg_blue, bg_alpha);
 
-    if (do_paint_map_from_raster (&aux) == RL2_OK)
+/* encoding the output image accordingly to the current PNG options */
+    rl2_png_begin_request (data, sqlite, db_prefix, cvg_name, style_name);
+    ret = do_paint_map_from_raster (&aux);
+    rl2_png_end_request ();
+    if (ret == RL2_OK)
       {
 	  *img = aux.output->img;
 	  *img_size = aux.output->img_size;
@@ -7649,6 +7812,7 @@ rl2_styled_map_image_blob_from_raster (sqlite3 * sqlite, const void *data,
 				       int *img_size)
 {
 /* rendering a Map Image from a Raster Coverage - BLOB */
+    int ret;
     unsigned char bg_red = 0;
     unsigned char bg_green = 0;
     unsigned char bg_blue = 0;
@@ -7722,7 +7886,11 @@ rl2_styled_map_image_blob_from_raster (sqlite3 * sqlite, const void *data,
 /* priming the background */
     rl2_prime_background (ctx, bg_red, bg_green, bg_blue, bg_alpha);
 
-    if (do_paint_map_from_raster (&aux) == RL2_OK)
+/* encoding the output image accordingly to the current PNG options */
+    rl2_png_begin_request (data, sqlite, db_prefix, NULL, NULL);
+    ret = do_paint_map_from_raster (&aux);
+    rl2_png_end_request ();
+    if (ret == RL2_OK)
       {
 	  *img = aux.output->img;
 	  *img_size = aux.output->img_size;
@@ -7980,8 +8148,6 @@ rl2_pixel_from_raster_by_point (sqlite3 * sqlite, const void *data,
 
 /* retrieving the NO-DATA pixel */
     xpixel = rl2_clone_pixel (rl2_get_coverage_no_data (coverage));
-    rl2_destroy_coverage (coverage);
-    coverage = NULL;
     if (xpixel == NULL)
 	goto error;
 
@@ -7997,8 +8163,10 @@ rl2_pixel_from_raster_by_point (sqlite3 * sqlite, const void *data,
 	;
     else if (rl2_load_cached_raster
 	     (sqlite, data, db_prefix, cvg_name, pyramid_level, x, y, palette,
-	      &raster) != RL2_OK)
+	      coverage, &raster) != RL2_OK)
 	goto error;
+    rl2_destroy_coverage (coverage);
+    coverage = NULL;
     if (raster != NULL)
       {
 	  /* extracting the Pixel at coordinates [X,Y] */
@@ -8126,6 +8294,9 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
     int ret;
     int reproject_on_the_fly;
     int has_extra_columns;
+    int gen_band = -1;
+    rl2BandedRendererPtr banded = NULL;
+    rl2LabelCandidatesPtr labels = NULL;
     rl2VariantArrayPtr variant = NULL;
     rl2GraphicsContextPtr ctx = NULL;
     rl2GraphicsContextPtr ctx_labels = NULL;
@@ -8235,6 +8406,26 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
     ext_min_y = miny - extended_y;
     ext_max_y = maxy + extended_y;
 
+    if (aux->mode_labels)
+      {
+	  rl2PrivCanvasPtr pcanvas = (rl2PrivCanvasPtr) canvas;
+	  if (rl2_match_label_candidates
+	      (pcanvas->labels, db_prefix, cvg_name, width, height, minx, miny,
+	       maxx, maxy))
+	    {
+		/* painting the Labels retained by the Feature pass (no query at all) */
+		ctx = rl2_get_canvas_ctx (canvas, RL2_CANVAS_BASE_CTX);
+		if (ctx == NULL)
+		    goto error;
+		rl2_draw_label_candidates (ctx, sqlite, priv_data,
+					   pcanvas->labels);
+		rl2_destroy_label_candidates (pcanvas->labels);
+		pcanvas->labels = NULL;
+		do_set_canvas_ready (canvas, RL2_CANVAS_BASE_CTX);
+		goto done;
+	    }
+      }
+
 /* attempting to load the VectorLayer definitions from the DBMS */
     multi = rl2_create_vector_layer_from_dbms (sqlite, db_prefix, cvg_name);
     if (multi == NULL)
@@ -8282,6 +8473,13 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
       }
     rl2_is_multilayer_topogeo (multi, &is_topogeo);
     rl2_is_multilayer_toponet (multi, &is_toponet);
+    if (!is_topogeo && !is_toponet)
+      {
+	  /* checking for some precomputed generalization suitable for this scale */
+	  gen_band =
+	      rl2_find_vector_generalization (sqlite, db_prefix, cvg_name,
+					      multi, scale);
+      }
     if (lyr_stl != NULL)
       {
 	  /* checking if the Style has Text Labels */
@@ -8293,6 +8491,15 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
 		if (ctx_labels != NULL)
 		    rl2_prime_background (ctx_labels, 0, 0, 0, 0);	/* labels layer: always transparent */
 	    }
+	  if (has_labels && ctx_labels == NULL && !aux->mode_labels
+	      && ((rl2PrivCanvasPtr) canvas)->retain_labels)
+	    {
+		/* retaining all Labels for the later Label pass */
+		labels =
+		    rl2_create_label_candidates (db_prefix, cvg_name, width,
+						 height, minx, miny, maxx,
+						 maxy);
+	    }
       }
 
     for (j = 0; j < rl2_get_multilayer_count (multi); j++)
@@ -8303,6 +8510,7 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
 	  int len;
 	  int is_face = 0;
 	  int is_seed = 0;
+	  int face_cache = 0;
 	  int visible = 0;
 	  rl2VectorLayerPtr layer = NULL;
 	  rl2PrivVectorLayerPtr lyr;
@@ -8420,20 +8628,47 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
 		  }
 	    }
 	  if (is_topogeo && is_face)
+	      face_cache = rl2_find_topo_face_cache (sqlite, db_prefix, toponame);
+	  if (face_cache)
+	    {
+		/* fetching the materialized Face Geometries */
+		char *face_geom =
+		    rl2_topo_face_cache_geometry_sql (db_prefix, toponame,
+						      lyr->f_table_name);
+		if (reproject_on_the_fly)
+		    sql =
+			sqlite3_mprintf ("SELECT ST_Transform(%s, %d)",
+					 face_geom, out_srid);
+		else
+		    sql = sqlite3_mprintf ("SELECT %s", face_geom);
+		sqlite3_free (face_geom);
+	    }
+	  else if (is_topogeo && is_face)
 	    {
+		/* clipping will be natively applied on each fetched Geometry */
 		if (reproject_on_the_fly)
 		    sql =
 			sqlite3_mprintf
-			("SELECT CastToXY(ST_Intersection(ST_Transform(ST_GetFaceGeometry(%Q, face_id), %d), "
-			 "BuildMbr(%f, %f, %f, %f)))",
-			 toponame, out_srid, ext_min_x, ext_min_y, ext_max_x,
-			 ext_max_y);
+			("SELECT ST_Transform(ST_GetFaceGeometry(%Q, face_id), %d)",
+			 toponame, out_srid);
 		else
 		    sql =
 			sqlite3_mprintf
-			("SELECT CastToXY(ST_Intersection(ST_GetFaceGeometry(%Q, face_id), "
-			 "BuildMbr(%f, %f, %f, %f)))", toponame, ext_min_x,
-			 ext_min_y, ext_max_x, ext_max_y);
+			("SELECT ST_GetFaceGeometry(%Q, face_id)", toponame);
+	    }
+	  else if (gen_band >= 0)
+	    {
+		/* fetching the generalized Geometries for this scale band */
+		char *gen_geom =
+		    rl2_generalized_geometry_sql (db_prefix, cvg_name, lyr,
+						  gen_band);
+		if (reproject_on_the_fly)
+		    sql =
+			sqlite3_mprintf ("SELECT ST_Transform(%s, %d)",
+					 gen_geom, out_srid);
+		else
+		    sql = sqlite3_mprintf ("SELECT %s", gen_geom);
+		sqlite3_free (gen_geom);
 	    }
 	  else
 	    {
@@ -8441,18 +8676,13 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
 		    quoted = rl2_double_quoted_sql (lyr->view_geometry);
 		else
 		    quoted = rl2_double_quoted_sql (lyr->f_geometry_column);
+		/* clipping will be natively applied on each fetched Geometry */
 		if (reproject_on_the_fly)
 		    sql =
-			sqlite3_mprintf
-			("SELECT CastToXY(ST_Intersection(ST_Transform(\"%s\", %d), "
-			 "BuildMbr(%f, %f, %f, %f)))", quoted, out_srid,
-			 ext_min_x, ext_min_y, ext_max_x, ext_max_y);
+			sqlite3_mprintf ("SELECT ST_Transform(\"%s\", %d)",
+					 quoted, out_srid);
 		else
-		    sql =
-			sqlite3_mprintf
-			("SELECT CastToXY(ST_Intersection(\"%s\", "
-			 "BuildMbr(%f, %f, %f, %f)))", quoted, ext_min_x,
-			 ext_min_y, ext_max_x, ext_max_y);
+		    sql = sqlite3_mprintf ("SELECT \"%s\"", quoted);
 		free (quoted);
 	    }
 	  sqlite3_free (toponame);
@@ -8698,7 +8928,44 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
 	  free (xdb_prefix);
 	  free (quoted);
 	  sqlite3_free (oldsql);
-	  if (reproject_on_the_fly)
+	  if (gen_band >= 0)
+	    {
+		/* querying the Spatial Index of the generalized Geometries */
+		char *search_frame;
+		char *gen_filter;
+		if (reproject_on_the_fly)
+		    search_frame = sqlite3_mprintf ("ST_Transform(?, %d)", srid);
+		else
+		    search_frame = sqlite3_mprintf ("?");
+		gen_filter =
+		    rl2_generalized_filter_sql (db_prefix, cvg_name, lyr,
+						gen_band, search_frame);
+		sqlite3_free (search_frame);
+		oldsql = sql;
+		sql = sqlite3_mprintf ("%s WHERE %s", oldsql, gen_filter);
+		sqlite3_free (gen_filter);
+		sqlite3_free (oldsql);
+	    }
+	  else if (face_cache)
+	    {
+		/* querying the Spatial Index of the Face Cache */
+		char *search_frame;
+		char *face_filter;
+		if (reproject_on_the_fly)
+		    search_frame = sqlite3_mprintf ("ST_Transform(?, %d)", srid);
+		else
+		    search_frame = sqlite3_mprintf ("?");
+		face_filter =
+		    rl2_topo_face_cache_filter_sql (db_prefix,
+						    lyr->f_table_name,
+						    search_frame);
+		sqlite3_free (search_frame);
+		oldsql = sql;
+		sql = sqlite3_mprintf ("%s WHERE %s", oldsql, face_filter);
+		sqlite3_free (face_filter);
+		sqlite3_free (oldsql);
+	    }
+	  else if (reproject_on_the_fly)
 	    {
 		if (lyr->spatial_index)
 		  {
@@ -8787,6 +9054,19 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
 		      sqlite3_free (oldsql);
 		  }
 	    }
+	  if (has_extra_columns && !is_topogeo && !is_toponet)
+	    {
+		/* pushing the Style Rule Filters down into the query */
+		char *filter =
+		    rl2_build_feature_type_style_sql_filter (lyr_stl, scale);
+		if (filter != NULL)
+		  {
+		      oldsql = sql;
+		      sql = sqlite3_mprintf ("%s AND (%s)", oldsql, filter);
+		      sqlite3_free (oldsql);
+		      sqlite3_free (filter);
+		  }
+	    }
 	  if (is_topogeo)
 	    {
 		if (is_face)
@@ -8828,6 +9108,15 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
 		goto error;
 	    }
 
+	  if (!aux->mode_labels)
+	    {
+		/* attempting to paint all Features in parallel bands */
+		banded =
+		    rl2_create_banded_renderer (sqlite, priv_data, ctx, width,
+						height, minx, miny, maxx, maxy,
+						x_res, y_res);
+	    }
+
 	  sqlite3_reset (stmt);
 	  sqlite3_clear_bindings (stmt);
 	  sqlite3_bind_blob (stmt, 1, blob, blob_sz, SQLITE_STATIC);
@@ -8837,6 +9126,8 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
 		ret = sqlite3_step (stmt);
 		if (ret == SQLITE_DONE)
 		    break;	/* end of result set */
+		if (ret != SQLITE_ROW || rl2_is_cancelled ())
+		    goto error;	/* SQL error, or the request was cancelled */
 		if (ret == SQLITE_ROW)
 		  {
 		      rl2GeometryPtr geom = NULL;
@@ -8849,6 +9140,16 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
 				rl2_geometry_from_blob ((const unsigned char
 							 *) g_blob, g_blob_sz);
 			}
+		      if (geom != NULL)
+			{
+			    /* clipping to the extended frame, dropping sub-pixel steps */
+			    rl2GeometryPtr clipped =
+				rl2_clip_geometry (geom, ext_min_x, ext_min_y,
+						   ext_max_x, ext_max_y,
+						   x_res / 2.0, y_res / 2.0);
+			    rl2_destroy_geometry (geom);
+			    geom = clipped;
+			}
 		      if (has_extra_columns)
 			{
 			    if (variant != NULL)
@@ -8909,17 +9210,33 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
 				    (lyr_stl, scale, variant, &scale_forbidden);
 			    if (!scale_forbidden)
 			      {
+				  if (labels != NULL)
+				    {
+					if (!rl2_add_label_candidates
+					    (labels, symbolizer, geom, variant))
+					  {
+					      rl2_destroy_geometry (geom);
+					      goto error;
+					  }
+				    }
 				  if (ctx_labels != NULL && has_labels)
 				    {
 					/* immediately painting Text Labels */
-					rl2_draw_vector_feature (ctx, sqlite,
-								 priv_data,
-								 symbolizer,
-								 height, minx,
-								 miny, maxx,
-								 maxy, x_res,
-								 y_res, geom,
-								 variant, 0);
+					if (banded == NULL)
+					    rl2_draw_vector_feature (ctx,
+								     sqlite,
+								     priv_data,
+								     symbolizer,
+								     height,
+								     minx,
+								     miny,
+								     maxx,
+								     maxy,
+								     x_res,
+								     y_res,
+								     geom,
+								     variant,
+								     0);
 					rl2_draw_vector_feature (ctx_labels,
 								 sqlite,
 								 priv_data,
@@ -8930,7 +9247,7 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
 								 y_res, geom,
 								 variant, 1);
 				    }
-				  else
+				  else if (banded == NULL)
 				    {
 					/* painting eventual Text Labels in a later step */
 					rl2_draw_vector_feature (ctx, sqlite,
@@ -8943,13 +9260,35 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
 								 variant,
 								 aux->mode_labels);
 				    }
+				  if (banded != NULL)
+				    {
+					/* queueing the Feature for parallel painting */
+					if (!rl2_banded_renderer_add
+					    (banded, geom, symbolizer, variant))
+					  {
+					      rl2_destroy_geometry (geom);
+					      goto error;
+					  }
+					geom = NULL;
+					variant = NULL;
+				    }
 			      }
-			    rl2_destroy_geometry (geom);
+			    if (geom != NULL)
+				rl2_destroy_geometry (geom);
 			}
 		  }
 	    }
 	  sqlite3_finalize (stmt);
 	  stmt = NULL;
+	  if (banded != NULL)
+	    {
+		/* painting all bands directly on the canvas */
+		ret = rl2_banded_renderer_paint (banded);
+		rl2_destroy_banded_renderer (banded);
+		banded = NULL;
+		if (!ret)
+		    goto error;
+	    }
 
 	skip_topo_sublayer:
 	  which = RL2_CANVAS_UNKNOWN_CTX;
@@ -9024,6 +9363,15 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
       }
 
   done:
+    if (labels != NULL)
+      {
+	  /* handing over the retained Labels to the Canvas */
+	  rl2PrivCanvasPtr pcanvas = (rl2PrivCanvasPtr) canvas;
+	  if (pcanvas->labels != NULL)
+	      rl2_destroy_label_candidates (pcanvas->labels);
+	  pcanvas->labels = labels;
+	  labels = NULL;
+      }
     if (aux->output == NULL)
       {
 	  rl2_destroy_multi_layer (multi);
@@ -9173,6 +9521,10 @@ do_paint_map_from_vector (struct aux_vector_render *aux)
 	rl2_destroy_variant_array (variant);
     if (stmt != NULL)
 	sqlite3_finalize (stmt);
+    if (banded != NULL)
+	rl2_destroy_banded_renderer (banded);
+    if (labels != NULL)
+	rl2_destroy_label_candidates (labels);
     if (aux->output != NULL)
       {
 	  aux->output->img = NULL;
@@ -9273,6 +9625,7 @@ rl2_map_image_blob_from_vector (sqlite3 * sqlite, const void *data,
 				unsigned char **img, int *img_size)
 {
 /* rendering a Map Image from a Vector Coverage - BLOB */
+    int ret;
     unsigned char bg_red = 0;
     unsigned char bg_green = 0;
     unsigned char bg_blue = 0;
@@ -9418,7 +9771,11 @@ rl2_map_image_blob_from_vector (sqlite3 * sqlite, const void *data,
     if (ctx_link_seeds != NULL)
 	rl2_prime_background (ctx_link_seeds, 0, 0, 0, 0);	/* LinkSeeds layer: always transparent */
 
-    if (do_paint_map_from_vector (&aux) == RL2_OK)
+/* encoding the output image accordingly to the current PNG options */
+    rl2_png_begin_request (data, sqlite, db_prefix, cvg_name, style_name);
+    ret = do_paint_map_from_vector (&aux);
+    rl2_png_end_request ();
+    if (ret == RL2_OK)
       {
 	  rl2_graph_destroy_context (ctx);
 	  if (ctx_nodes != NULL)
@@ -9481,6 +9838,7 @@ rl2_styled_map_image_blob_from_vector (sqlite3 * sqlite, const void *data,
 				       int *img_size)
 {
 /* rendering a Map Image from a Vector Coverage - BLOB */
+    int ret;
     unsigned char bg_red = 0;
     unsigned char bg_green = 0;
     unsigned char bg_blue = 0;
@@ -9631,7 +9989,11 @@ rl2_styled_map_image_blob_from_vector (sqlite3 * sqlite, const void *data,
     if (ctx_link_seeds != NULL)
 	rl2_prime_background (ctx_link_seeds, 0, 0, 0, 0);	/* LinkSeeds layer: always transparent */
 
-    if (do_paint_map_from_vector (&aux) == RL2_OK)
+/* encoding the output image accordingly to the current PNG options */
+    rl2_png_begin_request (data, sqlite, db_prefix, NULL, NULL);
+    ret = do_paint_map_from_vector (&aux);
+    rl2_png_end_request ();
+    if (ret == RL2_OK)
       {
 	  rl2_graph_destroy_context (ctx);
 	  rl2_graph_destroy_context (ctx_labels);
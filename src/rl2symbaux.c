@@ -99,6 +99,7 @@ rl2_create_default_style_rule ()
     rule->comparison_op = RL2_COMPARISON_NONE;
     rule->comparison_args = NULL;
     rule->column_name = NULL;
+    rule->filter = NULL;
     rule->style_type = RL2_UNKNOWN_STYLE;
     rule->style = NULL;
     rule->next = NULL;
@@ -372,36 +373,108 @@ is_valid_numeric_literal (const char *literal)
     return 1;
 }
 
+static void
+compile_rule_literal (const char *literal, rl2PrivRuleLiteralPtr lit)
+{
+/* pre-parsing a Rule literal, so to avoid parsing it again for each Feature */
+    lit->is_numeric = 0;
+    lit->int_value = 0;
+    lit->dbl_value = 0.0;
+    lit->text_value = literal;
+    if (literal == NULL)
+	return;
+    if (is_valid_numeric_literal (literal))
+      {
+	  lit->is_numeric = 1;
+	  lit->int_value = atoll (literal);
+	  lit->dbl_value = atof (literal);
+      }
+}
+
+static void
+compile_rule_filter (rl2PrivStyleRulePtr rule, rl2PrivRuleFilterPtr filter)
+{
+/* compiling a Rule Filter into a typed predicate */
+    filter->has_args = 0;
+    filter->column_index = -1;
+    compile_rule_literal (NULL, &(filter->lower));
+    compile_rule_literal (NULL, &(filter->upper));
+    if (rule->comparison_args == NULL)
+	return;
+    filter->has_args = 1;
+    if (rule->comparison_op == RL2_COMPARISON_BETWEEN)
+      {
+	  rl2PrivRuleBetweenArgsPtr arg =
+	      (rl2PrivRuleBetweenArgsPtr) (rule->comparison_args);
+	  compile_rule_literal (arg->lower, &(filter->lower));
+	  compile_rule_literal (arg->upper, &(filter->upper));
+      }
+    else if (rule->comparison_op != RL2_COMPARISON_LIKE)
+      {
+	  rl2PrivRuleSingleArgPtr arg =
+	      (rl2PrivRuleSingleArgPtr) (rule->comparison_args);
+	  compile_rule_literal (arg->value, &(filter->lower));
+      }
+}
+
+static void
+compile_style_rule (rl2PrivFeatureTypeStylePtr stl, rl2PrivStyleRulePtr rule)
+{
+/* compiling a single Rule Filter */
+    int i;
+    if (rule->column_name == NULL)
+	return;
+    if (rule->filter != NULL)
+	free (rule->filter);
+    rule->filter = malloc (sizeof (rl2PrivRuleFilter));
+    if (rule->filter == NULL)
+	return;
+    compile_rule_filter (rule, rule->filter);
+    for (i = 0; i < stl->columns_count; i++)
+      {
+	  /* caching the position of the Filter column */
+	  if (strcasecmp (rule->column_name, *(stl->column_names + i)) == 0)
+	    {
+		rule->filter->column_index = i;
+		break;
+	    }
+      }
+}
+
+RL2_PRIVATE void
+rl2_compile_feature_type_style_filters (rl2PrivFeatureTypeStylePtr stl)
+{
+/* compiling once and for all the Rule Filters of a FeatureTypeStyle */
+    rl2PrivStyleRulePtr pR;
+    if (stl == NULL)
+	return;
+    pR = stl->first_rule;
+    while (pR != NULL)
+      {
+	  compile_style_rule (stl, pR);
+	  pR = pR->next;
+      }
+}
+
 static int
-eval_filter_eq (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
+eval_filter_eq (rl2PrivRuleFilterPtr filter, rl2PrivVariantValuePtr val)
 {
 /* evaluating an IsEqual comparison */
-    sqlite3_int64 intval;
-    double dblval;
-    rl2PrivRuleSingleArgPtr arg =
-	(rl2PrivRuleSingleArgPtr) (rule->comparison_args);
-    if (arg == NULL)
+    rl2PrivRuleLiteralPtr arg = &(filter->lower);
+    if (!filter->has_args)
 	return 0;
     switch (val->sqlite3_type)
       {
       case SQLITE_INTEGER:
-	  if (is_valid_numeric_literal (arg->value))
-	    {
-		intval = atoll (arg->value);
-		if (intval == val->int_value)
-		    return 1;
-	    }
+	  if (arg->is_numeric && arg->int_value == val->int_value)
+	      return 1;
 	  break;
       case SQLITE_FLOAT:
-	  if (is_valid_numeric_literal (arg->value))
-	    {
-		dblval = atof (arg->value);
-		if (dblval == val->dbl_value)
-		    return 1;
-	    }
+	  if (arg->is_numeric && arg->dbl_value == val->dbl_value)
+	      return 1;
 	  break;
       case SQLITE_TEXT:
-	  if (strcmp (arg->value, val->text_value) == 0)
+	  if (strcmp (arg->text_value, val->text_value) == 0)
 	      return 1;
 	  break;
       };
@@ -409,37 +482,26 @@ eval_filter_eq (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
 }
 
 static int
-eval_filter_ne (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
+eval_filter_ne (rl2PrivRuleFilterPtr filter, rl2PrivVariantValuePtr val)
 {
 /* evaluating an IsNotEqual comparison */
-    sqlite3_int64 intval;
-    double dblval;
-    rl2PrivRuleSingleArgPtr arg =
-	(rl2PrivRuleSingleArgPtr) (rule->comparison_args);
-    if (arg == NULL)
+    rl2PrivRuleLiteralPtr arg = &(filter->lower);
+    if (!filter->has_args)
 	return 1;
     switch (val->sqlite3_type)
       {
       case SQLITE_INTEGER:
-	  if (is_valid_numeric_literal (arg->value))
-	    {
-		intval = atoll (arg->value);
-		if (intval == val->int_value)
-		    return 0;
-	    }
+	  if (arg->is_numeric && arg->int_value == val->int_value)
+	      return 0;
 	  break;
       case SQLITE_FLOAT:
-	  if (is_valid_numeric_literal (arg->value))
-	    {
-		dblval = atof (arg->value);
-		if (dblval == val->dbl_value)
-		    return 0;
-	    }
+	  if (arg->is_numeric && arg->dbl_value == val->dbl_value)
+	      return 0;
 	  break;
       case SQLITE_TEXT:
-	  if (is_valid_numeric_literal (arg->value))
+	  if (arg->is_numeric)
 	    {
-		if (strcmp (arg->value, val->text_value) == 0)
+		if (strcmp (arg->text_value, val->text_value) == 0)
 		    return 0;
 	    }
 	  break;
@@ -452,35 +514,24 @@ eval_filter_ne (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
 }
 
 static int
-eval_filter_lt (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
+eval_filter_lt (rl2PrivRuleFilterPtr filter, rl2PrivVariantValuePtr val)
 {
 /* evaluating an IsLessThan comparison */
-    sqlite3_int64 intval;
-    double dblval;
-    rl2PrivRuleSingleArgPtr arg =
-	(rl2PrivRuleSingleArgPtr) (rule->comparison_args);
-    if (arg == NULL)
+    rl2PrivRuleLiteralPtr arg = &(filter->lower);
+    if (!filter->has_args)
 	return 0;
     switch (val->sqlite3_type)
       {
       case SQLITE_INTEGER:
-	  if (is_valid_numeric_literal (arg->value))
-	    {
-		intval = atoll (arg->value);
-		if (val->int_value < intval)
-		    return 1;
-	    }
+	  if (arg->is_numeric && val->int_value < arg->int_value)
+	      return 1;
 	  break;
       case SQLITE_FLOAT:
-	  if (is_valid_numeric_literal (arg->value))
-	    {
-		dblval = atof (arg->value);
-		if (val->dbl_value < dblval)
-		    return 1;
-	    }
+	  if (arg->is_numeric && val->dbl_value < arg->dbl_value)
+	      return 1;
 	  break;
       case SQLITE_TEXT:
-	  if (strcmp (val->text_value, arg->value) < 0)
+	  if (strcmp (val->text_value, arg->text_value) < 0)
 	      return 1;
 	  break;
       };
@@ -488,35 +539,24 @@ eval_filter_lt (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
 }
 
 static int
-eval_filter_gt (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
+eval_filter_gt (rl2PrivRuleFilterPtr filter, rl2PrivVariantValuePtr val)
 {
 /* evaluating an IsGreaterThan comparison */
-    sqlite3_int64 intval;
-    double dblval;
-    rl2PrivRuleSingleArgPtr arg =
-	(rl2PrivRuleSingleArgPtr) (rule->comparison_args);
-    if (arg == NULL)
+    rl2PrivRuleLiteralPtr arg = &(filter->lower);
+    if (!filter->has_args)
 	return 0;
     switch (val->sqlite3_type)
       {
       case SQLITE_INTEGER:
-	  if (is_valid_numeric_literal (arg->value))
-	    {
-		intval = atoll (arg->value);
-		if (val->int_value > intval)
-		    return 1;
-	    }
+	  if (arg->is_numeric && val->int_value > arg->int_value)
+	      return 1;
 	  break;
       case SQLITE_FLOAT:
-	  if (is_valid_numeric_literal (arg->value))
-	    {
-		dblval = atof (arg->value);
-		if (val->dbl_value > dblval)
-		    return 1;
-	    }
+	  if (arg->is_numeric && val->dbl_value > arg->dbl_value)
+	      return 1;
 	  break;
       case SQLITE_TEXT:
-	  if (strcmp (val->text_value, arg->value) > 0)
+	  if (strcmp (val->text_value, arg->text_value) > 0)
 	      return 1;
 	  break;
       };
@@ -524,35 +564,24 @@ eval_filter_gt (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
 }
 
 static int
-eval_filter_le (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
+eval_filter_le (rl2PrivRuleFilterPtr filter, rl2PrivVariantValuePtr val)
 {
 /* evaluating an IsLessThanOrEqualTo comparison */
-    sqlite3_int64 intval;
-    double dblval;
-    rl2PrivRuleSingleArgPtr arg =
-	(rl2PrivRuleSingleArgPtr) (rule->comparison_args);
-    if (arg == NULL)
+    rl2PrivRuleLiteralPtr arg = &(filter->lower);
+    if (!filter->has_args)
 	return 0;
     switch (val->sqlite3_type)
       {
       case SQLITE_INTEGER:
-	  if (is_valid_numeric_literal (arg->value))
-	    {
-		intval = atoll (arg->value);
-		if (val->int_value <= intval)
-		    return 1;
-	    }
+	  if (arg->is_numeric && val->int_value <= arg->int_value)
+	      return 1;
 	  break;
       case SQLITE_FLOAT:
-	  if (is_valid_numeric_literal (arg->value))
-	    {
-		dblval = atof (arg->value);
-		if (val->dbl_value <= dblval)
-		    return 1;
-	    }
+	  if (arg->is_numeric && val->dbl_value <= arg->dbl_value)
+	      return 1;
 	  break;
       case SQLITE_TEXT:
-	  if (strcmp (val->text_value, arg->value) <= 0)
+	  if (strcmp (val->text_value, arg->text_value) <= 0)
 	      return 1;
 	  break;
       };
@@ -560,35 +589,24 @@ eval_filter_le (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
 }
 
 static int
-eval_filter_ge (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
+eval_filter_ge (rl2PrivRuleFilterPtr filter, rl2PrivVariantValuePtr val)
 {
 /* evaluating an IsGreaterThanOrEqualTo comparison */
-    sqlite3_int64 intval;
-    double dblval;
-    rl2PrivRuleSingleArgPtr arg =
-	(rl2PrivRuleSingleArgPtr) (rule->comparison_args);
-    if (arg == NULL)
+    rl2PrivRuleLiteralPtr arg = &(filter->lower);
+    if (!filter->has_args)
 	return 0;
     switch (val->sqlite3_type)
       {
       case SQLITE_INTEGER:
-	  if (is_valid_numeric_literal (arg->value))
-	    {
-		intval = atoll (arg->value);
-		if (val->int_value >= intval)
-		    return 1;
-	    }
+	  if (arg->is_numeric && val->int_value >= arg->int_value)
+	      return 1;
 	  break;
       case SQLITE_FLOAT:
-	  if (is_valid_numeric_literal (arg->value))
-	    {
-		dblval = atof (arg->value);
-		if (val->dbl_value >= dblval)
-		    return 1;
-	    }
+	  if (arg->is_numeric && val->dbl_value >= arg->dbl_value)
+	      return 1;
 	  break;
       case SQLITE_TEXT:
-	  if (strcmp (val->text_value, arg->value) >= 0)
+	  if (strcmp (val->text_value, arg->text_value) >= 0)
 	      return 1;
 	  break;
       };
@@ -596,42 +614,34 @@ eval_filter_ge (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
 }
 
 static int
-eval_filter_between (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
+eval_filter_between (rl2PrivRuleFilterPtr filter, rl2PrivVariantValuePtr val)
 {
 /* evaluating a Between comparison */
-    sqlite3_int64 int_lo;
-    sqlite3_int64 int_hi;
-    double dbl_lo;
-    double dbl_hi;
-    rl2PrivRuleBetweenArgsPtr arg =
-	(rl2PrivRuleBetweenArgsPtr) (rule->comparison_args);
-    if (arg == NULL)
+    rl2PrivRuleLiteralPtr lo = &(filter->lower);
+    rl2PrivRuleLiteralPtr hi = &(filter->upper);
+    if (!filter->has_args)
 	return 0;
     switch (val->sqlite3_type)
       {
       case SQLITE_INTEGER:
-	  if (is_valid_numeric_literal (arg->lower)
-	      && is_valid_numeric_literal (arg->upper))
+	  if (lo->is_numeric && hi->is_numeric)
 	    {
-		int_lo = atoll (arg->lower);
-		int_hi = atoll (arg->upper);
-		if (val->int_value >= int_lo && val->int_value < int_hi)
+		if (val->int_value >= lo->int_value
+		    && val->int_value < hi->int_value)
 		    return 1;
 	    }
 	  break;
       case SQLITE_FLOAT:
-	  if (is_valid_numeric_literal (arg->lower)
-	      && is_valid_numeric_literal (arg->upper))
+	  if (lo->is_numeric && hi->is_numeric)
 	    {
-		dbl_lo = atof (arg->lower);
-		dbl_hi = atof (arg->upper);
-		if (val->dbl_value >= dbl_lo && val->dbl_value < dbl_hi)
+		if (val->dbl_value >= lo->dbl_value
+		    && val->dbl_value < hi->dbl_value)
 		    return 1;
 	    }
 	  break;
       case SQLITE_TEXT:
-	  if (strcmp (val->text_value, arg->lower) >= 0
-	      && strcmp (val->text_value, arg->upper) < 0)
+	  if (strcmp (val->text_value, lo->text_value) >= 0
+	      && strcmp (val->text_value, hi->text_value) < 0)
 	      return 1;
 	  break;
       };
@@ -778,16 +788,65 @@ eval_filter_like (rl2PrivStyleRulePtr rule, rl2PrivVariantValuePtr val)
     return 1;
 }
 
+static int
+eval_filter_value (rl2PrivStyleRulePtr rule, rl2PrivRuleFilterPtr filter,
+		   rl2PrivVariantValuePtr val)
+{
+/* evaluating a Rule Filter against the value of its own column */
+    switch (rule->comparison_op)
+      {
+      case RL2_COMPARISON_EQ:
+	  return eval_filter_eq (filter, val);
+      case RL2_COMPARISON_NE:
+	  return eval_filter_ne (filter, val);
+      case RL2_COMPARISON_LT:
+	  return eval_filter_lt (filter, val);
+      case RL2_COMPARISON_GT:
+	  return eval_filter_gt (filter, val);
+      case RL2_COMPARISON_LE:
+	  return eval_filter_le (filter, val);
+      case RL2_COMPARISON_GE:
+	  return eval_filter_ge (filter, val);
+      case RL2_COMPARISON_LIKE:
+	  return eval_filter_like (rule, val);
+      case RL2_COMPARISON_BETWEEN:
+	  return eval_filter_between (filter, val);
+      case RL2_COMPARISON_NULL:
+	  if (val->sqlite3_type == SQLITE_NULL)
+	      return 1;
+	  break;
+      };
+    return 0;
+}
+
 static int
 eval_filter (rl2PrivStyleRulePtr rule, rl2VariantArrayPtr variant)
 {
 /* evaluating a Rule Filter */
     int i;
+    rl2PrivRuleFilter not_compiled;
+    rl2PrivRuleFilterPtr filter = rule->filter;
     rl2PrivVariantArrayPtr var = (rl2PrivVariantArrayPtr) variant;
     if (rule->column_name == NULL)
 	return 1;		/* there is no comparison: surely true */
     if (var == NULL)
 	return 0;
+    if (filter == NULL)
+      {
+	  /* not yet compiled Filter: parsing the literals on the fly */
+	  compile_rule_filter (rule, &not_compiled);
+	  filter = &not_compiled;
+      }
+    else if (filter->column_index >= 0 && filter->column_index < var->count)
+      {
+	  /* directly accessing the cached column position */
+	  rl2PrivVariantValuePtr val = *(var->array + filter->column_index);
+	  if (val != NULL && val->column_name != NULL)
+	    {
+		if (strcasecmp (rule->column_name, val->column_name) == 0)
+		    return eval_filter_value (rule, filter, val);
+	    }
+      }
     for (i = 0; i < var->count; i++)
       {
 	  rl2PrivVariantValuePtr val = *(var->array + i);
@@ -797,30 +856,7 @@ eval_filter (rl2PrivStyleRulePtr rule, rl2VariantArrayPtr variant)
 	      return 0;
 	  if (strcasecmp (rule->column_name, val->column_name) != 0)
 	      continue;
-	  switch (rule->comparison_op)
-	    {
-	    case RL2_COMPARISON_EQ:
-		return eval_filter_eq (rule, val);
-	    case RL2_COMPARISON_NE:
-		return eval_filter_ne (rule, val);
-	    case RL2_COMPARISON_LT:
-		return eval_filter_lt (rule, val);
-	    case RL2_COMPARISON_GT:
-		return eval_filter_gt (rule, val);
-	    case RL2_COMPARISON_LE:
-		return eval_filter_le (rule, val);
-	    case RL2_COMPARISON_GE:
-		return eval_filter_ge (rule, val);
-	    case RL2_COMPARISON_LIKE:
-		return eval_filter_like (rule, val);
-	    case RL2_COMPARISON_BETWEEN:
-		return eval_filter_between (rule, val);
-	    case RL2_COMPARISON_NULL:
-		if (val->sqlite3_type == SQLITE_NULL)
-		    return 1;
-		break;
-	    };
-	  break;
+	  return eval_filter_value (rule, filter, val);
       }
     return 0;
 }
@@ -960,6 +996,301 @@ rl2_is_visible_style (rl2FeatureTypeStylePtr style, double scale)
     return 1;
 }
 
+static int
+is_rule_in_scale (rl2PrivStyleRulePtr rule, double scale)
+{
+/* testing if a Rule is visible at a given scale */
+    if (rule->min_scale != DBL_MAX && rule->max_scale != DBL_MAX)
+      {
+	  if (scale >= rule->min_scale && scale < rule->max_scale)
+	      return 1;
+	  return 0;
+      }
+    if (rule->min_scale != DBL_MAX)
+      {
+	  if (scale >= rule->min_scale)
+	      return 1;
+	  return 0;
+      }
+    if (rule->max_scale != DBL_MAX)
+      {
+	  if (scale < rule->max_scale)
+	      return 1;
+	  return 0;
+      }
+    return 1;
+}
+
+static char *
+sql_filter_double (double value)
+{
+/* formatting a Double literal; NULL if not representable in SQL */
+    if (value != value || value > DBL_MAX || value < -DBL_MAX)
+	return NULL;
+    return sqlite3_mprintf ("%!.17g", value);
+}
+
+static char *
+sql_filter_compare (const char *column, const char *op,
+		    rl2PrivRuleLiteralPtr arg, int numeric_too)
+{
+/*
+/ translating a typed comparison into SQL
+/ the CASE typeof() exactly mirrors eval_filter(): the column is
+/ always compared as stored, ignoring both affinity and collation
+*/
+    char *sql;
+    char *dbl;
+    if (!numeric_too || !arg->is_numeric)
+	return sqlite3_mprintf
+	    ("(typeof(\"%s\") = 'text' AND +\"%s\" COLLATE BINARY %s %Q)",
+	     column, column, op, arg->text_value);
+    dbl = sql_filter_double (arg->dbl_value);
+    if (dbl == NULL)
+	return NULL;
+    sql =
+	sqlite3_mprintf
+	("(CASE typeof(\"%s\") WHEN 'integer' THEN +\"%s\" %s %lld "
+	 "WHEN 'real' THEN +\"%s\" %s %s WHEN 'text' THEN "
+	 "+\"%s\" COLLATE BINARY %s %Q ELSE 0 END)", column, column, op,
+	 arg->int_value, column, op, dbl, column, op, arg->text_value);
+    sqlite3_free (dbl);
+    return sql;
+}
+
+static char *
+sql_filter_between (const char *column, rl2PrivRuleLiteralPtr lo,
+		    rl2PrivRuleLiteralPtr hi)
+{
+/* translating a Between comparison into SQL */
+    char *sql;
+    char *dbl_lo;
+    char *dbl_hi;
+    if (!lo->is_numeric || !hi->is_numeric)
+	return sqlite3_mprintf
+	    ("(typeof(\"%s\") = 'text' AND +\"%s\" COLLATE BINARY >= %Q "
+	     "AND +\"%s\" COLLATE BINARY < %Q)", column, column,
+	     lo->text_value, column, hi->text_value);
+    dbl_lo = sql_filter_double (lo->dbl_value);
+    dbl_hi = sql_filter_double (hi->dbl_value);
+    if (dbl_lo == NULL || dbl_hi == NULL)
+      {
+	  if (dbl_lo != NULL)
+	      sqlite3_free (dbl_lo);
+	  if (dbl_hi != NULL)
+	      sqlite3_free (dbl_hi);
+	  return NULL;
+      }
+    sql =
+	sqlite3_mprintf
+	("(CASE typeof(\"%s\") WHEN 'integer' THEN "
+	 "(+\"%s\" >= %lld AND +\"%s\" < %lld) WHEN 'real' THEN "
+	 "(+\"%s\" >= %s AND +\"%s\" < %s) WHEN 'text' THEN "
+	 "(+\"%s\" COLLATE BINARY >= %Q AND +\"%s\" COLLATE BINARY < %Q) "
+	 "ELSE 0 END)", column, column, lo->int_value, column,
+	 hi->int_value, column, dbl_lo, column, dbl_hi, column,
+	 lo->text_value, column, hi->text_value);
+    sqlite3_free (dbl_lo);
+    sqlite3_free (dbl_hi);
+    return sql;
+}
+
+static char *
+sql_filter_from_rule (rl2PrivStyleRulePtr rule, int superset)
+{
+/*
+/ translating a Rule Filter into an SQL expression
+/
+/ when an exact translation isn't possible (e.g. Like) the
+/ expression will match a superset of all Features passing
+/ the Filter if "superset" is TRUE, a subset otherwise
+*/
+    char *column;
+    char *sql = NULL;
+    rl2PrivRuleFilter filter;
+    const char *fallback = (superset) ? "1" : "0";
+    if (rule->column_name == NULL)
+	return sqlite3_mprintf ("1");
+    compile_rule_filter (rule, &filter);
+    column = rl2_double_quoted_sql (rule->column_name);
+    if (column == NULL)
+	return sqlite3_mprintf ("%s", fallback);
+    switch (rule->comparison_op)
+      {
+      case RL2_COMPARISON_EQ:
+	  if (filter.has_args)
+	      sql = sql_filter_compare (column, "=", &(filter.lower), 1);
+	  else
+	      sql = sqlite3_mprintf ("0");
+	  break;
+      case RL2_COMPARISON_NE:
+	  if (!filter.has_args)
+	      sql = sqlite3_mprintf ("1");
+	  else if (filter.lower.is_numeric)
+	      sql = sql_filter_compare (column, "<>", &(filter.lower), 1);
+	  else
+	      sql =
+		  sqlite3_mprintf
+		  ("(typeof(\"%s\") IN ('integer', 'real', 'text'))", column);
+	  break;
+      case RL2_COMPARISON_LT:
+      case RL2_COMPARISON_GT:
+      case RL2_COMPARISON_LE:
+      case RL2_COMPARISON_GE:
+	  if (filter.has_args)
+	    {
+		const char *op = "<";
+		if (rule->comparison_op == RL2_COMPARISON_GT)
+		    op = ">";
+		if (rule->comparison_op == RL2_COMPARISON_LE)
+		    op = "<=";
+		if (rule->comparison_op == RL2_COMPARISON_GE)
+		    op = ">=";
+		sql = sql_filter_compare (column, op, &(filter.lower), 1);
+	    }
+	  else
+	      sql = sqlite3_mprintf ("0");
+	  break;
+      case RL2_COMPARISON_BETWEEN:
+	  if (filter.has_args)
+	      sql =
+		  sql_filter_between (column, &(filter.lower),
+				      &(filter.upper));
+	  else
+	      sql = sqlite3_mprintf ("0");
+	  break;
+      case RL2_COMPARISON_LIKE:
+	  /* wild-cards and escapes have their own semantics: not translated */
+	  if (superset && filter.has_args)
+	      sql = sqlite3_mprintf ("(typeof(\"%s\") = 'text')", column);
+	  else
+	      sql = sqlite3_mprintf ("0");
+	  break;
+      case RL2_COMPARISON_NULL:
+	  sql = sqlite3_mprintf ("(\"%s\" IS NULL)", column);
+	  break;
+      default:
+	  sql = sqlite3_mprintf ("0");
+	  break;
+      };
+    free (column);
+    if (sql == NULL)
+	sql = sqlite3_mprintf ("%s", fallback);
+    return sql;
+}
+
+static char *
+sql_filter_append (char *list, char *term)
+{
+/* appending a further term to an SQL list of ORed expressions */
+    char *sql;
+    if (list == NULL)
+	return term;
+    sql = sqlite3_mprintf ("%s OR %s", list, term);
+    sqlite3_free (list);
+    sqlite3_free (term);
+    return sql;
+}
+
+RL2_DECLARE char *
+rl2_build_feature_type_style_sql_filter (rl2FeatureTypeStylePtr style,
+					 double scale)
+{
+/*
+/ building an SQL expression selecting only the Features that
+/ will be effectively drawn at a given scale by a FeatureTypeStyle
+/
+/ a Feature is drawn when it matches the Filter of any Rule
+/ visible at this scale; when there is no Else Rule a Feature
+/ matching no Filter at all is drawn as well (default style).
+/ Features only matching Rules out of scale are never drawn.
+/
+/ NULL will be returned when all Features could be drawn,
+/ otherwise the returned string must be freed by sqlite3_free()
+*/
+    char *visible = NULL;
+    char *hidden = NULL;
+    char *term;
+    char *sql;
+    rl2PrivStyleRulePtr pR;
+    rl2PrivFeatureTypeStylePtr stl = (rl2PrivFeatureTypeStylePtr) style;
+    if (stl == NULL)
+	return NULL;
+    if (stl->first_rule == NULL)
+	return NULL;
+    if (stl->else_rule != NULL)
+      {
+	  if (is_rule_in_scale (stl->else_rule, scale))
+	      return NULL;
+      }
+
+    pR = stl->first_rule;
+    while (pR != NULL)
+      {
+	  int in_scale;
+	  if (pR->style_type == RL2_VECTOR_STYLE && pR->style != NULL)
+	      ;
+	  else
+	    {
+		/* skipping any invalid rule */
+		pR = pR->next;
+		continue;
+	    }
+	  in_scale = is_rule_in_scale (pR, scale);
+	  term = sql_filter_from_rule (pR, in_scale);
+	  if (term == NULL)
+	      goto error;
+	  if (in_scale)
+	    {
+		if (strcmp (term, "1") == 0)
+		  {
+		      /* unconditionally visible: all Features will be drawn */
+		      sqlite3_free (term);
+		      goto error;
+		  }
+		visible = sql_filter_append (visible, term);
+		if (visible == NULL)
+		    goto error;
+	    }
+	  else
+	    {
+		hidden = sql_filter_append (hidden, term);
+		if (hidden == NULL)
+		    goto error;
+	    }
+	  pR = pR->next;
+      }
+
+    if (stl->else_rule != NULL)
+      {
+	  /* the Else Rule is out of scale */
+	  if (hidden != NULL)
+	      sqlite3_free (hidden);
+	  if (visible == NULL)
+	      return sqlite3_mprintf ("0");
+	  sql = sqlite3_mprintf ("(%s)", visible);
+	  sqlite3_free (visible);
+	  return sql;
+      }
+    if (hidden == NULL)
+	goto error;
+    if (visible == NULL)
+	sql = sqlite3_mprintf ("NOT (%s)", hidden);
+    else
+	sql = sqlite3_mprintf ("(%s) OR NOT (%s)", visible, hidden);
+    sqlite3_free (hidden);
+    if (visible != NULL)
+	sqlite3_free (visible);
+    return sql;
+
+  error:
+    if (visible != NULL)
+	sqlite3_free (visible);
+    if (hidden != NULL)
+	sqlite3_free (hidden);
+    return NULL;
+}
+
 RL2_DECLARE int
 rl2_style_has_labels (rl2FeatureTypeStylePtr style)
 {
@@ -1073,6 +1404,8 @@ rl2_destroy_style_rule (rl2PrivStyleRulePtr rule)
 
     if (rule->column_name != NULL)
 	free (rule->column_name);
+    if (rule->filter != NULL)
+	free (rule->filter);
     if (rule->comparison_args != NULL)
       {
 	  if (rule->comparison_op == RL2_COMPARISON_LIKE)
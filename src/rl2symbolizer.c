@@ -6028,6 +6028,7 @@ rl2_feature_type_style_from_xml (const char *name, const unsigned char *xml)
     if (style->name == NULL)
 	goto error;
     build_column_names_array (style);
+    rl2_compile_feature_type_style_filters (style);
 
     return (rl2FeatureTypeStylePtr) style;
 
@@ -0,0 +1,631 @@
+/*
+
+ rl2topocache -- materialized Face Geometries for TopoGeo Coverages
+
+ version 0.1, 2026 October 18
+
+ Author: Sandro Furieri a.furieri@lqt.it
+
+ -----------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2026
+the Initial Developer. All Rights Reserved.
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#ifdef LOADABLE_EXTENSION
+#include "rasterlite2/sqlite.h"
+#endif
+
+#include "rasterlite2/rasterlite2.h"
+#include "rasterlite2_private.h"
+
+/*
+/ a TopoGeo Coverage can optionally have a Face Cache: the Geometry
+/ of each Face (as returned by ST_GetFaceGeometry) materialized into
+/ the "<topology>_face_cache" table (supported by its own Spatial Index)
+/
+/ the "topo_face_caches" table keeps a change counter for each cached
+/ Topology: a few Triggers on the Face and Edge tables increment it and
+/ reset the Geometries of all affected Faces, so that the Cache can be
+/ lazily brought up to date the next time it's used
+*/
+
+static char *
+face_cache_table_name (const char *topology)
+{
+/* returns the (double quoted) name of the Face Cache table */
+    char *table = sqlite3_mprintf ("%s_face_cache", topology);
+    char *xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    return xtable;
+}
+
+static int
+do_exec_sql (sqlite3 * handle, char *sql, const char *what)
+{
+/* executing an SQL statement (will free the SQL text) */
+    int ret;
+    char *sql_err = NULL;
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "%s error: %s\n", what, sql_err);
+	  sqlite3_free (sql_err);
+	  return 0;
+      }
+    return 1;
+}
+
+static char *
+get_topology_name (sqlite3 * handle, const char *topology)
+{
+/* returns the exact name of some Topology (NULL if not existing) */
+    char *sql;
+    char **results;
+    int rows;
+    int columns;
+    int i;
+    int ret;
+    char *name = NULL;
+
+    sql =
+	sqlite3_mprintf ("SELECT topology_name FROM main.topologies "
+			 "WHERE Lower(topology_name) = Lower(%Q)", topology);
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return NULL;
+    for (i = 1; i <= rows; i++)
+      {
+	  const char *value = results[(i * columns) + 0];
+	  if (value != NULL && name == NULL)
+	      name = sqlite3_mprintf ("%s", value);
+      }
+    sqlite3_free_table (results);
+    return name;
+}
+
+static int
+get_topology_srid (sqlite3 * handle, const char *topology)
+{
+/* returns the SRID of some Topology */
+    char *sql;
+    char **results;
+    int rows;
+    int columns;
+    int i;
+    int ret;
+    int srid = -1;
+
+    sql =
+	sqlite3_mprintf ("SELECT srid FROM main.topologies "
+			 "WHERE Lower(topology_name) = Lower(%Q)", topology);
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return -1;
+    for (i = 1; i <= rows; i++)
+	srid = atoi (results[(i * columns) + 0]);
+    sqlite3_free_table (results);
+    return srid;
+}
+
+static int
+face_cache_exists (sqlite3 * handle, const char *db_prefix,
+		   const char *topology)
+{
+/* checking if the Face Cache of some Topology does exist */
+    char *sql;
+    char *table;
+    char *xdb_prefix;
+    char **results;
+    int rows;
+    int columns;
+    int i;
+    int ret;
+    int exists = 0;
+
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    table = sqlite3_mprintf ("%s_face_cache", topology);
+    sql =
+	sqlite3_mprintf ("SELECT Count(*) FROM \"%s\".sqlite_master "
+			 "WHERE type = 'table' AND Lower(name) = Lower(%Q)",
+			 xdb_prefix, table);
+    free (xdb_prefix);
+    sqlite3_free (table);
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    for (i = 1; i <= rows; i++)
+      {
+	  if (atoi (results[(i * columns) + 0]) > 0)
+	      exists = 1;
+      }
+    sqlite3_free_table (results);
+    return exists;
+}
+
+static int
+get_face_cache_status (sqlite3 * handle, const char *db_prefix,
+		       const char *topology, sqlite3_int64 * changes,
+		       sqlite3_int64 * synced)
+{
+/* retrieving the change counters of some Face Cache */
+    char *sql;
+    char *xdb_prefix;
+    sqlite3_stmt *stmt = NULL;
+    int ret;
+    int ok = 0;
+
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    sql =
+	sqlite3_mprintf ("SELECT changes, synced FROM \"%s\".topo_face_caches "
+			 "WHERE topology_name = Lower(%Q)", xdb_prefix,
+			 topology);
+    free (xdb_prefix);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		*changes = sqlite3_column_int64 (stmt, 0);
+		*synced = sqlite3_column_int64 (stmt, 1);
+		ok = 1;
+	    }
+	  else
+	      break;
+      }
+    sqlite3_finalize (stmt);
+    return ok;
+}
+
+static int
+do_refresh_face_cache (sqlite3 * handle, const char *db_prefix,
+		       const char *topology)
+{
+/* lazily re-materializing all Faces affected by Topology changes */
+    char *sql;
+    char *xdb_prefix;
+    char *xtable;
+    int ret;
+
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    ret =
+	sqlite3_exec (handle, "SAVEPOINT rl2_face_cache", NULL, NULL, NULL);
+    if (ret != SQLITE_OK)
+	return 0;
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    xtable = face_cache_table_name (topology);
+    sql =
+	sqlite3_mprintf ("UPDATE \"%s\".\"%s\" SET geometry = "
+			 "CastToXY(ST_GetFaceGeometry(%Q, face_id)) "
+			 "WHERE geometry IS NULL", xdb_prefix, xtable,
+			 topology);
+    free (xtable);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  free (xdb_prefix);
+	  goto error;
+      }
+    sql =
+	sqlite3_mprintf ("UPDATE \"%s\".topo_face_caches SET synced = changes "
+			 "WHERE topology_name = Lower(%Q)", xdb_prefix,
+			 topology);
+    free (xdb_prefix);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    ret =
+	sqlite3_exec (handle, "RELEASE SAVEPOINT rl2_face_cache", NULL, NULL,
+		      NULL);
+    if (ret != SQLITE_OK)
+	goto error;
+    return 1;
+
+  error:
+    sqlite3_exec (handle, "ROLLBACK TO SAVEPOINT rl2_face_cache", NULL, NULL,
+		  NULL);
+    sqlite3_exec (handle, "RELEASE SAVEPOINT rl2_face_cache", NULL, NULL,
+		  NULL);
+    return 0;
+}
+
+RL2_PRIVATE int
+rl2_find_topo_face_cache (sqlite3 * handle, const char *db_prefix,
+			  const char *topology)
+{
+/*
+/ checking if the Face Cache of some Topology can be used
+/ (refreshing it if the Topology has changed in the meanwhile)
+/
+/ returns 0 if ST_GetFaceGeometry() should be used instead
+*/
+    sqlite3_int64 changes;
+    sqlite3_int64 synced;
+    if (topology == NULL)
+	return 0;
+    if (!face_cache_exists (handle, db_prefix, topology))
+	return 0;
+    if (!get_face_cache_status (handle, db_prefix, topology, &changes, &synced))
+	return 0;
+    if (changes == synced)
+	return 1;
+/* the Topology has changed: e.g. a read-only DB can't be refreshed */
+    return do_refresh_face_cache (handle, db_prefix, topology);
+}
+
+RL2_PRIVATE char *
+rl2_topo_face_cache_geometry_sql (const char *db_prefix, const char *topology,
+				  const char *face_table)
+{
+/* SQL expression fetching the cached Geometry of each Face */
+    char *sql;
+    char *xdb_prefix;
+    char *xcache;
+    char *xtable;
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    xcache = face_cache_table_name (topology);
+    xtable = rl2_double_quoted_sql (face_table);
+    sql =
+	sqlite3_mprintf
+	("(SELECT c.geometry FROM \"%s\".\"%s\" AS c "
+	 "WHERE c.face_id = \"%s\".face_id)", xdb_prefix, xcache, xtable);
+    free (xdb_prefix);
+    free (xcache);
+    free (xtable);
+    return sql;
+}
+
+RL2_PRIVATE char *
+rl2_topo_face_cache_filter_sql (const char *db_prefix, const char *face_table,
+				const char *search_frame)
+{
+/* SQL spatial filter based on the Spatial Index of the Face Cache */
+    char *sql;
+    char *rtree_name;
+    int len = strlen (face_table);
+    if (len > 5 && strcasecmp (face_table + len - 5, "_face") == 0)
+	len -= 5;
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    rtree_name =
+	sqlite3_mprintf ("DB=%s.%.*s_face_cache", db_prefix, len, face_table);
+    sql =
+	sqlite3_mprintf
+	("face_id IN (SELECT ROWID FROM SpatialIndex WHERE f_table_name = %Q "
+	 "AND f_geometry_column = 'geometry' AND search_frame = %s)",
+	 rtree_name, search_frame);
+    sqlite3_free (rtree_name);
+    return sql;
+}
+
+static int
+drop_face_cache_triggers (sqlite3 * handle, const char *topology)
+{
+/* dropping all Triggers supporting the Face Cache */
+    const char *suffixes[] = { "face_ins", "face_upd", "face_del",
+	"edge_ins", "edge_upd", "edge_del", NULL
+    };
+    int i;
+    char *trigger;
+    char *xtrigger;
+    char *sql;
+
+    for (i = 0; suffixes[i] != NULL; i++)
+      {
+	  trigger =
+	      sqlite3_mprintf ("%s_face_cache_%s", topology, suffixes[i]);
+	  xtrigger = rl2_double_quoted_sql (trigger);
+	  sqlite3_free (trigger);
+	  sql = sqlite3_mprintf ("DROP TRIGGER IF EXISTS main.\"%s\"", xtrigger);
+	  free (xtrigger);
+	  if (!do_exec_sql (handle, sql, "DROP TRIGGER"))
+	      return 0;
+      }
+    return 1;
+}
+
+static int
+create_face_cache_trigger (sqlite3 * handle, const char *topology,
+			   const char *suffix, const char *table,
+			   const char *event, const char *faces)
+{
+/* creating a Trigger invalidating the Face Cache */
+    char *trigger;
+    char *xtrigger;
+    char *prim;
+    char *xprim;
+    char *xcache;
+    char *sql;
+    int ret;
+
+    trigger = sqlite3_mprintf ("%s_face_cache_%s", topology, suffix);
+    xtrigger = rl2_double_quoted_sql (trigger);
+    sqlite3_free (trigger);
+    prim = sqlite3_mprintf ("%s_%s", topology, table);
+    xprim = rl2_double_quoted_sql (prim);
+    sqlite3_free (prim);
+    xcache = face_cache_table_name (topology);
+    if (strcmp (suffix, "face_ins") == 0)
+	sql =
+	    sqlite3_mprintf ("CREATE TRIGGER main.\"%s\" AFTER %s ON \"%s\"\n"
+			     "FOR EACH ROW WHEN NEW.face_id > 0 BEGIN\n"
+			     "INSERT OR IGNORE INTO \"%s\" (face_id) VALUES (NEW.face_id);\n"
+			     "UPDATE topo_face_caches SET changes = changes + 1 "
+			     "WHERE topology_name = Lower(%Q);\nEND",
+			     xtrigger, event, xprim, xcache, topology);
+    else if (strcmp (suffix, "face_del") == 0)
+	sql =
+	    sqlite3_mprintf ("CREATE TRIGGER main.\"%s\" AFTER %s ON \"%s\"\n"
+			     "FOR EACH ROW BEGIN\n"
+			     "DELETE FROM \"%s\" WHERE face_id = OLD.face_id;\n"
+			     "UPDATE topo_face_caches SET changes = changes + 1 "
+			     "WHERE topology_name = Lower(%Q);\nEND",
+			     xtrigger, event, xprim, xcache, topology);
+    else
+	sql =
+	    sqlite3_mprintf ("CREATE TRIGGER main.\"%s\" AFTER %s ON \"%s\"\n"
+			     "FOR EACH ROW BEGIN\n"
+			     "UPDATE \"%s\" SET geometry = NULL WHERE face_id IN (%s);\n"
+			     "UPDATE topo_face_caches SET changes = changes + 1 "
+			     "WHERE topology_name = Lower(%Q);\nEND",
+			     xtrigger, event, xprim, xcache, faces, topology);
+    free (xtrigger);
+    free (xprim);
+    free (xcache);
+    ret = do_exec_sql (handle, sql, "CREATE TRIGGER");
+    return ret;
+}
+
+static int
+create_face_cache_triggers (sqlite3 * handle, const char *topology)
+{
+/* creating all Triggers supporting the Face Cache */
+    if (!create_face_cache_trigger
+	(handle, topology, "face_ins", "face", "INSERT", NULL))
+	return 0;
+    if (!create_face_cache_trigger
+	(handle, topology, "face_upd", "face", "UPDATE",
+	 "OLD.face_id, NEW.face_id"))
+	return 0;
+    if (!create_face_cache_trigger
+	(handle, topology, "face_del", "face", "DELETE", NULL))
+	return 0;
+    if (!create_face_cache_trigger
+	(handle, topology, "edge_ins", "edge", "INSERT",
+	 "NEW.left_face, NEW.right_face"))
+	return 0;
+    if (!create_face_cache_trigger
+	(handle, topology, "edge_upd", "edge", "UPDATE",
+	 "OLD.left_face, OLD.right_face, NEW.left_face, NEW.right_face"))
+	return 0;
+    if (!create_face_cache_trigger
+	(handle, topology, "edge_del", "edge", "DELETE",
+	 "OLD.left_face, OLD.right_face"))
+	return 0;
+    return 1;
+}
+
+static int
+do_drop_topo_face_cache (sqlite3 * handle, const char *topology)
+{
+/* dropping the Face Cache of some Topology (if any) */
+    char *sql;
+    char *table;
+    char *xtable;
+
+    if (!drop_face_cache_triggers (handle, topology))
+	return 0;
+    if (!face_cache_exists (handle, NULL, topology))
+	return 1;
+
+/* disabling the spatial index */
+    table = sqlite3_mprintf ("%s_face_cache", topology);
+    sql = sqlite3_mprintf ("SELECT DisableSpatialIndex("
+			   "%Q, 'geometry')", table);
+    if (!do_exec_sql (handle, sql, "DisableSpatialIndex"))
+      {
+	  sqlite3_free (table);
+	  return 0;
+      }
+
+/* unregistering the geometry column */
+    sql = sqlite3_mprintf ("SELECT DiscardGeometryColumn("
+			   "%Q, 'geometry')", table);
+    if (!do_exec_sql (handle, sql, "DiscardGeometryColumn"))
+      {
+	  sqlite3_free (table);
+	  return 0;
+      }
+    sqlite3_free (table);
+
+/* dropping the spatial index */
+    table = sqlite3_mprintf ("idx_%s_face_cache_geometry", topology);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql = sqlite3_mprintf ("DROP TABLE IF EXISTS main.\"%s\"", xtable);
+    free (xtable);
+    if (!do_exec_sql (handle, sql, "DROP TABLE"))
+	return 0;
+
+/* dropping the Face Cache table */
+    xtable = face_cache_table_name (topology);
+    sql = sqlite3_mprintf ("DROP TABLE main.\"%s\"", xtable);
+    free (xtable);
+    if (!do_exec_sql (handle, sql, "DROP TABLE"))
+	return 0;
+
+/* removing the change counters */
+    sql =
+	sqlite3_mprintf ("DELETE FROM main.topo_face_caches "
+			 "WHERE topology_name = Lower(%Q)", topology);
+    if (!do_exec_sql (handle, sql, "DELETE FROM topo_face_caches"))
+	return 0;
+    return 1;
+}
+
+RL2_PRIVATE int
+rl2_drop_topo_face_cache (sqlite3 * handle, const char *topology)
+{
+/* dropping the Face Cache of some Topology (if any) */
+    char *name = get_topology_name (handle, topology);
+    int ret;
+    if (name == NULL)
+	return RL2_ERROR;
+    ret = do_drop_topo_face_cache (handle, name);
+    sqlite3_free (name);
+    if (!ret)
+	return RL2_ERROR;
+    return RL2_OK;
+}
+
+static int
+create_face_cache (sqlite3 * handle, const char *topology, int srid)
+{
+/* creating the Face Cache table and its Spatial Index */
+    char *sql;
+    char *table;
+    char *xtable;
+
+/* creating the change counters table (if not already existing) */
+    sql = sqlite3_mprintf ("CREATE TABLE IF NOT EXISTS main.topo_face_caches ("
+			   "topology_name TEXT NOT NULL PRIMARY KEY,\n"
+			   "changes INTEGER NOT NULL DEFAULT 0,\n"
+			   "synced INTEGER NOT NULL DEFAULT 0)");
+    if (!do_exec_sql (handle, sql, "CREATE TABLE topo_face_caches"))
+	return 0;
+
+    xtable = face_cache_table_name (topology);
+    sql = sqlite3_mprintf ("CREATE TABLE main.\"%s\" ("
+			   "face_id INTEGER PRIMARY KEY)", xtable);
+    free (xtable);
+    if (!do_exec_sql (handle, sql, "CREATE TABLE"))
+	return 0;
+
+/* creating the cached geometry */
+    table = sqlite3_mprintf ("%s_face_cache", topology);
+    sql = sqlite3_mprintf ("SELECT AddGeometryColumn("
+			   "%Q, 'geometry', %d, 'GEOMETRY', 'XY')", table,
+			   srid);
+    if (!do_exec_sql (handle, sql, "AddGeometryColumn"))
+      {
+	  sqlite3_free (table);
+	  return 0;
+      }
+
+/* creating the spatial index */
+    sql = sqlite3_mprintf ("SELECT CreateSpatialIndex("
+			   "%Q, 'geometry')", table);
+    sqlite3_free (table);
+    if (!do_exec_sql (handle, sql, "CreateSpatialIndex"))
+	return 0;
+    return 1;
+}
+
+RL2_PRIVATE int
+rl2_build_topo_face_cache (sqlite3 * handle, const char *topology)
+{
+/* (re)building the Face Cache of some Topology */
+    char *name;
+    char *sql;
+    char *xcache;
+    char *prim;
+    char *xprim;
+    int srid;
+
+    name = get_topology_name (handle, topology);
+    if (name == NULL)
+	return RL2_ERROR;
+    srid = get_topology_srid (handle, name);
+
+/* dropping the previous Face Cache (if any) */
+    if (!do_drop_topo_face_cache (handle, name))
+	goto error;
+    if (!create_face_cache (handle, name, srid))
+	goto error;
+
+/* materializing all Face Geometries */
+    xcache = face_cache_table_name (name);
+    prim = sqlite3_mprintf ("%s_face", name);
+    xprim = rl2_double_quoted_sql (prim);
+    sqlite3_free (prim);
+    sql =
+	sqlite3_mprintf ("INSERT INTO main.\"%s\" (face_id, geometry) "
+			 "SELECT face_id, CastToXY(ST_GetFaceGeometry(%Q, face_id)) "
+			 "FROM main.\"%s\" WHERE face_id > 0", xcache, name,
+			 xprim);
+    free (xcache);
+    free (xprim);
+    if (!do_exec_sql (handle, sql, "INSERT INTO face cache"))
+	goto error;
+
+/* registering the change counters and the Triggers */
+    sql =
+	sqlite3_mprintf ("INSERT OR REPLACE INTO main.topo_face_caches "
+			 "(topology_name, changes, synced) VALUES (Lower(%Q), 0, 0)",
+			 name);
+    if (!do_exec_sql (handle, sql, "INSERT INTO topo_face_caches"))
+	goto error;
+    if (!create_face_cache_triggers (handle, name))
+	goto error;
+    sqlite3_free (name);
+    return RL2_OK;
+
+  error:
+    sqlite3_free (name);
+    return RL2_ERROR;
+}
@@ -0,0 +1,577 @@
+/*
+
+ rl2vectorbands -- parallel banded rendering of Vector Coverages
+
+ version 0.1, 2026 October 18
+
+ Author: Sandro Furieri a.furieri@lqt.it
+
+ -----------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2026
+the Initial Developer. All Rights Reserved.
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef LOADABLE_EXTENSION
+#include "rasterlite2/sqlite.h"
+#endif
+
+#include "rasterlite2/rasterlite2.h"
+#include "rasterlite2/rl2graphics.h"
+#include "rasterlite2_private.h"
+
+/*
+/ parallel rendering of a Vector Coverage:
+/
+/ all Features are fetched once (on the main thread) and then the
+/ canvas is split into horizontal bands, each one of them being
+/ painted by its own thread through a private Graphics Context
+/ directly sharing the pixel rows of the target canvas
+/
+/ bands are disjoint and every band paints the same Features in the
+/ same order on the same pixels, so the result is exactly the same
+/ of a serial painting; labels are never painted here and are always
+/ left to the main thread
+*/
+
+/* the minimum height (in pixels) of each band */
+#define RL2_VECTOR_BAND_MIN_HEIGHT	64
+
+/*
+/ a stroke could extend beyond the Feature's MBR up to half the miter
+/ limit (10, the Cairo default) times its width
+*/
+#define RL2_VECTOR_BAND_MITER	5.0
+
+RL2_PRIVATE rl2BandedRendererPtr
+rl2_create_banded_renderer (sqlite3 * handle, const void *priv_data,
+			    void *ctx, int width, int height, double minx,
+			    double miny, double maxx, double maxy,
+			    double x_res, double y_res)
+{
+/*
+/ creating a Banded Renderer
+/
+/ will return NULL if parallel rendering is not enabled or not
+/ applicable at all, and the caller is expected to fall back to
+/ serial painting
+*/
+    rl2BandedRendererPtr renderer;
+    struct rl2_private_data *priv = (struct rl2_private_data *) priv_data;
+    int max_threads;
+
+    if (priv == NULL || ctx == NULL)
+	return NULL;
+    if (!priv->parallel_vector)
+	return NULL;
+    max_threads = priv->max_threads;
+    if (max_threads > 64)
+	max_threads = 64;
+    if (max_threads < 2)
+	return NULL;
+    if (height < RL2_VECTOR_BAND_MIN_HEIGHT * 2)
+	return NULL;
+    if (sqlite3_db_mutex (handle) == NULL)
+      {
+	  /*
+	  / the DB connection is not serialized, so it can't be
+	  / safely shared (e.g. when fetching External Graphics)
+	  */
+	  return NULL;
+      }
+
+    renderer = malloc (sizeof (rl2BandedRenderer));
+    if (renderer == NULL)
+	return NULL;
+    renderer->handle = handle;
+    renderer->priv_data = priv_data;
+    renderer->ctx = ctx;
+    renderer->max_threads = max_threads;
+    renderer->width = width;
+    renderer->height = height;
+    renderer->minx = minx;
+    renderer->miny = miny;
+    renderer->maxx = maxx;
+    renderer->maxy = maxy;
+    renderer->x_res = x_res;
+    renderer->y_res = y_res;
+    renderer->features = NULL;
+    renderer->count = 0;
+    renderer->max = 0;
+    renderer->unbounded = 0;
+    return renderer;
+}
+
+static void
+reset_banded_features (rl2BandedRendererPtr renderer)
+{
+/* releasing all Features */
+    int i;
+    for (i = 0; i < renderer->count; i++)
+      {
+	  rl2BandedFeaturePtr feature = renderer->features + i;
+	  if (feature->geom != NULL)
+	      rl2_destroy_geometry (feature->geom);
+	  if (feature->variant != NULL)
+	      rl2_destroy_variant_array (feature->variant);
+      }
+    renderer->count = 0;
+    renderer->unbounded = 0;
+}
+
+RL2_PRIVATE void
+rl2_destroy_banded_renderer (rl2BandedRendererPtr renderer)
+{
+/* memory cleanup - destroying a Banded Renderer */
+    if (renderer == NULL)
+	return;
+    reset_banded_features (renderer);
+    if (renderer->features != NULL)
+	free (renderer->features);
+    free (renderer);
+}
+
+static double
+stroke_margin (rl2PrivStrokePtr stroke)
+{
+/* how far (in pixels) a Stroke could extend beyond the Feature's MBR */
+    if (stroke == NULL)
+	return 0.0;
+    if (stroke->col_width != NULL)
+	return -1.0;		/* depending on each Feature */
+    return stroke->width * RL2_VECTOR_BAND_MITER;
+}
+
+static double
+graphic_margin (rl2PrivGraphicPtr graphic)
+{
+/* how far (in pixels) a point symbol could extend beyond its Point */
+    rl2PrivGraphicItemPtr item;
+    double margin = 0.0;
+    if (graphic == NULL)
+	return 0.0;
+    if (graphic->col_size != NULL || graphic->col_point_x != NULL
+	|| graphic->col_point_y != NULL || graphic->col_displ_x != NULL
+	|| graphic->col_displ_y != NULL)
+	return -1.0;		/* depending on each Feature */
+    item = graphic->first;
+    while (item != NULL)
+      {
+	  if (item->type == RL2_EXTERNAL_GRAPHIC)
+	      return -1.0;	/* a Bitmap retains its own size */
+	  if (item->type == RL2_MARK_GRAPHIC && item->item != NULL)
+	    {
+		double m;
+		rl2PrivMarkPtr mark = (rl2PrivMarkPtr) (item->item);
+		m = stroke_margin (mark->stroke);
+		if (m < 0.0)
+		    return -1.0;
+		if (m > margin)
+		    margin = m;
+	    }
+	  item = item->next;
+      }
+/* a rotated symbol anchored on its corner stays within twice its size */
+    margin += graphic->size * 2.0;
+    if (graphic->displacement_x < 0.0)
+	margin -= graphic->displacement_x;
+    else
+	margin += graphic->displacement_x;
+    if (graphic->displacement_y < 0.0)
+	margin -= graphic->displacement_y;
+    else
+	margin += graphic->displacement_y;
+    return margin;
+}
+
+static double
+offset_margin (double offset)
+{
+/* absolute value of some offset */
+    return (offset < 0.0) ? -offset : offset;
+}
+
+static double
+symbolizer_margin (rl2VectorSymbolizerPtr symbolizer)
+{
+/*
+/ computing how far (in pixels) a Feature painted by some Symbolizer
+/ could extend beyond its own MBR
+/
+/ will return a negative value if this can't be bounded in advance
+*/
+    rl2PrivVectorSymbolizerPtr sym = (rl2PrivVectorSymbolizerPtr) symbolizer;
+    rl2PrivVectorSymbolizerItemPtr item;
+    double margin = 0.0;
+    double m;
+
+    if (sym == NULL)
+      {
+	  /* the default Symbolizer: 16 pixels square Marks, 1 pixel strokes */
+	  return (16.0 * 2.0) + RL2_VECTOR_BAND_MITER;
+      }
+    item = sym->first;
+    while (item != NULL)
+      {
+	  m = 0.0;
+	  if (item->symbolizer_type == RL2_POINT_SYMBOLIZER
+	      && item->symbolizer != NULL)
+	    {
+		rl2PrivPointSymbolizerPtr point =
+		    (rl2PrivPointSymbolizerPtr) (item->symbolizer);
+		m = graphic_margin (point->graphic);
+	    }
+	  if (item->symbolizer_type == RL2_LINE_SYMBOLIZER
+	      && item->symbolizer != NULL)
+	    {
+		rl2PrivLineSymbolizerPtr line =
+		    (rl2PrivLineSymbolizerPtr) (item->symbolizer);
+		if (line->col_perpoff != NULL)
+		    return -1.0;
+		m = stroke_margin (line->stroke);
+		if (m >= 0.0)
+		    m += offset_margin (line->perpendicular_offset);
+	    }
+	  if (item->symbolizer_type == RL2_POLYGON_SYMBOLIZER
+	      && item->symbolizer != NULL)
+	    {
+		rl2PrivPolygonSymbolizerPtr polyg =
+		    (rl2PrivPolygonSymbolizerPtr) (item->symbolizer);
+		if (polyg->col_displ_x != NULL || polyg->col_displ_y != NULL
+		    || polyg->col_perpoff != NULL)
+		    return -1.0;
+		m = stroke_margin (polyg->stroke);
+		if (m >= 0.0)
+		    m += offset_margin (polyg->displacement_x) +
+			offset_margin (polyg->displacement_y) +
+			offset_margin (polyg->perpendicular_offset);
+	    }
+	  /* TextSymbolizers are never painted by bands */
+	  if (m < 0.0)
+	      return -1.0;
+	  if (m > margin)
+	      margin = m;
+	  item = item->next;
+      }
+    return margin;
+}
+
+RL2_PRIVATE int
+rl2_banded_renderer_add (rl2BandedRendererPtr renderer, rl2GeometryPtr geom,
+			 rl2VectorSymbolizerPtr symbolizer,
+			 rl2VariantArrayPtr variant)
+{
+/*
+/ queueing a Feature to be painted
+/
+/ on success the Renderer takes ownership of both the Geometry and
+/ the Variant Array; the Symbolizer is simply referenced
+*/
+    rl2BandedFeaturePtr feature;
+    if (renderer == NULL || geom == NULL)
+	return 0;
+    if (renderer->count >= renderer->max)
+      {
+	  int max = (renderer->max == 0) ? 1024 : renderer->max * 2;
+	  rl2BandedFeaturePtr p =
+	      realloc (renderer->features, sizeof (rl2BandedFeature) * max);
+	  if (p == NULL)
+	      return 0;
+	  renderer->features = p;
+	  renderer->max = max;
+      }
+    feature = renderer->features + renderer->count;
+    feature->geom = geom;
+    feature->symbolizer = symbolizer;
+    feature->variant = variant;
+    feature->margin = symbolizer_margin (symbolizer);
+    if (feature->margin < 0.0)
+	renderer->unbounded = 1;
+    renderer->count += 1;
+    return 1;
+}
+
+static int
+feature_touches_band (rl2BandedRendererPtr renderer,
+		      rl2BandedFeaturePtr feature, int band_y, int band_height)
+{
+/* checking if a Feature could be painted within some band */
+    double y_top;
+    double y_bottom;
+    rl2GeometryPtr geom = feature->geom;
+    if (geom->maxy < geom->miny)
+	return 1;		/* undefined MBR */
+    y_top =
+	(double) (renderer->height) -
+	((geom->maxy - renderer->miny) / renderer->y_res);
+    y_bottom =
+	(double) (renderer->height) -
+	((geom->miny - renderer->miny) / renderer->y_res);
+    if (y_bottom + feature->margin < (double) band_y)
+	return 0;
+    if (y_top - feature->margin > (double) (band_y + band_height))
+	return 0;
+    return 1;
+}
+
+static void
+do_paint_band (rl2BandedWorkerPtr worker)
+{
+/* painting all Features touching a band */
+    int i;
+    rl2BandedRendererPtr renderer = worker->renderer;
+    if (worker->perf != NULL)
+	rl2_perf_set_thread_counters (worker->perf);
+    rl2_cancel_set_thread_token (worker->cancel);
+    for (i = 0; i < renderer->count; i++)
+      {
+	  rl2BandedFeaturePtr feature = renderer->features + i;
+	  if (rl2_is_cancelled ())
+	      break;
+	  if (!feature_touches_band
+	      (renderer, feature, worker->band_y, worker->band_height))
+	      continue;
+	  rl2_draw_vector_feature (worker->ctx, renderer->handle,
+				   renderer->priv_data, feature->symbolizer,
+				   renderer->height, renderer->minx,
+				   renderer->miny, renderer->maxx,
+				   renderer->maxy, renderer->x_res,
+				   renderer->y_res, feature->geom,
+				   feature->variant, 0);
+      }
+}
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+DWORD WINAPI
+doRunPaintBandThread (void *arg)
+#else
+void *
+doRunPaintBandThread (void *arg)
+#endif
+{
+/* threaded function: painting a band */
+    rl2BandedWorkerPtr worker = (rl2BandedWorkerPtr) arg;
+    do_paint_band (worker);
+#if defined(_WIN32) && !defined(__MINGW32__)
+    return 0;
+#else
+    pthread_exit (NULL);
+    return NULL;
+#endif
+}
+
+static void
+start_paint_band_thread (rl2BandedWorkerPtr worker)
+{
+/* starting a concurrent thread */
+#if defined(_WIN32) && !defined(__MINGW32__)
+    HANDLE thread_handle;
+    HANDLE *p_thread;
+    DWORD dwThreadId;
+    thread_handle =
+	CreateThread (NULL, 0, doRunPaintBandThread, worker, 0, &dwThreadId);
+    if (thread_handle == NULL)
+      {
+	  /* failure: painting on the main thread */
+	  do_paint_band (worker);
+	  return;
+      }
+    p_thread = malloc (sizeof (HANDLE));
+    *p_thread = thread_handle;
+    worker->opaque_thread_id = p_thread;
+#else
+    pthread_t thread_id;
+    pthread_t *p_thread;
+    if (pthread_create (&thread_id, NULL, doRunPaintBandThread, worker) != 0)
+      {
+	  /* failure: painting on the main thread */
+	  do_paint_band (worker);
+	  return;
+      }
+    p_thread = malloc (sizeof (pthread_t));
+    *p_thread = thread_id;
+    worker->opaque_thread_id = p_thread;
+#endif
+}
+
+static void
+join_paint_band_thread (rl2BandedWorkerPtr worker)
+{
+/* waiting until a concurrent thread exits */
+    if (worker->opaque_thread_id == NULL)
+	return;
+#if defined(_WIN32) && !defined(__MINGW32__)
+    WaitForSingleObject (*((HANDLE *) (worker->opaque_thread_id)), INFINITE);
+    CloseHandle (*((HANDLE *) (worker->opaque_thread_id)));
+#else
+    pthread_join (*((pthread_t *) (worker->opaque_thread_id)), NULL);
+#endif
+    free (worker->opaque_thread_id);
+    worker->opaque_thread_id = NULL;
+}
+
+static void
+do_paint_serial (rl2BandedRendererPtr renderer)
+{
+/* fallback: painting all Features directly on the target canvas */
+    int i;
+    for (i = 0; i < renderer->count; i++)
+      {
+	  rl2BandedFeaturePtr feature = renderer->features + i;
+	  if (rl2_is_cancelled ())
+	      break;
+	  rl2_draw_vector_feature (renderer->ctx, renderer->handle,
+				   renderer->priv_data, feature->symbolizer,
+				   renderer->height, renderer->minx,
+				   renderer->miny, renderer->maxx,
+				   renderer->maxy, renderer->x_res,
+				   renderer->y_res, feature->geom,
+				   feature->variant, 0);
+      }
+}
+
+RL2_PRIVATE int
+rl2_banded_renderer_paint (rl2BandedRendererPtr renderer)
+{
+/*
+/ painting all queued Features in parallel (one thread for each band)
+/ directly on the target canvas
+/
+/ all Features are released on completion, so that the same Renderer
+/ could be eventually reused
+*/
+    rl2BandedWorkerPtr workers = NULL;
+    int n_bands;
+    int band_height;
+    int i;
+    int ok = 1;
+    struct rl2_perf_counters *perf;
+    struct rl2_cancel_token *cancel;
+
+    if (renderer == NULL)
+	return 0;
+    if (renderer->count == 0)
+	return 1;
+
+    n_bands = renderer->max_threads;
+    band_height = (renderer->height + n_bands - 1) / n_bands;
+    if (band_height < RL2_VECTOR_BAND_MIN_HEIGHT)
+      {
+	  band_height = RL2_VECTOR_BAND_MIN_HEIGHT;
+	  n_bands = (renderer->height + band_height - 1) / band_height;
+      }
+    if (n_bands > renderer->count)
+      {
+	  /* not worth: too few Features */
+	  n_bands = 1;
+      }
+    if (renderer->unbounded)
+      {
+	  /* some symbol could reach any band: painting serially */
+	  n_bands = 1;
+      }
+    if (n_bands > 1)
+	workers = malloc (sizeof (rl2BandedWorker) * n_bands);
+    if (workers == NULL)
+      {
+	  do_paint_serial (renderer);
+	  reset_banded_features (renderer);
+	  return 1;
+      }
+
+    perf = rl2_perf_get_thread_counters ();
+    cancel = rl2_cancel_get_thread_token ();
+    for (i = 0; i < n_bands; i++)
+      {
+	  /* creating all bands */
+	  rl2BandedWorkerPtr worker = workers + i;
+	  worker->opaque_thread_id = NULL;
+	  worker->renderer = renderer;
+	  worker->band_y = i * band_height;
+	  worker->band_height = band_height;
+	  if (worker->band_y + band_height > renderer->height)
+	      worker->band_height = renderer->height - worker->band_y;
+	  worker->perf = perf;
+	  worker->cancel = cancel;
+	  worker->ctx =
+	      rl2_graph_create_band_context (renderer->ctx, worker->band_y,
+					     worker->band_height);
+	  if (worker->ctx == NULL)
+	      ok = 0;
+      }
+    if (!ok)
+      {
+	  /* unable to create the bands: falling back to serial painting */
+	  for (i = 0; i < n_bands; i++)
+	    {
+		if (workers[i].ctx != NULL)
+		    rl2_graph_destroy_context (workers[i].ctx);
+	    }
+	  free (workers);
+	  do_paint_serial (renderer);
+	  reset_banded_features (renderer);
+	  return 1;
+      }
+
+    for (i = 0; i < n_bands; i++)
+	start_paint_band_thread (workers + i);
+    for (i = 0; i < n_bands; i++)
+	join_paint_band_thread (workers + i);
+
+    for (i = 0; i < n_bands; i++)
+      {
+	  /* completing all bands */
+	  rl2BandedWorkerPtr worker = workers + i;
+	  if (rl2_graph_merge_band (renderer->ctx, worker->ctx, worker->band_y)
+	      != RL2_OK)
+	      ok = 0;
+	  rl2_graph_destroy_context (worker->ctx);
+      }
+    free (workers);
+    reset_banded_features (renderer);
+    if (rl2_is_cancelled ())
+	ok = 0;
+    return ok;
+}
@@ -0,0 +1,752 @@
+/*
+
+ rl2zstd -- trained ZSTD dictionaries
+
+ version 0.1, 2026 October 18
+
+ Author: Sandro Furieri a.furieri@lqt.it
+
+ -----------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2026
+the Initial Developer. All Rights Reserved.
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#ifdef LOADABLE_EXTENSION
+#include "rasterlite2/sqlite.h"
+#endif
+
+#include "rasterlite2/rasterlite2.h"
+#include "rasterlite2_private.h"
+
+#ifndef OMIT_ZSTD		/* only if ZSTD is enabled */
+#include <zstd.h>
+#include <zdict.h>
+
+/* samples larger than this are truncated when training a dictionary */
+#define RL2_ZSTD_MAX_SAMPLE_SIZE	(128 * 1024)
+
+/*
+/ ZSTD Dictionaries
+/
+/ all the Dictionaries trained for some Coverage are loaded when the
+/ Coverage object is created, and are owned by the Coverage itself;
+/ ZSTD frames self-identify the Dictionary they were compressed with,
+/ so that the decoder simply searches it by its Dictionary ID
+/ 
+/ each Dictionary is reference counted: every single compression or
+/ decompression holds a further reference while using the prepared
+/ CDict / DDict, that are lazily created on first use and will never
+/ be destroyed before the Dictionary itself
+*/
+struct rl2_zstd_cdict
+{
+    int level;
+    ZSTD_CDict *cdict;
+    struct rl2_zstd_cdict *next;
+};
+
+struct rl2_zstd_dictionary
+{
+    void *mutex;
+    unsigned int dict_id;
+    int ref_count;
+    unsigned char *dictionary;
+    int dictionary_sz;
+    struct rl2_zstd_cdict *first_cdict;
+    ZSTD_DDict *ddict;
+};
+
+static void
+dictionary_lock (struct rl2_zstd_dictionary *dict)
+{
+/* locking a Dictionary */
+    if (dict->mutex != NULL)
+	sqlite3_mutex_enter ((sqlite3_mutex *) (dict->mutex));
+}
+
+static void
+dictionary_unlock (struct rl2_zstd_dictionary *dict)
+{
+/* unlocking a Dictionary */
+    if (dict->mutex != NULL)
+	sqlite3_mutex_leave ((sqlite3_mutex *) (dict->mutex));
+}
+
+static struct rl2_zstd_dictionary *
+create_dictionary (unsigned int dict_id, const unsigned char *blob,
+		   int blob_sz)
+{
+/* creating a Dictionary (initially holding a single reference) */
+    struct rl2_zstd_dictionary *dict =
+	malloc (sizeof (struct rl2_zstd_dictionary));
+    if (dict == NULL)
+	return NULL;
+    dict->dictionary = malloc (blob_sz);
+    if (dict->dictionary == NULL)
+      {
+	  free (dict);
+	  return NULL;
+      }
+    memcpy (dict->dictionary, blob, blob_sz);
+    dict->mutex = sqlite3_mutex_alloc (SQLITE_MUTEX_FAST);
+    dict->dictionary_sz = blob_sz;
+    dict->dict_id = dict_id;
+    dict->ref_count = 1;
+    dict->first_cdict = NULL;
+    dict->ddict = NULL;
+    return dict;
+}
+
+static void
+release_dictionary (struct rl2_zstd_dictionary *dict)
+{
+/* removing a reference; destroying the Dictionary when no longer used */
+    struct rl2_zstd_cdict *pC;
+    struct rl2_zstd_cdict *pCn;
+    int destroy;
+    dictionary_lock (dict);
+    dict->ref_count -= 1;
+    destroy = (dict->ref_count <= 0) ? 1 : 0;
+    dictionary_unlock (dict);
+    if (!destroy)
+	return;
+    pC = dict->first_cdict;
+    while (pC != NULL)
+      {
+	  pCn = pC->next;
+	  ZSTD_freeCDict (pC->cdict);
+	  free (pC);
+	  pC = pCn;
+      }
+    if (dict->ddict != NULL)
+	ZSTD_freeDDict (dict->ddict);
+    if (dict->mutex != NULL)
+	sqlite3_mutex_free ((sqlite3_mutex *) (dict->mutex));
+    free (dict->dictionary);
+    free (dict);
+}
+
+static struct rl2_zstd_dictionary *
+acquire_dictionary (rl2PrivCoveragePtr cvg, unsigned int dict_id)
+{
+/* 
+/ searching a Dictionary loaded by some Coverage
+/ the returned Dictionary holds a further reference, and must
+/ always be released by calling release_dictionary()
+*/
+    int i;
+    if (cvg == NULL || dict_id == 0)
+	return NULL;
+    for (i = 0; i < cvg->nZstdDicts; i++)
+      {
+	  struct rl2_zstd_dictionary *dict = cvg->zstdDicts[i];
+	  if (dict->dict_id == dict_id)
+	    {
+		dictionary_lock (dict);
+		dict->ref_count += 1;
+		dictionary_unlock (dict);
+		return dict;
+	    }
+      }
+    return NULL;
+}
+
+static const ZSTD_CDict *
+get_cdict (struct rl2_zstd_dictionary *dict, int level)
+{
+/* returning the prepared CDict for some compression level */
+    struct rl2_zstd_cdict *pC;
+    const ZSTD_CDict *cdict = NULL;
+    dictionary_lock (dict);
+    pC = dict->first_cdict;
+    while (pC != NULL)
+      {
+	  if (pC->level == level)
+	    {
+		cdict = pC->cdict;
+		break;
+	    }
+	  pC = pC->next;
+      }
+    if (cdict == NULL)
+      {
+	  ZSTD_CDict *new_cdict =
+	      ZSTD_createCDict (dict->dictionary, dict->dictionary_sz, level);
+	  pC = malloc (sizeof (struct rl2_zstd_cdict));
+	  if (new_cdict != NULL && pC != NULL)
+	    {
+		pC->level = level;
+		pC->cdict = new_cdict;
+		pC->next = dict->first_cdict;
+		dict->first_cdict = pC;
+		cdict = new_cdict;
+	    }
+	  else
+	    {
+		if (new_cdict != NULL)
+		    ZSTD_freeCDict (new_cdict);
+		if (pC != NULL)
+		    free (pC);
+	    }
+      }
+    dictionary_unlock (dict);
+    return cdict;
+}
+
+static const ZSTD_DDict *
+get_ddict (struct rl2_zstd_dictionary *dict)
+{
+/* returning the prepared DDict */
+    const ZSTD_DDict *ddict;
+    dictionary_lock (dict);
+    if (dict->ddict == NULL)
+	dict->ddict = ZSTD_createDDict (dict->dictionary, dict->dictionary_sz);
+    ddict = dict->ddict;
+    dictionary_unlock (dict);
+    return ddict;
+}
+
+RL2_PRIVATE size_t
+rl2_zstd_compress (void *dst, size_t dst_capacity, const void *src,
+		   size_t src_size, int level, rl2CoveragePtr ptr)
+{
+/* 
+/ ZSTD compression - using the current Dictionary of the given
+/ Coverage (if any)
+*/
+    rl2PrivCoveragePtr cvg = (rl2PrivCoveragePtr) ptr;
+    struct rl2_zstd_dictionary *dict = NULL;
+    const ZSTD_CDict *cdict = NULL;
+    ZSTD_CCtx *cctx = NULL;
+    size_t ret;
+    if (cvg != NULL)
+	dict = acquire_dictionary (cvg, cvg->zstdDictId);
+    if (dict != NULL)
+      {
+	  cdict = get_cdict (dict, level);
+	  if (cdict != NULL)
+	      cctx = ZSTD_createCCtx ();
+      }
+    if (cctx == NULL)
+	ret = ZSTD_compress (dst, dst_capacity, src, src_size, level);
+    else
+      {
+	  ret =
+	      ZSTD_compress_usingCDict (cctx, dst, dst_capacity, src, src_size,
+					cdict);
+	  ZSTD_freeCCtx (cctx);
+      }
+    if (dict != NULL)
+	release_dictionary (dict);
+    return ret;
+}
+
+RL2_PRIVATE size_t
+rl2_zstd_decompress (void *dst, size_t dst_capacity, const void *src,
+		     size_t src_size, rl2CoveragePtr ptr)
+{
+/*
+/ ZSTD decompression
+/ a frame referencing some Dictionary requires the Coverage that
+/ loaded it; any other frame can be decompressed without a Coverage
+*/
+    rl2PrivCoveragePtr cvg = (rl2PrivCoveragePtr) ptr;
+    struct rl2_zstd_dictionary *dict;
+    const ZSTD_DDict *ddict;
+    ZSTD_DCtx *dctx;
+    size_t ret = 0;
+    unsigned int dict_id = ZSTD_getDictID_fromFrame (src, src_size);
+    if (dict_id == 0)
+	return ZSTD_decompress (dst, dst_capacity, src, src_size);
+    dict = acquire_dictionary (cvg, dict_id);
+    if (dict == NULL)
+      {
+	  fprintf (stderr,
+		   "ZSTD: missing Dictionary ID=%u (not loaded by the Coverage)\n",
+		   dict_id);
+	  return 0;
+      }
+    ddict = get_ddict (dict);
+    dctx = ZSTD_createDCtx ();
+    if (ddict != NULL && dctx != NULL)
+	ret =
+	    ZSTD_decompress_usingDDict (dctx, dst, dst_capacity, src, src_size,
+					ddict);
+    if (dctx != NULL)
+	ZSTD_freeDCtx (dctx);
+    release_dictionary (dict);
+    return ret;
+}
+
+static int
+has_dictionaries_table (sqlite3 * handle, const char *db_prefix,
+			const char *coverage)
+{
+/* checking if a Coverage has some trained Dictionary */
+    int ret;
+    int i;
+    char **results;
+    int rows;
+    int columns;
+    char *sql;
+    char *table;
+    char *xdb_prefix;
+    int exists = 0;
+
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    table = sqlite3_mprintf ("%s_zstd_dicts", coverage);
+    sql =
+	sqlite3_mprintf
+	("SELECT Count(*) FROM \"%s\".sqlite_master WHERE type = 'table' "
+	 "AND Lower(name) = Lower(%Q)", xdb_prefix, table);
+    free (xdb_prefix);
+    sqlite3_free (table);
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    for (i = 1; i <= rows; i++)
+      {
+	  if (atoi (results[(i * columns) + 0]) > 0)
+	      exists = 1;
+      }
+    sqlite3_free_table (results);
+    return exists;
+}
+
+RL2_PRIVATE int
+rl2_load_zstd_dictionaries (sqlite3 * handle, const char *db_prefix,
+			    rl2CoveragePtr ptr)
+{
+/*
+/ loading all the Dictionaries trained for some Coverage
+/ the most recently trained one will be used for compressing new tiles,
+/ all the others are still required for decoding older tiles
+*/
+    rl2PrivCoveragePtr cvg = (rl2PrivCoveragePtr) ptr;
+    char *sql;
+    char *table;
+    char *xtable;
+    char *xdb_prefix;
+    int ret;
+    sqlite3_stmt *stmt = NULL;
+    struct rl2_zstd_dictionary **dicts = NULL;
+    int count = 0;
+    int max = 0;
+
+    if (cvg == NULL)
+	return RL2_ERROR;
+    if (cvg->Compression != RL2_COMPRESSION_ZSTD
+	&& cvg->Compression != RL2_COMPRESSION_ZSTD_NO)
+	return RL2_OK;
+    if (!has_dictionaries_table (handle, db_prefix, cvg->coverageName))
+	return RL2_OK;
+
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    table = sqlite3_mprintf ("%s_zstd_dicts", cvg->coverageName);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql =
+	sqlite3_mprintf ("SELECT dict_id, dictionary FROM \"%s\".\"%s\" "
+			 "ORDER BY seq", xdb_prefix, xtable);
+    free (xdb_prefix);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    while (1)
+      {
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;
+	  if (ret == SQLITE_ROW)
+	    {
+		unsigned int dict_id;
+		const unsigned char *blob;
+		int blob_sz;
+		struct rl2_zstd_dictionary *dict;
+		if (sqlite3_column_type (stmt, 0) != SQLITE_INTEGER
+		    || sqlite3_column_type (stmt, 1) != SQLITE_BLOB)
+		    continue;
+		dict_id = (unsigned int) sqlite3_column_int64 (stmt, 0);
+		blob = sqlite3_column_blob (stmt, 1);
+		blob_sz = sqlite3_column_bytes (stmt, 1);
+		if (ZSTD_getDictID_fromDict (blob, blob_sz) != dict_id)
+		    continue;
+		if (count >= max)
+		  {
+		      struct rl2_zstd_dictionary **new_dicts;
+		      max += 8;
+		      new_dicts =
+			  realloc (dicts,
+				   sizeof (struct rl2_zstd_dictionary *) * max);
+		      if (new_dicts == NULL)
+			  goto error;
+		      dicts = new_dicts;
+		  }
+		dict = create_dictionary (dict_id, blob, blob_sz);
+		if (dict == NULL)
+		    goto error;
+		dicts[count++] = dict;
+	    }
+	  else
+	    {
+		fprintf (stderr,
+			 "SELECT ZSTD Dictionaries; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (handle));
+		goto error;
+	    }
+      }
+    sqlite3_finalize (stmt);
+
+    rl2_release_zstd_dictionaries (ptr);
+    cvg->zstdDicts = dicts;
+    cvg->nZstdDicts = count;
+    if (count > 0)
+	cvg->zstdDictId = dicts[count - 1]->dict_id;
+    return RL2_OK;
+
+  error:
+    if (stmt != NULL)
+	sqlite3_finalize (stmt);
+    while (count > 0)
+	release_dictionary (dicts[--count]);
+    if (dicts != NULL)
+	free (dicts);
+    return RL2_ERROR;
+}
+
+RL2_PRIVATE void
+rl2_release_zstd_dictionaries (rl2CoveragePtr ptr)
+{
+/* releasing all the Dictionaries referenced by some Coverage */
+    rl2PrivCoveragePtr cvg = (rl2PrivCoveragePtr) ptr;
+    int i;
+    if (cvg == NULL)
+	return;
+    for (i = 0; i < cvg->nZstdDicts; i++)
+	release_dictionary (cvg->zstdDicts[i]);
+    if (cvg->zstdDicts != NULL)
+	free (cvg->zstdDicts);
+    cvg->zstdDicts = NULL;
+    cvg->nZstdDicts = 0;
+    cvg->zstdDictId = 0;
+}
+
+static int
+add_training_sample (rl2CoveragePtr cvg, unsigned char **samples,
+		     size_t *samples_sz, size_t *max_samples_sz,
+		     size_t *sizes, int *count, const unsigned char *blob,
+		     int blob_sz)
+{
+/* appending the uncompressed payload of some tile block */
+    unsigned char *payload;
+    int payload_sz;
+    if (blob == NULL)
+	return 1;
+    if (rl2_get_zstd_payload (blob, blob_sz, &payload, &payload_sz, cvg) !=
+	RL2_OK)
+	return 1;		/* not ZSTD compressed: silently ignored */
+    if (payload_sz > RL2_ZSTD_MAX_SAMPLE_SIZE)
+	payload_sz = RL2_ZSTD_MAX_SAMPLE_SIZE;
+    if (*samples_sz + payload_sz > *max_samples_sz)
+      {
+	  size_t new_sz = *max_samples_sz + (4 * RL2_ZSTD_MAX_SAMPLE_SIZE);
+	  unsigned char *new_samples;
+	  if (new_sz < *samples_sz + payload_sz)
+	      new_sz = *samples_sz + payload_sz;
+	  new_samples = realloc (*samples, new_sz);
+	  if (new_samples == NULL)
+	    {
+		free (payload);
+		return 0;
+	    }
+	  *samples = new_samples;
+	  *max_samples_sz = new_sz;
+      }
+    memcpy (*samples + *samples_sz, payload, payload_sz);
+    free (payload);
+    *samples_sz += payload_sz;
+    sizes[*count] = payload_sz;
+    *count += 1;
+    return 1;
+}
+
+static int
+store_dictionary (sqlite3 * handle, const char *coverage,
+		  unsigned int dict_id, int num_samples,
+		  const unsigned char *dictionary, int dictionary_sz)
+{
+/* permanently storing a trained Dictionary */
+    char *sql;
+    char *table;
+    char *xtable;
+    int ret;
+    sqlite3_stmt *stmt = NULL;
+
+    table = sqlite3_mprintf ("%s_zstd_dicts", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql = sqlite3_mprintf ("CREATE TABLE IF NOT EXISTS main.\"%s\" ("
+			   "seq INTEGER PRIMARY KEY AUTOINCREMENT,\n"
+			   "dict_id INTEGER NOT NULL UNIQUE,\n"
+			   "num_samples INTEGER NOT NULL,\n"
+			   "trained TIMESTAMP NOT NULL DEFAULT "
+			   "(strftime('%%Y-%%m-%%dT%%H:%%M:%%fZ', 'now')),\n"
+			   "dictionary BLOB NOT NULL)", xtable);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CREATE TABLE \"%s_zstd_dicts\" error: %s\n",
+		   coverage, sqlite3_errmsg (handle));
+	  free (xtable);
+	  return 0;
+      }
+    /* re-training an identical Dictionary simply makes it the current one */
+    sql = sqlite3_mprintf ("INSERT OR REPLACE INTO main.\"%s\" "
+			   "(seq, dict_id, num_samples, dictionary) "
+			   "VALUES (NULL, ?, ?, ?)", xtable);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    sqlite3_bind_int64 (stmt, 1, dict_id);
+    sqlite3_bind_int (stmt, 2, num_samples);
+    sqlite3_bind_blob (stmt, 3, dictionary, dictionary_sz, SQLITE_STATIC);
+    ret = sqlite3_step (stmt);
+    sqlite3_finalize (stmt);
+    if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+	return 1;
+    fprintf (stderr, "INSERT INTO \"%s_zstd_dicts\" error: %s\n", coverage,
+	     sqlite3_errmsg (handle));
+    return 0;
+}
+
+RL2_PRIVATE int
+rl2_train_zstd_dictionary (sqlite3 * handle, const char *coverage,
+			   int max_samples, int dict_size,
+			   unsigned int *dict_id)
+{
+/*
+/ training a ZSTD Dictionary by sampling the tiles already stored
+/ into some ZSTD compressed Coverage
+/
+/ samples are evenly spread across the whole TILE_DATA table; each
+/ sample is the uncompressed payload of an Odd or Even block, i.e.
+/ exactly the same bytes the compressor will then see
+*/
+    rl2CoveragePtr cvg = NULL;
+    rl2PrivCoveragePtr priv;
+    char *sql;
+    char *table;
+    char *xtable;
+    int ret;
+    sqlite3_stmt *stmt = NULL;
+    sqlite3_int64 num_tiles = 0;
+    sqlite3_int64 step;
+    unsigned char *samples = NULL;
+    size_t samples_sz = 0;
+    size_t max_samples_sz = 0;
+    size_t *sizes = NULL;
+    int count = 0;
+    unsigned char *dictionary = NULL;
+    size_t dictionary_sz;
+
+    *dict_id = 0;
+    if (coverage == NULL || max_samples <= 0 || dict_size <= 0)
+	return RL2_ERROR;
+    cvg = rl2_create_coverage_from_dbms (handle, NULL, coverage);
+    if (cvg == NULL)
+	return RL2_ERROR;
+    priv = (rl2PrivCoveragePtr) cvg;
+    if (priv->Compression != RL2_COMPRESSION_ZSTD
+	&& priv->Compression != RL2_COMPRESSION_ZSTD_NO)
+      {
+	  fprintf (stderr,
+		   "ZSTD Dictionary: Coverage \"%s\" isn't ZSTD compressed\n",
+		   coverage);
+	  goto error;
+      }
+
+/* counting how many tiles are there */
+    table = sqlite3_mprintf ("%s_tile_data", coverage);
+    xtable = rl2_double_quoted_sql (table);
+    sqlite3_free (table);
+    sql = sqlite3_mprintf ("SELECT Count(*) FROM main.\"%s\"", xtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  free (xtable);
+	  goto error;
+      }
+    if (sqlite3_step (stmt) == SQLITE_ROW)
+	num_tiles = sqlite3_column_int64 (stmt, 0);
+    sqlite3_finalize (stmt);
+    stmt = NULL;
+    step = num_tiles / max_samples;
+    if (step < 1)
+	step = 1;
+
+/* collecting the samples */
+    sql = sqlite3_mprintf ("SELECT tile_data_odd, tile_data_even "
+			   "FROM main.\"%s\" WHERE (tile_id %% ?) = 0 "
+			   "ORDER BY tile_id LIMIT ?", xtable);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    sizes = malloc (sizeof (size_t) * max_samples * 2);
+    if (sizes == NULL)
+	goto error;
+    sqlite3_bind_int64 (stmt, 1, step);
+    sqlite3_bind_int (stmt, 2, max_samples);
+    while (1)
+      {
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;
+	  if (ret == SQLITE_ROW)
+	    {
+		int ib;
+		for (ib = 0; ib < 2; ib++)
+		  {
+		      if (sqlite3_column_type (stmt, ib) != SQLITE_BLOB)
+			  continue;
+		      if (!add_training_sample
+			  (cvg, &samples, &samples_sz, &max_samples_sz, sizes,
+			   &count, sqlite3_column_blob (stmt, ib),
+			   sqlite3_column_bytes (stmt, ib)))
+			  goto error;
+		  }
+	    }
+	  else
+	    {
+		fprintf (stderr,
+			 "SELECT ZSTD samples; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (handle));
+		goto error;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    stmt = NULL;
+    if (count < 8)
+      {
+	  fprintf (stderr,
+		   "ZSTD Dictionary: too few samples (%d) for Coverage \"%s\"\n",
+		   count, coverage);
+	  goto error;
+      }
+
+/* training the Dictionary */
+    dictionary = malloc (dict_size);
+    if (dictionary == NULL)
+	goto error;
+    dictionary_sz =
+	ZDICT_trainFromBuffer (dictionary, dict_size, samples, sizes, count);
+    if (ZDICT_isError (dictionary_sz))
+      {
+	  fprintf (stderr, "ZSTD Dictionary: training error: %s\n",
+		   ZDICT_getErrorName (dictionary_sz));
+	  goto error;
+      }
+    *dict_id = ZDICT_getDictID (dictionary, dictionary_sz);
+    if (*dict_id == 0)
+	goto error;
+    if (!store_dictionary
+	(handle, coverage, *dict_id, count, dictionary, dictionary_sz))
+	goto error;
+
+    free (dictionary);
+    free (samples);
+    free (sizes);
+    rl2_destroy_coverage (cvg);
+    return RL2_OK;
+
+  error:
+    *dict_id = 0;
+    if (stmt != NULL)
+	sqlite3_finalize (stmt);
+    if (dictionary != NULL)
+	free (dictionary);
+    if (samples != NULL)
+	free (samples);
+    if (sizes != NULL)
+	free (sizes);
+    if (cvg != NULL)
+	rl2_destroy_coverage (cvg);
+    return RL2_ERROR;
+}
+
+#else /* ZSTD is disabled */
+
+RL2_PRIVATE int
+rl2_load_zstd_dictionaries (sqlite3 * handle, const char *db_prefix,
+			    rl2CoveragePtr ptr)
+{
+/* ZSTD is disabled: there are no Dictionaries at all */
+    return RL2_OK;
+}
+
+RL2_PRIVATE void
+rl2_release_zstd_dictionaries (rl2CoveragePtr ptr)
+{
+/* ZSTD is disabled: there are no Dictionaries at all */
+}
+
+RL2_PRIVATE int
+rl2_train_zstd_dictionary (sqlite3 * handle, const char *coverage,
+			   int max_samples, int dict_size,
+			   unsigned int *dict_id)
+{
+/* ZSTD is disabled: always failing */
+    *dict_id = 0;
+    fprintf (stderr, "librasterlite2 was built by disabling ZSTD support\n");
+    return RL2_ERROR;
+}
+
+#endif /* end ZSTD conditional */
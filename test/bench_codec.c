@@ -0,0 +1,385 @@
+/*
+
+ bench_codec.c -- RasterLite-2 Benchmark: tile encoding / decoding
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2019
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "rasterlite2/rasterlite2.h"
+
+#include "bench_common.h"
+
+#define BENCH_TILE_SIZE	256
+
+struct bench_raster_type
+{
+    const char *name;
+    unsigned char sample_type;
+    unsigned char pixel_type;
+    unsigned char num_bands;
+};
+
+struct bench_compression
+{
+    const char *name;
+    unsigned char compression;
+    int quality;
+};
+
+static struct bench_raster_type raster_types[] = {
+    {"1-BIT/MONOCHROME", RL2_SAMPLE_1_BIT, RL2_PIXEL_MONOCHROME, 1},
+    {"1-BIT/PALETTE", RL2_SAMPLE_1_BIT, RL2_PIXEL_PALETTE, 1},
+    {"2-BIT/PALETTE", RL2_SAMPLE_2_BIT, RL2_PIXEL_PALETTE, 1},
+    {"4-BIT/PALETTE", RL2_SAMPLE_4_BIT, RL2_PIXEL_PALETTE, 1},
+    {"UINT8/PALETTE", RL2_SAMPLE_UINT8, RL2_PIXEL_PALETTE, 1},
+    {"2-BIT/GRAYSCALE", RL2_SAMPLE_2_BIT, RL2_PIXEL_GRAYSCALE, 1},
+    {"4-BIT/GRAYSCALE", RL2_SAMPLE_4_BIT, RL2_PIXEL_GRAYSCALE, 1},
+    {"UINT8/GRAYSCALE", RL2_SAMPLE_UINT8, RL2_PIXEL_GRAYSCALE, 1},
+    {"UINT8/RGB", RL2_SAMPLE_UINT8, RL2_PIXEL_RGB, 3},
+    {"UINT16/RGB", RL2_SAMPLE_UINT16, RL2_PIXEL_RGB, 3},
+    {"UINT8/MULTIBAND", RL2_SAMPLE_UINT8, RL2_PIXEL_MULTIBAND, 4},
+    {"UINT16/MULTIBAND", RL2_SAMPLE_UINT16, RL2_PIXEL_MULTIBAND, 4},
+    {"INT8/DATAGRID", RL2_SAMPLE_INT8, RL2_PIXEL_DATAGRID, 1},
+    {"UINT8/DATAGRID", RL2_SAMPLE_UINT8, RL2_PIXEL_DATAGRID, 1},
+    {"INT16/DATAGRID", RL2_SAMPLE_INT16, RL2_PIXEL_DATAGRID, 1},
+    {"UINT16/DATAGRID", RL2_SAMPLE_UINT16, RL2_PIXEL_DATAGRID, 1},
+    {"INT32/DATAGRID", RL2_SAMPLE_INT32, RL2_PIXEL_DATAGRID, 1},
+    {"UINT32/DATAGRID", RL2_SAMPLE_UINT32, RL2_PIXEL_DATAGRID, 1},
+    {"FLOAT/DATAGRID", RL2_SAMPLE_FLOAT, RL2_PIXEL_DATAGRID, 1},
+    {"DOUBLE/DATAGRID", RL2_SAMPLE_DOUBLE, RL2_PIXEL_DATAGRID, 1},
+    {NULL, 0, 0, 0}
+};
+
+static struct bench_compression compressions[] = {
+    {"NONE", RL2_COMPRESSION_NONE, 100},
+    {"DEFLATE", RL2_COMPRESSION_DEFLATE, 100},
+    {"DEFLATE_NO", RL2_COMPRESSION_DEFLATE_NO, 100},
+    {"LZMA", RL2_COMPRESSION_LZMA, 100},
+    {"LZMA_NO", RL2_COMPRESSION_LZMA_NO, 100},
+    {"LZ4", RL2_COMPRESSION_LZ4, 100},
+    {"LZ4_NO", RL2_COMPRESSION_LZ4_NO, 100},
+    {"ZSTD", RL2_COMPRESSION_ZSTD, 100},
+    {"ZSTD_NO", RL2_COMPRESSION_ZSTD_NO, 100},
+    {"PNG", RL2_COMPRESSION_PNG, 100},
+    {"JPEG", RL2_COMPRESSION_JPEG, 80},
+    {"WEBP", RL2_COMPRESSION_LOSSY_WEBP, 80},
+    {"LL_WEBP", RL2_COMPRESSION_LOSSLESS_WEBP, 100},
+    {"FAX4", RL2_COMPRESSION_CCITTFAX4, 100},
+    {"JP2", RL2_COMPRESSION_LOSSY_JP2, 80},
+    {"LL_JP2", RL2_COMPRESSION_LOSSLESS_JP2, 100},
+    {NULL, 0, 0}
+};
+
+static int
+sample_size (unsigned char sample_type)
+{
+/* returns the size (in bytes) of a single sample */
+    switch (sample_type)
+      {
+      case RL2_SAMPLE_INT16:
+      case RL2_SAMPLE_UINT16:
+	  return 2;
+      case RL2_SAMPLE_INT32:
+      case RL2_SAMPLE_UINT32:
+      case RL2_SAMPLE_FLOAT:
+	  return 4;
+      case RL2_SAMPLE_DOUBLE:
+	  return 8;
+      };
+    return 1;
+}
+
+static unsigned int
+bench_random (unsigned int *seed)
+{
+/* simple deterministic LCG - the same data for every run */
+    *seed = (*seed * 1103515245) + 12345;
+    return (*seed / 65536) % 32768;
+}
+
+static double
+synthetic_value (unsigned int x, unsigned int y, unsigned int band,
+		 unsigned int *seed)
+{
+/* a smooth terrain-like surface with a bit of noise */
+    double v = sin ((double) x / 23.0) * cos ((double) y / 31.0);
+    v += (double) (x + y + (band * 17)) / (2.0 * BENCH_TILE_SIZE);
+    v += (double) (bench_random (seed) % 8) / 256.0;
+    return v;			/* roughly in the range -1.0 .. +2.0 */
+}
+
+static unsigned char *
+build_buffer (const struct bench_raster_type *type, int *size)
+{
+/* building a synthetic pixel buffer */
+    unsigned int x;
+    unsigned int y;
+    unsigned int b;
+    unsigned int seed = 1;
+    int nbytes = sample_size (type->sample_type);
+    int sz =
+	BENCH_TILE_SIZE * BENCH_TILE_SIZE * type->num_bands * nbytes;
+    unsigned char *buf = malloc (sz);
+    unsigned char *p = buf;
+    if (buf == NULL)
+	return NULL;
+    for (y = 0; y < BENCH_TILE_SIZE; y++)
+      {
+	  for (x = 0; x < BENCH_TILE_SIZE; x++)
+	    {
+		for (b = 0; b < type->num_bands; b++)
+		  {
+		      double v = synthetic_value (x, y, b, &seed);
+		      double norm = (v + 1.0) / 3.0;	/* 0.0 .. 1.0 */
+		      if (norm < 0.0)
+			  norm = 0.0;
+		      if (norm > 1.0)
+			  norm = 1.0;
+		      switch (type->sample_type)
+			{
+			case RL2_SAMPLE_1_BIT:
+			    *p++ = (norm > 0.5) ? 1 : 0;
+			    break;
+			case RL2_SAMPLE_2_BIT:
+			    *p++ = (unsigned char) (norm * 3.0);
+			    break;
+			case RL2_SAMPLE_4_BIT:
+			    *p++ = (unsigned char) (norm * 15.0);
+			    break;
+			case RL2_SAMPLE_INT8:
+			    *((char *) p) = (char) ((norm * 255.0) - 128.0);
+			    p++;
+			    break;
+			case RL2_SAMPLE_UINT8:
+			    *p++ = (unsigned char) (norm * 255.0);
+			    break;
+			case RL2_SAMPLE_INT16:
+			    *((short *) p) = (short) (v * 1000.0);
+			    p += 2;
+			    break;
+			case RL2_SAMPLE_UINT16:
+			    *((unsigned short *) p) =
+				(unsigned short) (norm * 65535.0);
+			    p += 2;
+			    break;
+			case RL2_SAMPLE_INT32:
+			    *((int *) p) = (int) (v * 100000.0);
+			    p += 4;
+			    break;
+			case RL2_SAMPLE_UINT32:
+			    *((unsigned int *) p) =
+				(unsigned int) (norm * 1000000.0);
+			    p += 4;
+			    break;
+			case RL2_SAMPLE_FLOAT:
+			    *((float *) p) = (float) (v * 1000.0);
+			    p += 4;
+			    break;
+			case RL2_SAMPLE_DOUBLE:
+			    *((double *) p) = v * 1000.0;
+			    p += 8;
+			    break;
+			};
+		  }
+	    }
+      }
+    *size = sz;
+    return buf;
+}
+
+static rl2PalettePtr
+build_palette (const struct bench_raster_type *type)
+{
+/* building a Palette (if required) */
+    int i;
+    int num;
+    rl2PalettePtr plt;
+    if (type->pixel_type != RL2_PIXEL_PALETTE)
+	return NULL;
+    switch (type->sample_type)
+      {
+      case RL2_SAMPLE_1_BIT:
+	  num = 2;
+	  break;
+      case RL2_SAMPLE_2_BIT:
+	  num = 4;
+	  break;
+      case RL2_SAMPLE_4_BIT:
+	  num = 16;
+	  break;
+      default:
+	  num = 256;
+	  break;
+      };
+    plt = rl2_create_palette (num);
+    for (i = 0; i < num; i++)
+	rl2_set_palette_color (plt, i, (i * 7) % 256, (i * 13) % 256,
+			       255 - ((i * 3) % 256));
+    return plt;
+}
+
+static rl2RasterPtr
+build_raster (const struct bench_raster_type *type)
+{
+/* building a synthetic Raster */
+    rl2RasterPtr rst;
+    int size;
+    rl2PalettePtr plt;
+    unsigned char *buf = build_buffer (type, &size);
+    if (buf == NULL)
+	return NULL;
+    plt = build_palette (type);
+    rst =
+	rl2_create_raster (BENCH_TILE_SIZE, BENCH_TILE_SIZE,
+			   type->sample_type, type->pixel_type,
+			   type->num_bands, buf, size, plt, NULL, 0, NULL);
+    if (rst == NULL)
+      {
+	  free (buf);
+	  if (plt != NULL)
+	      rl2_destroy_palette (plt);
+      }
+    return rst;
+}
+
+static int
+bench_case (const struct bench_raster_type *type,
+	    const struct bench_compression *codec, int iterations)
+{
+/* benchmarking a single Sample Type / Compression combination */
+    int i;
+    char name[128];
+    struct bench_samples enc;
+    struct bench_samples dec;
+    unsigned char *blob_odd;
+    int blob_odd_sz;
+    unsigned char *blob_even;
+    int blob_even_sz;
+    double raw_bytes;
+    double blob_bytes = 0.0;
+    rl2PalettePtr plt;
+    rl2RasterPtr rst = build_raster (type);
+    if (rst == NULL)
+	return 0;
+
+/* testing first if this combination is supported at all */
+    if (rl2_raster_encode
+	(rst, codec->compression, &blob_odd, &blob_odd_sz, &blob_even,
+	 &blob_even_sz, codec->quality, 1) != RL2_OK)
+      {
+	  rl2_destroy_raster (rst);
+	  return 0;
+      }
+    free (blob_odd);
+    if (blob_even != NULL)
+	free (blob_even);
+
+    raw_bytes =
+	(double) BENCH_TILE_SIZE *(double) BENCH_TILE_SIZE *
+	(double) (type->num_bands) * (double) sample_size (type->sample_type);
+    sprintf (name, "%s/%s", type->name, codec->name);
+    bench_samples_init (&enc);
+    bench_samples_init (&dec);
+    plt = build_palette (type);
+
+    for (i = 0; i < iterations; i++)
+      {
+	  double t0;
+	  double t1;
+	  rl2RasterPtr out;
+	  t0 = bench_now ();
+	  if (rl2_raster_encode
+	      (rst, codec->compression, &blob_odd, &blob_odd_sz, &blob_even,
+	       &blob_even_sz, codec->quality, 1) != RL2_OK)
+	      break;
+	  t1 = bench_now ();
+	  bench_samples_add (&enc, t1 - t0);
+	  blob_bytes = (double) blob_odd_sz + (double) blob_even_sz;
+
+	  t0 = bench_now ();
+	  out =
+	      rl2_raster_decode (RL2_SCALE_1, blob_odd, blob_odd_sz,
+				 blob_even, blob_even_sz,
+				 (plt == NULL) ? NULL : rl2_clone_palette (plt));
+	  t1 = bench_now ();
+	  if (out != NULL)
+	    {
+		bench_samples_add (&dec, t1 - t0);
+		rl2_destroy_raster (out);
+	    }
+	  free (blob_odd);
+	  if (blob_even != NULL)
+	      free (blob_even);
+      }
+
+    bench_json_result (name, "encode", &enc, raw_bytes, 1.0);
+    bench_json_result (name, "decode", &dec, raw_bytes, 1.0);
+    fprintf (stderr, "%-32s ratio %6.2f:1\n", name,
+	     (blob_bytes > 0.0) ? raw_bytes / blob_bytes : 0.0);
+    bench_samples_reset (&enc);
+    bench_samples_reset (&dec);
+    if (plt != NULL)
+	rl2_destroy_palette (plt);
+    rl2_destroy_raster (rst);
+    return 1;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int t;
+    int c;
+    int iterations = bench_iterations (BENCH_DEFAULT_ITERATIONS);
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+    bench_json_begin ("codec");
+    for (t = 0; raster_types[t].name != NULL; t++)
+      {
+	  for (c = 0; compressions[c].name != NULL; c++)
+	      bench_case (&(raster_types[t]), &(compressions[c]), iterations);
+      }
+    bench_json_end ();
+    return 0;
+}
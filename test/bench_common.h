@@ -0,0 +1,226 @@
+/*
+
+ bench_common.h -- RasterLite-2 Benchmark helpers
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2019
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+
+/*
+/ common helpers shared by all bench_*.c programs
+/
+/ each benchmark program prints a single JSON document on stdout:
+/ {"suite": "...", "results": [ {...}, {...} ], "peak_rss_kb": N}
+/
+/ every result object reports the number of iterations, the
+/ throughput (MB/s and tiles/s) and the p50/p99 latency in millis
+*/
+
+#include <sys/time.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#define BENCH_DEFAULT_ITERATIONS	20
+
+struct bench_samples
+{
+    double *values;
+    int count;
+    int max;
+};
+
+static int bench_json_items = 0;
+
+static double
+bench_now (void)
+{
+/* returns the current wall-clock time in seconds */
+    struct timeval tv;
+    gettimeofday (&tv, NULL);
+    return (double) tv.tv_sec + ((double) tv.tv_usec / 1000000.0);
+}
+
+static int
+bench_iterations (int dflt)
+{
+/* returns the number of iterations (RL2_BENCH_ITERATIONS env variable) */
+    const char *env = getenv ("RL2_BENCH_ITERATIONS");
+    int n;
+    if (env == NULL)
+	return dflt;
+    n = atoi (env);
+    if (n < 1)
+	return dflt;
+    return n;
+}
+
+static void
+bench_samples_init (struct bench_samples *s)
+{
+/* initializing an empty list of timing samples */
+    s->values = NULL;
+    s->count = 0;
+    s->max = 0;
+}
+
+static void
+bench_samples_reset (struct bench_samples *s)
+{
+/* resetting a list of timing samples */
+    if (s->values != NULL)
+	free (s->values);
+    bench_samples_init (s);
+}
+
+static void
+bench_samples_add (struct bench_samples *s, double seconds)
+{
+/* appending a timing sample */
+    if (s->count == s->max)
+      {
+	  int max = (s->max == 0) ? 64 : s->max * 2;
+	  double *values = realloc (s->values, sizeof (double) * max);
+	  if (values == NULL)
+	      return;
+	  s->values = values;
+	  s->max = max;
+      }
+    s->values[s->count++] = seconds;
+}
+
+static int
+cmp_bench_samples (const void *p1, const void *p2)
+{
+/* compares two timing samples [sort] */
+    double v1 = *((const double *) p1);
+    double v2 = *((const double *) p2);
+    if (v1 < v2)
+	return -1;
+    if (v1 > v2)
+	return 1;
+    return 0;
+}
+
+static double
+bench_samples_total (struct bench_samples *s)
+{
+/* returns the sum of all timing samples */
+    int i;
+    double total = 0.0;
+    for (i = 0; i < s->count; i++)
+	total += s->values[i];
+    return total;
+}
+
+static double
+bench_percentile (struct bench_samples *s, double pct)
+{
+/* returns the Nth percentile (nearest rank) of all timing samples */
+    int idx;
+    if (s->count == 0)
+	return 0.0;
+    qsort (s->values, s->count, sizeof (double), cmp_bench_samples);
+    idx = (int) ((pct / 100.0) * (double) s->count + 0.5) - 1;
+    if (idx < 0)
+	idx = 0;
+    if (idx >= s->count)
+	idx = s->count - 1;
+    return s->values[idx];
+}
+
+static long
+bench_peak_rss_kb (void)
+{
+/* returns the Peak Resident Set Size (in KB) */
+#ifdef _WIN32
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage (RUSAGE_SELF, &usage) != 0)
+	return -1;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+static void
+bench_json_begin (const char *suite)
+{
+/* starting the JSON output */
+    printf ("{\"suite\": \"%s\", \"results\": [", suite);
+    bench_json_items = 0;
+}
+
+static void
+bench_json_result (const char *name, const char *operation,
+		   struct bench_samples *s, double bytes_per_iter,
+		   double tiles_per_iter)
+{
+/* printing a single JSON result object */
+    double total = bench_samples_total (s);
+    double mb_s = 0.0;
+    double tiles_s = 0.0;
+    if (total > 0.0)
+      {
+	  mb_s = (bytes_per_iter * (double) (s->count)) / total / 1048576.0;
+	  tiles_s = (tiles_per_iter * (double) (s->count)) / total;
+      }
+    if (bench_json_items > 0)
+	printf (",");
+    printf ("\n  {\"name\": \"%s\", \"operation\": \"%s\", ", name,
+	    operation);
+    printf ("\"iterations\": %d, \"total_sec\": %1.6f, ", s->count, total);
+    printf ("\"mb_per_sec\": %1.3f, \"tiles_per_sec\": %1.3f, ", mb_s,
+	    tiles_s);
+    printf ("\"p50_ms\": %1.4f, ", bench_percentile (s, 50.0) * 1000.0);
+    printf ("\"p99_ms\": %1.4f, ", bench_percentile (s, 99.0) * 1000.0);
+    printf ("\"peak_rss_kb\": %ld}", bench_peak_rss_kb ());
+    bench_json_items++;
+}
+
+static void
+bench_json_end (void)
+{
+/* completing the JSON output */
+    printf ("\n], \"peak_rss_kb\": %ld}\n", bench_peak_rss_kb ());
+    fflush (stdout);
+}
@@ -0,0 +1,342 @@
+/*
+
+ bench_import.c -- RasterLite-2 Benchmark: raster import and pyramids
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2019
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+#include "bench_common.h"
+
+struct bench_dataset
+{
+    const char *coverage;
+    const char *sample;
+    const char *pixel;
+    int num_bands;
+    const char *compression;
+    int quality;
+    int srid;
+    double resolution;
+    const char *path1;
+    const char *path2;
+};
+
+static struct bench_dataset datasets[] = {
+    {"bench_rgb", "UINT8", "RGB", 3, "JPEG", 80, 26914, 0.152400030480006134,
+     "map_samples/usgs-rgb/rgb1.tif", "map_samples/usgs-rgb/rgb2.tif"},
+    {"bench_gray", "UINT8", "GRAYSCALE", 1, "PNG", 100, 26914, 1.0,
+     "map_samples/usgs-gray/gray1.tif", "map_samples/usgs-gray/gray2.tif"},
+    {"bench_srtm", "INT16", "DATAGRID", 1, "DEFLATE", 100, 4326,
+     0.0008333333333333, "map_samples/usgs-srtm/srtm1.tif",
+     "map_samples/usgs-srtm/srtm2.tif"},
+#ifndef OMIT_ZSTD		/* only if ZSTD is enabled */
+    {"bench_u16", "UINT16", "DATAGRID", 1, "ZSTD", 100, 4326,
+     0.0008333333333333, "map_samples/usgs-nile-u16/nile1-uint16.tif",
+     "map_samples/usgs-nile-u16/nile2-uint16.tif"},
+#endif /* end ZSTD conditional */
+#ifndef OMIT_LZ4		/* only if LZ4 is enabled */
+    {"bench_dbl", "DOUBLE", "DATAGRID", 1, "LZ4", 100, 4326,
+     0.0008333333333333, "map_samples/usgs-nile-dbl/nile1-dbl.tif",
+     "map_samples/usgs-nile-dbl/nile2-dbl.tif"},
+#endif /* end LZ4 conditional */
+    {"bench_ascii", "FLOAT", "DATAGRID", 1, "DEFLATE", 100, 3003, 1.0,
+     "map_samples/ascii/ascii1.asc", "map_samples/ascii/ascii2.asc"},
+    {NULL, NULL, NULL, 0, NULL, 0, 0, 0.0, NULL, NULL}
+};
+
+static int
+execute_check (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning True/False */
+    sqlite3_stmt *stmt;
+    int ret;
+    int retcode = 0;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return SQLITE_ERROR;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+      {
+	  if (sqlite3_column_int (stmt, 0) == 1)
+	      retcode = 1;
+      }
+    sqlite3_finalize (stmt);
+    if (retcode == 1)
+	return SQLITE_OK;
+    return SQLITE_ERROR;
+}
+
+static int
+count_tiles (sqlite3 * sqlite, const char *coverage, int base_only)
+{
+/* counting the Tiles of some Coverage */
+    char *sql;
+    char *table;
+    sqlite3_stmt *stmt;
+    int ret;
+    int count = 0;
+
+    table = sqlite3_mprintf ("%s_tiles", coverage);
+    if (base_only)
+	sql =
+	    sqlite3_mprintf
+	    ("SELECT Count(*) FROM \"%w\" WHERE pyramid_level = 0", table);
+    else
+	sql = sqlite3_mprintf ("SELECT Count(*) FROM \"%w\"", table);
+    sqlite3_free (table);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	      count = sqlite3_column_int (stmt, 0);
+      }
+    sqlite3_finalize (stmt);
+    return count;
+}
+
+static double
+file_size (const char *path)
+{
+/* returns the size (in bytes) of some file */
+    struct stat st;
+    if (stat (path, &st) != 0)
+	return 0.0;
+    return (double) (st.st_size);
+}
+
+static int
+bench_import (sqlite3 * sqlite, const struct bench_dataset *ds,
+	      int iterations)
+{
+/* benchmarking the import of some raster file */
+    int i;
+    char *sql;
+    char name[128];
+    struct bench_samples s;
+    double bytes = (file_size (ds->path1) + file_size (ds->path2)) / 2.0;
+    int tiles = 0;
+    bench_samples_init (&s);
+
+    for (i = 0; i < iterations; i++)
+      {
+	  double t0;
+	  double t1;
+	  int ret;
+	  const char *path = (i % 2 == 0) ? ds->path1 : ds->path2;
+
+	  sql = sqlite3_mprintf ("SELECT RL2_DropRasterCoverage(%Q, 1)",
+				 ds->coverage);
+	  execute_check (sqlite, sql);
+	  sqlite3_free (sql);
+	  sql = sqlite3_mprintf ("SELECT RL2_CreateRasterCoverage("
+				 "%Q, %Q, %Q, %d, %Q, %d, %d, %d, %d, %1.16f, %1.16f)",
+				 ds->coverage, ds->sample, ds->pixel,
+				 ds->num_bands, ds->compression, ds->quality,
+				 256, 256, ds->srid, ds->resolution,
+				 ds->resolution);
+	  ret = execute_check (sqlite, sql);
+	  sqlite3_free (sql);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "CreateRasterCoverage \"%s\" error\n",
+			 ds->coverage);
+		bench_samples_reset (&s);
+		return 0;
+	    }
+
+	  sql = sqlite3_mprintf ("SELECT RL2_LoadRaster(%Q, %Q, 0, %d, 0, 1)",
+				 ds->coverage, path, ds->srid);
+	  t0 = bench_now ();
+	  ret = execute_check (sqlite, sql);
+	  t1 = bench_now ();
+	  sqlite3_free (sql);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "LoadRaster \"%s\" error\n", path);
+		bench_samples_reset (&s);
+		return 0;
+	    }
+	  bench_samples_add (&s, t1 - t0);
+	  tiles = count_tiles (sqlite, ds->coverage, 1);
+      }
+
+    sprintf (name, "%s/%s", ds->coverage, ds->compression);
+    bench_json_result (name, "import", &s, bytes, (double) tiles);
+    bench_samples_reset (&s);
+    return 1;
+}
+
+static int
+bench_pyramid (sqlite3 * sqlite, const void *priv_data,
+	       const struct bench_dataset *ds, int iterations)
+{
+/* benchmarking rl2_build_section_pyramid() */
+    int i;
+    char *sql;
+    char name[128];
+    struct bench_samples s;
+    int base_tiles;
+    int tiles;
+
+/* loading both files as two distinct Sections */
+    sql = sqlite3_mprintf ("SELECT RL2_DropRasterCoverage(%Q, 1)",
+			   ds->coverage);
+    execute_check (sqlite, sql);
+    sqlite3_free (sql);
+    sql = sqlite3_mprintf ("SELECT RL2_CreateRasterCoverage("
+			   "%Q, %Q, %Q, %d, %Q, %d, %d, %d, %d, %1.16f, %1.16f)",
+			   ds->coverage, ds->sample, ds->pixel, ds->num_bands,
+			   ds->compression, ds->quality, 256, 256, ds->srid,
+			   ds->resolution, ds->resolution);
+    execute_check (sqlite, sql);
+    sqlite3_free (sql);
+    sql = sqlite3_mprintf ("SELECT RL2_LoadRaster(%Q, %Q, 0, %d, 0, 1)",
+			   ds->coverage, ds->path1, ds->srid);
+    execute_check (sqlite, sql);
+    sqlite3_free (sql);
+    base_tiles = count_tiles (sqlite, ds->coverage, 1);
+
+    bench_samples_init (&s);
+    tiles = 0;
+    for (i = 0; i < iterations; i++)
+      {
+	  double t0;
+	  double t1;
+	  int ret;
+	  t0 = bench_now ();
+	  ret =
+	      rl2_build_section_pyramid (sqlite, priv_data, ds->coverage, 1, 1,
+					 0);
+	  t1 = bench_now ();
+	  if (ret != RL2_OK)
+	    {
+		fprintf (stderr, "rl2_build_section_pyramid \"%s\" error\n",
+			 ds->coverage);
+		break;
+	    }
+	  bench_samples_add (&s, t1 - t0);
+	  tiles = count_tiles (sqlite, ds->coverage, 0) - base_tiles;
+      }
+    sprintf (name, "%s/%s", ds->coverage, ds->compression);
+    bench_json_result (name, "section_pyramid", &s, 0.0, (double) tiles);
+    bench_samples_reset (&s);
+    return 1;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    int d;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+    int iterations = bench_iterations (BENCH_DEFAULT_ITERATIONS) / 4;
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+    if (iterations < 2)
+	iterations = 2;
+
+#ifdef _WIN32
+    putenv ("SPATIALITE_SECURITY=relaxed");
+#else /* not WIN32 */
+    setenv ("SPATIALITE_SECURITY", "relaxed", 1);
+#endif
+
+/* opening and initializing the "memory" benchmark DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+
+    bench_json_begin ("import");
+    for (d = 0; datasets[d].coverage != NULL; d++)
+      {
+	  if (!bench_import (db_handle, &(datasets[d]), iterations))
+	      return -3;
+	  if (!bench_pyramid (db_handle, priv_data, &(datasets[d]), iterations))
+	      return -4;
+      }
+    bench_json_end ();
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+    return 0;
+}
@@ -0,0 +1,408 @@
+/*
+
+ bench_render.c -- RasterLite-2 Benchmark: raw reads and map rendering
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2019
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+#include "bench_common.h"
+
+#define BENCH_RASTER	"bench_rgb"
+
+struct bench_extent
+{
+    double minx;
+    double miny;
+    double maxx;
+    double maxy;
+};
+
+static int
+execute_check (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning True/False */
+    sqlite3_stmt *stmt;
+    int ret;
+    int retcode = 0;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return SQLITE_ERROR;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+      {
+	  if (sqlite3_column_int (stmt, 0) == 1)
+	      retcode = 1;
+      }
+    sqlite3_finalize (stmt);
+    if (retcode == 1)
+	return SQLITE_OK;
+    return SQLITE_ERROR;
+}
+
+static int
+get_raster_extent (sqlite3 * sqlite, const char *coverage,
+		   struct bench_extent *ext)
+{
+/* retrieving the full extent of some Raster Coverage */
+    const char *sql;
+    sqlite3_stmt *stmt;
+    int ret;
+    int ok = 0;
+
+    sql = "SELECT extent_minx, extent_miny, extent_maxx, extent_maxy "
+	"FROM raster_coverages WHERE Lower(coverage_name) = Lower(?)";
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return 0;
+    sqlite3_bind_text (stmt, 1, coverage, strlen (coverage), SQLITE_STATIC);
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		ext->minx = sqlite3_column_double (stmt, 0);
+		ext->miny = sqlite3_column_double (stmt, 1);
+		ext->maxx = sqlite3_column_double (stmt, 2);
+		ext->maxy = sqlite3_column_double (stmt, 3);
+		ok = 1;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    return ok;
+}
+
+static int
+prepare_raster (sqlite3 * sqlite)
+{
+/* creating and populating the RGB Coverage (not timed) */
+    char *sql;
+    int ret;
+
+    sql = sqlite3_mprintf ("SELECT RL2_CreateRasterCoverage("
+			   "%Q, 'UINT8', 'RGB', 3, 'JPEG', 80, 256, 256, 26914, "
+			   "0.152400030480006134, 0.152400030480006134)",
+			   BENCH_RASTER);
+    ret = execute_check (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    sql = sqlite3_mprintf ("SELECT RL2_LoadRaster(%Q, %Q, 0, 26914, 1, 1)",
+			   BENCH_RASTER, "map_samples/usgs-rgb/rgb1.tif");
+    ret = execute_check (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    return 1;
+}
+
+static int
+bench_raw_read (sqlite3 * sqlite, int max_threads,
+		const struct bench_extent *ext, unsigned int size,
+		int iterations)
+{
+/* benchmarking rl2_get_raw_raster_data() */
+    int i;
+    char name[128];
+    struct bench_samples s;
+    rl2CoveragePtr cvg;
+    double res = 0.152400030480006134;
+    double cx = (ext->minx + ext->maxx) / 2.0;
+    double cy = (ext->miny + ext->maxy) / 2.0;
+    double half = ((double) size * res) / 2.0;
+    int tiles = ((size + 255) / 256) * ((size + 255) / 256);
+
+    cvg = rl2_create_coverage_from_dbms (sqlite, NULL, BENCH_RASTER);
+    if (cvg == NULL)
+	return 0;
+    bench_samples_init (&s);
+    for (i = 0; i < iterations; i++)
+      {
+	  double t0;
+	  double t1;
+	  int ret;
+	  unsigned char *buffer = NULL;
+	  int buf_size = 0;
+	  rl2PalettePtr palette = NULL;
+	  t0 = bench_now ();
+	  ret =
+	      rl2_get_raw_raster_data (sqlite, max_threads, cvg, size, size,
+				       cx - half, cy - half, cx + half,
+				       cy + half, res, res, &buffer, &buf_size,
+				       &palette, RL2_PIXEL_RGB);
+	  t1 = bench_now ();
+	  if (palette != NULL)
+	      rl2_destroy_palette (palette);
+	  if (buffer != NULL)
+	      free (buffer);
+	  if (ret != RL2_OK)
+	    {
+		fprintf (stderr, "rl2_get_raw_raster_data %ux%u error\n", size,
+			 size);
+		bench_samples_reset (&s);
+		rl2_destroy_coverage (cvg);
+		return 0;
+	    }
+	  bench_samples_add (&s, t1 - t0);
+      }
+    rl2_destroy_coverage (cvg);
+    sprintf (name, "%s/%ux%u/threads=%d", BENCH_RASTER, size, size,
+	     max_threads);
+    bench_json_result (name, "raw_read", &s, (double) size * size * 3.0,
+		       (double) tiles);
+    bench_samples_reset (&s);
+    return 1;
+}
+
+static int
+bench_getmap (sqlite3 * sqlite, const char *func, const char *coverage,
+	      const char *style, int srid, const struct bench_extent *ext,
+	      int size, int iterations)
+{
+/* benchmarking RL2_GetMapImageFromRaster() / RL2_GetMapImageFromVector() */
+    int i;
+    char *sql;
+    char name[256];
+    sqlite3_stmt *stmt;
+    int ret;
+    struct bench_samples s;
+    double bytes = 0.0;
+
+    sql = sqlite3_mprintf ("SELECT %s(NULL, ?, BuildMbr(?, ?, ?, ?, ?), "
+			   "?, ?, ?, 'image/png', '#ffffff', 1, 80)", func);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    bench_samples_init (&s);
+    for (i = 0; i < iterations; i++)
+      {
+	  double t0;
+	  double t1;
+	  int ok = 0;
+	  sqlite3_reset (stmt);
+	  sqlite3_clear_bindings (stmt);
+	  sqlite3_bind_text (stmt, 1, coverage, strlen (coverage),
+			     SQLITE_STATIC);
+	  sqlite3_bind_double (stmt, 2, ext->minx);
+	  sqlite3_bind_double (stmt, 3, ext->miny);
+	  sqlite3_bind_double (stmt, 4, ext->maxx);
+	  sqlite3_bind_double (stmt, 5, ext->maxy);
+	  sqlite3_bind_int (stmt, 6, srid);
+	  sqlite3_bind_int (stmt, 7, size);
+	  sqlite3_bind_int (stmt, 8, size);
+	  sqlite3_bind_text (stmt, 9, style, strlen (style), SQLITE_STATIC);
+	  t0 = bench_now ();
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_ROW)
+	    {
+		if (sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+		  {
+		      bytes = sqlite3_column_bytes (stmt, 0);
+		      ok = 1;
+		  }
+	    }
+	  t1 = bench_now ();
+	  if (!ok)
+	    {
+		fprintf (stderr, "%s \"%s\" %dx%d error\n", func, coverage,
+			 size, size);
+		sqlite3_finalize (stmt);
+		bench_samples_reset (&s);
+		return 0;
+	    }
+	  bench_samples_add (&s, t1 - t0);
+      }
+    sqlite3_finalize (stmt);
+    sprintf (name, "%s/%s/%dx%d", coverage, style, size, size);
+    bench_json_result (name, func, &s, bytes, 0.0);
+    bench_samples_reset (&s);
+    return 1;
+}
+
+static int
+bench_vectors (int iterations)
+{
+/* benchmarking the Vector renderer against NE.sqlite */
+    int ret;
+    int retcode = 1;
+    int i;
+    int size;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+    struct bench_extent ext = { 2.0, 49.0, 8.0, 55.0 };
+    const char *coverages[] = { "countries", "railroads", "popplaces", NULL };
+
+    ret = sqlite3_open_v2 ("NE.sqlite", &db_handle, SQLITE_OPEN_READONLY,
+			   NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  sqlite3_close (db_handle);
+	  spatialite_cleanup_ex (cache);
+	  rl2_cleanup_private (priv_data);
+	  return 0;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+
+    for (i = 0; coverages[i] != NULL && retcode; i++)
+      {
+	  for (size = 256; size <= 1024; size *= 2)
+	    {
+		if (!bench_getmap
+		    (db_handle, "RL2_GetMapImageFromVector", coverages[i],
+		     "default", 4326, &ext, size, iterations))
+		  {
+		      retcode = 0;
+		      break;
+		  }
+	    }
+      }
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    return retcode;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    int size;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    struct bench_extent ext;
+    struct bench_extent view;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+    int iterations = bench_iterations (BENCH_DEFAULT_ITERATIONS);
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+#ifdef _WIN32
+    putenv ("SPATIALITE_SECURITY=relaxed");
+#else /* not WIN32 */
+    setenv ("SPATIALITE_SECURITY", "relaxed", 1);
+#endif
+
+/* opening and initializing the "memory" benchmark DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+    if (!prepare_raster (db_handle))
+      {
+	  fprintf (stderr, "unable to prepare the \"%s\" Coverage\n",
+		   BENCH_RASTER);
+	  return -3;
+      }
+    if (!get_raster_extent (db_handle, BENCH_RASTER, &ext))
+	return -4;
+
+    bench_json_begin ("render");
+
+/* raw window reads: single thread vs multi-threaded */
+    for (size = 256; size <= 1024; size *= 2)
+      {
+	  if (!bench_raw_read (db_handle, 1, &ext, size, iterations))
+	      return -5;
+	  if (!bench_raw_read (db_handle, 4, &ext, size, iterations))
+	      return -6;
+      }
+
+/* raster GetMap: a centered window at increasing output sizes */
+    view.minx = (ext.minx + ext.maxx) / 2.0 - 200.0;
+    view.miny = (ext.miny + ext.maxy) / 2.0 - 200.0;
+    view.maxx = view.minx + 400.0;
+    view.maxy = view.miny + 400.0;
+    for (size = 256; size <= 1024; size *= 2)
+      {
+	  if (!bench_getmap
+	      (db_handle, "RL2_GetMapImageFromRaster", BENCH_RASTER, "default",
+	       26914, &view, size, iterations))
+	      return -7;
+      }
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+
+/* vector GetMap */
+    if (!bench_vectors (iterations))
+	return -8;
+
+    bench_json_end ();
+    spatialite_shutdown ();
+    return 0;
+}
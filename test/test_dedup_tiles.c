@@ -0,0 +1,424 @@
+/*
+
+ test_dedup_tiles.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+#define DEDUP_WIDTH	768
+#define DEDUP_HEIGHT	512
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+check_text (sqlite3 * sqlite, const char *sql, const char *expected)
+{
+/* executing an SQL statement returning a Text (or NULL) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int ok = 0;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return 0;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW)
+      {
+	  if (expected == NULL)
+	    {
+		if (sqlite3_column_type (stmt, 0) == SQLITE_NULL)
+		    ok = 1;
+	    }
+	  else if (sqlite3_column_type (stmt, 0) == SQLITE_TEXT)
+	    {
+		const char *value =
+		    (const char *) sqlite3_column_text (stmt, 0);
+		if (strcmp (value, expected) == 0)
+		    ok = 1;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    if (!ok)
+	fprintf (stderr, "Unexpected result: %s\n", sql);
+    return ok;
+}
+
+static unsigned char *
+build_pixels (void)
+{
+/* 
+/ building a 3x2 tiles Grayscale image: all tiles are identical
+/ except the last one
+*/
+    int row;
+    int col;
+    unsigned char *pixels = malloc (DEDUP_WIDTH * DEDUP_HEIGHT);
+    unsigned char *p = pixels;
+    for (row = 0; row < DEDUP_HEIGHT; row++)
+      {
+	  for (col = 0; col < DEDUP_WIDTH; col++)
+	    {
+		int x = col % 256;
+		int y = row % 256;
+		if (row >= 256 && col >= 512)
+		    *p++ = (x * y) % 251;
+		else
+		    *p++ = (x + y) % 251;
+	    }
+      }
+    return pixels;
+}
+
+static int
+create_coverage (sqlite3 * sqlite, const char *coverage, int dedup)
+{
+/* creating a Grayscale Coverage (optionally deduplicating tiles) */
+    char *sql;
+    int ret;
+
+    sql = sqlite3_mprintf ("SELECT RL2_CreateRasterCoverage("
+			   "%Q, 'UINT8', 'GRAYSCALE', 1, 'PNG', 100, 256, 256, "
+			   "4326, 0.01, 0.01, NULL, 0, 0, 0, 0, 0, 0, 0, "
+			   "-1.0, -1.0, %d)", coverage, dedup);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+      {
+	  fprintf (stderr, "CreateRasterCoverage \"%s\" error\n", coverage);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+import_pixels (sqlite3 * sqlite, const char *coverage,
+	       const unsigned char *pixels)
+{
+/* importing the test image as a Section (no Pyramid) */
+    char *sql;
+    sqlite3_stmt *stmt;
+    int ret;
+    int ok = 0;
+
+    sql = sqlite3_mprintf ("SELECT RL2_ImportSectionRawPixels("
+			   "%Q, 'dedup', %d, %d, ?, "
+			   "BuildMbr(0, 0, %1.2f, %1.2f, 4326), 0, 1)",
+			   coverage, DEDUP_WIDTH, DEDUP_HEIGHT,
+			   DEDUP_WIDTH / 100.0, DEDUP_HEIGHT / 100.0);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    sqlite3_bind_blob (stmt, 1, pixels, DEDUP_WIDTH * DEDUP_HEIGHT,
+		       SQLITE_STATIC);
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW)
+	ok = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    if (ok != 1)
+	fprintf (stderr, "ImportSectionRawPixels \"%s\" error\n", coverage);
+    return ok;
+}
+
+static int
+check_pixels (sqlite3 * sqlite, const char *coverage,
+	      const unsigned char *pixels)
+{
+/* exporting the whole Coverage and comparing the original pixels */
+    char *sql;
+    sqlite3_stmt *stmt;
+    int ret;
+    int ok = 0;
+
+    sql = sqlite3_mprintf ("SELECT RL2_ExportRawPixels(NULL, %Q, %d, %d, "
+			   "BuildMbr(0, 0, %1.2f, %1.2f, 4326), 0.01)",
+			   coverage, DEDUP_WIDTH, DEDUP_HEIGHT,
+			   DEDUP_WIDTH / 100.0, DEDUP_HEIGHT / 100.0);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+      {
+	  if (sqlite3_column_bytes (stmt, 0) == DEDUP_WIDTH * DEDUP_HEIGHT
+	      && memcmp (sqlite3_column_blob (stmt, 0), pixels,
+			 DEDUP_WIDTH * DEDUP_HEIGHT) == 0)
+	      ok = 1;
+      }
+    sqlite3_finalize (stmt);
+    if (!ok)
+	fprintf (stderr, "\"%s\": mismatching pixels\n", coverage);
+    return ok;
+}
+
+static int
+test_tile_hash (sqlite3 * sqlite)
+{
+/* testing the TileHash SQL function */
+    if (!check_text
+	(sqlite, "SELECT RL2_TileHash(X'00010203', NULL)",
+	 "37b59afd592725f9305e484a5d7f5168:4:0"))
+	return 0;
+    if (!check_text
+	(sqlite, "SELECT RL2_TileHash(X'00010203', X'0405')",
+	 "d15ae53931880fd7b724dd7888b4b4ed:4:2"))
+	return 0;
+    if (!check_text (sqlite, "SELECT RL2_TileHash(NULL, NULL)", NULL))
+	return 0;
+    if (!check_text (sqlite, "SELECT RL2_TileHash(X'00010203', 'even')", NULL))
+	return 0;
+    return 1;
+}
+
+static int
+test_dedup (sqlite3 * sqlite, const unsigned char *pixels)
+{
+/* checking the deduplicated Coverage */
+    if (execute_int (sqlite, "SELECT Count(*) FROM dedup_gray_tile_data") != 6)
+      {
+	  fprintf (stderr, "Dedup: unexpected number of tiles\n");
+	  return 0;
+      }
+    if (execute_int (sqlite, "SELECT Count(*) FROM dedup_gray_tile_blobs") !=
+	2)
+      {
+	  fprintf (stderr, "Dedup: identical tiles stored more than once\n");
+	  return 0;
+      }
+    if (execute_int
+	(sqlite, "SELECT Max(ref_count) FROM dedup_gray_tile_blobs") != 5)
+      {
+	  fprintf (stderr, "Dedup: unexpected reference count\n");
+	  return 0;
+      }
+    if (execute_int
+	(sqlite,
+	 "SELECT Count(*) FROM dedup_gray_tile_blobs AS b "
+	 "JOIN plain_gray_tile_data AS p ON (p.tile_data_odd = b.tile_data_odd)")
+	!= 6)
+      {
+	  fprintf (stderr, "Dedup: payloads differing from the plain ones\n");
+	  return 0;
+      }
+    if (!check_pixels (sqlite, "plain_gray", pixels))
+	return 0;
+    if (!check_pixels (sqlite, "dedup_gray", pixels))
+	return 0;
+
+/* deleting the Section must release all payloads */
+    if (execute_int
+	(sqlite,
+	 "SELECT RL2_DeleteSection('dedup_gray', (SELECT section_id "
+	 "FROM dedup_gray_sections WHERE section_name = 'dedup'))") != 1)
+      {
+	  fprintf (stderr, "Dedup: DeleteSection error\n");
+	  return 0;
+      }
+    if (execute_int (sqlite, "SELECT Count(*) FROM dedup_gray_tile_refs") != 0)
+      {
+	  fprintf (stderr, "Dedup: orphan tile references\n");
+	  return 0;
+      }
+    if (execute_int (sqlite, "SELECT Count(*) FROM dedup_gray_tile_blobs") !=
+	0)
+      {
+	  fprintf (stderr, "Dedup: orphan tile payloads\n");
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+test_hash_collision (sqlite3 * sqlite, const unsigned char *pixels)
+{
+/* 
+/ simulating hash collisions: some unrelated payload is already
+/ stored under the same hash of each tile about to be imported
+*/
+    if (!create_coverage (sqlite, "collide_gray", 1))
+	return 0;
+    if (sqlite3_exec
+	(sqlite,
+	 "INSERT INTO collide_gray_tile_blobs (tile_hash, ref_count, "
+	 "tile_data_odd, tile_data_even) SELECT DISTINCT "
+	 "RL2_TileHash(tile_data_odd, tile_data_even), 1, X'DEADBEEF', NULL "
+	 "FROM plain_gray_tile_data", NULL, NULL, NULL) != SQLITE_OK)
+      {
+	  fprintf (stderr, "Collision: unable to store the fake payloads\n");
+	  return 0;
+      }
+    if (!import_pixels (sqlite, "collide_gray", pixels))
+	return 0;
+    if (execute_int (sqlite, "SELECT Count(*) FROM collide_gray_tile_blobs")
+	!= 4)
+      {
+	  fprintf (stderr, "Collision: colliding payloads not stored\n");
+	  return 0;
+      }
+    if (execute_int
+	(sqlite,
+	 "SELECT Count(*) FROM collide_gray_tile_data "
+	 "WHERE tile_data_odd = X'DEADBEEF'") != 0)
+      {
+	  fprintf (stderr, "Collision: tiles bound to a colliding payload\n");
+	  return 0;
+      }
+    if (!check_pixels (sqlite, "collide_gray", pixels))
+	return 0;
+    return 1;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+    char *old_SPATIALITE_SECURITY_ENV = NULL;
+    unsigned char *pixels;
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+    old_SPATIALITE_SECURITY_ENV = getenv ("SPATIALITE_SECURITY");
+#ifdef _WIN32
+    putenv ("SPATIALITE_SECURITY=relaxed");
+#else /* not WIN32 */
+    setenv ("SPATIALITE_SECURITY", "relaxed", 1);
+#endif
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+
+    if (!test_tile_hash (db_handle))
+	return -3;
+
+/* loading the same pixels into a deduplicated and an ordinary Coverage */
+    pixels = build_pixels ();
+    if (!create_coverage (db_handle, "dedup_gray", 1))
+	return -4;
+    if (!create_coverage (db_handle, "plain_gray", 0))
+	return -5;
+    if (!import_pixels (db_handle, "dedup_gray", pixels))
+	return -6;
+    if (!import_pixels (db_handle, "plain_gray", pixels))
+	return -7;
+
+    ret = test_hash_collision (db_handle, pixels);
+    if (ret)
+	ret = test_dedup (db_handle, pixels);
+    free (pixels);
+    if (!ret)
+	return -8;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+
+    if (old_SPATIALITE_SECURITY_ENV)
+      {
+#ifdef _WIN32
+	  char *env = sqlite3_mprintf ("SPATIALITE_SECURITY=%s",
+				       old_SPATIALITE_SECURITY_ENV);
+	  putenv (env);
+	  sqlite3_free (env);
+#else /* not WIN32 */
+	  setenv ("SPATIALITE_SECURITY", old_SPATIALITE_SECURITY_ENV, 1);
+#endif
+      }
+    else
+      {
+#ifdef _WIN32
+	  putenv ("SPATIALITE_SECURITY=");
+#else /* not WIN32 */
+	  unsetenv ("SPATIALITE_SECURITY");
+#endif
+      }
+    return 0;
+}
@@ -0,0 +1,278 @@
+/*
+
+ test_import_threads.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+import_dir (sqlite3 * sqlite, const char *coverage, const char *pixel,
+	    int num_bands, double res, const char *dir_path, int max_threads)
+{
+/* creating a Coverage and importing a whole directory into it */
+    char *sql;
+    int ret;
+
+    sql = sqlite3_mprintf ("SELECT RL2_SetMaxThreads(%d)", max_threads);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+      {
+	  fprintf (stderr, "SetMaxThreads(%d) error\n", max_threads);
+	  return 0;
+      }
+    sql = sqlite3_mprintf ("SELECT RL2_CreateRasterCoverage("
+			   "%Q, 'UINT8', %Q, %d, 'PNG', 100, 256, 256, 26914, "
+			   "%1.16f, %1.16f)", coverage, pixel, num_bands, res,
+			   res);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+      {
+	  fprintf (stderr, "CreateRasterCoverage \"%s\" error\n", coverage);
+	  return 0;
+      }
+    sql =
+	sqlite3_mprintf
+	("SELECT RL2_LoadRastersFromDir(%Q, %Q, '.tif', 0, 26914, 1, 1)",
+	 coverage, dir_path);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+      {
+	  fprintf (stderr, "LoadRastersFromDir \"%s\" (%d threads) error\n",
+		   coverage, max_threads);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+compare_sections (sqlite3 * sqlite, const char *seq, const char *par)
+{
+/* Section IDs, names, extents and statistics must exactly match */
+    char *sql;
+    int count;
+    int matching;
+
+    sql = sqlite3_mprintf ("SELECT Count(*) FROM \"%s_sections\"", seq);
+    count = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (count < 2)
+      {
+	  fprintf (stderr, "%s: unexpected Sections count %d\n", seq, count);
+	  return 0;
+      }
+    sql = sqlite3_mprintf ("SELECT Count(*) FROM \"%s_sections\"", par);
+    matching = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (matching != count)
+      {
+	  fprintf (stderr, "%s: mismatching Sections count %d (expected %d)\n",
+		   par, matching, count);
+	  return 0;
+      }
+    sql =
+	sqlite3_mprintf
+	("SELECT Count(*) FROM \"%s_sections\" AS s "
+	 "JOIN \"%s_sections\" AS p ON (s.section_id = p.section_id) "
+	 "WHERE s.section_name = p.section_name AND s.width = p.width "
+	 "AND s.height = p.height AND ST_Equals(s.geometry, p.geometry) = 1 "
+	 "AND s.statistics = p.statistics", seq, par);
+    matching = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (matching != count)
+      {
+	  fprintf (stderr, "%s: %d Sections out of %d are matching\n", par,
+		   matching, count);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+compare_tiles (sqlite3 * sqlite, const char *seq, const char *par)
+{
+/* every Tile (including the Pyramid ones) must have the same checksum */
+    char *sql;
+    int count;
+    int matching;
+
+    sql = sqlite3_mprintf ("SELECT Count(*) FROM \"%s_tiles\"", seq);
+    count = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (count <= 0)
+      {
+	  fprintf (stderr, "%s: no Tiles at all\n", seq);
+	  return 0;
+      }
+    sql = sqlite3_mprintf ("SELECT Count(*) FROM \"%s_tiles\"", par);
+    matching = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (matching != count)
+      {
+	  fprintf (stderr, "%s: mismatching Tiles count %d (expected %d)\n",
+		   par, matching, count);
+	  return 0;
+      }
+    sql =
+	sqlite3_mprintf
+	("SELECT Count(*) FROM \"%s_tiles\" AS st "
+	 "JOIN \"%s_tile_data\" AS sd ON (sd.tile_id = st.tile_id) "
+	 "JOIN \"%s_tiles\" AS pt ON (pt.section_id = st.section_id "
+	 "AND pt.pyramid_level = st.pyramid_level "
+	 "AND ST_Equals(pt.geometry, st.geometry) = 1) "
+	 "JOIN \"%s_tile_data\" AS pd ON (pd.tile_id = pt.tile_id) "
+	 "WHERE MD5Checksum(sd.tile_data_odd) = MD5Checksum(pd.tile_data_odd) "
+	 "AND IfNull(MD5Checksum(sd.tile_data_even), '') = "
+	 "IfNull(MD5Checksum(pd.tile_data_even), '')", seq, seq, par, par);
+    matching = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (matching != count)
+      {
+	  fprintf (stderr, "%s: %d Tiles out of %d are matching\n", par,
+		   matching, count);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+test_import_threads (sqlite3 * sqlite, const char *name, const char *pixel,
+		     int num_bands, double res, const char *dir_path)
+{
+/* importing the same file list by a single thread and by many threads */
+    char *seq = sqlite3_mprintf ("%s_seq", name);
+    char *par = sqlite3_mprintf ("%s_par", name);
+    int ok = 0;
+
+    if (!import_dir (sqlite, seq, pixel, num_bands, res, dir_path, 1))
+	goto end;
+    if (!import_dir (sqlite, par, pixel, num_bands, res, dir_path, 4))
+	goto end;
+    if (!compare_sections (sqlite, seq, par))
+	goto end;
+    if (!compare_tiles (sqlite, seq, par))
+	goto end;
+    ok = 1;
+
+  end:
+    sqlite3_free (seq);
+    sqlite3_free (par);
+    return ok;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+
+/* RGB and Grayscale file lists */
+    if (!test_import_threads
+	(db_handle, "rgb", "RGB", 3, 0.152400030480006134,
+	 "map_samples/usgs-rgb"))
+	return -3;
+    if (!test_import_threads
+	(db_handle, "gray", "GRAYSCALE", 1, 1.0, "map_samples/usgs-gray"))
+	return -4;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+    return 0;
+}
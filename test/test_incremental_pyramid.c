@@ -0,0 +1,374 @@
+/*
+
+ test_incremental_pyramid.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+#define SECTION_SIZE	512
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+execute_check (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement not returning any result */
+    char *err_msg = NULL;
+    int ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "%s\nerror: %s\n", sql, err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+import_section (sqlite3 * sqlite, const char *section, double minx,
+		double miny)
+{
+/* importing a checkered MONOCHROME Section (without Pyramid) */
+    char *sql;
+    sqlite3_stmt *stmt;
+    unsigned char *pixels;
+    unsigned char *p;
+    int row;
+    int col;
+    int ret;
+    int ok = 0;
+
+    pixels = malloc (SECTION_SIZE * SECTION_SIZE);
+    p = pixels;
+    for (row = 0; row < SECTION_SIZE; row++)
+      {
+	  for (col = 0; col < SECTION_SIZE; col++)
+	      *p++ = ((row / 8) + (col / 8)) % 2;
+      }
+    sql = sqlite3_mprintf ("SELECT RL2_ImportSectionRawPixels("
+			   "'mono_incr', %Q, %d, %d, ?, "
+			   "BuildMbr(%1.2f, %1.2f, %1.2f, %1.2f, 4326), 0, 1)",
+			   section, SECTION_SIZE, SECTION_SIZE, minx, miny,
+			   minx + (SECTION_SIZE / 100.0),
+			   miny + (SECTION_SIZE / 100.0));
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret == SQLITE_OK)
+      {
+	  sqlite3_bind_blob (stmt, 1, pixels, SECTION_SIZE * SECTION_SIZE,
+			     SQLITE_STATIC);
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_ROW)
+	      ok = sqlite3_column_int (stmt, 0);
+	  sqlite3_finalize (stmt);
+      }
+    free (pixels);
+    if (ok != 1)
+	fprintf (stderr, "ImportSectionRawPixels \"%s\" error\n", section);
+    return ok;
+}
+
+static int
+count_dirty (sqlite3 * sqlite)
+{
+/* counting the pending dirty footprints */
+    return execute_int (sqlite, "SELECT Count(*) FROM mono_incr_pyramid_dirty");
+}
+
+static int
+count_pyramid_tiles (sqlite3 * sqlite)
+{
+/* counting the Monolithic Pyramid tiles */
+    return execute_int (sqlite,
+			"SELECT Count(*) FROM mono_incr_tiles WHERE pyramid_level > 0");
+}
+
+static int
+count_pyramid_levels (sqlite3 * sqlite)
+{
+/* counting the Monolithic Pyramid levels */
+    return execute_int (sqlite, "SELECT Count(*) FROM mono_incr_levels");
+}
+
+static int
+test_incremental (sqlite3 * sqlite)
+{
+/* refreshing a MONOCHROME Monolithic Pyramid */
+    int n_tiles;
+    int n_levels;
+
+/* building the initial Monolithic Pyramid */
+    if (!import_section (sqlite, "west", 0.0, 0.0))
+	return -10;
+    if (execute_int
+	(sqlite, "SELECT RL2_PyramidizeMonolithic('mono_incr', 1, 1)") != 1)
+      {
+	  fprintf (stderr, "PyramidizeMonolithic error\n");
+	  return -11;
+      }
+    if (count_dirty (sqlite) != 0)
+	return -12;
+
+/* a SQL error while INSERTing the rebuilt tiles must be reported */
+    if (!import_section (sqlite, "east", SECTION_SIZE / 100.0, 0.0))
+	return -13;
+    if (count_dirty (sqlite) != 1)
+      {
+	  fprintf (stderr, "the new Section has not been tracked\n");
+	  return -14;
+      }
+    if (!execute_check
+	(sqlite,
+	 "CREATE TRIGGER block_levels BEFORE INSERT ON mono_incr_tiles "
+	 "FOR EACH ROW WHEN NEW.pyramid_level > 0 BEGIN "
+	 "SELECT RAISE(ABORT, 'blocked'); END"))
+	return -15;
+    if (execute_int
+	(sqlite, "SELECT RL2_Pyramidize('mono_incr', NULL, 0, 1, 1)") != 0)
+      {
+	  fprintf (stderr, "Pyramidize: INSERT error not propagated\n");
+	  return -16;
+      }
+    if (count_dirty (sqlite) != 1)
+      {
+	  fprintf (stderr, "Pyramidize: failed refresh not rolled back\n");
+	  return -17;
+      }
+    if (!execute_check (sqlite, "DROP TRIGGER block_levels"))
+	return -18;
+
+/* a SQL error while resetting the dirty footprints must be reported */
+    if (!execute_check
+	(sqlite,
+	 "CREATE TRIGGER block_dirty BEFORE DELETE ON mono_incr_pyramid_dirty "
+	 "FOR EACH ROW BEGIN SELECT RAISE(ABORT, 'blocked'); END"))
+	return -19;
+    if (execute_int
+	(sqlite, "SELECT RL2_Pyramidize('mono_incr', NULL, 0, 1, 1)") != 0)
+      {
+	  fprintf (stderr, "Pyramidize: DELETE error not propagated\n");
+	  return -20;
+      }
+    if (count_dirty (sqlite) != 1)
+	return -21;
+    if (!execute_check (sqlite, "DROP TRIGGER block_dirty"))
+	return -22;
+
+/* the connection is still usable and the refresh now succeeds */
+    if (execute_int
+	(sqlite, "SELECT RL2_Pyramidize('mono_incr', NULL, 0, 1, 1)") != 1)
+      {
+	  fprintf (stderr, "Pyramidize: incremental refresh error\n");
+	  return -23;
+      }
+    if (count_dirty (sqlite) != 0)
+	return -24;
+
+/* the refreshed Pyramid must match a full rebuild */
+    n_tiles = count_pyramid_tiles (sqlite);
+    if (n_tiles <= 0)
+	return -25;
+    if (execute_int
+	(sqlite, "SELECT RL2_PyramidizeMonolithic('mono_incr', 1, 1)") != 1)
+	return -26;
+    if (count_pyramid_tiles (sqlite) != n_tiles)
+      {
+	  fprintf (stderr, "incremental Pyramid: %d tiles, expected %d\n",
+		   n_tiles, count_pyramid_tiles (sqlite));
+	  return -27;
+      }
+
+/* an UPDATEd Section must record both its OLD and NEW footprint */
+    if (!execute_check
+	(sqlite,
+	 "UPDATE mono_incr_sections SET section_name = 'west2' "
+	 "WHERE section_name = 'west'"))
+	return -28;
+    if (count_dirty (sqlite) != 2)
+      {
+	  fprintf (stderr, "the updated Section has not been tracked\n");
+	  return -29;
+      }
+    if (execute_int
+	(sqlite, "SELECT RL2_Pyramidize('mono_incr', NULL, 0, 1, 1)") != 1)
+	return -30;
+    if (count_dirty (sqlite) != 0)
+	return -31;
+
+/* the Coverage now grows along the Y axis only */
+    if (!import_section (sqlite, "north1", 0.0, SECTION_SIZE / 100.0))
+	return -32;
+    if (!import_section (sqlite, "north2", 0.0, 2.0 * SECTION_SIZE / 100.0))
+	return -33;
+    if (execute_int
+	(sqlite, "SELECT RL2_Pyramidize('mono_incr', NULL, 0, 1, 1)") != 1)
+	return -34;
+    n_tiles = count_pyramid_tiles (sqlite);
+    n_levels = count_pyramid_levels (sqlite);
+    if (n_tiles <= 0 || n_levels <= 0)
+	return -35;
+    if (execute_int
+	(sqlite, "SELECT RL2_PyramidizeMonolithic('mono_incr', 1, 1)") != 1)
+	return -36;
+    if (count_pyramid_levels (sqlite) != n_levels)
+      {
+	  fprintf (stderr, "incremental Pyramid: %d levels, expected %d\n",
+		   n_levels, count_pyramid_levels (sqlite));
+	  return -37;
+      }
+    if (count_pyramid_tiles (sqlite) != n_tiles)
+      {
+	  fprintf (stderr, "incremental Pyramid: %d tiles, expected %d\n",
+		   n_tiles, count_pyramid_tiles (sqlite));
+	  return -38;
+      }
+    return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+    char *old_SPATIALITE_SECURITY_ENV = NULL;
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+    old_SPATIALITE_SECURITY_ENV = getenv ("SPATIALITE_SECURITY");
+#ifdef _WIN32
+    putenv ("SPATIALITE_SECURITY=relaxed");
+#else /* not WIN32 */
+    setenv ("SPATIALITE_SECURITY", "relaxed", 1);
+#endif
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+
+/* creating a MONOCHROME Coverage */
+    if (execute_int
+	(db_handle,
+	 "SELECT RL2_CreateRasterCoverage('mono_incr', '1-BIT', "
+	 "'MONOCHROME', 1, 'NONE', 100, 256, 256, 4326, 0.01, 0.01, "
+	 "RL2_SetPixelValue(RL2_CreatePixel('1-BIT', 'MONOCHROME', 1), 0, 0))")
+	!= 1)
+      {
+	  fprintf (stderr, "CreateRasterCoverage error\n");
+	  return -3;
+      }
+
+    ret = test_incremental (db_handle);
+    if (ret != 0)
+	return ret;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+
+    if (old_SPATIALITE_SECURITY_ENV)
+      {
+#ifdef _WIN32
+	  char *env = sqlite3_mprintf ("SPATIALITE_SECURITY=%s",
+				       old_SPATIALITE_SECURITY_ENV);
+	  putenv (env);
+	  sqlite3_free (env);
+#else /* not WIN32 */
+	  setenv ("SPATIALITE_SECURITY", old_SPATIALITE_SECURITY_ENV, 1);
+#endif
+      }
+    else
+      {
+#ifdef _WIN32
+	  putenv ("SPATIALITE_SECURITY=");
+#else /* not WIN32 */
+	  unsetenv ("SPATIALITE_SECURITY");
+#endif
+      }
+    return 0;
+}
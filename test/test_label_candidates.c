@@ -0,0 +1,407 @@
+/*
+
+ test_label_candidates.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+#define MAP_FRAME	"BuildMbr(1496000, 4799000, 1564000, 4850000, 3003)"
+
+/* a MapConfiguration with two Vector Layers, optionally labelled */
+static const char *map_config_head =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+    "<RL2MapConfig version=\"1.0\" xmlns=\"http://www.gaia-gis.it/RL2MapConfig\">"
+    "<Name>labels</Name><MapOptions>"
+    "<MultiThreading Enabled=\"false\" MaxThreads=\"1\" />"
+    "<MapCrs Crs=\"EPSG:3003\" AutoTransformEnabled=\"false\" />"
+    "<MapBackground Color=\"#ffffff\" Transparent=\"false\" />"
+    "<LabelAdvancedOptions AntiCollisionEnabled=\"false\" "
+    "WrapTextEnabled=\"false\" AutoRotateEnabled=\"false\" "
+    "ShiftPositionEnabled=\"false\" /></MapOptions>"
+    "<MapBoundingBox MinX=\"1496000\" MinY=\"4799000\" MaxX=\"1564000\" "
+    "MaxY=\"4850000\" />";
+
+static const char *zones_layer =
+    "<MapLayer Type=\"vector\" DbPrefix=\"main\" Name=\"zones\" "
+    "Visible=\"true\"><VectorLayerStyle><PolygonSymbolizer><Fill>"
+    "<SvgParameter name=\"fill\">#c0d0f0</SvgParameter></Fill><Stroke>"
+    "<SvgParameter name=\"stroke\">#000080</SvgParameter>"
+    "<SvgParameter name=\"stroke-width\">1.00</SvgParameter></Stroke>"
+    "</PolygonSymbolizer>%s</VectorLayerStyle></MapLayer>";
+
+static const char *zones_labels =
+    "<TextSymbolizer><Label>@name@</Label><Font>"
+    "<SvgParameter name=\"font-family\">sans serif</SvgParameter>"
+    "<SvgParameter name=\"font-size\">14.00</SvgParameter></Font>"
+    "<Fill><SvgParameter name=\"fill\">#0000c0</SvgParameter></Fill>"
+    "</TextSymbolizer>";
+
+static const char *places_layer =
+    "<MapLayer Type=\"vector\" DbPrefix=\"main\" Name=\"places\" "
+    "Visible=\"true\"><VectorLayerStyle><PointSymbolizer><Graphic><Mark>"
+    "<WellKnownName>circle</WellKnownName><Fill>"
+    "<SvgParameter name=\"fill\">#20c040</SvgParameter></Fill></Mark>"
+    "<Size>4.00</Size></Graphic></PointSymbolizer>%s"
+    "</VectorLayerStyle></MapLayer>";
+
+static const char *places_labels =
+    "<TextSymbolizer><Label>@code@</Label><Font>"
+    "<SvgParameter name=\"font-family\">serif</SvgParameter>"
+    "<SvgParameter name=\"font-size\">10.00</SvgParameter></Font>"
+    "<Fill><SvgParameter name=\"fill\">#c00000</SvgParameter></Fill>"
+    "</TextSymbolizer>";
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+execute_sql (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning nothing */
+    char *err_msg = NULL;
+    int ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+create_coverages (sqlite3 * sqlite)
+{
+/* creating and populating both Vector Coverages */
+    if (!execute_sql
+	(sqlite,
+	 "CREATE TABLE places (id INTEGER PRIMARY KEY, name TEXT, code TEXT)"))
+	return 0;
+    if (execute_int
+	(sqlite,
+	 "SELECT AddGeometryColumn('places', 'geom', 3003, 'POINT', 'XY')") !=
+	1)
+	return 0;
+    if (execute_int (sqlite, "SELECT CreateSpatialIndex('places', 'geom')")
+	!= 1)
+	return 0;
+
+/* 3000 Points (3000 Labels): many Arena blocks and index reallocations */
+    if (!execute_sql
+	(sqlite,
+	 "WITH RECURSIVE seq(i) AS (SELECT 0 UNION ALL SELECT i + 1 FROM seq "
+	 "WHERE i < 2999) INSERT INTO places (id, name, code, geom) "
+	 "SELECT i + 1, printf('Place #%d', i + 1), printf('P%04d', i), "
+	 "MakePoint(1500000 + (i % 60) * 1000 + 500, "
+	 "4800000 + (i / 60) * 1000 + 500, 3003) FROM seq"))
+	return 0;
+    if (execute_int
+	(sqlite, "SELECT SE_RegisterVectorCoverage('places', 'places', 'geom')")
+	!= 1)
+	return 0;
+
+    if (!execute_sql
+	(sqlite, "CREATE TABLE zones (id INTEGER PRIMARY KEY, name TEXT)"))
+	return 0;
+    if (execute_int
+	(sqlite,
+	 "SELECT AddGeometryColumn('zones', 'geom', 3003, 'POLYGON', 'XY')") !=
+	1)
+	return 0;
+    if (execute_int (sqlite, "SELECT CreateSpatialIndex('zones', 'geom')") !=
+	1)
+	return 0;
+
+/* 
+/ 20 Polygons with more than 5000 vertices each: every serialized
+/ Geometry is bigger than a whole Arena block
+*/
+    if (!execute_sql
+	(sqlite,
+	 "WITH RECURSIVE z(n) AS (SELECT 0 UNION ALL SELECT n + 1 FROM z "
+	 "WHERE n < 19), k(j) AS (SELECT 0 UNION ALL SELECT j + 1 FROM k "
+	 "WHERE j < 5000), v(n, x0, y0) AS (SELECT n, "
+	 "1500000 + (n % 5) * 12000, 4800000 + (n / 5) * 12000 FROM z) "
+	 "INSERT INTO zones (id, name, geom) SELECT n + 1, "
+	 "printf('Zone #%d', n + 1), PolygonFromText('POLYGON((' || "
+	 "(SELECT group_concat(printf('%d %d', x0 + j * 2, y0), ', ') "
+	 "FROM k) || printf(', %d %d, %d %d, %d %d))', x0 + 10000, "
+	 "y0 + 10000, x0, y0 + 10000, x0, y0), 3003) FROM v"))
+	return 0;
+    if (execute_int
+	(sqlite, "SELECT SE_RegisterVectorCoverage('zones', 'zones', 'geom')")
+	!= 1)
+	return 0;
+    return 1;
+}
+
+static int
+get_symbolize_count (sqlite3 * sqlite)
+{
+/* retrieving how many times Features (or Labels) have been symbolized */
+    sqlite3_stmt *stmt;
+    int ret;
+    int count = -1;
+    const char *sql = "SELECT RL2_GetPerfCounters()";
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return -1;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_TEXT)
+      {
+	  const char *json = (const char *) sqlite3_column_text (stmt, 0);
+	  const char *p = strstr (json, "\"symbolize\": {\"count\": ");
+	  if (p != NULL)
+	      count = atoi (p + strlen ("\"symbolize\": {\"count\": "));
+      }
+    sqlite3_finalize (stmt);
+    return count;
+}
+
+static unsigned char *
+render_map (sqlite3 * sqlite, int labels, int *blob_sz, int *symbolized)
+{
+/* painting the whole MapConfiguration */
+    char *zones;
+    char *places;
+    char *xml;
+    char *sql;
+    sqlite3_stmt *stmt;
+    unsigned char *blob = NULL;
+    int ret;
+
+    *blob_sz = 0;
+    *symbolized = -1;
+    zones = sqlite3_mprintf (zones_layer, labels ? zones_labels : "");
+    places = sqlite3_mprintf (places_layer, labels ? places_labels : "");
+    xml =
+	sqlite3_mprintf ("%s%s%s</RL2MapConfig>", map_config_head, zones,
+			 places);
+    sqlite3_free (zones);
+    sqlite3_free (places);
+    if (execute_int (sqlite, "SELECT RL2_ResetPerfCounters()") != 1)
+      {
+	  sqlite3_free (xml);
+	  return NULL;
+      }
+    sql =
+	sqlite3_mprintf ("SELECT RL2_GetImageFromMapConfiguration(%Q, "
+			 MAP_FRAME ", 800, 600, 'image/png')", xml);
+    sqlite3_free (xml);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "GetImageFromMapConfiguration SQL error: %s\n",
+		   sqlite3_errmsg (sqlite));
+	  return NULL;
+      }
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+      {
+	  *blob_sz = sqlite3_column_bytes (stmt, 0);
+	  blob = malloc (*blob_sz);
+	  memcpy (blob, sqlite3_column_blob (stmt, 0), *blob_sz);
+      }
+    sqlite3_finalize (stmt);
+    *symbolized = get_symbolize_count (sqlite);
+    return blob;
+}
+
+static int
+same_image (const unsigned char *blob1, int blob1_sz,
+	    const unsigned char *blob2, int blob2_sz)
+{
+/* checking if two images are identical */
+    if (blob1 == NULL || blob2 == NULL)
+	return 0;
+    if (blob1_sz != blob2_sz)
+	return 0;
+    if (memcmp (blob1, blob2, blob1_sz) != 0)
+	return 0;
+    return 1;
+}
+
+static int
+test_labels (sqlite3 * sqlite)
+{
+/* the Label pass must paint the Labels retained by the Feature pass */
+    unsigned char *features;
+    unsigned char *labels = NULL;
+    unsigned char *again = NULL;
+    int features_sz;
+    int labels_sz;
+    int again_sz;
+    int sym_features;
+    int sym_labels;
+    int sym_again;
+    int retcode = 0;
+
+/* just the Features: each one of them is symbolized once */
+    features = render_map (sqlite, 0, &features_sz, &sym_features);
+    if (features == NULL)
+	return -1;
+    if (sym_features < 3020)
+      {
+	  fprintf (stderr, "unexpected Feature pass: %d symbolized\n",
+		   sym_features);
+	  retcode = -2;
+	  goto end;
+      }
+
+/* 
+/ Features and Labels: the Label pass of each Layer paints all the
+/ retained candidates at once, without querying any Feature again
+*/
+    labels = render_map (sqlite, 1, &labels_sz, &sym_labels);
+    if (labels == NULL)
+      {
+	  retcode = -3;
+	  goto end;
+      }
+    if (same_image (features, features_sz, labels, labels_sz))
+      {
+	  fprintf (stderr, "no Label at all\n");
+	  retcode = -4;
+	  goto end;
+      }
+    if (sym_labels != sym_features + 2)
+      {
+	  fprintf (stderr, "unexpected Label pass: %d symbolized (%d + 2)\n",
+		   sym_labels, sym_features);
+	  retcode = -5;
+	  goto end;
+      }
+
+/* no Label candidate must survive its own request */
+    again = render_map (sqlite, 1, &again_sz, &sym_again);
+    if (!same_image (labels, labels_sz, again, again_sz))
+      {
+	  fprintf (stderr, "a second rendering paints different Labels\n");
+	  retcode = -6;
+	  goto end;
+      }
+    if (sym_again != sym_labels)
+      {
+	  retcode = -7;
+	  goto end;
+      }
+
+  end:
+    free (features);
+    if (labels != NULL)
+	free (labels);
+    if (again != NULL)
+	free (again);
+    return retcode;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+    if (!create_coverages (db_handle))
+	return -3;
+
+    ret = test_labels (db_handle);
+    if (ret != 0)
+	return -10 + ret;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+    return 0;
+}
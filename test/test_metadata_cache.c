@@ -0,0 +1,459 @@
+/*
+
+ test_metadata_cache.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+#define TEST_DB	"./metadata_cache.sqlite"
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+open_connection (const char *path, sqlite3 ** handle, void **cache,
+		 void **priv_data)
+{
+/* opening and initializing a connection on the test DB */
+    int ret;
+    *handle = NULL;
+    *cache = spatialite_alloc_connection ();
+    *priv_data = rl2_alloc_private ();
+    ret = sqlite3_open_v2 (path, handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (*handle));
+	  return 0;
+      }
+    spatialite_init_ex (*handle, *cache, 0);
+    rl2_init (*handle, *priv_data, 0);
+    return 1;
+}
+
+static void
+close_connection (sqlite3 * handle, void *cache, void *priv_data)
+{
+/* closing a connection */
+    sqlite3_close (handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+}
+
+static int
+create_coverage (sqlite3 * sqlite, const char *coverage, int grayscale,
+		 unsigned char red, unsigned char green, unsigned char blue)
+{
+/* (re)creating a flat Coverage: all pixels share the same color */
+    char *sql;
+    sqlite3_stmt *stmt;
+    unsigned char *pixels;
+    unsigned char *p;
+    int num_bands = grayscale ? 1 : 3;
+    int sz = 64 * 64 * num_bands;
+    int i;
+    int ret;
+    int ok = 0;
+
+    sql = sqlite3_mprintf ("SELECT RL2_DropRasterCoverage(%Q, 1)", coverage);
+    execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    sql =
+	sqlite3_mprintf
+	("SELECT RL2_CreateRasterCoverage(%Q, 'UINT8', %Q, %d, 'PNG', 100, "
+	 "256, 256, 3857, 1.0, 1.0, NULL, 1, 0, 0, 0, 0)", coverage,
+	 grayscale ? "GRAYSCALE" : "RGB", num_bands);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+      {
+	  fprintf (stderr, "CreateRasterCoverage \"%s\" error\n", coverage);
+	  return 0;
+      }
+
+    pixels = malloc (sz);
+    p = pixels;
+    for (i = 0; i < 64 * 64; i++)
+      {
+	  *p++ = red;
+	  if (grayscale)
+	      continue;
+	  *p++ = green;
+	  *p++ = blue;
+      }
+    sql =
+	sqlite3_mprintf
+	("SELECT RL2_ImportSectionRawPixels(%Q, 'flat', 64, 64, ?, "
+	 "BuildMbr(0, 0, 64, 64, 3857), 1, 1)", coverage);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret == SQLITE_OK)
+      {
+	  sqlite3_bind_blob (stmt, 1, pixels, sz, SQLITE_STATIC);
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_ROW)
+	      ok = sqlite3_column_int (stmt, 0);
+	  sqlite3_finalize (stmt);
+      }
+    free (pixels);
+    if (ok != 1)
+	fprintf (stderr, "ImportSectionRawPixels \"%s\" error\n", coverage);
+    return ok;
+}
+
+static int
+create_palette_coverage (sqlite3 * sqlite)
+{
+/* creating a Palette Coverage: all pixels are index #1 */
+    const char *sql;
+    sqlite3_stmt *stmt;
+    unsigned char pixels[64 * 64];
+    rl2PalettePtr palette;
+    int ret;
+    int ok = 0;
+
+    sql = "SELECT RL2_CreateRasterCoverage('plt', 'UINT8', 'PALETTE', 1, "
+	"'PNG', 100, 256, 256, 3857, 1.0, 1.0, NULL, 1, 0, 0, 0, 0)";
+    if (execute_int (sqlite, sql) != 1)
+      {
+	  fprintf (stderr, "CreateRasterCoverage \"plt\" error\n");
+	  return 0;
+      }
+    palette = rl2_create_palette (2);
+    rl2_set_palette_color (palette, 0, 255, 255, 255);
+    rl2_set_palette_color (palette, 1, 0, 0, 255);
+    ret = rl2_update_dbms_palette (sqlite, "plt", palette);
+    rl2_destroy_palette (palette);
+    if (ret != RL2_OK)
+      {
+	  fprintf (stderr, "unable to set the \"plt\" Palette\n");
+	  return 0;
+      }
+
+    memset (pixels, 1, sizeof (pixels));
+    sql = "SELECT RL2_ImportSectionRawPixels('plt', 'flat', 64, 64, ?, "
+	"BuildMbr(0, 0, 64, 64, 3857), 1, 1)";
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret == SQLITE_OK)
+      {
+	  sqlite3_bind_blob (stmt, 1, pixels, sizeof (pixels), SQLITE_STATIC);
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_ROW)
+	      ok = sqlite3_column_int (stmt, 0);
+	  sqlite3_finalize (stmt);
+      }
+    if (ok != 1)
+	fprintf (stderr, "ImportSectionRawPixels \"plt\" error\n");
+    return ok;
+}
+
+static int
+set_palette_color (sqlite3 * sqlite, unsigned char red, unsigned char green,
+		   unsigned char blue)
+{
+/* changing the color of the Palette index #1 */
+    int ret;
+    rl2PalettePtr palette = rl2_create_palette (2);
+    rl2_set_palette_color (palette, 0, 255, 255, 255);
+    rl2_set_palette_color (palette, 1, red, green, blue);
+    ret = rl2_update_dbms_palette (sqlite, "plt", palette);
+    rl2_destroy_palette (palette);
+    if (ret != RL2_OK)
+      {
+	  fprintf (stderr, "unable to change the \"plt\" Palette\n");
+	  return 0;
+      }
+    return 1;
+}
+
+static char *
+style_xml (int red_band, int green_band, int blue_band)
+{
+/* a RasterSymbolizer rearranging the RGB bands */
+    return
+	sqlite3_mprintf
+	("<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+	 "<RasterSymbolizer version=\"1.1.0\" "
+	 "xmlns=\"http://www.opengis.net/se\" "
+	 "xmlns:ogc=\"http://www.opengis.net/ogc\">"
+	 "<Name>swap</Name><Opacity>1.0</Opacity><ChannelSelection>"
+	 "<RedChannel><SourceChannelName>%d</SourceChannelName></RedChannel>"
+	 "<GreenChannel><SourceChannelName>%d</SourceChannelName></GreenChannel>"
+	 "<BlueChannel><SourceChannelName>%d</SourceChannelName></BlueChannel>"
+	 "</ChannelSelection></RasterSymbolizer>", red_band, green_band,
+	 blue_band);
+}
+
+static int
+register_style (sqlite3 * sqlite, int red_band, int green_band,
+		int blue_band)
+{
+/* registering the "swap" RasterStyle for the "rgb" Coverage */
+    const char *sql;
+    char *xsql;
+    char *xml;
+    sqlite3_stmt *stmt;
+    int ret;
+    int style_id;
+    int ok = 0;
+
+    xml = style_xml (red_band, green_band, blue_band);
+    sql = "SELECT SE_RegisterRasterStyle(XB_Create(?, 1))";
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret == SQLITE_OK)
+      {
+	  sqlite3_bind_blob (stmt, 1, xml, strlen (xml), SQLITE_STATIC);
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_ROW)
+	      ok = sqlite3_column_int (stmt, 0);
+	  sqlite3_finalize (stmt);
+      }
+    sqlite3_free (xml);
+    if (ok != 1)
+      {
+	  fprintf (stderr, "unable to register the \"swap\" Style\n");
+	  return 0;
+      }
+    style_id =
+	execute_int (sqlite,
+		     "SELECT style_id FROM SE_raster_styles WHERE style_name = 'swap'");
+    xsql =
+	sqlite3_mprintf ("SELECT SE_RegisterRasterStyledLayer('rgb', %d)",
+			 style_id);
+    ret = execute_int (sqlite, xsql);
+    sqlite3_free (xsql);
+    if (ret != 1)
+      {
+	  fprintf (stderr, "unable to register the \"swap\" Styled Layer\n");
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+reload_style (sqlite3 * sqlite, int red_band, int green_band, int blue_band)
+{
+/* changing the "swap" RasterStyle */
+    const char *sql;
+    char *xml;
+    sqlite3_stmt *stmt;
+    int ret;
+    int ok = 0;
+
+    xml = style_xml (red_band, green_band, blue_band);
+    sql = "SELECT SE_ReloadRasterStyle('swap', XB_Create(?, 1))";
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret == SQLITE_OK)
+      {
+	  sqlite3_bind_blob (stmt, 1, xml, strlen (xml), SQLITE_STATIC);
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_ROW)
+	      ok = sqlite3_column_int (stmt, 0);
+	  sqlite3_finalize (stmt);
+      }
+    sqlite3_free (xml);
+    if (ok != 1)
+	fprintf (stderr, "unable to reload the \"swap\" Style\n");
+    return ok;
+}
+
+static int
+check_map_color (sqlite3 * sqlite, const char *coverage, const char *style,
+		 unsigned char red, unsigned char green, unsigned char blue)
+{
+/* painting a Map Image and checking the color of its central pixel */
+    char *sql;
+    sqlite3_stmt *stmt;
+    int ret;
+    rl2RasterPtr rst = NULL;
+    unsigned char *rgba = NULL;
+    int rgba_sz;
+    unsigned char *p;
+    int ok = 0;
+
+    sql =
+	sqlite3_mprintf
+	("SELECT RL2_GetMapImageFromRaster(NULL, %Q, "
+	 "BuildMbr(0, 0, 64, 64, 3857), 64, 64, %Q, 'image/png', "
+	 "'#808080', 0, 100, 1)", coverage, style);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+	rst =
+	    rl2_raster_from_png (sqlite3_column_blob (stmt, 0),
+				 sqlite3_column_bytes (stmt, 0), 0);
+    sqlite3_finalize (stmt);
+    if (rst == NULL)
+      {
+	  fprintf (stderr, "\"%s\" (%s): unexpected NULL Map Image\n",
+		   coverage, style);
+	  return 0;
+      }
+    if (rl2_raster_data_to_RGBA (rst, &rgba, &rgba_sz) != RL2_OK)
+	goto end;
+    p = rgba + (((32 * 64) + 32) * 4);
+    if (p[0] == red && p[1] == green && p[2] == blue)
+	ok = 1;
+    else
+	fprintf (stderr,
+		 "\"%s\" (%s): unexpected color %d,%d,%d (expected %d,%d,%d)\n",
+		 coverage, style, p[0], p[1], p[2], red, green, blue);
+
+  end:
+    if (rgba != NULL)
+	free (rgba);
+    rl2_destroy_raster (rst);
+    return ok;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int result = 0;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    sqlite3 *db_other;
+    void *cache;
+    void *cache_other;
+    void *priv_data;
+    void *priv_other;
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+    unlink (TEST_DB);
+    if (!open_connection (TEST_DB, &db_handle, &cache, &priv_data))
+	return -1;
+    if (sqlite3_exec
+	(db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+	 &err_msg) != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+
+/* populating the test DB */
+    if (!create_coverage (db_handle, "cvg", 0, 200, 50, 10))
+	return -3;
+    if (!create_coverage (db_handle, "rgb", 0, 200, 50, 10))
+	return -4;
+    if (!register_style (db_handle, 3, 2, 1))
+	return -5;
+    if (!create_palette_coverage (db_handle))
+	return -6;
+
+/* loading everything into the Metadata Cache */
+    if (!check_map_color (db_handle, "cvg", "default", 200, 50, 10))
+	return -7;
+    if (!check_map_color (db_handle, "rgb", "swap", 10, 50, 200))
+	return -8;
+    if (!check_map_color (db_handle, "plt", "default", 0, 0, 255))
+	return -9;
+/* hitting the Metadata Cache */
+    if (!check_map_color (db_handle, "rgb", "swap", 10, 50, 200))
+	return -10;
+
+/* changes made by the same connection (sqlite3_total_changes) */
+    if (!create_coverage (db_handle, "cvg", 1, 100, 0, 0))
+	return -11;
+    if (!check_map_color (db_handle, "cvg", "default", 100, 100, 100))
+	return -12;
+    if (!reload_style (db_handle, 2, 1, 3))
+	return -13;
+    if (!check_map_color (db_handle, "rgb", "swap", 50, 200, 10))
+	return -14;
+    if (!set_palette_color (db_handle, 0, 255, 0))
+	return -15;
+    if (!check_map_color (db_handle, "plt", "default", 0, 255, 0))
+	return -16;
+
+/* changes committed by another connection (PRAGMA data_version) */
+    if (!open_connection (TEST_DB, &db_other, &cache_other, &priv_other))
+	return -17;
+    if (!create_coverage (db_other, "cvg", 0, 20, 220, 60))
+	result = -18;
+    else if (!check_map_color (db_handle, "cvg", "default", 20, 220, 60))
+	result = -19;
+    else if (!reload_style (db_other, 1, 3, 2))
+	result = -20;
+    else if (!check_map_color (db_handle, "rgb", "swap", 200, 10, 50))
+	result = -21;
+    else if (!set_palette_color (db_other, 255, 255, 0))
+	result = -22;
+    else if (!check_map_color (db_handle, "plt", "default", 255, 255, 0))
+	result = -23;
+    close_connection (db_other, cache_other, priv_other);
+
+    close_connection (db_handle, cache, priv_data);
+    spatialite_shutdown ();
+    unlink (TEST_DB);
+    return result;
+}
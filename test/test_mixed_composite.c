@@ -0,0 +1,328 @@
+/*
+
+ test_mixed_composite.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+struct test_section
+{
+/* an overlapping Section (with its own resolution) */
+    const char *name;
+    int width;
+    int height;
+    double minx;
+    double miny;
+    double maxx;
+    double maxy;
+};
+
+static const struct test_section sections[] = {
+    {"base", 512, 512, 0.0, 0.0, 1024.0, 1024.0},
+    {"detail", 512, 512, 256.0, 256.0, 768.0, 768.0},
+    {"east", 256, 256, 600.0, 100.0, 1112.0, 612.0},
+    {"strip", 200, 100, 100.0, 700.0, 500.0, 900.0},
+    {"tiny", 300, 300, 380.0, 380.0, 530.0, 530.0},
+    {NULL, 0, 0, 0.0, 0.0, 0.0, 0.0}
+};
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+import_section (sqlite3 * sqlite, const struct test_section *sect, int index)
+{
+/* importing a Section; every Section has its own pattern and white holes */
+    char *sql;
+    sqlite3_stmt *stmt;
+    unsigned char *pixels;
+    unsigned char *p;
+    int row;
+    int col;
+    int ret;
+    int ok = 0;
+    int sz = sect->width * sect->height * 3;
+
+    pixels = malloc (sz);
+    if (pixels == NULL)
+	return 0;
+    p = pixels;
+    for (row = 0; row < sect->height; row++)
+      {
+	  for (col = 0; col < sect->width; col++)
+	    {
+		if (((row / 16) + (col / 16)) % 5 == index % 5)
+		  {
+		      /* white: a transparent pixel */
+		      *p++ = 255;
+		      *p++ = 255;
+		      *p++ = 255;
+		      continue;
+		  }
+		*p++ = (row * (index + 1)) % 240;
+		*p++ = (col * (index + 2)) % 240;
+		*p++ = (index * 50) % 240;
+	    }
+      }
+    sql =
+	sqlite3_mprintf
+	("SELECT RL2_ImportSectionRawPixels('mixed', %Q, %d, %d, ?, "
+	 "BuildMbr(%1.2f, %1.2f, %1.2f, %1.2f, 3857), 0, 1)", sect->name,
+	 sect->width, sect->height, sect->minx, sect->miny, sect->maxx,
+	 sect->maxy);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret == SQLITE_OK)
+      {
+	  sqlite3_bind_blob (stmt, 1, pixels, sz, SQLITE_STATIC);
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_ROW)
+	      ok = sqlite3_column_int (stmt, 0);
+	  sqlite3_finalize (stmt);
+      }
+    free (pixels);
+    if (ok != 1)
+	fprintf (stderr, "ImportSectionRawPixels \"%s\" error\n", sect->name);
+    return ok;
+}
+
+static unsigned char *
+get_map_image (sqlite3 * sqlite, int max_threads, double minx, double miny,
+	       double maxx, double maxy, int width, int height,
+	       int transparent, int *image_size)
+{
+/* painting a Map Image from the Mixed Resolutions Coverage */
+    char *sql;
+    sqlite3_stmt *stmt;
+    int ret;
+    unsigned char *image = NULL;
+
+    *image_size = 0;
+    sql = sqlite3_mprintf ("SELECT RL2_SetMaxThreads(%d)", max_threads);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != max_threads)
+	return NULL;
+    sql =
+	sqlite3_mprintf
+	("SELECT RL2_GetMapImageFromRaster(NULL, 'mixed', "
+	 "BuildMbr(%1.2f, %1.2f, %1.2f, %1.2f, 3857), %d, %d, 'default', "
+	 "'image/png', '#ffffff', %d, 100, 1)", minx, miny, maxx, maxy, width,
+	 height, transparent);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return NULL;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+      {
+	  const unsigned char *blob = sqlite3_column_blob (stmt, 0);
+	  int blob_sz = sqlite3_column_bytes (stmt, 0);
+	  image = malloc (blob_sz);
+	  memcpy (image, blob, blob_sz);
+	  *image_size = blob_sz;
+      }
+    sqlite3_finalize (stmt);
+    return image;
+}
+
+static unsigned char *
+decode_rgba (const unsigned char *png, int png_size, int *rgba_size)
+{
+/* decoding a PNG image into an RGBA buffer */
+    unsigned char *rgba = NULL;
+    rl2RasterPtr rst = rl2_raster_from_png (png, png_size, 1);
+    if (rst == NULL)
+	return NULL;
+    if (rl2_raster_data_to_RGBA (rst, &rgba, rgba_size) != RL2_OK)
+	rgba = NULL;
+    rl2_destroy_raster (rst);
+    return rgba;
+}
+
+static int
+test_composite (sqlite3 * sqlite, double minx, double miny, double maxx,
+		double maxy, int width, int height, int transparent)
+{
+/* comparing the serial and the parallel Mixed Resolutions composition */
+    unsigned char *png_1;
+    unsigned char *png_4;
+    unsigned char *rgba_1 = NULL;
+    unsigned char *rgba_4 = NULL;
+    int png_1_sz;
+    int png_4_sz;
+    int rgba_1_sz;
+    int rgba_4_sz;
+    int ok = 0;
+
+    png_1 =
+	get_map_image (sqlite, 1, minx, miny, maxx, maxy, width, height,
+		       transparent, &png_1_sz);
+    png_4 =
+	get_map_image (sqlite, 4, minx, miny, maxx, maxy, width, height,
+		       transparent, &png_4_sz);
+    if (png_1 == NULL || png_4 == NULL)
+      {
+	  fprintf (stderr, "%dx%d: unexpected NULL Map Image\n", width,
+		   height);
+	  goto end;
+      }
+    rgba_1 = decode_rgba (png_1, png_1_sz, &rgba_1_sz);
+    rgba_4 = decode_rgba (png_4, png_4_sz, &rgba_4_sz);
+    if (rgba_1 == NULL || rgba_4 == NULL)
+      {
+	  fprintf (stderr, "%dx%d: unable to decode the Map Image\n", width,
+		   height);
+	  goto end;
+      }
+    if (rgba_1_sz != rgba_4_sz || memcmp (rgba_1, rgba_4, rgba_1_sz) != 0)
+      {
+	  fprintf (stderr,
+		   "%dx%d transparent=%d: serial and parallel pixels differ\n",
+		   width, height, transparent);
+	  goto end;
+      }
+    ok = 1;
+
+  end:
+    if (png_1 != NULL)
+	free (png_1);
+    if (png_4 != NULL)
+	free (png_4);
+    if (rgba_1 != NULL)
+	free (rgba_1);
+    if (rgba_4 != NULL)
+	free (rgba_4);
+    return ok;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    int i;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+
+/* a Mixed Resolutions Coverage: overlapping Sections */
+    if (execute_int
+	(db_handle,
+	 "SELECT RL2_CreateRasterCoverage('mixed', 'UINT8', 'RGB', 3, "
+	 "'PNG', 100, 256, 256, 3857, 1.0, 1.0, NULL, 0, 1, 0, 0, 0)") != 1)
+      {
+	  fprintf (stderr, "CreateRasterCoverage error\n");
+	  return -3;
+      }
+    for (i = 0; sections[i].name != NULL; i++)
+      {
+	  if (!import_section (db_handle, sections + i, i))
+	      return -4;
+      }
+
+/* full extent (sub-sampled), a detailed zoom and a partial overlap */
+    if (!test_composite (db_handle, 0.0, 0.0, 1112.0, 1024.0, 556, 512, 0))
+	return -5;
+    if (!test_composite (db_handle, 0.0, 0.0, 1112.0, 1024.0, 556, 512, 1))
+	return -6;
+    if (!test_composite (db_handle, 300.0, 300.0, 700.0, 700.0, 800, 800, 0))
+	return -7;
+    if (!test_composite (db_handle, 300.0, 300.0, 700.0, 700.0, 800, 800, 1))
+	return -8;
+    if (!test_composite (db_handle, 500.0, 50.0, 1200.0, 750.0, 350, 350, 0))
+	return -9;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+    return 0;
+}
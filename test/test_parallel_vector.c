@@ -0,0 +1,360 @@
+/*
+
+ test_parallel_vector.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+#define MAP_FRAME	"BuildMbr(1400000, 4700000, 1800000, 4950000, 3003)"
+
+static const char *polygon_style =
+    "<PolygonSymbolizer><Fill>"
+    "<SvgParameter name=\"fill\">#2040c0</SvgParameter>"
+    "<SvgParameter name=\"fill-opacity\">0.5</SvgParameter></Fill>"
+    "<Stroke><SvgParameter name=\"stroke\">#000000</SvgParameter>"
+    "<SvgParameter name=\"stroke-width\">3</SvgParameter></Stroke>"
+    "</PolygonSymbolizer>";
+
+static const char *line_style =
+    "<LineSymbolizer><Stroke>"
+    "<SvgParameter name=\"stroke\">#c02020</SvgParameter>"
+    "<SvgParameter name=\"stroke-opacity\">0.7</SvgParameter>"
+    "<SvgParameter name=\"stroke-width\">6</SvgParameter>"
+    "<SvgParameter name=\"stroke-linecap\">round</SvgParameter>"
+    "</Stroke></LineSymbolizer>";
+
+static const char *point_style =
+    "<PointSymbolizer><Graphic><Mark>"
+    "<WellKnownName>circle</WellKnownName><Fill>"
+    "<SvgParameter name=\"fill\">#20c040</SvgParameter></Fill>"
+    "<Stroke><SvgParameter name=\"stroke\">#000000</SvgParameter>"
+    "<SvgParameter name=\"stroke-width\">1.5</SvgParameter></Stroke>"
+    "</Mark><Size>14</Size></Graphic></PointSymbolizer>";
+
+static const char *wide_line_style =
+    "<LineSymbolizer><Stroke>"
+    "<SvgParameter name=\"stroke\">#8020c0</SvgParameter>"
+    "<SvgParameter name=\"stroke-opacity\">0.6</SvgParameter>"
+    "<SvgParameter name=\"stroke-width\">90</SvgParameter>"
+    "<SvgParameter name=\"stroke-linejoin\">mitre</SvgParameter>"
+    "</Stroke></LineSymbolizer>";
+
+static const char *large_mark_style =
+    "<PointSymbolizer><Graphic><Mark>"
+    "<WellKnownName>star</WellKnownName><Fill>"
+    "<SvgParameter name=\"fill\">#c0a020</SvgParameter>"
+    "<SvgParameter name=\"fill-opacity\">0.5</SvgParameter></Fill>"
+    "<Stroke><SvgParameter name=\"stroke\">#000000</SvgParameter>"
+    "<SvgParameter name=\"stroke-width\">12</SvgParameter></Stroke>"
+    "</Mark><Size>300</Size><Displacement><DisplacementX>40</DisplacementX>"
+    "<DisplacementY>-160</DisplacementY></Displacement>"
+    "</Graphic></PointSymbolizer>";
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+execute_sql (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning nothing */
+    char *err_msg = NULL;
+    int ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+create_coverage (sqlite3 * sqlite, const char *table, const char *type,
+		 const char *geometry)
+{
+/* creating and populating a Vector Coverage (400 overlapping Features) */
+    char *sql;
+    int ret;
+
+    sql = sqlite3_mprintf ("CREATE TABLE %s (id INTEGER PRIMARY KEY)", table);
+    ret = execute_sql (sqlite, sql);
+    sqlite3_free (sql);
+    if (!ret)
+	return 0;
+    sql =
+	sqlite3_mprintf
+	("SELECT AddGeometryColumn(%Q, 'geom', 3003, %Q, 'XY')", table, type);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+	return 0;
+    sql = sqlite3_mprintf ("SELECT CreateSpatialIndex(%Q, 'geom')", table);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+	return 0;
+
+/* pseudo-random (but repeatable) positions spread over the whole map */
+    sql =
+	sqlite3_mprintf
+	("WITH RECURSIVE seq(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM seq "
+	 "WHERE i < 400), pos(i, x, y) AS (SELECT i, "
+	 "1390000 + ((i * 7919) %% 420000), 4690000 + ((i * 104729) %% 270000) "
+	 "FROM seq) INSERT INTO %s (id, geom) SELECT i, %s FROM pos", table,
+	 geometry);
+    ret = execute_sql (sqlite, sql);
+    sqlite3_free (sql);
+    if (!ret)
+	return 0;
+
+    sql =
+	sqlite3_mprintf ("SELECT SE_RegisterVectorCoverage(%Q, %Q, 'geom')",
+			 table, table);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+	return 0;
+    return 1;
+}
+
+static unsigned char *
+render_map (sqlite3 * sqlite, const char *coverage, const char *symbolizer,
+	    int width, int height, int transparent, int *blob_sz)
+{
+/* painting the whole Coverage */
+    char *sql;
+    sqlite3_stmt *stmt;
+    unsigned char *blob = NULL;
+    int ret;
+
+    *blob_sz = 0;
+    sql =
+	sqlite3_mprintf
+	("SELECT RL2_GetStyledMapImageFromVector(NULL, %Q, " MAP_FRAME
+	 ", %d, %d, '<FeatureTypeStyle xmlns=\"http://www.opengis.net/se\" "
+	 "version=\"1.1.0\"><Name>bands</Name><Rule>%q</Rule>"
+	 "</FeatureTypeStyle>', 'image/png', '#ffffff', %d)", coverage, width,
+	 height, symbolizer, transparent);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "GetStyledMapImageFromVector SQL error: %s\n",
+		   sqlite3_errmsg (sqlite));
+	  return NULL;
+      }
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+      {
+	  *blob_sz = sqlite3_column_bytes (stmt, 0);
+	  blob = malloc (*blob_sz);
+	  memcpy (blob, sqlite3_column_blob (stmt, 0), *blob_sz);
+      }
+    sqlite3_finalize (stmt);
+    return blob;
+}
+
+static int
+compare_banded (sqlite3 * sqlite, const char *coverage,
+		const char *symbolizer, int width, int height, int transparent)
+{
+/* checking that the banded map is pixel-identical to the serial one */
+    unsigned char *serial;
+    unsigned char *banded;
+    int serial_sz;
+    int banded_sz;
+    int ok = 1;
+
+    if (execute_int (sqlite, "SELECT RL2_SetParallelVectorRendering(0)") != 0)
+	return 0;
+    serial =
+	render_map (sqlite, coverage, symbolizer, width, height, transparent,
+		    &serial_sz);
+    if (execute_int (sqlite, "SELECT RL2_SetParallelVectorRendering(1)") != 1)
+      {
+	  if (serial != NULL)
+	      free (serial);
+	  return 0;
+      }
+    banded =
+	render_map (sqlite, coverage, symbolizer, width, height, transparent,
+		    &banded_sz);
+    if (serial == NULL || banded == NULL)
+      {
+	  fprintf (stderr, "%s %dx%d: unexpected NULL image\n", coverage,
+		   width, height);
+	  ok = 0;
+      }
+    else if (serial_sz != banded_sz
+	     || memcmp (serial, banded, serial_sz) != 0)
+      {
+	  fprintf (stderr, "%s %dx%d: banded and serial maps differ\n",
+		   coverage, width, height);
+	  ok = 0;
+      }
+    if (serial != NULL)
+	free (serial);
+    if (banded != NULL)
+	free (banded);
+    return ok;
+}
+
+static int
+test_bands (sqlite3 * sqlite)
+{
+/* comparing banded and serial painting for all kinds of Features */
+    const int sizes[] = { 512, 512, 640, 333, 256, 1000, 0 };
+    int i;
+    int retcode = 0;
+
+    for (i = 0; sizes[i] != 0; i += 2)
+      {
+	  int width = sizes[i];
+	  int height = sizes[i + 1];
+	  if (!compare_banded
+	      (sqlite, "polygons", polygon_style, width, height, 0))
+	      retcode = -1;
+	  if (!compare_banded
+	      (sqlite, "polygons", polygon_style, width, height, 1))
+	      retcode = -2;
+	  if (!compare_banded (sqlite, "lines", line_style, width, height, 0))
+	      retcode = -3;
+	  if (!compare_banded (sqlite, "points", point_style, width, height, 1))
+	      retcode = -4;
+	  /* symbols reaching far beyond their own band */
+	  if (!compare_banded
+	      (sqlite, "lines", wide_line_style, width, height, 0))
+	      retcode = -5;
+	  if (!compare_banded
+	      (sqlite, "points", large_mark_style, width, height, 1))
+	      retcode = -6;
+      }
+    return retcode;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+/* 
+/ opening and initializing the "memory" test DB; parallel painting
+/ requires a serialized connection
+*/
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE |
+			   SQLITE_OPEN_FULLMUTEX, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+    if (execute_int (db_handle, "SELECT RL2_SetMaxThreads(4)") != 4)
+	return -3;
+
+/* rectangles, zig-zag lines and points overlapping across all bands */
+    if (!create_coverage
+	(db_handle, "polygons", "POLYGON",
+	 "BuildMbr(x, y, x + 30000 + (i % 7) * 9000, "
+	 "y + 20000 + (i % 5) * 11000, 3003)"))
+	return -4;
+    if (!create_coverage
+	(db_handle, "lines", "LINESTRING",
+	 "GeomFromText(printf('LINESTRING(%d %d, %d %d, %d %d)', x, y, "
+	 "x + 40000, y + 60000 + (i % 3) * 20000, x + 90000, y - 15000), 3003)"))
+	return -5;
+    if (!create_coverage (db_handle, "points", "POINT", "MakePoint(x, y, 3003)"))
+	return -6;
+
+    ret = test_bands (db_handle);
+    if (ret != 0)
+	return -10 + ret;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+    return 0;
+}
@@ -0,0 +1,522 @@
+/*
+
+ test_png8_palette.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+create_rgb_coverage (sqlite3 * sqlite)
+{
+/* creating and loading the RGB Coverage */
+    char *sql;
+
+    sql = sqlite3_mprintf ("SELECT RL2_CreateRasterCoverage("
+			   "'rgb_png8', 'UINT8', 'RGB', 3, 'PNG', 100, 256, 256, "
+			   "26914, %1.16f, %1.16f)", 0.152400030480006134,
+			   0.152400030480006134);
+    if (execute_int (sqlite, sql) != 1)
+      {
+	  sqlite3_free (sql);
+	  fprintf (stderr, "CreateRasterCoverage \"rgb_png8\" error\n");
+	  return 0;
+      }
+    sqlite3_free (sql);
+    if (execute_int
+	(sqlite,
+	 "SELECT RL2_LoadRastersFromDir('rgb_png8', 'map_samples/usgs-rgb', "
+	 "'.tif', 0, 26914, 0, 1)") != 1)
+      {
+	  fprintf (stderr, "LoadRastersFromDir \"rgb_png8\" error\n");
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+create_flat_coverage (sqlite3 * sqlite)
+{
+/* creating a Coverage containing just a single (black) color */
+    if (execute_int
+	(sqlite,
+	 "SELECT RL2_CreateRasterCoverage('flat_png8', 'UINT8', 'RGB', 3, "
+	 "'NONE', 100, 256, 256, 4326, 0.01, 0.01)") != 1)
+      {
+	  fprintf (stderr, "CreateRasterCoverage \"flat_png8\" error\n");
+	  return 0;
+      }
+    if (execute_int
+	(sqlite,
+	 "SELECT RL2_ImportSectionRawPixels('flat_png8', 'flat', 512, 512, "
+	 "zeroblob(512 * 512 * 3), BuildMbr(0, 0, 5.12, 5.12, 4326), 1, 1)")
+	!= 1)
+      {
+	  fprintf (stderr, "ImportSectionRawPixels \"flat_png8\" error\n");
+	  return 0;
+      }
+    return 1;
+}
+
+static unsigned char *
+get_png8 (sqlite3 * sqlite, const char *coverage, double fminx, double fminy,
+	  double fmaxx, double fmaxy, int *png_size)
+{
+/* 
+/ requesting a PNG8 Map Image; the BBOX is expressed as fractions
+/ of the Coverage's full extent
+*/
+    const char *sql;
+    sqlite3_stmt *stmt;
+    int ret;
+    unsigned char *png = NULL;
+
+    *png_size = 0;
+    sql = "SELECT RL2_GetMapImageFromRaster(NULL, ?1, "
+	"(SELECT BuildMbr(extent_minx + (extent_maxx - extent_minx) * ?2, "
+	"extent_miny + (extent_maxy - extent_miny) * ?3, "
+	"extent_minx + (extent_maxx - extent_minx) * ?4, "
+	"extent_miny + (extent_maxy - extent_miny) * ?5, srid) "
+	"FROM raster_coverages WHERE coverage_name = ?1), "
+	"256, 256, 'default', 'image/png8', '#ffffff', 0, 80, 1)";
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return NULL;
+    sqlite3_bind_text (stmt, 1, coverage, strlen (coverage), SQLITE_STATIC);
+    sqlite3_bind_double (stmt, 2, fminx);
+    sqlite3_bind_double (stmt, 3, fminy);
+    sqlite3_bind_double (stmt, 4, fmaxx);
+    sqlite3_bind_double (stmt, 5, fmaxy);
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+      {
+	  const unsigned char *blob = sqlite3_column_blob (stmt, 0);
+	  int blob_sz = sqlite3_column_bytes (stmt, 0);
+	  png = malloc (blob_sz);
+	  memcpy (png, blob, blob_sz);
+	  *png_size = blob_sz;
+      }
+    sqlite3_finalize (stmt);
+    if (png == NULL)
+	fprintf (stderr, "%s: unexpected NULL PNG8 Map Image\n", coverage);
+    return png;
+}
+
+static const unsigned char *
+find_plte (const unsigned char *png, int png_size, unsigned int *length)
+{
+/* searching the PLTE chunk of some PNG image */
+    int pos = 8;
+    while (pos + 8 <= png_size)
+      {
+	  unsigned int len =
+	      ((unsigned int) png[pos] << 24) | (png[pos + 1] << 16) |
+	      (png[pos + 2] << 8) | png[pos + 3];
+	  if (memcmp (png + pos + 4, "PLTE", 4) == 0)
+	    {
+		*length = len;
+		return png + pos + 8;
+	    }
+	  pos += 12 + len;
+      }
+    *length = 0;
+    return NULL;
+}
+
+static int
+same_palette (const unsigned char *png_1, int png_1_sz,
+	      const unsigned char *png_2, int png_2_sz)
+{
+/* checking if two PNG images share the same PLTE */
+    unsigned int len_1;
+    unsigned int len_2;
+    const unsigned char *plte_1 = find_plte (png_1, png_1_sz, &len_1);
+    const unsigned char *plte_2 = find_plte (png_2, png_2_sz, &len_2);
+    if (plte_1 == NULL || plte_2 == NULL)
+	return 0;
+    if (len_1 != len_2)
+	return 0;
+    if (memcmp (plte_1, plte_2, len_1) != 0)
+	return 0;
+    return 1;
+}
+
+static unsigned char *
+decode_rgba (const unsigned char *png, int png_size, int *rgba_size)
+{
+/* decoding a PNG image into an RGBA buffer */
+    unsigned char *rgba = NULL;
+    rl2RasterPtr rst = rl2_raster_from_png (png, png_size, 0);
+    if (rst == NULL)
+	return NULL;
+    if (rl2_raster_data_to_RGBA (rst, &rgba, rgba_size) != RL2_OK)
+	rgba = NULL;
+    rl2_destroy_raster (rst);
+    return rgba;
+}
+
+static int
+test_arguments (sqlite3 * sqlite)
+{
+/* testing the SQL functions setting the PNG8 options */
+    if (execute_int (sqlite, "SELECT RL2_GetPNG8StablePalette()") != 0)
+	return 0;
+    if (execute_int (sqlite, "SELECT RL2_GetPNG8Dithering()") != 0)
+	return 0;
+    if (execute_int (sqlite, "SELECT RL2_SetPNG8StablePalette(NULL)") != -1)
+	return 0;
+    if (execute_int (sqlite, "SELECT RL2_SetPNG8Dithering('yes')") != -1)
+	return 0;
+    if (execute_int (sqlite, "SELECT RL2_SetPNG8Dithering(1)") != 1)
+	return 0;
+    if (execute_int (sqlite, "SELECT RL2_GetPNG8Dithering()") != 1)
+	return 0;
+    if (execute_int (sqlite, "SELECT RL2_SetPNG8Dithering(0)") != 0)
+	return 0;
+    return 1;
+}
+
+static int
+test_dithering (sqlite3 * sqlite)
+{
+/* ordered dithering must actually change the output pixels */
+    unsigned char *png_1 = NULL;
+    unsigned char *png_2 = NULL;
+    unsigned char *rgba_1 = NULL;
+    unsigned char *rgba_2 = NULL;
+    int png_1_sz;
+    int png_2_sz;
+    int rgba_1_sz;
+    int rgba_2_sz;
+    int retcode = 0;
+
+    png_1 = get_png8 (sqlite, "rgb_png8", 0.0, 0.0, 0.5, 0.5, &png_1_sz);
+    if (execute_int (sqlite, "SELECT RL2_SetPNG8Dithering(1)") != 1)
+	goto end;
+    png_2 = get_png8 (sqlite, "rgb_png8", 0.0, 0.0, 0.5, 0.5, &png_2_sz);
+    if (execute_int (sqlite, "SELECT RL2_SetPNG8Dithering(0)") != 0)
+	goto end;
+    if (png_1 == NULL || png_2 == NULL)
+	goto end;
+    rgba_1 = decode_rgba (png_1, png_1_sz, &rgba_1_sz);
+    rgba_2 = decode_rgba (png_2, png_2_sz, &rgba_2_sz);
+    if (rgba_1 == NULL || rgba_2 == NULL || rgba_1_sz != rgba_2_sz)
+      {
+	  fprintf (stderr, "Dithering: unable to decode the PNG8 images\n");
+	  goto end;
+      }
+    if (memcmp (rgba_1, rgba_2, rgba_1_sz) == 0)
+      {
+	  fprintf (stderr, "Dithering: no effect on the output pixels\n");
+	  goto end;
+      }
+    retcode = 1;
+
+  end:
+    if (png_1 != NULL)
+	free (png_1);
+    if (png_2 != NULL)
+	free (png_2);
+    if (rgba_1 != NULL)
+	free (rgba_1);
+    if (rgba_2 != NULL)
+	free (rgba_2);
+    return retcode;
+}
+
+static int
+sample_stable_palette (sqlite3 * sqlite, const char *coverage, double fmin,
+		       double fmax)
+{
+/* rendering the eight images needed to seed the stable Palette */
+    int i;
+    for (i = 0; i < 8; i++)
+      {
+	  int png_sz;
+	  double step = (fmax - fmin) / 8.0;
+	  double x = fmin + (step * i);
+	  unsigned char *png =
+	      get_png8 (sqlite, coverage, x, fmin, x + step, fmax, &png_sz);
+	  if (png == NULL)
+	      return 0;
+	  free (png);
+      }
+    return 1;
+}
+
+static int
+test_stable_palette (sqlite3 * sqlite)
+{
+/* all tiles must share the same Palette once it has been seeded */
+    unsigned char *ref_a = NULL;
+    unsigned char *ref_b = NULL;
+    unsigned char *png_a = NULL;
+    unsigned char *png_b = NULL;
+    unsigned char *png_c = NULL;
+    int ref_a_sz;
+    int ref_b_sz;
+    int png_a_sz;
+    int png_b_sz;
+    int png_c_sz;
+    int retcode = 0;
+
+/* per-image Palettes */
+    ref_a = get_png8 (sqlite, "rgb_png8", 0.0, 0.0, 0.5, 0.5, &ref_a_sz);
+    ref_b = get_png8 (sqlite, "rgb_png8", 0.5, 0.5, 1.0, 1.0, &ref_b_sz);
+    if (ref_a == NULL || ref_b == NULL)
+	goto end;
+    if (same_palette (ref_a, ref_a_sz, ref_b, ref_b_sz))
+      {
+	  fprintf (stderr, "Stable: unexpected identical Palettes\n");
+	  goto end;
+      }
+
+/* seeding the stable Palette */
+    if (execute_int (sqlite, "SELECT RL2_SetPNG8StablePalette(1)") != 1)
+	goto end;
+    png_a = get_png8 (sqlite, "rgb_png8", 0.0, 0.0, 0.5, 0.5, &png_a_sz);
+    if (png_a == NULL)
+	goto end;
+    if (!same_palette (png_a, png_a_sz, ref_a, ref_a_sz))
+      {
+	  fprintf (stderr, "Stable: first image not quantized on its own\n");
+	  goto end;
+      }
+    free (png_a);
+    png_a = NULL;
+    if (!sample_stable_palette (sqlite, "rgb_png8", 0.0, 1.0))
+	goto end;
+
+/* now both tiles must share the same Palette */
+    png_a = get_png8 (sqlite, "rgb_png8", 0.0, 0.0, 0.5, 0.5, &png_a_sz);
+    png_b = get_png8 (sqlite, "rgb_png8", 0.5, 0.5, 1.0, 1.0, &png_b_sz);
+    if (png_a == NULL || png_b == NULL)
+	goto end;
+    if (!same_palette (png_a, png_a_sz, png_b, png_b_sz))
+      {
+	  fprintf (stderr, "Stable: tiles not sharing the same Palette\n");
+	  goto end;
+      }
+
+/* writing into the DB must discard the stable Palette */
+    if (sqlite3_exec
+	(sqlite,
+	 "UPDATE raster_coverages SET title = 'changed' "
+	 "WHERE coverage_name = 'rgb_png8'", NULL, NULL, NULL) != SQLITE_OK)
+	goto end;
+    png_c = get_png8 (sqlite, "rgb_png8", 0.5, 0.5, 1.0, 1.0, &png_c_sz);
+    if (png_c == NULL)
+	goto end;
+    if (!same_palette (png_c, png_c_sz, ref_b, ref_b_sz))
+      {
+	  fprintf (stderr, "Stable: Palette not discarded after a change\n");
+	  goto end;
+      }
+    retcode = 1;
+
+  end:
+    execute_int (sqlite, "SELECT RL2_SetPNG8StablePalette(0)");
+    if (ref_a != NULL)
+	free (ref_a);
+    if (ref_b != NULL)
+	free (ref_b);
+    if (png_a != NULL)
+	free (png_a);
+    if (png_b != NULL)
+	free (png_b);
+    if (png_c != NULL)
+	free (png_c);
+    return retcode;
+}
+
+static int
+test_degenerate_palette (sqlite3 * sqlite)
+{
+/* a single-color sample must never become the stable Palette */
+    unsigned char *png = NULL;
+    unsigned char *rgba = NULL;
+    int png_sz;
+    int rgba_sz;
+    int retcode = 0;
+
+    if (execute_int (sqlite, "SELECT RL2_SetPNG8StablePalette(1)") != 1)
+	goto end;
+    if (!sample_stable_palette (sqlite, "flat_png8", 0.0, 1.0))
+	goto end;
+
+/* black Coverage on a white background */
+    png = get_png8 (sqlite, "flat_png8", -1.0, -1.0, 2.0, 2.0, &png_sz);
+    if (png == NULL)
+	goto end;
+    rgba = decode_rgba (png, png_sz, &rgba_sz);
+    if (rgba == NULL || rgba_sz != 256 * 256 * 4)
+      {
+	  fprintf (stderr, "Degenerate: unable to decode the PNG8 image\n");
+	  goto end;
+      }
+    if (rgba[0] != 255 || rgba[1] != 255 || rgba[2] != 255)
+      {
+	  fprintf (stderr, "Degenerate: white background lost\n");
+	  goto end;
+      }
+    if (rgba[(128 * 256 + 128) * 4] != 0)
+      {
+	  fprintf (stderr, "Degenerate: black Coverage lost\n");
+	  goto end;
+      }
+    retcode = 1;
+
+  end:
+    execute_int (sqlite, "SELECT RL2_SetPNG8StablePalette(0)");
+    if (png != NULL)
+	free (png);
+    if (rgba != NULL)
+	free (rgba);
+    return retcode;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+    char *old_SPATIALITE_SECURITY_ENV = NULL;
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+    old_SPATIALITE_SECURITY_ENV = getenv ("SPATIALITE_SECURITY");
+#ifdef _WIN32
+    putenv ("SPATIALITE_SECURITY=relaxed");
+#else /* not WIN32 */
+    setenv ("SPATIALITE_SECURITY", "relaxed", 1);
+#endif
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+
+    if (!test_arguments (db_handle))
+	return -3;
+    if (!create_rgb_coverage (db_handle))
+	return -4;
+    if (!create_flat_coverage (db_handle))
+	return -5;
+    if (!test_dithering (db_handle))
+	return -10;
+    if (!test_stable_palette (db_handle))
+	return -20;
+    if (!test_degenerate_palette (db_handle))
+	return -30;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+
+    if (old_SPATIALITE_SECURITY_ENV)
+      {
+#ifdef _WIN32
+	  char *env = sqlite3_mprintf ("SPATIALITE_SECURITY=%s",
+				       old_SPATIALITE_SECURITY_ENV);
+	  putenv (env);
+	  sqlite3_free (env);
+#else /* not WIN32 */
+	  setenv ("SPATIALITE_SECURITY", old_SPATIALITE_SECURITY_ENV, 1);
+#endif
+      }
+    else
+      {
+#ifdef _WIN32
+	  putenv ("SPATIALITE_SECURITY=");
+#else /* not WIN32 */
+	  unsetenv ("SPATIALITE_SECURITY");
+#endif
+      }
+    return 0;
+}
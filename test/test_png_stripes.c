@@ -0,0 +1,382 @@
+/*
+
+ test_png_stripes.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+static int
+execute_check (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning True/False */
+    sqlite3_stmt *stmt;
+    int ret;
+    int retcode = 0;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return SQLITE_ERROR;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+      {
+	  if (sqlite3_column_int (stmt, 0) == 1)
+	      retcode = 1;
+      }
+    sqlite3_finalize (stmt);
+    if (retcode == 1)
+	return SQLITE_OK;
+    return SQLITE_ERROR;
+}
+
+static int
+set_max_threads (sqlite3 * sqlite, int max_threads)
+{
+/* setting the max number of concurrent threads */
+    char *sql;
+    sqlite3_stmt *stmt;
+    int ret;
+    int retcode = 0;
+
+    sql = sqlite3_mprintf ("SELECT RL2_SetMaxThreads(%d)", max_threads);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW)
+      {
+	  if (sqlite3_column_int (stmt, 0) == max_threads)
+	      retcode = 1;
+      }
+    sqlite3_finalize (stmt);
+    return retcode;
+}
+
+static int
+create_coverage (sqlite3 * sqlite, const char *coverage,
+		 const char *pixel_name, int num_bands, double resolution,
+		 const char *dir_path)
+{
+/* creating and loading some DBMS Coverage */
+    int ret;
+    char *sql;
+
+    sql = sqlite3_mprintf ("SELECT RL2_CreateRasterCoverage("
+			   "%Q, 'UINT8', %Q, %d, 'PNG', 100, 256, 256, 26914, "
+			   "%1.16f, %1.16f)", coverage, pixel_name, num_bands,
+			   resolution, resolution);
+    ret = execute_check (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CreateRasterCoverage \"%s\" error\n", coverage);
+	  return 0;
+      }
+    sql =
+	sqlite3_mprintf
+	("SELECT RL2_LoadRastersFromDir(%Q, %Q, %Q, 0, 26914, 0, 1)", coverage,
+	 dir_path, ".tif");
+    ret = execute_check (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "LoadRastersFromDir \"%s\" error\n", coverage);
+	  return 0;
+      }
+    return 1;
+}
+
+static unsigned char *
+get_map_image (sqlite3 * sqlite, const char *coverage, const char *format,
+	       int transparent, int *image_size)
+{
+/* requesting a Map Image (taller than 128 rows) covering the whole Coverage */
+    const char *sql;
+    sqlite3_stmt *stmt;
+    int ret;
+    unsigned char *image = NULL;
+
+    *image_size = 0;
+    sql = "SELECT RL2_GetMapImageFromRaster(NULL, ?, "
+	"(SELECT BuildMbr(extent_minx, extent_miny, extent_maxx, extent_maxy, srid) "
+	"FROM raster_coverages WHERE coverage_name = ?), "
+	"512, 384, 'default', ?, '#ffffff', ?, 80, 1)";
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return NULL;
+    sqlite3_bind_text (stmt, 1, coverage, strlen (coverage), SQLITE_STATIC);
+    sqlite3_bind_text (stmt, 2, coverage, strlen (coverage), SQLITE_STATIC);
+    sqlite3_bind_text (stmt, 3, format, strlen (format), SQLITE_STATIC);
+    sqlite3_bind_int (stmt, 4, transparent);
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+      {
+	  const unsigned char *blob = sqlite3_column_blob (stmt, 0);
+	  int blob_sz = sqlite3_column_bytes (stmt, 0);
+	  image = malloc (blob_sz);
+	  memcpy (image, blob, blob_sz);
+	  *image_size = blob_sz;
+      }
+    sqlite3_finalize (stmt);
+    return image;
+}
+
+static int
+count_idat_chunks (const unsigned char *png, int png_size)
+{
+/* counting how many IDAT chunks are in some PNG image */
+    int count = 0;
+    int pos = 8;
+    while (pos + 8 <= png_size)
+      {
+	  unsigned int len =
+	      ((unsigned int) png[pos] << 24) | (png[pos + 1] << 16) |
+	      (png[pos + 2] << 8) | png[pos + 3];
+	  if (memcmp (png + pos + 4, "IDAT", 4) == 0)
+	      count++;
+	  pos += 12 + len;
+      }
+    return count;
+}
+
+static unsigned char *
+decode_rgba (const unsigned char *png, int png_size, unsigned int *width,
+	     unsigned int *height, int *rgba_size)
+{
+/* decoding a PNG image into an RGBA buffer */
+    unsigned char *rgba = NULL;
+    rl2RasterPtr rst = rl2_raster_from_png (png, png_size, 1);
+    if (rst == NULL)
+	return NULL;
+    if (rl2_get_raster_size (rst, width, height) != RL2_OK)
+      {
+	  rl2_destroy_raster (rst);
+	  return NULL;
+      }
+    if (rl2_raster_data_to_RGBA (rst, &rgba, rgba_size) != RL2_OK)
+	rgba = NULL;
+    rl2_destroy_raster (rst);
+    return rgba;
+}
+
+static int
+test_stripes (sqlite3 * sqlite, const char *coverage, const char *format,
+	      int transparent, int striped)
+{
+/* comparing the single-threaded and the multi-threaded Map Images */
+    unsigned char *png_1 = NULL;
+    unsigned char *png_4 = NULL;
+    int png_1_sz;
+    int png_4_sz;
+    unsigned char *rgba_1 = NULL;
+    unsigned char *rgba_4 = NULL;
+    int rgba_1_sz;
+    int rgba_4_sz;
+    unsigned int width_1;
+    unsigned int height_1;
+    unsigned int width_4;
+    unsigned int height_4;
+    int retcode = 0;
+
+    if (!set_max_threads (sqlite, 1))
+	goto end;
+    png_1 = get_map_image (sqlite, coverage, format, transparent, &png_1_sz);
+    if (!set_max_threads (sqlite, 4))
+	goto end;
+    png_4 = get_map_image (sqlite, coverage, format, transparent, &png_4_sz);
+    if (png_1 == NULL || png_4 == NULL)
+      {
+	  fprintf (stderr, "%s %s: unexpected NULL Map Image\n", coverage,
+		   format);
+	  goto end;
+      }
+    if (striped)
+      {
+	  /* 384 rows and 4 threads: exactly 4 Stripes, one IDAT each */
+	  if (count_idat_chunks (png_1, png_1_sz) != 1)
+	    {
+		fprintf (stderr, "%s %s: unexpected single-thread IDAT count\n",
+			 coverage, format);
+		goto end;
+	    }
+	  if (count_idat_chunks (png_4, png_4_sz) != 4)
+	    {
+		fprintf (stderr, "%s %s: unexpected multi-thread IDAT count\n",
+			 coverage, format);
+		goto end;
+	    }
+      }
+
+    rgba_1 = decode_rgba (png_1, png_1_sz, &width_1, &height_1, &rgba_1_sz);
+    rgba_4 = decode_rgba (png_4, png_4_sz, &width_4, &height_4, &rgba_4_sz);
+    if (rgba_1 == NULL || rgba_4 == NULL)
+      {
+	  fprintf (stderr, "%s %s: unable to decode the PNG image\n", coverage,
+		   format);
+	  goto end;
+      }
+    if (width_1 != 512 || height_1 != 384 || width_4 != 512
+	|| height_4 != 384)
+      {
+	  fprintf (stderr, "%s %s: unexpected PNG dimensions\n", coverage,
+		   format);
+	  goto end;
+      }
+    if (rgba_1_sz != rgba_4_sz || memcmp (rgba_1, rgba_4, rgba_1_sz) != 0)
+      {
+	  fprintf (stderr, "%s %s: mismatching pixels\n", coverage, format);
+	  goto end;
+      }
+    retcode = 1;
+
+  end:
+    if (png_1 != NULL)
+	free (png_1);
+    if (png_4 != NULL)
+	free (png_4);
+    if (rgba_1 != NULL)
+	free (rgba_1);
+    if (rgba_4 != NULL)
+	free (rgba_4);
+    return retcode;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+    char *old_SPATIALITE_SECURITY_ENV = NULL;
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+    old_SPATIALITE_SECURITY_ENV = getenv ("SPATIALITE_SECURITY");
+#ifdef _WIN32
+    putenv ("SPATIALITE_SECURITY=relaxed");
+#else /* not WIN32 */
+    setenv ("SPATIALITE_SECURITY", "relaxed", 1);
+#endif
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+
+/* creating the test Coverages */
+    if (!create_coverage (db_handle, "rgb_stripes", "RGB", 3,
+			  0.152400030480006134, "map_samples/usgs-rgb"))
+	return -3;
+    if (!create_coverage (db_handle, "gray_stripes", "GRAYSCALE", 1,
+			  1.0, "map_samples/usgs-gray"))
+	return -4;
+
+/* RGB and RGBA */
+    if (!test_stripes (db_handle, "rgb_stripes", "image/png", 0, 1))
+	return -10;
+    if (!test_stripes (db_handle, "rgb_stripes", "image/png", 1, 1))
+	return -11;
+
+/* Grayscale and Grayscale + Alpha */
+    if (!test_stripes (db_handle, "gray_stripes", "image/png", 0, 1))
+	return -20;
+    if (!test_stripes (db_handle, "gray_stripes", "image/png", 1, 1))
+	return -21;
+
+/* PNG8 (Palette): never striped, but must not depend on threads */
+    if (!test_stripes (db_handle, "rgb_stripes", "image/png8", 0, 0))
+	return -30;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+
+    if (old_SPATIALITE_SECURITY_ENV)
+      {
+#ifdef _WIN32
+	  char *env = sqlite3_mprintf ("SPATIALITE_SECURITY=%s",
+				       old_SPATIALITE_SECURITY_ENV);
+	  putenv (env);
+	  sqlite3_free (env);
+#else /* not WIN32 */
+	  setenv ("SPATIALITE_SECURITY", old_SPATIALITE_SECURITY_ENV, 1);
+#endif
+      }
+    else
+      {
+#ifdef _WIN32
+	  putenv ("SPATIALITE_SECURITY=");
+#else /* not WIN32 */
+	  unsetenv ("SPATIALITE_SECURITY");
+#endif
+      }
+    return 0;
+}
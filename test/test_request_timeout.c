@@ -0,0 +1,435 @@
+/*
+
+ test_request_timeout.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+#define SECTION_SIZE	2048
+
+/* a deadline expiring well before the first Tile or Feature */
+#define TINY_TIMEOUT	"0.000001"
+
+#define VECTOR_MAP \
+    "RL2_GetMapImageFromVector(NULL, 'points', " \
+    "BuildMbr(0, 0, 2048, 2048, 3857), 512, 512, 'default', 'image/png')"
+
+#define RASTER_MAP \
+    "RL2_GetMapImageFromRaster(NULL, 'ortho', " \
+    "BuildMbr(0, 0, 2048, 2048, 3857), 512, 512, 'default', 'image/png')"
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+execute_sql (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning nothing */
+    char *err_msg = NULL;
+    int ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+import_section (sqlite3 * sqlite)
+{
+/* importing a big RGB Section (without Pyramid) */
+    const char *sql;
+    sqlite3_stmt *stmt;
+    unsigned char *pixels;
+    unsigned char *p;
+    int row;
+    int col;
+    int ret;
+    int ok = 0;
+
+    pixels = malloc (SECTION_SIZE * SECTION_SIZE * 3);
+    if (pixels == NULL)
+	return 0;
+    p = pixels;
+    for (row = 0; row < SECTION_SIZE; row++)
+      {
+	  for (col = 0; col < SECTION_SIZE; col++)
+	    {
+		*p++ = row % 256;
+		*p++ = col % 256;
+		*p++ = (row + col) % 256;
+	    }
+      }
+    sql = "SELECT RL2_ImportSectionRawPixels('ortho', 'section', 2048, 2048, "
+	"?, BuildMbr(0, 0, 2048, 2048, 3857), 0, 1)";
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret == SQLITE_OK)
+      {
+	  sqlite3_bind_blob (stmt, 1, pixels, SECTION_SIZE * SECTION_SIZE * 3,
+			     SQLITE_STATIC);
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_ROW)
+	      ok = sqlite3_column_int (stmt, 0);
+	  sqlite3_finalize (stmt);
+      }
+    free (pixels);
+    if (ok != 1)
+	fprintf (stderr, "ImportSectionRawPixels error\n");
+    return ok;
+}
+
+static int
+create_coverages (sqlite3 * sqlite)
+{
+/* creating an RGB Raster Coverage and a Vector Coverage */
+    if (execute_int
+	(sqlite,
+	 "SELECT RL2_CreateRasterCoverage('ortho', 'UINT8', 'RGB', 3, "
+	 "'DEFLATE', 100, 256, 256, 3857, 1.0, 1.0)") != 1)
+	return 0;
+    if (!import_section (sqlite))
+	return 0;
+
+    if (!execute_sql (sqlite, "CREATE TABLE points (id INTEGER PRIMARY KEY)"))
+	return 0;
+    if (execute_int
+	(sqlite,
+	 "SELECT AddGeometryColumn('points', 'geom', 3857, 'POINT', 'XY')") !=
+	1)
+	return 0;
+    if (execute_int (sqlite, "SELECT CreateSpatialIndex('points', 'geom')")
+	!= 1)
+	return 0;
+    if (!execute_sql
+	(sqlite,
+	 "WITH RECURSIVE seq(i) AS (SELECT 0 UNION ALL SELECT i + 1 FROM seq "
+	 "WHERE i < 39999) INSERT INTO points (id, geom) SELECT i + 1, "
+	 "MakePoint((i % 200) * 10.24 + 5, (i / 200) * 10.24 + 5, 3857) "
+	 "FROM seq"))
+	return 0;
+    if (execute_int
+	(sqlite, "SELECT SE_RegisterVectorCoverage('points', 'points', 'geom')")
+	!= 1)
+	return 0;
+    return execute_sql (sqlite,
+			"CREATE TABLE images (id INTEGER PRIMARY KEY, "
+			"img BLOB NOT NULL)");
+}
+
+static int
+save_image (sqlite3 * sqlite, int id, const char *map)
+{
+/* painting a Map, saving the image */
+    char *sql = sqlite3_mprintf ("INSERT INTO images (id, img) "
+				 "SELECT %d, %s", id, map);
+    int ret = execute_sql (sqlite, sql);
+    sqlite3_free (sql);
+    return ret;
+}
+
+static int
+same_image (sqlite3 * sqlite, int id, const char *map)
+{
+/* painting a Map again, comparing it with a saved image */
+    char *sql = sqlite3_mprintf ("SELECT img = %s FROM images WHERE id = %d",
+				 map, id);
+    int ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    return (ret == 1) ? 1 : 0;
+}
+
+static int
+is_aborted (sqlite3 * sqlite, const char *map)
+{
+/* checking if painting a Map has been cancelled */
+    char *sql = sqlite3_mprintf ("SELECT %s IS NULL", map);
+    int ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    return (ret == 1) ? 1 : 0;
+}
+
+static int
+app_progress_handler (void *arg)
+{
+/* a progress handler set by the application: just counting calls */
+    int *count = (int *) arg;
+    *count += 1;
+    return 0;
+}
+
+static int
+count_pyramid_tiles (sqlite3 * sqlite)
+{
+/* counting the Pyramid tiles */
+    return execute_int (sqlite,
+			"SELECT Count(*) FROM ortho_tiles WHERE pyramid_level > 0");
+}
+
+static int
+is_usable (sqlite3 * sqlite)
+{
+/* 
+/ checking that the connection is still usable after a cancelled request:
+/ no pending transaction, and no progress handler interrupting plain SQL
+*/
+    if (!sqlite3_get_autocommit (sqlite))
+      {
+	  fprintf (stderr, "Unexpected pending transaction\n");
+	  return 0;
+      }
+    if (execute_int
+	(sqlite,
+	 "WITH RECURSIVE seq(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM seq "
+	 "WHERE i < 200000) SELECT Count(*) FROM seq") != 200000)
+      {
+	  fprintf (stderr, "Plain SQL unexpectedly interrupted\n");
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+test_timeout_args (sqlite3 * sqlite, const void *priv_data)
+{
+/* setting and getting the per-request deadline */
+    double seconds;
+
+    if (execute_int (sqlite, "SELECT RL2_SetRequestTimeout('abc')") != -1)
+	return -1;
+    if (execute_int (sqlite, "SELECT RL2_SetRequestTimeout(-1)") != -1)
+	return -2;
+    if (execute_int (sqlite, "SELECT RL2_SetRequestTimeout(2.5)") != 1)
+	return -3;
+    if (execute_int (sqlite, "SELECT RL2_GetRequestTimeout() = 2.5") != 1)
+	return -4;
+    if (rl2_get_request_timeout (priv_data, &seconds) != RL2_OK
+	|| seconds != 2.5)
+	return -5;
+    if (rl2_set_request_timeout (priv_data, -1.0) != RL2_ERROR)
+	return -6;
+    if (rl2_set_request_timeout (NULL, 1.0) != RL2_ERROR)
+	return -7;
+    if (rl2_set_request_timeout (priv_data, 10.0) != RL2_OK)
+	return -8;
+    if (execute_int (sqlite, "SELECT RL2_GetRequestTimeout() = 10.0") != 1)
+	return -9;
+    if (execute_int (sqlite, "SELECT RL2_SetRequestTimeout(0)") != 1)
+	return -10;
+    if (execute_int (sqlite, "SELECT RL2_GetRequestTimeout() = 0.0") != 1)
+	return -11;
+    return 0;
+}
+
+static int
+test_timeout (sqlite3 * sqlite)
+{
+/* a tiny deadline must abort long requests */
+
+/* reference Maps (no deadline at all) */
+    if (!save_image (sqlite, 1, VECTOR_MAP))
+	return -1;
+    if (!save_image (sqlite, 2, RASTER_MAP))
+	return -2;
+
+    if (execute_int (sqlite, "SELECT RL2_SetRequestTimeout(" TINY_TIMEOUT ")")
+	!= 1)
+	return -3;
+    if (!is_aborted (sqlite, VECTOR_MAP))
+      {
+	  fprintf (stderr, "GetMapImageFromVector not cancelled\n");
+	  return -4;
+      }
+    if (!is_usable (sqlite))
+	return -5;
+    if (!is_aborted (sqlite, RASTER_MAP))
+      {
+	  fprintf (stderr, "GetMapImageFromRaster not cancelled\n");
+	  return -6;
+      }
+    if (!is_usable (sqlite))
+	return -7;
+    if (execute_int (sqlite, "SELECT RL2_Pyramidize('ortho', NULL, 1, 1)") !=
+	0)
+      {
+	  fprintf (stderr, "Pyramidize not cancelled\n");
+	  return -8;
+      }
+    if (!is_usable (sqlite))
+	return -9;
+    if (count_pyramid_tiles (sqlite) != 0)
+      {
+	  fprintf (stderr, "Cancelled Pyramidize not rolled back\n");
+	  return -10;
+      }
+
+/* a generous deadline: each request has its own */
+    if (execute_int (sqlite, "SELECT RL2_SetRequestTimeout(600)") != 1)
+	return -11;
+    if (!same_image (sqlite, 1, VECTOR_MAP))
+      {
+	  fprintf (stderr, "GetMapImageFromVector: mismatching image\n");
+	  return -12;
+      }
+    if (!same_image (sqlite, 2, RASTER_MAP))
+      {
+	  fprintf (stderr, "GetMapImageFromRaster: mismatching image\n");
+	  return -13;
+      }
+
+/* no deadline at all */
+    if (execute_int (sqlite, "SELECT RL2_SetRequestTimeout(0)") != 1)
+	return -14;
+    if (execute_int (sqlite, "SELECT RL2_Pyramidize('ortho', NULL, 1, 1)") !=
+	1)
+      {
+	  fprintf (stderr, "Pyramidize failed\n");
+	  return -15;
+      }
+    if (count_pyramid_tiles (sqlite) <= 0)
+	return -16;
+    if (!same_image (sqlite, 1, VECTOR_MAP))
+	return -17;
+    return 0;
+}
+
+static int
+test_app_progress_handler (sqlite3 * sqlite)
+{
+/* without a deadline the application's progress handler must survive */
+    int count = 0;
+
+    if (execute_int (sqlite, "SELECT RL2_SetRequestTimeout(0)") != 1)
+	return -1;
+    sqlite3_progress_handler (sqlite, 100, app_progress_handler, &count);
+    if (!same_image (sqlite, 1, VECTOR_MAP))
+	return -2;
+    if (!same_image (sqlite, 2, RASTER_MAP))
+	return -3;
+    count = 0;
+    if (!is_usable (sqlite))
+	return -4;
+    if (count == 0)
+      {
+	  fprintf (stderr, "Application progress handler removed\n");
+	  return -5;
+      }
+    sqlite3_progress_handler (sqlite, 0, NULL, NULL);
+    return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    sqlite3 *db_handle;
+    char *err_msg = NULL;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+    if (!create_coverages (db_handle))
+	return -3;
+
+    ret = test_timeout_args (db_handle, priv_data);
+    if (ret != 0)
+	return -10 + ret;
+    ret = test_timeout (db_handle);
+    if (ret != 0)
+	return -30 + ret;
+    ret = test_app_progress_handler (db_handle);
+    if (ret != 0)
+	return -50 + ret;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+    return 0;
+}
@@ -0,0 +1,411 @@
+/*
+
+ test_section_checksum.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+#define SOURCE_PATH	"map_samples/ascii/ascii1.asc"
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+execute_check (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement not returning any result */
+    char *err_msg = NULL;
+    int ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "%s\nerror: %s\n", sql, err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+copy_file (const char *src, const char *dst)
+{
+/* creating a private copy of the Source file */
+    char buf[8192];
+    size_t rd;
+    int ok = 1;
+    FILE *in = fopen (src, "rb");
+    FILE *out;
+    if (in == NULL)
+	return 0;
+    out = fopen (dst, "wb");
+    if (out == NULL)
+      {
+	  fclose (in);
+	  return 0;
+      }
+    while ((rd = fread (buf, 1, sizeof (buf), in)) > 0)
+      {
+	  if (fwrite (buf, 1, rd, out) != rd)
+	    {
+		ok = 0;
+		break;
+	    }
+      }
+    fclose (in);
+    fclose (out);
+    return ok;
+}
+
+static int
+patch_byte (const char *path, long offset, int *value)
+{
+/* replacing a single byte; the previous value is returned in *value */
+    int old;
+    FILE *fl = fopen (path, "r+b");
+    if (fl == NULL)
+	return 0;
+    if (fseek (fl, offset, SEEK_END) != 0)
+      {
+	  fclose (fl);
+	  return 0;
+      }
+    old = fgetc (fl);
+    if (old == EOF || fseek (fl, offset, SEEK_END) != 0)
+      {
+	  fclose (fl);
+	  return 0;
+      }
+    fputc (*value, fl);
+    fclose (fl);
+    *value = old;
+    return 1;
+}
+
+static int
+check_section (sqlite3 * sqlite, const char *coverage, int section_id,
+	       const char *path)
+{
+/* comparing the stored checksum against the current Source file */
+    char *sql;
+    int ret;
+    if (path == NULL)
+	sql =
+	    sqlite3_mprintf ("SELECT RL2_CheckSectionChecksum(%Q, %d)",
+			     coverage, section_id);
+    else
+	sql =
+	    sqlite3_mprintf ("SELECT RL2_CheckSectionChecksum(%Q, %d, %Q)",
+			     coverage, section_id, path);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    return ret;
+}
+
+static int
+test_checksum (sqlite3 * sqlite, const char *algorithm, int digest_len)
+{
+/* importing a Section, then tampering with its Source file */
+    char *coverage = sqlite3_mprintf ("cksum_%s", algorithm);
+    char *path = sqlite3_mprintf ("./cksum_%s.asc", algorithm);
+    char *sql;
+    int value;
+    int retcode = 0;
+
+    sql = sqlite3_mprintf ("SELECT RL2_SetSectionChecksum(%Q) = %Q",
+			   algorithm, algorithm);
+    if (execute_int (sqlite, sql) != 1)
+      {
+	  fprintf (stderr, "SetSectionChecksum(%s) error\n", algorithm);
+	  retcode = -1;
+	  goto end;
+      }
+    sqlite3_free (sql);
+
+/* creating a Coverage storing both the paths and the checksums */
+    sql = sqlite3_mprintf ("SELECT RL2_CreateRasterCoverage("
+			   "%Q, 'FLOAT', 'DATAGRID', 1, 'NONE', 100, 256, 256, "
+			   "3003, 1.0, 1.0, NULL, 1, 0, 1, 1, 1)", coverage);
+    if (execute_int (sqlite, sql) != 1)
+      {
+	  fprintf (stderr, "CreateRasterCoverage \"%s\" error\n", coverage);
+	  retcode = -2;
+	  goto end;
+      }
+    sqlite3_free (sql);
+    if (!copy_file (SOURCE_PATH, path))
+      {
+	  fprintf (stderr, "unable to copy \"%s\"\n", SOURCE_PATH);
+	  retcode = -3;
+	  sql = NULL;
+	  goto end;
+      }
+    sql = sqlite3_mprintf ("SELECT RL2_LoadRaster(%Q, %Q, 0, 3003, 0)",
+			   coverage, path);
+    if (execute_int (sqlite, sql) != 1)
+      {
+	  fprintf (stderr, "LoadRaster \"%s\" error\n", coverage);
+	  retcode = -4;
+	  goto end;
+      }
+    sqlite3_free (sql);
+    sql = sqlite3_mprintf ("SELECT length(md5_checksum) FROM \"%w_sections\" "
+			   "WHERE section_id = 1", coverage);
+    if (execute_int (sqlite, sql) != digest_len)
+      {
+	  fprintf (stderr, "%s: unexpected checksum length\n", algorithm);
+	  retcode = -5;
+	  goto end;
+      }
+    sqlite3_free (sql);
+    sql = NULL;
+
+/* the untouched file (and any identical copy) must match */
+    if (check_section (sqlite, coverage, 1, NULL) != 1)
+      {
+	  fprintf (stderr, "%s: untouched file mismatch\n", algorithm);
+	  retcode = -6;
+	  goto end;
+      }
+    if (check_section (sqlite, coverage, 1, SOURCE_PATH) != 1)
+      {
+	  fprintf (stderr, "%s: identical copy mismatch\n", algorithm);
+	  retcode = -7;
+	  goto end;
+      }
+
+/* tampering with a single digit of the last grid row */
+    value = '0';
+    if (!patch_byte (path, -8, &value))
+      {
+	  retcode = -8;
+	  goto end;
+      }
+    if (value == '0')
+      {
+	  /* the original digit already was a zero */
+	  value = '1';
+	  if (!patch_byte (path, -8, &value))
+	    {
+		retcode = -9;
+		goto end;
+	    }
+	  value = '0';
+      }
+    if (check_section (sqlite, coverage, 1, NULL) != 0)
+      {
+	  fprintf (stderr, "%s: tampered file not detected\n", algorithm);
+	  retcode = -10;
+	  goto end;
+      }
+
+/* restoring the original byte */
+    if (!patch_byte (path, -8, &value))
+      {
+	  retcode = -11;
+	  goto end;
+      }
+    if (check_section (sqlite, coverage, 1, NULL) != 1)
+      {
+	  fprintf (stderr, "%s: restored file mismatch\n", algorithm);
+	  retcode = -12;
+	  goto end;
+      }
+
+/* a vanished Source file or an unknown Section */
+    unlink (path);
+    if (check_section (sqlite, coverage, 1, NULL) != 0)
+      {
+	  fprintf (stderr, "%s: missing file not detected\n", algorithm);
+	  retcode = -13;
+	  goto end;
+      }
+    if (check_section (sqlite, coverage, 99, NULL) != -1)
+      {
+	  fprintf (stderr, "%s: unexpected result for a missing Section\n",
+		   algorithm);
+	  retcode = -14;
+	  goto end;
+      }
+
+/* the unprefixed alias */
+    sql = sqlite3_mprintf ("SELECT CheckSectionChecksum(%Q, 1, %Q)",
+			   coverage, SOURCE_PATH);
+    if (execute_int (sqlite, sql) != 1)
+      {
+	  fprintf (stderr, "%s: CheckSectionChecksum error\n", algorithm);
+	  retcode = -15;
+	  goto end;
+      }
+    sqlite3_free (sql);
+
+/* a stored checksum of unknown length can't be checked */
+    sql = sqlite3_mprintf ("UPDATE \"%w_sections\" SET md5_checksum = "
+			   "'0123456789' WHERE section_id = 1", coverage);
+    if (!execute_check (sqlite, sql))
+      {
+	  retcode = -16;
+	  goto end;
+      }
+    sqlite3_free (sql);
+    sql = NULL;
+    if (check_section (sqlite, coverage, 1, SOURCE_PATH) != -1)
+      {
+	  fprintf (stderr, "%s: unknown digest not rejected\n", algorithm);
+	  retcode = -17;
+	  goto end;
+      }
+
+  end:
+    if (sql != NULL)
+	sqlite3_free (sql);
+    unlink (path);
+    sqlite3_free (coverage);
+    sqlite3_free (path);
+    return retcode;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+    char *old_SPATIALITE_SECURITY_ENV = NULL;
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+    old_SPATIALITE_SECURITY_ENV = getenv ("SPATIALITE_SECURITY");
+#ifdef _WIN32
+    putenv ("SPATIALITE_SECURITY=relaxed");
+#else /* not WIN32 */
+    setenv ("SPATIALITE_SECURITY", "relaxed", 1);
+#endif
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+
+/* testing the SQL functions */
+    if (execute_int (db_handle, "SELECT RL2_SetSectionChecksum('SHA1') IS NULL")
+	!= 1)
+	return -3;
+    if (execute_int (db_handle, "SELECT RL2_CheckSectionChecksum(1, 1)") != -1)
+	return -4;
+    if (execute_int (db_handle, "SELECT CheckSectionChecksum(1, 1)") != -1)
+	return -5;
+
+    ret = test_checksum (db_handle, "md5", 32);
+    if (ret != 0)
+	return -10 + ret;
+    ret = test_checksum (db_handle, "xxh64", 16);
+    if (ret != 0)
+	return -30 + ret;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+
+    if (old_SPATIALITE_SECURITY_ENV)
+      {
+#ifdef _WIN32
+	  char *env = sqlite3_mprintf ("SPATIALITE_SECURITY=%s",
+				       old_SPATIALITE_SECURITY_ENV);
+	  putenv (env);
+	  sqlite3_free (env);
+#else /* not WIN32 */
+	  setenv ("SPATIALITE_SECURITY", old_SPATIALITE_SECURITY_ENV, 1);
+#endif
+      }
+    else
+      {
+#ifdef _WIN32
+	  putenv ("SPATIALITE_SECURITY=");
+#else /* not WIN32 */
+	  unsetenv ("SPATIALITE_SECURITY");
+#endif
+      }
+    return 0;
+}
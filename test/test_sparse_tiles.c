@@ -0,0 +1,385 @@
+/*
+
+ test_sparse_tiles.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+#define SPARSE_WIDTH	768
+#define SPARSE_HEIGHT	512
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static unsigned char *
+build_pixels (void)
+{
+/* 
+/ building a 3x2 tiles Grayscale image:
+/ - first column: gradients (ordinary tiles)
+/ - second column: a single value (Uniform tiles)
+/ - third column: NO-DATA (empty tiles)
+*/
+    int row;
+    int col;
+    unsigned char *pixels = malloc (SPARSE_WIDTH * SPARSE_HEIGHT);
+    unsigned char *p = pixels;
+    for (row = 0; row < SPARSE_HEIGHT; row++)
+      {
+	  for (col = 0; col < SPARSE_WIDTH; col++)
+	    {
+		if (col < 256)
+		    *p++ = 1 + ((row + col) % 250);
+		else if (col < 512)
+		    *p++ = (row < 256) ? 128 : 200;
+		else
+		    *p++ = 0;
+	    }
+      }
+    return pixels;
+}
+
+static int
+create_coverage (sqlite3 * sqlite, const char *coverage)
+{
+/* creating a Grayscale Coverage (NO-DATA = 0) */
+    char *sql;
+    int ret;
+
+    sql = sqlite3_mprintf ("SELECT RL2_CreateRasterCoverage("
+			   "%Q, 'UINT8', 'GRAYSCALE', 1, 'PNG', 100, 256, 256, "
+			   "4326, 0.01, 0.01, RL2_SetPixelValue("
+			   "RL2_CreatePixel('UINT8', 'GRAYSCALE', 1), 0, 0))",
+			   coverage);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+      {
+	  fprintf (stderr, "CreateRasterCoverage \"%s\" error\n", coverage);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+import_pixels (sqlite3 * sqlite, const char *coverage,
+	       const unsigned char *pixels)
+{
+/* importing the test image as a Section */
+    char *sql;
+    sqlite3_stmt *stmt;
+    int ret;
+    int ok = 0;
+
+    sql = sqlite3_mprintf ("SELECT RL2_ImportSectionRawPixels("
+			   "%Q, 'sparse', %d, %d, ?, "
+			   "BuildMbr(0, 0, %1.2f, %1.2f, 4326), 1, 1)",
+			   coverage, SPARSE_WIDTH, SPARSE_HEIGHT,
+			   SPARSE_WIDTH / 100.0, SPARSE_HEIGHT / 100.0);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    sqlite3_bind_blob (stmt, 1, pixels, SPARSE_WIDTH * SPARSE_HEIGHT,
+		       SQLITE_STATIC);
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW)
+	ok = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    if (ok != 1)
+	fprintf (stderr, "ImportSectionRawPixels \"%s\" error\n", coverage);
+    return ok;
+}
+
+static unsigned char *
+export_pixels (sqlite3 * sqlite, const char *coverage, double resolution,
+	       int *size)
+{
+/* exporting the whole Coverage as RAW pixels */
+    char *sql;
+    sqlite3_stmt *stmt;
+    int ret;
+    unsigned char *pixels = NULL;
+    int width = (int) (SPARSE_WIDTH * 0.01 / resolution);
+    int height = (int) (SPARSE_HEIGHT * 0.01 / resolution);
+
+    *size = 0;
+    sql = sqlite3_mprintf ("SELECT RL2_ExportRawPixels(NULL, %Q, %d, %d, "
+			   "BuildMbr(0, 0, %1.2f, %1.2f, 4326), %1.2f)",
+			   coverage, width, height, SPARSE_WIDTH / 100.0,
+			   SPARSE_HEIGHT / 100.0, resolution);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return NULL;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+      {
+	  const unsigned char *blob = sqlite3_column_blob (stmt, 0);
+	  int blob_sz = sqlite3_column_bytes (stmt, 0);
+	  pixels = malloc (blob_sz);
+	  memcpy (pixels, blob, blob_sz);
+	  *size = blob_sz;
+      }
+    sqlite3_finalize (stmt);
+    if (pixels == NULL)
+	fprintf (stderr, "ExportRawPixels \"%s\" error\n", coverage);
+    return pixels;
+}
+
+static int
+count_tiles (sqlite3 * sqlite, const char *coverage, int max_size)
+{
+/* counting the base level tiles (optionally: only the tiny ones) */
+    char *sql;
+    char *table;
+    char *xtable;
+    int count;
+
+    table = sqlite3_mprintf ("%s_tile_data", coverage);
+    xtable = sqlite3_mprintf ("\"%w\"", table);
+    sqlite3_free (table);
+    if (max_size > 0)
+	sql = sqlite3_mprintf ("SELECT Count(*) FROM %s AS d "
+			       "JOIN \"%w_tiles\" AS t ON (t.tile_id = d.tile_id) "
+			       "WHERE t.pyramid_level = 0 "
+			       "AND length(d.tile_data_odd) <= %d", xtable,
+			       coverage, max_size);
+    else
+	sql = sqlite3_mprintf ("SELECT Count(*) FROM %s AS d "
+			       "JOIN \"%w_tiles\" AS t ON (t.tile_id = d.tile_id) "
+			       "WHERE t.pyramid_level = 0", xtable, coverage);
+    sqlite3_free (xtable);
+    count = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    return count;
+}
+
+static int
+test_sparse (sqlite3 * sqlite, const unsigned char *pixels)
+{
+/* comparing a Sparse and an ordinary Coverage */
+    unsigned char *sparse = NULL;
+    unsigned char *dense = NULL;
+    int sparse_sz;
+    int dense_sz;
+    int retcode = 0;
+
+/* base level tiles */
+    if (count_tiles (sqlite, "dense_gray", 0) != 6)
+      {
+	  fprintf (stderr, "Dense: unexpected number of tiles\n");
+	  goto end;
+      }
+    if (count_tiles (sqlite, "dense_gray", 48) != 0)
+      {
+	  fprintf (stderr, "Dense: unexpected Uniform tiles\n");
+	  goto end;
+      }
+    if (count_tiles (sqlite, "sparse_gray", 0) != 4)
+      {
+	  fprintf (stderr, "Sparse: NO-DATA tiles have been stored\n");
+	  goto end;
+      }
+    if (count_tiles (sqlite, "sparse_gray", 48) != 2)
+      {
+	  fprintf (stderr, "Sparse: Uniform tiles have not been detected\n");
+	  goto end;
+      }
+
+/* full resolution: both must return exactly the original pixels */
+    sparse = export_pixels (sqlite, "sparse_gray", 0.01, &sparse_sz);
+    dense = export_pixels (sqlite, "dense_gray", 0.01, &dense_sz);
+    if (sparse == NULL || dense == NULL)
+	goto end;
+    if (dense_sz != SPARSE_WIDTH * SPARSE_HEIGHT
+	|| memcmp (dense, pixels, dense_sz) != 0)
+      {
+	  fprintf (stderr, "Dense: mismatching pixels\n");
+	  goto end;
+      }
+    if (sparse_sz != dense_sz || memcmp (sparse, pixels, sparse_sz) != 0)
+      {
+	  fprintf (stderr, "Sparse: mismatching pixels\n");
+	  goto end;
+      }
+    free (sparse);
+    free (dense);
+
+/* reduced resolution (Pyramid levels) */
+    sparse = export_pixels (sqlite, "sparse_gray", 0.02, &sparse_sz);
+    dense = export_pixels (sqlite, "dense_gray", 0.02, &dense_sz);
+    if (sparse == NULL || dense == NULL)
+	goto end;
+    if (sparse_sz != dense_sz || memcmp (sparse, dense, sparse_sz) != 0)
+      {
+	  fprintf (stderr, "Sparse: mismatching Pyramid pixels\n");
+	  goto end;
+      }
+    retcode = 1;
+
+  end:
+    if (sparse != NULL)
+	free (sparse);
+    if (dense != NULL)
+	free (dense);
+    return retcode;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+    char *old_SPATIALITE_SECURITY_ENV = NULL;
+    unsigned char *pixels;
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+    old_SPATIALITE_SECURITY_ENV = getenv ("SPATIALITE_SECURITY");
+#ifdef _WIN32
+    putenv ("SPATIALITE_SECURITY=relaxed");
+#else /* not WIN32 */
+    setenv ("SPATIALITE_SECURITY", "relaxed", 1);
+#endif
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+
+/* testing the SQL functions */
+    if (execute_int (db_handle, "SELECT RL2_GetSparseTiles()") != 0)
+	return -3;
+    if (execute_int (db_handle, "SELECT RL2_SetSparseTiles(NULL)") != -1)
+	return -4;
+
+/* loading the same pixels into a Sparse and an ordinary Coverage */
+    pixels = build_pixels ();
+    if (!create_coverage (db_handle, "sparse_gray"))
+	return -5;
+    if (!create_coverage (db_handle, "dense_gray"))
+	return -6;
+    if (execute_int (db_handle, "SELECT RL2_SetSparseTiles(1)") != 1)
+	return -7;
+    if (!import_pixels (db_handle, "sparse_gray", pixels))
+	return -8;
+    if (execute_int (db_handle, "SELECT RL2_SetSparseTiles(0)") != 0)
+	return -9;
+    if (!import_pixels (db_handle, "dense_gray", pixels))
+	return -10;
+
+    ret = test_sparse (db_handle, pixels);
+    free (pixels);
+    if (!ret)
+	return -11;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+
+    if (old_SPATIALITE_SECURITY_ENV)
+      {
+#ifdef _WIN32
+	  char *env = sqlite3_mprintf ("SPATIALITE_SECURITY=%s",
+				       old_SPATIALITE_SECURITY_ENV);
+	  putenv (env);
+	  sqlite3_free (env);
+#else /* not WIN32 */
+	  setenv ("SPATIALITE_SECURITY", old_SPATIALITE_SECURITY_ENV, 1);
+#endif
+      }
+    else
+      {
+#ifdef _WIN32
+	  putenv ("SPATIALITE_SECURITY=");
+#else /* not WIN32 */
+	  unsetenv ("SPATIALITE_SECURITY");
+#endif
+      }
+    return 0;
+}
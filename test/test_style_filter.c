@@ -0,0 +1,431 @@
+/*
+
+ test_style_filter.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+#define VISIBLE_SCALE	500.0
+#define HIDDEN_SCALE	5000.0
+#define MAX_FEATURES	64
+
+/* a mix of every storage class, including numeric-looking text */
+static const char *feature_values[] = {
+    "5", "10", "-3", "0", "5.0", "5.5", "10.25", "1e300", "'5'", "'10'",
+    "'5.0'", "'abc'", "'b'", "'A'", "''", "NULL", "x'05'", NULL
+};
+
+static char *
+build_style (const char *filter, const char *second_rule, int with_else)
+{
+/* building an SLD/SE style; the first Rule is visible up to 1:1000 */
+    const char *symbolizer = "<LineSymbolizer><Stroke>"
+	"<SvgParameter name=\"stroke\">#ff0000</SvgParameter>"
+	"</Stroke></LineSymbolizer>";
+    char *rule2;
+    char *rule_else;
+    char *xml;
+    if (second_rule != NULL)
+	rule2 = sqlite3_mprintf ("<Rule><ogc:Filter>%s</ogc:Filter>"
+				 "<MinScaleDenominator>2000</MinScaleDenominator>"
+				 "%s</Rule>", second_rule, symbolizer);
+    else
+	rule2 = sqlite3_mprintf ("");
+    if (with_else)
+	rule_else = sqlite3_mprintf ("<Rule><ElseFilter/>"
+				     "<MaxScaleDenominator>1000</MaxScaleDenominator>"
+				     "%s</Rule>", symbolizer);
+    else
+	rule_else = sqlite3_mprintf ("");
+    xml = sqlite3_mprintf ("<FeatureTypeStyle "
+			   "xmlns=\"http://www.opengis.net/se\" "
+			   "xmlns:ogc=\"http://www.opengis.net/ogc\" "
+			   "version=\"1.1.0\"><Name>filter</Name>"
+			   "<Rule>%s%s%s"
+			   "<MaxScaleDenominator>1000</MaxScaleDenominator>"
+			   "%s</Rule>%s%s</FeatureTypeStyle>",
+			   (filter == NULL) ? "" : "<ogc:Filter>",
+			   (filter == NULL) ? "" : filter,
+			   (filter == NULL) ? "" : "</ogc:Filter>", symbolizer,
+			   rule2, rule_else);
+    sqlite3_free (rule2);
+    sqlite3_free (rule_else);
+    return xml;
+}
+
+static char *
+single_filter (const char *op, const char *literal)
+{
+/* a comparison between the "val" column and a Literal */
+    return sqlite3_mprintf ("<ogc:%s><ogc:PropertyName>val</ogc:PropertyName>"
+			    "<ogc:Literal>%s</ogc:Literal></ogc:%s>", op,
+			    literal, op);
+}
+
+static char *
+between_filter (const char *lower, const char *upper)
+{
+/* a Between comparison on the "val" column */
+    return sqlite3_mprintf ("<ogc:PropertyIsBetween>"
+			    "<ogc:PropertyName>val</ogc:PropertyName>"
+			    "<ogc:LowerBoundary><ogc:Literal>%s</ogc:Literal>"
+			    "</ogc:LowerBoundary><ogc:UpperBoundary>"
+			    "<ogc:Literal>%s</ogc:Literal></ogc:UpperBoundary>"
+			    "</ogc:PropertyIsBetween>", lower, upper);
+}
+
+static int
+is_drawn (rl2FeatureTypeStylePtr style, double scale, sqlite3_stmt * stmt)
+{
+/* evaluating the Style Rules against the current row */
+    int scale_forbidden;
+    rl2VariantArrayPtr variant = rl2_create_variant_array (1);
+    switch (sqlite3_column_type (stmt, 1))
+      {
+      case SQLITE_INTEGER:
+	  rl2_set_variant_int (variant, 0, "val",
+			       sqlite3_column_int64 (stmt, 1));
+	  break;
+      case SQLITE_FLOAT:
+	  rl2_set_variant_double (variant, 0, "val",
+				  sqlite3_column_double (stmt, 1));
+	  break;
+      case SQLITE_TEXT:
+	  rl2_set_variant_text (variant, 0, "val",
+				(const char *) sqlite3_column_text (stmt, 1),
+				sqlite3_column_bytes (stmt, 1));
+	  break;
+      case SQLITE_BLOB:
+	  rl2_set_variant_blob (variant, 0, "val",
+				sqlite3_column_blob (stmt, 1),
+				sqlite3_column_bytes (stmt, 1));
+	  break;
+      default:
+	  rl2_set_variant_null (variant, 0, "val");
+	  break;
+      };
+    rl2_get_symbolizer_from_feature_type_style (style, scale, variant,
+						&scale_forbidden);
+    rl2_destroy_variant_array (variant);
+    return !scale_forbidden;
+}
+
+static int
+compare_filter (sqlite3 * sqlite, rl2FeatureTypeStylePtr style, double scale,
+		int exact, const char *title)
+{
+/* 
+/ comparing the Features selected by the compiled SQL Filter
+/ against the ones drawn by evaluating the Style Rules
+*/
+    char *filter;
+    char *sql;
+    sqlite3_stmt *stmt;
+    int selected[MAX_FEATURES];
+    int ret;
+    int retcode = 1;
+
+    memset (selected, 0, sizeof (selected));
+    filter = rl2_build_feature_type_style_sql_filter (style, scale);
+    sql = sqlite3_mprintf ("SELECT id FROM feat WHERE %s",
+			   (filter == NULL) ? "1" : filter);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "%s: invalid SQL Filter \"%s\": %s\n", title,
+		   filter, sqlite3_errmsg (sqlite));
+	  if (filter != NULL)
+	      sqlite3_free (filter);
+	  return 0;
+      }
+    while (sqlite3_step (stmt) == SQLITE_ROW)
+	selected[sqlite3_column_int (stmt, 0)] = 1;
+    sqlite3_finalize (stmt);
+
+    sql = "SELECT id, val FROM feat ORDER BY id";
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  if (filter != NULL)
+	      sqlite3_free (filter);
+	  return 0;
+      }
+    while (sqlite3_step (stmt) == SQLITE_ROW)
+      {
+	  int id = sqlite3_column_int (stmt, 0);
+	  int drawn = is_drawn (style, scale, stmt);
+	  if (drawn && !selected[id])
+	    {
+		fprintf (stderr, "%s @%1.0f: Feature #%d (%s) dropped by \"%s\"\n",
+			 title, scale, id, sqlite3_column_text (stmt, 1),
+			 filter);
+		retcode = 0;
+	    }
+	  if (exact && !drawn && selected[id])
+	    {
+		fprintf (stderr,
+			 "%s @%1.0f: Feature #%d (%s) wrongly selected by \"%s\"\n",
+			 title, scale, id, sqlite3_column_text (stmt, 1),
+			 filter);
+		retcode = 0;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    if (filter != NULL)
+	sqlite3_free (filter);
+    return retcode;
+}
+
+static int
+test_style (sqlite3 * sqlite, char *filter, const char *second_rule,
+	    int with_else, int exact, const char *title)
+{
+/* testing a Style both at a visible and at a hidden scale */
+    int ok = 1;
+    char *xml = build_style (filter, second_rule, with_else);
+    rl2FeatureTypeStylePtr style =
+	rl2_feature_type_style_from_xml ("filter", (unsigned char *) xml);
+    sqlite3_free (xml);
+    if (filter != NULL)
+	sqlite3_free (filter);
+    if (style == NULL)
+      {
+	  fprintf (stderr, "%s: unable to parse the Style\n", title);
+	  return 0;
+      }
+    if (!compare_filter (sqlite, style, VISIBLE_SCALE, exact, title))
+	ok = 0;
+    if (!compare_filter (sqlite, style, HIDDEN_SCALE, exact, title))
+	ok = 0;
+    rl2_destroy_feature_type_style (style);
+    return ok;
+}
+
+static int
+test_fallback (sqlite3 * sqlite, char *filter, int with_else,
+	       const char *title)
+{
+/* a Style that can't be compiled at all must not filter anything */
+    int ok = 1;
+    char *sql;
+    char *xml = build_style (filter, NULL, with_else);
+    rl2FeatureTypeStylePtr style =
+	rl2_feature_type_style_from_xml ("filter", (unsigned char *) xml);
+    sqlite3_free (xml);
+    if (filter != NULL)
+	sqlite3_free (filter);
+    if (style == NULL)
+      {
+	  fprintf (stderr, "%s: unable to parse the Style\n", title);
+	  return 0;
+      }
+    sql = rl2_build_feature_type_style_sql_filter (style, VISIBLE_SCALE);
+    if (sql != NULL)
+      {
+	  fprintf (stderr, "%s: unexpected SQL Filter \"%s\"\n", title, sql);
+	  sqlite3_free (sql);
+	  ok = 0;
+      }
+    if (!compare_filter (sqlite, style, VISIBLE_SCALE, 1, title))
+	ok = 0;
+    if (!compare_filter (sqlite, style, HIDDEN_SCALE, 0, title))
+	ok = 0;
+    rl2_destroy_feature_type_style (style);
+    return ok;
+}
+
+static int
+test_filters (sqlite3 * sqlite)
+{
+/* testing all the comparison operators */
+    const char *ops[] = {
+	"PropertyIsEqualTo", "PropertyIsNotEqualTo", "PropertyIsLessThan",
+	"PropertyIsGreaterThan", "PropertyIsLessThanOrEqualTo",
+	"PropertyIsGreaterThanOrEqualTo", NULL
+    };
+    const char *literals[] = { "5", "5.5", "-3", "10", "b", "5.0", NULL };
+    const char **op;
+    const char **lit;
+    char title[128];
+    char huge[401];
+    int retcode = 0;
+
+    for (op = ops; *op != NULL; op++)
+      {
+	  for (lit = literals; *lit != NULL; lit++)
+	    {
+		sprintf (title, "%s '%s'", *op, *lit);
+		if (!test_style
+		    (sqlite, single_filter (*op, *lit), NULL, 0, 1, title))
+		    retcode = -1;
+	    }
+      }
+    if (!test_style
+	(sqlite, between_filter ("0", "10"), NULL, 0, 1, "Between 0 10"))
+	retcode = -2;
+    if (!test_style
+	(sqlite, between_filter ("-3.5", "5.5"), NULL, 0, 1,
+	 "Between -3.5 5.5"))
+	retcode = -3;
+    if (!test_style
+	(sqlite, between_filter ("a", "c"), NULL, 0, 1, "Between a c"))
+	retcode = -4;
+    if (!test_style
+	(sqlite,
+	 sqlite3_mprintf ("<ogc:PropertyIsNull><ogc:PropertyName>val"
+			  "</ogc:PropertyName></ogc:PropertyIsNull>"), NULL,
+	 0, 1, "IsNull"))
+	retcode = -5;
+
+/* 
+/ mixing a visible and a hidden Rule; a visible Else Rule disables
+/ the pushdown, so only a superset can be expected in that case
+*/
+    if (!test_style
+	(sqlite, single_filter ("PropertyIsEqualTo", "5"),
+	 "<ogc:PropertyIsGreaterThan><ogc:PropertyName>val</ogc:PropertyName>"
+	 "<ogc:Literal>0</ogc:Literal></ogc:PropertyIsGreaterThan>", 0, 1,
+	 "EqualTo 5 + GreaterThan 0"))
+	retcode = -6;
+    if (!test_style
+	(sqlite, single_filter ("PropertyIsLessThan", "b"),
+	 "<ogc:PropertyIsNull><ogc:PropertyName>val</ogc:PropertyName>"
+	 "</ogc:PropertyIsNull>", 1, 0, "LessThan b + IsNull + Else"))
+	retcode = -7;
+
+/* Like is never translated: a superset is selected instead */
+    if (!test_style
+	(sqlite,
+	 sqlite3_mprintf ("<ogc:PropertyIsLike wildCard=\"*\" "
+			  "singleChar=\".\" escapeChar=\"!\">"
+			  "<ogc:PropertyName>val</ogc:PropertyName>"
+			  "<ogc:Literal>a*</ogc:Literal></ogc:PropertyIsLike>"),
+	 NULL, 0, 0, "Like a*"))
+	retcode = -8;
+
+/* not compilable: no Filter at all, an infinite Literal, a visible Else */
+    if (!test_fallback (sqlite, NULL, 0, "no Filter"))
+	retcode = -9;
+    memset (huge, '9', sizeof (huge) - 1);
+    huge[sizeof (huge) - 1] = '\0';
+    if (!test_fallback
+	(sqlite, single_filter ("PropertyIsLessThan", huge), 0,
+	 "LessThan 9e400"))
+	retcode = -10;
+    if (!test_fallback
+	(sqlite, single_filter ("PropertyIsEqualTo", "5"), 1,
+	 "EqualTo 5 + Else"))
+	retcode = -11;
+    return retcode;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    int id;
+    char *sql;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+
+/* an untyped column: every value keeps its own storage class */
+    ret =
+	sqlite3_exec (db_handle,
+		      "CREATE TABLE feat (id INTEGER PRIMARY KEY, val)", NULL,
+		      NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CREATE TABLE error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+    for (id = 0; feature_values[id] != NULL; id++)
+      {
+	  sql = sqlite3_mprintf ("INSERT INTO feat (id, val) VALUES (%d, %s)",
+				 id + 1, feature_values[id]);
+	  ret = sqlite3_exec (db_handle, sql, NULL, NULL, &err_msg);
+	  sqlite3_free (sql);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "INSERT error: %s\n", err_msg);
+		sqlite3_free (err_msg);
+		return -3;
+	    }
+      }
+
+    ret = test_filters (db_handle);
+    if (ret != 0)
+	return -10 + ret;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+    return 0;
+}
@@ -0,0 +1,494 @@
+/*
+
+ test_text_cache.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+#include "rasterlite2/rl2graphics.h"
+
+#define CANVAS_WIDTH	320
+#define CANVAS_HEIGHT	80
+
+#define MAP_FRAME	"BuildMbr(1500000, 4800000, 1600000, 4875000, 3003)"
+
+/* rotated Labels with a Halo */
+static const char *halo_style =
+    "<TextSymbolizer><Label>@name@</Label><Font>"
+    "<SvgParameter name=\"font-family\">sans serif</SvgParameter>"
+    "<SvgParameter name=\"font-weight\">bold</SvgParameter>"
+    "<SvgParameter name=\"font-size\">14.00</SvgParameter></Font>"
+    "<LabelPlacement><PointPlacement><Rotation>30.0</Rotation>"
+    "</PointPlacement></LabelPlacement><Halo><Radius>1.5</Radius><Fill>"
+    "<SvgParameter name=\"fill\">#ffffff</SvgParameter></Fill></Halo>"
+    "<Fill><SvgParameter name=\"fill\">#204080</SvgParameter></Fill>"
+    "</TextSymbolizer>";
+
+/* plain Labels */
+static const char *plain_style =
+    "<TextSymbolizer><Label>@name@</Label><Font>"
+    "<SvgParameter name=\"font-family\">serif</SvgParameter>"
+    "<SvgParameter name=\"font-style\">italic</SvgParameter>"
+    "<SvgParameter name=\"font-size\">10.00</SvgParameter></Font>"
+    "<Fill><SvgParameter name=\"fill\">#000000</SvgParameter></Fill>"
+    "</TextSymbolizer>";
+
+struct text_cache_stats
+{
+    int runs;
+    int hits;
+    int misses;
+};
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+execute_sql (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning nothing */
+    char *err_msg = NULL;
+    int ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+create_coverage (sqlite3 * sqlite, const char *table, int count)
+{
+/* creating and populating a Vector Coverage of labelled Points */
+    char *sql;
+    int ret;
+
+    sql =
+	sqlite3_mprintf ("CREATE TABLE %s (id INTEGER PRIMARY KEY, name TEXT)",
+			 table);
+    ret = execute_sql (sqlite, sql);
+    sqlite3_free (sql);
+    if (!ret)
+	return 0;
+    sql =
+	sqlite3_mprintf
+	("SELECT AddGeometryColumn(%Q, 'geom', 3003, 'POINT', 'XY')", table);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+	return 0;
+    sql = sqlite3_mprintf ("SELECT CreateSpatialIndex(%Q, 'geom')", table);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+	return 0;
+
+/* each Point has its own Label; a few of them are not plain ASCII */
+    sql =
+	sqlite3_mprintf
+	("WITH RECURSIVE seq(i) AS (SELECT 0 UNION ALL SELECT i + 1 FROM seq "
+	 "WHERE i < %d) INSERT INTO %s (id, name, geom) SELECT i + 1, "
+	 "CASE WHEN i %% 10 = 0 THEN printf('Città #%%d', i) "
+	 "ELSE printf('Label #%%d', i) END, "
+	 "MakePoint(1500000 + (i %% 100) * 1000 + 500, "
+	 "4800000 + (i / 100) * 1000 + 500, 3003) FROM seq", count - 1,
+	 table);
+    ret = execute_sql (sqlite, sql);
+    sqlite3_free (sql);
+    if (!ret)
+	return 0;
+
+    sql =
+	sqlite3_mprintf ("SELECT SE_RegisterVectorCoverage(%Q, %Q, 'geom')",
+			 table, table);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+	return 0;
+    return 1;
+}
+
+static int
+json_int (const char *json, const char *key)
+{
+/* extracting some Integer value from a JSON string */
+    char *pattern = sqlite3_mprintf ("\"%s\": ", key);
+    const char *p = strstr (json, pattern);
+    int value = -1;
+    if (p != NULL)
+	value = atoi (p + strlen (pattern));
+    sqlite3_free (pattern);
+    return value;
+}
+
+static int
+get_text_cache_stats (sqlite3 * sqlite, struct text_cache_stats *stats)
+{
+/* retrieving the Text Cache statistics from the Performance Counters */
+    sqlite3_stmt *stmt;
+    int ret;
+    int ok = 0;
+    const char *sql = "SELECT RL2_GetPerfCounters()";
+
+    stats->runs = -1;
+    stats->hits = -1;
+    stats->misses = -1;
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return 0;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_TEXT)
+      {
+	  const char *json = (const char *) sqlite3_column_text (stmt, 0);
+	  const char *p = strstr (json, "\"text_cache\": {");
+	  if (p != NULL)
+	    {
+		stats->runs = json_int (p, "runs");
+		stats->hits = json_int (p, "hits");
+		stats->misses = json_int (p, "misses");
+		ok = 1;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    return ok;
+}
+
+static unsigned char *
+render_map (sqlite3 * sqlite, const char *coverage, const char *symbolizer,
+	    struct text_cache_stats *stats, int *blob_sz)
+{
+/* painting all Labels, then retrieving the Text Cache statistics */
+    char *sql;
+    sqlite3_stmt *stmt;
+    unsigned char *blob = NULL;
+    int ret;
+
+    *blob_sz = 0;
+    if (execute_int (sqlite, "SELECT RL2_ResetPerfCounters()") != 1)
+	return NULL;
+    sql =
+	sqlite3_mprintf
+	("SELECT RL2_GetStyledMapImageFromVector(NULL, %Q, " MAP_FRAME
+	 ", 1024, 768, '<FeatureTypeStyle xmlns=\"http://www.opengis.net/se\" "
+	 "version=\"1.1.0\"><Name>labels</Name><Rule>%q</Rule>"
+	 "</FeatureTypeStyle>', 'image/png', '#ffffff', 0)", coverage,
+	 symbolizer);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "GetStyledMapImageFromVector SQL error: %s\n",
+		   sqlite3_errmsg (sqlite));
+	  return NULL;
+      }
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+      {
+	  *blob_sz = sqlite3_column_bytes (stmt, 0);
+	  blob = malloc (*blob_sz);
+	  memcpy (blob, sqlite3_column_blob (stmt, 0), *blob_sz);
+      }
+    sqlite3_finalize (stmt);
+    if (blob != NULL && !get_text_cache_stats (sqlite, stats))
+      {
+	  free (blob);
+	  blob = NULL;
+      }
+    return blob;
+}
+
+static int
+same_image (const unsigned char *blob1, int blob1_sz,
+	    const unsigned char *blob2, int blob2_sz)
+{
+/* checking if two images are identical */
+    if (blob1 == NULL || blob2 == NULL)
+	return 0;
+    if (blob1_sz != blob2_sz)
+	return 0;
+    if (memcmp (blob1, blob2, blob1_sz) != 0)
+	return 0;
+    return 1;
+}
+
+static int
+test_labels (sqlite3 * sqlite, const char *symbolizer)
+{
+/* painting the same Labels twice: the second time is all cache hits */
+    unsigned char *miss;
+    unsigned char *hit = NULL;
+    int miss_sz;
+    int hit_sz;
+    struct text_cache_stats stats;
+    int retcode = 0;
+
+    miss = render_map (sqlite, "places", symbolizer, &stats, &miss_sz);
+    if (miss == NULL)
+	return -1;
+    if (stats.misses <= 0 || stats.runs <= 0)
+      {
+	  fprintf (stderr, "expected Text Cache misses (%d runs, %d misses)\n",
+		   stats.runs, stats.misses);
+	  retcode = -2;
+	  goto end;
+      }
+
+    hit = render_map (sqlite, "places", symbolizer, &stats, &hit_sz);
+    if (hit == NULL)
+      {
+	  retcode = -3;
+	  goto end;
+      }
+    if (stats.misses != 0 || stats.hits <= 0)
+      {
+	  fprintf (stderr, "expected Text Cache hits (%d hits, %d misses)\n",
+		   stats.hits, stats.misses);
+	  retcode = -4;
+	  goto end;
+      }
+    if (!same_image (miss, miss_sz, hit, hit_sz))
+      {
+	  fprintf (stderr, "cache hits painted differently\n");
+	  retcode = -5;
+	  goto end;
+      }
+
+  end:
+    free (miss);
+    if (hit != NULL)
+	free (hit);
+    return retcode;
+}
+
+static int
+test_eviction (sqlite3 * sqlite)
+{
+/* the Text Cache never grows beyond its limit */
+    unsigned char *first;
+    unsigned char *second = NULL;
+    int first_sz;
+    int second_sz;
+    struct text_cache_stats stats;
+    int retcode = 0;
+
+    first = render_map (sqlite, "crowded", plain_style, &stats, &first_sz);
+    if (first == NULL)
+	return -1;
+    if (stats.misses < 5000)
+      {
+	  fprintf (stderr, "Unexpected Text Cache misses: %d\n", stats.misses);
+	  retcode = -2;
+	  goto end;
+      }
+    if (stats.runs <= 0 || stats.runs >= 5000)
+      {
+	  fprintf (stderr, "Unexpected Text Cache size: %d\n", stats.runs);
+	  retcode = -3;
+	  goto end;
+      }
+
+/* evicted Labels are shaped again, and painted the same */
+    second = render_map (sqlite, "crowded", plain_style, &stats, &second_sz);
+    if (!same_image (first, first_sz, second, second_sz))
+      {
+	  fprintf (stderr, "Labels painted differently after eviction\n");
+	  retcode = -4;
+	  goto end;
+      }
+
+  end:
+    free (first);
+    if (second != NULL)
+	free (second);
+    return retcode;
+}
+
+
+static int
+test_extent (const void *priv_data)
+{
+/* a cached Label must measure the same as an uncached one */
+    rl2GraphicsContextPtr ctx;
+    rl2GraphicsFontPtr font;
+    double pre_x1, pre_y1, width1, height1, post_x1, post_y1;
+    double pre_x2, pre_y2, width2, height2, post_x2, post_y2;
+    unsigned char *rgba;
+    int ret = 0;
+
+/* the first measure is a cache miss, all the others are cache hits */
+    ctx = rl2_graph_create_context (priv_data, CANVAS_WIDTH, CANVAS_HEIGHT);
+    if (ctx == NULL)
+	return -1;
+    font =
+	rl2_graph_create_toy_font ("serif", 16.0, RL2_FONTSTYLE_ITALIC,
+				   RL2_FONTWEIGHT_NORMAL);
+    if (font == NULL)
+      {
+	  rl2_graph_destroy_context (ctx);
+	  return -2;
+      }
+    rl2_graph_set_font (ctx, font);
+    if (!rl2_graph_get_text_extent
+	(ctx, "Measured Label", &pre_x1, &pre_y1, &width1, &height1, &post_x1,
+	 &post_y1))
+	ret = -3;
+    if (ret == 0)
+      {
+	  /* painting the Label fills the Text Cache */
+	  rl2_graph_draw_text (ctx, "Measured Label", 10.0, 40.0, 0.0, 0.0,
+			       0.5);
+	  rl2_graph_draw_text (ctx, "Measured Label", 10.0, 70.0, 0.0, 0.0,
+			       0.5);
+	  if (!rl2_graph_get_text_extent
+	      (ctx, "Measured Label", &pre_x2, &pre_y2, &width2, &height2,
+	       &post_x2, &post_y2))
+	      ret = -4;
+      }
+    if (ret == 0)
+      {
+	  if (pre_x1 != pre_x2 || pre_y1 != pre_y2 || width1 != width2
+	      || height1 != height2 || post_x1 != post_x2
+	      || post_y1 != post_y2)
+	    {
+		fprintf (stderr, "Mismatching Text extents\n");
+		ret = -5;
+	    }
+	  if (width1 <= 0.0 || height1 <= 0.0)
+	    {
+		fprintf (stderr, "Unexpected empty Text extent\n");
+		ret = -6;
+	    }
+      }
+    rgba = rl2_graph_get_context_rgba_array (ctx);
+    if (rgba == NULL)
+	ret = -7;
+    else
+	free (rgba);
+    rl2_graph_release_font (ctx);
+    rl2_graph_destroy_context (ctx);
+    rl2_graph_destroy_font (font);
+    return ret;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+    if (!create_coverage (db_handle, "places", 200))
+	return -3;
+    if (!create_coverage (db_handle, "crowded", 6000))
+	return -4;
+
+/* the same Labels painted on cache misses and on cache hits */
+    ret = test_labels (db_handle, halo_style);
+    if (ret != 0)
+	return -10 + ret;
+    ret = test_labels (db_handle, plain_style);
+    if (ret != 0)
+	return -20 + ret;
+
+    ret = test_extent (priv_data);
+    if (ret != 0)
+	return -30 + ret;
+    ret = test_eviction (db_handle);
+    if (ret != 0)
+	return -40 + ret;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+    return 0;
+}
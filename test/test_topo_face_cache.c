@@ -0,0 +1,359 @@
+/*
+
+ test_topo_face_cache.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+/* the line splitting the first square into two Faces */
+#define SPLIT_LINE \
+    "GeomFromText('LINESTRING(1500050 4800000, 1500050 4800100)', 3003)"
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+execute_sql (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning nothing */
+    char *err_msg = NULL;
+    int ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+create_topology (sqlite3 * sqlite)
+{
+/* creating a TopoGeo Coverage: a grid of 2x2 squares */
+    int ix;
+    int iy;
+    char *sql;
+
+    if (execute_int (sqlite, "SELECT CreateTopology('cadastre', 3003, 0, 0)")
+	!= 1)
+	return 0;
+    for (iy = 0; iy < 2; iy++)
+      {
+	  for (ix = 0; ix < 2; ix++)
+	    {
+		int x = 1500000 + (ix * 100);
+		int y = 4800000 + (iy * 100);
+		sql =
+		    sqlite3_mprintf
+		    ("SELECT TopoGeo_AddPolygon('cadastre', "
+		     "GeomFromText('POLYGON((%d %d, %d %d, %d %d, %d %d, %d %d))', "
+		     "3003))", x, y, x + 100, y, x + 100, y + 100, x, y + 100, x,
+		     y);
+		if (!execute_sql (sqlite, sql))
+		  {
+		      sqlite3_free (sql);
+		      return 0;
+		  }
+		sqlite3_free (sql);
+	    }
+      }
+    if (execute_int
+	(sqlite,
+	 "SELECT SE_RegisterTopoGeoCoverage('cadastre', 'cadastre')") != 1)
+	return 0;
+    if (execute_sql
+	(sqlite,
+	 "CREATE TABLE images (id INTEGER PRIMARY KEY, img BLOB NOT NULL)"))
+	return 1;
+    return 0;
+}
+
+static int
+count_faces (sqlite3 * sqlite)
+{
+/* counting the Faces (excluding the Universe) */
+    return execute_int (sqlite,
+			"SELECT Count(*) FROM cadastre_face WHERE face_id > 0");
+}
+
+static int
+is_stale (sqlite3 * sqlite)
+{
+/* checking if the Face Cache is out of sync */
+    return execute_int (sqlite,
+			"SELECT changes <> synced FROM topo_face_caches "
+			"WHERE topology_name = 'cadastre'");
+}
+
+static int
+check_face_cache (sqlite3 * sqlite, int expected)
+{
+/* checking the Face Cache against the Topology */
+    int count;
+
+    if (is_stale (sqlite) != 0)
+      {
+	  fprintf (stderr, "Face Cache: unexpected stale status\n");
+	  return 0;
+      }
+    count = count_faces (sqlite);
+    if (count != expected)
+      {
+	  fprintf (stderr, "Face Cache: unexpected %d Faces (expected %d)\n",
+		   count, expected);
+	  return 0;
+      }
+    count = execute_int (sqlite, "SELECT Count(*) FROM cadastre_face_cache");
+    if (count != expected)
+      {
+	  fprintf (stderr,
+		   "Face Cache: unexpected %d cached Faces (expected %d)\n",
+		   count, expected);
+	  return 0;
+      }
+/* each cached Geometry must be the current one */
+    count =
+	execute_int (sqlite,
+		     "SELECT Count(*) FROM cadastre_face AS f "
+		     "LEFT JOIN cadastre_face_cache AS c ON (c.face_id = f.face_id) "
+		     "WHERE f.face_id > 0 AND (c.geometry IS NULL OR "
+		     "ST_Equals(c.geometry, CastToXY(ST_GetFaceGeometry("
+		     "'cadastre', f.face_id))) <> 1)");
+    if (count != 0)
+      {
+	  fprintf (stderr, "Face Cache: %d outdated Geometries\n", count);
+	  return 0;
+      }
+/* the Spatial Index must find every Face */
+    count =
+	execute_int (sqlite,
+		     "SELECT Count(*) FROM cadastre_face_cache WHERE "
+		     "face_id IN (SELECT ROWID FROM SpatialIndex WHERE "
+		     "f_table_name = 'DB=main.cadastre_face_cache' AND "
+		     "f_geometry_column = 'geometry' AND search_frame = "
+		     "BuildMbr(1499900, 4799900, 1500300, 4800300, 3003))");
+    if (count != expected)
+      {
+	  fprintf (stderr, "Face Cache: Spatial Index found %d Faces\n",
+		   count);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+paint_map (sqlite3 * sqlite, int id)
+{
+/* painting the TopoGeo Coverage, saving the image */
+    char *sql =
+	sqlite3_mprintf ("INSERT INTO images (id, img) "
+			 "SELECT %d, RL2_GetMapImageFromVector(NULL, 'cadastre', "
+			 "BuildMbr(1499900, 4799900, 1500300, 4800300, 3003), "
+			 "400, 400, 'default', 'image/png')", id);
+    int ret = execute_sql (sqlite, sql);
+    sqlite3_free (sql);
+    return ret;
+}
+
+static int
+same_image (sqlite3 * sqlite, int id1, int id2)
+{
+/* comparing two painted images */
+    char *sql = sqlite3_mprintf ("SELECT a.img = b.img FROM images AS a, "
+				 "images AS b WHERE a.id = %d AND b.id = %d",
+				 id1, id2);
+    int ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    return (ret == 1) ? 1 : 0;
+}
+
+static int
+test_face_cache (sqlite3 * sqlite)
+{
+/* editing the Topology: the Face Cache must be refreshed */
+    if (execute_int (sqlite, "SELECT RL2_BuildTopoFaceCache('cadastre')") != 1)
+	return -1;
+    if (!check_face_cache (sqlite, 4))
+	return -2;
+    if (!paint_map (sqlite, 1))
+	return -3;
+
+/* splitting a Face: the Cache becomes stale */
+    if (!execute_sql
+	(sqlite, "SELECT TopoGeo_AddLineString('cadastre', " SPLIT_LINE ")"))
+	return -4;
+    if (is_stale (sqlite) != 1)
+      {
+	  fprintf (stderr, "Face Cache: not invalidated by a split\n");
+	  return -5;
+      }
+    if (execute_int
+	(sqlite,
+	 "SELECT Count(*) FROM cadastre_face_cache WHERE geometry IS NULL") <=
+	0)
+      {
+	  fprintf (stderr, "Face Cache: no Face reset by a split\n");
+	  return -6;
+      }
+
+/* painting lazily refreshes the Cache */
+    if (!paint_map (sqlite, 2))
+	return -7;
+    if (!check_face_cache (sqlite, 5))
+	return -8;
+    if (same_image (sqlite, 1, 2))
+      {
+	  fprintf (stderr, "Face Cache: the split has not been painted\n");
+	  return -9;
+      }
+
+/* removing the splitting Edge: two Faces are merged again */
+    if (!execute_sql
+	(sqlite,
+	 "SELECT ST_RemEdgeModFace('cadastre', (SELECT edge_id FROM "
+	 "cadastre_edge WHERE ST_Equals(geom, " SPLIT_LINE ") = 1))"))
+	return -10;
+    if (is_stale (sqlite) != 1)
+      {
+	  fprintf (stderr, "Face Cache: not invalidated by a merge\n");
+	  return -11;
+      }
+    if (!paint_map (sqlite, 3))
+	return -12;
+    if (!check_face_cache (sqlite, 4))
+	return -13;
+
+/* the same Map painted without any Face Cache */
+    if (execute_int (sqlite, "SELECT RL2_DropTopoFaceCache('cadastre')") != 1)
+	return -14;
+    if (!paint_map (sqlite, 4))
+	return -15;
+    if (!same_image (sqlite, 3, 4))
+      {
+	  fprintf (stderr, "Face Cache: mismatching images (merge)\n");
+	  return -16;
+      }
+
+/* splitting again without any Face Cache */
+    if (!execute_sql
+	(sqlite, "SELECT TopoGeo_AddLineString('cadastre', " SPLIT_LINE ")"))
+	return -17;
+    if (!paint_map (sqlite, 5))
+	return -18;
+    if (!same_image (sqlite, 2, 5))
+      {
+	  fprintf (stderr, "Face Cache: mismatching images (split)\n");
+	  return -19;
+      }
+    return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    sqlite3 *db_handle;
+    char *err_msg = NULL;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+    if (!create_topology (db_handle))
+	return -3;
+
+    ret = test_face_cache (db_handle);
+    if (ret != 0)
+	return -10 + ret;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+    return 0;
+}
@@ -0,0 +1,341 @@
+/*
+
+ test_vector_clip.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+/* 1000 x 1000 map units painted on 500 x 500 pixels */
+#define MAP_FRAME	"BuildMbr(0, 0, 1000, 1000, 3857)"
+#define MAP_SIZE	500
+
+static const char *polygon_style =
+    "<PolygonSymbolizer><Fill>"
+    "<SvgParameter name=\"fill\">#ff0000</SvgParameter></Fill>"
+    "</PolygonSymbolizer>";
+
+static const char *line_style =
+    "<LineSymbolizer><Stroke>"
+    "<SvgParameter name=\"stroke\">#0000ff</SvgParameter>"
+    "<SvgParameter name=\"stroke-width\">4</SvgParameter>"
+    "</Stroke></LineSymbolizer>";
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+execute_sql (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning nothing */
+    char *err_msg = NULL;
+    int ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+create_coverage (sqlite3 * sqlite, const char *table, const char *type,
+		 const char **wkt)
+{
+/* creating and populating a Vector Coverage */
+    char *sql;
+    int ret;
+    int i;
+
+    sql = sqlite3_mprintf ("CREATE TABLE %s (id INTEGER PRIMARY KEY)", table);
+    ret = execute_sql (sqlite, sql);
+    sqlite3_free (sql);
+    if (!ret)
+	return 0;
+    sql =
+	sqlite3_mprintf
+	("SELECT AddGeometryColumn(%Q, 'geom', 3857, %Q, 'XY')", table, type);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+	return 0;
+    sql = sqlite3_mprintf ("SELECT CreateSpatialIndex(%Q, 'geom')", table);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+	return 0;
+    for (i = 0; wkt[i] != NULL; i++)
+      {
+	  sql =
+	      sqlite3_mprintf
+	      ("INSERT INTO %s (id, geom) VALUES (%d, GeomFromText(%Q, 3857))",
+	       table, i + 1, wkt[i]);
+	  ret = execute_sql (sqlite, sql);
+	  sqlite3_free (sql);
+	  if (!ret)
+	      return 0;
+      }
+    sql =
+	sqlite3_mprintf ("SELECT SE_RegisterVectorCoverage(%Q, %Q, 'geom')",
+			 table, table);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+	return 0;
+    return 1;
+}
+
+static unsigned char *
+render_map (sqlite3 * sqlite, const char *coverage, const char *symbolizer,
+	    int *rgba_sz)
+{
+/* painting the whole Map and decoding it as RGBA */
+    char *sql;
+    sqlite3_stmt *stmt;
+    unsigned char *rgba = NULL;
+    rl2RasterPtr rst = NULL;
+    unsigned int width;
+    unsigned int height;
+    int ret;
+
+    sql =
+	sqlite3_mprintf
+	("SELECT RL2_GetStyledMapImageFromVector(NULL, %Q, " MAP_FRAME
+	 ", %d, %d, '<FeatureTypeStyle xmlns=\"http://www.opengis.net/se\" "
+	 "version=\"1.1.0\"><Name>clip</Name><Rule>%q</Rule>"
+	 "</FeatureTypeStyle>', 'image/png', '#ffffff', 0)", coverage,
+	 MAP_SIZE, MAP_SIZE, symbolizer);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "GetStyledMapImageFromVector SQL error: %s\n",
+		   sqlite3_errmsg (sqlite));
+	  return NULL;
+      }
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+	rst =
+	    rl2_raster_from_png (sqlite3_column_blob (stmt, 0),
+				 sqlite3_column_bytes (stmt, 0), 1);
+    sqlite3_finalize (stmt);
+    if (rst == NULL)
+      {
+	  fprintf (stderr, "%s: unexpected NULL image\n", coverage);
+	  return NULL;
+      }
+    if (rl2_get_raster_size (rst, &width, &height) != RL2_OK
+	|| width != MAP_SIZE || height != MAP_SIZE
+	|| rl2_raster_data_to_RGBA (rst, &rgba, rgba_sz) != RL2_OK)
+	rgba = NULL;
+    rl2_destroy_raster (rst);
+    return rgba;
+}
+
+static int
+check_pixel (const unsigned char *rgba, const char *coverage, int col,
+	     int row, unsigned char red, unsigned char green,
+	     unsigned char blue)
+{
+/* checking the (anti-aliasing tolerant) color of some pixel */
+    const unsigned char *p = rgba + (((row * MAP_SIZE) + col) * 4);
+    if (abs (p[0] - red) > 32 || abs (p[1] - green) > 32
+	|| abs (p[2] - blue) > 32)
+      {
+	  fprintf (stderr,
+		   "%s: pixel %d,%d is #%02x%02x%02x (expected #%02x%02x%02x)\n",
+		   coverage, col, row, p[0], p[1], p[2], red, green, blue);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+test_polygons (sqlite3 * sqlite)
+{
+/* 
+/ a Polygon much bigger than the Map (no vertex at all on the canvas)
+/ and its Interior Ring fully on the canvas, then a Polygon fully
+/ outside the Map
+*/
+    const char *wkt[] = {
+	"POLYGON((-5000 -5000, 6000 -5000, 6000 6000, -5000 6000, -5000 -5000), "
+	    "(400 400, 600 400, 600 600, 400 600, 400 400))",
+	"POLYGON((2000 2000, 3000 2000, 3000 3000, 2000 3000, 2000 2000))",
+	NULL
+    };
+    unsigned char *rgba;
+    int rgba_sz;
+    int ok = 1;
+    if (!create_coverage (sqlite, "areas", "POLYGON", wkt))
+	return -1;
+    rgba = render_map (sqlite, "areas", polygon_style, &rgba_sz);
+    if (rgba == NULL)
+	return -2;
+    ok &= check_pixel (rgba, "areas", 0, 0, 0xff, 0x00, 0x00);
+    ok &= check_pixel (rgba, "areas", MAP_SIZE - 1, 0, 0xff, 0x00, 0x00);
+    ok &= check_pixel (rgba, "areas", 0, MAP_SIZE - 1, 0xff, 0x00, 0x00);
+    ok &= check_pixel (rgba, "areas", MAP_SIZE - 1, MAP_SIZE - 1, 0xff, 0x00,
+		       0x00);
+    ok &= check_pixel (rgba, "areas", 100, 250, 0xff, 0x00, 0x00);
+    /* the hole */
+    ok &= check_pixel (rgba, "areas", 250, 250, 0xff, 0xff, 0xff);
+    ok &= check_pixel (rgba, "areas", 205, 295, 0xff, 0xff, 0xff);
+    free (rgba);
+    return ok ? 0 : -3;
+}
+
+static int
+test_lines (sqlite3 * sqlite)
+{
+/*
+/ a Linestring leaving the Map across its upper edge and then entering
+/ it again, and a Linestring crossing the Map with no vertex at all on
+/ the canvas
+*/
+    const char *wkt[] = {
+	"LINESTRING(-3000 750, 300 750, 300 3000, 700 3000, 700 750, 4000 750)",
+	"LINESTRING(-2000 -2000, 3000 3000)",
+	NULL
+    };
+    unsigned char *rgba;
+    int rgba_sz;
+    int ok = 1;
+    if (!create_coverage (sqlite, "lines", "LINESTRING", wkt))
+	return -1;
+    rgba = render_map (sqlite, "lines", line_style, &rgba_sz);
+    if (rgba == NULL)
+	return -2;
+    /* the horizontal segments at Y=750 (row 125) */
+    ok &= check_pixel (rgba, "lines", 0, 125, 0x00, 0x00, 0xff);
+    ok &= check_pixel (rgba, "lines", 50, 125, 0x00, 0x00, 0xff);
+    ok &= check_pixel (rgba, "lines", 450, 125, 0x00, 0x00, 0xff);
+    ok &= check_pixel (rgba, "lines", MAP_SIZE - 1, 125, 0x00, 0x00, 0xff);
+    /* the vertical segments leaving and entering the Map */
+    ok &= check_pixel (rgba, "lines", 150, 60, 0x00, 0x00, 0xff);
+    ok &= check_pixel (rgba, "lines", 150, 0, 0x00, 0x00, 0xff);
+    ok &= check_pixel (rgba, "lines", 350, 60, 0x00, 0x00, 0xff);
+    ok &= check_pixel (rgba, "lines", 350, 0, 0x00, 0x00, 0xff);
+    /* the outside part must never be joined along the upper edge */
+    ok &= check_pixel (rgba, "lines", 250, 0, 0xff, 0xff, 0xff);
+    ok &= check_pixel (rgba, "lines", 250, 1, 0xff, 0xff, 0xff);
+    ok &= check_pixel (rgba, "lines", 250, 125, 0xff, 0xff, 0xff);
+    /* the diagonal line */
+    ok &= check_pixel (rgba, "lines", 0, MAP_SIZE - 1, 0x00, 0x00, 0xff);
+    ok &= check_pixel (rgba, "lines", 100, 400, 0x00, 0x00, 0xff);
+    ok &= check_pixel (rgba, "lines", 250, 250, 0x00, 0x00, 0xff);
+    ok &= check_pixel (rgba, "lines", MAP_SIZE - 1, 0, 0x00, 0x00, 0xff);
+    ok &= check_pixel (rgba, "lines", 100, 100, 0xff, 0xff, 0xff);
+    free (rgba);
+    return ok ? 0 : -3;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+
+    ret = test_polygons (db_handle);
+    if (ret != 0)
+	return -10 + ret;
+    ret = test_lines (db_handle);
+    if (ret != 0)
+	return -20 + ret;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+    return 0;
+}
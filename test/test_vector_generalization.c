@@ -0,0 +1,464 @@
+/*
+
+ test_vector_generalization.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+/* a 400 Km wide map (well beyond 1:50000) */
+#define MAP_FRAME	"BuildMbr(1400000, 4700000, 1800000, 4950000, 3003)"
+
+struct map_image
+{
+    unsigned char *blob;
+    int blob_sz;
+};
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+execute_sql (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning nothing */
+    char *err_msg = NULL;
+    int ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+render_map (sqlite3 * sqlite, struct map_image *img)
+{
+/* painting the whole Coverage */
+    const char *sql = "SELECT RL2_GetMapImageFromVector(NULL, 'parcels_cvg', "
+	MAP_FRAME ", 512, 320, 'default', 'image/png')";
+    sqlite3_stmt *stmt;
+    int ret;
+
+    img->blob = NULL;
+    img->blob_sz = 0;
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "GetMapImageFromVector SQL error: %s\n",
+		   sqlite3_errmsg (sqlite));
+	  return 0;
+      }
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+      {
+	  img->blob_sz = sqlite3_column_bytes (stmt, 0);
+	  img->blob = malloc (img->blob_sz);
+	  memcpy (img->blob, sqlite3_column_blob (stmt, 0), img->blob_sz);
+      }
+    sqlite3_finalize (stmt);
+    if (img->blob == NULL)
+      {
+	  fprintf (stderr, "GetMapImageFromVector: unexpected NULL image\n");
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+same_image (struct map_image *img1, struct map_image *img2)
+{
+/* checking if two map images are identical */
+    if (img1->blob_sz != img2->blob_sz)
+	return 0;
+    if (memcmp (img1->blob, img2->blob, img1->blob_sz) != 0)
+	return 0;
+    return 1;
+}
+
+static void
+free_image (struct map_image *img)
+{
+    if (img->blob != NULL)
+	free (img->blob);
+    img->blob = NULL;
+    img->blob_sz = 0;
+}
+
+static int
+count_generalized (sqlite3 * sqlite, int feature_id)
+{
+/* counting the generalized Geometries of some Feature */
+    char *sql =
+	sqlite3_mprintf ("SELECT Count(*) FROM parcels_cvg_generalized "
+			 "WHERE feature_id = %d", feature_id);
+    int count = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    return count;
+}
+
+static int
+check_against_base (sqlite3 * sqlite, struct map_image *img,
+		    const char *title)
+{
+/*
+/ painting from the generalization store, then from the full
+/ resolution Geometries: all Features are plain rectangles, so
+/ both maps must be identical
+*/
+    struct map_image base;
+    int ok = 1;
+
+    if (!render_map (sqlite, img))
+	return 0;
+    if (execute_int (sqlite, "SELECT DropVectorGeneralization('parcels_cvg')")
+	!= 1)
+	return 0;
+    if (!render_map (sqlite, &base))
+	return 0;
+    if (!same_image (img, &base))
+      {
+	  fprintf (stderr, "%s: generalized and full resolution maps differ\n",
+		   title);
+	  ok = 0;
+      }
+    free_image (&base);
+    if (execute_int (sqlite, "SELECT BuildVectorGeneralization('parcels_cvg')")
+	!= 1)
+	return 0;
+    return ok;
+}
+
+static int
+test_generalization (sqlite3 * sqlite)
+{
+/* testing that the generalization store follows all changes */
+    struct map_image empty;
+    struct map_image img1;
+    struct map_image img2;
+    struct map_image img3;
+    int retcode = 0;
+
+    empty.blob = NULL;
+    img1.blob = NULL;
+    img2.blob = NULL;
+    img3.blob = NULL;
+
+/* an empty map, then a single Feature */
+    if (!render_map (sqlite, &empty))
+	return -1;
+    if (!execute_sql
+	(sqlite,
+	 "INSERT INTO parcels (id, geom) VALUES (1, "
+	 "BuildMbr(1500000, 4800000, 1550000, 4850000, 3003))"))
+	return -2;
+    if (execute_int (sqlite, "SELECT BuildVectorGeneralization('parcels_cvg')")
+	!= 1)
+	return -3;
+    if (count_generalized (sqlite, 1) != 6)
+	return -4;
+    if (!check_against_base (sqlite, &img1, "build"))
+      {
+	  retcode = -5;
+	  goto end;
+      }
+
+/* the map is really painted from the store */
+    if (!execute_sql (sqlite, "SAVEPOINT probe"))
+      {
+	  retcode = -6;
+	  goto end;
+      }
+    if (!execute_sql (sqlite, "DELETE FROM parcels_cvg_generalized"))
+      {
+	  retcode = -7;
+	  goto end;
+      }
+    if (!render_map (sqlite, &img2))
+      {
+	  retcode = -8;
+	  goto end;
+      }
+    if (!same_image (&img2, &empty))
+      {
+	  fprintf (stderr, "the generalization store is not used\n");
+	  retcode = -9;
+	  goto end;
+      }
+    free_image (&img2);
+    if (!execute_sql (sqlite, "ROLLBACK TO probe")
+	|| !execute_sql (sqlite, "RELEASE probe"))
+      {
+	  retcode = -10;
+	  goto end;
+      }
+
+/* inserting a Feature after the build: it must be selected and painted */
+    if (!execute_sql
+	(sqlite,
+	 "INSERT INTO parcels (id, geom) VALUES (2, "
+	 "BuildMbr(1650000, 4850000, 1700000, 4900000, 3003))"))
+      {
+	  retcode = -11;
+	  goto end;
+      }
+    if (count_generalized (sqlite, 2) != 6)
+      {
+	  retcode = -12;
+	  goto end;
+      }
+    if (execute_int
+	(sqlite,
+	 "SELECT Count(*) FROM SpatialIndex "
+	 "WHERE f_table_name = 'DB=main.parcels_cvg_generalized' "
+	 "AND f_geometry_column = 'geometry' AND search_frame = "
+	 "BuildMbr(1660000, 4860000, 1690000, 4890000, 3003)") != 6)
+      {
+	  retcode = -13;
+	  goto end;
+      }
+    if (!render_map (sqlite, &img2))
+      {
+	  retcode = -14;
+	  goto end;
+      }
+    if (same_image (&img2, &img1))
+      {
+	  fprintf (stderr, "the inserted Feature is not painted\n");
+	  retcode = -15;
+	  goto end;
+      }
+    free_image (&img2);
+    if (!check_against_base (sqlite, &img2, "insert"))
+      {
+	  retcode = -16;
+	  goto end;
+      }
+
+/* moving a Feature */
+    if (!execute_sql
+	(sqlite,
+	 "UPDATE parcels SET geom = "
+	 "BuildMbr(1600000, 4720000, 1650000, 4770000, 3003) WHERE id = 2"))
+      {
+	  retcode = -17;
+	  goto end;
+      }
+    if (count_generalized (sqlite, 2) != 6)
+      {
+	  retcode = -18;
+	  goto end;
+      }
+    if (!check_against_base (sqlite, &img3, "update"))
+      {
+	  retcode = -19;
+	  goto end;
+      }
+    if (same_image (&img3, &img2))
+      {
+	  fprintf (stderr, "the updated Feature is stale\n");
+	  retcode = -20;
+	  goto end;
+      }
+
+/* deleting a Feature */
+    if (!execute_sql (sqlite, "DELETE FROM parcels WHERE id = 2"))
+      {
+	  retcode = -21;
+	  goto end;
+      }
+    if (count_generalized (sqlite, 2) != 0)
+      {
+	  retcode = -22;
+	  goto end;
+      }
+    free_image (&img2);
+    if (!render_map (sqlite, &img2))
+      {
+	  retcode = -23;
+	  goto end;
+      }
+    if (!same_image (&img2, &img1))
+      {
+	  fprintf (stderr, "the deleted Feature is still painted\n");
+	  retcode = -24;
+	  goto end;
+      }
+
+/* dropping the store also removes all its Triggers */
+    if (execute_int (sqlite, "SELECT DropVectorGeneralization('parcels_cvg')")
+	!= 1)
+      {
+	  retcode = -25;
+	  goto end;
+      }
+    if (execute_int
+	(sqlite,
+	 "SELECT Count(*) FROM sqlite_master WHERE type = 'trigger' "
+	 "AND name LIKE 'parcels_cvg_gen_%'") != 0)
+      {
+	  retcode = -26;
+	  goto end;
+      }
+    if (!execute_sql
+	(sqlite,
+	 "INSERT INTO parcels (id, geom) VALUES (3, "
+	 "BuildMbr(1650000, 4850000, 1700000, 4900000, 3003))"))
+      {
+	  retcode = -27;
+	  goto end;
+      }
+
+/* unregistering the Coverage empties the store */
+    if (execute_int (sqlite, "SELECT BuildVectorGeneralization('parcels_cvg')")
+	!= 1)
+      {
+	  retcode = -28;
+	  goto end;
+      }
+    if (execute_int (sqlite, "SELECT SE_UnRegisterVectorCoverage('parcels_cvg')")
+	!= 1)
+      {
+	  retcode = -29;
+	  goto end;
+      }
+    if (execute_int (sqlite, "SELECT Count(*) FROM parcels_cvg_generalized")
+	!= 0)
+      {
+	  retcode = -30;
+	  goto end;
+      }
+
+  end:
+    free_image (&empty);
+    free_image (&img1);
+    free_image (&img2);
+    free_image (&img3);
+    return retcode;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    char *err_msg = NULL;
+    sqlite3 *db_handle;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+
+/* creating and registering the Vector Coverage */
+    if (!execute_sql
+	(db_handle, "CREATE TABLE parcels (id INTEGER PRIMARY KEY)"))
+	return -3;
+    if (execute_int
+	(db_handle,
+	 "SELECT AddGeometryColumn('parcels', 'geom', 3003, 'POLYGON', 'XY')")
+	!= 1)
+	return -4;
+    if (execute_int (db_handle, "SELECT CreateSpatialIndex('parcels', 'geom')")
+	!= 1)
+	return -5;
+    if (execute_int
+	(db_handle,
+	 "SELECT SE_RegisterVectorCoverage('parcels_cvg', 'parcels', 'geom')")
+	!= 1)
+	return -6;
+
+    ret = test_generalization (db_handle);
+    if (ret != 0)
+	return -10 + ret;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+    return 0;
+}
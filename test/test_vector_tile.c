@@ -0,0 +1,618 @@
+/*
+
+ test_vector_tile.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include "rasterlite2/rasterlite2.h"
+
+#define WORLD_EXTENT	20037508.342789244
+
+#define MAX_FEATURES	4
+#define MAX_GEOM	32
+
+struct mvt_feature
+{
+/* a decoded MVT Feature */
+    int has_id;
+    sqlite3_uint64 id;
+    int type;
+    int n_tags;
+    int n_geom;
+    unsigned int geom[MAX_GEOM];
+};
+
+struct mvt_layer
+{
+/* a decoded MVT Layer */
+    int version;
+    char name[64];
+    int extent;
+    int n_keys;
+    int n_values;
+    int n_features;
+    struct mvt_feature features[MAX_FEATURES];
+};
+
+static int
+read_varint (const unsigned char *buf, int size, int *pos,
+	     sqlite3_uint64 * value)
+{
+/* decoding a protobuf Varint */
+    int shift = 0;
+    *value = 0;
+    while (*pos < size && shift < 64)
+      {
+	  unsigned char byte = buf[*pos];
+	  *pos += 1;
+	  *value |= (sqlite3_uint64) (byte & 0x7f) << shift;
+	  if ((byte & 0x80) == 0)
+	      return 1;
+	  shift += 7;
+      }
+    return 0;
+}
+
+static int
+read_key (const unsigned char *buf, int size, int *pos, int *field,
+	  int *wire_type)
+{
+/* decoding a protobuf field Key */
+    sqlite3_uint64 key;
+    if (!read_varint (buf, size, pos, &key))
+	return 0;
+    *field = (int) (key >> 3);
+    *wire_type = (int) (key & 0x7);
+    return 1;
+}
+
+static int
+read_bytes (const unsigned char *buf, int size, int *pos,
+	    const unsigned char **data, int *len)
+{
+/* decoding a protobuf length-delimited field */
+    sqlite3_uint64 value;
+    if (!read_varint (buf, size, pos, &value))
+	return 0;
+    if (value > (sqlite3_uint64) (size - *pos))
+	return 0;
+    *data = buf + *pos;
+    *len = (int) value;
+    *pos += *len;
+    return 1;
+}
+
+static int
+skip_field (const unsigned char *buf, int size, int *pos, int wire_type)
+{
+/* skipping an unexpected protobuf field */
+    sqlite3_uint64 value;
+    const unsigned char *data;
+    int len;
+    switch (wire_type)
+      {
+      case 0:
+	  return read_varint (buf, size, pos, &value);
+      case 1:
+	  *pos += 8;
+	  return (*pos <= size);
+      case 2:
+	  return read_bytes (buf, size, pos, &data, &len);
+      case 5:
+	  *pos += 4;
+	  return (*pos <= size);
+      };
+    return 0;
+}
+
+static int
+count_packed (const unsigned char *buf, int size, unsigned int *out, int max)
+{
+/* decoding a packed uint32 field */
+    int pos = 0;
+    int count = 0;
+    sqlite3_uint64 value;
+    while (pos < size)
+      {
+	  if (!read_varint (buf, size, &pos, &value))
+	      return -1;
+	  if (out != NULL)
+	    {
+		if (count >= max)
+		    return -1;
+		out[count] = (unsigned int) value;
+	    }
+	  count++;
+      }
+    return count;
+}
+
+static int
+decode_feature (const unsigned char *buf, int size, struct mvt_feature *ftr)
+{
+/* decoding an MVT Feature */
+    int pos = 0;
+    int field;
+    int wire_type;
+    sqlite3_uint64 value;
+    const unsigned char *data;
+    int len;
+
+    memset (ftr, 0, sizeof (struct mvt_feature));
+    while (pos < size)
+      {
+	  if (!read_key (buf, size, &pos, &field, &wire_type))
+	      return 0;
+	  if (field == 1 && wire_type == 0)
+	    {
+		if (!read_varint (buf, size, &pos, &(ftr->id)))
+		    return 0;
+		ftr->has_id = 1;
+	    }
+	  else if (field == 2 && wire_type == 2)
+	    {
+		if (!read_bytes (buf, size, &pos, &data, &len))
+		    return 0;
+		ftr->n_tags = count_packed (data, len, NULL, 0);
+		if (ftr->n_tags < 0)
+		    return 0;
+	    }
+	  else if (field == 3 && wire_type == 0)
+	    {
+		if (!read_varint (buf, size, &pos, &value))
+		    return 0;
+		ftr->type = (int) value;
+	    }
+	  else if (field == 4 && wire_type == 2)
+	    {
+		if (!read_bytes (buf, size, &pos, &data, &len))
+		    return 0;
+		ftr->n_geom = count_packed (data, len, ftr->geom, MAX_GEOM);
+		if (ftr->n_geom < 0)
+		    return 0;
+	    }
+	  else if (!skip_field (buf, size, &pos, wire_type))
+	      return 0;
+      }
+    return 1;
+}
+
+static int
+decode_layer (const unsigned char *buf, int size, struct mvt_layer *lyr)
+{
+/* decoding an MVT Layer */
+    int pos = 0;
+    int field;
+    int wire_type;
+    sqlite3_uint64 value;
+    const unsigned char *data;
+    int len;
+
+    while (pos < size)
+      {
+	  if (!read_key (buf, size, &pos, &field, &wire_type))
+	      return 0;
+	  if (field == 15 && wire_type == 0)
+	    {
+		if (!read_varint (buf, size, &pos, &value))
+		    return 0;
+		lyr->version = (int) value;
+	    }
+	  else if (field == 1 && wire_type == 2)
+	    {
+		if (!read_bytes (buf, size, &pos, &data, &len))
+		    return 0;
+		if (len >= (int) sizeof (lyr->name))
+		    return 0;
+		memcpy (lyr->name, data, len);
+		lyr->name[len] = '\0';
+	    }
+	  else if (field == 2 && wire_type == 2)
+	    {
+		if (!read_bytes (buf, size, &pos, &data, &len))
+		    return 0;
+		if (lyr->n_features >= MAX_FEATURES)
+		    return 0;
+		if (!decode_feature
+		    (data, len, lyr->features + lyr->n_features))
+		    return 0;
+		lyr->n_features += 1;
+	    }
+	  else if (field == 3 && wire_type == 2)
+	    {
+		if (!read_bytes (buf, size, &pos, &data, &len))
+		    return 0;
+		lyr->n_keys += 1;
+	    }
+	  else if (field == 4 && wire_type == 2)
+	    {
+		if (!read_bytes (buf, size, &pos, &data, &len))
+		    return 0;
+		lyr->n_values += 1;
+	    }
+	  else if (field == 5 && wire_type == 0)
+	    {
+		if (!read_varint (buf, size, &pos, &value))
+		    return 0;
+		lyr->extent = (int) value;
+	    }
+	  else if (!skip_field (buf, size, &pos, wire_type))
+	      return 0;
+      }
+    return 1;
+}
+
+static int
+decode_tile (const unsigned char *buf, int size, struct mvt_layer *lyr)
+{
+/* decoding an MVT Tile expected to contain exactly one Layer */
+    int pos = 0;
+    int field;
+    int wire_type;
+    const unsigned char *data;
+    int len;
+    int n_layers = 0;
+
+    memset (lyr, 0, sizeof (struct mvt_layer));
+    while (pos < size)
+      {
+	  if (!read_key (buf, size, &pos, &field, &wire_type))
+	      return 0;
+	  if (field == 3 && wire_type == 2)
+	    {
+		if (!read_bytes (buf, size, &pos, &data, &len))
+		    return 0;
+		if (n_layers > 0)
+		    return 0;
+		if (!decode_layer (data, len, lyr))
+		    return 0;
+		n_layers++;
+	    }
+	  else if (!skip_field (buf, size, &pos, wire_type))
+	      return 0;
+      }
+    return (n_layers == 1) ? 1 : 0;
+}
+
+static int
+execute_int (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning an Integer (-999 on failure) */
+    sqlite3_stmt *stmt;
+    int ret;
+    int value = -999;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return value;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_INTEGER)
+	value = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+    return value;
+}
+
+static int
+execute_sql (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement returning nothing */
+    char *err_msg = NULL;
+    int ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+    return 1;
+}
+
+static double
+map_x (int px)
+{
+/* the EPSG:3857 X of some pixel of the 0/0/0 Tile (extent 4096) */
+    return (0.0 - WORLD_EXTENT) + ((double) px * (WORLD_EXTENT * 2.0 / 4096.0));
+}
+
+static double
+map_y (int py)
+{
+/* the EPSG:3857 Y of some pixel of the 0/0/0 Tile (extent 4096) */
+    return WORLD_EXTENT - ((double) py * (WORLD_EXTENT * 2.0 / 4096.0));
+}
+
+static int
+create_coverage (sqlite3 * sqlite, const char *name, const char *type,
+		 const char *wkt)
+{
+/* creating a Vector Coverage containing a single Feature (id=7) */
+    char *sql;
+    int ret;
+
+    sql =
+	sqlite3_mprintf ("CREATE TABLE \"%s\" (id INTEGER PRIMARY KEY)", name);
+    ret = execute_sql (sqlite, sql);
+    sqlite3_free (sql);
+    if (!ret)
+	return 0;
+    sql =
+	sqlite3_mprintf
+	("SELECT AddGeometryColumn(%Q, 'geom', 3857, %Q, 'XY')", name, type);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+	return 0;
+    sql = sqlite3_mprintf ("SELECT CreateSpatialIndex(%Q, 'geom')", name);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    if (ret != 1)
+	return 0;
+    sql =
+	sqlite3_mprintf
+	("INSERT INTO \"%s\" (id, geom) VALUES (7, GeomFromText(%Q, 3857))",
+	 name, wkt);
+    ret = execute_sql (sqlite, sql);
+    sqlite3_free (sql);
+    if (!ret)
+	return 0;
+    sql =
+	sqlite3_mprintf ("SELECT SE_RegisterVectorCoverage(%Q, %Q, 'geom')",
+			 name, name);
+    ret = execute_int (sqlite, sql);
+    sqlite3_free (sql);
+    return (ret == 1) ? 1 : 0;
+}
+
+static int
+create_coverages (sqlite3 * sqlite)
+{
+/* creating a Points, a Linestrings and a Polygons Coverage */
+    char *wkt;
+    int ret;
+
+    wkt =
+	sqlite3_mprintf ("POINT(%1.6f %1.6f)", map_x (1024), map_y (3072));
+    ret = create_coverage (sqlite, "wells", "POINT", wkt);
+    sqlite3_free (wkt);
+    if (!ret)
+	return 0;
+    wkt =
+	sqlite3_mprintf ("LINESTRING(%1.6f %1.6f, %1.6f %1.6f, %1.6f %1.6f)",
+			 map_x (3000), map_y (1000), map_x (1000),
+			 map_y (1500), map_x (2000), map_y (500));
+    ret = create_coverage (sqlite, "roads", "LINESTRING", wkt);
+    sqlite3_free (wkt);
+    if (!ret)
+	return 0;
+    wkt =
+	sqlite3_mprintf ("POLYGON((%1.6f %1.6f, %1.6f %1.6f, %1.6f %1.6f, "
+			 "%1.6f %1.6f, %1.6f %1.6f))", map_x (1000),
+			 map_y (1000), map_x (2000), map_y (1000),
+			 map_x (2000), map_y (2000), map_x (1000),
+			 map_y (2000), map_x (1000), map_y (1000));
+    ret = create_coverage (sqlite, "parcels", "POLYGON", wkt);
+    sqlite3_free (wkt);
+    return ret;
+}
+
+static int
+test_tile (sqlite3 * sqlite, const char *coverage, int extent, int type,
+	   const unsigned int *expected, int n_expected)
+{
+/* encoding and then decoding the 0/0/0 Tile of some Coverage */
+    unsigned char *blob;
+    int blob_sz;
+    struct mvt_layer lyr;
+    struct mvt_feature *ftr;
+    int i;
+
+    if (rl2_vector_tile_blob
+	(sqlite, NULL, coverage, 0, 0, 0, extent, 0, &blob,
+	 &blob_sz) != RL2_OK)
+      {
+	  fprintf (stderr, "%s: unable to encode the Tile\n", coverage);
+	  return -1;
+      }
+    if (!decode_tile (blob, blob_sz, &lyr))
+      {
+	  fprintf (stderr, "%s: unable to decode the Tile\n", coverage);
+	  free (blob);
+	  return -2;
+      }
+    free (blob);
+
+    if (lyr.version != 2)
+      {
+	  fprintf (stderr, "%s: unexpected Layer version %d\n", coverage,
+		   lyr.version);
+	  return -3;
+      }
+    if (strcmp (lyr.name, coverage) != 0)
+      {
+	  fprintf (stderr, "%s: unexpected Layer name \"%s\"\n", coverage,
+		   lyr.name);
+	  return -4;
+      }
+    if (lyr.extent != extent)
+      {
+	  fprintf (stderr, "%s: unexpected Layer extent %d\n", coverage,
+		   lyr.extent);
+	  return -5;
+      }
+    if (lyr.n_keys != 0 || lyr.n_values != 0)
+      {
+	  fprintf (stderr, "%s: unexpected attributes\n", coverage);
+	  return -6;
+      }
+    if (lyr.n_features != 1)
+      {
+	  fprintf (stderr, "%s: unexpected %d Features\n", coverage,
+		   lyr.n_features);
+	  return -7;
+      }
+    ftr = lyr.features;
+    if (!ftr->has_id || ftr->id != 7)
+      {
+	  fprintf (stderr, "%s: unexpected Feature id\n", coverage);
+	  return -8;
+      }
+    if (ftr->type != type)
+      {
+	  fprintf (stderr, "%s: unexpected Feature type %d\n", coverage,
+		   ftr->type);
+	  return -9;
+      }
+    if (ftr->n_tags != 0)
+      {
+	  fprintf (stderr, "%s: unexpected Feature tags\n", coverage);
+	  return -10;
+      }
+    if (ftr->n_geom != n_expected)
+      {
+	  fprintf (stderr, "%s: unexpected %d geometry integers\n", coverage,
+		   ftr->n_geom);
+	  return -11;
+      }
+    for (i = 0; i < n_expected; i++)
+      {
+	  if (ftr->geom[i] != expected[i])
+	    {
+		fprintf (stderr,
+			 "%s: geometry integer #%d is %u (expected %u)\n",
+			 coverage, i, ftr->geom[i], expected[i]);
+		return -12;
+	    }
+      }
+    return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int ret;
+    sqlite3 *db_handle;
+    char *err_msg = NULL;
+    unsigned char *blob;
+    int blob_sz;
+    void *cache = spatialite_alloc_connection ();
+    void *priv_data = rl2_alloc_private ();
+/*
+/ expected geometry Commands and ZigZag encoded Parameters
+/ MoveTo(n) = 1 | (n << 3), LineTo(n) = 2 | (n << 3), ClosePath = 15
+*/
+    const unsigned int point[] = { 9, 2048, 6144 };
+    const unsigned int point512[] = { 9, 256, 768 };
+    const unsigned int line[] = {
+	9, 6000, 2000,		/* MoveTo (3000, 1000) */
+	18, 3999, 1000,		/* LineTo (-2000, +500) */
+	2000, 1999		/* (+1000, -1000) */
+    };
+    const unsigned int polygon[] = {
+	9, 2000, 2000,		/* MoveTo (1000, 1000) */
+	26, 2000, 0,		/* LineTo (+1000, 0) */
+	0, 2000,		/* (0, +1000) */
+	1999, 0,		/* (-1000, 0) */
+	15			/* ClosePath */
+    };
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+/* opening and initializing the "memory" test DB */
+    ret = sqlite3_open_v2 (":memory:", &db_handle,
+			   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_open_v2() error: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  return -1;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    rl2_init (db_handle, priv_data, 0);
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadataFull(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadataFull() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -2;
+      }
+    if (!create_coverages (db_handle))
+	return -3;
+
+    ret = test_tile (db_handle, "wells", 4096, 1, point, 3);
+    if (ret != 0)
+	return -10 + ret;
+    ret = test_tile (db_handle, "wells", 512, 1, point512, 3);
+    if (ret != 0)
+	return -30 + ret;
+    ret = test_tile (db_handle, "roads", 4096, 2, line, 8);
+    if (ret != 0)
+	return -50 + ret;
+    ret = test_tile (db_handle, "parcels", 4096, 3, polygon, 11);
+    if (ret != 0)
+	return -70 + ret;
+
+/* a Tile not intersecting any Feature is empty */
+    if (rl2_vector_tile_blob
+	(db_handle, NULL, "parcels", 2, 3, 3, 4096, 0, &blob,
+	 &blob_sz) != RL2_OK)
+	return -90;
+    free (blob);
+    if (blob_sz != 0)
+	return -91;
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    rl2_cleanup_private (priv_data);
+    spatialite_shutdown ();
+    return 0;
+}
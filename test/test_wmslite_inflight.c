@@ -0,0 +1,248 @@
+/*
+
+ test_wmslite_inflight.c -- RasterLite-2 Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the RasterLite2 library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2021
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#include "config.h"
+
+#include "sqlite3.h"
+
+#include "wmslite_inflight.h"
+
+#define WAITERS		8
+
+#ifndef _WIN32
+
+struct waiter
+{
+/* a thread issuing a request identical to the leader's one */
+    pthread_t thread_id;
+    const char *key;
+    int coalesced;
+    int rendered;
+    char payload[64];
+};
+
+static pthread_mutex_t free_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int free_count = 0;
+
+static void
+counted_free (void *ptr)
+{
+/* freeing a shared payload, so to check it's freed exactly once */
+    pthread_mutex_lock (&free_mutex);
+    free_count++;
+    pthread_mutex_unlock (&free_mutex);
+    free (ptr);
+}
+
+static WmsLiteSharedResponsePtr
+make_response (const char *text, int refcount)
+{
+/* creating a shared response */
+    WmsLiteSharedResponsePtr shared = malloc (sizeof (WmsLiteSharedResponse));
+    shared->length = strlen (text) + 1;
+    shared->payload = malloc (shared->length);
+    memcpy (shared->payload, text, shared->length);
+    shared->freeor = counted_free;
+    shared->mime_type = 0;
+    shared->refcount = refcount;
+    return shared;
+}
+
+static void *
+run_waiter (void *arg)
+{
+/* threaded function: a request joining the leader's one */
+    struct waiter *w = (struct waiter *) arg;
+    void *leader;
+    WmsLiteSharedResponsePtr shared;
+    char *key = sqlite3_mprintf ("%s", w->key);
+    if (inflight_acquire (key, &leader, &shared))
+      {
+	  /* unexpected: this request has not been coalesced */
+	  w->rendered = 1;
+	  inflight_publish (leader, NULL);
+	  return NULL;
+      }
+    w->coalesced = 1;
+    if (shared != NULL)
+      {
+	  strcpy (w->payload, shared->payload);
+	  release_shared_response (shared);
+      }
+    return NULL;
+}
+
+static int
+test_coalescing (const char *key, const char *text, int leader_refs)
+{
+/* a leader and many identical waiters sharing the same response */
+    struct waiter waiters[WAITERS];
+    void *leader;
+    WmsLiteSharedResponsePtr shared;
+    WmsLiteSharedResponsePtr mine;
+    int i;
+
+    free_count = 0;
+    if (!inflight_acquire (sqlite3_mprintf ("%s", key), &leader, &shared))
+      {
+	  fprintf (stderr, "%s: the first request isn't the leader\n", key);
+	  return -1;
+      }
+    if (leader == NULL)
+      {
+	  fprintf (stderr, "%s: unexpected NULL leader\n", key);
+	  return -2;
+      }
+    for (i = 0; i < WAITERS; i++)
+      {
+	  struct waiter *w = waiters + i;
+	  w->key = key;
+	  w->coalesced = 0;
+	  w->rendered = 0;
+	  *(w->payload) = '\0';
+	  pthread_create (&(w->thread_id), NULL, run_waiter, w);
+      }
+
+/* "rendering": giving all waiters the time to join */
+    usleep (500000);
+    mine = make_response (text, leader_refs);
+    inflight_publish (leader, mine);
+    for (i = 0; i < WAITERS; i++)
+	pthread_join (waiters[i].thread_id, NULL);
+
+    for (i = 0; i < WAITERS; i++)
+      {
+	  struct waiter *w = waiters + i;
+	  if (w->rendered || !w->coalesced)
+	    {
+		fprintf (stderr, "%s: waiter #%d rendered on its own\n", key,
+			 i);
+		return -3;
+	    }
+	  if (strcmp (w->payload, text) != 0)
+	    {
+		fprintf (stderr, "%s: waiter #%d got \"%s\"\n", key, i,
+			 w->payload);
+		return -4;
+	    }
+      }
+    if (leader_refs > 0)
+      {
+	  /* the leader still holds its own reference */
+	  if (free_count != 0)
+	    {
+		fprintf (stderr, "%s: payload freed too early\n", key);
+		return -5;
+	    }
+	  release_shared_response (mine);
+      }
+    if (free_count != 1)
+      {
+	  fprintf (stderr, "%s: payload freed %d times\n", key, free_count);
+	  return -6;
+      }
+
+/* the request is no longer in-flight: the next one leads again */
+    if (!inflight_acquire (sqlite3_mprintf ("%s", key), &leader, &shared))
+      {
+	  fprintf (stderr, "%s: stale in-flight request\n", key);
+	  return -7;
+      }
+    inflight_publish (leader, NULL);
+    return 0;
+}
+
+static int
+test_unshared_exception ()
+{
+/* an exception nobody waited for must be freed on publishing */
+    void *leader;
+    WmsLiteSharedResponsePtr shared;
+    free_count = 0;
+    if (!inflight_acquire (sqlite3_mprintf ("lonely"), &leader, &shared))
+	return -1;
+    inflight_publish (leader, make_response ("exception", 0));
+    if (free_count != 1)
+      {
+	  fprintf (stderr, "unshared exception freed %d times\n", free_count);
+	  return -2;
+      }
+    return 0;
+}
+
+#endif
+
+int
+main (int argc, char *argv[])
+{
+#ifndef _WIN32
+    int ret;
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+/* a valid MapImage, also held by the leader itself */
+    ret = test_coalescing ("map", "PNG image", 1);
+    if (ret < 0)
+	return ret;
+
+/* a failed request: the exception is shared, not rendered again */
+    ret = test_coalescing ("failure", "ServiceException", 0);
+    if (ret < 0)
+	return ret - 10;
+
+    ret = test_unshared_exception ();
+    if (ret < 0)
+	return ret - 20;
+#endif
+    return 0;
+}
@@ -30,6 +30,15 @@
 #include <float.h>
 #include <limits.h>
 #include <time.h>
+#include <math.h>
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+#include <windows.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#include <pthread.h>
+#endif
 
 #if defined(_WIN32) && !defined(__MINGW32__)
 #include "config-msvc.h"
@@ -40,6 +49,7 @@
 #include <rasterlite2/rasterlite2.h>
 #include <rasterlite2/rl2tiff.h>
 #include <rasterlite2/rl2graphics.h>
+#include <rasterlite2/rl2mapconfig.h>
 
 #include <spatialite/gaiaaux.h>
 #include <spatialite.h>
@@ -58,6 +68,7 @@
 #define ARG_MODE_CATALOG	12
 #define ARG_MODE_MAP		13
 #define ARG_MODE_HISTOGRAM	14
+#define ARG_MODE_SEED		15
 
 #define ARG_DB_PATH		10
 #define ARG_SRC_PATH		11
@@ -99,6 +110,11 @@
 #define ARG_BLUE_BAND	47
 #define ARG_NIR_BAND	48
 #define ARG_AUTO_NDVI	49
+#define ARG_MAP_CONFIG		50
+#define ARG_STYLE		51
+#define ARG_MIN_ZOOM		52
+#define ARG_MAX_ZOOM		53
+#define ARG_FORMAT		54
 
 #define ARG_MAX_THREADS		98
 #define ARG_CACHE_SIZE		99
@@ -107,6 +123,14 @@
 #define strcasecmp	_stricmp
 #endif /* not WIN32 */
 
+/* SEED: GoogleMapsCompatible (EPSG:3857) Tile Matrix Set */
+#define SEED_TILE_SIZE		256
+#define SEED_TILES_PER_THREAD	16
+#define SEED_MAX_ZOOM		22
+#define SEED_PI			3.14159265358979323846
+#define SEED_MERCATOR_EXTENT	20037508.342789244
+#define SEED_MAX_LATITUDE	85.0511287798066
+
 struct pyramid_params
 {
 /* a struct used to pass Pyramidization params */
@@ -2614,6 +2638,1001 @@ exec_histogram (sqlite3 * handle, const char *coverage, const char *section,
     return 0;
 }
 
+struct seed_tile
+{
+/* a struct wrapping a single Tile to be seeded */
+    int zoom;
+    int x;
+    int y;
+    int empty;
+    unsigned char *blob;
+    int blob_sz;
+};
+
+struct seed_worker
+{
+/* a struct wrapping a SEED worker (one for each thread) */
+    sqlite3 *handle;
+    void *cache;
+    void *priv_data;
+    sqlite3_stmt *stmt_mbr;
+    const char *coverage;
+    const char *map_config;
+    const char *style;
+    int jpeg;
+    int quality;
+    int check_empty;
+    struct seed_tile *tiles;
+    int count;
+    int empty;
+    int errors;
+    void *opaque_thread_id;
+};
+
+static void
+seed_tile_bbox (int zoom, int x, int y, double *minx, double *miny,
+		double *maxx, double *maxy)
+{
+/* computing the GoogleMapsCompatible (EPSG:3857) BBOX of some Tile */
+    double span = (SEED_MERCATOR_EXTENT * 2.0) / (double) (1 << zoom);
+    *minx = -SEED_MERCATOR_EXTENT + ((double) x * span);
+    *maxx = *minx + span;
+    *maxy = SEED_MERCATOR_EXTENT - ((double) y * span);
+    *miny = *maxy - span;
+}
+
+static int
+seed_tile_col (double lon, int zoom)
+{
+/* computing the Tile Column containing some Longitude */
+    int n = 1 << zoom;
+    int x = (int) floor (((lon + 180.0) / 360.0) * (double) n);
+    if (x < 0)
+	x = 0;
+    if (x >= n)
+	x = n - 1;
+    return x;
+}
+
+static int
+seed_tile_row (double lat, int zoom)
+{
+/* computing the Tile Row containing some Latitude */
+    int n = 1 << zoom;
+    int y;
+    double rad;
+    if (lat > SEED_MAX_LATITUDE)
+	lat = SEED_MAX_LATITUDE;
+    if (lat < -SEED_MAX_LATITUDE)
+	lat = -SEED_MAX_LATITUDE;
+    rad = lat * SEED_PI / 180.0;
+    y = (int)
+	floor (((1.0 - (log (tan (rad) + (1.0 / cos (rad))) / SEED_PI)) / 2.0) *
+	       (double) n);
+    if (y < 0)
+	y = 0;
+    if (y >= n)
+	y = n - 1;
+    return y;
+}
+
+static void
+do_seed_tile (struct seed_worker *worker, struct seed_tile *tile)
+{
+/* rendering a single Tile */
+    int ret;
+    double minx;
+    double miny;
+    double maxx;
+    double maxy;
+    unsigned char *blob = NULL;
+    int blob_sz;
+    unsigned char *img = NULL;
+    int img_sz;
+    rl2RasterPtr rst = NULL;
+    unsigned char *rgba = NULL;
+    int rgba_sz;
+    unsigned char *rgb = NULL;
+    unsigned char *p_in;
+    unsigned char *p_out;
+    unsigned char *jpeg;
+    int jpeg_sz;
+    int transparent = 1;
+    int i;
+
+    seed_tile_bbox (tile->zoom, tile->x, tile->y, &minx, &miny, &maxx, &maxy);
+    sqlite3_reset (worker->stmt_mbr);
+    sqlite3_clear_bindings (worker->stmt_mbr);
+    sqlite3_bind_double (worker->stmt_mbr, 1, minx);
+    sqlite3_bind_double (worker->stmt_mbr, 2, miny);
+    sqlite3_bind_double (worker->stmt_mbr, 3, maxx);
+    sqlite3_bind_double (worker->stmt_mbr, 4, maxy);
+    ret = sqlite3_step (worker->stmt_mbr);
+    if (ret == SQLITE_ROW
+	&& sqlite3_column_type (worker->stmt_mbr, 0) == SQLITE_BLOB)
+      {
+	  const unsigned char *p = sqlite3_column_blob (worker->stmt_mbr, 0);
+	  blob_sz = sqlite3_column_bytes (worker->stmt_mbr, 0);
+	  blob = malloc (blob_sz);
+	  memcpy (blob, p, blob_sz);
+      }
+    sqlite3_reset (worker->stmt_mbr);
+    if (blob == NULL)
+	goto error;
+
+/* 
+/ always rendering a PNG: a Coverage is always painted on a transparent
+/ background, so to safely detect empty Tiles; a Map Configuration
+/ adopts its own background (see is_seed_map_config_transparent)
+*/
+    if (worker->coverage != NULL)
+	ret =
+	    rl2_map_image_blob_from_raster (worker->handle, worker->priv_data,
+					    NULL, worker->coverage, blob,
+					    blob_sz, SEED_TILE_SIZE,
+					    SEED_TILE_SIZE, worker->style,
+					    "image/png", "#ffffff", 1, 100, 0,
+					    &img, &img_sz);
+    else
+	ret =
+	    rl2_image_blob_from_map_config (worker->handle, worker->priv_data,
+					    worker->map_config, blob, blob_sz,
+					    SEED_TILE_SIZE, SEED_TILE_SIZE,
+					    "image/png", 100, 0, &img, &img_sz);
+    free (blob);
+    if (ret != RL2_OK)
+	goto error;
+
+    if (!worker->check_empty && !worker->jpeg)
+      {
+	  /* opaque background: the PNG Tile can never be empty */
+	  tile->blob = img;
+	  tile->blob_sz = img_sz;
+	  return;
+      }
+
+/* checking for a fully transparent (empty or all NoData) Tile */
+    rst = rl2_raster_from_png (img, img_sz, 1);
+    if (rst == NULL)
+	goto error;
+    if (rl2_raster_data_to_RGBA (rst, &rgba, &rgba_sz) != RL2_OK)
+	goto error;
+    rl2_destroy_raster (rst);
+    rst = NULL;
+    if (!worker->check_empty)
+	transparent = 0;
+    for (i = 3; transparent && i < rgba_sz; i += 4)
+      {
+	  if (rgba[i] != 0)
+	    {
+		transparent = 0;
+		break;
+	    }
+      }
+    if (transparent)
+      {
+	  worker->empty += 1;
+	  tile->empty = 1;
+	  free (rgba);
+	  free (img);
+	  return;
+      }
+
+    if (!worker->jpeg)
+      {
+	  /* storing the PNG Tile as is */
+	  free (rgba);
+	  tile->blob = img;
+	  tile->blob_sz = img_sz;
+	  return;
+      }
+
+/* JPEG Tile: blending the RGBA pixels on a white background */
+    free (img);
+    img = NULL;
+    rgb = malloc (SEED_TILE_SIZE * SEED_TILE_SIZE * 3);
+    if (rgb == NULL)
+	goto error;
+    p_in = rgba;
+    p_out = rgb;
+    for (i = 0; i < SEED_TILE_SIZE * SEED_TILE_SIZE; i++)
+      {
+	  int alpha = p_in[3];
+	  *p_out++ = (unsigned char) ((p_in[0] * alpha + 255 * (255 - alpha))
+				      / 255);
+	  *p_out++ = (unsigned char) ((p_in[1] * alpha + 255 * (255 - alpha))
+				      / 255);
+	  *p_out++ = (unsigned char) ((p_in[2] * alpha + 255 * (255 - alpha))
+				      / 255);
+	  p_in += 4;
+      }
+    free (rgba);
+    rgba = NULL;
+    if (rl2_rgb_to_jpeg
+	(SEED_TILE_SIZE, SEED_TILE_SIZE, rgb, worker->quality, &jpeg,
+	 &jpeg_sz) != RL2_OK)
+	goto error;
+    free (rgb);
+    tile->blob = jpeg;
+    tile->blob_sz = jpeg_sz;
+    return;
+
+  error:
+    if (rst != NULL)
+	rl2_destroy_raster (rst);
+    if (img != NULL)
+	free (img);
+    if (rgba != NULL)
+	free (rgba);
+    if (rgb != NULL)
+	free (rgb);
+    worker->errors += 1;
+}
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+DWORD WINAPI
+doRunSeedThread (void *arg)
+#else
+void *
+doRunSeedThread (void *arg)
+#endif
+{
+/* threaded function: rendering a batch of Tiles */
+    struct seed_worker *worker = (struct seed_worker *) arg;
+    int i;
+    for (i = 0; i < worker->count; i++)
+	do_seed_tile (worker, worker->tiles + i);
+#if defined(_WIN32) && !defined(__MINGW32__)
+    return 0;
+#else
+    pthread_exit (NULL);
+    return NULL;
+#endif
+}
+
+static void
+start_seed_thread (struct seed_worker *worker)
+{
+/* starting a concurrent thread */
+#if defined(_WIN32) && !defined(__MINGW32__)
+    HANDLE thread_handle;
+    HANDLE *p_thread;
+    DWORD dwThreadId;
+    thread_handle =
+	CreateThread (NULL, 0, doRunSeedThread, worker, 0, &dwThreadId);
+    SetThreadPriority (thread_handle, THREAD_PRIORITY_IDLE);
+    p_thread = malloc (sizeof (HANDLE));
+    *p_thread = thread_handle;
+    worker->opaque_thread_id = p_thread;
+#else
+    pthread_t thread_id;
+    pthread_t *p_thread;
+    int ok_prior = 0;
+    int policy;
+    int min_prio;
+    pthread_attr_t attr;
+    struct sched_param sp;
+    pthread_attr_init (&attr);
+    if (pthread_attr_setschedpolicy (&attr, SCHED_RR) == 0)
+      {
+	  /* attempting to set the lowest priority */
+	  if (pthread_attr_getschedpolicy (&attr, &policy) == 0)
+	    {
+		min_prio = sched_get_priority_min (policy);
+		sp.sched_priority = min_prio;
+		if (pthread_attr_setschedparam (&attr, &sp) == 0)
+		  {
+		      /* ok, setting the lowest priority */
+		      ok_prior = 1;
+		      pthread_create (&thread_id, &attr, doRunSeedThread,
+				      worker);
+		  }
+	    }
+      }
+    if (!ok_prior)
+      {
+	  /* failure: using standard priority */
+	  pthread_create (&thread_id, NULL, doRunSeedThread, worker);
+      }
+    p_thread = malloc (sizeof (pthread_t));
+    *p_thread = thread_id;
+    worker->opaque_thread_id = p_thread;
+#endif
+}
+
+static void
+do_run_seed_children (struct seed_worker *workers, int thread_count)
+{
+/* concurrent execution of all SEED children threads */
+    struct seed_worker *worker;
+    int i;
+#if defined(_WIN32) && !defined(__MINGW32__)
+    HANDLE *handles;
+#endif
+
+    for (i = 0; i < thread_count; i++)
+      {
+	  /* starting all children threads */
+	  worker = workers + i;
+	  start_seed_thread (worker);
+      }
+
+/* waiting until all child threads exit */
+#if defined(_WIN32) && !defined(__MINGW32__)
+    handles = malloc (sizeof (HANDLE) * thread_count);
+    for (i = 0; i < thread_count; i++)
+      {
+	  /* initializing the HANDLEs array */
+	  HANDLE *pOpaque;
+	  worker = workers + i;
+	  pOpaque = (HANDLE *) (worker->opaque_thread_id);
+	  *(handles + i) = *pOpaque;
+      }
+    WaitForMultipleObjects (thread_count, handles, TRUE, INFINITE);
+    free (handles);
+#else
+    for (i = 0; i < thread_count; i++)
+      {
+	  pthread_t *pOpaque;
+	  worker = workers + i;
+	  pOpaque = (pthread_t *) (worker->opaque_thread_id);
+	  pthread_join (*pOpaque, NULL);
+      }
+#endif
+
+    for (i = 0; i < thread_count; i++)
+      {
+	  /* cleaning up a thread slot */
+	  worker = workers + i;
+	  if (worker->opaque_thread_id != NULL)
+	      free (worker->opaque_thread_id);
+	  worker->opaque_thread_id = NULL;
+      }
+}
+
+static int
+open_seed_worker (struct seed_worker *worker, const char *db_path)
+{
+/* opening a private read-only connection for a SEED worker */
+    int ret;
+    const char *sql = "SELECT BuildMbr(?, ?, ?, ?, 3857)";
+    ret = sqlite3_open_v2 (db_path, &(worker->handle), SQLITE_OPEN_READONLY,
+			   NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "cannot open '%s': %s\n", db_path,
+		   sqlite3_errmsg (worker->handle));
+	  sqlite3_close (worker->handle);
+	  worker->handle = NULL;
+	  return 0;
+      }
+    sqlite3_busy_timeout (worker->handle, 60000);
+    worker->cache = spatialite_alloc_connection ();
+    spatialite_init_ex (worker->handle, worker->cache, 0);
+    worker->priv_data = rl2_alloc_private ();
+    rl2_init (worker->handle, worker->priv_data, 0);
+    ret =
+	sqlite3_prepare_v2 (worker->handle, sql, strlen (sql),
+			    &(worker->stmt_mbr), NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "SELECT BuildMbr SQL error: %s\n",
+		   sqlite3_errmsg (worker->handle));
+	  return 0;
+      }
+    return 1;
+}
+
+static void
+close_seed_worker (struct seed_worker *worker)
+{
+/* closing a SEED worker connection */
+    if (worker->stmt_mbr != NULL)
+	sqlite3_finalize (worker->stmt_mbr);
+    if (worker->handle != NULL)
+	sqlite3_close (worker->handle);
+    if (worker->priv_data != NULL)
+	rl2_cleanup_private (worker->priv_data);
+    if (worker->cache != NULL)
+	spatialite_cleanup_ex (worker->cache);
+}
+
+static int
+do_seed_round (sqlite3 * store, sqlite3_stmt * stmt_ins,
+	       sqlite3_stmt * stmt_empty, struct seed_worker *workers,
+	       int max_threads, struct seed_tile *batch, int count,
+	       int *rendered, int *empty, int *errors)
+{
+/* rendering a batch of Tiles and committing them into the Tile Store */
+    int ret;
+    int i;
+    int n = 1 << batch->zoom;
+    int thread_count = 0;
+    int per_thread = (count + max_threads - 1) / max_threads;
+    char *sql_err = NULL;
+
+    for (i = 0; i < max_threads; i++)
+      {
+	  /* assigning a chunk of Tiles to each worker */
+	  struct seed_worker *worker = workers + i;
+	  int base = i * per_thread;
+	  if (base >= count)
+	      break;
+	  worker->tiles = batch + base;
+	  worker->count = per_thread;
+	  if (base + per_thread > count)
+	      worker->count = count - base;
+	  worker->empty = 0;
+	  worker->errors = 0;
+	  thread_count++;
+      }
+    do_run_seed_children (workers, thread_count);
+    for (i = 0; i < thread_count; i++)
+      {
+	  *empty += workers[i].empty;
+	  *errors += workers[i].errors;
+      }
+
+/* 
+/ storing all rendered Tiles (MBTiles rows are TMS, i.e. bottom-up)
+/ empty Tiles are recorded as well, so that resuming will skip them
+*/
+    ret = sqlite3_exec (store, "BEGIN", NULL, NULL, &sql_err);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "BEGIN TRANSACTION error: %s\n", sql_err);
+	  sqlite3_free (sql_err);
+	  goto error;
+      }
+    for (i = 0; i < count; i++)
+      {
+	  struct seed_tile *tile = batch + i;
+	  if (tile->empty)
+	    {
+		sqlite3_reset (stmt_empty);
+		sqlite3_clear_bindings (stmt_empty);
+		sqlite3_bind_int (stmt_empty, 1, tile->zoom);
+		sqlite3_bind_int (stmt_empty, 2, tile->x);
+		sqlite3_bind_int (stmt_empty, 3, n - 1 - tile->y);
+		ret = sqlite3_step (stmt_empty);
+		if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+		    continue;
+		fprintf (stderr,
+			 "INSERT INTO Empty Tiles; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (store));
+		sqlite3_exec (store, "ROLLBACK", NULL, NULL, NULL);
+		goto error;
+	    }
+	  if (tile->blob == NULL)
+	      continue;
+	  sqlite3_reset (stmt_ins);
+	  sqlite3_clear_bindings (stmt_ins);
+	  sqlite3_bind_int (stmt_ins, 1, tile->zoom);
+	  sqlite3_bind_int (stmt_ins, 2, tile->x);
+	  sqlite3_bind_int (stmt_ins, 3, n - 1 - tile->y);
+	  sqlite3_bind_blob (stmt_ins, 4, tile->blob, tile->blob_sz, free);
+	  tile->blob = NULL;
+	  ret = sqlite3_step (stmt_ins);
+	  if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+	      *rendered += 1;
+	  else
+	    {
+		fprintf (stderr, "INSERT INTO Tiles; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (store));
+		sqlite3_exec (store, "ROLLBACK", NULL, NULL, NULL);
+		goto error;
+	    }
+      }
+    ret = sqlite3_exec (store, "COMMIT", NULL, NULL, &sql_err);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "COMMIT TRANSACTION error: %s\n", sql_err);
+	  sqlite3_free (sql_err);
+	  goto error;
+      }
+    return 1;
+
+  error:
+    for (i = 0; i < count; i++)
+      {
+	  struct seed_tile *tile = batch + i;
+	  if (tile->blob != NULL)
+	      free (tile->blob);
+	  tile->blob = NULL;
+      }
+    return 0;
+}
+
+static int
+create_seed_store (sqlite3 * store, const char *tiles, const char *metadata)
+{
+/* creating the MBTiles-like Tile Store (if not already existing) */
+    int ret;
+    char *sql;
+    char *xtiles = gaiaDoubleQuotedSql (tiles);
+    char *xmetadata = gaiaDoubleQuotedSql (metadata);
+    char *xindex;
+    char *xempty;
+    char *sql_err = NULL;
+
+    sql = sqlite3_mprintf ("CREATE TABLE IF NOT EXISTS \"%s\" (\n"
+			   "name TEXT NOT NULL,\n"
+			   "value TEXT)", xmetadata);
+    ret = sqlite3_exec (store, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    sql = sqlite3_mprintf ("idx_%s_name", metadata);
+    xindex = gaiaDoubleQuotedSql (sql);
+    sqlite3_free (sql);
+    sql = sqlite3_mprintf ("CREATE UNIQUE INDEX IF NOT EXISTS \"%s\" "
+			   "ON \"%s\" (name)", xindex, xmetadata);
+    free (xindex);
+    ret = sqlite3_exec (store, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    sql = sqlite3_mprintf ("CREATE TABLE IF NOT EXISTS \"%s\" (\n"
+			   "zoom_level INTEGER NOT NULL,\n"
+			   "tile_column INTEGER NOT NULL,\n"
+			   "tile_row INTEGER NOT NULL,\n"
+			   "tile_data BLOB NOT NULL)", xtiles);
+    ret = sqlite3_exec (store, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    sql = sqlite3_mprintf ("idx_%s_zxy", tiles);
+    xindex = gaiaDoubleQuotedSql (sql);
+    sqlite3_free (sql);
+    sql = sqlite3_mprintf ("CREATE UNIQUE INDEX IF NOT EXISTS \"%s\" "
+			   "ON \"%s\" (zoom_level, tile_column, tile_row)",
+			   xindex, xtiles);
+    free (xindex);
+    ret = sqlite3_exec (store, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+/* empty Tiles (never stored, but already seeded) */
+    sql = sqlite3_mprintf ("%s_empty", tiles);
+    xempty = gaiaDoubleQuotedSql (sql);
+    sqlite3_free (sql);
+    sql = sqlite3_mprintf ("CREATE TABLE IF NOT EXISTS \"%s\" (\n"
+			   "zoom_level INTEGER NOT NULL,\n"
+			   "tile_column INTEGER NOT NULL,\n"
+			   "tile_row INTEGER NOT NULL,\n"
+			   "PRIMARY KEY (zoom_level, tile_column, tile_row))",
+			   xempty);
+    free (xempty);
+    ret = sqlite3_exec (store, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    free (xtiles);
+    free (xmetadata);
+    return 1;
+
+  error:
+    fprintf (stderr, "CREATE Tile Store error: %s\n", sql_err);
+    sqlite3_free (sql_err);
+    free (xtiles);
+    free (xmetadata);
+    return 0;
+}
+
+static int
+set_seed_metadata (sqlite3 * store, const char *metadata, const char *name,
+		   const char *format, int min_zoom, int max_zoom,
+		   double minx, double miny, double maxx, double maxy)
+{
+/* updating the Tile Store metadata */
+    int ret;
+    int i;
+    char *sql;
+    char *xmetadata = gaiaDoubleQuotedSql (metadata);
+    sqlite3_stmt *stmt = NULL;
+    char *values[7][2];
+
+    sql = sqlite3_mprintf ("INSERT OR REPLACE INTO \"%s\" (name, value) "
+			   "VALUES (?, ?)", xmetadata);
+    free (xmetadata);
+    ret = sqlite3_prepare_v2 (store, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "INSERT INTO Metadata SQL error: %s\n",
+		   sqlite3_errmsg (store));
+	  return 0;
+      }
+    values[0][0] = sqlite3_mprintf ("name");
+    values[0][1] = sqlite3_mprintf ("%s", name);
+    values[1][0] = sqlite3_mprintf ("type");
+    values[1][1] = sqlite3_mprintf ("baselayer");
+    values[2][0] = sqlite3_mprintf ("version");
+    values[2][1] = sqlite3_mprintf ("1.0");
+    values[3][0] = sqlite3_mprintf ("format");
+    values[3][1] = sqlite3_mprintf ("%s", format);
+    values[4][0] = sqlite3_mprintf ("bounds");
+    values[4][1] =
+	sqlite3_mprintf ("%1.6f,%1.6f,%1.6f,%1.6f", minx, miny, maxx, maxy);
+    values[5][0] = sqlite3_mprintf ("minzoom");
+    values[5][1] = sqlite3_mprintf ("%d", min_zoom);
+    values[6][0] = sqlite3_mprintf ("maxzoom");
+    values[6][1] = sqlite3_mprintf ("%d", max_zoom);
+    for (i = 0; i < 7; i++)
+      {
+	  sqlite3_reset (stmt);
+	  sqlite3_clear_bindings (stmt);
+	  sqlite3_bind_text (stmt, 1, values[i][0], strlen (values[i][0]),
+			     sqlite3_free);
+	  sqlite3_bind_text (stmt, 2, values[i][1], strlen (values[i][1]),
+			     sqlite3_free);
+	  ret = sqlite3_step (stmt);
+	  if (ret != SQLITE_DONE && ret != SQLITE_ROW)
+	    {
+		fprintf (stderr,
+			 "INSERT INTO Metadata; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (store));
+		for (i = i + 1; i < 7; i++)
+		  {
+		      sqlite3_free (values[i][0]);
+		      sqlite3_free (values[i][1]);
+		  }
+		sqlite3_finalize (stmt);
+		return 0;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    return 1;
+}
+
+static int
+get_seed_coverage_bbox (sqlite3 * handle, const char *coverage, double *minx,
+			double *miny, double *maxx, double *maxy)
+{
+/* retrieving the geographic extent of some Coverage */
+    int ret;
+    int found = 0;
+    const char *sql;
+    sqlite3_stmt *stmt = NULL;
+
+    sql = "SELECT geo_minx, geo_miny, geo_maxx, geo_maxy "
+	"FROM raster_coverages WHERE Lower(coverage_name) = Lower(?)";
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "SELECT Coverage geo Extent SQL error: %s\n",
+		   sqlite3_errmsg (handle));
+	  return 0;
+      }
+    sqlite3_bind_text (stmt, 1, coverage, strlen (coverage), SQLITE_STATIC);
+    while (1)
+      {
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;
+	  if (ret == SQLITE_ROW)
+	    {
+		if (sqlite3_column_type (stmt, 0) == SQLITE_FLOAT
+		    && sqlite3_column_type (stmt, 1) == SQLITE_FLOAT
+		    && sqlite3_column_type (stmt, 2) == SQLITE_FLOAT
+		    && sqlite3_column_type (stmt, 3) == SQLITE_FLOAT)
+		  {
+		      if (*minx == DBL_MAX)
+			  *minx = sqlite3_column_double (stmt, 0);
+		      if (*miny == DBL_MAX)
+			  *miny = sqlite3_column_double (stmt, 1);
+		      if (*maxx == DBL_MAX)
+			  *maxx = sqlite3_column_double (stmt, 2);
+		      if (*maxy == DBL_MAX)
+			  *maxy = sqlite3_column_double (stmt, 3);
+		      found = 1;
+		  }
+	    }
+	  else
+	    {
+		fprintf (stderr,
+			 "SELECT Coverage geo Extent; sqlite3_step() error: %s\n",
+			 sqlite3_errmsg (handle));
+		break;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    if (!found)
+	fprintf (stderr, "Coverage \"%s\" has no valid geographic Extent\n",
+		 coverage);
+    return found;
+}
+
+static int
+is_seed_map_config_transparent (sqlite3 * handle, const char *map_config)
+{
+/* 
+/ checking if some Map Configuration paints a transparent background;
+/ an opaque background makes every Tile look painted, so empty Tiles
+/ can't be detected at all
+*/
+    unsigned char *xml;
+    rl2MapConfigPtr config;
+    int transparent = 0;
+    xml = rl2_xml_from_registered_map_config (handle, map_config);
+    if (xml == NULL)
+	return 0;
+    config = rl2_parse_map_config_xml (xml);
+    free (xml);
+    if (config == NULL)
+	return 0;
+    transparent = config->map_background_transparent;
+    rl2_destroy_map_config (config);
+    return transparent;
+}
+
+static int
+exec_seed (sqlite3 * handle, const char *db_path, const char *coverage,
+	   const char *map_config, const char *style, const char *dst_path,
+	   int min_zoom, int max_zoom, double minx, double miny, double maxx,
+	   double maxy, int jpeg, int quality, int max_threads)
+{
+/* pre-rendering a Coverage or a Map Configuration into a Tile Store */
+    int ret;
+    char *sql;
+    char *xtiles;
+    char *xempty;
+    char *tiles = NULL;
+    char *metadata = NULL;
+    sqlite3 *store = NULL;
+    int own_store = 0;
+    sqlite3_stmt *stmt_ins = NULL;
+    sqlite3_stmt *stmt_chk = NULL;
+    sqlite3_stmt *stmt_empty = NULL;
+    struct seed_worker *workers = NULL;
+    struct seed_tile *batch = NULL;
+    int batch_max;
+    int zoom;
+    int x;
+    int y;
+    int i;
+    int retcode = 0;
+    char *sql_err = NULL;
+    const char *name = (coverage != NULL) ? coverage : map_config;
+    int check_empty = 1;
+    time_t start;
+    time_t now;
+
+/* resolving the geographic BBOX */
+    if (minx == DBL_MAX || miny == DBL_MAX || maxx == DBL_MAX
+	|| maxy == DBL_MAX)
+      {
+	  if (!get_seed_coverage_bbox
+	      (handle, coverage, &minx, &miny, &maxx, &maxy))
+	      return 0;
+      }
+    if (minx < -180.0)
+	minx = -180.0;
+    if (maxx > 180.0)
+	maxx = 180.0;
+    if (miny < -SEED_MAX_LATITUDE)
+	miny = -SEED_MAX_LATITUDE;
+    if (maxy > SEED_MAX_LATITUDE)
+	maxy = SEED_MAX_LATITUDE;
+    if (minx >= maxx || miny >= maxy)
+      {
+	  fprintf (stderr, "invalid BBOX: nothing to be seeded\n");
+	  return 0;
+      }
+    printf ("   Geographic BBOX: %1.6f %1.6f %1.6f %1.6f\n", minx, miny,
+	    maxx, maxy);
+    if (coverage == NULL
+	&& !is_seed_map_config_transparent (handle, map_config))
+      {
+	  /* a Coverage is always rendered on a transparent background */
+	  check_empty = 0;
+	  printf
+	      ("   Map Config paints an opaque background: every Tile will be stored\n");
+      }
+
+/* the pending transaction on the main connection is no longer needed */
+    ret = sqlite3_exec (handle, "COMMIT", NULL, NULL, &sql_err);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "COMMIT TRANSACTION error: %s\n", sql_err);
+	  sqlite3_free (sql_err);
+	  return 0;
+      }
+
+/* opening the Tile Store */
+    if (dst_path == NULL)
+      {
+	  /* seeding into the Coverage DB itself */
+	  store = handle;
+	  tiles = sqlite3_mprintf ("%s_seed_tiles", name);
+	  metadata = sqlite3_mprintf ("%s_seed_metadata", name);
+      }
+    else
+      {
+	  /* seeding into an MBTiles file */
+	  ret =
+	      sqlite3_open_v2 (dst_path, &store,
+			       SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+			       NULL);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "cannot open '%s': %s\n", dst_path,
+			 sqlite3_errmsg (store));
+		sqlite3_close (store);
+		store = NULL;
+		goto stop;
+	    }
+	  own_store = 1;
+	  tiles = sqlite3_mprintf ("tiles");
+	  metadata = sqlite3_mprintf ("metadata");
+      }
+    sqlite3_busy_timeout (store, 60000);
+    if (!create_seed_store (store, tiles, metadata))
+	goto stop;
+    if (!set_seed_metadata
+	(store, metadata, name, jpeg ? "jpg" : "png", min_zoom, max_zoom, minx,
+	 miny, maxx, maxy))
+	goto stop;
+
+    xtiles = gaiaDoubleQuotedSql (tiles);
+    sql = sqlite3_mprintf ("INSERT OR REPLACE INTO \"%s\" "
+			   "(zoom_level, tile_column, tile_row, tile_data) "
+			   "VALUES (?, ?, ?, ?)", xtiles);
+    ret = sqlite3_prepare_v2 (store, sql, strlen (sql), &stmt_ins, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  free (xtiles);
+	  fprintf (stderr, "INSERT INTO Tiles SQL error: %s\n",
+		   sqlite3_errmsg (store));
+	  goto stop;
+      }
+    sql = sqlite3_mprintf ("%s_empty", tiles);
+    xempty = gaiaDoubleQuotedSql (sql);
+    sqlite3_free (sql);
+    sql = sqlite3_mprintf ("SELECT 1 FROM \"%s\" WHERE zoom_level = ?1 "
+			   "AND tile_column = ?2 AND tile_row = ?3 "
+			   "UNION ALL SELECT 1 FROM \"%s\" WHERE zoom_level = ?1 "
+			   "AND tile_column = ?2 AND tile_row = ?3", xtiles,
+			   xempty);
+    free (xtiles);
+    ret = sqlite3_prepare_v2 (store, sql, strlen (sql), &stmt_chk, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  free (xempty);
+	  fprintf (stderr, "SELECT FROM Tiles SQL error: %s\n",
+		   sqlite3_errmsg (store));
+	  goto stop;
+      }
+    sql = sqlite3_mprintf ("INSERT OR REPLACE INTO \"%s\" "
+			   "(zoom_level, tile_column, tile_row) "
+			   "VALUES (?, ?, ?)", xempty);
+    free (xempty);
+    ret = sqlite3_prepare_v2 (store, sql, strlen (sql), &stmt_empty, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "INSERT INTO Empty Tiles SQL error: %s\n",
+		   sqlite3_errmsg (store));
+	  goto stop;
+      }
+
+/* opening a private connection for each worker thread */
+    workers = malloc (sizeof (struct seed_worker) * max_threads);
+    if (workers == NULL)
+	goto stop;
+    memset (workers, 0, sizeof (struct seed_worker) * max_threads);
+    for (i = 0; i < max_threads; i++)
+      {
+	  struct seed_worker *worker = workers + i;
+	  worker->coverage = coverage;
+	  worker->map_config = map_config;
+	  worker->style = style;
+	  worker->jpeg = jpeg;
+	  worker->quality = quality;
+	  worker->check_empty = check_empty;
+	  if (!open_seed_worker (worker, db_path))
+	      goto stop;
+      }
+    batch_max = max_threads * SEED_TILES_PER_THREAD;
+    batch = malloc (sizeof (struct seed_tile) * batch_max);
+    if (batch == NULL)
+	goto stop;
+
+    for (zoom = min_zoom; zoom <= max_zoom; zoom++)
+      {
+	  /* seeding a Zoom Level */
+	  int n = 1 << zoom;
+	  int col0 = seed_tile_col (minx, zoom);
+	  int col1 = seed_tile_col (maxx, zoom);
+	  int row0 = seed_tile_row (maxy, zoom);
+	  int row1 = seed_tile_row (miny, zoom);
+	  int count = 0;
+	  int rendered = 0;
+	  int empty = 0;
+	  int skipped = 0;
+	  int errors = 0;
+	  time (&start);
+	  for (y = row0; y <= row1; y++)
+	    {
+		for (x = col0; x <= col1; x++)
+		  {
+		      /* resuming: skipping already stored Tiles */
+		      int exists = 0;
+		      sqlite3_reset (stmt_chk);
+		      sqlite3_clear_bindings (stmt_chk);
+		      sqlite3_bind_int (stmt_chk, 1, zoom);
+		      sqlite3_bind_int (stmt_chk, 2, x);
+		      sqlite3_bind_int (stmt_chk, 3, n - 1 - y);
+		      if (sqlite3_step (stmt_chk) == SQLITE_ROW)
+			  exists = 1;
+		      sqlite3_reset (stmt_chk);
+		      if (exists)
+			{
+			    skipped++;
+			    continue;
+			}
+		      batch[count].zoom = zoom;
+		      batch[count].x = x;
+		      batch[count].y = y;
+		      batch[count].empty = 0;
+		      batch[count].blob = NULL;
+		      batch[count].blob_sz = 0;
+		      count++;
+		      if (count == batch_max)
+			{
+			    if (!do_seed_round
+				(store, stmt_ins, stmt_empty, workers,
+				 max_threads, batch, count, &rendered, &empty,
+				 &errors))
+				goto stop;
+			    count = 0;
+			}
+		  }
+	    }
+	  if (count > 0)
+	    {
+		if (!do_seed_round
+		    (store, stmt_ins, stmt_empty, workers, max_threads, batch,
+		     count, &rendered, &empty, &errors))
+		    goto stop;
+	    }
+	  time (&now);
+	  printf
+	      ("Zoom Level %2d: %d Tiles stored, %d empty, %d resumed, %d errors (%d sec)\n",
+	       zoom, rendered, empty, skipped, errors, (int) (now - start));
+	  if (errors > 0)
+	      goto stop;
+      }
+    retcode = 1;
+
+  stop:
+    if (batch != NULL)
+	free (batch);
+    if (workers != NULL)
+      {
+	  for (i = 0; i < max_threads; i++)
+	      close_seed_worker (workers + i);
+	  free (workers);
+      }
+    if (stmt_ins != NULL)
+	sqlite3_finalize (stmt_ins);
+    if (stmt_chk != NULL)
+	sqlite3_finalize (stmt_chk);
+    if (stmt_empty != NULL)
+	sqlite3_finalize (stmt_empty);
+    if (own_store)
+	sqlite3_close (store);
+    if (tiles != NULL)
+	sqlite3_free (tiles);
+    if (metadata != NULL)
+	sqlite3_free (metadata);
+/* restoring a pending transaction, as expected by the caller */
+    sqlite3_exec (handle, "BEGIN", NULL, NULL, NULL);
+    return retcode;
+}
+
 static void
 spatialite_autocreate (sqlite3 * db)
 {
@@ -4162,6 +5181,107 @@ check_map_args (const char *db_path, const char *coverage, const char *dst_path,
     return err;
 }
 
+static int
+check_seed_args (const char *db_path, const char *coverage,
+		 const char *map_config, const char **style,
+		 const char *dst_path, int *min_zoom, int *max_zoom,
+		 const char *format, int *jpeg, int *quality, double minx,
+		 double miny, double maxx, double maxy)
+{
+/* checking/printing SEED args */
+    int err = 0;
+    printf ("\n\nrl2tool; request is SEED\n");
+    printf ("===========================================================\n");
+    if (db_path == NULL)
+      {
+	  fprintf (stderr, "*** ERROR *** no DB path was specified\n");
+	  err = 1;
+      }
+    else
+	printf ("           DB path: %s\n", db_path);
+    if (coverage == NULL && map_config == NULL)
+      {
+	  fprintf (stderr,
+		   "*** ERROR *** no Coverage or Map Configuration was specified\n");
+	  err = 1;
+      }
+    else if (coverage != NULL && map_config != NULL)
+      {
+	  fprintf (stderr,
+		   "*** ERROR *** Coverage and Map Configuration are mutually exclusive\n");
+	  err = 1;
+      }
+    else if (coverage != NULL)
+      {
+	  if (*style == NULL)
+	      *style = "default";
+	  printf ("          Coverage: %s\n", coverage);
+	  printf ("             Style: %s\n", *style);
+      }
+    else
+	printf ("        Map Config: %s\n", map_config);
+    if (dst_path == NULL)
+	printf ("        Tile Store: the Coverage DB itself\n");
+    else
+	printf ("        Tile Store: %s\n", dst_path);
+    if (*min_zoom < 0)
+	*min_zoom = 0;
+    if (*max_zoom < 0)
+      {
+	  fprintf (stderr, "*** ERROR *** no max Zoom Level was specified\n");
+	  err = 1;
+      }
+    else if (*max_zoom > SEED_MAX_ZOOM)
+      {
+	  fprintf (stderr, "*** ERROR *** max Zoom Level can't exceed %d\n",
+		   SEED_MAX_ZOOM);
+	  err = 1;
+      }
+    else if (*min_zoom > *max_zoom)
+      {
+	  fprintf (stderr, "*** ERROR *** min Zoom Level exceeds max Zoom\n");
+	  err = 1;
+      }
+    else
+	printf ("       Zoom Levels: %d - %d (GoogleMapsCompatible)\n",
+		*min_zoom, *max_zoom);
+    if (format == NULL || strcasecmp (format, "png") == 0)
+      {
+	  *jpeg = 0;
+	  printf ("       Tile Format: PNG\n");
+      }
+    else if (strcasecmp (format, "jpeg") == 0
+	     || strcasecmp (format, "jpg") == 0)
+      {
+	  *jpeg = 1;
+	  if (*quality < 0)
+	      *quality = 80;
+	  if (*quality > 100)
+	      *quality = 100;
+	  printf ("       Tile Format: JPEG (quality %d)\n", *quality);
+      }
+    else
+      {
+	  fprintf (stderr, "*** ERROR *** unsupported Tile Format: %s\n",
+		   format);
+	  err = 1;
+      }
+    if (minx == DBL_MAX || miny == DBL_MAX || maxx == DBL_MAX
+	|| maxy == DBL_MAX)
+      {
+	  if (map_config != NULL)
+	    {
+		fprintf (stderr,
+			 "*** ERROR *** a Map Configuration requires an explicit BBOX\n");
+		err = 1;
+	    }
+	  else
+	      printf ("   Geographic BBOX: the Coverage geographic Extent\n");
+      }
+    printf ("===========================================================\n\n");
+    return err;
+}
+
 static int
 check_catalog_args (const char *db_path)
 {
@@ -4747,6 +5867,45 @@ do_help (int mode)
 	  fprintf (stderr,
 		   "-outh or --out-height number    image height (in pixels)\n\n");
       }
+    if (mode == ARG_NONE || mode == ARG_MODE_SEED)
+      {
+	  /* MODE = SEED */
+	  fprintf (stderr, "\nmode: SEED\n");
+	  fprintf (stderr,
+		   "will pre-render a Coverage or a Map Configuration into\n"
+		   "a GoogleMapsCompatible (EPSG:3857) Tile Store\n");
+	  fprintf (stderr,
+		   "==============================================================\n");
+	  fprintf (stderr,
+		   "-db or --db-path      pathname  RasterLite2 DB path\n");
+	  fprintf (stderr, "-cov or --coverage    string    Coverage's name\n");
+	  fprintf (stderr,
+		   "-mcf or --map-config  string    Map Configuration's name\n");
+	  fprintf (stderr,
+		   "-sty or --style       string    optional: Style's name\n");
+	  fprintf (stderr,
+		   "                                default is \"default\"\n");
+	  fprintf (stderr,
+		   "-dst or --dst-path    pathname  optional: MBTiles path\n");
+	  fprintf (stderr,
+		   "                                default is the DB itself\n");
+	  fprintf (stderr, "-minz or --min-zoom   number    min Zoom Level\n");
+	  fprintf (stderr, "-maxz or --max-zoom   number    max Zoom Level\n");
+	  fprintf (stderr,
+		   "-fmt or --format      string    PNG or JPEG (default PNG)\n");
+	  fprintf (stderr,
+		   "-qty or --quality     number    JPEG quality (default 80)\n");
+	  fprintf (stderr, "-minx or --min-x      number    BBOX (longitude)\n");
+	  fprintf (stderr, "-miny or --min-y      number    BBOX (latitude)\n");
+	  fprintf (stderr, "-maxx or --max-x      number    BBOX (longitude)\n");
+	  fprintf (stderr, "-maxy or --max-y      number    BBOX (latitude)\n");
+	  fprintf (stderr,
+		   "                                default is Coverage Extent\n");
+	  fprintf (stderr,
+		   "-mt or --max-threads   num      concurrent rendering threads\n");
+	  fprintf (stderr,
+		   "already seeded (stored or empty) Tiles are never rendered again (resume)\n\n");
+      }
     if (mode == ARG_NONE || mode == ARG_MODE_CATALOG)
       {
 	  /* MODE = CATALOG */
@@ -4866,6 +6025,12 @@ main (int argc, char *argv[])
     int auto_ndvi = -1;
     int retcode = 0;
     int max_threads = 1;
+    const char *map_config = NULL;
+    const char *style = NULL;
+    const char *format = NULL;
+    int min_zoom = -1;
+    int max_zoom = -1;
+    int jpeg = 0;
 
     if (argc >= 2)
       {
@@ -4908,6 +6073,8 @@ main (int argc, char *argv[])
 	      mode = ARG_MODE_CATALOG;
 	  if (strcasecmp (argv[1], "HISTOGRAM") == 0)
 	      mode = ARG_MODE_HISTOGRAM;
+	  if (strcasecmp (argv[1], "SEED") == 0)
+	      mode = ARG_MODE_SEED;
       }
     for (i = 2; i < argc; i++)
       {
@@ -5108,6 +6275,21 @@ main (int argc, char *argv[])
 		  case ARG_AUTO_NDVI:
 		      auto_ndvi = atoi (argv[i]);
 		      break;
+		  case ARG_MAP_CONFIG:
+		      map_config = argv[i];
+		      break;
+		  case ARG_STYLE:
+		      style = argv[i];
+		      break;
+		  case ARG_MIN_ZOOM:
+		      min_zoom = atoi (argv[i]);
+		      break;
+		  case ARG_MAX_ZOOM:
+		      max_zoom = atoi (argv[i]);
+		      break;
+		  case ARG_FORMAT:
+		      format = argv[i];
+		      break;
 		  case ARG_CACHE_SIZE:
 		      cache_size = atoi (argv[i]);
 		      break;
@@ -5196,6 +6378,36 @@ main (int argc, char *argv[])
 		next_arg = ARG_COMPRESSION;
 		continue;
 	    }
+	  if (strcmp (argv[i], "-mcf") == 0
+	      || strcasecmp (argv[i], "--map-config") == 0)
+	    {
+		next_arg = ARG_MAP_CONFIG;
+		continue;
+	    }
+	  if (strcmp (argv[i], "-sty") == 0
+	      || strcasecmp (argv[i], "--style") == 0)
+	    {
+		next_arg = ARG_STYLE;
+		continue;
+	    }
+	  if (strcmp (argv[i], "-minz") == 0
+	      || strcasecmp (argv[i], "--min-zoom") == 0)
+	    {
+		next_arg = ARG_MIN_ZOOM;
+		continue;
+	    }
+	  if (strcmp (argv[i], "-maxz") == 0
+	      || strcasecmp (argv[i], "--max-zoom") == 0)
+	    {
+		next_arg = ARG_MAX_ZOOM;
+		continue;
+	    }
+	  if (strcmp (argv[i], "-fmt") == 0
+	      || strcasecmp (argv[i], "--format") == 0)
+	    {
+		next_arg = ARG_FORMAT;
+		continue;
+	    }
 	  if (strcmp (argv[i], "-qty") == 0
 	      || strcasecmp (argv[i], "--quality") == 0)
 	    {
@@ -5529,6 +6741,12 @@ main (int argc, char *argv[])
       case ARG_MODE_CATALOG:
 	  error = check_catalog_args (db_path);
 	  break;
+      case ARG_MODE_SEED:
+	  error =
+	      check_seed_args (db_path, coverage, map_config, &style, dst_path,
+			       &min_zoom, &max_zoom, format, &jpeg, &quality,
+			       minx, miny, maxx, maxy);
+	  break;
       case ARG_MODE_HISTOGRAM:
 	  if (dst_path == NULL)
 	    {
@@ -5706,6 +6924,12 @@ main (int argc, char *argv[])
 	      exec_histogram (handle, coverage, section, ok_section_id,
 			      section_id, band_index, dst_path);
 	  break;
+      case ARG_MODE_SEED:
+	  ret =
+	      exec_seed (handle, db_path, coverage, map_config, style, dst_path,
+			 min_zoom, max_zoom, minx, miny, maxx, maxy, jpeg,
+			 quality, max_threads);
+	  break;
       };
 
     if (ret)
@@ -5759,6 +6983,9 @@ main (int argc, char *argv[])
 	    case ARG_MODE_HISTOGRAM:
 		op_name = "HISTOGRAM";
 		break;
+	    case ARG_MODE_SEED:
+		op_name = "SEED";
+		break;
 	    };
 	  printf ("\nOperation %s successfully completed\n", op_name);
       }
@@ -32,6 +32,8 @@
 #include <spatialite.h>
 #include <spatialite/gaiaaux.h>
 
+#include "wmslite_inflight.h"
+
 #define ARG_NONE		1000
 #define ARG_SERVER		1001
 #define ARG_CONFIG_FILE	1002
@@ -56,6 +58,7 @@
 #define WMS_GET_MAP				2
 #define WMS_GET_FEATURE_INFO	3
 #define WMS_GET_LEGEND_GRAPHIC	4
+#define WMTS_GET_TILE			5
 
 #define WMS_EXCEPTIONS_DEFAULT	0
 #define WMS_EXCEPTIONS_XML		1
@@ -72,6 +75,8 @@
 #define MIME_JPEG	5
 #define MIME_TIFF	6
 #define MIME_PDF	7
+#define MIME_WEBP	8
+#define MIME_MVT	9
 
 #define CONNECTION_INVALID	0
 #define CONNECTION_AVAILABLE	1
@@ -268,6 +273,8 @@ typedef struct wms_lite_layer
     WmsLiteChildLayerPtr Last;
     double MinScaleDenominator;
     double MaxScaleDenominator;
+    double Timeout;
+    sqlite3_int64 MaxPixels;
     int ChildLayer;
     struct wms_lite_layer *Next;
 } WmsLiteLayer;
@@ -285,6 +292,8 @@ typedef struct wms_lite_attached_layer
     WmsLiteVectorPtr Vector;
     double MinScaleDenominator;
     double MaxScaleDenominator;
+    double Timeout;
+    sqlite3_int64 MaxPixels;
     int ChildLayer;
     struct wms_lite_attached_layer *Next;
 } WmsLiteAttachedLayer;
@@ -312,6 +321,7 @@ typedef struct wms_lite_connection
     sqlite3_stmt *stmt_raster;
     sqlite3_stmt *stmt_config;
     sqlite3_stmt *stmt_wms;
+    sqlite3_stmt *stmt_mvt;
     CURL *curl;
     int status;
 } WmsLiteConnection;
@@ -333,6 +343,8 @@ typedef struct wms_lite_configuration
     char *Path;
     int MultithreadEnabled;
     int MaxThreads;
+    double RequestTimeout;
+    sqlite3_int64 MaxPixels;
     int WmsMaxRetries;
     int WmsPause;
     unsigned char BackgroundRed;
@@ -446,6 +458,7 @@ typedef struct http_request
     char *end_time;
     int http_status;
     int service_wms;
+    int service_wmts;
     int request_type;
     int exceptions;
     int version_1;
@@ -470,6 +483,7 @@ typedef struct http_request
     int point_y;
     void *http_response;
     void (*freeor) (void *);
+    WmsLiteSharedResponsePtr shared_response;
     int http_content_length;
     int http_mime_type;
     const char *param_version;
@@ -490,6 +504,10 @@ typedef struct http_request
     const char *param_feature_count;
     const char *param_point_x;
     const char *param_point_y;
+    const char *param_tile_matrix_set;
+    const char *param_tile_matrix;
+    const char *param_tile_row;
+    const char *param_tile_col;
 } WmsLiteHttpRequest;
 typedef WmsLiteHttpRequest *WmsLiteHttpRequestPtr;
 
@@ -585,4 +603,12 @@ extern void destroy_connections_pool (WmsLiteConnectionsPoolPtr pool);
 extern int server_main (int argc, char *argv[]);
 extern void process_http_request (WmsLiteHttpRequestPtr req);
 extern void do_get_capabilities (WmsLiteHttpRequestPtr req);
+extern void do_find_layer (WmsLiteConfigPtr config, const char *layer_name,
+			   int *layer_type, const char **db_prefix,
+			   const char **coverage_name);
+extern void do_find_layer_limits (WmsLiteConfigPtr config,
+				  const char *layer_name, double *timeout,
+				  sqlite3_int64 * max_pixels);
+extern int parse_wmts_rest_url (WmsLiteHttpRequestPtr req);
+extern void process_wmts_request (WmsLiteHttpRequestPtr req);
 extern void do_update_logfile (WmsLiteHttpRequestPtr req);
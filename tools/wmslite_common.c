@@ -30,10 +30,16 @@
 #include <string.h>
 #include <math.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 #include "wmslite.h"
 #include "rasterlite2_private.h"
 
-extern void
+void
 clean_shutdown ()
 {
 /* performing a clean shutdown */
@@ -166,7 +172,7 @@ make_url_spaces (const char *str)
     return outstr;
 }
 
-extern char *
+char *
 url_decode (CURL * curl, const char *encoded_url)
 {
 /* decoding a possibly encoded URL */
@@ -246,7 +252,23 @@ prepare_stmt_wms (sqlite3 * db_handle)
     return stmt;
 }
 
-extern void
+static sqlite3_stmt *
+prepare_stmt_mvt (sqlite3 * db_handle)
+{
+/* creatint a prepared statement for Vector Tiles */
+    sqlite3_stmt *stmt = NULL;
+    const char *sql = "SELECT RL2_GetVectorTile(?, ?, ?, ?, ?, 4096, 64)";
+    int ret = sqlite3_prepare_v2 (db_handle, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  if (stmt != NULL)
+	      sqlite3_finalize (stmt);
+	  return NULL;
+      }
+    return stmt;
+}
+
+void
 connection_init (WmsLiteConnectionPtr conn, WmsLiteConfigPtr config)
 {
 /* creating a DB connection */
@@ -298,6 +320,7 @@ connection_init (WmsLiteConnectionPtr conn, WmsLiteConfigPtr config)
     conn->stmt_raster = prepare_stmt_raster (db_handle);
     conn->stmt_config = prepare_stmt_config (db_handle);
     conn->stmt_wms = prepare_stmt_wms (db_handle);
+    conn->stmt_mvt = prepare_stmt_mvt (db_handle);
     conn->curl = curl_easy_init ();
     conn->status = CONNECTION_AVAILABLE;
     return;
@@ -317,6 +340,8 @@ close_connection (WmsLiteConnectionPtr conn)
 	sqlite3_finalize (conn->stmt_config);
     if (conn->stmt_wms != NULL)
 	sqlite3_finalize (conn->stmt_wms);
+    if (conn->stmt_mvt != NULL)
+	sqlite3_finalize (conn->stmt_mvt);
     if (conn->handle != NULL)
 	sqlite3_close (conn->handle);
     if (conn->splite_privdata != NULL)
@@ -328,7 +353,7 @@ close_connection (WmsLiteConnectionPtr conn)
     conn->status = CONNECTION_INVALID;
 }
 
-extern void
+void
 destroy_connections_pool (WmsLiteConnectionsPoolPtr pool)
 {
 /* memory clean-up: destroying a connections pool */
@@ -347,7 +372,7 @@ destroy_connections_pool (WmsLiteConnectionsPoolPtr pool)
     free (pool);
 }
 
-extern WmsLiteConnectionsPoolPtr
+WmsLiteConnectionsPoolPtr
 alloc_connections_pool (WmsLiteConfigPtr config, int max_connections)
 {
 /* creating and initializing the connections pool */
@@ -384,6 +409,7 @@ alloc_connections_pool (WmsLiteConfigPtr config, int max_connections)
 	  conn->stmt_raster = NULL;
 	  conn->stmt_config = NULL;
 	  conn->stmt_wms = NULL;
+	  conn->stmt_mvt = NULL;
 	  conn->curl = NULL;
 	  conn->status = CONNECTION_INVALID;
       }
@@ -401,6 +427,7 @@ alloc_connections_pool (WmsLiteConfigPtr config, int max_connections)
 		conn->stmt_raster = config->Connection.stmt_raster;
 		conn->stmt_config = config->Connection.stmt_config;
 		conn->stmt_wms = config->Connection.stmt_wms;
+		conn->stmt_mvt = config->Connection.stmt_mvt;
 		conn->curl = config->Connection.curl;
 		conn->status = CONNECTION_AVAILABLE;
 		/* releasing ownership on Config Connection */
@@ -409,6 +436,7 @@ alloc_connections_pool (WmsLiteConfigPtr config, int max_connections)
 		config->Connection.stmt_raster = NULL;
 		config->Connection.stmt_config = NULL;
 		config->Connection.stmt_wms = NULL;
+		config->Connection.stmt_mvt = NULL;
 		config->Connection.splite_privdata = NULL;
 		config->Connection.rl2_privdata = NULL;
 	    }
@@ -432,7 +460,7 @@ alloc_connections_pool (WmsLiteConfigPtr config, int max_connections)
     return pool;
 }
 
-extern WmsLiteArgumentPtr
+WmsLiteArgumentPtr
 alloc_wms_argument (char *name, char *value)
 {
 /* allocating a WMS argument */
@@ -443,7 +471,7 @@ alloc_wms_argument (char *name, char *value)
     return arg;
 }
 
-extern void
+void
 destroy_wms_argument (WmsLiteArgumentPtr arg)
 {
 /* memory cleanup - destroying a WMS arg struct */
@@ -457,7 +485,7 @@ destroy_wms_argument (WmsLiteArgumentPtr arg)
 }
 
 
-extern int
+int
 add_wms_argument (WmsLiteHttpRequestPtr req, const char *token)
 {
 /* attempting to add an HTTP CGI argument */
@@ -1374,7 +1402,7 @@ check_wms_bgcolor (WmsLiteHttpRequestPtr req)
     return 1;
 }
 
-extern void
+void
 parse_request_args (WmsLiteHttpRequestPtr req, const char *query_string,
 		    int len)
 {
@@ -1720,7 +1748,7 @@ throw_exception (WmsLiteHttpRequestPtr req, const char *msg)
 	throw_xml_exception (req, msg);
 }
 
-extern void
+void
 do_get_capabilities (WmsLiteHttpRequestPtr req)
 {
 /* preparing the GetCapabilities response */
@@ -1819,7 +1847,7 @@ do_get_capabilities (WmsLiteHttpRequestPtr req)
     req->http_mime_type = MIME_XML;
 }
 
-static void
+void
 do_find_layer (WmsLiteConfigPtr config, const char *layer_name, int *layer_type,
 	       const char **db_prefix, const char **coverage_name)
 {
@@ -1928,6 +1956,65 @@ do_find_layer (WmsLiteConfigPtr config, const char *layer_name, int *layer_type,
       }
 }
 
+void
+do_find_layer_limits (WmsLiteConfigPtr config, const char *layer_name,
+		      double *timeout, sqlite3_int64 * max_pixels)
+{
+/* 
+/ retrieving the request limits applying to some Layer
+/ (Layer-level limits always override the global ones)
+*/
+    WmsLiteLayerPtr lyr;
+    WmsLiteAttachedPtr db;
+    WmsLiteAttachedLayerPtr attLyr;
+
+    *timeout = config->RequestTimeout;
+    *max_pixels = config->MaxPixels;
+
+    lyr = config->MainFirst;
+    while (lyr != NULL)
+      {
+	  /* checking all Layers from MAIN */
+	  if (is_valid_wmslite_layer (lyr)
+	      && strcasecmp (layer_name, lyr->AliasName) == 0)
+	    {
+		if (lyr->Timeout >= 0.0)
+		    *timeout = lyr->Timeout;
+		if (lyr->MaxPixels >= 0)
+		    *max_pixels = lyr->MaxPixels;
+		return;
+	    }
+	  lyr = lyr->Next;
+      }
+
+    db = config->DbFirst;
+    while (db != NULL)
+      {
+	  /* checking all Layers from ATTACHED DBs */
+	  if (db->Valid == 0)
+	    {
+		/* skipping any invalid ATTACHED DB */
+		db = db->Next;
+		continue;
+	    }
+	  attLyr = db->First;
+	  while (attLyr != NULL)
+	    {
+		if (is_valid_wmslite_attached_layer (attLyr)
+		    && strcasecmp (layer_name, attLyr->AliasName) == 0)
+		  {
+		      if (attLyr->Timeout >= 0.0)
+			  *timeout = attLyr->Timeout;
+		      if (attLyr->MaxPixels >= 0)
+			  *max_pixels = attLyr->MaxPixels;
+		      return;
+		  }
+		attLyr = attLyr->Next;
+	    }
+	  db = db->Next;
+      }
+}
+
 static void
 do_bind_raster_vector_values (WmsLiteHttpRequestPtr req, sqlite3_stmt * stmt,
 			      const char *db_prefix, const char *coverage_name,
@@ -2136,10 +2223,13 @@ multiple_layer_request (WmsLiteHttpRequestPtr req, const unsigned char *payload,
       }
 }
 
-static void
+static int
 do_get_map (WmsLiteHttpRequestPtr req)
 {
-/* preparing the GetMap response */
+/* 
+/ preparing the GetMap response 
+/ returns 1 on success, 0 if an exception has been thrown
+*/
     WmsLiteStyledLayerPtr lyr;
     int layer_type;
     const char *db_prefix;
@@ -2147,6 +2237,9 @@ do_get_map (WmsLiteHttpRequestPtr req)
     sqlite3_stmt *stmt = NULL;
     int layer_count = 0;
     int valid = 0;
+    double timeout;
+    sqlite3_int64 max_pixels;
+    sqlite3_int64 pixels = (sqlite3_int64) (req->width) * req->height;
     rl2GraphicsContextPtr ctx_out = NULL;
     unsigned char *rgba_base = NULL;
 
@@ -2162,6 +2255,17 @@ do_get_map (WmsLiteHttpRequestPtr req)
       {
 	  /* counting how many Layers are in this GetMap request */
 	  layer_count++;
+	  do_find_layer_limits (req->config, lyr->LayerName, &timeout,
+				&max_pixels);
+	  if (max_pixels > 0 && pixels > max_pixels)
+	    {
+		/* exceeding the pixel budget of this Layer */
+		throw_exception (req,
+				 "WmsLite: GetMap WIDTH x HEIGHT exceeds the max pixels allowed for this Layer");
+		req->http_status = 200;
+		req->freeor = NULL;
+		return 0;
+	    }
 	  lyr = lyr->Next;
       }
 
@@ -2215,6 +2319,9 @@ do_get_map (WmsLiteHttpRequestPtr req)
 		int ret;
 		const unsigned char *payload = NULL;
 		int payload_size = 0;
+		do_find_layer_limits (req->config, lyr->LayerName, &timeout,
+				      &max_pixels);
+		rl2_set_request_timeout (req->conn->rl2_privdata, timeout);
 		while (1)
 		  {
 		      ret = sqlite3_step (stmt);
@@ -2250,7 +2357,11 @@ do_get_map (WmsLiteHttpRequestPtr req)
 				  valid++;
 			      }
 			}
+		      else
+			  break;	/* SQL error, or the request timed out */
 		  }
+		/* restoring the default deadline on this connection */
+		rl2_set_request_timeout (req->conn->rl2_privdata, 0.0);
 	    }
 	  else
 	    {
@@ -2266,6 +2377,7 @@ do_get_map (WmsLiteHttpRequestPtr req)
     if (layer_count > 1)
       {
 	  /* multiple layer request - creating the final MapImage */
+	  int ok = 0;
 	  if (valid != layer_count)
 	    {
 		/* throwing an exception */
@@ -2349,6 +2461,7 @@ do_get_map (WmsLiteHttpRequestPtr req)
 		      req->http_content_length = image_size;
 		      req->freeor = free;
 		      req->http_mime_type = req->format;
+		      ok = 1;
 		  }
 	    }
 	  if (ctx_out != NULL)
@@ -2357,7 +2470,7 @@ do_get_map (WmsLiteHttpRequestPtr req)
 		if (rgba_base != NULL)
 		    free (rgba_base);
 	    }
-	  return;
+	  return ok;
       }
 
 /* single layer request */
@@ -2368,13 +2481,142 @@ do_get_map (WmsLiteHttpRequestPtr req)
 			   "WmsLite internal error: GetMap unexpected NULL image");
 	  req->http_status = 200;
 	  req->freeor = NULL;
+	  return 0;
       }
-    else
+/* valid MapImage */
+    req->freeor = free;
+    req->http_mime_type = req->format;
+    return 1;
+}
+
+static char *
+build_get_map_key (WmsLiteHttpRequestPtr req)
+{
+/*
+/ building the normalized key identifying some GetMap request
+/ (based on the already parsed values, not on the raw URL)
+*/
+    char *key;
+    char *prev;
+    WmsLiteStyledLayerPtr lyr;
+    if (req->layers_list == NULL || req->bbox == NULL)
+	return NULL;
+    key =
+	sqlite3_mprintf ("%d|%d|%1.17g|%1.17g|%1.17g|%1.17g|%d|%d|%d|%d|%d|"
+			 "%02x%02x%02x|%d", req->ok_version, req->srid,
+			 req->bbox->MinX, req->bbox->MinY, req->bbox->MaxX,
+			 req->bbox->MaxY, req->width, req->height, req->format,
+			 req->transparent, req->reaspect, req->bg_red,
+			 req->bg_green, req->bg_blue, req->exceptions);
+    lyr = req->layers_list->first;
+    while (lyr != NULL)
+      {
+	  /* appending all Layer/Style pairs */
+	  prev = key;
+	  key =
+	      sqlite3_mprintf ("%s|%s:%s", prev,
+			       (lyr->LayerName == NULL) ? "" : lyr->LayerName,
+			       (lyr->StyleName == NULL) ? "" : lyr->StyleName);
+	  sqlite3_free (prev);
+	  lyr = lyr->Next;
+      }
+    return key;
+}
+
+static void
+attach_shared_response (WmsLiteHttpRequestPtr req,
+			WmsLiteSharedResponsePtr shared)
+{
+/* attaching a shared GetMap response to some HTTP request */
+    if (req->http_response != NULL)
+      {
+	  /* cleaning the http_response */
+	  if (req->freeor != NULL)
+	      req->freeor (req->http_response);
+      }
+    req->http_response = shared->payload;
+    req->freeor = NULL;
+    req->shared_response = shared;
+    req->http_content_length = shared->length;
+    req->http_mime_type = shared->mime_type;
+}
+
+static void
+do_coalesced_get_map (WmsLiteHttpRequestPtr req)
+{
+/* 
+/ preparing the GetMap response - coalescing identical requests
+/ (see wmslite_inflight.c)
+*/
+    char *key;
+    void *leader;
+    WmsLiteSharedResponsePtr shared;
+    int ok;
+
+    if (!req->config->IsMiniServer)
+      {
+	  /* CGI: a single request per process, nothing to coalesce */
+	  do_get_map (req);
+	  return;
+      }
+    key = build_get_map_key (req);
+    if (key == NULL)
+      {
+	  do_get_map (req);
+	  return;
+      }
+
+    if (!inflight_acquire (key, &leader, &shared))
+      {
+	  /* an identical request was already in-flight */
+	  if (shared != NULL)
+	      attach_shared_response (req, shared);
+	  else
+	    {
+		/* no shared response available: rendering on our own */
+		do_get_map (req);
+	    }
+	  return;
+      }
+
+    ok = do_get_map (req);
+
+    shared = NULL;
+    if (req->http_response != NULL)
       {
-	  /* valid MapImage */
-	  req->freeor = free;
-	  req->http_mime_type = req->format;
+	  /* wrapping the response as a reference counted buffer */
+	  shared = malloc (sizeof (WmsLiteSharedResponse));
+	  if (shared != NULL)
+	    {
+		shared->length = req->http_content_length;
+		shared->mime_type = req->http_mime_type;
+		if (ok && req->freeor != NULL)
+		  {
+		      /* the MapImage is shared with this request too */
+		      shared->payload = req->http_response;
+		      shared->freeor = req->freeor;
+		      shared->refcount = 1;
+		      req->freeor = NULL;
+		      req->shared_response = shared;
+		  }
+		else
+		  {
+		      /* the exception is copied for the waiters only */
+		      shared->payload = malloc (shared->length);
+		      shared->freeor = free;
+		      shared->refcount = 0;
+		      if (shared->payload == NULL)
+			{
+			    free (shared);
+			    shared = NULL;
+			}
+		      else
+			  memcpy (shared->payload, req->http_response,
+				  shared->length);
+		  }
+	    }
       }
+    inflight_publish (leader, shared);
 }
 
 static void
@@ -2727,12 +2969,14 @@ do_get_layer_legend (WmsLiteHttpRequestPtr req, int type, int sub_type, const ch
 		     "WmsLite internal error: GetLegendGraphics unexpected NULL image");
 }
 
-extern void
+void
 process_http_request (WmsLiteHttpRequestPtr req)
 {
 /* checking for a valid WMS request */
     int intval;
-    WmsLiteArgumentPtr arg = req->first_arg;
+    WmsLiteArgumentPtr arg;
+    parse_wmts_rest_url (req);
+    arg = req->first_arg;
     while (arg != NULL)
       {
 	  /* evaluating any critical argument */
@@ -2740,6 +2984,8 @@ process_http_request (WmsLiteHttpRequestPtr req)
 	    {
 		if (strcasecmp (arg->arg_value, "WMS") == 0)
 		    req->service_wms = 1;
+		if (strcasecmp (arg->arg_value, "WMTS") == 0)
+		    req->service_wmts = 1;
 	    }
 	  if (strcasecmp (arg->arg_name, "REQUEST") == 0)
 	    {
@@ -2778,6 +3024,8 @@ process_http_request (WmsLiteHttpRequestPtr req)
 		    req->request_type = WMS_GET_FEATURE_INFO;
 		if (strcasecmp (arg->arg_value, "GetLegendGraphic") == 0)
 		    req->request_type = WMS_GET_LEGEND_GRAPHIC;
+		if (strcasecmp (arg->arg_value, "GetTile") == 0)
+		    req->request_type = WMTS_GET_TILE;
 	    }
 	  if (strcasecmp (arg->arg_name, "LAYERS") == 0)
 	      req->param_layers = arg->arg_value;
@@ -2816,6 +3064,14 @@ process_http_request (WmsLiteHttpRequestPtr req)
 	  if (strcasecmp (arg->arg_name, "Y") == 0
 	      || strcasecmp (arg->arg_name, "J") == 0)
 	      req->param_point_y = arg->arg_value;
+	  if (strcasecmp (arg->arg_name, "TILEMATRIXSET") == 0)
+	      req->param_tile_matrix_set = arg->arg_value;
+	  if (strcasecmp (arg->arg_name, "TILEMATRIX") == 0)
+	      req->param_tile_matrix = arg->arg_value;
+	  if (strcasecmp (arg->arg_name, "TILEROW") == 0)
+	      req->param_tile_row = arg->arg_value;
+	  if (strcasecmp (arg->arg_name, "TILECOL") == 0)
+	      req->param_tile_col = arg->arg_value;
 	  if (strcasecmp (arg->arg_name, "EXCEPTIONS") == 0)
 	    {
 		req->exceptions = WMS_EXCEPTIONS_ERROR;
@@ -2837,6 +3093,13 @@ process_http_request (WmsLiteHttpRequestPtr req)
       }
     set_ok_version (req);
 
+    if (req->service_wmts)
+      {
+	  /* WMTS request - LAYER and STYLE are shared with GetLegendGraphic */
+	  process_wmts_request (req);
+	  return;
+      }
+
 /* attempting to validate the HTTP request */
     if (req->service_wms == 0)
       {
@@ -3485,7 +3748,7 @@ process_http_request (WmsLiteHttpRequestPtr req)
 	  do_get_capabilities (req);
 	  break;
       case WMS_GET_MAP:
-	  do_get_map (req);
+	  do_coalesced_get_map (req);
 	  break;
       case WMS_GET_FEATURE_INFO:
 	  throw_exception (req, "IT SHOULD BE AN XML");
@@ -3502,7 +3765,7 @@ process_http_request (WmsLiteHttpRequestPtr req)
     req->http_status = 200;
 }
 
-extern char *
+char *
 get_timestamp ()
 {
 /* returning the current timestamp */
@@ -3567,7 +3830,7 @@ get_timestamp ()
     return dummy;
 }
 
-extern void
+void
 do_update_logfile (WmsLiteHttpRequestPtr req)
 {
 /* updating the Logfile */
@@ -3578,7 +3841,7 @@ do_update_logfile (WmsLiteHttpRequestPtr req)
     fflush (stdout);
 }
 
-extern WmsLiteHttpRequestPtr
+WmsLiteHttpRequestPtr
 create_http_request (int id, WmsLiteConfigPtr config, const char *server_addr,
 		     int port_no, struct neutral_socket *socket)
 {
@@ -3604,6 +3867,7 @@ create_http_request (int id, WmsLiteConfigPtr config, const char *server_addr,
     req->http_status = -1;
     req->begin_time = get_timestamp ();
     req->service_wms = 0;
+    req->service_wmts = 0;
     req->request_type = 0;
     req->exceptions = WMS_EXCEPTIONS_DEFAULT;
     req->version_1 = 99;
@@ -3628,6 +3892,7 @@ create_http_request (int id, WmsLiteConfigPtr config, const char *server_addr,
     req->point_y = 0;
     req->http_response = NULL;
     req->freeor = NULL;
+    req->shared_response = NULL;
     req->http_content_length = 0;
     req->http_mime_type = 0;
     req->param_version = NULL;
@@ -3648,10 +3913,14 @@ create_http_request (int id, WmsLiteConfigPtr config, const char *server_addr,
     req->param_feature_count = NULL;
     req->param_point_x = NULL;
     req->param_point_y = NULL;
+    req->param_tile_matrix_set = NULL;
+    req->param_tile_matrix = NULL;
+    req->param_tile_row = NULL;
+    req->param_tile_col = NULL;
     return req;
 }
 
-extern void
+void
 destroy_http_request (WmsLiteHttpRequestPtr req)
 {
 /* memory cleanup: freeing an HTTP Request struct */
@@ -3691,5 +3960,7 @@ destroy_http_request (WmsLiteHttpRequestPtr req)
 	  if (req->freeor != NULL)
 	      req->freeor (req->http_response);
       }
+    if (req->shared_response != NULL)
+	release_shared_response (req->shared_response);
     free (req);
 }
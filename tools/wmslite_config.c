@@ -652,6 +652,8 @@ create_wmslite_layer (char type, const char *alias, const char *name, int child)
     lyr->Last = NULL;
     lyr->MinScaleDenominator = -1.0;
     lyr->MaxScaleDenominator = -1.0;
+    lyr->Timeout = -1.0;
+    lyr->MaxPixels = -1;
     lyr->ChildLayer = child;
     lyr->Next = NULL;
     return lyr;
@@ -783,6 +785,8 @@ create_wmslite_attached_layer (char type, const char *alias, const char *name,
     lyr->Vector = NULL;
     lyr->MinScaleDenominator = -1.0;
     lyr->MaxScaleDenominator = -1.0;
+    lyr->Timeout = -1.0;
+    lyr->MaxPixels = -1;
     lyr->ChildLayer = child;
     lyr->Next = NULL;
     return lyr;
@@ -868,6 +872,8 @@ create_wmslite_config (const char *path)
     config->PendingShutdown = 0;
     config->MultithreadEnabled = 0;
     config->MaxThreads = 1;
+    config->RequestTimeout = 0.0;
+    config->MaxPixels = 0;
     config->WmsMaxRetries = 5;
     config->WmsPause = 1000;
     config->BackgroundRed = 255;
@@ -2220,6 +2226,55 @@ parse_wmslite_multi_threading (xmlNodePtr node, WmsLiteConfigPtr config)
       }
 }
 
+static void
+parse_wmslite_request_limits (xmlNodePtr node, WmsLiteConfigPtr config)
+{
+/* parsing a <RequestLimits> tag */
+    const char *value;
+    struct _xmlAttr *attr = node->properties;
+    while (attr != NULL)
+      {
+	  /* attributes */
+	  if (attr->type == XML_ATTRIBUTE_NODE)
+	    {
+		const char *name = (const char *) (attr->name);
+		if (strcmp (name, "Timeout") == 0)
+		  {
+		      xmlNode *text = attr->children;
+		      config->RequestTimeout = 0.0;
+		      if (text != NULL)
+			{
+			    if (text->type == XML_TEXT_NODE)
+			      {
+				  value = (const char *) (text->content);
+				  if (value != NULL)
+				      config->RequestTimeout = atof (value);
+			      }
+			}
+		      if (config->RequestTimeout < 0.0)
+			  config->RequestTimeout = 0.0;
+		  }
+		if (strcmp (name, "MaxPixels") == 0)
+		  {
+		      xmlNode *text = attr->children;
+		      config->MaxPixels = 0;
+		      if (text != NULL)
+			{
+			    if (text->type == XML_TEXT_NODE)
+			      {
+				  value = (const char *) (text->content);
+				  if (value != NULL)
+				      config->MaxPixels = atoll (value);
+			      }
+			}
+		      if (config->MaxPixels < 0)
+			  config->MaxPixels = 0;
+		  }
+		attr = attr->next;
+	    }
+      }
+}
+
 static void
 parse_wmslite_background (xmlNodePtr node, WmsLiteConfigPtr config)
 {
@@ -2618,6 +2673,8 @@ parse_wmslite_options (xmlNodePtr node, WmsLiteConfigPtr config)
 		const char *name = (const char *) (node->name);
 		if (strcmp (name, "MultiThreading") == 0)
 		    parse_wmslite_multi_threading (node, config);
+		if (strcmp (name, "RequestLimits") == 0)
+		    parse_wmslite_request_limits (node, config);
 		if (strcmp (name, "WMS") == 0)
 		    parse_wmslite_wms (node, config);
 		if (strcmp (name, "Background") == 0)
@@ -2670,6 +2727,8 @@ parse_wmslite_layer (xmlNodePtr node, WmsLiteConfigPtr config)
     const char *lyr_name = NULL;
     char type;
     int child = 0;
+    double timeout = -1.0;
+    sqlite3_int64 max_pixels = -1;
     WmsLiteLayerPtr lyr;
     struct _xmlAttr *attr = node->properties;
     while (attr != NULL)
@@ -2763,12 +2822,42 @@ parse_wmslite_layer (xmlNodePtr node, WmsLiteConfigPtr config)
 			      }
 			}
 		  }
+		if (strcmp (name, "Timeout") == 0)
+		  {
+		      xmlNode *text = attr->children;
+		      timeout = -1.0;
+		      if (text != NULL)
+			{
+			    if (text->type == XML_TEXT_NODE)
+			      {
+				  value = (const char *) (text->content);
+				  if (value != NULL)
+				      timeout = atof (value);
+			      }
+			}
+		  }
+		if (strcmp (name, "MaxPixels") == 0)
+		  {
+		      xmlNode *text = attr->children;
+		      max_pixels = -1;
+		      if (text != NULL)
+			{
+			    if (text->type == XML_TEXT_NODE)
+			      {
+				  value = (const char *) (text->content);
+				  if (value != NULL)
+				      max_pixels = atoll (value);
+			      }
+			}
+		  }
 		attr = attr->next;
 	    }
       }
     lyr = add_wmslite_layer (config, type, alias, lyr_name, child);
     if (lyr == NULL)
 	return;
+    lyr->Timeout = timeout;
+    lyr->MaxPixels = max_pixels;
 
     node = node->children;
     while (node)
@@ -2793,6 +2882,9 @@ parse_wmslite_attached_layer (xmlNodePtr node, WmsLiteAttachedPtr db)
     const char *lyr_name = NULL;
     char type;
     int child = 0;
+    double timeout = -1.0;
+    sqlite3_int64 max_pixels = -1;
+    WmsLiteAttachedLayerPtr lyr;
     struct _xmlAttr *attr = node->properties;
     while (attr != NULL)
       {
@@ -2881,10 +2973,42 @@ parse_wmslite_attached_layer (xmlNodePtr node, WmsLiteAttachedPtr db)
 			      }
 			}
 		  }
+		if (strcmp (name, "Timeout") == 0)
+		  {
+		      xmlNode *text = attr->children;
+		      timeout = -1.0;
+		      if (text != NULL)
+			{
+			    if (text->type == XML_TEXT_NODE)
+			      {
+				  value = (const char *) (text->content);
+				  if (value != NULL)
+				      timeout = atof (value);
+			      }
+			}
+		  }
+		if (strcmp (name, "MaxPixels") == 0)
+		  {
+		      xmlNode *text = attr->children;
+		      max_pixels = -1;
+		      if (text != NULL)
+			{
+			    if (text->type == XML_TEXT_NODE)
+			      {
+				  value = (const char *) (text->content);
+				  if (value != NULL)
+				      max_pixels = atoll (value);
+			      }
+			}
+		  }
 		attr = attr->next;
 	    }
       }
-    add_wmslite_attached_layer (db, type, alias, lyr_name, child);
+    lyr = add_wmslite_attached_layer (db, type, alias, lyr_name, child);
+    if (lyr == NULL)
+	return;
+    lyr->Timeout = timeout;
+    lyr->MaxPixels = max_pixels;
 }
 
 static void
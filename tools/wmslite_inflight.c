@@ -0,0 +1,258 @@
+/*
+/ wmslite_inflight
+/
+/ a light-weight WMS server / GCI supporting RasterLite2 DataSources
+/ GetMap request coalescing
+/
+/ version 2.0, 2021 March 2
+/
+/ Author: Sandro Furieri a.furieri@lqt.it
+/
+/ Copyright (C) 2021  Alessandro Furieri
+/
+/    This program is free software: you can redistribute it and/or modify
+/    it under the terms of the GNU General Public License as published by
+/    the Free Software Foundation, either version 3 of the License, or
+/    (at your option) any later version.
+/
+/    This program is distributed in the hope that it will be useful,
+/    but WITHOUT ANY WARRANTY; without even the implied warranty of
+/    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/    GNU General Public License for more details.
+/
+/    You should have received a copy of the GNU General Public License
+/    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <sqlite3.h>
+
+#include "wmslite_inflight.h"
+
+/*
+/ GetMap request coalescing (singleflight)
+/
+/ concurrent identical GetMap requests (MiniServer only) wait for the
+/ first one (the leader) to complete, then share its encoded response
+/ buffer; a failure (exception, timeout) is shared as well, so that the
+/ waiters never render the same failing request all over again
+*/
+
+typedef struct wms_lite_inflight
+{
+/* a struct wrapping a GetMap request currently being rendered */
+    char *key;
+    int waiters;
+    int done;
+    WmsLiteSharedResponsePtr shared;
+#ifdef _WIN32
+    CONDITION_VARIABLE cond;
+#else
+    pthread_cond_t cond;
+#endif
+    struct wms_lite_inflight *next;
+} WmsLiteInflight;
+typedef WmsLiteInflight *WmsLiteInflightPtr;
+
+#ifdef _WIN32
+static SRWLOCK inflight_lock = SRWLOCK_INIT;
+#else
+static pthread_mutex_t inflight_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+static WmsLiteInflightPtr inflight_first = NULL;
+
+static void
+lock_inflight ()
+{
+/* locking the in-flight list */
+#ifdef _WIN32
+    AcquireSRWLockExclusive (&inflight_lock);
+#else
+    pthread_mutex_lock (&inflight_mutex);
+#endif
+}
+
+static void
+unlock_inflight ()
+{
+/* unlocking the in-flight list */
+#ifdef _WIN32
+    ReleaseSRWLockExclusive (&inflight_lock);
+#else
+    pthread_mutex_unlock (&inflight_mutex);
+#endif
+}
+
+static WmsLiteInflightPtr
+create_inflight (char *key)
+{
+/* creating an in-flight GetMap request (taking ownership of the key) */
+    WmsLiteInflightPtr entry = malloc (sizeof (WmsLiteInflight));
+    if (entry == NULL)
+	return NULL;
+    entry->key = key;
+    entry->waiters = 0;
+    entry->done = 0;
+    entry->shared = NULL;
+#ifdef _WIN32
+    InitializeConditionVariable (&(entry->cond));
+#else
+    pthread_cond_init (&(entry->cond), NULL);
+#endif
+    entry->next = NULL;
+    return entry;
+}
+
+static void
+destroy_inflight (WmsLiteInflightPtr entry)
+{
+/* memory cleanup - freeing an in-flight GetMap request */
+    if (entry->key != NULL)
+	sqlite3_free (entry->key);
+#ifndef _WIN32
+    pthread_cond_destroy (&(entry->cond));
+#endif
+    free (entry);
+}
+
+extern void
+release_shared_response (WmsLiteSharedResponsePtr shared)
+{
+/* releasing a reference to some shared GetMap response */
+    int last;
+    lock_inflight ();
+    shared->refcount -= 1;
+    last = (shared->refcount <= 0) ? 1 : 0;
+    unlock_inflight ();
+    if (!last)
+	return;
+    if (shared->payload != NULL && shared->freeor != NULL)
+	shared->freeor (shared->payload);
+    free (shared);
+}
+
+extern int
+inflight_acquire (char *key, void **leader, WmsLiteSharedResponsePtr * shared)
+{
+/* joining an identical in-flight request, or becoming its leader */
+    WmsLiteInflightPtr entry;
+
+    *leader = NULL;
+    *shared = NULL;
+    lock_inflight ();
+    entry = inflight_first;
+    while (entry != NULL)
+      {
+	  /* searching an identical request already in-flight */
+	  if (strcmp (entry->key, key) == 0)
+	      break;
+	  entry = entry->next;
+      }
+    if (entry != NULL)
+      {
+	  /* waiting for the leader to publish its response */
+	  sqlite3_free (key);
+	  entry->waiters += 1;
+	  while (!entry->done)
+	    {
+#ifdef _WIN32
+		SleepConditionVariableSRW (&(entry->cond), &inflight_lock,
+					   INFINITE, 0);
+#else
+		pthread_cond_wait (&(entry->cond), &inflight_mutex);
+#endif
+	    }
+	  *shared = entry->shared;
+	  entry->waiters -= 1;
+	  if (entry->waiters == 0)
+	      destroy_inflight (entry);
+	  unlock_inflight ();
+	  return 0;
+      }
+    entry = create_inflight (key);
+    if (entry == NULL)
+      {
+	  unlock_inflight ();
+	  sqlite3_free (key);
+	  return 1;
+      }
+    entry->next = inflight_first;
+    inflight_first = entry;
+    unlock_inflight ();
+    *leader = entry;
+    return 1;
+}
+
+extern void
+inflight_publish (void *leader, WmsLiteSharedResponsePtr shared)
+{
+/* publishing the leader's response to all waiters */
+    WmsLiteInflightPtr entry = (WmsLiteInflightPtr) leader;
+    WmsLiteInflightPtr prev;
+    int unused = 0;
+    if (entry == NULL)
+      {
+	  /* nothing was coalesced */
+	  if (shared != NULL && shared->refcount <= 0)
+	      unused = 1;
+	  goto end;
+      }
+
+    lock_inflight ();
+    /* removing from the in-flight list: any later request will render again */
+    if (inflight_first == entry)
+	inflight_first = entry->next;
+    else
+      {
+	  prev = inflight_first;
+	  while (prev != NULL)
+	    {
+		if (prev->next == entry)
+		  {
+		      prev->next = entry->next;
+		      break;
+		  }
+		prev = prev->next;
+	    }
+      }
+    entry->done = 1;
+    entry->shared = shared;
+    if (shared != NULL)
+      {
+	  shared->refcount += entry->waiters;
+	  if (shared->refcount <= 0)
+	    {
+		/* nobody is going to hold this response */
+		entry->shared = NULL;
+		unused = 1;
+	    }
+      }
+    if (entry->waiters == 0)
+	destroy_inflight (entry);
+    else
+      {
+#ifdef _WIN32
+	  WakeAllConditionVariable (&(entry->cond));
+#else
+	  pthread_cond_broadcast (&(entry->cond));
+#endif
+      }
+    unlock_inflight ();
+
+  end:
+    if (unused)
+      {
+	  if (shared->payload != NULL && shared->freeor != NULL)
+	      shared->freeor (shared->payload);
+	  free (shared);
+      }
+}
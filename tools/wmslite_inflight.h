@@ -0,0 +1,62 @@
+/* 
+/ wmslite_inflight - GetMap request coalescing
+/
+/ a light-weight WMS server / GCI supporting RasterLite2 DataSources
+/
+/ version 2.0, 2021 March 2
+/
+/ Author: Sandro Furieri a.furieri@lqt.it
+/
+/ Copyright (C) 2021  Alessandro Furieri
+/
+/    This program is free software: you can redistribute it and/or modify
+/    it under the terms of the GNU General Public License as published by
+/    the Free Software Foundation, either version 3 of the License, or
+/    (at your option) any later version.
+/
+/    This program is distributed in the hope that it will be useful,
+/    but WITHOUT ANY WARRANTY; without even the implied warranty of
+/    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/    GNU General Public License for more details.
+/
+/    You should have received a copy of the GNU General Public License
+/    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/
+*/
+
+#ifndef _WMSLITE_INFLIGHT_H
+#define _WMSLITE_INFLIGHT_H
+
+typedef struct wms_lite_shared_response
+{
+/* a struct wrapping a GetMap response shared by coalesced requests */
+    void *payload;
+    void (*freeor) (void *);
+    int length;
+    int mime_type;
+    int refcount;
+} WmsLiteSharedResponse;
+typedef WmsLiteSharedResponse *WmsLiteSharedResponsePtr;
+
+/*
+/ inflight_acquire() returns 1 when the caller is the leader: it must
+/ then render the response and always call inflight_publish() on the
+/ returned leader handle (a NULL leader handle means that nothing can be
+/ coalesced, and inflight_publish() is a no-op).
+/ it returns 0 when an identical request was already in-flight: the
+/ caller has been blocked until the leader published its response, and
+/ *shared is the response to be returned (possibly an exception), or
+/ NULL if the leader had nothing to share.
+/ the key is always taken over (freed by sqlite3_free).
+/
+/ the refcount of a published response must count the references
+/ still held by the leader (0 or 1): inflight_publish() adds one more
+/ reference for each waiter, and immediately frees a response that
+/ nobody is going to hold
+*/
+extern int inflight_acquire (char *key, void **leader,
+			     WmsLiteSharedResponsePtr * shared);
+extern void inflight_publish (void *leader, WmsLiteSharedResponsePtr shared);
+extern void release_shared_response (WmsLiteSharedResponsePtr shared);
+
+#endif /* _WMSLITE_INFLIGHT_H */
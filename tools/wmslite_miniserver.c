@@ -321,6 +321,12 @@ win32_http_request (void *data)
       case MIME_PDF:
 	  mime_type = "application/x-pdf";
 	  break;
+      case MIME_WEBP:
+	  mime_type = "image/webp";
+	  break;
+      case MIME_MVT:
+	  mime_type = "application/vnd.mapbox-vector-tile";
+	  break;
       default:
 	  mime_type = "text/plain; charset=UTF-8";
 	  break;
@@ -422,6 +428,12 @@ berkeley_http_request (void *data)
       case MIME_PDF:
 	  mime_type = "application/x-pdf";
 	  break;
+      case MIME_WEBP:
+	  mime_type = "image/webp";
+	  break;
+      case MIME_MVT:
+	  mime_type = "application/vnd.mapbox-vector-tile";
+	  break;
       default:
 	  mime_type = "text/plain; charset=UTF-8";
 	  break;
@@ -549,6 +561,11 @@ do_start_http (WmsLiteConfigPtr config, const char *ip_addr, int port_no,
 		config->MaxThreads);
     else
 	printf ("              RasterLite2 MaxThreads: 1\n");
+    if (config->RequestTimeout > 0.0)
+	printf ("              Request Timeout: %1.3f sec\n",
+		config->RequestTimeout);
+    if (config->MaxPixels > 0)
+	printf ("              Max Pixels: %lld\n", config->MaxPixels);
     printf
 	("================================================================================\n");
     printf ("HINT: test the following URL on your preferred web browser:\n\n");
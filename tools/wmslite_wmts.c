@@ -0,0 +1,1315 @@
+/*
+/ wmslite_wmts
+/
+/ a light-weight WMS server / GCI supporting RasterLite2 DataSources
+/ WMTS (KVP and REST) and XYZ (Web Mercator) tile endpoints
+/
+/ version 2.0, 2021 March 2
+/
+/ Author: Sandro Furieri a.furieri@lqt.it
+/
+/ Copyright (C) 2021  Alessandro Furieri
+/
+/    This program is free software: you can redistribute it and/or modify
+/    it under the terms of the GNU General Public License as published by
+/    the Free Software Foundation, either version 3 of the License, or
+/    (at your option) any later version.
+/
+/    This program is distributed in the hope that it will be useful,
+/    but WITHOUT ANY WARRANTY; without even the implied warranty of
+/    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/    GNU General Public License for more details.
+/
+/    You should have received a copy of the GNU General Public License
+/    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "wmslite.h"
+#include "rasterlite2_private.h"
+
+/*
+/ every Raster Coverage (not supporting mixed resolutions) exposes
+/ its own TileMatrixSet, identified by the Layer's AliasName:
+/
+/ - one TileMatrix for each Pyramid Level found in "<coverage>_levels"
+/   TileMatrix "0" always is the coarsest Pyramid Level
+/ - the TopLeftCorner always is the Coverage's own upper-left corner
+/ - TileWidth and TileHeight always are the Coverage's own tile size
+/
+/ so that any aligned tile exactly corresponds to a stored tile
+/ whenever the Coverage consists of a single Section
+/
+/ the XYZ endpoints (and the well-known "GoogleMapsCompatible" 
+/ TileMatrixSet) always adopt the EPSG:3857 256x256 global grid:
+/ - Vector Coverages are reprojected by RL2_GetVectorTile
+/ - Raster Coverages are never reprojected, so they are only
+/   available when their own SRID is EPSG:3857
+/
+/ WebP is never rendered: it's only served when the stored tile
+/ already is a WebP payload (passthrough), and it isn't advertised
+*/
+
+#define WMTS_METERS_PER_DEGREE	111319.49079327358
+#define WMTS_PIXEL_SIZE			0.00028
+#define WMTS_XYZ_MATRIX_SET		"GoogleMapsCompatible"
+#define WMTS_XYZ_WORLD_EXTENT	20037508.342789244
+#define WMTS_XYZ_TILE_SIZE		256
+
+typedef struct wmts_tile_matrix
+{
+/* a struct wrapping a WMTS TileMatrix */
+    int PyramidLevel;
+    double ResX;
+    double ResY;
+    int MatrixWidth;
+    int MatrixHeight;
+} WmtsTileMatrix;
+typedef WmtsTileMatrix *WmtsTileMatrixPtr;
+
+typedef struct wmts_tile_matrix_set
+{
+/* a struct wrapping a WMTS TileMatrixSet */
+    int Srid;
+    int IsGeographic;
+    int TileWidth;
+    int TileHeight;
+    double MinX;
+    double MinY;
+    double MaxX;
+    double MaxY;
+    int Count;
+    WmtsTileMatrixPtr Matrices;
+} WmtsTileMatrixSet;
+typedef WmtsTileMatrixSet *WmtsTileMatrixSetPtr;
+
+static void
+destroy_wmts_tile_matrix_set (WmtsTileMatrixSetPtr tms)
+{
+/* memory cleanup - destroying a TileMatrixSet */
+    if (tms == NULL)
+	return;
+    if (tms->Matrices != NULL)
+	free (tms->Matrices);
+    free (tms);
+}
+
+static WmtsTileMatrixSetPtr
+load_wmts_tile_matrix_set (sqlite3 * handle, const char *db_prefix,
+			   const char *coverage)
+{
+/* building the TileMatrixSet of some Raster Coverage */
+    WmtsTileMatrixSetPtr tms = NULL;
+    char *sql;
+    char *xdb_prefix;
+    char *xtable;
+    char *xxtable;
+    sqlite3_stmt *stmt = NULL;
+    int ret;
+    int ok = 0;
+    int count = 0;
+    int idx;
+
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+
+/* retrieving the Coverage basic definitions */
+    sql =
+	sqlite3_mprintf
+	("SELECT srid, tile_width, tile_height, extent_minx, extent_miny, "
+	 "extent_maxx, extent_maxy, mixed_resolutions, SridIsGeographic(srid) "
+	 "FROM \"%s\".raster_coverages WHERE Lower(coverage_name) = Lower(?)",
+	 xdb_prefix);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    sqlite3_bind_text (stmt, 1, coverage, strlen (coverage), SQLITE_STATIC);
+    while (1)
+      {
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;
+	  if (ret == SQLITE_ROW)
+	    {
+		if (sqlite3_column_type (stmt, 3) != SQLITE_FLOAT
+		    || sqlite3_column_type (stmt, 4) != SQLITE_FLOAT
+		    || sqlite3_column_type (stmt, 5) != SQLITE_FLOAT
+		    || sqlite3_column_type (stmt, 6) != SQLITE_FLOAT)
+		    continue;	/* undefined extent: empty Coverage */
+		if (sqlite3_column_int (stmt, 7) != 0)
+		    continue;	/* mixed resolutions: no TileMatrixSet */
+		tms = malloc (sizeof (WmtsTileMatrixSet));
+		tms->Srid = sqlite3_column_int (stmt, 0);
+		tms->TileWidth = sqlite3_column_int (stmt, 1);
+		tms->TileHeight = sqlite3_column_int (stmt, 2);
+		tms->MinX = sqlite3_column_double (stmt, 3);
+		tms->MinY = sqlite3_column_double (stmt, 4);
+		tms->MaxX = sqlite3_column_double (stmt, 5);
+		tms->MaxY = sqlite3_column_double (stmt, 6);
+		tms->IsGeographic = sqlite3_column_int (stmt, 8);
+		tms->Count = 0;
+		tms->Matrices = NULL;
+	    }
+	  else
+	      goto error;
+      }
+    sqlite3_finalize (stmt);
+    stmt = NULL;
+    if (tms == NULL)
+	goto error;
+
+/* retrieving all Pyramid Levels - from the coarsest to the finest one */
+    xtable = sqlite3_mprintf ("%s_levels", coverage);
+    xxtable = rl2_double_quoted_sql (xtable);
+    sqlite3_free (xtable);
+    sql =
+	sqlite3_mprintf
+	("SELECT pyramid_level, x_resolution_1_1, y_resolution_1_1 "
+	 "FROM \"%s\".\"%s\" ORDER BY pyramid_level DESC", xdb_prefix, xxtable);
+    free (xxtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    for (idx = 0; idx < 2; idx++)
+      {
+	  /* first pass: counting; second pass: loading */
+	  if (idx == 1)
+	    {
+		if (count == 0)
+		    goto error;
+		tms->Matrices = malloc (sizeof (WmtsTileMatrix) * count);
+		tms->Count = count;
+		count = 0;
+		sqlite3_reset (stmt);
+	    }
+	  while (1)
+	    {
+		ret = sqlite3_step (stmt);
+		if (ret == SQLITE_DONE)
+		    break;
+		if (ret == SQLITE_ROW)
+		  {
+		      WmtsTileMatrixPtr mtx;
+		      double span;
+		      if (idx == 0)
+			{
+			    count++;
+			    continue;
+			}
+		      if (count >= tms->Count)
+			  break;
+		      mtx = tms->Matrices + count++;
+		      mtx->PyramidLevel = sqlite3_column_int (stmt, 0);
+		      mtx->ResX = sqlite3_column_double (stmt, 1);
+		      mtx->ResY = sqlite3_column_double (stmt, 2);
+		      span = (double) (tms->TileWidth) * mtx->ResX;
+		      mtx->MatrixWidth =
+			  (int) ceil ((tms->MaxX - tms->MinX) / span);
+		      span = (double) (tms->TileHeight) * mtx->ResY;
+		      mtx->MatrixHeight =
+			  (int) ceil ((tms->MaxY - tms->MinY) / span);
+		      if (mtx->MatrixWidth < 1)
+			  mtx->MatrixWidth = 1;
+		      if (mtx->MatrixHeight < 1)
+			  mtx->MatrixHeight = 1;
+		  }
+		else
+		    goto error;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    stmt = NULL;
+    tms->Count = count;
+    ok = 1;
+
+  error:
+    if (stmt != NULL)
+	sqlite3_finalize (stmt);
+    free (xdb_prefix);
+    if (!ok)
+      {
+	  destroy_wmts_tile_matrix_set (tms);
+	  return NULL;
+      }
+    return tms;
+}
+
+static int
+parse_wmts_format (const char *format)
+{
+/* parsing a WMTS Format (MIME type or REST/XYZ file extension) */
+    if (format == NULL)
+	return MIME_PNG;
+    if (strcasecmp (format, "image/png") == 0
+	|| strcasecmp (format, "png") == 0)
+	return MIME_PNG;
+    if (strcasecmp (format, "image/jpeg") == 0
+	|| strcasecmp (format, "jpeg") == 0 || strcasecmp (format, "jpg") == 0)
+	return MIME_JPEG;
+    if (strcasecmp (format, "image/webp") == 0
+	|| strcasecmp (format, "webp") == 0)
+	return MIME_WEBP;
+    if (strcasecmp (format, "application/vnd.mapbox-vector-tile") == 0
+	|| strcasecmp (format, "mvt") == 0 || strcasecmp (format, "pbf") == 0)
+	return MIME_MVT;
+    return MIME_UNKNOWN;
+}
+
+static void
+throw_wmts_exception (WmsLiteHttpRequestPtr req, const char *code,
+		      const char *locator, const char *msg)
+{
+/* throwing an OWS ExceptionReport */
+    if (req->http_response != NULL)
+      {
+	  /* cleaning the http_response */
+	  if (req->freeor != NULL)
+	      req->freeor (req->http_response);
+	  req->http_response = NULL;
+      }
+    if (locator == NULL)
+	req->http_response =
+	    sqlite3_mprintf
+	    ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+	     "<ExceptionReport xmlns=\"http://www.opengis.net/ows/1.1\" "
+	     "version=\"1.1.0\">\r\n"
+	     "\t<Exception exceptionCode=\"%s\">\r\n"
+	     "\t\t<ExceptionText>%s</ExceptionText>\r\n"
+	     "\t</Exception>\r\n</ExceptionReport>\r\n", code, msg);
+    else
+	req->http_response =
+	    sqlite3_mprintf
+	    ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+	     "<ExceptionReport xmlns=\"http://www.opengis.net/ows/1.1\" "
+	     "version=\"1.1.0\">\r\n"
+	     "\t<Exception exceptionCode=\"%s\" locator=\"%s\">\r\n"
+	     "\t\t<ExceptionText>%s</ExceptionText>\r\n"
+	     "\t</Exception>\r\n</ExceptionReport>\r\n", code, locator, msg);
+    req->freeor = sqlite3_free;
+    req->http_content_length = strlen (req->http_response);
+    req->http_mime_type = MIME_XML;
+    req->http_status = 200;
+}
+
+static char *
+get_wmts_url_path (const char *request_url)
+{
+/* extracting the path component from the Request URL */
+    const char *start;
+    const char *end;
+    char *path;
+    int len;
+    if (request_url == NULL)
+	return NULL;
+    start = strchr (request_url, '/');
+    if (start == NULL)
+	return NULL;
+    end = start;
+    while (*end != '\0' && *end != '?' && *end != '#' && *end != ' ')
+	end++;
+    len = end - start;
+    path = malloc (len + 1);
+    memcpy (path, start, len);
+    *(path + len) = '\0';
+    return path;
+}
+
+static void
+add_wmts_argument (WmsLiteHttpRequestPtr req, const char *name,
+		   const char *value)
+{
+/* adding a KVP argument corresponding to some REST/XYZ path segment */
+    WmsLiteArgumentPtr arg;
+    char *xname = malloc (strlen (name) + 1);
+    strcpy (xname, name);
+    arg = alloc_wms_argument (xname, url_decode (req->conn->curl, value));
+    if (req->first_arg == NULL)
+	req->first_arg = arg;
+    if (req->last_arg != NULL)
+	req->last_arg->next = arg;
+    req->last_arg = arg;
+}
+
+extern int
+parse_wmts_rest_url (WmsLiteHttpRequestPtr req)
+{
+/*
+/ checking for a WMTS REST or XYZ Request URL
+/
+/ .../wmts/WMTSCapabilities.xml
+/ .../wmts/{Layer}/{Style}/{TileMatrixSet}/{TileMatrix}/{TileRow}/{TileCol}.{ext}
+/ .../xyz/{Layer}/{z}/{x}/{y}.{ext}
+/
+/ any recognized URL is translated into the equivalent KVP arguments;
+/ XYZ always refers to the EPSG:3857 "GoogleMapsCompatible" grid
+*/
+    char *path;
+    char *p;
+    char *ext;
+    char *segments[6];
+    int count = 0;
+    int xyz = 0;
+    int ok = 0;
+
+    path = get_wmts_url_path (req->request_url);
+    if (path == NULL)
+	return 0;
+    p = strstr (path, "/wmts/");
+    if (p != NULL)
+	p += 6;
+    else
+      {
+	  p = strstr (path, "/xyz/");
+	  if (p == NULL)
+	      goto end;
+	  p += 5;
+	  xyz = 1;
+      }
+
+    if (!xyz && strlen (p) >= 20
+	&& strcasecmp (p + strlen (p) - 20, "WMTSCapabilities.xml") == 0)
+      {
+	  /* REST GetCapabilities */
+	  add_wmts_argument (req, "SERVICE", "WMTS");
+	  add_wmts_argument (req, "REQUEST", "GetCapabilities");
+	  ok = 1;
+	  goto end;
+      }
+
+/* splitting the path into its segments */
+    while (*p != '\0' && count < 6)
+      {
+	  segments[count++] = p;
+	  p = strchr (p, '/');
+	  if (p == NULL)
+	      break;
+	  *p++ = '\0';
+      }
+    if (p != NULL && *p != '\0')
+	goto end;		/* too many segments */
+    if ((xyz && count != 4) || (!xyz && count != 6))
+	goto end;
+
+/* splitting the file extension from the last segment */
+    ext = strrchr (segments[count - 1], '.');
+    if (ext == NULL)
+	goto end;
+    *ext++ = '\0';
+
+    add_wmts_argument (req, "SERVICE", "WMTS");
+    add_wmts_argument (req, "REQUEST", "GetTile");
+    add_wmts_argument (req, "LAYER", segments[0]);
+    add_wmts_argument (req, "FORMAT", ext);
+    if (xyz)
+      {
+	  add_wmts_argument (req, "TILEMATRIXSET", WMTS_XYZ_MATRIX_SET);
+	  add_wmts_argument (req, "TILEMATRIX", segments[1]);
+	  add_wmts_argument (req, "TILECOL", segments[2]);
+	  add_wmts_argument (req, "TILEROW", segments[3]);
+      }
+    else
+      {
+	  add_wmts_argument (req, "STYLE", segments[1]);
+	  add_wmts_argument (req, "TILEMATRIXSET", segments[2]);
+	  add_wmts_argument (req, "TILEMATRIX", segments[3]);
+	  add_wmts_argument (req, "TILEROW", segments[4]);
+	  add_wmts_argument (req, "TILECOL", segments[5]);
+      }
+    ok = 1;
+
+  end:
+    free (path);
+    return ok;
+}
+
+static int
+is_wmts_default_style (const char *style)
+{
+/* checking for the default (unstyled) Style */
+    if (style == NULL)
+	return 1;
+    if (*style == '\0')
+	return 1;
+    if (strcasecmp (style, "default") == 0)
+	return 1;
+    return 0;
+}
+
+static int
+get_wmts_odd_payload (const unsigned char *blob, int blob_sz,
+		      const unsigned char **payload, int *payload_sz,
+		      int *mime_type)
+{
+/*
+/ checking if an OddBlock contains a self-standing JPEG, PNG or WebP
+/ image (UINT8 RGB, GRAYSCALE or PALETTE, no mask) and returning a 
+/ direct reference to its payload
+*/
+    const unsigned char *ptr;
+    int endian;
+    unsigned int compressed;
+    unsigned int compressed_mask;
+    if (blob_sz < 41)
+	return 0;
+    if (*(blob + 0) != 0x00 || *(blob + 1) != RL2_ODD_BLOCK_START)
+	return 0;
+    endian = *(blob + 2);
+    switch (*(blob + 3))
+      {
+      case RL2_COMPRESSION_JPEG:
+	  *mime_type = MIME_JPEG;
+	  break;
+      case RL2_COMPRESSION_PNG:
+	  *mime_type = MIME_PNG;
+	  break;
+      case RL2_COMPRESSION_LOSSY_WEBP:
+      case RL2_COMPRESSION_LOSSLESS_WEBP:
+	  *mime_type = MIME_WEBP;
+	  break;
+      default:
+	  return 0;
+      };
+    if (*(blob + 4) != RL2_SAMPLE_UINT8)
+	return 0;
+    switch (*(blob + 5))
+      {
+      case RL2_PIXEL_RGB:
+	  if (*(blob + 6) != 3)
+	      return 0;
+	  break;
+      case RL2_PIXEL_GRAYSCALE:
+      case RL2_PIXEL_PALETTE:
+	  if (*(blob + 6) != 1)
+	      return 0;
+	  break;
+      default:
+	  /* MONOCHROME, MULTIBAND or DATAGRID: requires rendering */
+	  return 0;
+      };
+    ptr = blob + 19;
+    if (endian == RL2_LITTLE_ENDIAN)
+      {
+	  compressed = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) |
+	      ((unsigned int) ptr[3] << 24);
+	  ptr += 8;
+	  compressed_mask = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) |
+	      ((unsigned int) ptr[3] << 24);
+      }
+    else
+      {
+	  compressed = ((unsigned int) ptr[0] << 24) | (ptr[1] << 16) |
+	      (ptr[2] << 8) | ptr[3];
+	  ptr += 8;
+	  compressed_mask = ((unsigned int) ptr[0] << 24) | (ptr[1] << 16) |
+	      (ptr[2] << 8) | ptr[3];
+      }
+    if (compressed_mask != 0)
+	return 0;		/* transparency mask: requires rendering */
+    if (*(blob + 31) != RL2_DATA_START)
+	return 0;
+    if ((unsigned int) blob_sz < 40 + compressed)
+	return 0;
+    if (*(blob + 32 + compressed) != RL2_DATA_END)
+	return 0;
+    *payload = blob + 32;
+    *payload_sz = compressed;
+    return 1;
+}
+
+static int
+is_wmts_passthrough_coverage (sqlite3 * handle, const char *db_prefix,
+			      const char *coverage)
+{
+/* 
+/ checking if the stored tiles of some Coverage could be directly 
+/ returned: UINT8 RGB, GRAYSCALE or PALETTE and no NoData
+*/
+    char *sql;
+    char *xdb_prefix;
+    sqlite3_stmt *stmt = NULL;
+    int ret;
+    int ok = 0;
+
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    sql =
+	sqlite3_mprintf
+	("SELECT sample_type, pixel_type, num_bands, nodata_pixel "
+	 "FROM \"%s\".raster_coverages WHERE Lower(coverage_name) = Lower(?)",
+	 xdb_prefix);
+    free (xdb_prefix);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    sqlite3_bind_text (stmt, 1, coverage, strlen (coverage), SQLITE_STATIC);
+    while (1)
+      {
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;
+	  if (ret == SQLITE_ROW)
+	    {
+		const char *sample =
+		    (const char *) sqlite3_column_text (stmt, 0);
+		const char *pixel =
+		    (const char *) sqlite3_column_text (stmt, 1);
+		int bands = sqlite3_column_int (stmt, 2);
+		if (sample == NULL || pixel == NULL)
+		    continue;
+		if (sqlite3_column_type (stmt, 3) != SQLITE_NULL)
+		    continue;	/* NoData: requires rendering */
+		if (strcasecmp (sample, "UINT8") != 0)
+		    continue;
+		if (strcasecmp (pixel, "RGB") == 0 && bands == 3)
+		    ok = 1;
+		if (strcasecmp (pixel, "GRAYSCALE") == 0 && bands == 1)
+		    ok = 1;
+		if (strcasecmp (pixel, "PALETTE") == 0 && bands == 1)
+		    ok = 1;
+	    }
+	  else
+	      break;
+      }
+    sqlite3_finalize (stmt);
+    return ok;
+}
+
+static int
+do_wmts_passthrough (WmsLiteHttpRequestPtr req, const char *db_prefix,
+		     const char *coverage, WmtsTileMatrixPtr mtx,
+		     double minx, double maxy, double maxx, double miny)
+{
+/* attempting to directly return a stored tile (no rendering at all) */
+    char *sql;
+    char *xdb_prefix;
+    char *xtiles;
+    char *xxtiles;
+    char *xdata;
+    char *xxdata;
+    sqlite3_stmt *stmt = NULL;
+    int ret;
+    int done = 0;
+    double cx = minx + ((maxx - minx) / 2.0);
+    double cy = miny + ((maxy - miny) / 2.0);
+    double tolerance_x = mtx->ResX / 2.0;
+    double tolerance_y = mtx->ResY / 2.0;
+
+    if (db_prefix == NULL)
+	db_prefix = "main";
+    if (!is_wmts_passthrough_coverage (req->conn->handle, db_prefix, coverage))
+	return 0;
+    xdb_prefix = rl2_double_quoted_sql (db_prefix);
+    xtiles = sqlite3_mprintf ("%s_tiles", coverage);
+    xxtiles = rl2_double_quoted_sql (xtiles);
+    sqlite3_free (xtiles);
+    xdata = sqlite3_mprintf ("%s_tile_data", coverage);
+    xxdata = rl2_double_quoted_sql (xdata);
+    sqlite3_free (xdata);
+    xtiles = sqlite3_mprintf ("DB=%s.%s_tiles", db_prefix, coverage);
+    sql =
+	sqlite3_mprintf
+	("SELECT d.tile_data_odd, d.tile_data_even, MbrMinX(t.geometry), "
+	 "MbrMaxY(t.geometry) FROM \"%s\".\"%s\" AS t "
+	 "JOIN \"%s\".\"%s\" AS d ON (d.tile_id = t.tile_id) "
+	 "WHERE t.pyramid_level = ? AND t.ROWID IN ( "
+	 "SELECT ROWID FROM SpatialIndex WHERE f_table_name = %Q "
+	 "AND search_frame = BuildMBR(?, ?, ?, ?))", xdb_prefix, xxtiles,
+	 xdb_prefix, xxdata, xtiles);
+    sqlite3_free (xtiles);
+    free (xdb_prefix);
+    free (xxtiles);
+    free (xxdata);
+    ret = sqlite3_prepare_v2 (req->conn->handle, sql, strlen (sql), &stmt,
+			      NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+
+/* searching the stored tile covering the center of the requested tile */
+    sqlite3_bind_int (stmt, 1, mtx->PyramidLevel);
+    sqlite3_bind_double (stmt, 2, cx - tolerance_x);
+    sqlite3_bind_double (stmt, 3, cy - tolerance_y);
+    sqlite3_bind_double (stmt, 4, cx + tolerance_x);
+    sqlite3_bind_double (stmt, 5, cy + tolerance_y);
+    while (1)
+      {
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;
+	  if (ret == SQLITE_ROW)
+	    {
+		const unsigned char *blob;
+		int blob_sz;
+		const unsigned char *payload;
+		int payload_sz;
+		int mime_type;
+		double tile_minx = sqlite3_column_double (stmt, 2);
+		double tile_maxy = sqlite3_column_double (stmt, 3);
+		if (fabs (tile_minx - minx) > tolerance_x
+		    || fabs (tile_maxy - maxy) > tolerance_y)
+		    continue;	/* not aligned to the TileMatrix */
+		if (sqlite3_column_type (stmt, 0) != SQLITE_BLOB)
+		    continue;
+		if (sqlite3_column_type (stmt, 1) != SQLITE_NULL)
+		    continue;	/* Odd/Even interlaced: requires decoding */
+		blob = sqlite3_column_blob (stmt, 0);
+		blob_sz = sqlite3_column_bytes (stmt, 0);
+		if (!get_wmts_odd_payload
+		    (blob, blob_sz, &payload, &payload_sz, &mime_type))
+		    continue;
+		if (mime_type != req->format)
+		    continue;	/* format mismatch: requires rendering */
+		if (req->http_response != NULL)
+		  {
+		      if (req->freeor != NULL)
+			  req->freeor (req->http_response);
+		  }
+		req->http_response = malloc (payload_sz);
+		memcpy (req->http_response, payload, payload_sz);
+		req->http_content_length = payload_sz;
+		req->freeor = free;
+		req->http_mime_type = mime_type;
+		done = 1;
+		break;
+	    }
+	  else
+	      break;
+      }
+    sqlite3_finalize (stmt);
+    return done;
+}
+
+static int
+do_wmts_render (WmsLiteHttpRequestPtr req, const char *db_prefix,
+		const char *coverage, WmtsTileMatrixSetPtr tms,
+		double minx, double miny, double maxx, double maxy)
+{
+/* rendering the requested tile by calling RL2_GetMapImageFromRaster */
+    sqlite3_stmt *stmt = req->conn->stmt_raster;
+    const char *style = req->param_legend_style;
+    const char *format;
+    int mime_type;
+    int ret;
+    int done = 0;
+    double timeout;
+    sqlite3_int64 max_pixels;
+    if (stmt == NULL)
+	return 0;
+    if (req->format == MIME_JPEG)
+      {
+	  format = "image/jpeg";
+	  mime_type = MIME_JPEG;
+      }
+    else if (req->format == MIME_PNG)
+      {
+	  format = "image/png";
+	  mime_type = MIME_PNG;
+      }
+    else
+	return 0;		/* WebP can't be rendered */
+    if (is_wmts_default_style (style))
+	style = "default";
+    sqlite3_reset (stmt);
+    sqlite3_clear_bindings (stmt);
+    if (db_prefix == NULL)
+	sqlite3_bind_null (stmt, 1);
+    else
+	sqlite3_bind_text (stmt, 1, db_prefix, strlen (db_prefix),
+			   SQLITE_STATIC);
+    sqlite3_bind_text (stmt, 2, coverage, strlen (coverage), SQLITE_STATIC);
+    sqlite3_bind_double (stmt, 3, minx);
+    sqlite3_bind_double (stmt, 4, miny);
+    sqlite3_bind_double (stmt, 5, maxx);
+    sqlite3_bind_double (stmt, 6, maxy);
+    sqlite3_bind_int (stmt, 7, tms->Srid);
+    sqlite3_bind_int (stmt, 8, tms->TileWidth);
+    sqlite3_bind_int (stmt, 9, tms->TileHeight);
+    sqlite3_bind_text (stmt, 10, style, strlen (style), SQLITE_STATIC);
+    sqlite3_bind_text (stmt, 11, format, strlen (format), SQLITE_STATIC);
+    sqlite3_bind_text (stmt, 12, "#ffffff", 7, SQLITE_STATIC);
+    sqlite3_bind_int (stmt, 13, (mime_type == MIME_PNG) ? 1 : 0);
+    sqlite3_bind_int (stmt, 14, (mime_type == MIME_JPEG) ? 80 : 100);
+    sqlite3_bind_int (stmt, 15, 0);
+    do_find_layer_limits (req->config, req->param_legend_layer, &timeout,
+			  &max_pixels);
+    rl2_set_request_timeout (req->conn->rl2_privdata, timeout);
+    while (1)
+      {
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;
+	  if (ret == SQLITE_ROW)
+	    {
+		if (sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+		  {
+		      const unsigned char *payload =
+			  sqlite3_column_blob (stmt, 0);
+		      int payload_sz = sqlite3_column_bytes (stmt, 0);
+		      if (req->http_response != NULL)
+			{
+			    if (req->freeor != NULL)
+				req->freeor (req->http_response);
+			}
+		      req->http_response = malloc (payload_sz);
+		      memcpy (req->http_response, payload, payload_sz);
+		      req->http_content_length = payload_sz;
+		      req->freeor = free;
+		      req->http_mime_type = mime_type;
+		      done = 1;
+		  }
+	    }
+	  else
+	      break;
+      }
+    sqlite3_reset (stmt);
+    rl2_set_request_timeout (req->conn->rl2_privdata, 0.0);
+    return done;
+}
+
+static int
+do_wmts_vector_tile (WmsLiteHttpRequestPtr req, const char *db_prefix,
+		     const char *coverage, int zoom, int col, int row)
+{
+/* encoding the requested Vector Tile by calling RL2_GetVectorTile */
+    sqlite3_stmt *stmt = req->conn->stmt_mvt;
+    int ret;
+    int done = 0;
+    double timeout;
+    sqlite3_int64 max_pixels;
+    if (stmt == NULL)
+	return 0;
+    sqlite3_reset (stmt);
+    sqlite3_clear_bindings (stmt);
+    if (db_prefix == NULL)
+	sqlite3_bind_null (stmt, 1);
+    else
+	sqlite3_bind_text (stmt, 1, db_prefix, strlen (db_prefix),
+			   SQLITE_STATIC);
+    sqlite3_bind_text (stmt, 2, coverage, strlen (coverage), SQLITE_STATIC);
+    sqlite3_bind_int (stmt, 3, zoom);
+    sqlite3_bind_int (stmt, 4, col);
+    sqlite3_bind_int (stmt, 5, row);
+    do_find_layer_limits (req->config, req->param_legend_layer, &timeout,
+			  &max_pixels);
+    rl2_set_request_timeout (req->conn->rl2_privdata, timeout);
+    while (1)
+      {
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;
+	  if (ret == SQLITE_ROW)
+	    {
+		if (sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+		  {
+		      /* an empty Tile is a valid zero length payload */
+		      const unsigned char *payload =
+			  sqlite3_column_blob (stmt, 0);
+		      int payload_sz = sqlite3_column_bytes (stmt, 0);
+		      if (req->http_response != NULL)
+			{
+			    if (req->freeor != NULL)
+				req->freeor (req->http_response);
+			}
+		      req->http_response = malloc (payload_sz + 1);
+		      if (payload_sz > 0)
+			  memcpy (req->http_response, payload, payload_sz);
+		      req->http_content_length = payload_sz;
+		      req->freeor = free;
+		      req->http_mime_type = MIME_MVT;
+		      done = 1;
+		  }
+	    }
+	  else
+	      break;
+      }
+    sqlite3_reset (stmt);
+    rl2_set_request_timeout (req->conn->rl2_privdata, 0.0);
+    return done;
+}
+
+static int
+parse_wmts_int (const char *str, int *value)
+{
+/* parsing a strictly numeric (non negative) WMTS argument */
+    const char *p = str;
+    if (str == NULL || *str == '\0')
+	return 0;
+    while (*p != '\0')
+      {
+	  if (*p < '0' || *p > '9')
+	      return 0;
+	  p++;
+      }
+    *value = atoi (str);
+    return 1;
+}
+
+static void
+do_wmts_get_tile (WmsLiteHttpRequestPtr req)
+{
+/* preparing the GetTile response */
+    int layer_type;
+    const char *db_prefix;
+    const char *coverage;
+    WmtsTileMatrixSetPtr tms;
+    WmtsTileMatrixPtr mtx;
+    int zoom;
+    int row;
+    int col;
+    double minx;
+    double miny;
+    double maxx;
+    double maxy;
+    char *msg;
+    int is_vector = 0;
+    int is_xyz = 0;
+
+    if (req->param_legend_layer == NULL || *(req->param_legend_layer) == '\0')
+      {
+	  throw_wmts_exception (req, "MissingParameterValue", "LAYER",
+				"WMTS GetTile: missing LAYER parameter");
+	  return;
+      }
+    do_find_layer (req->config, req->param_legend_layer, &layer_type,
+		   &db_prefix, &coverage);
+    if (layer_type == WMS_MAIN_VECTOR || layer_type == WMS_ATTACH_VECTOR)
+	is_vector = 1;
+    else if (layer_type != WMS_MAIN_RASTER && layer_type != WMS_ATTACH_RASTER)
+      {
+	  throw_wmts_exception (req, "InvalidParameterValue", "LAYER",
+				"WMTS GetTile: unknown or not tiled LAYER");
+	  return;
+      }
+    if (req->param_tile_matrix_set != NULL
+	&& strcasecmp (req->param_tile_matrix_set, WMTS_XYZ_MATRIX_SET) == 0)
+	is_xyz = 1;
+    else if (req->param_tile_matrix_set != NULL
+	     && strcasecmp (req->param_tile_matrix_set,
+			    req->param_legend_layer) != 0)
+      {
+	  throw_wmts_exception (req, "InvalidParameterValue", "TILEMATRIXSET",
+				"WMTS GetTile: unknown TILEMATRIXSET");
+	  return;
+      }
+    req->format = parse_wmts_format (req->param_format);
+    if (is_vector && req->param_format == NULL)
+	req->format = MIME_MVT;
+    if (req->format == MIME_UNKNOWN || (is_vector && req->format != MIME_MVT)
+	|| (!is_vector && req->format == MIME_MVT))
+      {
+	  throw_wmts_exception (req, "InvalidParameterValue", "FORMAT",
+				"WMTS GetTile: unsupported FORMAT");
+	  return;
+      }
+    if (!parse_wmts_int (req->param_tile_matrix, &zoom)
+	|| !parse_wmts_int (req->param_tile_row, &row)
+	|| !parse_wmts_int (req->param_tile_col, &col))
+      {
+	  throw_wmts_exception (req, "MissingParameterValue", NULL,
+				"WMTS GetTile: missing or invalid TILEMATRIX, TILEROW or TILECOL");
+	  return;
+      }
+
+    if (is_vector)
+      {
+	  /* Vector Tiles always adopt the XYZ (EPSG:3857) tiling scheme */
+	  if (zoom > 30 || row >= (1 << zoom) || col >= (1 << zoom))
+	    {
+		throw_wmts_exception (req, "TileOutOfRange", NULL,
+				      "WMTS GetTile: TILEMATRIX, TILEROW or TILECOL out of range");
+		return;
+	    }
+	  if (!do_wmts_vector_tile (req, db_prefix, coverage, zoom, col, row))
+	      throw_wmts_exception (req, "NoApplicableCode", NULL,
+				    "WmsLite internal error: GetTile unexpected NULL Vector Tile");
+	  req->http_status = 200;
+	  return;
+      }
+
+    tms = load_wmts_tile_matrix_set (req->conn->handle, db_prefix, coverage);
+    if (tms == NULL)
+      {
+	  throw_wmts_exception (req, "InvalidParameterValue", "LAYER",
+				"WMTS GetTile: no TileMatrixSet available for this LAYER");
+	  return;
+      }
+    if (!is_xyz && zoom >= tms->Count)
+      {
+	  throw_wmts_exception (req, "InvalidParameterValue", "TILEMATRIX",
+				"WMTS GetTile: unknown TILEMATRIX");
+	  destroy_wmts_tile_matrix_set (tms);
+	  return;
+      }
+    if (is_xyz)
+      {
+	  /* the EPSG:3857 global grid: never reprojecting a Raster */
+	  double size;
+	  if (tms->Srid != 3857)
+	    {
+		throw_wmts_exception (req, "InvalidParameterValue",
+				      "TILEMATRIXSET",
+				      "WMTS GetTile: XYZ tiles require an EPSG:3857 Raster Coverage");
+		destroy_wmts_tile_matrix_set (tms);
+		return;
+	    }
+	  if (zoom > 30 || row >= (1 << zoom) || col >= (1 << zoom))
+	    {
+		throw_wmts_exception (req, "TileOutOfRange", NULL,
+				      "WMTS GetTile: TILEMATRIX, TILEROW or TILECOL out of range");
+		destroy_wmts_tile_matrix_set (tms);
+		return;
+	    }
+	  if (req->format == MIME_WEBP)
+	    {
+		throw_wmts_exception (req, "InvalidParameterValue", "FORMAT",
+				      "WMTS GetTile: WebP XYZ tiles are not supported");
+		destroy_wmts_tile_matrix_set (tms);
+		return;
+	    }
+	  size = (WMTS_XYZ_WORLD_EXTENT * 2.0) / (double) (1 << zoom);
+	  minx = (0.0 - WMTS_XYZ_WORLD_EXTENT) + ((double) col * size);
+	  maxx = minx + size;
+	  maxy = WMTS_XYZ_WORLD_EXTENT - ((double) row * size);
+	  miny = maxy - size;
+	  tms->TileWidth = WMTS_XYZ_TILE_SIZE;
+	  tms->TileHeight = WMTS_XYZ_TILE_SIZE;
+	  if (!do_wmts_render
+	      (req, db_prefix, coverage, tms, minx, miny, maxx, maxy))
+	      throw_wmts_exception (req, "NoApplicableCode", NULL,
+				    "WmsLite internal error: GetTile unexpected NULL image");
+	  destroy_wmts_tile_matrix_set (tms);
+	  req->http_status = 200;
+	  return;
+      }
+    mtx = tms->Matrices + zoom;
+    if (row >= mtx->MatrixHeight || col >= mtx->MatrixWidth)
+      {
+	  msg =
+	      sqlite3_mprintf
+	      ("WMTS GetTile: TILEROW must be between 0 and %d, TILECOL must be between 0 and %d",
+	       mtx->MatrixHeight - 1, mtx->MatrixWidth - 1);
+	  throw_wmts_exception (req, "TileOutOfRange", NULL, msg);
+	  sqlite3_free (msg);
+	  destroy_wmts_tile_matrix_set (tms);
+	  return;
+      }
+
+/* computing the tile extent */
+    minx = tms->MinX + ((double) col * (double) (tms->TileWidth) * mtx->ResX);
+    maxx = minx + ((double) (tms->TileWidth) * mtx->ResX);
+    maxy = tms->MaxY - ((double) row * (double) (tms->TileHeight) * mtx->ResY);
+    miny = maxy - ((double) (tms->TileHeight) * mtx->ResY);
+
+    if (is_wmts_default_style (req->param_legend_style))
+      {
+	  /* aligned and unstyled: attempting to stream the stored tile */
+	  if (do_wmts_passthrough
+	      (req, db_prefix, coverage, mtx, minx, maxy, maxx, miny))
+	    {
+		destroy_wmts_tile_matrix_set (tms);
+		req->http_status = 200;
+		return;
+	    }
+      }
+    if (req->format == MIME_WEBP)
+      {
+	  throw_wmts_exception (req, "InvalidParameterValue", "FORMAT",
+				"WMTS GetTile: WebP is only available for tiles stored as WebP");
+	  destroy_wmts_tile_matrix_set (tms);
+	  return;
+      }
+    if (!do_wmts_render (req, db_prefix, coverage, tms, minx, miny, maxx,
+			 maxy))
+	throw_wmts_exception (req, "NoApplicableCode", NULL,
+			      "WmsLite internal error: GetTile unexpected NULL image");
+    destroy_wmts_tile_matrix_set (tms);
+    req->http_status = 200;
+}
+
+static char *
+get_wmts_base_url (WmsLiteConfigPtr config)
+{
+/* returning the base URL (OnlineResource, no query string) */
+    char *url;
+    char *p;
+    int len;
+    const char *online = config->OnlineResource;
+    if (online == NULL)
+	online = "http://127.0.0.1/";
+    len = strlen (online);
+    url = malloc (len + 1);
+    strcpy (url, online);
+    p = strchr (url, '?');
+    if (p != NULL)
+	*p = '\0';
+    len = strlen (url);
+    while (len > 0 && *(url + len - 1) == '/')
+	*(url + --len) = '\0';
+    return url;
+}
+
+static char *
+wmts_clean_xml (const char *dirty)
+{
+/* masking any illegal XML char */
+    char *clean;
+    char *out;
+    const char *in;
+    int count = 0;
+    for (in = dirty; *in != '\0'; in++)
+      {
+	  if (*in == '<' || *in == '>' || *in == '&' || *in == '"')
+	      count++;
+      }
+    if (count == 0)
+	return sqlite3_mprintf ("%s", dirty);
+    clean = sqlite3_malloc (strlen (dirty) + (count * 6) + 1);
+    out = clean;
+    for (in = dirty; *in != '\0'; in++)
+      {
+	  switch (*in)
+	    {
+	    case '<':
+		strcpy (out, "&lt;");
+		out += 4;
+		break;
+	    case '>':
+		strcpy (out, "&gt;");
+		out += 4;
+		break;
+	    case '&':
+		strcpy (out, "&amp;");
+		out += 5;
+		break;
+	    case '"':
+		strcpy (out, "&quot;");
+		out += 6;
+		break;
+	    default:
+		*out++ = *in;
+		break;
+	    };
+      }
+    *out = '\0';
+    return clean;
+}
+
+static char *
+wmts_capabilities_layer (sqlite3 * handle, char *xml, const char *base_url,
+			 const char *alias_name, const char *title,
+			 const char *db_prefix, const char *coverage,
+			 char **matrix_sets)
+{
+/* appending a Layer and its TileMatrixSet to the Capabilities */
+    char *prev;
+    char *name;
+    char *xtitle;
+    char *tms_xml;
+    int i;
+    double meters_per_unit;
+    WmtsTileMatrixSetPtr tms =
+	load_wmts_tile_matrix_set (handle, db_prefix, coverage);
+    if (tms == NULL)
+	return xml;
+    name = wmts_clean_xml (alias_name);
+    xtitle = wmts_clean_xml ((title == NULL) ? alias_name : title);
+    prev = xml;
+    xml =
+	sqlite3_mprintf
+	("%s\t\t<Layer>\r\n\t\t\t<ows:Title>%s</ows:Title>\r\n"
+	 "\t\t\t<ows:Identifier>%s</ows:Identifier>\r\n"
+	 "\t\t\t<ows:BoundingBox crs=\"urn:ogc:def:crs:EPSG::%d\">\r\n"
+	 "\t\t\t\t<ows:LowerCorner>%1.8f %1.8f</ows:LowerCorner>\r\n"
+	 "\t\t\t\t<ows:UpperCorner>%1.8f %1.8f</ows:UpperCorner>\r\n"
+	 "\t\t\t</ows:BoundingBox>\r\n"
+	 "\t\t\t<Style isDefault=\"true\">\r\n"
+	 "\t\t\t\t<ows:Identifier>default</ows:Identifier>\r\n"
+	 "\t\t\t</Style>\r\n"
+	 "\t\t\t<Format>image/png</Format>\r\n"
+	 "\t\t\t<Format>image/jpeg</Format>\r\n"
+	 "\t\t\t<TileMatrixSetLink>\r\n"
+	 "\t\t\t\t<TileMatrixSet>%s</TileMatrixSet>\r\n"
+	 "\t\t\t</TileMatrixSetLink>\r\n"
+	 "\t\t\t<ResourceURL format=\"image/png\" resourceType=\"tile\" "
+	 "template=\"%s/wmts/%s/{Style}/{TileMatrixSet}/{TileMatrix}/{TileRow}/{TileCol}.png\"/>\r\n"
+	 "\t\t\t<ResourceURL format=\"image/jpeg\" resourceType=\"tile\" "
+	 "template=\"%s/wmts/%s/{Style}/{TileMatrixSet}/{TileMatrix}/{TileRow}/{TileCol}.jpg\"/>\r\n"
+	 "\t\t</Layer>\r\n", prev, xtitle, name, tms->Srid, tms->MinX,
+	 tms->MinY, tms->MaxX, tms->MaxY, name, base_url, name, base_url,
+	 name);
+    sqlite3_free (prev);
+    sqlite3_free (xtitle);
+
+/* preparing the corresponding TileMatrixSet */
+    if (tms->IsGeographic)
+	meters_per_unit = WMTS_METERS_PER_DEGREE;
+    else
+	meters_per_unit = 1.0;
+    tms_xml =
+	sqlite3_mprintf
+	("%s\t\t<TileMatrixSet>\r\n\t\t\t<ows:Identifier>%s</ows:Identifier>\r\n"
+	 "\t\t\t<ows:SupportedCRS>urn:ogc:def:crs:EPSG::%d</ows:SupportedCRS>\r\n",
+	 *matrix_sets, name, tms->Srid);
+    sqlite3_free (*matrix_sets);
+    for (i = 0; i < tms->Count; i++)
+      {
+	  WmtsTileMatrixPtr mtx = tms->Matrices + i;
+	  double scale = (mtx->ResX * meters_per_unit) / WMTS_PIXEL_SIZE;
+	  double corner_1 = tms->MinX;
+	  double corner_2 = tms->MaxY;
+	  if (tms->IsGeographic)
+	    {
+		/* EPSG axis order: Latitude first */
+		corner_1 = tms->MaxY;
+		corner_2 = tms->MinX;
+	    }
+	  prev = tms_xml;
+	  tms_xml =
+	      sqlite3_mprintf
+	      ("%s\t\t\t<TileMatrix>\r\n\t\t\t\t<ows:Identifier>%d</ows:Identifier>\r\n"
+	       "\t\t\t\t<ScaleDenominator>%1.8f</ScaleDenominator>\r\n"
+	       "\t\t\t\t<TopLeftCorner>%1.8f %1.8f</TopLeftCorner>\r\n"
+	       "\t\t\t\t<TileWidth>%d</TileWidth>\r\n"
+	       "\t\t\t\t<TileHeight>%d</TileHeight>\r\n"
+	       "\t\t\t\t<MatrixWidth>%d</MatrixWidth>\r\n"
+	       "\t\t\t\t<MatrixHeight>%d</MatrixHeight>\r\n"
+	       "\t\t\t</TileMatrix>\r\n", prev, i, scale, corner_1, corner_2,
+	       tms->TileWidth, tms->TileHeight, mtx->MatrixWidth,
+	       mtx->MatrixHeight);
+	  sqlite3_free (prev);
+      }
+    *matrix_sets = sqlite3_mprintf ("%s\t\t</TileMatrixSet>\r\n", tms_xml);
+    sqlite3_free (tms_xml);
+    sqlite3_free (name);
+    destroy_wmts_tile_matrix_set (tms);
+    return xml;
+}
+
+static void
+do_wmts_get_capabilities (WmsLiteHttpRequestPtr req)
+{
+/* preparing the WMTS GetCapabilities response */
+    char *xml;
+    char *prev;
+    char *matrix_sets;
+    char *base_url;
+    char *title;
+    WmsLiteLayerPtr lyr;
+    WmsLiteAttachedPtr db;
+    WmsLiteAttachedLayerPtr attLyr;
+
+    base_url = get_wmts_base_url (req->config);
+    title =
+	wmts_clean_xml ((req->config->Title ==
+			 NULL) ? "WmsLite" : req->config->Title);
+    xml =
+	sqlite3_mprintf
+	("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+	 "<Capabilities xmlns=\"http://www.opengis.net/wmts/1.0\" "
+	 "xmlns:ows=\"http://www.opengis.net/ows/1.1\" "
+	 "xmlns:xlink=\"http://www.w3.org/1999/xlink\" version=\"1.0.0\">\r\n"
+	 "\t<ows:ServiceIdentification>\r\n"
+	 "\t\t<ows:Title>%s</ows:Title>\r\n"
+	 "\t\t<ows:ServiceType>OGC WMTS</ows:ServiceType>\r\n"
+	 "\t\t<ows:ServiceTypeVersion>1.0.0</ows:ServiceTypeVersion>\r\n"
+	 "\t</ows:ServiceIdentification>\r\n"
+	 "\t<ows:OperationsMetadata>\r\n"
+	 "\t\t<ows:Operation name=\"GetCapabilities\">\r\n"
+	 "\t\t\t<ows:DCP><ows:HTTP><ows:Get xlink:href=\"%s?\"/></ows:HTTP></ows:DCP>\r\n"
+	 "\t\t</ows:Operation>\r\n"
+	 "\t\t<ows:Operation name=\"GetTile\">\r\n"
+	 "\t\t\t<ows:DCP><ows:HTTP><ows:Get xlink:href=\"%s?\"/></ows:HTTP></ows:DCP>\r\n"
+	 "\t\t</ows:Operation>\r\n"
+	 "\t</ows:OperationsMetadata>\r\n\t<Contents>\r\n", title,
+	 base_url, base_url);
+    sqlite3_free (title);
+    matrix_sets = sqlite3_mprintf ("%s", "");
+
+    lyr = req->config->MainFirst;
+    while (lyr != NULL)
+      {
+	  /* all Raster Layers from MAIN */
+	  if (is_valid_wmslite_layer (lyr) && lyr->Type == WMS_LAYER_RASTER)
+	      xml =
+		  wmts_capabilities_layer (req->conn->handle, xml, base_url,
+					   lyr->AliasName,
+					   (lyr->Raster ==
+					    NULL) ? NULL : lyr->Raster->Title,
+					   NULL, lyr->Name, &matrix_sets);
+	  lyr = lyr->Next;
+      }
+    db = req->config->DbFirst;
+    while (db != NULL)
+      {
+	  /* all Raster Layers from ATTACHED DBs */
+	  if (db->Valid)
+	    {
+		attLyr = db->First;
+		while (attLyr != NULL)
+		  {
+		      if (is_valid_wmslite_attached_layer (attLyr)
+			  && attLyr->Type == WMS_LAYER_RASTER)
+			  xml =
+			      wmts_capabilities_layer (req->conn->handle, xml,
+						       base_url,
+						       attLyr->AliasName,
+						       (attLyr->Raster ==
+							NULL) ? NULL :
+						       attLyr->Raster->Title,
+						       db->DbPrefix,
+						       attLyr->Name,
+						       &matrix_sets);
+		      attLyr = attLyr->Next;
+		  }
+	    }
+	  db = db->Next;
+      }
+
+    prev = xml;
+    xml =
+	sqlite3_mprintf ("%s%s\t</Contents>\r\n"
+			 "\t<ServiceMetadataURL xlink:href=\"%s/wmts/1.0.0/WMTSCapabilities.xml\"/>\r\n"
+			 "</Capabilities>\r\n", prev, matrix_sets, base_url);
+    sqlite3_free (prev);
+    sqlite3_free (matrix_sets);
+    free (base_url);
+
+    if (req->http_response != NULL)
+      {
+	  /* cleaning the http_response */
+	  if (req->freeor != NULL)
+	      req->freeor (req->http_response);
+      }
+    req->http_response = xml;
+    req->freeor = sqlite3_free;
+    req->http_content_length = strlen (xml);
+    req->http_mime_type = MIME_XML;
+    req->http_status = 200;
+}
+
+extern void
+process_wmts_request (WmsLiteHttpRequestPtr req)
+{
+/* processing a WMTS (KVP, REST or XYZ) request */
+    switch (req->request_type)
+      {
+      case WMS_GET_CAPABILITIES:
+	  do_wmts_get_capabilities (req);
+	  break;
+      case WMTS_GET_TILE:
+	  do_wmts_get_tile (req);
+	  break;
+      default:
+	  throw_wmts_exception (req, "OperationNotSupported", "REQUEST",
+				"Incomplete WMTS request: REQUEST parameter missing or invalid");
+	  break;
+      };
+}
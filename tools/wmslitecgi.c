@@ -223,6 +223,12 @@ main (int argc, char *argv[])
 		  case MIME_PDF:
 		      mime_type = "application/x-pdf";
 		      break;
+		  case MIME_WEBP:
+		      mime_type = "image/webp";
+		      break;
+		  case MIME_MVT:
+		      mime_type = "application/vnd.mapbox-vector-tile";
+		      break;
 		  default:
 		      mime_type = "text/plain; charset=UTF-8";
 		      break;